@@ -216,12 +216,21 @@ FLAGS+=" -g3"
 FLAGS+=" -DEIDSP_QUANTIZE_FILTERBANK=0"
 FLAGS+=" -DEI_CLASSIFIER_SLICES_PER_MODEL_WINDOW=4"
 FLAGS+=" -DEI_DSP_IMAGE_BUFFER_STATIC_SIZE=128"
+# one static 2176 byte arena (the size of the EON tensor arena): DSP scratch while the DSP
+# blocks run, then the tensor arena of the EON model
+FLAGS+=" -DEIDSP_SCRATCH_ARENA=1 -DEI_CLASSIFIER_SCRATCH_ARENA_SIZE=2176 -DEI_CLASSIFIER_SCRATCH_ARENA_STATIC=1"
+FLAGS+=" -DEI_CLASSIFIER_TELEMETRY=1" # per-stage latency histograms for AT+STATS
+# DSP / NN zone profiler for AT+PROFILE, in core cycles (480 MHz M7)
+#FLAGS+=" -DEI_PROFILER=1 -DEI_PROFILER_USE_CYCLE_COUNTER=1 -DEI_PROFILER_CYCLES_PER_US=480"
+# TFLite Micro interpreter next to the EON model, runs models uploaded with AT+MODELUPLOAD (AllOpsResolver links every kernel, mind the flash size)
+#FLAGS+=" -DEI_CLASSIFIER_LOADABLE_MODEL=1"
 
 # frame buffer allocation options: {static (default), heap or SDRAM}
 FLAGS+=" -DEI_CAMERA_FRAME_BUFFER_SDRAM"
 #FLAGS+=" -DEI_CAMERA_FRAME_BUFFER_HEAP"
 
-FLAGS+=" -DEI_CLASSIFIER_ALLOCATION_STATIC" # heap suffers from fragmentation, statically allocating helps
+# no EI_CLASSIFIER_ALLOCATION_STATIC: the heap suffers from fragmentation, but the tensor arena is
+# already the static scratch arena above (EON would keep a second static arena of its own)
 FLAGS+=" -w"
 
 if [ "$OPT_BUILD" -eq 1 ]; then
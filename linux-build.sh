@@ -0,0 +1,280 @@
+#!/bin/bash
+set -e
+
+################################ Project ######################################
+
+# Builds the firmware as a Linux process: the shared sources (ei_main, the AT
+# server and handlers, sampler, run impulse, sensors) are compiled unmodified
+# against the host stand-ins in src/ingestion-sdk-platform/linux/shim.
+
+PROJECT=firmware-linux
+
+SCRIPTPATH="$( cd "$(dirname "$0")" ; pwd -P )"
+BUILD_DIR="${SCRIPTPATH}/build-linux"
+
+if [ -z "$CXX" ]; then
+    CXX=g++
+fi
+if [ -z "$CC" ]; then
+    CC=gcc
+fi
+
+################################ Parse args ###################################
+OPT_BUILD=0
+OPT_CLEAN=0
+OPT_TEST=0
+OPT_TABLES=0
+OPT_CMSIS_NN=0
+OPT_PROFILER=0
+OPT_JOBS=$(nproc 2>/dev/null || echo 4)
+
+POSITIONAL_ARGS=()
+
+while [[ $# -gt 0 ]]; do
+  case $1 in
+    --build)
+      OPT_BUILD=1
+      shift # past argument
+      ;;
+    --clean)
+      OPT_CLEAN=1
+      shift # past argument
+      ;;
+    --all)
+      OPT_CLEAN=1
+      OPT_BUILD=1
+      shift # past argument
+      ;;
+    --test)
+      OPT_BUILD=1
+      OPT_TEST=1
+      shift # past argument
+      ;;
+    --static-impulse-tables)
+      OPT_TABLES=1
+      shift # past argument
+      ;;
+    --cmsis-nn)
+      OPT_CMSIS_NN=1
+      shift # past argument
+      ;;
+    --profiler)
+      OPT_PROFILER=1
+      shift # past argument
+      ;;
+    -j)
+      OPT_JOBS=$2
+      shift # past argument
+      shift # past value
+      ;;
+    -*|--*)
+      echo "Unknown option $1"
+      exit 1
+      ;;
+    *)
+      POSITIONAL_ARGS+=("$1") # save positional arg
+      shift # past argument
+      ;;
+  esac
+done
+
+set -- "${POSITIONAL_ARGS[@]}" # restore positional parameters
+
+############################### Build Deps #####################################
+
+# the shim directory comes first, it provides mbed.h, FlashIAP.h, PDM.h, camera.h, ...
+INCLUDE="-I./src/ingestion-sdk-platform/linux/shim"
+INCLUDE+=" -I./src/ingestion-sdk-platform/linux"
+INCLUDE+=" -I./src"
+INCLUDE+=" -I./src/model-parameters"
+INCLUDE+=" -I./src/ingestion-sdk-c/"
+INCLUDE+=" -I./src/ingestion-sdk-c/inc/signing"
+INCLUDE+=" -I./src/ingestion-sdk-platform/portenta-h7"
+INCLUDE+=" -I./src/sensors"
+INCLUDE+=" -I./src/mbedtls_hmac_sha256_sw/"
+INCLUDE+=" -I./src/edge-impulse-sdk/"
+INCLUDE+=" -I./src/firmware-sdk/"
+
+FLAGS="-O3"
+FLAGS+=" -g"
+FLAGS+=" -DEIDSP_QUANTIZE_FILTERBANK=0"
+FLAGS+=" -DEI_CLASSIFIER_SLICES_PER_MODEL_WINDOW=4"
+FLAGS+=" -DEI_DSP_IMAGE_BUFFER_STATIC_SIZE=128"
+# one static 2176 byte arena (the size of the EON tensor arena): DSP scratch while the DSP
+# blocks run, then the tensor arena of the EON model; no EI_CLASSIFIER_ALLOCATION_STATIC,
+# EON would keep a second static arena of its own
+FLAGS+=" -DEIDSP_SCRATCH_ARENA=1 -DEI_CLASSIFIER_SCRATCH_ARENA_SIZE=2176 -DEI_CLASSIFIER_SCRATCH_ARENA_STATIC=1"
+FLAGS+=" -DEI_CLASSIFIER_TELEMETRY=1" # per-stage latency histograms for AT+STATS
+FLAGS+=" -DEI_VAD_GATE=1" # skip DSP / NN on silent slices in AT+RUNIMPULSECONT
+FLAGS+=" -DEI_CLASSIFIER_LOADABLE_MODEL=1" # AT+MODELUPLOAD, models run by the interpreter from the flash file
+FLAGS+=" -DEI_KERNEL_BENCHMARK=1" # AT+BENCHKERNELS
+FLAGS+=" -DEI_CLASSIFIER_ARENA_REPORT=1" # AT+ARENA
+FLAGS+=" -DEI_CLASSIFIER_STATIC_IMPULSE=1" # MFCC specialized on the model, tables in model_static_impulse.h
+FLAGS+=" -DTF_LITE_DISABLE_X86_NEON"
+# like the Arm toolchain, drop unused code (ei_image_lib.cpp refers to an EiCamera this board does not use)
+FLAGS+=" -ffunction-sections -fdata-sections"
+
+# frame buffer allocation options: {static (default), heap or SDRAM}
+FLAGS+=" -DEI_CAMERA_FRAME_BUFFER_SDRAM"
+#FLAGS+=" -DEI_CAMERA_FRAME_BUFFER_HEAP"
+
+# --cmsis-nn builds the NN kernels on the portable C paths of CMSIS-NN (as the
+# Arm builds do, without the DSP / MVE intrinsics), in a separate build directory
+if [ "$OPT_CMSIS_NN" -eq 1 ]; then
+    PROJECT=firmware-linux-cmsis-nn
+    BUILD_DIR="${SCRIPTPATH}/build-linux-cmsis-nn"
+    FLAGS+=" -DEI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN=1"
+    CMSIS_EXCLUDE='/edge-impulse-sdk/CMSIS/\(Core\|DSP\)/'
+else
+    CMSIS_EXCLUDE='/edge-impulse-sdk/CMSIS/'
+fi
+
+# --profiler adds the DSP / NN zone profiler for AT+PROFILE (clock_gettime based, a few
+# percent on every inference, so off by default), in a separate build directory
+if [ "$OPT_PROFILER" -eq 1 ]; then
+    PROJECT="${PROJECT}-profiler"
+    BUILD_DIR="${BUILD_DIR}-profiler"
+    FLAGS+=" -DEI_PROFILER=1"
+fi
+
+CXXFLAGS="-std=gnu++17 $INCLUDE $FLAGS"
+CFLAGS="-std=gnu11 $INCLUDE $FLAGS"
+
+# everything under src/ except the board specific device file, the other SDK
+# ports and the Arm-only kernels (CMSIS-NN unless --cmsis-nn, CMSIS-DSP)
+list_sources() {
+    find ./src -name '*.cpp' -o -name '*.cc' -o -name '*.c' \
+        | grep -v '/ingestion-sdk-platform/portenta-h7/ei_device_portenta.cpp' \
+        | grep -v '/edge-impulse-sdk/porting/\(arduino\|espressif\|particle\)/' \
+        | grep -v "$CMSIS_EXCLUDE" \
+        | grep -v '/firmware-sdk/tools/' \
+        | sort
+}
+
+# compiles one source if it (or a header it includes) changed since the last build
+compile_one() {
+    src=$1
+    obj="${BUILD_DIR}/obj/${src#./}.o"
+    dep="${obj%.o}.d"
+
+    if [ -f "$obj" ] && [ -f "$dep" ]; then
+        deps=$(sed -e 's/^[^:]*://' -e 's/\\$//' "$dep")
+        if [ -z "$(find $deps -newer "$obj" -print -quit 2>/dev/null)" ]; then
+            return 0
+        fi
+    fi
+
+    mkdir -p "$(dirname "$obj")"
+    echo "Compiling ${src#./}"
+    case "$src" in
+        *.c) $CC $CFLAGS -MMD -MF "$dep" -c "$src" -o "$obj" ;;
+        *)   $CXX $CXXFLAGS -MMD -MF "$dep" -c "$src" -o "$obj" ;;
+    esac
+}
+export -f compile_one
+export BUILD_DIR CC CXX CFLAGS CXXFLAGS
+
+# compiles the sources on stdin, starting over when the flags change (the
+# dependency check only sees sources and headers)
+compile_sources() {
+    if [ -d "${BUILD_DIR}/obj" ] && [ "$(cat "${BUILD_DIR}/flags" 2>/dev/null)" != "$CXXFLAGS" ]; then
+        echo "Build flags changed, rebuilding everything"
+        rm -rf "${BUILD_DIR}/obj"
+    fi
+    mkdir -p "$BUILD_DIR"
+    echo "$CXXFLAGS" > "${BUILD_DIR}/flags"
+
+    xargs -P "$OPT_JOBS" -I{} bash -c 'compile_one "$@"' _ {}
+}
+
+# firmware-sdk/tools/static_impulse_tables.cpp writes the tables of the static
+# impulse mode to $1, linked against the firmware objects in $2
+STATIC_TABLES=./src/model-parameters/model_static_impulse.h
+generate_static_impulse_tables() {
+    $CXX $CXXFLAGS ./src/firmware-sdk/tools/static_impulse_tables.cpp "$2" -Wl,--gc-sections -lpthread \
+        -o "${BUILD_DIR}/static_impulse_tables"
+    "${BUILD_DIR}/static_impulse_tables" "$1"
+}
+
+cd "$SCRIPTPATH"
+
+if [ "$OPT_CLEAN" -eq 1 ]; then
+    echo "Cleaning $PROJECT"
+    rm -rf "$BUILD_DIR"
+fi
+
+# the tool needs no impulse object (ei_run_impulse.cpp is the only source that
+# includes the tables), so this also works when the tables are out of date
+if [ "$OPT_TABLES" -eq 1 ]; then
+    echo "Generating ${STATIC_TABLES#./}"
+    SOURCES=$(list_sources | grep -v '/ingestion-sdk-c/ei_run_impulse.cpp$' | grep -v '/linux/ei_main_linux.cpp$')
+    echo "$SOURCES" | compile_sources
+    TABLES_LIB="${BUILD_DIR}/libstatic-impulse-tables.a"
+    rm -f "$TABLES_LIB"
+    ar rcs "$TABLES_LIB" $(echo "$SOURCES" | sed -e "s|^\./|${BUILD_DIR}/obj/|" -e 's|$|.o|')
+    generate_static_impulse_tables "$STATIC_TABLES" "$TABLES_LIB"
+    echo "Generating ${STATIC_TABLES#./} done"
+fi
+
+if [ "$OPT_BUILD" -eq 1 ]; then
+    echo "Building $PROJECT"
+    SOURCES=$(list_sources)
+    echo "$SOURCES" | compile_sources
+
+    OBJECTS=$(echo "$SOURCES" | sed -e "s|^\./|${BUILD_DIR}/obj/|" -e 's|$|.o|')
+    $CXX -o "${BUILD_DIR}/${PROJECT}" $OBJECTS -Wl,--gc-sections -lpthread
+    echo "Building $PROJECT done: ${BUILD_DIR}/${PROJECT}"
+fi
+
+################################ Tests ########################################
+
+# tests/host/*.cpp are standalone programs linked against the firmware objects
+# (everything but the Linux main), tests/firmware/test_*.py drive the firmware
+# binary over its stdin / stdout serial port
+if [ "$OPT_TEST" -eq 1 ]; then
+    echo "Testing $PROJECT"
+    TEST_DIR="${BUILD_DIR}/tests"
+    mkdir -p "$TEST_DIR"
+    LIB="${TEST_DIR}/lib${PROJECT}.a"
+    rm -f "$LIB"
+    ar rcs "$LIB" $(echo "$OBJECTS" | grep -v '/linux/ei_main_linux.cpp.o$')
+
+    FAILED=0
+    # the committed tables must be the ones the model gives
+    generate_static_impulse_tables "${TEST_DIR}/model_static_impulse.h" "$LIB"
+    if cmp -s "${TEST_DIR}/model_static_impulse.h" "$STATIC_TABLES"; then
+        echo "PASS static_impulse_tables"
+    else
+        echo "FAIL static_impulse_tables: ${STATIC_TABLES#./} is out of date, run $0 --static-impulse-tables"
+        FAILED=1
+    fi
+
+    for test in ./tests/host/*.cpp; do
+        [ -e "$test" ] || continue
+        name=$(basename "$test" .cpp)
+        echo "Compiling ${test#./}"
+        $CXX $CXXFLAGS -I./tests/host "$test" "$LIB" -Wl,--gc-sections -lpthread -o "${TEST_DIR}/${name}"
+        if "${TEST_DIR}/${name}"; then
+            echo "PASS ${name}"
+        else
+            echo "FAIL ${name}"
+            FAILED=1
+        fi
+    done
+
+    if ! FIRMWARE="${BUILD_DIR}/${PROJECT}" python3 -m unittest discover -s ./tests/firmware -p 'test_*.py' -v; then
+        FAILED=1
+    fi
+
+    if [ "$FAILED" -ne 0 ]; then
+        echo "Testing $PROJECT failed"
+        exit 1
+    fi
+    echo "Testing $PROJECT done"
+fi
+
+if [ "$OPT_BUILD" -eq 0 ] && [ "$OPT_CLEAN" -eq 0 ]; then
+    if [ "$OPT_TABLES" -eq 0 ]; then
+        echo "Usage: $0 [--build] [--clean] [--all] [--test] [--static-impulse-tables] [--cmsis-nn] [--profiler] [-j jobs]"
+    fi
+fi
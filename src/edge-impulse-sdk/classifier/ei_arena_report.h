@@ -0,0 +1,194 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EDGE_IMPULSE_ARENA_REPORT_H_
+#define _EDGE_IMPULSE_ARENA_REPORT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+// Collect arena / tensor lifetime information for the NN (see run_classifier_arena_report).
+// The TFLite Micro interpreter fills in the whole report, EON compiled models only the
+// arena totals (tensors, buffers and recorded allocations are left empty).
+#ifndef EI_CLASSIFIER_ARENA_REPORT
+#define EI_CLASSIFIER_ARENA_REPORT              0
+#endif // EI_CLASSIFIER_ARENA_REPORT
+
+#ifndef EI_ARENA_REPORT_MAX_TENSORS
+#define EI_ARENA_REPORT_MAX_TENSORS             64
+#endif // EI_ARENA_REPORT_MAX_TENSORS
+
+#ifndef EI_ARENA_REPORT_MAX_BUFFERS
+#define EI_ARENA_REPORT_MAX_BUFFERS             32
+#endif // EI_ARENA_REPORT_MAX_BUFFERS
+
+#define EI_ARENA_REPORT_NODE_UNUSED             -1
+
+/** A tensor that lives in the (non-persistent part of the) arena */
+typedef struct {
+    int16_t index;          // tensor index in the graph
+    int16_t first_node;     // first node that reads or writes the tensor
+    int16_t last_node;      // last node that reads or writes the tensor
+    uint32_t offset;        // offset from the start of the arena, in bytes
+    uint32_t bytes;
+} ei_arena_report_tensor_t;
+
+/** A persistent or scratch buffer requested by a kernel */
+typedef struct {
+    int16_t node;           // node that requested the buffer (EI_ARENA_REPORT_NODE_UNUSED if unknown)
+    bool scratch;           // scratch (RequestScratchBufferInArena) or persistent buffer
+    bool overflow;          // did not fit in the arena, taken from the heap instead
+    uint32_t bytes;
+} ei_arena_report_buffer_t;
+
+/** Allocation bucket as recorded by the TFLM RecordingMicroAllocator */
+typedef struct {
+    const char *name;
+    uint32_t requested_bytes;
+    uint32_t used_bytes;
+    uint32_t count;
+} ei_arena_report_recorded_t;
+
+#define EI_ARENA_REPORT_MAX_RECORDED            6
+
+typedef struct ei_arena_report {
+    const char *engine;
+    uint32_t arena_size;            // bytes reserved for the arena
+    uint32_t nonpersistent_bytes;   // bytes used by tensors (head of the arena)
+    uint32_t persistent_bytes;      // bytes used by persistent and scratch buffers (tail of the arena)
+    uint32_t overflow_bytes;        // bytes that did not fit and were taken from the heap
+    uint32_t headroom_bytes;        // unused bytes in between
+    uint16_t nodes_count;
+
+    uint16_t tensors_count;         // can be larger than EI_ARENA_REPORT_MAX_TENSORS, only the first ones are stored
+    ei_arena_report_tensor_t tensors[EI_ARENA_REPORT_MAX_TENSORS];
+
+    uint16_t buffers_count;         // can be larger than EI_ARENA_REPORT_MAX_BUFFERS, only the first ones are stored
+    ei_arena_report_buffer_t buffers[EI_ARENA_REPORT_MAX_BUFFERS];
+
+    uint16_t recorded_count;
+    ei_arena_report_recorded_t recorded[EI_ARENA_REPORT_MAX_RECORDED];
+} ei_arena_report_t;
+
+/**
+ * @brief      Print the arena report as a single JSON object
+ *
+ * @param      report  The report (filled in by run_classifier_arena_report)
+ */
+__attribute__((unused)) static void ei_arena_report_print_json(const ei_arena_report_t *report)
+{
+    ei_printf("{\"engine\":\"%s\",\"arenaSize\":%u,\"nonPersistentBytes\":%u,\"persistentBytes\":%u,"
+        "\"overflowBytes\":%u,\"headroomBytes\":%u,\"nodes\":%u,\"tensorCount\":%u,\"tensors\":[",
+        report->engine ? report->engine : "unknown",
+        (unsigned int)report->arena_size, (unsigned int)report->nonpersistent_bytes,
+        (unsigned int)report->persistent_bytes, (unsigned int)report->overflow_bytes,
+        (unsigned int)report->headroom_bytes, (unsigned int)report->nodes_count,
+        (unsigned int)report->tensors_count);
+
+    size_t tensors_stored = report->tensors_count < EI_ARENA_REPORT_MAX_TENSORS ?
+        report->tensors_count : EI_ARENA_REPORT_MAX_TENSORS;
+    for (size_t ix = 0; ix < tensors_stored; ix++) {
+        const ei_arena_report_tensor_t *t = &report->tensors[ix];
+        ei_printf("%s{\"index\":%d,\"offset\":%u,\"bytes\":%u,\"firstNode\":%d,\"lastNode\":%d}",
+            ix == 0 ? "" : ",", (int)t->index, (unsigned int)t->offset, (unsigned int)t->bytes,
+            (int)t->first_node, (int)t->last_node);
+    }
+
+    ei_printf("],\"bufferCount\":%u,\"buffers\":[", (unsigned int)report->buffers_count);
+
+    size_t buffers_stored = report->buffers_count < EI_ARENA_REPORT_MAX_BUFFERS ?
+        report->buffers_count : EI_ARENA_REPORT_MAX_BUFFERS;
+    for (size_t ix = 0; ix < buffers_stored; ix++) {
+        const ei_arena_report_buffer_t *b = &report->buffers[ix];
+        ei_printf("%s{\"node\":%d,\"type\":\"%s\",\"bytes\":%u,\"overflow\":%s}",
+            ix == 0 ? "" : ",", (int)b->node, b->scratch ? "scratch" : "persistent",
+            (unsigned int)b->bytes, b->overflow ? "true" : "false");
+    }
+
+    ei_printf("],\"recorded\":[");
+
+    for (size_t ix = 0; ix < report->recorded_count && ix < EI_ARENA_REPORT_MAX_RECORDED; ix++) {
+        const ei_arena_report_recorded_t *r = &report->recorded[ix];
+        ei_printf("%s{\"name\":\"%s\",\"requestedBytes\":%u,\"usedBytes\":%u,\"count\":%u}",
+            ix == 0 ? "" : ",", r->name, (unsigned int)r->requested_bytes,
+            (unsigned int)r->used_bytes, (unsigned int)r->count);
+    }
+
+    ei_printf("]}\n");
+}
+
+/**
+ * @brief      Fill in the first and last node that use every tensor in the report
+ *
+ * @param      report          The report, tensors need to be filled in already
+ * @param      get_node_io     Callback that returns the inputs or outputs of a node (TfLiteIntArray layout: size, data...)
+ * @param      ctx             Context passed to the callback
+ */
+__attribute__((unused)) static void ei_arena_report_compute_lifetimes(
+    ei_arena_report_t *report,
+    const int *(*get_node_io)(void *ctx, size_t node, bool outputs),
+    void *ctx)
+{
+    size_t tensors_stored = report->tensors_count < EI_ARENA_REPORT_MAX_TENSORS ?
+        report->tensors_count : EI_ARENA_REPORT_MAX_TENSORS;
+
+    for (size_t ix = 0; ix < tensors_stored; ix++) {
+        report->tensors[ix].first_node = EI_ARENA_REPORT_NODE_UNUSED;
+        report->tensors[ix].last_node = EI_ARENA_REPORT_NODE_UNUSED;
+    }
+
+    for (size_t node = 0; node < report->nodes_count; node++) {
+        for (int io = 0; io < 2; io++) {
+            const int *arr = get_node_io(ctx, node, io == 1);
+            if (!arr) {
+                continue;
+            }
+            for (int a = 0; a < arr[0]; a++) {
+                for (size_t ix = 0; ix < tensors_stored; ix++) {
+                    ei_arena_report_tensor_t *t = &report->tensors[ix];
+                    if (t->index != arr[a + 1]) {
+                        continue;
+                    }
+                    if (t->first_node == EI_ARENA_REPORT_NODE_UNUSED) {
+                        t->first_node = (int16_t)node;
+                    }
+                    t->last_node = (int16_t)node;
+                }
+            }
+        }
+    }
+}
+
+#endif // _EDGE_IMPULSE_ARENA_REPORT_H_
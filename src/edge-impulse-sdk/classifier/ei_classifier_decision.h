@@ -0,0 +1,406 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_DECISION_H_
+#define _EI_CLASSIFIER_DECISION_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+#include "edge-impulse-sdk/dsp/returntypes.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+// Capacity of the vote history (readings that are compared for consensus)
+#ifndef EI_CLASSIFIER_DECISION_MAX_READINGS
+#define EI_CLASSIFIER_DECISION_MAX_READINGS     32
+#endif // EI_CLASSIFIER_DECISION_MAX_READINGS
+
+// Capacity of the score window (results that are averaged before thresholding),
+// longer windows are rejected when the window is initialized
+#ifndef EI_CLASSIFIER_DECISION_MAX_WINDOW
+#define EI_CLASSIFIER_DECISION_MAX_WINDOW       16
+#endif // EI_CLASSIFIER_DECISION_MAX_WINDOW
+
+// Labels per decision layer. Every impulse of the deployment returns its scores in
+// ei_impulse_result_t, so with a static classification array none has more labels than
+// the array holds. With a dynamically allocated one, set this to the largest label count
+// of all impulses.
+#ifndef EI_CLASSIFIER_DECISION_MAX_LABELS
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 1
+#define EI_CLASSIFIER_DECISION_MAX_LABELS       (sizeof(ei_impulse_result_t::classification) / sizeof(ei_impulse_result_classification_t))
+#else
+#error "Define EI_CLASSIFIER_DECISION_MAX_LABELS as the largest label count of all impulses"
+#endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 1
+#endif // EI_CLASSIFIER_DECISION_MAX_LABELS
+
+// Bits in ei_classifier_decision_config_t::label_mask, a mask needs at most this many labels
+#define EI_CLASSIFIER_DECISION_MASK_BITS        32
+
+#define EI_CLASSIFIER_DECISION_UNCERTAIN        -1
+#define EI_CLASSIFIER_DECISION_ANOMALY          -2
+#define EI_CLASSIFIER_DECISION_NO_EVENT         -1
+
+/**
+ * Moving average over the last `window` score vectors. The running sum is
+ * updated incrementally (subtract the oldest, add the newest), so a push is
+ * O(labels) regardless of the window length.
+ */
+typedef struct {
+    float scores[EI_CLASSIFIER_DECISION_MAX_WINDOW][EI_CLASSIFIER_DECISION_MAX_LABELS];
+    float running_sum[EI_CLASSIFIER_DECISION_MAX_LABELS];
+    uint16_t n_labels;
+    uint16_t window;
+    uint16_t ix;            // slot the next push overwrites
+    uint16_t filled;        // number of valid entries, grows until the window is full
+} ei_classifier_score_window_t;
+
+/**
+ * Ring buffer of per-update readings (a label index, uncertain or anomaly) with
+ * a vote count per reading that is kept in sync on every push.
+ */
+typedef struct {
+    int16_t readings[EI_CLASSIFIER_DECISION_MAX_READINGS];
+    uint16_t count[EI_CLASSIFIER_DECISION_MAX_LABELS + 2];
+    uint16_t n_labels;
+    uint16_t size;
+    uint16_t ix;            // oldest reading, overwritten by the next push
+} ei_classifier_vote_history_t;
+
+typedef struct {
+    uint16_t n_labels;
+    // consensus (see ei_classifier_smooth.h)
+    uint16_t n_readings;
+    uint16_t min_readings_same;
+    float classifier_confidence;
+    float anomaly_confidence;
+    // events on the averaged scores
+    uint16_t average_window;        // 1 = no averaging
+    float detection_threshold;      // default for all labels, see ei_classifier_decision_set_threshold
+    float release_threshold;        // an event is re-armed when the score drops below this
+    uint16_t refractory_updates;    // updates after an event in which no new event can fire
+    uint32_t label_mask;            // labels that can raise events (bit per label, up to 32 labels), 0 = all
+} ei_classifier_decision_config_t;
+
+typedef struct {
+    const char *vote;               // consensus: a label, "uncertain" or "anomaly"
+    int16_t vote_ix;                // label index, EI_CLASSIFIER_DECISION_UNCERTAIN or _ANOMALY
+    const char *event;              // label that crossed its threshold in this update, nullptr if none
+    int16_t event_ix;               // label index or EI_CLASSIFIER_DECISION_NO_EVENT
+    int16_t active_ix;              // label that is latched until it drops below its release threshold
+    float event_score;              // averaged score of event_ix (or of the top label if no event)
+} ei_classifier_decision_output_t;
+
+typedef struct {
+    ei_classifier_decision_config_t config;
+    ei_classifier_vote_history_t votes;
+    ei_classifier_score_window_t window;
+    float threshold[EI_CLASSIFIER_DECISION_MAX_LABELS];
+    float release[EI_CLASSIFIER_DECISION_MAX_LABELS];
+    int16_t active_ix;
+    uint16_t refractory_left;
+    ei_classifier_decision_output_t output;
+} ei_classifier_decision_t;
+
+/* Score window ------------------------------------------------------------ */
+
+/**
+ * The window lives in the struct, nothing to release.
+ *
+ * @return EI_IMPULSE_INVALID_SIZE if the labels or the window do not fit the compile-time capacity
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_classifier_score_window_init(ei_classifier_score_window_t *w,
+    size_t n_labels, size_t window)
+{
+    if (n_labels == 0 || n_labels > EI_CLASSIFIER_DECISION_MAX_LABELS ||
+        window == 0 || window > EI_CLASSIFIER_DECISION_MAX_WINDOW) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+
+    for (size_t row = 0; row < window; row++) {
+        for (size_t ix = 0; ix < n_labels; ix++) {
+            w->scores[row][ix] = 0.f;
+        }
+    }
+
+    w->n_labels = (uint16_t)n_labels;
+    w->window = (uint16_t)window;
+    w->ix = 0;
+    w->filled = 0;
+    for (size_t ix = 0; ix < n_labels; ix++) {
+        w->running_sum[ix] = 0.f;
+    }
+    return EI_IMPULSE_OK;
+}
+
+__attribute__((unused)) static void ei_classifier_score_window_push(ei_classifier_score_window_t *w,
+    const ei_impulse_result_classification_t *scores)
+{
+    float *slot = w->scores[w->ix];
+    for (size_t ix = 0; ix < w->n_labels; ix++) {
+        w->running_sum[ix] -= slot[ix];
+        w->running_sum[ix] += scores[ix].value;
+        slot[ix] = scores[ix].value;
+    }
+
+    if (++w->ix >= w->window) {
+        w->ix = 0;
+    }
+    if (w->filled < w->window) {
+        w->filled++;
+    }
+}
+
+__attribute__((unused)) static float ei_classifier_score_window_mean(const ei_classifier_score_window_t *w,
+    size_t label_ix)
+{
+    return w->filled > 0 ? w->running_sum[label_ix] / w->filled : 0.f;
+}
+
+/* Vote history ------------------------------------------------------------ */
+
+__attribute__((unused)) static size_t ei_classifier_vote_slot(const ei_classifier_vote_history_t *h,
+    int16_t reading)
+{
+    if (reading >= 0) {
+        return (size_t)reading;
+    }
+    return reading == EI_CLASSIFIER_DECISION_UNCERTAIN ? h->n_labels : h->n_labels + 1;
+}
+
+__attribute__((unused)) static bool ei_classifier_vote_history_init(ei_classifier_vote_history_t *h,
+    size_t n_labels, size_t size)
+{
+    if (n_labels > EI_CLASSIFIER_DECISION_MAX_LABELS || size == 0 ||
+        size > EI_CLASSIFIER_DECISION_MAX_READINGS) {
+        return false;
+    }
+
+    h->n_labels = (uint16_t)n_labels;
+    h->size = (uint16_t)size;
+    h->ix = 0;
+    for (size_t ix = 0; ix < size; ix++) {
+        h->readings[ix] = EI_CLASSIFIER_DECISION_UNCERTAIN;
+    }
+    for (size_t ix = 0; ix < n_labels + 2; ix++) {
+        h->count[ix] = 0;
+    }
+    h->count[n_labels] = (uint16_t)size;
+    return true;
+}
+
+__attribute__((unused)) static void ei_classifier_vote_history_push(ei_classifier_vote_history_t *h,
+    int16_t reading)
+{
+    h->count[ei_classifier_vote_slot(h, h->readings[h->ix])]--;
+    h->count[ei_classifier_vote_slot(h, reading)]++;
+    h->readings[h->ix] = reading;
+
+    if (++h->ix >= h->size) {
+        h->ix = 0;
+    }
+}
+
+/**
+ * Reading with the most votes if any reading has at least min_readings_same votes,
+ * uncertain otherwise. Ties go to the lowest label index (as ei_classifier_smooth_update).
+ */
+__attribute__((unused)) static int16_t ei_classifier_vote_history_consensus(
+    const ei_classifier_vote_history_t *h, size_t min_readings_same)
+{
+    size_t top_slot = 0;
+    uint16_t top_count = 0;
+    bool met_threshold = false;
+
+    for (size_t ix = 0; ix < (size_t)h->n_labels + 2; ix++) {
+        if (h->count[ix] > top_count) {
+            top_slot = ix;
+            top_count = h->count[ix];
+        }
+        if (h->count[ix] >= min_readings_same) {
+            met_threshold = true;
+        }
+    }
+
+    if (!met_threshold || top_slot == h->n_labels) {
+        return EI_CLASSIFIER_DECISION_UNCERTAIN;
+    }
+    if (top_slot == (size_t)h->n_labels + 1) {
+        return EI_CLASSIFIER_DECISION_ANOMALY;
+    }
+    return (int16_t)top_slot;
+}
+
+/* Decision ---------------------------------------------------------------- */
+
+__attribute__((unused)) static void ei_classifier_decision_default_config(
+    ei_classifier_decision_config_t *config, size_t n_labels)
+{
+    config->n_labels = (uint16_t)n_labels;
+    config->n_readings = 10;
+    config->min_readings_same = 7;
+    config->classifier_confidence = 0.8f;
+    config->anomaly_confidence = 0.3f;
+    config->average_window = 1;
+    config->detection_threshold = 0.8f;
+    config->release_threshold = 0.5f;
+    config->refractory_updates = 0;
+    config->label_mask = 0;
+}
+
+/**
+ * Initialize a decision layer: consensus voting over the last n_readings results
+ * plus (optionally averaged) per-label thresholds with hysteresis and a refractory
+ * period. All state lives in the struct.
+ *
+ * @return EI_IMPULSE_INVALID_SIZE if the config does not fit the compile-time capacity
+ *         (labels, readings, average window) or sets a label_mask for more than 32 labels
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_classifier_decision_init(ei_classifier_decision_t *d,
+    const ei_classifier_decision_config_t *config)
+{
+    d->config = *config;
+
+    if (config->label_mask != 0 && config->n_labels > EI_CLASSIFIER_DECISION_MASK_BITS) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+    if (!ei_classifier_vote_history_init(&d->votes, config->n_labels, config->n_readings)) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+    EI_IMPULSE_ERROR res = ei_classifier_score_window_init(&d->window, config->n_labels, config->average_window);
+    if (res != EI_IMPULSE_OK) {
+        return res;
+    }
+
+    for (size_t ix = 0; ix < config->n_labels; ix++) {
+        d->threshold[ix] = config->detection_threshold;
+        d->release[ix] = config->release_threshold;
+    }
+
+    d->active_ix = EI_CLASSIFIER_DECISION_NO_EVENT;
+    d->refractory_left = 0;
+    d->output = { "uncertain", EI_CLASSIFIER_DECISION_UNCERTAIN, nullptr,
+        EI_CLASSIFIER_DECISION_NO_EVENT, EI_CLASSIFIER_DECISION_NO_EVENT, 0.f };
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Set the detection and release threshold for one label. release should be
+ * lower than threshold, the gap is the hysteresis.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_classifier_decision_set_threshold(
+    ei_classifier_decision_t *d, size_t label_ix, float threshold, float release)
+{
+    if (label_ix >= d->config.n_labels) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+    d->threshold[label_ix] = threshold;
+    d->release[label_ix] = release < threshold ? release : threshold;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Feed a new result. Reads the classification and anomaly score straight from the
+ * result, the returned output stays valid until the next update.
+ */
+__attribute__((unused)) static const ei_classifier_decision_output_t *ei_classifier_decision_update(
+    ei_classifier_decision_t *d, const ei_impulse_result_t *result)
+{
+    const ei_classifier_decision_config_t *config = &d->config;
+    ei_classifier_decision_output_t *out = &d->output;
+
+    // consensus
+    int16_t reading = EI_CLASSIFIER_DECISION_UNCERTAIN;
+    for (size_t ix = 0; ix < config->n_labels; ix++) {
+        if (result->classification[ix].value >= config->classifier_confidence) {
+            reading = (int16_t)ix;
+        }
+    }
+    if (result->anomaly >= config->anomaly_confidence) {
+        reading = EI_CLASSIFIER_DECISION_ANOMALY;
+    }
+    ei_classifier_vote_history_push(&d->votes, reading);
+
+    out->vote_ix = ei_classifier_vote_history_consensus(&d->votes, config->min_readings_same);
+    if (out->vote_ix == EI_CLASSIFIER_DECISION_UNCERTAIN) {
+        out->vote = "uncertain";
+    }
+    else if (out->vote_ix == EI_CLASSIFIER_DECISION_ANOMALY) {
+        out->vote = "anomaly";
+    }
+    else {
+        out->vote = result->classification[out->vote_ix].label;
+    }
+
+    // events on the averaged scores
+    ei_classifier_score_window_push(&d->window, result->classification);
+
+    int16_t top_ix = EI_CLASSIFIER_DECISION_NO_EVENT;
+    float top_score = 0.f;
+    for (size_t ix = 0; ix < config->n_labels; ix++) {
+        if (config->label_mask &&
+            (ix >= EI_CLASSIFIER_DECISION_MASK_BITS || !(config->label_mask & (1u << ix)))) {
+            continue;
+        }
+        float score = ei_classifier_score_window_mean(&d->window, ix);
+        if (score > top_score) {
+            top_score = score;
+            top_ix = (int16_t)ix;
+        }
+    }
+
+    if (d->active_ix >= 0 &&
+        ei_classifier_score_window_mean(&d->window, d->active_ix) < d->release[d->active_ix]) {
+        d->active_ix = EI_CLASSIFIER_DECISION_NO_EVENT;
+    }
+
+    out->event = nullptr;
+    out->event_ix = EI_CLASSIFIER_DECISION_NO_EVENT;
+    out->event_score = top_score;
+
+    if (d->refractory_left > 0) {
+        d->refractory_left--;
+    }
+    else if (top_ix >= 0 && top_ix != d->active_ix && top_score >= d->threshold[top_ix]) {
+        out->event_ix = top_ix;
+        out->event = result->classification[top_ix].label;
+        d->active_ix = top_ix;
+        d->refractory_left = config->refractory_updates;
+    }
+
+    out->active_ix = d->active_ix;
+    return out;
+}
+
+#endif // _EI_CLASSIFIER_DECISION_H_
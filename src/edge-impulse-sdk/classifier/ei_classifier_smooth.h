@@ -39,31 +39,49 @@
 
 #include <stdint.h>
 
+// Capacity of the reading history (n_readings)
+#ifndef EI_CLASSIFIER_SMOOTH_MAX_READINGS
+#define EI_CLASSIFIER_SMOOTH_MAX_READINGS   32
+#endif // EI_CLASSIFIER_SMOOTH_MAX_READINGS
+
 typedef struct ei_classifier_smooth {
-    int *last_readings;
+    int last_readings[EI_CLASSIFIER_SMOOTH_MAX_READINGS];
     size_t last_readings_size;
     uint8_t min_readings_same;
     float classifier_confidence;
     float anomaly_confidence;
     uint8_t count[EI_CLASSIFIER_LABEL_COUNT + 2] = { 0 };
     size_t count_size = EI_CLASSIFIER_LABEL_COUNT + 2;
+    size_t last_readings_ix = 0; // oldest reading, overwritten by the next update
 } ei_classifier_smooth_t;
 
+static inline size_t ei_classifier_smooth_count_ix(int reading) {
+    if (reading >= 0) {
+        return (size_t)reading;
+    }
+    return reading == -1 ? EI_CLASSIFIER_LABEL_COUNT : EI_CLASSIFIER_LABEL_COUNT + 1;
+}
+
 /**
  * Initialize a smooth structure. This is useful if you don't want to trust
  * single readings, but rather want consensus
  * (e.g. 7 / 10 readings should be the same before I draw any ML conclusions).
- * This allocates memory on the heap!
+ * The readings live in the struct, see ei_classifier_decision.h for a version
+ * that also supports averaged per-label thresholds.
  * @param smooth Pointer to an uninitialized ei_classifier_smooth_t struct
- * @param n_readings Number of readings you want to store
+ * @param n_readings Number of readings you want to store (1..EI_CLASSIFIER_SMOOTH_MAX_READINGS)
  * @param min_readings_same Minimum readings that need to be the same before concluding (needs to be lower than n_readings)
  * @param classifier_confidence Minimum confidence in a class (default 0.8)
  * @param anomaly_confidence Maximum error for anomalies (default 0.3)
+ * @returns false if n_readings does not fit, every update then returns 'uncertain'
  */
-void ei_classifier_smooth_init(ei_classifier_smooth_t *smooth, size_t n_readings,
+bool ei_classifier_smooth_init(ei_classifier_smooth_t *smooth, size_t n_readings,
                                uint8_t min_readings_same, float classifier_confidence = 0.8,
                                float anomaly_confidence = 0.3) {
-    smooth->last_readings = (int*)ei_malloc(n_readings * sizeof(int));
+    if (n_readings == 0 || n_readings > EI_CLASSIFIER_SMOOTH_MAX_READINGS) {
+        smooth->last_readings_size = 0;
+        return false;
+    }
     for (size_t ix = 0; ix < n_readings; ix++) {
         smooth->last_readings[ix] = -1; // -1 == uncertain
     }
@@ -72,6 +90,12 @@ void ei_classifier_smooth_init(ei_classifier_smooth_t *smooth, size_t n_readings
     smooth->classifier_confidence = classifier_confidence;
     smooth->anomaly_confidence = anomaly_confidence;
     smooth->count_size = EI_CLASSIFIER_LABEL_COUNT + 2;
+
+    // all readings start out as uncertain
+    memset(smooth->count, 0, EI_CLASSIFIER_LABEL_COUNT + 2);
+    smooth->count[EI_CLASSIFIER_LABEL_COUNT] = (uint8_t)n_readings;
+    smooth->last_readings_ix = 0;
+    return true;
 }
 
 /**
@@ -81,16 +105,12 @@ void ei_classifier_smooth_init(ei_classifier_smooth_t *smooth, size_t n_readings
  * @returns Label, either 'uncertain', 'anomaly', or a label from the result struct
  */
 const char* ei_classifier_smooth_update(ei_classifier_smooth_t *smooth, ei_impulse_result_t *result) {
-    // clear out the count array
-    memset(smooth->count, 0, EI_CLASSIFIER_LABEL_COUNT + 2);
-
-    // roll through the last_readings buffer
-    numpy::roll(smooth->last_readings, smooth->last_readings_size, -1);
-
     int reading = -1; // uncertain
 
-    // print the predictions
-    // printf("[");
+    if (smooth->last_readings_size == 0) {
+        return "uncertain";
+    }
+
     for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
         if (result->classification[ix].value >= smooth->classifier_confidence) {
             reading = (int)ix;
@@ -100,19 +120,14 @@ const char* ei_classifier_smooth_update(ei_classifier_smooth_t *smooth, ei_impul
         reading = -2; // anomaly
     }
 
-    smooth->last_readings[smooth->last_readings_size - 1] = reading;
+    // last_readings is a ring buffer, replace the oldest reading and keep the counts in sync
+    int *oldest = &smooth->last_readings[smooth->last_readings_ix];
+    smooth->count[ei_classifier_smooth_count_ix(*oldest)]--;
+    smooth->count[ei_classifier_smooth_count_ix(reading)]++;
+    *oldest = reading;
 
-    // now count last 10 readings and see what we actually see...
-    for (size_t ix = 0; ix < smooth->last_readings_size; ix++) {
-        if (smooth->last_readings[ix] >= 0) {
-            smooth->count[smooth->last_readings[ix]]++;
-        }
-        else if (smooth->last_readings[ix] == -1) { // uncertain
-            smooth->count[EI_CLASSIFIER_LABEL_COUNT]++;
-        }
-        else if (smooth->last_readings[ix] == -2) { // anomaly
-            smooth->count[EI_CLASSIFIER_LABEL_COUNT + 1]++;
-        }
+    if (++smooth->last_readings_ix >= smooth->last_readings_size) {
+        smooth->last_readings_ix = 0;
     }
 
     // then loop over the count and see which is highest
@@ -145,10 +160,10 @@ const char* ei_classifier_smooth_update(ei_classifier_smooth_t *smooth, ei_impul
 }
 
 /**
- * Clear up a smooth structure
+ * Clear up a smooth structure (nothing is allocated, kept for existing callers)
  */
 void ei_classifier_smooth_free(ei_classifier_smooth_t *smooth) {
-    ei_free(smooth->last_readings);
+    (void)smooth;
 }
 
 #endif // #if EI_CLASSIFIER_OBJECT_DETECTION != 1
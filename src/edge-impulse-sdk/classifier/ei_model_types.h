@@ -539,6 +539,19 @@ public:
     ei_input_params* input_params;
 };
 
+/**
+ * Continuous inference state of one impulse (see run_classifier_continuous_swap_state()),
+ * zeroed it starts empty. The buffers are allocated with ei_calloc().
+ */
+typedef struct {
+    float *features;            // feature window, nn_input_frame_size features
+    size_t features_size;
+    uint64_t features_written;  // features computed since the start, the window is full at nn_input_frame_size
+    float *dsp_frame;           // audio frame carried over to the next slice by the audio DSP blocks
+    size_t dsp_frame_size;
+    int dsp_frame_ix;
+} ei_classifier_continuous_state_t;
+
 typedef struct {
     uint32_t block_id;
     uint16_t implementation_version;
@@ -0,0 +1,120 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include "edge-impulse-sdk/classifier/ei_nms_workspace.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+ei_nms_workspace_t ei_nms_default_workspace = { };
+
+void ei_nms_workspace_free(ei_nms_workspace_t *ws)
+{
+    ei_free(ws->buffer);
+    ei_free(ws->staging_buffer);
+    memset(ws, 0, sizeof(ei_nms_workspace_t));
+}
+
+EI_IMPULSE_ERROR ei_nms_workspace_reserve(ei_nms_workspace_t *ws, size_t num_boxes)
+{
+    if (num_boxes <= ws->capacity) {
+        return EI_IMPULSE_OK;
+    }
+
+    ei_free(ws->buffer);
+    ws->capacity = 0;
+
+    size_t bytes_per_box = sizeof(ei_nms_candidate_t) + (5 * sizeof(float)) + (3 * sizeof(int)) +
+        (2 * EI_NMS_MAX_CELLS_PER_BOX * sizeof(int));
+    uint8_t *buffer = (uint8_t*)ei_malloc(num_boxes * bytes_per_box);
+    ws->buffer = buffer;
+    if (!buffer) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+
+    ws->candidates = (ei_nms_candidate_t*)buffer;
+    buffer += num_boxes * sizeof(ei_nms_candidate_t);
+    ws->corners = (float*)buffer;
+    buffer += num_boxes * 4 * sizeof(float);
+    ws->areas = (float*)buffer;
+    buffer += num_boxes * sizeof(float);
+    ws->selected = (int*)buffer;
+    buffer += num_boxes * sizeof(int);
+    ws->neighbours = (int*)buffer;
+    buffer += num_boxes * sizeof(int);
+    ws->neighbour_mark = (int*)buffer;
+    memset(ws->neighbour_mark, 0, num_boxes * sizeof(int));
+    ws->neighbour_stamp = 0;
+    buffer += num_boxes * sizeof(int);
+    ws->entry_selected = (int*)buffer;
+    buffer += num_boxes * EI_NMS_MAX_CELLS_PER_BOX * sizeof(int);
+    ws->entry_next = (int*)buffer;
+
+    ws->capacity = num_boxes;
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR ei_nms_workspace_reserve_staging(ei_nms_workspace_t *ws, size_t num_boxes)
+{
+    if (num_boxes <= ws->staging_capacity) {
+        return EI_IMPULSE_OK;
+    }
+
+    ei_free(ws->staging_buffer);
+    ws->staging_capacity = 0;
+
+    size_t bytes_per_box = (6 * sizeof(float)) + (2 * sizeof(int));
+    uint8_t *buffer = (uint8_t*)ei_malloc(num_boxes * bytes_per_box);
+    ws->staging_buffer = buffer;
+    if (!buffer) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+
+    ws->staging_boxes = (float*)buffer;
+    buffer += num_boxes * 4 * sizeof(float);
+    ws->staging_scores = (float*)buffer;
+    buffer += num_boxes * sizeof(float);
+    ws->selected_scores = (float*)buffer;
+    buffer += num_boxes * sizeof(float);
+    ws->staging_classes = (int*)buffer;
+    buffer += num_boxes * sizeof(int);
+    ws->selected_indices = (int*)buffer;
+
+    ws->staging_capacity = num_boxes;
+    return EI_IMPULSE_OK;
+}
+
+void ei_nms_release_workspace(void)
+{
+    ei_nms_workspace_free(&ei_nms_default_workspace);
+}
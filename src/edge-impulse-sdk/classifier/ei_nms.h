@@ -39,8 +39,9 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_nms_workspace.h"
 
-#if (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX)
+#if EI_NMS_ENABLED
 
 // The code below comes from tensorflow/lite/kernels/internal/reference/non_max_suppression.h
 // Copyright 2019 The TensorFlow Authors.  All rights reserved.
@@ -214,6 +215,314 @@ static inline void NonMaxSuppression(const float* boxes, const int num_boxes,
   }
 }
 
+// Same arithmetic as ComputeIntersectionOverUnion, on the precomputed corners and areas
+static inline float ei_nms_iou(const ei_nms_workspace_t *ws, const int i, const int j)
+{
+    const float *box_i = &ws->corners[i * 4];
+    const float *box_j = &ws->corners[j * 4];
+    const float area_i = ws->areas[i];
+    const float area_j = ws->areas[j];
+    if (area_i <= 0 || area_j <= 0) return 0.0;
+    const float intersection_ymax = std::min<float>(box_i[2], box_j[2]);
+    const float intersection_xmax = std::min<float>(box_i[3], box_j[3]);
+    const float intersection_ymin = std::max<float>(box_i[0], box_j[0]);
+    const float intersection_xmin = std::max<float>(box_i[1], box_j[1]);
+    const float intersection_area =
+        std::max<float>(intersection_ymax - intersection_ymin, 0.0) *
+        std::max<float>(intersection_xmax - intersection_xmin, 0.0);
+    return intersection_area / (area_i + area_j - intersection_area);
+}
+
+static inline int ei_nms_cell(float v, float origin, float inv_size, int cells)
+{
+    int cell = (int)((v - origin) * inv_size);
+    return cell < 0 ? 0 : (cell >= cells ? cells - 1 : cell);
+}
+
+// Grid cells covered by box i: [x0, x1] x [y0, y1]
+static inline void ei_nms_cells(const ei_nms_workspace_t *ws, const int i, int *x0, int *y0, int *x1, int *y1)
+{
+    const float *box = &ws->corners[i * 4];
+    *y0 = ei_nms_cell(box[0], ws->grid_y0, ws->grid_inv_h, ws->grid_h);
+    *x0 = ei_nms_cell(box[1], ws->grid_x0, ws->grid_inv_w, ws->grid_w);
+    *y1 = ei_nms_cell(box[2], ws->grid_y0, ws->grid_inv_h, ws->grid_h);
+    *x1 = ei_nms_cell(box[3], ws->grid_x0, ws->grid_inv_w, ws->grid_w);
+}
+
+static inline void ei_nms_push_entry(ei_nms_workspace_t *ws, int *head, int position)
+{
+    ws->entry_selected[ws->entry_count] = position;
+    ws->entry_next[ws->entry_count] = *head;
+    *head = ws->entry_count++;
+}
+
+static inline void ei_nms_add_selected(ei_nms_workspace_t *ws, const int i, int position)
+{
+    int x0, y0, x1, y1;
+    ei_nms_cells(ws, i, &x0, &y0, &x1, &y1);
+
+    ws->selected[position] = i;
+
+    if ((x1 - x0 + 1) * (y1 - y0 + 1) > EI_NMS_MAX_CELLS_PER_BOX) {
+        ei_nms_push_entry(ws, &ws->large_head, position);
+        return;
+    }
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            ei_nms_push_entry(ws, &ws->cell_head[(cy * ws->grid_w) + cx], position);
+        }
+    }
+}
+
+/**
+ * Whether any selected box that shares a grid cell with box i has an IoU of at least iou_threshold
+ */
+static inline bool ei_nms_is_suppressed(const ei_nms_workspace_t *ws, const int i, const int *classes,
+    ei_nms_mode_t mode, const float iou_threshold)
+{
+    int x0, y0, x1, y1;
+    ei_nms_cells(ws, i, &x0, &y0, &x1, &y1);
+
+    for (int c = -1; c < (y1 - y0 + 1) * (x1 - x0 + 1); c++) {
+        int e = c < 0 ? ws->large_head :
+            ws->cell_head[((y0 + (c / (x1 - x0 + 1))) * ws->grid_w) + x0 + (c % (x1 - x0 + 1))];
+        for (; e >= 0; e = ws->entry_next[e]) {
+            int j = ws->selected[ws->entry_selected[e]];
+            if (mode == EI_NMS_CLASS_AWARE && classes[j] != classes[i]) {
+                continue;
+            }
+            if (ei_nms_iou(ws, i, j) >= iou_threshold) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Collect the selected boxes (positions in ws->selected, in [begin, end)) that share
+ * a grid cell with box i, in ws->neighbours, newest first and without duplicates.
+ * A box is listed in up to EI_NMS_MAX_CELLS_PER_BOX cells, so duplicates are dropped
+ * while collecting and ws->neighbours never holds more than end - begin entries.
+ */
+static inline size_t ei_nms_find_neighbours(ei_nms_workspace_t *ws, const int i, const int *classes,
+    ei_nms_mode_t mode, int begin, int end)
+{
+    size_t count = 0;
+
+    // only a few boxes to look at, skip the grid
+    if (end - begin <= EI_NMS_GRID_MIN_CANDIDATES) {
+        for (int s = end - 1; s >= begin; s--) {
+            if (mode == EI_NMS_CLASS_AWARE && classes[ws->selected[s]] != classes[i]) {
+                continue;
+            }
+            ws->neighbours[count++] = s;
+        }
+        return count;
+    }
+
+    // a new stamp per call, so the marks never have to be cleared (except on wrap around)
+    if (++ws->neighbour_stamp <= 0) {
+        memset(ws->neighbour_mark, 0, ws->capacity * sizeof(int));
+        ws->neighbour_stamp = 1;
+    }
+
+    int x0, y0, x1, y1;
+    ei_nms_cells(ws, i, &x0, &y0, &x1, &y1);
+
+    for (int c = -1; c < (y1 - y0 + 1) * (x1 - x0 + 1); c++) {
+        int e = c < 0 ? ws->large_head :
+            ws->cell_head[((y0 + (c / (x1 - x0 + 1))) * ws->grid_w) + x0 + (c % (x1 - x0 + 1))];
+        // lists are sorted newest first, stop at the first box selected before begin
+        for (; e >= 0 && ws->entry_selected[e] >= begin; e = ws->entry_next[e]) {
+            const int position = ws->entry_selected[e];
+            if (ws->neighbour_mark[position] == ws->neighbour_stamp) {
+                continue;
+            }
+            ws->neighbour_mark[position] = ws->neighbour_stamp;
+            if (mode == EI_NMS_CLASS_AWARE && classes[ws->selected[position]] != classes[i]) {
+                continue;
+            }
+            ws->neighbours[count++] = position;
+        }
+    }
+
+    std::sort(ws->neighbours, ws->neighbours + count, [](int a, int b) { return a > b; });
+    return count;
+}
+
+/**
+ * Non-max suppression with the same semantics as NonMaxSuppression above, without
+ * allocations (after the workspace has grown to the largest input) and with IoU
+ * tests limited to selected boxes that share a grid cell with the candidate.
+ *
+ * Hard NMS (soft_nms_sigma == 0) sorts the candidates once. Soft-NMS uses a heap
+ * in the workspace with the same ordering as the std::priority_queue above, so
+ * decayed scores come out bit-exact. With equal scores hard NMS selects the
+ * lowest box index first.
+ *
+ * @param ws Workspace, grows to num_boxes if needed
+ * @param boxes Box encodings [y1, x1, y2, x2], shape [num_boxes, 4]
+ * @param scores Score per box
+ * @param classes Class per box, only read in EI_NMS_CLASS_AWARE mode (can be nullptr otherwise)
+ * @param mode Suppress across classes or only within a class
+ * @param selected_indices Output, box index per selection, length >= max_output_size
+ * @param selected_scores Output (can be nullptr), score per selection (decayed for soft-NMS)
+ * @param num_selected_indices Output, number of selections
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_nms_run(
+    ei_nms_workspace_t *ws,
+    const float *boxes,
+    const int num_boxes,
+    const float *scores,
+    const int *classes,
+    const int max_output_size,
+    const float iou_threshold,
+    const float score_threshold,
+    const float soft_nms_sigma,
+    ei_nms_mode_t mode,
+    int *selected_indices,
+    float *selected_scores,
+    int *num_selected_indices)
+{
+    *num_selected_indices = 0;
+
+    if (mode == EI_NMS_CLASS_AWARE && !classes) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+    if (num_boxes < 1) {
+        return EI_IMPULSE_OK;
+    }
+    if (ei_nms_workspace_reserve(ws, num_boxes) != EI_IMPULSE_OK) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+
+    // candidates above the score threshold, with their corners, areas, extent and mean size
+    int num_candidates = 0;
+    float y_min = 0.f, x_min = 0.f, y_max = 0.f, x_max = 0.f;
+    float sum_h = 0.f, sum_w = 0.f;
+    for (int i = 0; i < num_boxes; ++i) {
+        const float *box = &boxes[i * 4];
+        float *corners = &ws->corners[i * 4];
+        corners[0] = std::min<float>(box[0], box[2]);
+        corners[1] = std::min<float>(box[1], box[3]);
+        corners[2] = std::max<float>(box[0], box[2]);
+        corners[3] = std::max<float>(box[1], box[3]);
+        ws->areas[i] = (corners[2] - corners[0]) * (corners[3] - corners[1]);
+
+        if (!(scores[i] > score_threshold)) {
+            continue;
+        }
+        if (num_candidates == 0) {
+            y_min = corners[0]; x_min = corners[1]; y_max = corners[2]; x_max = corners[3];
+        }
+        else {
+            y_min = std::min(y_min, corners[0]); x_min = std::min(x_min, corners[1]);
+            y_max = std::max(y_max, corners[2]); x_max = std::max(x_max, corners[3]);
+        }
+        sum_h += corners[2] - corners[0];
+        sum_w += corners[3] - corners[1];
+        ws->candidates[num_candidates++] = { i, scores[i], 0 };
+    }
+
+    int num_outputs = std::min(num_candidates, max_output_size);
+    if (num_outputs == 0) {
+        return EI_IMPULSE_OK;
+    }
+
+    // A positive IoU needs a positive intersection, so with a threshold > 0 only boxes
+    // that share a cell can suppress each other. Cells are about the size of an average
+    // box, so most boxes cover 1-4 cells. Otherwise everything goes in a single cell.
+    ws->grid_w = 1;
+    ws->grid_h = 1;
+    if (num_candidates >= EI_NMS_GRID_MIN_CANDIDATES && iou_threshold > 0.0f &&
+            sum_h > 0.0f && sum_w > 0.0f) {
+        ws->grid_h = std::min(std::max((int)((y_max - y_min) * num_candidates / sum_h), 1), EI_NMS_GRID_SIZE);
+        ws->grid_w = std::min(std::max((int)((x_max - x_min) * num_candidates / sum_w), 1), EI_NMS_GRID_SIZE);
+    }
+    ws->grid_y0 = y_min;
+    ws->grid_x0 = x_min;
+    ws->grid_inv_h = ws->grid_h > 1 ? (float)ws->grid_h / (y_max - y_min) : 0.0f;
+    ws->grid_inv_w = ws->grid_w > 1 ? (float)ws->grid_w / (x_max - x_min) : 0.0f;
+    for (int ix = 0; ix < ws->grid_w * ws->grid_h; ix++) {
+        ws->cell_head[ix] = -1;
+    }
+    ws->large_head = -1;
+    ws->entry_count = 0;
+
+    if (soft_nms_sigma <= 0.0f) {
+        // hard NMS: scores never change, so one sort gives the selection order
+        std::sort(ws->candidates, ws->candidates + num_candidates,
+            [](const ei_nms_candidate_t &a, const ei_nms_candidate_t &b) {
+                return a.score > b.score || (a.score == b.score && a.index < b.index);
+            });
+
+        for (int c = 0; c < num_candidates && *num_selected_indices < num_outputs; c++) {
+            const ei_nms_candidate_t *candidate = &ws->candidates[c];
+
+            if (!ei_nms_is_suppressed(ws, candidate->index, classes, mode, iou_threshold)) {
+                selected_indices[*num_selected_indices] = candidate->index;
+                if (selected_scores) {
+                    selected_scores[*num_selected_indices] = candidate->score;
+                }
+                ei_nms_add_selected(ws, candidate->index, *num_selected_indices);
+                ++*num_selected_indices;
+            }
+        }
+        return EI_IMPULSE_OK;
+    }
+
+    // soft-NMS: decayed candidates go back into the heap
+    auto cmp = [](const ei_nms_candidate_t &a, const ei_nms_candidate_t &b) {
+        return a.score < b.score;
+    };
+    ei_nms_candidate_t *heap = ws->candidates;
+    for (int c = 1; c <= num_candidates; c++) {
+        std::push_heap(heap, heap + c, cmp);
+    }
+    int heap_size = num_candidates;
+
+    const float scale = -0.5 / soft_nms_sigma;
+    while (*num_selected_indices < num_outputs && heap_size > 0) {
+        std::pop_heap(heap, heap + heap_size, cmp);
+        ei_nms_candidate_t next_candidate = heap[--heap_size];
+        const float original_score = next_candidate.score;
+
+        // boxes that do not overlap have IoU 0 and would scale the score by exactly 1,
+        // so only the neighbours are visited (newest first, as NonMaxSuppression does)
+        size_t neighbours = ei_nms_find_neighbours(ws, next_candidate.index, classes, mode,
+            next_candidate.suppress_begin_index, *num_selected_indices);
+
+        bool should_hard_suppress = false;
+        for (size_t n = 0; n < neighbours; n++) {
+            const float iou = ei_nms_iou(ws, next_candidate.index, ws->selected[ws->neighbours[n]]);
+            if (iou >= iou_threshold) {
+                should_hard_suppress = true;
+                break;
+            }
+            next_candidate.score = next_candidate.score * std::exp(scale * iou * iou);
+            if (next_candidate.score <= score_threshold) break;
+        }
+        next_candidate.suppress_begin_index = *num_selected_indices;
+
+        if (!should_hard_suppress) {
+            if (next_candidate.score == original_score) {
+                selected_indices[*num_selected_indices] = next_candidate.index;
+                if (selected_scores) {
+                    selected_scores[*num_selected_indices] = next_candidate.score;
+                }
+                ei_nms_add_selected(ws, next_candidate.index, *num_selected_indices);
+                ++*num_selected_indices;
+            }
+            if (next_candidate.score > score_threshold) {
+                heap[heap_size++] = next_candidate;
+                std::push_heap(heap, heap + heap_size, cmp);
+            }
+        }
+    }
+    return EI_IMPULSE_OK;
+}
+
 /**
  * Run non-max suppression over the results array (for bounding boxes)
  */
@@ -231,45 +540,46 @@ EI_IMPULSE_ERROR ei_run_nms(
         return EI_IMPULSE_OK;
     }
 
-    int *selected_indices = (int*)ei_malloc(1 * bb_count * sizeof(int));
-    float *selected_scores = (float*)ei_malloc(1 * bb_count * sizeof(float));
-
-    if (!scores || !boxes || !selected_indices || !selected_scores || !classes) {
-        ei_free(selected_indices);
-        ei_free(selected_scores);
+    if (!scores || !boxes || !classes) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
 
-    //  boxes: box encodings in format [y1, x1, y2, x2], shape: [num_boxes, 4]
-    //  num_boxes: number of candidates
-    //  scores: scores for candidate boxes, in the same order. shape: [num_boxes]
-    //  max_output_size: the maximum number of selections.
-    //  iou_threshold: Intersection-over-Union (IoU) threshold for NMS
-    //  score_threshold: All candidate scores below this value are rejected
-    //  soft_nms_sigma: Soft NMS parameter, used for decaying scores
+    ei_nms_workspace_t *ws = &ei_nms_default_workspace;
+    if (ei_nms_workspace_reserve_staging(ws, bb_count) != EI_IMPULSE_OK) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
 
     int num_selected_indices;
 
-    NonMaxSuppression(
-        (const float*)boxes, // boxes
-        bb_count, // num_boxes
-        (const float*)scores, // scores
+    EI_IMPULSE_ERROR nms_res = ei_nms_run(
+        ws,
+        (const float*)boxes,
+        bb_count,
+        (const float*)scores,
+        classes,
         bb_count, // max_output_size
-        nms_config->iou_threshold, // iou_threshold
-        nms_config->confidence_threshold, // score_threshold
-        0.0f, // soft_nms_sigma
-        selected_indices,
-        selected_scores,
+        nms_config->iou_threshold,
+        nms_config->confidence_threshold,
+        EI_CLASSIFIER_NMS_SOFT_SIGMA,
+        EI_CLASSIFIER_NMS_CLASS_AWARE ? EI_NMS_CLASS_AWARE : EI_NMS_CLASS_AGNOSTIC,
+        ws->selected_indices,
+        ws->selected_scores,
         &num_selected_indices);
 
-    std::vector<ei_impulse_result_bounding_box_t> new_results;
+    if (nms_res != EI_IMPULSE_OK) {
+        return nms_res;
+    }
+
+    // boxes, scores and classes never point into results, so it can be rebuilt in place
+    results->clear();
+    results->reserve(num_selected_indices);
 
     for (size_t ix = 0; ix < (size_t)num_selected_indices; ix++) {
 
-        int out_ix = selected_indices[ix];
+        int out_ix = ws->selected_indices[ix];
         ei_impulse_result_bounding_box_t bb;
         bb.label  = impulse->categories[classes[out_ix]];
-        bb.value  = selected_scores[ix];
+        bb.value  = ws->selected_scores[ix];
 
         float ymin = boxes[(out_ix * 4) + 0];
         float xmin = boxes[(out_ix * 4) + 1];
@@ -287,20 +597,11 @@ EI_IMPULSE_ERROR ei_run_nms(
         bb.x      = static_cast<uint32_t>(xmin);
         bb.height = static_cast<uint32_t>(ymax) - bb.y;
         bb.width  = static_cast<uint32_t>(xmax) - bb.x;
-        new_results.push_back(bb);
+        results->push_back(bb);
 
         EI_LOGD("Found bb with label %s\n", bb.label);
     }
 
-    results->clear();
-
-    for (size_t ix = 0; ix < new_results.size(); ix++) {
-        results->push_back(new_results[ix]);
-    }
-
-    ei_free(selected_indices);
-    ei_free(selected_scores);
-
     return EI_IMPULSE_OK;
 
 }
@@ -317,8 +618,7 @@ EI_IMPULSE_ERROR ei_run_nms(
 
     size_t bb_count = 0;
     for (size_t ix = 0; ix < results->size(); ix++) {
-        auto bb = results->at(ix);
-        if (bb.value == 0) {
+        if (results->at(ix).value == 0) {
             continue;
         }
         bb_count++;
@@ -328,20 +628,19 @@ EI_IMPULSE_ERROR ei_run_nms(
         return EI_IMPULSE_OK;
     }
 
-    float *boxes = (float*)ei_malloc(4 * bb_count * sizeof(float));
-    float *scores = (float*)ei_malloc(1 * bb_count * sizeof(float));
-    int *classes = (int*) ei_malloc(bb_count * sizeof(int));
-
-    if (!scores || !boxes || !classes) {
-        ei_free(boxes);
-        ei_free(scores);
-        ei_free(classes);
+    // boxes are staged in the workspace, ei_run_nms below reserves the same size so they stay put
+    ei_nms_workspace_t *ws = &ei_nms_default_workspace;
+    if (ei_nms_workspace_reserve_staging(ws, bb_count) != EI_IMPULSE_OK) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
 
+    float *boxes = ws->staging_boxes;
+    float *scores = ws->staging_scores;
+    int *classes = ws->staging_classes;
+
     size_t box_ix = 0;
     for (size_t ix = 0; ix < results->size(); ix++) {
-        auto bb = results->at(ix);
+        const ei_impulse_result_bounding_box_t &bb = results->at(ix);
         if (bb.value == 0) {
             continue;
         }
@@ -359,25 +658,18 @@ EI_IMPULSE_ERROR ei_run_nms(
         box_ix++;
     }
 
-    EI_IMPULSE_ERROR nms_res = ei_run_nms(impulse,
-                                          results,
-                                          boxes,
-                                          scores,
-                                          classes,
-                                          bb_count,
-                                          clip_boxes,
-                                          nms_config);
-
-
-    ei_free(boxes);
-    ei_free(scores);
-    ei_free(classes);
-
-    return nms_res;
+    return ei_run_nms(impulse,
+                      results,
+                      boxes,
+                      scores,
+                      classes,
+                      bb_count,
+                      clip_boxes,
+                      nms_config);
 
 }
 
-#endif // (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE)
+#endif // EI_NMS_ENABLED
 
 #if (EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLO || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX)
 
@@ -0,0 +1,135 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EDGE_IMPULSE_NMS_WORKSPACE_H_
+#define _EDGE_IMPULSE_NMS_WORKSPACE_H_
+
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+
+// Object detection models that run non-max suppression (ei_nms.h)
+#define EI_NMS_ENABLED (EI_HAS_YOLOV5 || EI_HAS_YOLOX || EI_HAS_TAO_DECODE_DETECTIONS || EI_HAS_TAO_YOLOV3 || \
+    EI_HAS_TAO_YOLOV4 || EI_HAS_YOLOV2 || EI_HAS_YOLO_PRO || EI_HAS_YOLOV11 || EI_HAS_QC_FACE_DET_LITE || EI_HAS_QC_YOLOX)
+
+// Maximum grid cells per side of the spatial index used by ei_nms_run
+#ifndef EI_NMS_GRID_SIZE
+#define EI_NMS_GRID_SIZE                    16
+#endif // EI_NMS_GRID_SIZE
+
+// Below this number of candidates every candidate is tested against every selected box
+#ifndef EI_NMS_GRID_MIN_CANDIDATES
+#define EI_NMS_GRID_MIN_CANDIDATES          32
+#endif // EI_NMS_GRID_MIN_CANDIDATES
+
+// Only suppress boxes of the same class in ei_run_nms (0 = suppress across classes)
+#ifndef EI_CLASSIFIER_NMS_CLASS_AWARE
+#define EI_CLASSIFIER_NMS_CLASS_AWARE       0
+#endif // EI_CLASSIFIER_NMS_CLASS_AWARE
+
+// Soft-NMS sigma used by ei_run_nms (0 = hard NMS)
+#ifndef EI_CLASSIFIER_NMS_SOFT_SIGMA
+#define EI_CLASSIFIER_NMS_SOFT_SIGMA        0.0f
+#endif // EI_CLASSIFIER_NMS_SOFT_SIGMA
+
+// A selected box is stored in every grid cell it covers, up to this many (otherwise in a shared list)
+#define EI_NMS_MAX_CELLS_PER_BOX            4
+
+typedef enum {
+    EI_NMS_CLASS_AGNOSTIC = 0,  // any selected box can suppress a candidate
+    EI_NMS_CLASS_AWARE = 1      // only selected boxes of the same class suppress a candidate
+} ei_nms_mode_t;
+
+typedef struct {
+    int index;
+    float score;
+    int suppress_begin_index;
+} ei_nms_candidate_t;
+
+/**
+ * Buffers for ei_nms_run. Allocated once by ei_nms_workspace_reserve and reused
+ * across calls, it only grows when more candidates come in than ever before.
+ */
+typedef struct {
+    size_t capacity;
+    void *buffer;
+    ei_nms_candidate_t *candidates;
+    float *corners;             // [ymin, xmin, ymax, xmax] per candidate box, min / max already applied
+    float *areas;               // per candidate box
+    int *selected;              // candidate box index per selected box
+    int *neighbours;            // scratch for soft-NMS
+    int *neighbour_mark;        // per selected box, neighbour_stamp once it is in neighbours
+    int neighbour_stamp;
+
+    // grid: per cell a list of selected boxes (newest first), boxes that cover
+    // more than EI_NMS_MAX_CELLS_PER_BOX cells go in the large list instead
+    int *entry_selected;
+    int *entry_next;
+    int entry_count;
+    int cell_head[EI_NMS_GRID_SIZE * EI_NMS_GRID_SIZE];
+    int large_head;
+    int grid_w, grid_h;
+    float grid_x0, grid_y0, grid_inv_w, grid_inv_h;
+
+    // staging for ei_run_nms over a results vector
+    size_t staging_capacity;
+    void *staging_buffer;
+    float *staging_boxes;
+    float *staging_scores;
+    int *staging_classes;
+    int *selected_indices;
+    float *selected_scores;
+} ei_nms_workspace_t;
+
+// Workspace used by ei_run_nms, kept between inferences (ei_nms.cpp)
+extern ei_nms_workspace_t ei_nms_default_workspace;
+
+void ei_nms_workspace_free(ei_nms_workspace_t *ws);
+
+/**
+ * Make sure the workspace can hold num_boxes candidates
+ */
+EI_IMPULSE_ERROR ei_nms_workspace_reserve(ei_nms_workspace_t *ws, size_t num_boxes);
+
+/**
+ * Make sure the staging buffers (boxes, scores, classes and selections as passed
+ * to ei_run_nms) can hold num_boxes boxes
+ */
+EI_IMPULSE_ERROR ei_nms_workspace_reserve_staging(ei_nms_workspace_t *ws, size_t num_boxes);
+
+/**
+ * Free the buffers of the default workspace, called from run_classifier_deinit
+ */
+void ei_nms_release_workspace(void);
+
+#endif // _EDGE_IMPULSE_NMS_WORKSPACE_H_
@@ -37,6 +37,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+
+/** Elements converted per step by the block kernels (1, 4 or 8), wider steps let the compiler vectorize */
+#ifndef EI_QUANTIZE_LANES
+#define EI_QUANTIZE_LANES   8
+#endif
 
 static int32_t pre_cast_quantize(float value, float scale, int32_t zero_point, bool is_signed) {
 
@@ -46,4 +54,266 @@ static int32_t pre_cast_quantize(float value, float scale, int32_t zero_point, b
     return std::min( std::max( static_cast<int32_t>(round(value / scale)) + zero_point, min_value), max_value);
 }
 
+/**
+ * The estimate is floor(value / scale + 0.5 - 2^-10), computed as a truncation after
+ * adding an offset that keeps the sum positive (the clamped quotient stays within
+ * +-1300). The 2^-10 bias is larger than the error of the reciprocal multiply and of
+ * the offset add, so the estimate is the exact result or one below it.
+ */
+#define EI_QUANTIZE_OFFSET          2048
+#define EI_QUANTIZE_ROUND_OFFSET    (2048.0f + 0.5f - 0.0009765625f)
+
+/**
+ * Precomputed parameters for the block quantize kernels.
+ *
+ * The kernels estimate the output with a multiply by the reciprocal of the scale
+ * and then correct it by at most one step up against `thresholds`, the exact decision
+ * boundaries of pre_cast_quantize(). The result is bit-exact with pre_cast_quantize()
+ * wherever that is defined; outside of it (NaN, |value / scale| >= 2^31) the kernels
+ * behave like the Arm conversion: large values saturate, NaN maps to the zero point.
+ */
+typedef struct {
+    float scale;
+    int32_t zero_point;
+    bool is_signed;
+    // false when the scale can't be used for the fast path (0, negative, not finite),
+    // the kernels then call pre_cast_quantize() per element
+    bool exact;
+    int32_t min_value;
+    int32_t max_value;
+    float inv_scale;
+    // estimate is clamped to [lo, hi] (in steps, before adding the zero point)
+    float lo;
+    float hi;
+    // thresholds[i]: smallest input that quantizes to at least min_value + i,
+    // [0] is -inf and [256] NaN so the correction never leaves the output range
+    float thresholds[257];
+} ei_quantize_params_t;
+
+/**
+ * Fill the kernel parameters for a tensor's scale and zero point
+ * Finds every decision boundary of pre_cast_quantize() by stepping a few floats
+ * around the ideal boundary (zero_point + k - 0.5) * scale.
+ */
+__attribute__((unused)) static void ei_quantize_init_params(ei_quantize_params_t *params, float scale, int32_t zero_point, bool is_signed)
+{
+    params->scale = scale;
+    params->zero_point = zero_point;
+    params->is_signed = is_signed;
+    params->min_value = is_signed ? -128 : 0;
+    params->max_value = is_signed ? 127 : 255;
+    params->inv_scale = 1.0f / scale;
+    params->lo = static_cast<float>(params->min_value - zero_point - 1);
+    params->hi = static_cast<float>(params->max_value - zero_point + 1);
+    params->exact = false;
+
+    if (!(scale > 0.0f) || !std::isfinite(scale) || !std::isfinite(params->inv_scale)
+        || zero_point < -1024 || zero_point > 1024) {
+        return;
+    }
+
+    params->thresholds[0] = -INFINITY;
+    params->thresholds[256] = NAN;
+
+    for (int32_t k = params->min_value + 1; k <= params->max_value; k++) {
+        float v = (static_cast<float>(k - zero_point) - 0.5f) * scale;
+        if (!std::isfinite(v)) {
+            return;
+        }
+
+        int steps = 0;
+        if (pre_cast_quantize(v, scale, zero_point, is_signed) >= k) {
+            // walk down while the previous float still reaches k
+            for (;;) {
+                float prev = std::nextafter(v, -INFINITY);
+                if (pre_cast_quantize(prev, scale, zero_point, is_signed) < k) {
+                    break;
+                }
+                v = prev;
+                if (++steps > 64) {
+                    return;
+                }
+            }
+        }
+        else {
+            // walk up until k is reached
+            do {
+                v = std::nextafter(v, INFINITY);
+                if (++steps > 64) {
+                    return;
+                }
+            } while (pre_cast_quantize(v, scale, zero_point, is_signed) < k);
+        }
+        params->thresholds[k - params->min_value] = v;
+    }
+
+    params->exact = true;
+}
+
+/**
+ * Parameters for (scale, zero_point, is_signed), rebuilt only when they change
+ * between calls (inputs of the same model share them)
+ */
+__attribute__((unused)) static const ei_quantize_params_t *ei_quantize_get_params(float scale, int32_t zero_point, bool is_signed)
+{
+    static ei_quantize_params_t cached;
+    static bool cached_valid = false;
+
+    if (!cached_valid || cached.scale != scale || cached.zero_point != zero_point || cached.is_signed != is_signed) {
+        ei_quantize_init_params(&cached, scale, zero_point, is_signed);
+        cached_valid = true;
+    }
+    return &cached;
+}
+
+/**
+ * Quantize one value, same result as pre_cast_quantize()
+ */
+__attribute__((unused)) static inline int32_t ei_quantize_one(const ei_quantize_params_t *params, float value)
+{
+    if (!params->exact) {
+        return pre_cast_quantize(value, params->scale, params->zero_point, params->is_signed);
+    }
+
+    float t = value * params->inv_scale;
+    t = (t == t) ? t : 0.0f;
+    t = t < params->lo ? params->lo : t;
+    t = t > params->hi ? params->hi : t;
+    int32_t q = static_cast<int32_t>(t + EI_QUANTIZE_ROUND_OFFSET) - EI_QUANTIZE_OFFSET + params->zero_point;
+    q = q < params->min_value ? params->min_value : q;
+    q = q > params->max_value ? params->max_value : q;
+
+    int32_t i = q - params->min_value;
+    i += static_cast<int32_t>(value >= params->thresholds[i + 1]);
+    return i + params->min_value;
+}
+
+namespace ei {
+namespace quantize {
+
+/**
+ * Shared body of the block kernels: out[i] = quantize((in[i] - mean[i]) * mul[i]),
+ * or quantize(in[i]) without normalization
+ */
+template <typename T, bool normalize, int lanes>
+static void block_impl(const float *in, const float *mean, const float *mul, T *out, size_t n, const ei_quantize_params_t *params)
+{
+    size_t ix = 0;
+
+    if (params->exact) {
+        const float inv_scale = params->inv_scale;
+        const float lo = params->lo;
+        const float hi = params->hi;
+        const int32_t zero_point = params->zero_point;
+        const int32_t min_value = params->min_value;
+        const int32_t max_value = params->max_value;
+        const float *thresholds = params->thresholds;
+
+        for (; ix + lanes <= n; ix += lanes) {
+            float v[lanes];
+            int32_t q[lanes];
+
+            // estimate, independent per lane
+            for (int lane = 0; lane < lanes; lane++) {
+                float x = in[ix + lane];
+                if (normalize) {
+                    x = (x - mean[ix + lane]) * mul[ix + lane];
+                }
+                v[lane] = x;
+                float t = x * inv_scale;
+                t = (t == t) ? t : 0.0f;
+                t = t < lo ? lo : t;
+                t = t > hi ? hi : t;
+                int32_t e = static_cast<int32_t>(t + EI_QUANTIZE_ROUND_OFFSET) - EI_QUANTIZE_OFFSET + zero_point;
+                e = e < min_value ? min_value : e;
+                e = e > max_value ? max_value : e;
+                q[lane] = e - min_value;
+            }
+
+            // correct against the exact boundaries
+            for (int lane = 0; lane < lanes; lane++) {
+                int32_t i = q[lane];
+                i += static_cast<int32_t>(v[lane] >= thresholds[i + 1]);
+                out[ix + lane] = static_cast<T>(i + min_value);
+            }
+        }
+    }
+
+    for (; ix < n; ix++) {
+        float x = in[ix];
+        if (normalize) {
+            x = (x - mean[ix]) * mul[ix];
+        }
+        out[ix] = static_cast<T>(ei_quantize_one(params, x));
+    }
+}
+
+template <typename T, bool normalize>
+static void block(const float *in, const float *mean, const float *mul, T *out, size_t n, const ei_quantize_params_t *params)
+{
+    EI_PROFILE_SCOPE("quantize");
+
+#if EI_QUANTIZE_LANES == 8
+    block_impl<T, normalize, 8>(in, mean, mul, out, n, params);
+#elif EI_QUANTIZE_LANES == 4
+    block_impl<T, normalize, 4>(in, mean, mul, out, n, params);
+#else
+    block_impl<T, normalize, 1>(in, mean, mul, out, n, params);
+#endif
+}
+
+} // namespace quantize
+} // namespace ei
+
+/**
+ * Quantize a block of floats to int8 / uint8, bit-exact with pre_cast_quantize()
+ * (params->is_signed must match the output type)
+ */
+__attribute__((unused)) static void ei_quantize_block(const float *in, int8_t *out, size_t n, const ei_quantize_params_t *params)
+{
+    ei::quantize::block<int8_t, false>(in, NULL, NULL, out, n, params);
+}
+
+__attribute__((unused)) static void ei_quantize_block(const float *in, uint8_t *out, size_t n, const ei_quantize_params_t *params)
+{
+    ei::quantize::block<uint8_t, false>(in, NULL, NULL, out, n, params);
+}
+
+/**
+ * Normalize and quantize in one pass: out[i] = quantize((in[i] - mean[i]) * mul[i]).
+ * Same arithmetic as the standard scaler (subtract the mean, multiply by 1/std)
+ * followed by ei_quantize_block(), without writing the normalized floats back.
+ */
+__attribute__((unused)) static void ei_quantize_block_normalized(const float *in, const float *mean, const float *mul, int8_t *out, size_t n, const ei_quantize_params_t *params)
+{
+    ei::quantize::block<int8_t, true>(in, mean, mul, out, n, params);
+}
+
+__attribute__((unused)) static void ei_quantize_block_normalized(const float *in, const float *mean, const float *mul, uint8_t *out, size_t n, const ei_quantize_params_t *params)
+{
+    ei::quantize::block<uint8_t, true>(in, mean, mul, out, n, params);
+}
+
+/**
+ * Dequantize a block of an output tensor: out[i] = (in[i] - zero_point) * scale
+ * (same expression the result handlers use per element)
+ */
+__attribute__((unused)) static void ei_dequantize_block(const int8_t *in, float *out, size_t n, float scale, float zero_point)
+{
+    EI_PROFILE_SCOPE("dequantize");
+
+    for (size_t ix = 0; ix < n; ix++) {
+        out[ix] = (static_cast<float>(in[ix]) - zero_point) * scale;
+    }
+}
+
+__attribute__((unused)) static void ei_dequantize_block(const uint8_t *in, float *out, size_t n, float scale, float zero_point)
+{
+    EI_PROFILE_SCOPE("dequantize");
+
+    for (size_t ix = 0; ix < n; ix++) {
+        out[ix] = (static_cast<float>(in[ix]) - zero_point) * scale;
+    }
+}
+
 #endif  //!__EI_QUANTIZE__H__
\ No newline at end of file
@@ -47,7 +47,9 @@
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 #include <memory>
+#include <utility>
 
 #if EI_CLASSIFIER_LOAD_ANOMALY_H
 #include "inferencing_engines/anomaly.h"
@@ -57,10 +59,18 @@
 #include "ei_sampler.h"
 #endif
 
+// Also build the TFLite Micro interpreter next to an EON compiled model, to run models loaded at runtime
+#ifndef EI_CLASSIFIER_LOADABLE_MODEL
+#define EI_CLASSIFIER_LOADABLE_MODEL 0
+#endif // EI_CLASSIFIER_LOADABLE_MODEL
+
 #if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_micro.h"
 #elif EI_CLASSIFIER_COMPILED == 1
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_eon.h"
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_LOADABLE_MODEL == 1)
+#include "edge-impulse-sdk/classifier/inferencing_engines/tflite_micro.h"
+#endif
 #elif EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_FULL
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_full.h"
 #elif EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_TIDL
@@ -98,6 +108,16 @@
 // This file has an implicit dependency on ei_run_dsp.h, so must come after that include!
 #include "model-parameters/model_variables.h"
 
+// Feed per-stage timings of every process_impulse / process_impulse_continuous call to the application
+#ifndef EI_CLASSIFIER_TELEMETRY
+#define EI_CLASSIFIER_TELEMETRY 0
+#endif // EI_CLASSIFIER_TELEMETRY
+
+#if EI_CLASSIFIER_TELEMETRY == 1
+// Implemented by the application, called with the result (timing in us) and the return value
+extern void ei_telemetry_record_inference(const ei_impulse_result_t *result, EI_IMPULSE_ERROR res, bool continuous, uint64_t total_us);
+#endif // EI_CLASSIFIER_TELEMETRY == 1
+
 #ifdef __cplusplus
 namespace {
 #endif // __cplusplus
@@ -116,12 +136,91 @@ EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fm
 /* Private variables ------------------------------------------------------- */
 
 static uint64_t classifier_continuous_features_written = 0;
+// feature window of run_classifier_continuous(), nn_input_frame_size features
+static float *classifier_continuous_features = nullptr;
+static size_t classifier_continuous_features_size = 0;
+
+#if EIDSP_SCRATCH_ARENA
+// size of the arena shared between DSP scratch and the NN tensor arena
+#ifndef EI_CLASSIFIER_SCRATCH_ARENA_SIZE
+#if defined(EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE) && EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE > 0
+#define EI_CLASSIFIER_SCRATCH_ARENA_SIZE    EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE
+#else
+#error "EIDSP_SCRATCH_ARENA requires EI_CLASSIFIER_SCRATCH_ARENA_SIZE to be defined for this inferencing engine"
+#endif
+#endif // EI_CLASSIFIER_SCRATCH_ARENA_SIZE
+
+// keep the arena in a static buffer instead of allocating it on first use
+#ifndef EI_CLASSIFIER_SCRATCH_ARENA_STATIC
+#ifdef EI_CLASSIFIER_ALLOCATION_STATIC
+#define EI_CLASSIFIER_SCRATCH_ARENA_STATIC  1
+#else
+#define EI_CLASSIFIER_SCRATCH_ARENA_STATIC  0
+#endif
+#endif // EI_CLASSIFIER_SCRATCH_ARENA_STATIC
+
+#if defined(EI_CLASSIFIER_ALLOCATION_STATIC) && (EI_CLASSIFIER_COMPILED == 1)
+// EON compiled models ignore the allocator with EI_CLASSIFIER_ALLOCATION_STATIC and keep a
+// static tensor arena of their own, so nothing would be shared
+#error "EIDSP_SCRATCH_ARENA with EON: build without EI_CLASSIFIER_ALLOCATION_STATIC, EI_CLASSIFIER_SCRATCH_ARENA_STATIC=1 keeps the shared arena static"
+#endif
+
+#if EI_CLASSIFIER_SCRATCH_ARENA_STATIC
+// DSP scratch while the DSP blocks run, the tensor arena of the NN afterwards
+static uint8_t ei_scratch_arena_buffer[EI_CLASSIFIER_SCRATCH_ARENA_SIZE] __attribute__((aligned(16)));
+#endif
+#endif // EIDSP_SCRATCH_ARENA
 
 /* Private functions ------------------------------------------------------- */
 
 /* These functions (up to Public functions section) are not exposed to end-user,
 therefore changes are allowed. */
 
+/**
+ * @brief      Attach the impulse scratch arena (lazily, on first use)
+ *
+ * @return     The ei impulse error.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_scratch_arena_init(void)
+{
+#if EIDSP_SCRATCH_ARENA
+    if (ei::scratch_arena::is_attached()) {
+        return EI_IMPULSE_OK;
+    }
+
+#if EI_CLASSIFIER_SCRATCH_ARENA_STATIC
+    void *buffer = ei_scratch_arena_buffer;
+#else
+    void *buffer = ei_aligned_calloc(16, EI_CLASSIFIER_SCRATCH_ARENA_SIZE);
+    if (!buffer) {
+        ei_printf("ERR: Failed to allocate scratch arena (%d bytes)\n", (int)EI_CLASSIFIER_SCRATCH_ARENA_SIZE);
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+#endif
+    if (ei::scratch_arena::attach(buffer, EI_CLASSIFIER_SCRATCH_ARENA_SIZE) != ei::EIDSP_OK) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+#endif // EIDSP_SCRATCH_ARENA
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Detach and free the impulse scratch arena
+ */
+__attribute__((unused)) static void ei_scratch_arena_deinit(void)
+{
+#if EIDSP_SCRATCH_ARENA
+    void *buffer = ei::scratch_arena::detach();
+#if !EI_CLASSIFIER_SCRATCH_ARENA_STATIC
+    if (buffer) {
+        ei_aligned_free(buffer);
+    }
+#else
+    (void)buffer;
+#endif
+#endif // EIDSP_SCRATCH_ARENA
+}
+
 /**
  * @brief      Display the results of the inference
  *
@@ -151,6 +250,8 @@ extern "C" EI_IMPULSE_ERROR run_inference(
 {
     auto& impulse = handle->impulse;
     for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+        EI_PROFILE_SCOPE("inference");
+        EI_ALLOC_TAG_SCOPE(EI_ALLOC_TAG_NN);
 
         ei_learning_block_t block = impulse->learning_blocks[ix];
 
@@ -198,21 +299,10 @@ extern "C" EI_IMPULSE_ERROR run_inference(
     return EI_IMPULSE_OK;
 }
 
-/**
- * @brief      Process a complete impulse
- *
- * @param      impulse  struct with information about model and DSP
- * @param      signal   Sample data
- * @param      result   Output classifier results
- * @param      handle   Handle from open_impulse. nullptr for backward compatibility
- * @param[in]  debug    Debug output enable
- *
- * @return     The ei impulse error.
- */
-extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
-                                            signal_t *signal,
-                                            ei_impulse_result_t *result,
-                                            bool debug = false)
+static EI_IMPULSE_ERROR process_impulse_stages(ei_impulse_handle_t *handle,
+                                               signal_t *signal,
+                                               ei_impulse_result_t *result,
+                                               bool debug)
 {
     if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
         return EI_IMPULSE_INFERENCE_ERROR;
@@ -282,6 +372,11 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 #endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ONNX_TIDL) || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ATON
     uint32_t block_num = handle->impulse->dsp_blocks_size;
 
+    res = ei_scratch_arena_init();
+    if (res != EI_IMPULSE_OK) {
+        return res;
+    }
+
     // smart pointer to features array
     std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
     ei_feature_t* features = features_ptr.get();
@@ -298,7 +393,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     std::unique_ptr<ei::matrix_t> *matrix_ptrs = matrix_ptrs_ptr.get();
 
     if (matrix_ptrs == nullptr) {
-        delete[] matrix_ptrs;
         ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
         return EI_IMPULSE_ALLOC_FAILED;
     }
@@ -308,6 +402,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
     size_t out_features_index = 0;
 
     for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
+        EI_ALLOC_TAG_SCOPE(EI_ALLOC_TAG_DSP);
         ei_model_dsp_t block = handle->impulse->dsp_blocks[ix];
 
         matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
@@ -318,7 +413,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
         if (matrix_ptrs[ix]->buffer == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-            delete[] matrix_ptrs;
             return EI_IMPULSE_ALLOC_FAILED;
         }
 
@@ -341,6 +435,8 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
         auto internal_signal = swa.get_signal();
 #endif
 
+        EI_PROFILE_SCOPE("dsp");
+
         int ret;
         if (block.factory) { // ie, if we're using state
             // Msg user
@@ -364,6 +460,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
                 return EI_IMPULSE_OUT_OF_MEMORY;
             }
         } else {
+#if EIDSP_SCRATCH_ARENA
+            // stateless blocks get their scratch from the arena, it's released before inference
+            ei::scratch_arena_scope dsp_scratch_scope;
+#endif
             ret = block.extract_fn(internal_signal, features[ix].matrix, block.config, handle->impulse->frequency);
         }
 
@@ -414,6 +514,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 #else
     res = run_inference(handle, features, result, debug);
     if (res != EI_IMPULSE_OK) {
+        free_raw_outputs(handle, result);
         return res;
     }
 
@@ -428,6 +529,34 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 #endif
 }
 
+/**
+ * @brief      Process a complete impulse
+ *
+ * @param      impulse  struct with information about model and DSP
+ * @param      signal   Sample data
+ * @param      result   Output classifier results
+ * @param      handle   Handle from open_impulse. nullptr for backward compatibility
+ * @param[in]  debug    Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
+                                            signal_t *signal,
+                                            ei_impulse_result_t *result,
+                                            bool debug = false)
+{
+#if EI_CLASSIFIER_TELEMETRY == 1
+    uint64_t start_us = ei_read_timer_us();
+    EI_IMPULSE_ERROR res = process_impulse_stages(handle, signal, result, debug);
+    if (result != nullptr) {
+        ei_telemetry_record_inference(result, res, false, ei_read_timer_us() - start_us);
+    }
+    return res;
+#else
+    return process_impulse_stages(handle, signal, result, debug);
+#endif // EI_CLASSIFIER_TELEMETRY == 1
+}
+
 /**
  * @brief      Opens an impulse
  *
@@ -443,22 +572,13 @@ extern "C" EI_IMPULSE_ERROR init_impulse(ei_impulse_handle_t *handle) {
     return EI_IMPULSE_OK;
 }
 
-/**
- * @brief      Process a complete impulse for continuous inference
- *
- * @param      handle               struct with information about model and DSP
- * @param      signal               Sample data
- * @param      result               Output classifier results
- * @param[in]  debug                Debug output enable
- *
- * @return     The ei impulse error.
- */
-extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
-                                                       signal_t *signal,
-                                                       ei_impulse_result_t *result,
-                                                       bool debug = false)
+static EI_IMPULSE_ERROR process_impulse_continuous_stages(ei_impulse_handle_t *handle,
+                                                          signal_t *signal,
+                                                          ei_impulse_result_t *result,
+                                                          bool debug)
 {
-    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
+    // signal is nullptr for run_classifier_continuous_window(), the window is classified as it is
+    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr)) {
         return EI_IMPULSE_INFERENCE_ERROR;
     }
 
@@ -506,18 +626,29 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
 
     auto impulse = handle->impulse;
-    static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
-    if (!static_features_matrix.buffer) {
+    if (classifier_continuous_features_size != impulse->nn_input_frame_size) {
+        if (classifier_continuous_features) {
+            ei_free(classifier_continuous_features);
+        }
+        classifier_continuous_features = (float *)ei_calloc(impulse->nn_input_frame_size, sizeof(float));
+        classifier_continuous_features_size = classifier_continuous_features ? impulse->nn_input_frame_size : 0;
+        classifier_continuous_features_written = 0;
+    }
+    if (!classifier_continuous_features) {
         return EI_IMPULSE_ALLOC_FAILED;
     }
+    ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size, classifier_continuous_features);
 
-    EI_IMPULSE_ERROR ei_impulse_error = EI_IMPULSE_OK;
+    EI_IMPULSE_ERROR ei_impulse_error = ei_scratch_arena_init();
+    if (ei_impulse_error != EI_IMPULSE_OK) {
+        return ei_impulse_error;
+    }
 
     uint64_t dsp_start_us = ei_read_timer_us();
 
     size_t out_features_index = 0;
 
-    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+    for (size_t ix = 0; signal != nullptr && ix < impulse->dsp_blocks_size; ix++) {
         ei_model_dsp_t block = impulse->dsp_blocks[ix];
 
         if (out_features_index + block.n_output_features > impulse->nn_input_frame_size) {
@@ -530,7 +661,17 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
         int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size);
 
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+        const ei_static_dsp_fns_t *static_fns = ei_static_dsp_find(ei_static_dsp_fns, ei_static_dsp_fns_size, block.extract_fn);
+#endif
+
         /* Switch to the slice version of the mfcc feature extract function */
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+        if (static_fns) {
+            extract_fn_slice = static_fns->extract_per_slice_fn;
+        }
+        else
+#endif
         if (block.extract_fn == extract_mfcc_features) {
             extract_fn_slice = &extract_mfcc_per_slice_features;
         }
@@ -540,13 +681,22 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         else if (block.extract_fn == extract_mfe_features) {
             extract_fn_slice = &extract_mfe_per_slice_features;
         }
+        else if (block.extract_fn == extract_spectral_analysis_features) {
+            extract_fn_slice = &extract_spectral_analysis_per_slice_features;
+        }
         else {
-            ei_printf("ERR: Unknown extract function, only MFCC, MFE and spectrogram supported\n");
+            ei_printf("ERR: Unknown extract function, only MFCC, MFE, spectrogram and spectral analysis supported\n");
             return EI_IMPULSE_DSP_ERROR;
         }
 
+        EI_PROFILE_SCOPE("dsp.slice");
+        EI_ALLOC_TAG_SCOPE(EI_ALLOC_TAG_DSP);
+
         matrix_size_t features_written;
 
+#if EIDSP_SCRATCH_ARENA
+        ei::scratch_arena::mark_t dsp_scratch_mark = ei::scratch_arena::mark();
+#endif
 #if EIDSP_SIGNAL_C_FN_POINTER
         if (block.axes_size != impulse->raw_samples_per_frame) {
             ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
@@ -557,6 +707,9 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
         int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written);
 #endif
+#if EIDSP_SCRATCH_ARENA
+        ei::scratch_arena::release(dsp_scratch_mark);
+#endif
 
         if (ret != EIDSP_OK) {
             ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
@@ -589,7 +742,8 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         memset(features, 0, sizeof(ei_feature_t) * block_num);
 
         // have it outside of the loop to avoid going out of scope
-        std::unique_ptr<ei::matrix_t> *matrix_ptrs = new std::unique_ptr<ei::matrix_t>[block_num];
+        std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> matrix_ptrs_ptr(new std::unique_ptr<ei::matrix_t>[block_num]);
+        std::unique_ptr<ei::matrix_t> *matrix_ptrs = matrix_ptrs_ptr.get();
         if (matrix_ptrs == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
             return EI_IMPULSE_ALLOC_FAILED;
@@ -598,6 +752,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         out_features_index = 0;
         // iterate over every dsp block and run normalization
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+            EI_ALLOC_TAG_SCOPE(EI_ALLOC_TAG_DSP);
             ei_model_dsp_t block = impulse->dsp_blocks[ix];
             matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
 
@@ -608,7 +763,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
             if (matrix_ptrs[ix]->buffer == nullptr) {
                 ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                delete[] matrix_ptrs;
                 return EI_IMPULSE_ALLOC_FAILED;
             }
 
@@ -620,6 +774,17 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
                 features[ix].matrix->buffer[m_ix] = static_features_matrix.buffer[out_features_index + m_ix];
             }
 
+#if EIDSP_SCRATCH_ARENA
+            ei::scratch_arena_scope cmvn_scratch_scope;
+#endif
+
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+            const ei_static_dsp_fns_t *static_fns = ei_static_dsp_find(ei_static_dsp_fns, ei_static_dsp_fns_size, block.extract_fn);
+            if (static_fns) {
+                static_fns->cmvn_fn(features[ix].matrix, block.config);
+            }
+            else
+#endif
             if (block.extract_fn == extract_mfcc_features) {
                 calc_cepstral_mean_and_var_normalization_mfcc(features[ix].matrix, block.config);
             }
@@ -646,9 +811,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
         ei_impulse_error = run_inference(handle, features, result, debug);
         if (ei_impulse_error != EI_IMPULSE_OK) {
+            free_raw_outputs(handle, result);
             return ei_impulse_error;
         }
-        delete[] matrix_ptrs;
+        matrix_ptrs_ptr.reset();
         ei_impulse_error = run_postprocessing(handle, result);
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
@@ -660,6 +826,33 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     return ei_impulse_error;
 }
 
+/**
+ * @brief      Process a complete impulse for continuous inference
+ *
+ * @param      handle               struct with information about model and DSP
+ * @param      signal               Sample data
+ * @param      result               Output classifier results
+ * @param[in]  debug                Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
+                                                       signal_t *signal,
+                                                       ei_impulse_result_t *result,
+                                                       bool debug = false)
+{
+#if EI_CLASSIFIER_TELEMETRY == 1
+    uint64_t start_us = ei_read_timer_us();
+    EI_IMPULSE_ERROR res = process_impulse_continuous_stages(handle, signal, result, debug);
+    if (result != nullptr) {
+        ei_telemetry_record_inference(result, res, true, ei_read_timer_us() - start_us);
+    }
+    return res;
+#else
+    return process_impulse_continuous_stages(handle, signal, result, debug);
+#endif // EI_CLASSIFIER_TELEMETRY == 1
+}
+
 /**
  * Check if the current impulse could be used by 'run_classifier_image_quantized'
  */
@@ -899,6 +1092,41 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 #endif
 }
 
+/**
+ * @brief Start the continuous feature buffer over, without touching the postprocessing state.
+ *
+ * Call this when slices were not passed to `run_classifier_continuous()` (e.g. skipped by a
+ * voice activity gate). The buffered features and the DSP carry-over would otherwise be glued
+ * to audio that is not contiguous with them. No inference runs until a full window is buffered again.
+ *
+ * **Blocking**: yes
+ */
+__attribute__((unused)) static void run_classifier_continuous_restart(void)
+{
+    classifier_continuous_features_written = 0;
+    ei_dsp_clear_continuous_audio_state();
+}
+
+/**
+ * @brief Exchange the continuous inference state (the feature window and the audio carried
+ * over by the DSP) with `state`.
+ *
+ * Lets several impulses run `run_classifier_continuous()` over one stream, each with its own
+ * state: swap it in before the call and out again after it. Spectral analysis blocks keep
+ * their own per-config state, which is not swapped.
+ *
+ * **Blocking**: no
+ */
+__attribute__((unused)) static void run_classifier_continuous_swap_state(ei_classifier_continuous_state_t *state)
+{
+    std::swap(classifier_continuous_features, state->features);
+    std::swap(classifier_continuous_features_size, state->features_size);
+    std::swap(classifier_continuous_features_written, state->features_written);
+    std::swap(ei_dsp_cont_current_frame, state->dsp_frame);
+    std::swap(ei_dsp_cont_current_frame_size, state->dsp_frame_size);
+    std::swap(ei_dsp_cont_current_frame_ix, state->dsp_frame_ix);
+}
+
 /**
  * @brief Deletes static variables when running preprocessing and inference continuously.
  *
@@ -913,13 +1141,37 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 extern "C" void run_classifier_deinit(void)
 {
     deinit_postprocessing(&ei_default_impulse);
+#if EI_CLASSIFIER_LOAD_ANOMALY_H
+    ei_anomaly_release_state();
+#endif
+#if EI_NMS_ENABLED
+    ei_nms_release_workspace();
+#endif
+    ei::numpy::release_dct2_plans();
+    ei::spectral::wavelet::release_workspace();
+    ei_scratch_arena_deinit();
+#if EIDSP_TRACK_ALLOCATIONS
+    ei::alloc_tracker::report_leaks();
+#endif
 }
 
 __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
 {
     deinit_postprocessing(handle);
+#if EI_CLASSIFIER_LOAD_ANOMALY_H
+    ei_anomaly_release_state();
+#endif
+#if EI_NMS_ENABLED
+    ei_nms_release_workspace();
+#endif
+    ei::numpy::release_dct2_plans();
+    ei::spectral::wavelet::release_workspace();
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     deinit_data_normalization(handle);
+#endif
+    ei_scratch_arena_deinit();
+#if EIDSP_TRACK_ALLOCATIONS
+    ei::alloc_tracker::report_leaks();
 #endif
 }
 
@@ -1042,6 +1294,30 @@ __attribute__((unused)) EI_IMPULSE_ERROR run_classifier_continuous(
     return process_impulse_continuous(impulse, signal, result, debug);
 }
 
+/**
+ * @brief Run inference on the feature window of `run_classifier_continuous()` as it is,
+ *  without a new slice.
+ *
+ * For a state (see `run_classifier_continuous_swap_state()`) whose features were computed
+ * by another impulse with the same DSP blocks. Nothing runs until the window is full.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] impulse `ei_impulse_handle_t` struct with information about preprocessing and model.
+ * @param[out] result Pointer to an `ei_impulse_result_t` struct that contains the various output
+ *  results from inference.
+ * @param[in] debug Print internal inference debugging information via `ei_printf()`.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR run_classifier_continuous_window(
+    ei_impulse_handle_t *impulse,
+    ei_impulse_result_t *result,
+    bool debug = false)
+{
+    return process_impulse_continuous(impulse, nullptr, result, debug);
+}
+
 /**
  * @brief Run the classifier over a raw features array.
  *
@@ -1177,6 +1453,54 @@ extern "C" EI_IMPULSE_ERROR ei_set_freeform_output(
 }
 #endif // #if EI_CLASSIFIER_FREEFORM_OUTPUT
 
+#if EI_CLASSIFIER_ARENA_REPORT && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+/**
+ * @brief Collect the tensor arena layout of a learn block: tensor offsets and lifetimes,
+ *  persistent vs. non-persistent bytes, per-kernel scratch buffers and unused headroom.
+ *  The model is initialized for the report and freed again, don't call this while
+ *  running inference.
+ *
+ * @param[in] handle Pointer to the impulse handle
+ * @param[in] learn_block_ix Index into the impulse's learning blocks
+ * @param[out] report Report to fill in (use ei_arena_report_print_json to print it)
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_arena_report(
+    ei_impulse_handle_t *handle,
+    size_t learn_block_ix,
+    ei_arena_report_t *report
+) {
+    const ei_impulse_t *impulse = handle->impulse;
+
+    if (learn_block_ix >= impulse->learning_blocks_size) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+
+    const ei_learning_block_t *block = &impulse->learning_blocks[learn_block_ix];
+#if (EI_CLASSIFIER_COMPILED == 1) && (EI_CLASSIFIER_LOADABLE_MODEL == 1)
+    if (block->infer_fn == ei_interpreter::run_nn_inference) {
+        return ei_interpreter::run_nn_arena_report(block->config, report);
+    }
+#endif
+    if (block->infer_fn != run_nn_inference) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    return run_nn_arena_report(block->config, report);
+}
+
+/**
+ * @brief Collect the tensor arena layout of a learn block of the default impulse
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_arena_report(
+    size_t learn_block_ix,
+    ei_arena_report_t *report
+) {
+    return run_classifier_arena_report(&ei_default_impulse, learn_block_ix, report);
+}
+#endif // EI_CLASSIFIER_ARENA_REPORT
+
 /**
  * @brief Get image input parameters from an impulse
  *
@@ -39,6 +39,7 @@
 #include "edge-impulse-sdk/dsp/spectral/spectral.hpp"
 #include "edge-impulse-sdk/dsp/speechpy/speechpy.hpp"
 #include "edge-impulse-sdk/classifier/ei_signal_with_range.h"
+#include "edge-impulse-sdk/classifier/ei_quantize.h"
 #include "edge-impulse-sdk/dsp/ei_flatten.h"
 #include "model-parameters/model_metadata.h"
 
@@ -188,6 +189,87 @@ __attribute__((unused)) int extract_spectral_analysis_features(
     return EIDSP_NOT_SUPPORTED;
 }
 
+// sliding windows for continuous spectral analysis, one per block (keyed by config)
+static spectral::feature_stream ei_dsp_spectral_streams[EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS];
+
+static spectral::feature_stream *ei_dsp_spectral_stream_for(ei_dsp_config_spectral_analysis_t *config) {
+    spectral::feature_stream *unused = nullptr;
+    for (size_t ix = 0; ix < EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS; ix++) {
+        if (ei_dsp_spectral_streams[ix].config() == config) {
+            return &ei_dsp_spectral_streams[ix];
+        }
+        if (!unused && !ei_dsp_spectral_streams[ix].config()) {
+            unused = &ei_dsp_spectral_streams[ix];
+        }
+    }
+    return unused;
+}
+
+__attribute__((unused)) int extract_spectral_analysis_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency, matrix_size_t *matrix_size_out) {
+    ei_dsp_config_spectral_analysis_t *config = (ei_dsp_config_spectral_analysis_t *)config_ptr;
+
+    matrix_size_out->rows = 0;
+    matrix_size_out->cols = 0;
+
+    if (config->axes <= 0 || signal->total_length % config->axes != 0) {
+        EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+    }
+
+    spectral::feature_stream *stream = ei_dsp_spectral_stream_for(config);
+    if (!stream) {
+        ei_printf("ERR: More than %d spectral analysis blocks (see EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS)\n",
+            EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS);
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+
+    int ret = stream->configure(config, EI_CLASSIFIER_RAW_SAMPLE_COUNT, frequency);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    // slice from the raw signal
+    EI_DSP_MATRIX(slice, signal->total_length / config->axes, config->axes);
+    if (!slice.buffer) {
+        EIDSP_ERR(EIDSP_OUT_OF_MEM);
+    }
+    ret = signal->get_data(0, signal->total_length, slice.buffer);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    ret = stream->push(slice.buffer, slice.rows);
+    if (ret != EIDSP_OK) {
+        EIDSP_ERR(ret);
+    }
+
+    // no features until the first window is complete
+    if (!stream->window_full()) {
+        return EIDSP_OK;
+    }
+
+    if (stream->incremental()) {
+        ret = stream->extract(output_matrix);
+    }
+    else {
+        signal_t window_signal;
+        ret = numpy::signal_from_buffer(stream->window(),
+            EI_CLASSIFIER_RAW_SAMPLE_COUNT * config->axes, &window_signal);
+        if (ret == EIDSP_OK) {
+            ret = extract_spectral_analysis_features(&window_signal, output_matrix, config_ptr, frequency);
+        }
+    }
+    if (ret != EIDSP_OK) {
+        ei_printf("ERR: Spectral analysis failed (%d)\n", ret);
+        EIDSP_ERR(ret);
+    }
+
+    // the features cover the whole window
+    matrix_size_out->rows = output_matrix->rows;
+    matrix_size_out->cols = output_matrix->cols;
+
+    return EIDSP_OK;
+}
+
 __attribute__((unused)) int extract_raw_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_raw_t config = *((ei_dsp_config_raw_t*)config_ptr);
 
@@ -327,7 +409,13 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+typedef int (*extract_mfcc_run_slice_fn_t)(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfcc_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, int implementation_version);
+
+/**
+ * Continuous MFCC: carries partial frames between slices and runs `run_slice` over
+ * the complete frames (extract_mfcc_run_slice, or a static impulse specialization)
+ */
+__attribute__((unused)) static int extract_mfcc_per_slice_features_with(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out, extract_mfcc_run_slice_fn_t run_slice) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -430,7 +518,7 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
             EIDSP_ERR(x);
         }
 
-        x = extract_mfcc_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version);
+        x = run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
@@ -460,7 +548,7 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     size_t range_signal_orig_length = range_signal->total_length;
 
     // then we'll just go through normal processing of the signal:
-    x = extract_mfcc_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version);
+    x = run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out, implementation_version);
     if (x != EIDSP_OK) {
         EIDSP_ERR(x);
     }
@@ -496,6 +584,10 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 #endif
 }
 
+__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+    return extract_mfcc_per_slice_features_with(signal, output_matrix, config_ptr, sampling_frequency, matrix_size_out, &extract_mfcc_run_slice);
+}
+
 __attribute__((unused)) int extract_spectrogram_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
@@ -1277,6 +1369,9 @@ __attribute__((unused)) int extract_image_features_quantized(signal_t *signal, m
     static const float torch_mean[] = { 0.485, 0.456, 0.406 };
     static const float torch_std[] = { 0.229, 0.224, 0.225 };
 
+    // slow code paths: same rounding as the NN input quantization, saturated to int8
+    const ei_quantize_params_t *qparams = ei_quantize_get_params(scale, static_cast<int32_t>(zero_point), true);
+
 #if defined(EI_DSP_IMAGE_BUFFER_STATIC_SIZE)
     const size_t page_size = EI_DSP_IMAGE_BUFFER_STATIC_SIZE;
 #else
@@ -1338,9 +1433,9 @@ __attribute__((unused)) int extract_image_features_quantized(signal_t *signal, m
                         b -= 128.0f;
                     }
 
-                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(round(r / scale) + zero_point);
-                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(round(g / scale) + zero_point);
-                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(round(b / scale) + zero_point);
+                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(ei_quantize_one(qparams, r));
+                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(ei_quantize_one(qparams, g));
+                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(ei_quantize_one(qparams, b));
                 }
             }
             else {
@@ -1388,7 +1483,7 @@ __attribute__((unused)) int extract_image_features_quantized(signal_t *signal, m
                     // ITU-R 601-2 luma transform
                     // see: https://pillow.readthedocs.io/en/stable/reference/Image.html#PIL.Image.Image.convert
                     float v = (0.299f * r) + (0.587f * g) + (0.114f * b);
-                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(round(v / scale) + zero_point);
+                    output_matrix->buffer[output_ix++] = static_cast<int8_t>(ei_quantize_one(qparams, v));
                 }
             }
         }
@@ -1412,9 +1507,67 @@ __attribute__((unused)) int ei_dsp_clear_continuous_audio_state() {
     ei_dsp_cont_current_frame_size = 0;
     ei_dsp_cont_current_frame_ix = 0;
 
+    for (size_t ix = 0; ix < EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS; ix++) {
+        ei_dsp_spectral_streams[ix].clear();
+    }
+
     return EIDSP_OK;
 }
 
+/**
+ * Check whether two (stateless) DSP blocks compute the same features from the same signal,
+ * e.g. the MFCC blocks of two impulses trained with the same parameters. Block ids and
+ * named axes may differ.
+ *
+ * @returns true if the output of one block can be used for the other
+ */
+__attribute__((unused)) static bool ei_dsp_blocks_equal(const ei_model_dsp_t *a, const ei_model_dsp_t *b) {
+    if (a->extract_fn != b->extract_fn || a->factory || b->factory ||
+        a->n_output_features != b->n_output_features || a->axes_size != b->axes_size) {
+        return false;
+    }
+
+    for (uint32_t ix = 0; ix < a->axes_size; ix++) {
+        if (a->axes[ix] != b->axes[ix]) {
+            return false;
+        }
+    }
+
+    if (a->config == b->config) {
+        return true;
+    }
+
+    if (a->extract_fn == &extract_mfcc_features) {
+        const ei_dsp_config_mfcc_t *ca = (const ei_dsp_config_mfcc_t *)a->config;
+        const ei_dsp_config_mfcc_t *cb = (const ei_dsp_config_mfcc_t *)b->config;
+        return ca->implementation_version == cb->implementation_version && ca->axes == cb->axes &&
+            ca->num_cepstral == cb->num_cepstral && ca->frame_length == cb->frame_length &&
+            ca->frame_stride == cb->frame_stride && ca->num_filters == cb->num_filters &&
+            ca->fft_length == cb->fft_length && ca->win_size == cb->win_size &&
+            ca->low_frequency == cb->low_frequency && ca->high_frequency == cb->high_frequency &&
+            ca->pre_cof == cb->pre_cof && ca->pre_shift == cb->pre_shift;
+    }
+    else if (a->extract_fn == &extract_mfe_features) {
+        const ei_dsp_config_mfe_t *ca = (const ei_dsp_config_mfe_t *)a->config;
+        const ei_dsp_config_mfe_t *cb = (const ei_dsp_config_mfe_t *)b->config;
+        return ca->implementation_version == cb->implementation_version && ca->axes == cb->axes &&
+            ca->frame_length == cb->frame_length && ca->frame_stride == cb->frame_stride &&
+            ca->num_filters == cb->num_filters && ca->fft_length == cb->fft_length &&
+            ca->low_frequency == cb->low_frequency && ca->high_frequency == cb->high_frequency &&
+            ca->win_size == cb->win_size && ca->noise_floor_db == cb->noise_floor_db;
+    }
+    else if (a->extract_fn == &extract_spectrogram_features) {
+        const ei_dsp_config_spectrogram_t *ca = (const ei_dsp_config_spectrogram_t *)a->config;
+        const ei_dsp_config_spectrogram_t *cb = (const ei_dsp_config_spectrogram_t *)b->config;
+        return ca->implementation_version == cb->implementation_version && ca->axes == cb->axes &&
+            ca->frame_length == cb->frame_length && ca->frame_stride == cb->frame_stride &&
+            ca->fft_length == cb->fft_length && ca->noise_floor_db == cb->noise_floor_db &&
+            ca->show_axes == cb->show_axes;
+    }
+
+    return false;
+}
+
 /**
  * @brief      Calculates the cepstral mean and variable normalization.
  *
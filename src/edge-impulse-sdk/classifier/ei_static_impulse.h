@@ -0,0 +1,454 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EDGE_IMPULSE_STATIC_IMPULSE_H_
+#define _EDGE_IMPULSE_STATIC_IMPULSE_H_
+
+/**
+ * Static impulse mode: the generated model_variables.h instantiates the DSP blocks
+ * below with the block parameters as compile time constants. Scratch buffers are
+ * statically sized, loop bounds are known, and the mel filterbank and DCT tables
+ * are const data (model_static_impulse.h, generated from the model by
+ * firmware-sdk/tools/static_impulse_tables.cpp), so only the FFT work buffers are
+ * allocated per inference, nothing is rebuilt, and the compiler can fold / unroll
+ * the per-frame loops.
+ * Outputs are identical to the generic blocks (same arithmetic, same order).
+ */
+#ifndef EI_CLASSIFIER_STATIC_IMPULSE
+#define EI_CLASSIFIER_STATIC_IMPULSE            0
+#endif // EI_CLASSIFIER_STATIC_IMPULSE
+
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+
+#include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+
+/**
+ * Entry points of a specialized DSP block, the run_classifier*() functions use these
+ * instead of the generic per-slice / normalization functions for blocks in the table
+ */
+typedef struct {
+    int (*extract_fn)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency);
+    int (*extract_per_slice_fn)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size);
+    void (*cmvn_fn)(ei::matrix_t *matrix, void *config);
+} ei_static_dsp_fns_t;
+
+/**
+ * Find the specialized entry points for a DSP block (by its extract function)
+ * @returns nullptr if the block is not specialized
+ */
+__attribute__((unused)) static const ei_static_dsp_fns_t *ei_static_dsp_find(
+    const ei_static_dsp_fns_t *fns,
+    size_t fns_size,
+    int (*extract_fn)(ei::signal_t *, ei::matrix_t *, void *, const float))
+{
+    for (size_t ix = 0; ix < fns_size; ix++) {
+        if (fns[ix].extract_fn == extract_fn) {
+            return &fns[ix];
+        }
+    }
+    return nullptr;
+}
+
+namespace ei {
+namespace static_impulse {
+
+/**
+ * MFCC block specialized on a generated config, C provides:
+ *  frequency, frame_length, frame_stride, frame_length_samples, max_frames (frames in
+ *  a full window), num_cepstral, num_filters, fft_length, win_size, pre_cof, pre_shift,
+ *  implementation_version, and the tables mel_bins [num_filters + 2],
+ *  mel_weights (the non-zero triangle weights, filter by filter, middle bin excluded)
+ *  and dct_basis [num_filters][num_cepstral] (ortho normalization folded in)
+ */
+template <class C>
+class mfcc {
+public:
+    static constexpr size_t power_spectrum_size = C::fft_length / 2 + 1;
+    static constexpr size_t cmvn_pad = (C::win_size - 1) / 2;
+
+    static_assert(C::pre_shift > 0, "static MFCC needs a positive preemphasis shift");
+    static_assert(C::win_size > 0, "static MFCC needs a cmvn window");
+
+    /**
+     * Same as extract_mfcc_features() (run_classifier, complete window)
+     */
+    static int extract(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
+        if (signal->total_length == 0) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        int ret = preemphasis_begin(signal);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        signal_t preemphasized_audio_signal;
+        preemphasized_audio_signal.total_length = signal->total_length;
+        preemphasized_audio_signal.get_data = &preemphasis_get_data;
+
+        matrix_size_t out_matrix_size =
+            speechpy::feature::calculate_mfcc_buffer_size(
+                signal->total_length, C::frequency, C::frame_length, C::frame_stride, C::num_cepstral, C::implementation_version);
+        if (out_matrix_size.rows * out_matrix_size.cols > output_matrix->rows * output_matrix->cols) {
+            ei_printf("out_matrix = %dx%d\n", (int)output_matrix->rows, (int)output_matrix->cols);
+            ei_printf("calculated size = %dx%d\n", (int)out_matrix_size.rows, (int)out_matrix_size.cols);
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        output_matrix->rows = out_matrix_size.rows;
+        output_matrix->cols = out_matrix_size.cols;
+
+        ret = run(output_matrix, &preemphasized_audio_signal, C::implementation_version);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: MFCC failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+
+        ret = cmvnw(output_matrix);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: cmvnw failed (%d)\n", ret);
+            EIDSP_ERR(ret);
+        }
+
+        output_matrix->cols = out_matrix_size.rows * out_matrix_size.cols;
+        output_matrix->rows = 1;
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Same as extract_mfcc_per_slice_features() (run_classifier_continuous)
+     */
+    static int extract_per_slice(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+        return extract_mfcc_per_slice_features_with(signal, output_matrix, config_ptr, sampling_frequency, matrix_size_out, &run_slice);
+    }
+
+    /**
+     * Same as calc_cepstral_mean_and_var_normalization_mfcc()
+     */
+    static void cmvn(matrix_t *matrix, void *config_ptr) {
+        uint32_t original_matrix_size = matrix->rows * matrix->cols;
+
+        matrix->rows = original_matrix_size / C::num_cepstral;
+        matrix->cols = C::num_cepstral;
+
+        int ret = cmvnw(matrix);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: cmvnw failed (%d)\n", ret);
+            return;
+        }
+
+        matrix->rows = 1;
+        matrix->cols = original_matrix_size;
+    }
+
+private:
+    /**
+     * extract_mfcc_run_slice() on the static MFCC
+     */
+    static int run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfcc_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, int implementation_version) {
+        matrix_size_t out_matrix_size =
+            speechpy::feature::calculate_mfcc_buffer_size(
+                signal->total_length, C::frequency, C::frame_length, C::frame_stride, C::num_cepstral,
+                implementation_version);
+
+        int x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
+            -(out_matrix_size.rows * out_matrix_size.cols));
+        if (x != EIDSP_OK) {
+            EIDSP_ERR(x);
+        }
+
+        size_t output_matrix_offset = (output_matrix->rows * output_matrix->cols) -
+            (out_matrix_size.rows * out_matrix_size.cols);
+
+        matrix_t output_matrix_slice(out_matrix_size.rows, out_matrix_size.cols, output_matrix->buffer + output_matrix_offset);
+
+        x = run(&output_matrix_slice, signal, implementation_version);
+        if (x != EIDSP_OK) {
+            ei_printf("ERR: MFCC failed (%d)\n", x);
+            EIDSP_ERR(x);
+        }
+
+        matrix_size_out->rows += out_matrix_size.rows;
+        if (out_matrix_size.cols > 0) {
+            matrix_size_out->cols = out_matrix_size.cols;
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * speechpy::feature::mfcc() (with mfe()) on static buffers and the generated tables
+     */
+    static int run(matrix_t *out_features, signal_t *signal, int version) {
+        if (out_features->cols != C::num_cepstral) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        speechpy::stack_frames_info_t stack_frame_info = { 0 };
+        stack_frame_info.signal = signal;
+
+        int ret = speechpy::processing::stack_frames(
+            &stack_frame_info,
+            C::frequency,
+            C::frame_length,
+            C::frame_stride,
+            false,
+            version);
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+
+        const size_t frame_count = stack_frame_info.frame_count;
+        if (frame_count != out_features->rows || frame_count > C::max_frames ||
+                stack_frame_info.frame_length != C::frame_length_samples) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        for (size_t ix = 0; ix < frame_count; ix++) {
+            // same (zero padding) length calculation as mfe()
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
+            size_t signal_length = C::frame_length_samples;
+            if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
+                signal_length = signal_length -
+                    (stack_frame_info.signal->total_length - (signal_offset + signal_length));
+            }
+
+            {
+                EI_PROFILE_SCOPE("framing");
+                ret = stack_frame_info.signal->get_data(signal_offset, signal_length, frame_buffer);
+            }
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+
+            ret = numpy::power_spectrum(frame_buffer, C::frame_length_samples,
+                power_spectrum_buffer, power_spectrum_size, C::fft_length);
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+
+            float energy = numpy::sum(power_spectrum_buffer, power_spectrum_size);
+            if (energy == 0) {
+                energy = 1e-10;
+            }
+            energy_buffer[ix] = energy;
+
+            EI_PROFILE_SCOPE("filterbank");
+            float *row_ptr = mfe_buffer + (ix * C::num_filters);
+            const float *weight = C::mel_weights;
+            for (size_t i = 0; i < C::num_filters; i++) {
+                const size_t left = C::mel_bins[i];
+                const size_t middle = C::mel_bins[i + 1];
+                const size_t right = C::mel_bins[i + 2];
+
+                float value = power_spectrum_buffer[middle];
+                for (size_t bin = left + 1; bin < middle; bin++) {
+                    value += *weight++ * power_spectrum_buffer[bin];
+                }
+                for (size_t bin = middle + 1; bin < right; bin++) {
+                    value += *weight++ * power_spectrum_buffer[bin];
+                }
+                row_ptr[i] = value;
+            }
+        }
+
+        matrix_t features_matrix(frame_count, C::num_filters, mfe_buffer);
+        numpy::zero_handling(&features_matrix);
+
+        {
+            EI_PROFILE_SCOPE("log");
+            ret = numpy::log(&features_matrix);
+        }
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        {
+            EI_PROFILE_SCOPE("dct");
+            ret = numpy::dct2_truncated_basis(&features_matrix, out_features, C::dct_basis);
+        }
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        // replace first cepstral coefficient with log of frame energy for DC elimination
+        for (size_t row = 0; row < frame_count; row++) {
+            out_features->buffer[row * C::num_cepstral] = numpy::log(energy_buffer[row]);
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * speechpy::processing::cmvnw() with variance normalization, on static buffers
+     */
+    static int cmvnw(matrix_t *features_matrix) {
+        if (features_matrix->rows > C::max_frames || features_matrix->cols != C::num_cepstral) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        EI_PROFILE_SCOPE("cmvn");
+
+        matrix_t vec_pad(features_matrix->rows + (cmvn_pad * 2), C::num_cepstral, cmvn_pad_buffer);
+        matrix_t mean_matrix(C::num_cepstral, 1, cmvn_mean_buffer);
+        matrix_t window_variance(C::num_cepstral, 1, cmvn_variance_buffer);
+
+        int ret = numpy::pad_1d_symmetric(features_matrix, &vec_pad, cmvn_pad, cmvn_pad);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        for (size_t ix = 0; ix < features_matrix->rows; ix++) {
+            matrix_t window(C::win_size, C::num_cepstral, vec_pad.buffer + (ix * C::num_cepstral));
+
+            ret = numpy::mean_axis0(&window, &mean_matrix);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+
+            float *row = features_matrix->buffer + (ix * C::num_cepstral);
+            for (size_t col = 0; col < C::num_cepstral; col++) {
+                row[col] = row[col] - mean_matrix.buffer[col];
+            }
+        }
+
+        ret = numpy::pad_1d_symmetric(features_matrix, &vec_pad, cmvn_pad, cmvn_pad);
+        if (ret != EIDSP_OK) {
+            EIDSP_ERR(ret);
+        }
+
+        for (size_t ix = 0; ix < features_matrix->rows; ix++) {
+            matrix_t window(C::win_size, C::num_cepstral, vec_pad.buffer + (ix * C::num_cepstral));
+
+            ret = numpy::std_axis0(&window, &window_variance);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+
+            float *row = features_matrix->buffer + (ix * C::num_cepstral);
+            for (size_t col = 0; col < C::num_cepstral; col++) {
+                row[col] = row[col] / (window_variance.buffer[col] + 1e-10);
+            }
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Preemphasis straight from the source signal into the caller's frame buffer,
+     * same arithmetic as speechpy::processing::preemphasis
+     */
+    static int preemphasis_begin(signal_t *signal) {
+        if (signal->total_length < static_cast<size_t>(C::pre_shift)) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+        preemphasis_source = signal;
+        preemphasis_source_length = signal->total_length;
+        return signal->get_data(signal->total_length - C::pre_shift, C::pre_shift, preemphasis_end_of_signal);
+    }
+
+    static int preemphasis_get_data(size_t offset, size_t length, float *out_ptr) {
+        if (offset + length > preemphasis_source_length) {
+            EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+        }
+
+        EI_PROFILE_SCOPE("preemphasis");
+
+        const size_t shift = static_cast<size_t>(C::pre_shift);
+        if (offset >= shift) {
+            int ret = preemphasis_source->get_data(offset - shift, shift, preemphasis_history);
+            if (ret != 0) {
+                EIDSP_ERR(ret);
+            }
+        }
+
+        int ret = preemphasis_source->get_data(offset, length, out_ptr);
+        if (ret != 0) {
+            EIDSP_ERR(ret);
+        }
+
+        // back to front, so every sample still sees its unfiltered predecessor
+        for (size_t ix = length; ix-- > 0; ) {
+            float prev;
+            if (offset + ix < shift) {
+                prev = preemphasis_end_of_signal[offset + ix];
+            }
+            else if (ix >= shift) {
+                prev = out_ptr[ix - shift];
+            }
+            else {
+                prev = preemphasis_history[ix];
+            }
+            out_ptr[ix] = out_ptr[ix] - (C::pre_cof * prev);
+        }
+
+        return EIDSP_OK;
+    }
+
+    static float frame_buffer[C::frame_length_samples];
+    static float power_spectrum_buffer[power_spectrum_size];
+    static float mfe_buffer[C::max_frames * C::num_filters];
+    static float energy_buffer[C::max_frames];
+    static float cmvn_pad_buffer[(C::max_frames + (cmvn_pad * 2)) * C::num_cepstral];
+    static float cmvn_mean_buffer[C::num_cepstral];
+    static float cmvn_variance_buffer[C::num_cepstral];
+    static signal_t *preemphasis_source;
+    static size_t preemphasis_source_length;
+    static float preemphasis_end_of_signal[C::pre_shift];
+    static float preemphasis_history[C::pre_shift];
+};
+
+template <class C> float mfcc<C>::frame_buffer[C::frame_length_samples];
+template <class C> float mfcc<C>::power_spectrum_buffer[mfcc<C>::power_spectrum_size];
+template <class C> float mfcc<C>::mfe_buffer[C::max_frames * C::num_filters];
+template <class C> float mfcc<C>::energy_buffer[C::max_frames];
+template <class C> float mfcc<C>::cmvn_pad_buffer[(C::max_frames + (mfcc<C>::cmvn_pad * 2)) * C::num_cepstral];
+template <class C> float mfcc<C>::cmvn_mean_buffer[C::num_cepstral];
+template <class C> float mfcc<C>::cmvn_variance_buffer[C::num_cepstral];
+template <class C> signal_t *mfcc<C>::preemphasis_source = nullptr;
+template <class C> size_t mfcc<C>::preemphasis_source_length = 0;
+template <class C> float mfcc<C>::preemphasis_end_of_signal[C::pre_shift];
+template <class C> float mfcc<C>::preemphasis_history[C::pre_shift];
+
+} // namespace static_impulse
+} // namespace ei
+
+/** Table entry for a specialized MFCC block */
+#define EI_STATIC_DSP_MFCC_FNS(block) \
+    { &block::extract, &block::extract_per_slice, &block::cmvn }
+
+#endif // EI_CLASSIFIER_STATIC_IMPULSE == 1
+
+#endif // _EDGE_IMPULSE_STATIC_IMPULSE_H_
@@ -42,6 +42,8 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdint.h>
+#include <string.h>
+#include <algorithm>
 
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
@@ -53,53 +55,206 @@ namespace {
 #endif // __cplusplus
 
 #if EI_CLASSIFIER_HAS_ANOMALY_KMEANS
+
+// Number of clusters that are scored together. Their centroids are interleaved,
+// so the distances of a block are computed in one pass over the input.
+#ifndef EI_ANOMALY_KMEANS_BLOCK
+#define EI_ANOMALY_KMEANS_BLOCK             4
+#endif // EI_ANOMALY_KMEANS_BLOCK
+
+// Number of features between two early-abandon checks
+#ifndef EI_ANOMALY_KMEANS_ABANDON_STRIDE
+#define EI_ANOMALY_KMEANS_ABANDON_STRIDE    16
+#endif // EI_ANOMALY_KMEANS_ABANDON_STRIDE
+
+// Number of K-means blocks (over all impulses) that keep their state at the same time
+#ifndef EI_ANOMALY_KMEANS_MAX_BLOCKS
+#define EI_ANOMALY_KMEANS_MAX_BLOCKS        2
+#endif // EI_ANOMALY_KMEANS_MAX_BLOCKS
+
 /**
- * Standard scaler, scales all values in the input vector
- * Note that this *modifies* the array in place!
- * @param input Array of input values
- * @param scale Array of scale values (obtain from StandardScaler in Python)
- * @param mean Array of mean values (obtain from StandardScaler in Python)
- * @param input_size Size of input, scale and mean arrays
+ * K-means state, built on the first inference of a block and kept afterwards.
+ * A state belongs to one block of one impulse (impulse, block_id).
  */
-static void standard_scaler(float *input, const float *scale, const float *mean, size_t input_size) {
-    for (size_t ix = 0; ix < input_size; ix++) {
-        input[ix] = (input[ix] - mean[ix]) / scale[ix];
-    }
+typedef struct {
+    const ei_impulse_t *impulse;
+    uint32_t block_id;
+    const ei_learning_block_config_anomaly_kmeans_t *config;    // nullptr if the slot is free
+    float *input;           // gather buffer, scaled in place
+    float *inv_scale;       // 1 / anom_scale
+    float *centroids;       // [cluster block][feature][EI_ANOMALY_KMEANS_BLOCK], nullptr if it did not fit
+    float *max_error;       // per cluster, padded to a multiple of EI_ANOMALY_KMEANS_BLOCK
+} ei_anomaly_kmeans_state_t;
+
+static ei_anomaly_kmeans_state_t ei_anomaly_kmeans_states[EI_ANOMALY_KMEANS_MAX_BLOCKS] = { };
+static size_t ei_anomaly_kmeans_next_evict = 0;
+
+/**
+ * Squared distance beyond which a cluster can no longer score below min:
+ * sqrt(d) - max_error >= min  <=>  d >= (min + max_error)^2
+ */
+static inline float kmeans_abandon_bound(float min, float max_error) {
+    float bound = min + max_error;
+    return bound > 0.0f ? bound * bound : 0.0f;
 }
 
 /**
- * Calculate the distance between input vector and the cluster
- * @param input Array of input values (already scaled by standard_scaler)
+ * Get minimum distance to a cluster (sqrt(squared distance) - max_error)
+ * @param input Array of input values (already scaled)
  * @param input_size Size of the input array
- * @param cluster A cluster (number of centroids should match input_size)
+ * @param clusters Array of clusters
+ * @param cluster_size Size of cluster array
  */
-static float calculate_cluster_distance(float *input, size_t input_size, const ei_classifier_anom_cluster_t *cluster) {
-    // todo: check input_size and centroid size?
+static float get_min_distance_to_cluster(const float *input, size_t input_size, const ei_classifier_anom_cluster_t *clusters, size_t cluster_size) {
+    float min = 1000.0f;
+    for (size_t cx = 0; cx < cluster_size; cx++) {
+        const float *centroid = clusters[cx].centroid;
+        const float bound = kmeans_abandon_bound(min, clusters[cx].max_error);
+
+        float dist = 0.0f;
+        size_t ix = 0;
+        while (ix < input_size && dist <= bound) {
+            size_t end = std::min(ix + EI_ANOMALY_KMEANS_ABANDON_STRIDE, input_size);
+            for (; ix < end; ix++) {
+                float diff = input[ix] - centroid[ix];
+                dist += diff * diff;
+            }
+        }
+        if (ix < input_size) {
+            continue;
+        }
 
-    float dist = 0.0f;
-    for (size_t ix = 0; ix < input_size; ix++) {
-        dist += pow(input[ix] - cluster->centroid[ix], 2);
+        float score = sqrtf(dist) - clusters[cx].max_error;
+        if (score < min) {
+            min = score;
+        }
     }
-    return sqrt(dist) - cluster->max_error;
+    return min;
 }
 
 /**
- * Get minimum distance to a cluster
- * @param input Array of input values (already scaled by standard_scaler)
- * @param input_size Size of the input array
- * @param clusters Array of clusters
- * @param cluster_size Size of cluster array
+ * Same as get_min_distance_to_cluster, over the interleaved centroids in the state
  */
-static float get_min_distance_to_cluster(float *input, size_t input_size, const ei_classifier_anom_cluster_t *clusters, size_t cluster_size) {
+static float get_min_distance_to_cluster_blocked(const ei_anomaly_kmeans_state_t *state, size_t input_size, size_t cluster_size) {
+    const size_t B = EI_ANOMALY_KMEANS_BLOCK;
+    const float *input = state->input;
     float min = 1000.0f;
-    for (size_t ix = 0; ix < cluster_size; ix++) {
-        float dist = calculate_cluster_distance(input, input_size, &clusters[ix]);
-        if (dist < min) {
-            min = dist;
+
+    for (size_t block = 0; block * B < cluster_size; block++) {
+        const float *centroids = &state->centroids[block * input_size * B];
+        const float *max_error = &state->max_error[block * B];
+        const size_t clusters_in_block = std::min(B, cluster_size - (block * B));
+
+        float bound[EI_ANOMALY_KMEANS_BLOCK];
+        float dist[EI_ANOMALY_KMEANS_BLOCK];
+        for (size_t k = 0; k < B; k++) {
+            bound[k] = k < clusters_in_block ? kmeans_abandon_bound(min, max_error[k]) : 0.0f;
+            dist[k] = 0.0f;
+        }
+
+        size_t ix = 0;
+        while (ix < input_size) {
+            size_t end = std::min(ix + EI_ANOMALY_KMEANS_ABANDON_STRIDE, input_size);
+            for (; ix < end; ix++) {
+                const float value = input[ix];
+                const float *c = &centroids[ix * B];
+                for (size_t k = 0; k < B; k++) {
+                    float diff = value - c[k];
+                    dist[k] += diff * diff;
+                }
+            }
+
+            bool all_abandoned = true;
+            for (size_t k = 0; k < B; k++) {
+                all_abandoned &= dist[k] > bound[k];
+            }
+            if (all_abandoned) {
+                break;
+            }
+        }
+        if (ix < input_size) {
+            continue;
+        }
+
+        for (size_t k = 0; k < clusters_in_block; k++) {
+            float score = sqrtf(dist[k]) - max_error[k];
+            if (score < min) {
+                min = score;
+            }
         }
     }
     return min;
 }
+
+static void kmeans_free_state(ei_anomaly_kmeans_state_t *state) {
+    ei_free(state->input);
+    ei_free(state->centroids);
+    memset(state, 0, sizeof(ei_anomaly_kmeans_state_t));
+}
+
+/**
+ * Find the state of a K-means block, or build it (once, every block keeps its own
+ * state while there are no more than EI_ANOMALY_KMEANS_MAX_BLOCKS). The interleaved
+ * centroids are optional: if they do not fit in memory the clusters are read
+ * straight from the block config.
+ */
+static EI_IMPULSE_ERROR kmeans_prepare_state(const ei_impulse_t *impulse,
+    const ei_learning_block_config_anomaly_kmeans_t *block_config, ei_anomaly_kmeans_state_t **state_out) {
+
+    ei_anomaly_kmeans_state_t *state = nullptr;
+    for (size_t ix = 0; ix < EI_ANOMALY_KMEANS_MAX_BLOCKS; ix++) {
+        ei_anomaly_kmeans_state_t *s = &ei_anomaly_kmeans_states[ix];
+        if (s->config && s->impulse == impulse && s->block_id == block_config->block_id) {
+            state = s;
+            break;
+        }
+        if (!s->config && !state) {
+            state = s;
+        }
+    }
+    if (!state) {
+        // more blocks than states, take turns
+        state = &ei_anomaly_kmeans_states[ei_anomaly_kmeans_next_evict];
+        ei_anomaly_kmeans_next_evict = (ei_anomaly_kmeans_next_evict + 1) % EI_ANOMALY_KMEANS_MAX_BLOCKS;
+    }
+    *state_out = state;
+    if (state->config == block_config && state->impulse == impulse) {
+        return EI_IMPULSE_OK;
+    }
+
+    kmeans_free_state(state);
+
+    const size_t features = block_config->anom_axes_size;
+    state->input = (float*)ei_malloc(2 * features * sizeof(float));
+    if (!state->input) {
+        ei_printf("Failed to allocate memory for anomaly input buffer");
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    state->inv_scale = state->input + features;
+    for (size_t ix = 0; ix < features; ix++) {
+        state->inv_scale[ix] = 1.0f / block_config->anom_scale[ix];
+    }
+
+    const size_t B = EI_ANOMALY_KMEANS_BLOCK;
+    const size_t padded_clusters = ((block_config->anom_cluster_count + B - 1) / B) * B;
+    state->centroids = (float*)ei_malloc((padded_clusters * features + padded_clusters) * sizeof(float));
+    if (state->centroids) {
+        state->max_error = state->centroids + (padded_clusters * features);
+        for (size_t cx = 0; cx < padded_clusters; cx++) {
+            const bool pad = cx >= block_config->anom_cluster_count;
+            float *dst = &state->centroids[((cx / B) * features * B) + (cx % B)];
+            for (size_t ix = 0; ix < features; ix++) {
+                dst[ix * B] = pad ? 0.0f : block_config->anom_clusters[cx].centroid[ix];
+            }
+            state->max_error[cx] = pad ? 0.0f : block_config->anom_clusters[cx].max_error;
+        }
+    }
+
+    state->impulse = impulse;
+    state->block_id = block_config->block_id;
+    state->config = block_config;
+    return EI_IMPULSE_OK;
+}
 #endif // EI_CLASSIFIER_HAS_ANOMALY_KMEANS
 
 #ifdef __cplusplus
@@ -183,17 +338,23 @@ EI_IMPULSE_ERROR run_kmeans_anomaly(
 
     uint64_t anomaly_start_us = ei_read_timer_us();
 
-    float *input = (float*)ei_malloc(block_config->anom_axes_size * sizeof(float));
-    if (!input) {
-        ei_printf("Failed to allocate memory for anomaly input buffer");
-        return EI_IMPULSE_OUT_OF_MEMORY;
+    ei_anomaly_kmeans_state_t *state;
+    EI_IMPULSE_ERROR res = kmeans_prepare_state(impulse, block_config, &state);
+    if (res != EI_IMPULSE_OK) {
+        return res;
     }
+    float *input = state->input;
 
     extract_anomaly_input_values(fmatrix, input_block_ids, input_block_ids_size, block_config->anom_axes_size, block_config->anom_axis, input);
 
-    standard_scaler(input, block_config->anom_scale, block_config->anom_mean, block_config->anom_axes_size);
-    float anomaly = get_min_distance_to_cluster(
-        input, block_config->anom_axes_size, block_config->anom_clusters, block_config->anom_cluster_count);
+    // standard scaler
+    for (size_t ix = 0; ix < block_config->anom_axes_size; ix++) {
+        input[ix] = (input[ix] - block_config->anom_mean[ix]) * state->inv_scale[ix];
+    }
+
+    float anomaly = state->centroids ?
+        get_min_distance_to_cluster_blocked(state, block_config->anom_axes_size, block_config->anom_cluster_count) :
+        get_min_distance_to_cluster(input, block_config->anom_axes_size, block_config->anom_clusters, block_config->anom_cluster_count);
 
     uint64_t anomaly_end_us = ei_read_timer_us();
 
@@ -206,13 +367,15 @@ EI_IMPULSE_ERROR run_kmeans_anomaly(
     result->timing.anomaly_us = anomaly_end_us - anomaly_start_us;
     result->timing.anomaly = (int)(result->timing.anomaly_us / 1000);
     result->anomaly = anomaly;
-    ei_free(input);
 
     return EI_IMPULSE_OK;
 }
 #endif // EI_CLASSIFIER_HAS_ANOMALY_KMEANS
 
 #if EI_CLASSIFIER_HAS_ANOMALY_GMM
+// GMM gather buffer, kept between inferences
+static std::unique_ptr<ei::matrix_t> ei_anomaly_gmm_matrix;
+
 EI_IMPULSE_ERROR run_gmm_anomaly(
     const ei_impulse_t *impulse,
     ei_feature_t *fmatrix,
@@ -238,10 +401,16 @@ EI_IMPULSE_ERROR run_gmm_anomaly(
         .graph_config = block_config->graph_config
     };
 
-    std::unique_ptr<ei::matrix_t> matrix_ptr(new ei::matrix_t(1, block_config->anom_axes_size));
-    std::unique_ptr<ei_feature_t[]> input_ptr(new ei_feature_t[1]);
-    ei_feature_t* input = input_ptr.get();
+    std::unique_ptr<ei::matrix_t> &matrix_ptr = ei_anomaly_gmm_matrix;
+    if (!matrix_ptr || matrix_ptr->cols != block_config->anom_axes_size) {
+        matrix_ptr.reset(new ei::matrix_t(1, block_config->anom_axes_size));
+    }
+    if (!matrix_ptr->buffer) {
+        matrix_ptr.reset();
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
 
+    ei_feature_t input[1];
     input[0].matrix = matrix_ptr.get();
     input[0].blockId = 0;
 
@@ -257,6 +426,23 @@ EI_IMPULSE_ERROR run_gmm_anomaly(
 }
 #endif // EI_CLASSIFIER_HAS_ANOMALY_GMM
 
+/**
+ * Release what the anomaly blocks keep between inferences (the K-means state and
+ * the GMM gather buffer), called from run_classifier_deinit()
+ */
+__attribute__((unused)) static void ei_anomaly_release_state(void)
+{
+#if EI_CLASSIFIER_HAS_ANOMALY_KMEANS
+    for (size_t ix = 0; ix < EI_ANOMALY_KMEANS_MAX_BLOCKS; ix++) {
+        kmeans_free_state(&ei_anomaly_kmeans_states[ix]);
+    }
+    ei_anomaly_kmeans_next_evict = 0;
+#endif // EI_CLASSIFIER_HAS_ANOMALY_KMEANS
+#if EI_CLASSIFIER_HAS_ANOMALY_GMM
+    ei_anomaly_gmm_matrix.reset();
+#endif // EI_CLASSIFIER_HAS_ANOMALY_GMM
+}
+
 #endif // EI_CLASSIFIER_LOAD_ANOMALY_H
 
 #endif // _EDGE_IMPULSE_INFERENCING_ANOMALY_H_
@@ -43,6 +43,8 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 #include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+#include "edge-impulse-sdk/classifier/ei_arena_report.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 
 /**
  * Setup the TFLite runtime
@@ -66,7 +68,7 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     TfLiteTensor *outputs = *output_arg;
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
+    TfLiteStatus init_status = graph_config->model_init(ei_scratch_arena_aligned_calloc);
     if (init_status != kTfLiteOk) {
         ei_printf("Failed to initialize the model (error code %d)\n", init_status);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
@@ -112,8 +114,11 @@ static EI_IMPULSE_ERROR inference_tflite_run(
 
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    if (graph_config->model_invoke() != kTfLiteOk) {
-        return EI_IMPULSE_TFLITE_ERROR;
+    {
+        EI_PROFILE_SCOPE("nn.invoke");
+        if (graph_config->model_invoke() != kTfLiteOk) {
+            return EI_IMPULSE_TFLITE_ERROR;
+        }
     }
 
     uint64_t ctx_end_us = ei_read_timer_us();
@@ -170,8 +175,11 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     }
 
     // invoke the model
-    if (graph_config->model_invoke() != kTfLiteOk) {
-        return EI_IMPULSE_TFLITE_ERROR;
+    {
+        EI_PROFILE_SCOPE("nn.invoke");
+        if (graph_config->model_invoke() != kTfLiteOk) {
+            return EI_IMPULSE_TFLITE_ERROR;
+        }
     }
 
     auto output_res = fill_output_matrix_from_tensor(&outputs[0], output_matrix);
@@ -179,7 +187,7 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         return output_res;
     }
 
-    if (graph_config->model_reset(ei_aligned_free) != kTfLiteOk) {
+    if (graph_config->model_reset(ei_scratch_arena_aligned_free) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
     ei_free(outputs);
@@ -294,7 +302,7 @@ EI_IMPULSE_ERROR run_nn_inference(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    graph_config->model_reset(ei_aligned_free);
+    graph_config->model_reset(ei_scratch_arena_aligned_free);
     ei_free(outputs);
 
     if (run_res != EI_IMPULSE_OK) {
@@ -430,7 +438,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    graph_config->model_reset(ei_aligned_free);
+    graph_config->model_reset(ei_scratch_arena_aligned_free);
     ei_free(outputs);
 
     if (run_res != EI_IMPULSE_OK) {
@@ -441,6 +449,134 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
 }
 #endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
 
+#if EI_CLASSIFIER_ARENA_REPORT
+// The compiled model takes its tensor arena with a single alloc_fnc call in init, and does not
+// expose its allocator. The report fills that arena with a pattern and looks at what init
+// (persistent and scratch buffers, allocated from the tail and zeroed) and invoke (tensors,
+// from the head) overwrite.
+static uint8_t *arena_report_arena = NULL;
+static size_t arena_report_arena_size = 0;
+static uint8_t arena_report_fill = 0;
+
+static void *arena_report_calloc(size_t align, size_t size)
+{
+    uint8_t *ptr = (uint8_t*)ei_scratch_arena_aligned_calloc(align, size);
+    if (ptr && !arena_report_arena) {
+        arena_report_arena = ptr;
+        arena_report_arena_size = size;
+        memset(ptr, arena_report_fill, size);
+    }
+    return ptr;
+}
+
+/**
+ * @brief      Run init and invoke once on an arena filled with fill
+ *
+ * @param      graph_config      The compiled model
+ * @param[in]  fill              Byte to fill the arena with
+ * @param[out] persistent_start  Offset of the first byte written by init
+ * @param[out] nonpersistent_end Offset after the last byte below persistent_start written by invoke
+ *
+ * @return     The ei impulse error.
+ */
+static EI_IMPULSE_ERROR arena_report_probe(
+    ei_config_tflite_eon_graph_t *graph_config,
+    uint8_t fill,
+    size_t *persistent_start,
+    size_t *nonpersistent_end)
+{
+    arena_report_arena = NULL;
+    arena_report_arena_size = 0;
+    arena_report_fill = fill;
+
+    if (graph_config->model_init(arena_report_calloc) != kTfLiteOk) {
+        ei_printf("Failed to initialize the model\n");
+        return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+    }
+
+    if (!arena_report_arena) {
+        // static arena (EI_CLASSIFIER_ALLOCATION_STATIC), init clears it before we can look
+        graph_config->model_reset(ei_scratch_arena_aligned_free);
+        ei_printf("ERR: Arena report needs the compiled model built with EI_CLASSIFIER_ALLOCATION_HEAP\n");
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    size_t start = 0;
+    while (start < arena_report_arena_size && arena_report_arena[start] == fill) {
+        start++;
+    }
+
+    TfLiteTensor input;
+    if (graph_config->model_input(0, &input) != kTfLiteOk) {
+        graph_config->model_reset(ei_scratch_arena_aligned_free);
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+    memset(input.data.raw, 0, input.bytes);
+
+    if (graph_config->model_invoke() != kTfLiteOk) {
+        graph_config->model_reset(ei_scratch_arena_aligned_free);
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    size_t end = start;
+    while (end > 0 && arena_report_arena[end - 1] == fill) {
+        end--;
+    }
+
+    *persistent_start = start;
+    *nonpersistent_end = end;
+
+    graph_config->model_reset(ei_scratch_arena_aligned_free);
+    arena_report_arena = NULL;
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      Measure the arena of the compiled model: persistent bytes (written by init),
+ *             non-persistent bytes (written by invoke) and the headroom in between. Tensors and
+ *             per-kernel buffers are not visible from here, only the totals are filled in.
+ *             Two fill patterns are used, so a byte that happens to be written with the fill
+ *             value in one run is still seen in the other.
+ *
+ * @param      config_ptr  Learning block config (ei_learning_block_config_tflite_graph_t)
+ * @param      report      Report to fill in
+ *
+ * @return     The ei impulse error.
+ */
+static EI_IMPULSE_ERROR run_nn_arena_report(void *config_ptr, ei_arena_report_t *report)
+{
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    memset(report, 0, sizeof(ei_arena_report_t));
+
+    const uint8_t fills[2] = { 0xa5, 0x5a };
+    size_t persistent_start = SIZE_MAX;
+    size_t nonpersistent_end = 0;
+    size_t arena_size = 0;
+
+    for (size_t ix = 0; ix < sizeof(fills); ix++) {
+        size_t start, end;
+        EI_IMPULSE_ERROR res = arena_report_probe(graph_config, fills[ix], &start, &end);
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+        arena_size = arena_report_arena_size;
+        persistent_start = start < persistent_start ? start : persistent_start;
+        nonpersistent_end = end > nonpersistent_end ? end : nonpersistent_end;
+    }
+
+    report->engine = "eon";
+    report->arena_size = (uint32_t)arena_size;
+    report->persistent_bytes = (uint32_t)(arena_size - persistent_start);
+    report->nonpersistent_bytes = (uint32_t)nonpersistent_end;
+    report->headroom_bytes = (uint32_t)(persistent_start - nonpersistent_end);
+
+    return EI_IMPULSE_OK;
+}
+#endif // EI_CLASSIFIER_ARENA_REPORT
+
 __attribute__((unused)) int extract_tflite_eon_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_tflite_eon_t *dsp_config = (ei_dsp_config_tflite_eon_t*)config_ptr;
 
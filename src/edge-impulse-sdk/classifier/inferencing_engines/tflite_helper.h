@@ -91,18 +91,15 @@ EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
                 break;
             }
             case kTfLiteInt8: {
-                for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
-                    float val = (float)matrix->buffer[ix];
-                    input->data.int8[input_idx++] = static_cast<int8_t>(
-                        pre_cast_quantize(val, input->params.scale, input->params.zero_point, true));
-                }
+                const ei_quantize_params_t *qparams = ei_quantize_get_params(input->params.scale, input->params.zero_point, true);
+                ei_quantize_block(matrix->buffer, input->data.int8 + input_idx, matrix->rows * matrix->cols, qparams);
+                input_idx += matrix->rows * matrix->cols;
                 break;
             }
             case kTfLiteUInt8: {
-                for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
-                    float val = (float)matrix->buffer[ix];
-                    input->data.uint8[input_idx++] = static_cast<uint8_t>(
-                        pre_cast_quantize(val, input->params.scale, input->params.zero_point, false));            }
+                const ei_quantize_params_t *qparams = ei_quantize_get_params(input->params.scale, input->params.zero_point, false);
+                ei_quantize_block(matrix->buffer, input->data.uint8 + input_idx, matrix->rows * matrix->cols, qparams);
+                input_idx += matrix->rows * matrix->cols;
                 break;
             }
             default: {
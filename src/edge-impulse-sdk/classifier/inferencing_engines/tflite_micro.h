@@ -35,7 +35,7 @@
 #ifndef _EI_CLASSIFIER_INFERENCING_ENGINE_TFLITE_MICRO_H_
 #define _EI_CLASSIFIER_INFERENCING_ENGINE_TFLITE_MICRO_H_
 
-#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && ((EI_CLASSIFIER_COMPILED != 1) || (EI_CLASSIFIER_LOADABLE_MODEL == 1))
 
 #include "model-parameters/model_metadata.h"
 
@@ -47,6 +47,12 @@
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
+#include "edge-impulse-sdk/classifier/ei_arena_report.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+
+#if EI_CLASSIFIER_ARENA_REPORT
+#include "edge-impulse-sdk/tensorflow/lite/micro/recording_micro_interpreter.h"
+#endif
 
 #if defined(EI_CLASSIFIER_HAS_TFLITE_OPS_RESOLVER) && EI_CLASSIFIER_HAS_TFLITE_OPS_RESOLVER == 1
 #include "tflite-model/tflite-resolver.h"
@@ -88,6 +94,12 @@
 #define DEFINE_SECTION(x) __attribute__((section(x)))
 #endif
 
+#if EI_CLASSIFIER_COMPILED == 1
+// Next to an EON compiled model the interpreter only runs models loaded at runtime
+// (EI_CLASSIFIER_LOADABLE_MODEL), its entry points live apart from the EON ones
+namespace ei_interpreter {
+#endif // EI_CLASSIFIER_COMPILED == 1
+
 /**
  * Setup the TFLite runtime
  *
@@ -112,8 +124,10 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
 
     ei_config_tflite_graph_t *graph_config = (ei_config_tflite_graph_t*)block_config->graph_config;
 
-#ifdef EI_CLASSIFIER_ALLOCATION_STATIC
+#if defined(EI_CLASSIFIER_ALLOCATION_STATIC) && (EI_CLASSIFIER_LOADABLE_MODEL != 1) && !EIDSP_SCRATCH_ARENA
     // Assign a no-op lambda to the "free" function in case of static arena
+    // (loaded models bring their own arena size, so they always take it from the heap,
+    // with EIDSP_SCRATCH_ARENA the static scratch arena is the tensor arena)
 #if defined (EI_TENSOR_ARENA_LOCATION)
     static uint8_t tensor_arena[EI_CLASSIFIER_TFLITE_LARGEST_ARENA_SIZE] ALIGN(16) DEFINE_SECTION(STRINGIZE_VALUE_OF(EI_TENSOR_ARENA_LOCATION));
 #else
@@ -122,12 +136,13 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     p_tensor_arena = ei_unique_ptr_t(tensor_arena, [](void*){});
 #else
     // Create an area of memory to use for input, output, and intermediate arrays.
-    uint8_t *tensor_arena = (uint8_t*)ei_aligned_calloc(16, graph_config->arena_size);
+    // (this is the impulse scratch arena if EIDSP_SCRATCH_ARENA is enabled and it's large enough)
+    uint8_t *tensor_arena = (uint8_t*)ei_scratch_arena_aligned_calloc(16, graph_config->arena_size);
     if (tensor_arena == NULL) {
         ei_printf("Failed to allocate TFLite arena (%zu bytes)\n", graph_config->arena_size);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
     }
-    p_tensor_arena = ei_unique_ptr_t(tensor_arena, ei_aligned_free);
+    p_tensor_arena = ei_unique_ptr_t(tensor_arena, ei_scratch_arena_aligned_free);
 #endif
 
     static bool tflite_first_run = true;
@@ -222,7 +237,11 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     void* micro_profiler) {
 
     // Run inference, and report any error
-    TfLiteStatus invoke_status = interpreter->Invoke();
+    TfLiteStatus invoke_status;
+    {
+        EI_PROFILE_SCOPE("nn.invoke");
+        invoke_status = interpreter->Invoke();
+    }
     if (invoke_status != kTfLiteOk) {
         delete interpreter;
         ei_printf("Invoke failed (%d)\n", invoke_status);
@@ -301,7 +320,11 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     }
 
     // Run inference, and report any error
-    TfLiteStatus invoke_status = interpreter->Invoke();
+    TfLiteStatus invoke_status;
+    {
+        EI_PROFILE_SCOPE("nn.invoke");
+        invoke_status = interpreter->Invoke();
+    }
     if (invoke_status != kTfLiteOk) {
         ei_printf("Invoke failed (%d)\n", invoke_status);
         return EI_IMPULSE_TFLITE_ERROR;
@@ -576,6 +599,115 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
 }
 #endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
 
+#if EI_CLASSIFIER_ARENA_REPORT
+static const int* arena_report_get_node_io(void *ctx, size_t node, bool outputs)
+{
+    const tflite::SubGraph *subgraph = (const tflite::SubGraph*)ctx;
+    const tflite::Operator *op = subgraph->operators()->Get(node);
+    // flatbuffer vectors are stored as length + data, same layout as TfLiteIntArray
+    return outputs ? (const int*)op->outputs() : (const int*)op->inputs();
+}
+
+/**
+ * @brief      Build an interpreter with a RecordingMicroAllocator, allocate the tensors
+ *             and collect the arena report. The interpreter and arena are freed afterwards.
+ *
+ * @param      config_ptr  Learning block config (ei_learning_block_config_tflite_graph_t)
+ * @param      report      Report to fill in
+ *
+ * @return     The ei impulse error.
+ */
+static EI_IMPULSE_ERROR run_nn_arena_report(void *config_ptr, ei_arena_report_t *report)
+{
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)config_ptr;
+    ei_config_tflite_graph_t *graph_config = (ei_config_tflite_graph_t*)block_config->graph_config;
+
+    memset(report, 0, sizeof(ei_arena_report_t));
+
+    const tflite::Model *model = tflite::GetModel(graph_config->model);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    uint8_t *tensor_arena = (uint8_t*)ei_scratch_arena_aligned_calloc(16, graph_config->arena_size);
+    if (tensor_arena == NULL) {
+        ei_printf("Failed to allocate TFLite arena (%zu bytes)\n", graph_config->arena_size);
+        return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+    }
+    ei_unique_ptr_t p_tensor_arena(tensor_arena, ei_scratch_arena_aligned_free);
+
+#ifdef EI_TFLITE_RESOLVER
+    EI_TFLITE_RESOLVER
+#else
+    static tflite::AllOpsResolver resolver;
+#endif
+
+    std::unique_ptr<tflite::RecordingMicroInterpreter> interpreter(new tflite::RecordingMicroInterpreter(
+        model, resolver, tensor_arena, graph_config->arena_size));
+
+    if (interpreter->AllocateTensors(true) != kTfLiteOk) {
+        ei_printf("AllocateTensors() failed, arena (%zu bytes) too small\n", graph_config->arena_size);
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    const tflite::RecordingMicroAllocator &allocator = interpreter->GetMicroAllocator();
+    const tflite::RecordingSingleArenaBufferAllocator *memory = allocator.GetSimpleMemoryAllocator();
+
+    report->engine = "tflite";
+    report->arena_size = graph_config->arena_size;
+    report->nonpersistent_bytes = memory->GetNonPersistentUsedBytes();
+    report->persistent_bytes = memory->GetPersistentUsedBytes();
+    report->headroom_bytes = graph_config->arena_size - memory->GetUsedBytes();
+
+    const struct {
+        tflite::RecordedAllocationType type;
+        const char *name;
+    } buckets[EI_ARENA_REPORT_MAX_RECORDED] = {
+        { tflite::RecordedAllocationType::kTfLiteEvalTensorData, "evalTensorData" },
+        { tflite::RecordedAllocationType::kPersistentTfLiteTensorData, "persistentTensorData" },
+        { tflite::RecordedAllocationType::kPersistentTfLiteTensorQuantizationData, "persistentQuantizationData" },
+        { tflite::RecordedAllocationType::kPersistentBufferData, "persistentBufferData" },
+        { tflite::RecordedAllocationType::kTfLiteTensorVariableBufferData, "variableBufferData" },
+        { tflite::RecordedAllocationType::kNodeAndRegistrationArray, "nodeAndRegistrationArray" },
+    };
+    for (size_t ix = 0; ix < EI_ARENA_REPORT_MAX_RECORDED; ix++) {
+        tflite::RecordedAllocation r = allocator.GetRecordedAllocation(buckets[ix].type);
+        report->recorded[ix].name = buckets[ix].name;
+        report->recorded[ix].requested_bytes = r.requested_bytes;
+        report->recorded[ix].used_bytes = r.used_bytes;
+        report->recorded[ix].count = r.count;
+    }
+    report->recorded_count = EI_ARENA_REPORT_MAX_RECORDED;
+
+    // tensor() allocates a persistent TfLiteTensor per call, so only do this after recording the buckets
+    const tflite::SubGraph *subgraph = model->subgraphs()->Get(0);
+    report->nodes_count = subgraph->operators()->size();
+    for (size_t ix = 0; ix < interpreter->tensors_size(); ix++) {
+        TfLiteTensor *tensor = interpreter->tensor(ix);
+        if (!tensor || tensor->allocation_type != kTfLiteArenaRw) {
+            continue;
+        }
+        uint8_t *data = (uint8_t*)tensor->data.data;
+        if (data < tensor_arena || data >= tensor_arena + graph_config->arena_size) {
+            continue;
+        }
+        if (report->tensors_count < EI_ARENA_REPORT_MAX_TENSORS) {
+            ei_arena_report_tensor_t *t = &report->tensors[report->tensors_count];
+            t->index = (int16_t)ix;
+            t->offset = (uint32_t)(data - tensor_arena);
+            t->bytes = (uint32_t)tensor->bytes;
+        }
+        report->tensors_count++;
+    }
+    ei_arena_report_compute_lifetimes(report, &arena_report_get_node_io, (void*)subgraph);
+
+    return EI_IMPULSE_OK;
+}
+#endif // EI_CLASSIFIER_ARENA_REPORT
+
+#if EI_CLASSIFIER_COMPILED == 1
+} // namespace ei_interpreter
+#else
 __attribute__((unused)) int extract_tflite_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float frequency) {
     ei_dsp_config_tflite_t *dsp_config = (ei_dsp_config_tflite_t*)config_ptr;
 
@@ -606,6 +738,7 @@ __attribute__((unused)) int extract_tflite_features(signal_t *signal, matrix_t *
 
     return EIDSP_OK;
 }
+#endif // EI_CLASSIFIER_COMPILED == 1
 
-#endif // (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED != 1)
+#endif // (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && ((EI_CLASSIFIER_COMPILED != 1) || (EI_CLASSIFIER_LOADABLE_MODEL == 1))
 #endif // _EI_CLASSIFIER_INFERENCING_ENGINE_TFLITE_MICRO_H_
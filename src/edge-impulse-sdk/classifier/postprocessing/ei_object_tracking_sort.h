@@ -65,6 +65,16 @@ extern ei_impulse_handle_t &ei_default_impulse;
 #include <utility>
 #include <vector>
 
+// Number of trackers that are allocated when the tracker is created (live tracks at any time)
+#ifndef EI_OBJECT_TRACKING_SORT_MAX_TRACKS
+#define EI_OBJECT_TRACKING_SORT_MAX_TRACKS 64
+#endif
+
+// Largest component side that is solved by exhaustive search (up to 4! assignments by default)
+#ifndef EI_OBJECT_TRACKING_SORT_ENUM_MAX
+#define EI_OBJECT_TRACKING_SORT_ENUM_MAX 4
+#endif
+
 static inline bool labels_match(const char *a, const char *b)
 {
     // If labels are not provided, don't constrain matching.
@@ -195,17 +205,15 @@ static bool invert4x4(const double A[4][4], double invA[4][4])
     return true;
 }
 
-// Minimal fixed-size Kalman filter for SORT.
-// State: [u,v,s,r, u_dot,v_dot,s_dot]^T (7D), measurement: [u,v,s,r]^T (4D)
-struct Kalman7x4 {
-    std::array<double, 7> x {}; // state
-    double P[7][7] {}; // covariance
+// Constant matrices of the SORT Kalman filter, shared by all trackers
+struct Kalman7x4Model {
     double F[7][7] {}; // state transition
     double H[4][7] {}; // measurement matrix
     double Q[7][7] {}; // process noise
     double R[4][4] {}; // measurement noise
+    double P0[7][7] {}; // initial covariance
 
-    Kalman7x4()
+    Kalman7x4Model()
     {
         // F as in authors' reference implementation: constant velocity, dt=1
         // [1 0 0 0 1 0 0]
@@ -267,14 +275,37 @@ struct Kalman7x4 {
 
         for (int i = 0; i < 7; ++i) {
             for (int j = 0; j < 7; ++j) {
-                P[i][j] = 0.0;
+                P0[i][j] = 0.0;
             }
         }
         for (int i = 0; i < 7; ++i) {
-            P[i][i] = 10.0;
+            P0[i][i] = 10.0;
         }
         for (int i = 4; i < 7; ++i) {
-            P[i][i] *= 1000.0; // high uncertainty on initial velocities
+            P0[i][i] *= 1000.0; // high uncertainty on initial velocities
+        }
+    }
+};
+
+static const Kalman7x4Model &sort_kalman_model()
+{
+    static const Kalman7x4Model model;
+    return model;
+}
+
+// Minimal fixed-size Kalman filter for SORT.
+// State: [u,v,s,r, u_dot,v_dot,s_dot]^T (7D), measurement: [u,v,s,r]^T (4D)
+struct Kalman7x4 {
+    std::array<double, 7> x {}; // state
+    double P[7][7] {}; // covariance
+
+    Kalman7x4()
+    {
+        const Kalman7x4Model &m = sort_kalman_model();
+        for (int i = 0; i < 7; ++i) {
+            for (int j = 0; j < 7; ++j) {
+                P[i][j] = m.P0[i][j];
+            }
         }
     }
 
@@ -286,6 +317,8 @@ struct Kalman7x4 {
 
     void predict()
     {
+        const Kalman7x4Model &m = sort_kalman_model();
+
         // Prevent scale from going negative (matches python guard)
         if ((x[6] + x[2]) <= 0.0) {
             x[6] = 0.0;
@@ -296,7 +329,7 @@ struct Kalman7x4 {
         for (int i = 0; i < 7; ++i) {
             double s = 0.0;
             for (int j = 0; j < 7; ++j) {
-                s += F[i][j] * x[j];
+                s += m.F[i][j] * x[j];
             }
             xp[i] = s;
         }
@@ -308,7 +341,7 @@ struct Kalman7x4 {
             for (int j = 0; j < 7; ++j) {
                 double s = 0.0;
                 for (int k = 0; k < 7; ++k) {
-                    s += F[i][k] * P[k][j];
+                    s += m.F[i][k] * P[k][j];
                 }
                 FP[i][j] = s;
             }
@@ -318,9 +351,9 @@ struct Kalman7x4 {
             for (int j = 0; j < 7; ++j) {
                 double s = 0.0;
                 for (int k = 0; k < 7; ++k) {
-                    s += FP[i][k] * F[j][k]; // FPF^T
+                    s += FP[i][k] * m.F[j][k]; // FPF^T
                 }
-                FPFt[i][j] = s + Q[i][j];
+                FPFt[i][j] = s + m.Q[i][j];
             }
         }
         for (int i = 0; i < 7; ++i) {
@@ -332,6 +365,7 @@ struct Kalman7x4 {
 
     void update(const BBox &bb)
     {
+        const Kalman7x4Model &m = sort_kalman_model();
         const auto z = bbox_to_z(bb);
 
         // y = z - Hx
@@ -339,7 +373,7 @@ struct Kalman7x4 {
         for (int i = 0; i < 4; ++i) {
             double hx = 0.0;
             for (int j = 0; j < 7; ++j) {
-                hx += H[i][j] * x[j];
+                hx += m.H[i][j] * x[j];
             }
             y[i] = z[i] - hx;
         }
@@ -350,7 +384,7 @@ struct Kalman7x4 {
             for (int j = 0; j < 7; ++j) {
                 double s = 0.0;
                 for (int k = 0; k < 7; ++k) {
-                    s += H[i][k] * P[k][j];
+                    s += m.H[i][k] * P[k][j];
                 }
                 HP[i][j] = s;
             }
@@ -360,9 +394,9 @@ struct Kalman7x4 {
             for (int j = 0; j < 4; ++j) {
                 double s = 0.0;
                 for (int k = 0; k < 7; ++k) {
-                    s += HP[i][k] * H[j][k]; // HP H^T
+                    s += HP[i][k] * m.H[j][k]; // HP H^T
                 }
-                S[i][j] = s + R[i][j];
+                S[i][j] = s + m.R[i][j];
             }
         }
 
@@ -378,7 +412,7 @@ struct Kalman7x4 {
             for (int j = 0; j < 4; ++j) {
                 double s = 0.0;
                 for (int k = 0; k < 7; ++k) {
-                    s += P[i][k] * H[j][k];
+                    s += P[i][k] * m.H[j][k];
                 }
                 PHt[i][j] = s;
             }
@@ -409,7 +443,7 @@ struct Kalman7x4 {
             for (int j = 0; j < 7; ++j) {
                 double s = 0.0;
                 for (int k = 0; k < 4; ++k) {
-                    s += K[i][k] * H[k][j];
+                    s += K[i][k] * m.H[k][j];
                 }
                 KH[i][j] = s;
             }
@@ -438,98 +472,6 @@ struct Kalman7x4 {
     }
 };
 
-// Fast rectangular Hungarian (min-cost assignment) using potentials (O(n^2 m))
-// Returns pairs (row, col) for assigned rows.
-// If n==0 or m==0, returns empty.
-static std::vector<std::pair<int, int>> hungarian_min(const std::vector<std::vector<double>> &cost)
-{
-    const int n = static_cast<int>(cost.size());
-    const int m = n ? static_cast<int>(cost[0].size()) : 0;
-    std::vector<std::pair<int, int>> result;
-    if (n == 0 || m == 0) {
-        return result;
-    }
-
-    // Ensure n <= m for this implementation; if not, transpose.
-    if (n > m) {
-        std::vector<std::vector<double>> ct(m, std::vector<double>(n));
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < m; ++j) {
-                ct[j][i] = cost[i][j];
-            }
-        }
-        auto tr = hungarian_min(ct);
-        result.reserve(tr.size());
-        for (auto &p : tr) {
-            result.emplace_back(p.second, p.first);
-        }
-        return result;
-    }
-
-    const double INF = 1e100;
-    std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0);
-    std::vector<int> p(m + 1, 0), way(m + 1, 0);
-
-    for (int i = 1; i <= n; ++i) {
-        p[0] = i;
-        int j0 = 0;
-        std::vector<double> minv(m + 1, INF);
-        std::vector<char> used(m + 1, false);
-        do {
-            used[j0] = true;
-            int i0 = p[j0];
-            double delta = INF;
-            int j1 = 0;
-            for (int j = 1; j <= m; ++j) {
-                if (!used[j]) {
-                    double cur = cost[i0 - 1][j - 1] - u[i0] - v[j];
-                    if (cur < minv[j]) {
-                        minv[j] = cur;
-                        way[j] = j0;
-                    }
-                    if (minv[j] < delta) {
-                        delta = minv[j];
-                        j1 = j;
-                    }
-                }
-            }
-            for (int j = 0; j <= m; ++j) {
-                if (used[j]) {
-                    u[p[j]] += delta;
-                    v[j] -= delta;
-                }
-                else {
-                    minv[j] -= delta;
-                }
-            }
-            j0 = j1;
-        } while (p[j0] != 0);
-
-        // Augmenting
-        do {
-            int j1 = way[j0];
-            p[j0] = p[j1];
-            j0 = j1;
-        } while (j0 != 0);
-    }
-
-    // p[j] = assigned row for column j
-    std::vector<int> assign_row(n + 1, 0); // row -> col
-    for (int j = 1; j <= m; ++j) {
-        if (p[j] != 0) {
-            assign_row[p[j]] = j;
-        }
-    }
-
-    result.reserve(n);
-    for (int i = 1; i <= n; ++i) {
-        if (assign_row[i]) {
-            result.emplace_back(i - 1, assign_row[i] - 1);
-        }
-    }
-    return result;
-}
-
 struct KalmanBoxTracker {
     Kalman7x4 kf;
     int time_since_update = 0;
@@ -544,10 +486,26 @@ struct KalmanBoxTracker {
     static int next_id;
     static int next_output_id;
 
+    KalmanBoxTracker()
+    {
+    }
+
     explicit KalmanBoxTracker(const BBox &init_bb)
     {
+        init(init_bb);
+    }
+
+    // (Re)start the tracker from a detection, used when a pooled tracker is reused
+    void init(const BBox &init_bb)
+    {
+        kf = Kalman7x4();
         kf.init_from_bbox(init_bb);
+        time_since_update = 0;
         id = next_id++;
+        output_id = -1;
+        hits = 0;
+        hit_streak = 0;
+        age = 0;
         label = init_bb.label;
         score = init_bb.score;
     }
@@ -589,112 +547,273 @@ struct KalmanBoxTracker {
 int KalmanBoxTracker::next_id = 0;
 int KalmanBoxTracker::next_output_id = 0;
 
+// Buffers for associate_detections_to_trackers. They are resized every frame but
+// keep their capacity, so once the largest frame has been seen nothing is allocated.
+struct SORTAssociationWorkspace {
+    std::vector<float> iou_mat;         // Det x Trackers, row major
+    std::vector<int> parent;            // union-find over detections (0..D-1) and trackers (D..D+T-1)
+    std::vector<int> component_head;    // per root, first member of the component
+    std::vector<int> component_next;    // next member of the same component, -1 terminates
+    std::vector<int> component_dets;
+    std::vector<int> component_trks;
+    std::vector<int> best_assignment;   // per row of the component (smaller side), column or -1
+    std::vector<int> cur_assignment;
+    std::vector<char> col_used;
+    std::vector<double> cost;           // component cost matrix for rectangular_lsap
+    std::vector<int64_t> lsap_rows;
+    std::vector<int64_t> lsap_cols;
+    std::vector<char> det_assigned;
+    std::vector<char> trk_assigned;
+    std::vector<std::pair<int, int>> matches;
+    std::vector<int> unmatched_dets;
+    std::vector<int> unmatched_trks;
+};
+
+static int sort_find_root(std::vector<int> &parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Exhaustive search over all assignments of the rows to distinct columns (maximize the IOU sum)
+static void sort_enumerate_assignments(
+    SORTAssociationWorkspace &ws,
+    const double *iou_of, // rows x cols, row major
+    int rows,
+    int cols,
+    int row,
+    double sum,
+    double *best_sum)
+{
+    if (row == rows) {
+        if (sum > *best_sum) {
+            *best_sum = sum;
+            std::copy(ws.cur_assignment.begin(), ws.cur_assignment.begin() + rows, ws.best_assignment.begin());
+        }
+        return;
+    }
+    for (int c = 0; c < cols; ++c) {
+        if (ws.col_used[c]) {
+            continue;
+        }
+        ws.col_used[c] = true;
+        ws.cur_assignment[row] = c;
+        sort_enumerate_assignments(ws, iou_of, rows, cols, row + 1, sum + iou_of[row * cols + c], best_sum);
+        ws.col_used[c] = false;
+    }
+}
+
+/**
+ * Maximum-IOU assignment within one connected component of the IOU graph.
+ * Components are independent, so solving them separately gives the same total
+ * as an assignment over the whole matrix.
+ *   - a single detection or tracker: pick the best partner
+ *   - both sides <= EI_OBJECT_TRACKING_SORT_ENUM_MAX: exhaustive search
+ *   - otherwise: rectangular_lsap
+ * Pairs below iou_threshold are rejected afterwards, as before.
+ */
+static void sort_assign_component(SORTAssociationWorkspace &ws, int T, float iou_threshold)
+{
+    const int nd = static_cast<int>(ws.component_dets.size());
+    const int nt = static_cast<int>(ws.component_trks.size());
+    if (nd == 0 || nt == 0) {
+        return;
+    }
+
+    auto accept = [&](int d, int t) {
+        if (ws.iou_mat[d * T + t] < iou_threshold) {
+            return;
+        }
+        ws.matches.emplace_back(d, t);
+        ws.det_assigned[d] = true;
+        ws.trk_assigned[t] = true;
+    };
+
+    if (nd == 1 || nt == 1) {
+        int best_d = ws.component_dets[0], best_t = ws.component_trks[0];
+        for (int d : ws.component_dets) {
+            for (int t : ws.component_trks) {
+                if (ws.iou_mat[d * T + t] > ws.iou_mat[best_d * T + best_t]) {
+                    best_d = d;
+                    best_t = t;
+                }
+            }
+        }
+        accept(best_d, best_t);
+        return;
+    }
+
+    // component matrix with the smaller side as rows
+    const bool dets_are_rows = nd <= nt;
+    const int rows = dets_are_rows ? nd : nt;
+    const int cols = dets_are_rows ? nt : nd;
+    ws.cost.resize(rows * cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const int d = ws.component_dets[dets_are_rows ? r : c];
+            const int t = ws.component_trks[dets_are_rows ? c : r];
+            ws.cost[r * cols + c] = ws.iou_mat[d * T + t];
+        }
+    }
+
+    ws.best_assignment.assign(rows, -1);
+    if (cols <= EI_OBJECT_TRACKING_SORT_ENUM_MAX) {
+        ws.cur_assignment.resize(rows);
+        ws.col_used.assign(cols, false);
+        double best_sum = -1.0;
+        sort_enumerate_assignments(ws, ws.cost.data(), rows, cols, 0, 0.0, &best_sum);
+    }
+    else {
+        ws.lsap_rows.resize(rows);
+        ws.lsap_cols.resize(rows);
+        if (solve_rectangular_linear_sum_assignment(rows, cols, ws.cost.data(), true,
+                ws.lsap_rows.data(), ws.lsap_cols.data()) != 0) {
+            return;
+        }
+        for (int i = 0; i < rows; ++i) {
+            ws.best_assignment[ws.lsap_rows[i]] = static_cast<int>(ws.lsap_cols[i]);
+        }
+    }
+
+    for (int r = 0; r < rows; ++r) {
+        const int c = ws.best_assignment[r];
+        if (c < 0) {
+            continue;
+        }
+        accept(ws.component_dets[dets_are_rows ? r : c], ws.component_trks[dets_are_rows ? c : r]);
+    }
+}
+
 // Association similar to SORT:
 // - build IOU matrix between detections and predicted trackers
-// - if unique one-to-one above threshold -> use directly else Hungarian on -IOU
+// - if unique one-to-one above threshold -> use directly, else a maximum-IOU
+//   assignment per connected component of the IOU graph (see sort_assign_component)
 // - reject matches with IOU < threshold
+// Results are left in ws.matches, ws.unmatched_dets and ws.unmatched_trks.
 static void associate_detections_to_trackers(
-    const std::vector<BBox> &detections,
-    const std::vector<BBox> &trackers_pred,
+    const BBox *detections,
+    int D,
+    const BBox *trackers_pred,
+    int T,
     float iou_threshold,
-    std::vector<std::pair<int, int>> &matches,
-    std::vector<int> &unmatched_dets,
-    std::vector<int> &unmatched_trks)
+    SORTAssociationWorkspace &ws)
 {
-    matches.clear();
-    unmatched_dets.clear();
-    unmatched_trks.clear();
+    ws.matches.clear();
+    ws.unmatched_dets.clear();
+    ws.unmatched_trks.clear();
 
-    const int D = static_cast<int>(detections.size());
-    const int T = static_cast<int>(trackers_pred.size());
     // shortcut if no trackers exist, all detections are unmatched
     if (T == 0) {
-        unmatched_dets.resize(D);
-        std::iota(unmatched_dets.begin(), unmatched_dets.end(), 0);
+        ws.unmatched_dets.resize(D);
+        std::iota(ws.unmatched_dets.begin(), ws.unmatched_dets.end(), 0);
         return;
     }
 
     // initial IOU matrix (Det x Trackers); zero if labels don't match
-    std::vector<std::vector<double>> iou_mat(D, std::vector<double>(T, 0.0));
+    ws.iou_mat.resize(D * T);
     for (int d = 0; d < D; ++d) {
         for (int t = 0; t < T; ++t) {
-            iou_mat[d][t] = labels_match(detections[d].label, trackers_pred[t].label)
-                ? static_cast<double>(iou(detections[d], trackers_pred[t]))
-                : 0.0;
+            ws.iou_mat[d * T + t] = labels_match(detections[d].label, trackers_pred[t].label)
+                ? iou(detections[d], trackers_pred[t])
+                : 0.0f;
         }
     }
 
+    ws.det_assigned.assign(D, false);
+    ws.trk_assigned.assign(T, false);
+
     // Check if each row/col has at most one candidate above threshold.
     bool trivial = true;
-    if (D > 0 && T > 0) {
-        for (int d = 0; d < D && trivial; ++d) {
-            int c = 0;
-            for (int t = 0; t < T; ++t) {
-                if (iou_mat[d][t] > iou_threshold) {
-                    ++c;
-                }
-            }
-            if (c > 1) {
-                trivial = false;
+    for (int d = 0; d < D && trivial; ++d) {
+        int c = 0;
+        for (int t = 0; t < T; ++t) {
+            if (ws.iou_mat[d * T + t] > iou_threshold) {
+                ++c;
             }
         }
-        for (int t = 0; t < T && trivial; ++t) {
-            int c = 0;
-            for (int d = 0; d < D; ++d) {
-                if (iou_mat[d][t] > iou_threshold) {
-                    ++c;
-                }
-            }
-            if (c > 1) {
-                trivial = false;
+        if (c > 1) {
+            trivial = false;
+        }
+    }
+    for (int t = 0; t < T && trivial; ++t) {
+        int c = 0;
+        for (int d = 0; d < D; ++d) {
+            if (ws.iou_mat[d * T + t] > iou_threshold) {
+                ++c;
             }
         }
+        if (c > 1) {
+            trivial = false;
+        }
     }
 
-    std::vector<std::pair<int, int>> cand;
     if (trivial) {
         for (int d = 0; d < D; ++d) {
             for (int t = 0; t < T; ++t) {
-                if (iou_mat[d][t] > iou_threshold) {
-                    cand.emplace_back(d, t);
+                if (ws.iou_mat[d * T + t] > iou_threshold) {
+                    ws.matches.emplace_back(d, t);
+                    ws.det_assigned[d] = true;
+                    ws.trk_assigned[t] = true;
                 }
             }
         }
     }
     else {
-        // Hungarian on cost = -IOU (maximize IOU)
-        std::vector<std::vector<double>> cost(D, std::vector<double>(T, 0.0));
+        // Connected components over pairs with a positive IOU (pairs with IOU 0 add nothing
+        // to an assignment). With a threshold <= 0 such pairs are accepted, so everything
+        // is one component.
+        ws.parent.resize(D + T);
+        std::iota(ws.parent.begin(), ws.parent.end(), 0);
         for (int d = 0; d < D; ++d) {
             for (int t = 0; t < T; ++t) {
-                cost[d][t] = -iou_mat[d][t];
+                if (iou_threshold <= 0.0f || ws.iou_mat[d * T + t] > 0.0f) {
+                    int a = sort_find_root(ws.parent, d);
+                    int b = sort_find_root(ws.parent, D + t);
+                    if (a != b) {
+                        ws.parent[std::max(a, b)] = std::min(a, b);
+                    }
+                }
             }
         }
-        cand = hungarian_min(cost);
-    }
 
-    std::vector<char> det_assigned(D, false), trk_assigned(T, false);
-    // Filter out low-IOU assignments
-    for (auto &m : cand) {
-        const int d = m.first, t = m.second;
-        if (d < 0 || d >= D || t < 0 || t >= T) {
-            continue;
+        // members per component, in increasing order
+        ws.component_head.assign(D + T, -1);
+        ws.component_next.resize(D + T);
+        for (int i = D + T - 1; i >= 0; --i) {
+            const int root = sort_find_root(ws.parent, i);
+            ws.component_next[i] = ws.component_head[root];
+            ws.component_head[root] = i;
         }
-        if (iou_mat[d][t] < iou_threshold) {
-            continue;
+
+        for (int root = 0; root < D + T; ++root) {
+            if (ws.component_head[root] < 0) {
+                continue;
+            }
+            ws.component_dets.clear();
+            ws.component_trks.clear();
+            for (int i = ws.component_head[root]; i >= 0; i = ws.component_next[i]) {
+                if (i < D) {
+                    ws.component_dets.push_back(i);
+                }
+                else {
+                    ws.component_trks.push_back(i - D);
+                }
+            }
+            sort_assign_component(ws, T, iou_threshold);
         }
-        matches.emplace_back(d, t);
-        det_assigned[d] = true;
-        trk_assigned[t] = true;
     }
 
     for (int d = 0; d < D; ++d) {
-        if (!det_assigned[d]) {
-            unmatched_dets.push_back(d);
+        if (!ws.det_assigned[d]) {
+            ws.unmatched_dets.push_back(d);
         }
     }
     for (int t = 0; t < T; ++t) {
-        if (!trk_assigned[t]) {
-            unmatched_trks.push_back(t);
+        if (!ws.trk_assigned[t]) {
+            ws.unmatched_trks.push_back(t);
         }
     }
 }
@@ -707,20 +826,36 @@ struct TrackResult {
 class SORTTracker {
 public:
     // In the paper TLost=1 in experiments; min_hits is the "probationary" period.
-    SORTTracker(int max_age_, int min_hits_, float iou_threshold_)
+    SORTTracker(int max_age_, int min_hits_, float iou_threshold_,
+                int max_tracks_ = EI_OBJECT_TRACKING_SORT_MAX_TRACKS)
         : max_age(max_age_)
         , min_hits(min_hits_)
         , iou_threshold(iou_threshold_)
+        , max_tracks(max_tracks_)
     {
+        // all trackers are allocated up front and recycled
+        tracker_pool_.resize(max_tracks);
+        trackers_.reserve(max_tracks);
+        free_trackers_.reserve(max_tracks);
+        for (int i = max_tracks - 1; i >= 0; --i) {
+            free_trackers_.push_back(i);
+        }
+        trks_pred_.reserve(max_tracks);
+        object_tracking_output.reserve(max_tracks);
     }
 
     void process_new_detections(const std::vector<ei_impulse_result_bounding_box_t> &detections_in)
+    {
+        process_new_detections(detections_in.data(), detections_in.size());
+    }
+
+    void process_new_detections(const ei_impulse_result_bounding_box_t *detections_in, size_t detections_count)
     {
         frame_count_++;
-        std::vector<BBox> detections;
-        detections.reserve(detections_in.size());
-        for (const auto &det : detections_in) {
-            BBox b;
+        detections_.resize(detections_count);
+        for (size_t ix = 0; ix < detections_count; ix++) {
+            const ei_impulse_result_bounding_box_t &det = detections_in[ix];
+            BBox &b = detections_[ix];
             // input is top-left + width/height; tracker uses centers
             b.x1 = static_cast<float>(det.x);
             b.y1 = static_cast<float>(det.y);
@@ -728,47 +863,48 @@ public:
             b.y2 = static_cast<float>(det.y + det.height);
             b.label = det.label;
             b.score = det.value;
-            detections.push_back(b);
         }
 
         // 1) Predict existing trackers.
-        std::vector<BBox> trks_pred;
-        trks_pred.reserve(trackers_.size());
-        for (auto &trk : trackers_) {
-            trks_pred.push_back(trk.predict());
+        trks_pred_.clear();
+        for (int slot : trackers_) {
+            trks_pred_.push_back(tracker_pool_[slot].predict());
         }
 
         // 2) Associate detections to trackers.
-        std::vector<std::pair<int, int>> matches;
-        std::vector<int> unmatched_dets;
-        std::vector<int> unmatched_trks; //not used at all in this implementation but could be useful for extensions
         associate_detections_to_trackers(
-            detections,
-            trks_pred,
+            detections_.data(),
+            static_cast<int>(detections_.size()),
+            trks_pred_.data(),
+            static_cast<int>(trks_pred_.size()),
             iou_threshold,
-            matches,
-            unmatched_dets,
-            unmatched_trks);
+            assoc_);
 
         // 3) Update matched trackers with assigned detections.
-        for (auto &mt : matches) {
+        for (auto &mt : assoc_.matches) {
             const int d = mt.first;
             const int t = mt.second;
-            trackers_[t].update(detections[d]);
+            tracker_pool_[trackers_[t]].update(detections_[d]);
         }
 
         // 4) Create new trackers for unmatched detections.
-        for (int idx : unmatched_dets) {
-            trackers_.emplace_back(detections[idx]);
+        for (int idx : assoc_.unmatched_dets) {
+            if (free_trackers_.empty()) {
+                EI_LOGW("SORTTracker: all %d trackers in use, detection not tracked\n", max_tracks);
+                break;
+            }
+            int slot = free_trackers_.back();
+            free_trackers_.pop_back();
+            tracker_pool_[slot].init(detections_[idx]);
+            trackers_.push_back(slot);
         }
 
         // 5) Prepare output + prune dead trackers.
         object_tracking_output.clear();
-        object_tracking_output.reserve(trackers_.size());
 
         // Iterate backwards when erasing.
         for (int i = static_cast<int>(trackers_.size()) - 1; i >= 0; --i) {
-            auto &trk = trackers_[i];
+            auto &trk = tracker_pool_[trackers_[i]];
 
             // Output only “confirmed” tracks, as in reference SORT:
             // if time_since_update < 1 AND (hit_streak >= min_hits OR frame_count <= min_hits)
@@ -789,8 +925,9 @@ public:
                 object_tracking_output.push_back(trace_result);
             }
 
-            // Remove dead tracklets.
+            // Remove dead tracklets, the slot goes back to the pool.
             if (trk.time_since_update > max_age) {
+                free_trackers_.push_back(trackers_[i]);
                 trackers_.erase(trackers_.begin() + i);
             }
         }
@@ -804,12 +941,19 @@ public:
 
 private:
     int frame_count_ = 0;
-    std::vector<KalmanBoxTracker> trackers_;
+    std::vector<KalmanBoxTracker> tracker_pool_;   // max_tracks trackers, allocated once
+    std::vector<int> trackers_;                    // pool slots of the live trackers, oldest first
+    std::vector<int> free_trackers_;               // unused pool slots
+    // per-frame buffers, they keep their capacity between frames
+    std::vector<BBox> detections_;
+    std::vector<BBox> trks_pred_;
+    SORTAssociationWorkspace assoc_;
 
 public:
     int max_age;
     int min_hits;
     float iou_threshold;
+    int max_tracks;
     std::vector<ei_object_tracking_trace_t> object_tracking_output;
 };
 
@@ -856,14 +1000,10 @@ EI_IMPULSE_ERROR process_object_tracking(
     ei_object_tracking_sort_config_t *config = (ei_object_tracking_sort_config_t*)config_ptr;
 
     if ((void *)object_tracker != NULL) {
-        ei_impulse_result_bounding_box_t *bbs = result->bounding_boxes;
-        uint32_t bbs_num = result->bounding_boxes_count;
-        std::vector<ei_impulse_result_bounding_box_t> detections(bbs, bbs + bbs_num);
-
         object_tracker->max_age = config->max_age;
         object_tracker->min_hits = config->min_hits;
         object_tracker->iou_threshold = config->iou_threshold;
-        object_tracker->process_new_detections(detections);
+        object_tracker->process_new_detections(result->bounding_boxes, result->bounding_boxes_count);
 
         result->postprocessed_output.object_tracking_output.open_traces =
             object_tracker->object_tracking_output.data();
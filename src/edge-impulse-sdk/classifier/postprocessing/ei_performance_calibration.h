@@ -43,11 +43,10 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "model-parameters/model_metadata.h"
 #include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_decision.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 
 /* Private const types ----------------------------------------------------- */
-#define MEM_ERROR   "ERR: Failed to allocate memory for performance calibration\r\n"
-
 #define EI_PC_RET_NO_EVENT_DETECTED    -1
 #define EI_PC_RET_MEMORY_ERROR         -2
 
@@ -65,8 +64,7 @@ public:
         uint32_t sample_length,
         float sample_interval_ms)
     {
-        this->_score_array = nullptr;
-        this->_running_sum = nullptr;
+        this->_window_ready = false;
         this->_detection_threshold = config->detection_threshold;
         this->_suppression_flags = config->suppression_flags;
         this->_should_boost = config->is_configured;
@@ -92,45 +90,18 @@ public:
             return;
         }
 
-        /* Array to store scores for all labels */
-        this->_score_array = (float *)ei_malloc(
-            this->_average_window_duration_samples * this->_n_labels * sizeof(float));
-
-        if (this->_score_array == NULL) {
-            ei_printf(MEM_ERROR);
-            return;
-        }
-
-        for (uint32_t i = 0; i < this->_average_window_duration_samples * this->_n_labels; i++) {
-            this->_score_array[i] = 0.f;
-        }
-        this->_score_idx = 0;
-
-        /* Running sum for all labels */
-        this->_running_sum = (float *)ei_malloc(this->_n_labels * sizeof(float));
-
-        if (this->_running_sum != NULL) {
-            for (uint32_t i = 0; i < this->_n_labels; i++) {
-                this->_running_sum[i] = 0.f;
-            }
-        }
-        else {
-            ei_printf(MEM_ERROR);
+        /* Score window and running sum for all labels (fixed capacity, see ei_classifier_decision.h) */
+        if (ei_classifier_score_window_init(&this->_window, this->_n_labels, this->_average_window_duration_samples)
+                != EI_IMPULSE_OK) {
+            EI_LOGE("Performance calibration window too long (%u x %u labels, max. %u x %u), "
+                "raise EI_CLASSIFIER_DECISION_MAX_WINDOW\r\n",
+                (unsigned int)this->_average_window_duration_samples, (unsigned int)this->_n_labels,
+                (unsigned int)EI_CLASSIFIER_DECISION_MAX_WINDOW, (unsigned int)EI_CLASSIFIER_DECISION_MAX_LABELS);
             return;
         }
+        this->_window_ready = true;
 
         this->_suppression_count = this->_suppression_samples;
-        this->_n_scores_in_array = 0;
-    }
-
-    ~PerfCal()
-    {
-        if (this->_score_array) {
-            ei_free((void *)this->_score_array);
-        }
-        if (this->_running_sum) {
-            ei_free((void *)this->_running_sum);
-        }
     }
 
     bool should_boost()
@@ -154,30 +125,17 @@ public:
         float current_top_score = 0.f;
         uint32_t current_top_index = 0;
 
-        /* Check pointers */
-        if (this->_score_array == NULL || this->_running_sum == NULL) {
+        /* Check the score window */
+        if (!this->_window_ready) {
             return EI_PC_RET_MEMORY_ERROR;
         }
 
-        /* Update the score array and running sum */
-        for (uint32_t i = 0; i < this->_n_labels; i++) {
-            this->_running_sum[i] -= this->_score_array[(this->_score_idx * this->_n_labels) + i];
-            this->_running_sum[i] += scores[i].value;
-            this->_score_array[(this->_score_idx * this->_n_labels) + i] = scores[i].value;
-        }
-
-        if (++this->_score_idx >= this->_average_window_duration_samples) {
-            this->_score_idx = 0;
-        }
-
-        /* Number of samples to average, increases until the buffer is full */
-        if (this->_n_scores_in_array < this->_average_window_duration_samples) {
-            this->_n_scores_in_array++;
-        }
+        /* Update the score window and running sum */
+        ei_classifier_score_window_push(&this->_window, scores);
 
         /* Average data and place in scores & determine top score */
         for (uint32_t i = 0; i < this->_n_labels; i++) {
-            scores[i].value = this->_running_sum[i] / this->_n_scores_in_array;
+            scores[i].value = ei_classifier_score_window_mean(&this->_window, i);
 
             if (scores[i].value > current_top_score) {
                 if(this->_suppression_flags == 0) {
@@ -228,10 +186,8 @@ private:
     uint32_t _suppression_count;
     uint32_t _suppression_flags;
     uint32_t _n_labels;
-    float *_score_array;
-    uint32_t _score_idx;
-    float *_running_sum;
-    uint32_t _n_scores_in_array;
+    bool _window_ready;
+    ei_classifier_score_window_t _window;
 };
 
 EI_IMPULSE_ERROR init_perfcal(ei_impulse_handle_t *handle, void **state, void *config)
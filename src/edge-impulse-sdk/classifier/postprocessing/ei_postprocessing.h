@@ -36,6 +36,8 @@
 #define EI_POSTPROCESSING_H
 
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#include "edge-impulse-sdk/dsp/memory.hpp"
 
 #if EI_CLASSIFIER_CALIBRATION_ENABLED
 #include "edge-impulse-sdk/classifier/postprocessing/ei_performance_calibration.h"
@@ -103,6 +105,23 @@ extern "C" EI_IMPULSE_ERROR deinit_postprocessing(ei_impulse_handle_t *handle) {
     return EI_IMPULSE_OK;
 }
 
+/**
+ * Free the raw output matrices the learning blocks attached to the result.
+ * Done by run_postprocessing, call this when bailing out before it runs.
+ */
+__attribute__((unused)) static void free_raw_outputs(ei_impulse_handle_t *handle,
+                                                     ei_impulse_result_t *result) {
+    if (!handle || !result->_raw_outputs) {
+        return;
+    }
+    for (size_t ix = 0; ix < handle->impulse->output_tensors_size; ix++) {
+        if (result->_raw_outputs[ix].matrix) {
+            delete result->_raw_outputs[ix].matrix;
+            result->_raw_outputs[ix].matrix = nullptr;
+        }
+    }
+}
+
 extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
                                                ei_impulse_result_t *result) {
     auto start_us = ei_read_timer_us();
@@ -110,6 +129,9 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
     if (!handle) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
+
+    EI_PROFILE_SCOPE("postprocessing");
+    EI_ALLOC_TAG_SCOPE(EI_ALLOC_TAG_POSTPROCESSING);
     auto impulse = handle->impulse;
 
     for (size_t ix = 0; ix < impulse->postprocessing_blocks_size; ix++) {
@@ -125,18 +147,14 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
                                                                                 impulse->postprocessing_blocks[ix].config,
                                                                                 state);
         if (res != EI_IMPULSE_OK) {
+            free_raw_outputs(handle, result);
             result->timing.postprocessing_us = ei_read_timer_us() - start_us;
             return res;
         }
     }
 
     // free raw results
-    for (size_t ix = 0; ix < impulse->output_tensors_size; ix++) {
-        if (result->_raw_outputs[ix].matrix) {
-            delete result->_raw_outputs[ix].matrix;
-            result->_raw_outputs[ix].matrix = nullptr;
-        }
-    }
+    free_raw_outputs(handle, result);
 
     result->timing.postprocessing_us = ei_read_timer_us() - start_us;
 
@@ -41,6 +41,7 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/classifier/ei_nms.h"
+#include "edge-impulse-sdk/classifier/ei_quantize.h"
 #include "edge-impulse-sdk/dsp/ei_vector.h"
 #include <string>
 
@@ -367,10 +368,8 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_freeform_i8(ei_impulse_h
             return EI_IMPULSE_FREEFORM_OUTPUT_SIZE_MISMATCH;
         }
 
-        for (uint32_t ix = 0; ix < freeform_output.rows * freeform_output.cols; ix++) {
-            float value = static_cast<float>(raw_output_mtx->buffer[ix] - config->zero_point) * config->scale;
-            freeform_output.buffer[ix] = value;
-        }
+        ei_dequantize_block(raw_output_mtx->buffer, freeform_output.buffer,
+            freeform_output.rows * freeform_output.cols, config->scale, config->zero_point);
     }
 
     return EI_IMPULSE_OK;
@@ -408,10 +407,8 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_freeform_u8(ei_impulse_h
             return EI_IMPULSE_FREEFORM_OUTPUT_SIZE_MISMATCH;
         }
 
-        for (uint32_t ix = 0; ix < freeform_output.rows * freeform_output.cols; ix++) {
-            float value = static_cast<float>(raw_output_mtx->buffer[ix] - config->zero_point) * config->scale;
-            freeform_output.buffer[ix] = value;
-        }
+        ei_dequantize_block(raw_output_mtx->buffer, freeform_output.buffer,
+            freeform_output.rows * freeform_output.cols, config->scale, config->zero_point);
     }
 
     return EI_IMPULSE_OK;
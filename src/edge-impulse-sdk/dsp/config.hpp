@@ -100,12 +100,48 @@
 #define EIDSP_TRACK_ALLOCATIONS      0
 #endif // EIDSP_TRACK_ALLOCATIONS
 
+// live blocks the allocation tracker can hold (as a power of two), the table
+// is a static array of (1 << bits) entries and is only kept at most 3/4 full
+#ifndef EIDSP_TRACK_ALLOCATIONS_TABLE_BITS
+#define EIDSP_TRACK_ALLOCATIONS_TABLE_BITS  9
+#endif // EIDSP_TRACK_ALLOCATIONS_TABLE_BITS
+
 // set EIDSP_TRACK_ALLOCATIONS=1 and EIDSP_PRINT_ALLOCATIONS=0
 // to track but not print allocations
 #ifndef EIDSP_PRINT_ALLOCATIONS
 #define EIDSP_PRINT_ALLOCATIONS      1
 #endif
 
+// serve DSP scratch memory from an impulse-level arena that is shared with
+// the NN tensor arena (see ei::scratch_arena in memory.hpp)
+#ifndef EIDSP_SCRATCH_ARENA
+#define EIDSP_SCRATCH_ARENA          0
+#endif // EIDSP_SCRATCH_ARENA
+
+// largest truncated DCT basis (inputs x kept coefficients) that is precomputed,
+// bigger transforms go through the FFT-based dct2
+#ifndef EIDSP_DCT_MAX_BASIS_ELEMENTS
+#define EIDSP_DCT_MAX_BASIS_ELEMENTS 4096
+#endif // EIDSP_DCT_MAX_BASIS_ELEMENTS
+
+// number of truncated DCT bases that are kept (one per MFCC config)
+#ifndef EIDSP_DCT_PLAN_CACHE_SIZE
+#define EIDSP_DCT_PLAN_CACHE_SIZE    2
+#endif // EIDSP_DCT_PLAN_CACHE_SIZE
+
+// audio signals up to this many samples are read once into an int16 working buffer
+// (2 bytes per sample), longer signals are read per frame. The default covers a
+// continuous inferencing slice (250 ms at 16 kHz), not a full window.
+#ifndef EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES
+#define EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES   4000
+#endif // EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES
+
+// run Butterworth sections in single precision transposed direct form II,
+// faster but not bit identical to the reference (direct form II) filter
+#ifndef EIDSP_BUTTERWORTH_TDF2
+#define EIDSP_BUTTERWORTH_TDF2       0
+#endif // EIDSP_BUTTERWORTH_TDF2
+
 #ifndef EIDSP_SIGNAL_C_FN_POINTER
 #define EIDSP_SIGNAL_C_FN_POINTER    0
 #endif // EIDSP_SIGNAL_C_FN_POINTER
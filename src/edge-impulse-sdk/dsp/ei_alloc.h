@@ -33,10 +33,6 @@
 
 #include "memory.hpp"
 
-#if EIDSP_TRACK_ALLOCATIONS
-#include <map>
-#endif
-
 namespace ei {
 
 template <class T>
@@ -51,31 +47,15 @@ struct EiAlloc
     {
         auto bytes = n * sizeof(T);
         auto ptr = ei_dsp_malloc(bytes);
-#if EIDSP_TRACK_ALLOCATIONS
-        get_allocs()[ptr] = bytes;
-#endif
         return (T *)ptr;
     }
 
+    // n is the count passed to allocate(), so the size of the block is known
+    // here and the tracker does not need a side table of its own
     void deallocate(T *p, size_t n) noexcept
     {
-#if EIDSP_TRACK_ALLOCATIONS
-        auto size_p = get_allocs().find(p);
-        ei_dsp_free(p,size_p->second);
-        get_allocs().erase(size_p);
-#else
-        ei_dsp_free(p,0);
-#endif
-    }
-#if EIDSP_TRACK_ALLOCATIONS
-    private:
-    // [address] -> size requested
-    typedef std::map<void*,size_t> map_t;
-    static map_t& get_allocs() {
-        static map_t allocs;
-        return allocs;
+        ei_dsp_free(p, n * sizeof(T));
     }
-#endif
 };
 
 template <class T, class U>
@@ -32,7 +32,54 @@
 #define __EIPROFILER__H__
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
 
+/**
+ * Zone profiler. EI_PROFILE_SCOPE("name") times the rest of the enclosing block in a
+ * static zone (count, total, min and max), zones entered inside it become its children.
+ * A zone keeps one path per parent it ran under, so the tree attributes every entry.
+ * Nothing is allocated and nothing is printed while measuring: ei::profiler::report()
+ * prints the flat or tree form afterwards. The nesting is tracked per thread, the
+ * statistics of a zone are not locked: time a zone from one thread at a time.
+ * With EI_PROFILER=0 the macros expand to nothing.
+ */
+#ifndef EI_PROFILER
+#define EI_PROFILER                         0
+#endif // EI_PROFILER
+
+// Count core cycles (DWT CYCCNT) instead of ei_read_timer_us(), Armv7-M / Armv8-M mainline only
+#ifndef EI_PROFILER_USE_CYCLE_COUNTER
+#define EI_PROFILER_USE_CYCLE_COUNTER       0
+#endif // EI_PROFILER_USE_CYCLE_COUNTER
+
+// Core clock in MHz to report cycles as us, 0 reports raw cycles
+#ifndef EI_PROFILER_CYCLES_PER_US
+#define EI_PROFILER_CYCLES_PER_US           0
+#endif // EI_PROFILER_CYCLES_PER_US
+
+// Parents a zone is attributed under in the tree, entries under more are only in the flat report
+#ifndef EI_PROFILER_MAX_PARENTS
+#define EI_PROFILER_MAX_PARENTS             4
+#endif // EI_PROFILER_MAX_PARENTS
+
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+#define EI_PROFILER_THREAD_LOCAL            thread_local
+#else
+#define EI_PROFILER_THREAD_LOCAL
+#endif
+
+#if EI_PROFILER_USE_CYCLE_COUNTER == 1 && !(defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__))
+#undef EI_PROFILER_USE_CYCLE_COUNTER
+#define EI_PROFILER_USE_CYCLE_COUNTER       0
+#endif
+
+/**
+ * Millisecond stopwatch that prints on every report() call, kept for existing callers.
+ * Use the zones below to time anything shorter than a few ms.
+ */
 class EiProfiler {
 public:
     EiProfiler()
@@ -53,4 +100,326 @@ private:
     uint64_t timestamp;
 };
 
+namespace ei {
+namespace profiler {
+
+typedef uint32_t ticks_t;
+
+#if EI_PROFILER_USE_CYCLE_COUNTER == 1
+inline void start_ticks(void)
+{
+    *(volatile uint32_t *)0xE000EDFCu |= (1u << 24);    // DEMCR.TRCENA
+    *(volatile uint32_t *)0xE0001FB0u = 0xC5ACCE55u;    // DWT.LAR unlock (Cortex-M7)
+    *(volatile uint32_t *)0xE0001000u |= 1u;            // DWT.CTRL.CYCCNTENA
+}
+
+inline ticks_t read_ticks(void)
+{
+    return *(volatile uint32_t *)0xE0001004u;           // DWT.CYCCNT
+}
+#else
+inline void start_ticks(void) { }
+
+inline ticks_t read_ticks(void)
+{
+    return (ticks_t)ei_read_timer_us();
+}
+#endif // EI_PROFILER_USE_CYCLE_COUNTER == 1
+
+class zone;
+
+typedef struct zone_stats {
+    uint32_t count = 0;
+    uint64_t total = 0;
+    ticks_t min = 0;
+    ticks_t max = 0;
+
+    inline void add(ticks_t ticks)
+    {
+        if (count == 0 || ticks < min) {
+            min = ticks;
+        }
+        if (ticks > max) {
+            max = ticks;
+        }
+        count++;
+        total += ticks;
+    }
+} stats_t;
+
+// a zone under one parent path, the paths of all zones form the call tree
+typedef struct zone_path {
+    const zone *owner = nullptr;
+    const zone_path *parent = nullptr; // nullptr at the top level
+    stats_t stats;
+} path_t;
+
+typedef struct {
+    zone *head;
+    zone *tail;
+} registry_t;
+
+// one registry for all translation units (inline function, constant initialized)
+inline registry_t &registry(void)
+{
+    static registry_t r;
+    return r;
+}
+
+// innermost path being timed, per thread where the toolchain has thread local storage
+// (bare metal targets run the inference in one thread)
+inline const path_t *&current_path(void)
+{
+    static EI_PROFILER_THREAD_LOCAL const path_t *current = nullptr;
+    return current;
+}
+
+// stands for the path of an entry that found no free path slot, its children have none either
+inline const path_t *unattributed_path(void)
+{
+    static const path_t p;
+    return &p;
+}
+
+class zone {
+public:
+    zone() { }
+
+    explicit zone(const char *name, int16_t index = -1)
+    {
+        init(name, index);
+    }
+
+    void init(const char *name, int16_t index)
+    {
+        registry_t &r = registry();
+        if (r.head == nullptr) {
+            start_ticks();
+            r.head = this;
+        }
+        else {
+            r.tail->next = this;
+        }
+        r.tail = this;
+        this->name = name;
+        this->index = index;
+    }
+
+    /**
+     * @brief      The path of this zone under parent, added on the first entry
+     *
+     * @return     nullptr when all EI_PROFILER_MAX_PARENTS slots hold other parents
+     */
+    path_t *path_under(const path_t *parent)
+    {
+        if (parent == unattributed_path()) {
+            return nullptr;
+        }
+        for (uint8_t ix = 0; ix < paths_size; ix++) {
+            if (paths[ix].parent == parent) {
+                return &paths[ix];
+            }
+        }
+        if (paths_size == EI_PROFILER_MAX_PARENTS) {
+            return nullptr;
+        }
+        path_t *p = &paths[paths_size++];
+        p->owner = this;
+        p->parent = parent;
+        return p;
+    }
+
+    void reset(void)
+    {
+        stats = stats_t();
+        paths_size = 0;
+        unattributed = 0;
+    }
+
+    const char *name = nullptr;
+    int16_t index = -1;             // position in a zone_array, -1 otherwise
+    zone *next = nullptr;
+    stats_t stats;                  // all entries, whatever the parent
+    path_t paths[EI_PROFILER_MAX_PARENTS];
+    uint8_t paths_size = 0;
+    uint32_t unattributed = 0;      // entries without a path (not in the tree)
+};
+
+/**
+ * Zones for the iterations of a loop (e.g. the nodes of a graph), reported as name[ix]
+ */
+template<size_t N>
+class zone_array {
+public:
+    explicit zone_array(const char *name)
+    {
+        for (size_t ix = 0; ix < N; ix++) {
+            zones[ix].init(name, (int16_t)ix);
+        }
+    }
+
+    zone &operator[](size_t ix)
+    {
+        return zones[ix < N ? ix : N - 1];
+    }
+
+private:
+    zone zones[N];
+};
+
+class scope {
+public:
+    explicit scope(zone &z) : zone_(z)
+    {
+        const path_t *&current = current_path();
+        parent_ = current;
+        path_ = z.path_under(parent_);
+        current = path_ != nullptr ? path_ : unattributed_path();
+        start_ = read_ticks();
+    }
+
+    ~scope()
+    {
+        ticks_t ticks = read_ticks() - start_;
+        zone_.stats.add(ticks);
+        if (path_ != nullptr) {
+            path_->stats.add(ticks);
+        }
+        else {
+            zone_.unattributed++;
+        }
+        current_path() = parent_;
+    }
+
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+
+private:
+    zone &zone_;
+    path_t *path_;
+    const path_t *parent_;
+    ticks_t start_;
+};
+
+inline uint64_t ticks_to_report_units(uint64_t ticks)
+{
+#if EI_PROFILER_USE_CYCLE_COUNTER == 1 && EI_PROFILER_CYCLES_PER_US > 0
+    return ticks / EI_PROFILER_CYCLES_PER_US;
+#else
+    return ticks;
+#endif
+}
+
+inline const char *report_units(void)
+{
+#if EI_PROFILER_USE_CYCLE_COUNTER == 1 && EI_PROFILER_CYCLES_PER_US == 0
+    return "cycles";
+#else
+    return "us";
+#endif
+}
+
+inline void print_zone(const zone *z, const stats_t &stats, unsigned int depth, uint64_t self)
+{
+    char label[48];
+    int n = snprintf(label, sizeof(label), "%*s%s", (int)(depth * 2), "", z->name);
+    if (z->index >= 0 && n > 0 && (size_t)n < sizeof(label)) {
+        snprintf(label + n, sizeof(label) - n, "[%d]", (int)z->index);
+    }
+
+    ei_printf("%-32s %8lu %10lu %8lu %8lu %8lu %10lu\n", label,
+        (unsigned long)stats.count,
+        (unsigned long)ticks_to_report_units(stats.total),
+        (unsigned long)ticks_to_report_units(stats.count > 0 ? stats.total / stats.count : 0),
+        (unsigned long)ticks_to_report_units(stats.min),
+        (unsigned long)ticks_to_report_units(stats.max),
+        (unsigned long)ticks_to_report_units(self));
+}
+
+inline void print_tree(const path_t *parent, unsigned int depth)
+{
+    for (const zone *z = registry().head; z != nullptr; z = z->next) {
+        for (uint8_t ix = 0; ix < z->paths_size; ix++) {
+            const path_t *p = &z->paths[ix];
+            if (p->parent != parent || p->stats.count == 0) {
+                continue;
+            }
+
+            uint64_t children = 0;
+            for (const zone *c = registry().head; c != nullptr; c = c->next) {
+                for (uint8_t jx = 0; jx < c->paths_size; jx++) {
+                    if (c->paths[jx].parent == p) {
+                        children += c->paths[jx].stats.total;
+                    }
+                }
+            }
+
+            print_zone(z, p->stats, depth, p->stats.total > children ? p->stats.total - children : 0);
+            print_tree(p, depth + 1);
+        }
+    }
+}
+
+/**
+ * @brief      Print all zones that ran
+ *
+ * @param[in]  tree  Nest zones under each parent they ran in, with the time not spent in
+ *                   children ("self"); otherwise one line per zone in registration order
+ */
+inline void report(bool tree = true)
+{
+    ei_printf("%-32s %8s %10s %8s %8s %8s %10s (%s)\n",
+        "zone", "count", "total", "avg", "min", "max", "self", report_units());
+
+    if (!tree) {
+        for (const zone *z = registry().head; z != nullptr; z = z->next) {
+            if (z->stats.count > 0) {
+                print_zone(z, z->stats, 0, z->stats.total);
+            }
+        }
+        return;
+    }
+
+    print_tree(nullptr, 0);
+
+    unsigned long unattributed = 0;
+    for (const zone *z = registry().head; z != nullptr; z = z->next) {
+        unattributed += z->unattributed;
+    }
+    if (unattributed > 0) {
+        ei_printf("%lu entries under more than %d parents are only in the flat report\n",
+            unattributed, (int)EI_PROFILER_MAX_PARENTS);
+    }
+}
+
+/**
+ * @brief      Clear the statistics of all zones (call while no zone is being timed)
+ */
+inline void reset(void)
+{
+    for (zone *z = registry().head; z != nullptr; z = z->next) {
+        z->reset();
+    }
+}
+
+} // namespace profiler
+} // namespace ei
+
+#if EI_PROFILER == 1
+#define EI_PROFILER_CONCAT_(a, b)           a##b
+#define EI_PROFILER_CONCAT(a, b)            EI_PROFILER_CONCAT_(a, b)
+// time the rest of the enclosing block in a static zone named name
+#define EI_PROFILE_SCOPE(name) \
+    static ei::profiler::zone EI_PROFILER_CONCAT(_ei_profile_zone_, __LINE__)(name); \
+    ei::profiler::scope EI_PROFILER_CONCAT(_ei_profile_scope_, __LINE__)(EI_PROFILER_CONCAT(_ei_profile_zone_, __LINE__))
+// declare size zones reported as name[ix], time with EI_PROFILE_SCOPE_ZONE(var[ix])
+#define EI_PROFILE_ZONES(var, name, size)   static ei::profiler::zone_array<size> var(name)
+#define EI_PROFILE_SCOPE_ZONE(z) \
+    ei::profiler::scope EI_PROFILER_CONCAT(_ei_profile_scope_, __LINE__)(z)
+#else
+#define EI_PROFILE_SCOPE(name)
+#define EI_PROFILE_ZONES(var, name, size)
+#define EI_PROFILE_SCOPE_ZONE(z)
+#endif // EI_PROFILER == 1
+
 #endif  //!__EIPROFILER__H__
@@ -29,6 +29,389 @@
  * permissions, disclaimers and limitations under the License.
  */
 #include "memory.hpp"
+#include "returntypes.hpp"
 
 size_t ei_memory_in_use = 0;
 size_t ei_memory_peak_use = 0;
+
+namespace ei {
+
+#define EI_SCRATCH_ARENA_ALIGN          8
+#define EI_SCRATCH_ARENA_NO_BLOCK       SIZE_MAX
+
+// header in front of every block handed out to DSP
+typedef struct {
+    uint32_t prev; // offset of the previous block header (or UINT32_MAX)
+    uint32_t size; // payload size
+} scratch_arena_block_t;
+
+static uint8_t *scratch_arena_buffer = NULL;
+static size_t scratch_arena_size = 0;
+static size_t scratch_arena_top = 0;
+static size_t scratch_arena_last = EI_SCRATCH_ARENA_NO_BLOCK;
+static int scratch_arena_scopes = 0;
+static bool scratch_arena_claimed = false;
+static size_t scratch_arena_dsp_peak = 0;
+static size_t scratch_arena_nn_peak = 0;
+
+static inline scratch_arena_block_t *scratch_arena_block(size_t offset) {
+    return (scratch_arena_block_t*)(scratch_arena_buffer + offset);
+}
+
+int scratch_arena::attach(void *buffer, size_t size) {
+    if (scratch_arena_buffer || !buffer || ((uintptr_t)buffer & 15) != 0) {
+        return EIDSP_PARAMETER_INVALID;
+    }
+    scratch_arena_buffer = (uint8_t*)buffer;
+    scratch_arena_size = size;
+    scratch_arena_top = 0;
+    scratch_arena_last = EI_SCRATCH_ARENA_NO_BLOCK;
+    scratch_arena_scopes = 0;
+    scratch_arena_claimed = false;
+    return EIDSP_OK;
+}
+
+void *scratch_arena::detach() {
+    if (scratch_arena_top != 0 || scratch_arena_claimed) {
+        return NULL;
+    }
+    void *buffer = scratch_arena_buffer;
+    scratch_arena_buffer = NULL;
+    scratch_arena_size = 0;
+    return buffer;
+}
+
+bool scratch_arena::is_attached() {
+    return scratch_arena_buffer != NULL;
+}
+
+scratch_arena::mark_t scratch_arena::mark() {
+    scratch_arena_scopes++;
+    return scratch_arena_top;
+}
+
+void scratch_arena::release(scratch_arena::mark_t mark) {
+    if (scratch_arena_scopes > 0) {
+        scratch_arena_scopes--;
+    }
+    if (mark >= scratch_arena_top) {
+        return;
+    }
+    // headers below the mark are intact, so walk back to the last block below it
+    while (scratch_arena_last != EI_SCRATCH_ARENA_NO_BLOCK && scratch_arena_last >= mark) {
+        uint32_t prev = scratch_arena_block(scratch_arena_last)->prev;
+        scratch_arena_last = prev == UINT32_MAX ? EI_SCRATCH_ARENA_NO_BLOCK : prev;
+    }
+    scratch_arena_top = mark;
+}
+
+void *scratch_arena::alloc(size_t size) {
+    if (!scratch_arena_buffer || scratch_arena_scopes == 0 || scratch_arena_claimed || size == 0) {
+        return NULL;
+    }
+
+    size_t available = scratch_arena_size - scratch_arena_top;
+    if (available < sizeof(scratch_arena_block_t) || size > available - sizeof(scratch_arena_block_t)) {
+        return NULL;
+    }
+    size_t payload = (size + (EI_SCRATCH_ARENA_ALIGN - 1)) & ~(size_t)(EI_SCRATCH_ARENA_ALIGN - 1);
+    if (payload > available - sizeof(scratch_arena_block_t)) {
+        return NULL;
+    }
+
+    scratch_arena_block_t *block = scratch_arena_block(scratch_arena_top);
+    block->prev = scratch_arena_last == EI_SCRATCH_ARENA_NO_BLOCK ? UINT32_MAX : (uint32_t)scratch_arena_last;
+    block->size = (uint32_t)payload;
+
+    scratch_arena_last = scratch_arena_top;
+    scratch_arena_top += sizeof(scratch_arena_block_t) + payload;
+    if (scratch_arena_top > scratch_arena_dsp_peak) {
+        scratch_arena_dsp_peak = scratch_arena_top;
+    }
+
+    return (void*)(block + 1);
+}
+
+bool scratch_arena::owns(const void *ptr) {
+    return scratch_arena_buffer &&
+        (const uint8_t*)ptr >= scratch_arena_buffer &&
+        (const uint8_t*)ptr < scratch_arena_buffer + scratch_arena_size;
+}
+
+bool scratch_arena::dealloc(void *ptr) {
+    if (!ptr || scratch_arena_claimed || scratch_arena_last == EI_SCRATCH_ARENA_NO_BLOCK) {
+        return false;
+    }
+
+    // only the top block can be popped, anything else stays until release()
+    scratch_arena_block_t *top = scratch_arena_block(scratch_arena_last);
+    if (ptr != (void*)(top + 1)) {
+        return false;
+    }
+
+    scratch_arena_top = scratch_arena_last;
+    scratch_arena_last = top->prev == UINT32_MAX ? EI_SCRATCH_ARENA_NO_BLOCK : top->prev;
+    return true;
+}
+
+void *scratch_arena::claim(size_t size) {
+    if (!scratch_arena_buffer || scratch_arena_claimed || scratch_arena_top != 0 || size > scratch_arena_size) {
+        return NULL;
+    }
+    scratch_arena_claimed = true;
+    if (size > scratch_arena_nn_peak) {
+        scratch_arena_nn_peak = size;
+    }
+    memset(scratch_arena_buffer, 0, size);
+    return scratch_arena_buffer;
+}
+
+bool scratch_arena::unclaim(void *ptr) {
+    if (!scratch_arena_claimed || ptr != scratch_arena_buffer) {
+        return false;
+    }
+    scratch_arena_claimed = false;
+    return true;
+}
+
+size_t scratch_arena::get_size() {
+    return scratch_arena_size;
+}
+
+size_t scratch_arena::get_in_use() {
+    return scratch_arena_top;
+}
+
+size_t scratch_arena::get_dsp_peak_use() {
+    return scratch_arena_dsp_peak;
+}
+
+size_t scratch_arena::get_nn_peak_use() {
+    return scratch_arena_nn_peak;
+}
+
+size_t scratch_arena::get_peak_use() {
+    return scratch_arena_dsp_peak > scratch_arena_nn_peak ? scratch_arena_dsp_peak : scratch_arena_nn_peak;
+}
+
+void scratch_arena::reset_peak_use() {
+    scratch_arena_dsp_peak = scratch_arena_top;
+    scratch_arena_nn_peak = 0;
+}
+
+} // namespace ei
+
+#if EIDSP_TRACK_ALLOCATIONS
+namespace ei {
+
+#define EI_ALLOC_TRACKER_SIZE           (1UL << EIDSP_TRACK_ALLOCATIONS_TABLE_BITS)
+#define EI_ALLOC_TRACKER_MASK           (EI_ALLOC_TRACKER_SIZE - 1)
+#define EI_ALLOC_TRACKER_MAX_LIVE       ((EI_ALLOC_TRACKER_SIZE * 3) / 4)
+
+// one live block, an empty slot has ptr == NULL
+typedef struct {
+    void *ptr;
+    const char *fn;
+    uint32_t size;
+    uint32_t serial;
+    uint8_t tag;
+} alloc_tracker_entry_t;
+
+static alloc_tracker_entry_t alloc_tracker_table[EI_ALLOC_TRACKER_SIZE];
+static size_t alloc_tracker_live = 0;
+static size_t alloc_tracker_dropped = 0;
+static uint32_t alloc_tracker_serial = 0;
+static ei_alloc_tag_t alloc_tracker_tag = EI_ALLOC_TAG_APP;
+static size_t alloc_tracker_in_use[EI_ALLOC_TAG_COUNT] = { 0 };
+static size_t alloc_tracker_peak[EI_ALLOC_TAG_COUNT] = { 0 };
+
+static const char *alloc_tracker_tag_names[EI_ALLOC_TAG_COUNT] = {
+    "app", "dsp", "nn", "postprocessing"
+};
+
+// Fibonacci hashing, the low bits of heap pointers are mostly alignment
+static inline size_t alloc_tracker_slot(const void *ptr) {
+    uint32_t key = (uint32_t)((uintptr_t)ptr >> 3);
+#if UINTPTR_MAX > 0xffffffffUL
+    key ^= (uint32_t)((uint64_t)(uintptr_t)ptr >> 32);
+#endif
+    return (size_t)((key * 2654435769UL) & 0xffffffffUL) >> (32 - EIDSP_TRACK_ALLOCATIONS_TABLE_BITS);
+}
+
+static inline void alloc_tracker_add(ei_alloc_tag_t tag, size_t size) {
+    alloc_tracker_in_use[tag] += size;
+    if (alloc_tracker_in_use[tag] > alloc_tracker_peak[tag]) {
+        alloc_tracker_peak[tag] = alloc_tracker_in_use[tag];
+    }
+    ei_memory_in_use += size;
+    if (ei_memory_in_use > ei_memory_peak_use) {
+        ei_memory_peak_use = ei_memory_in_use;
+    }
+}
+
+static inline void alloc_tracker_sub(ei_alloc_tag_t tag, size_t size) {
+    // an untracked block can be freed in another phase than it was allocated in
+    alloc_tracker_in_use[tag] -= (size < alloc_tracker_in_use[tag]) ? size : alloc_tracker_in_use[tag];
+    ei_memory_in_use -= size;
+}
+
+static void alloc_tracker_print_entry(const alloc_tracker_entry_t *e) {
+    ei_printf("  leak: %lu bytes at %p (%s, #%lu, %s)\n", (unsigned long)e->size, e->ptr,
+        alloc_tracker_tag_names[e->tag], (unsigned long)e->serial, e->fn ? e->fn : "?");
+}
+
+void alloc_tracker::insert(void *ptr, size_t size, const char *fn) {
+    if (!ptr) {
+        return;
+    }
+    alloc_tracker_add(alloc_tracker_tag, size);
+
+    if (alloc_tracker_live >= EI_ALLOC_TRACKER_MAX_LIVE) {
+        alloc_tracker_dropped++;
+        return;
+    }
+
+    size_t ix = alloc_tracker_slot(ptr);
+    while (alloc_tracker_table[ix].ptr && alloc_tracker_table[ix].ptr != ptr) {
+        ix = (ix + 1) & EI_ALLOC_TRACKER_MASK;
+    }
+    if (alloc_tracker_table[ix].ptr == ptr) {
+        // registered twice without a free in between, keep the accounting of the new block
+        alloc_tracker_sub((ei_alloc_tag_t)alloc_tracker_table[ix].tag, alloc_tracker_table[ix].size);
+        alloc_tracker_live--;
+    }
+
+    alloc_tracker_entry_t *e = &alloc_tracker_table[ix];
+    e->ptr = ptr;
+    e->fn = fn;
+    e->size = (uint32_t)size;
+    e->serial = ++alloc_tracker_serial;
+    e->tag = (uint8_t)alloc_tracker_tag;
+    alloc_tracker_live++;
+}
+
+size_t alloc_tracker::remove(void *ptr, size_t size) {
+    if (!ptr) {
+        return 0;
+    }
+
+    size_t ix = alloc_tracker_slot(ptr);
+    while (alloc_tracker_table[ix].ptr != ptr) {
+        if (!alloc_tracker_table[ix].ptr) {
+            alloc_tracker_sub(alloc_tracker_tag, size);
+            return size;
+        }
+        ix = (ix + 1) & EI_ALLOC_TRACKER_MASK;
+    }
+
+    size_t registered_size = alloc_tracker_table[ix].size;
+    alloc_tracker_sub((ei_alloc_tag_t)alloc_tracker_table[ix].tag, registered_size);
+    alloc_tracker_live--;
+
+    // backward shift deletion, keeps probe sequences intact without tombstones
+    size_t hole = ix;
+    size_t next = (hole + 1) & EI_ALLOC_TRACKER_MASK;
+    while (alloc_tracker_table[next].ptr) {
+        size_t home = alloc_tracker_slot(alloc_tracker_table[next].ptr);
+        // move the entry into the hole unless its home slot lies cyclically in (hole, next]
+        if (((next - home) & EI_ALLOC_TRACKER_MASK) >= ((next - hole) & EI_ALLOC_TRACKER_MASK)) {
+            alloc_tracker_table[hole] = alloc_tracker_table[next];
+            hole = next;
+        }
+        next = (next + 1) & EI_ALLOC_TRACKER_MASK;
+    }
+    alloc_tracker_table[hole].ptr = NULL;
+
+    return registered_size;
+}
+
+ei_alloc_tag_t alloc_tracker::set_tag(ei_alloc_tag_t tag) {
+    ei_alloc_tag_t prev = alloc_tracker_tag;
+    alloc_tracker_tag = tag;
+    return prev;
+}
+
+ei_alloc_tag_t alloc_tracker::get_tag() {
+    return alloc_tracker_tag;
+}
+
+const char *alloc_tracker::get_tag_name(ei_alloc_tag_t tag) {
+    return tag < EI_ALLOC_TAG_COUNT ? alloc_tracker_tag_names[tag] : "?";
+}
+
+size_t alloc_tracker::get_in_use(ei_alloc_tag_t tag) {
+    return tag < EI_ALLOC_TAG_COUNT ? alloc_tracker_in_use[tag] : 0;
+}
+
+size_t alloc_tracker::get_peak_use(ei_alloc_tag_t tag) {
+    return tag < EI_ALLOC_TAG_COUNT ? alloc_tracker_peak[tag] : 0;
+}
+
+void alloc_tracker::reset_peak_use() {
+    for (int tag = 0; tag < EI_ALLOC_TAG_COUNT; tag++) {
+        alloc_tracker_peak[tag] = alloc_tracker_in_use[tag];
+    }
+    ei_memory_peak_use = ei_memory_in_use;
+}
+
+size_t alloc_tracker::get_live_count() {
+    return alloc_tracker_live;
+}
+
+size_t alloc_tracker::get_dropped_count() {
+    return alloc_tracker_dropped;
+}
+
+alloc_tracker::mark_t alloc_tracker::mark() {
+    return alloc_tracker_serial;
+}
+
+size_t alloc_tracker::check_leaks(mark_t mark, bool print) {
+    size_t leaks = 0;
+    for (size_t ix = 0; ix < EI_ALLOC_TRACKER_SIZE; ix++) {
+        const alloc_tracker_entry_t *e = &alloc_tracker_table[ix];
+        // serials wrap, compare the distance from the mark
+        if (e->ptr && (uint32_t)(e->serial - mark - 1) < (uint32_t)(alloc_tracker_serial - mark)) {
+            if (print) {
+                alloc_tracker_print_entry(e);
+            }
+            leaks++;
+        }
+    }
+    return leaks;
+}
+
+size_t alloc_tracker::report_leaks() {
+    ei_printf("Tracked DSP memory (in use / peak, bytes):\n");
+    for (int tag = 0; tag < EI_ALLOC_TAG_COUNT; tag++) {
+        ei_printf("  %-16s %8lu / %8lu\n", alloc_tracker_tag_names[tag],
+            (unsigned long)alloc_tracker_in_use[tag], (unsigned long)alloc_tracker_peak[tag]);
+    }
+    ei_printf("  %-16s %8lu / %8lu\n", "total",
+        (unsigned long)ei_memory_in_use, (unsigned long)ei_memory_peak_use);
+
+    size_t leaks = 0;
+    size_t app_blocks = 0;
+    for (size_t ix = 0; ix < EI_ALLOC_TRACKER_SIZE; ix++) {
+        const alloc_tracker_entry_t *e = &alloc_tracker_table[ix];
+        if (!e->ptr) {
+            continue;
+        }
+        if (e->tag == EI_ALLOC_TAG_APP) {
+            app_blocks++;
+            continue;
+        }
+        alloc_tracker_print_entry(e);
+        leaks++;
+    }
+    ei_printf("%lu leaked block(s), %lu block(s) held by the application",
+        (unsigned long)leaks, (unsigned long)app_blocks);
+    if (alloc_tracker_dropped > 0) {
+        ei_printf(", %lu block(s) not tracked (table full)", (unsigned long)alloc_tracker_dropped);
+    }
+    ei_printf("\n");
+    return leaks;
+}
+
+} // namespace ei
+#endif // EIDSP_TRACK_ALLOCATIONS
@@ -34,6 +34,7 @@
 // clang-format off
 #include <functional>
 #include <stdio.h>
+#include <string.h>
 #include <memory>
 #include "../porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
@@ -42,6 +43,15 @@
 extern size_t ei_memory_in_use;
 extern size_t ei_memory_peak_use;
 
+// phase of the impulse an allocation was made in, see ei::alloc_tracker
+typedef enum {
+    EI_ALLOC_TAG_APP = 0,
+    EI_ALLOC_TAG_DSP,
+    EI_ALLOC_TAG_NN,
+    EI_ALLOC_TAG_POSTPROCESSING,
+    EI_ALLOC_TAG_COUNT
+} ei_alloc_tag_t;
+
 #if EIDSP_PRINT_ALLOCATIONS == 1
 #define ei_dsp_printf           printf
 #else
@@ -64,11 +74,276 @@ typedef std::unique_ptr<void, std::function<void(void*)>> ei_unique_ptr_t;
 
 namespace ei {
 
+/**
+ * Impulse-level scratch arena, shared between DSP extraction and NN inference.
+ *
+ * DSP scratch (preemphasis buffers, FFT buffers, intermediate matrices) is dead
+ * by the time the NN runs, and the non-persistent part of the tensor arena is
+ * unused while DSP runs. When an arena is attached, allocations made through
+ * ei_dsp_malloc / ei_dsp_calloc (and DSP matrices) inside an open scope are
+ * handed out from the arena with stack-like mark/release semantics. After all
+ * scopes are released the NN can claim the same region as its tensor arena.
+ * Requests that do not fit fall back to the heap.
+ *
+ * Enable through the EIDSP_SCRATCH_ARENA macro.
+ */
+class scratch_arena {
+public:
+    typedef size_t mark_t;
+
+    /**
+     * Attach a buffer to use as arena. Must be at least 16-byte aligned.
+     * @param buffer Backing memory
+     * @param size Size of the backing memory, in bytes
+     * @returns EIDSP_OK if successful
+     */
+    static int attach(void *buffer, size_t size);
+
+    /**
+     * Detach the backing buffer, fails if memory is still handed out.
+     * @returns The buffer that was attached (so the caller can free it), or NULL
+     */
+    static void *detach();
+
+    static bool is_attached();
+
+    /**
+     * Open a scope, allocations made by the DSP code after this call are
+     * served from the arena until `release()` is called with the returned mark.
+     */
+    static mark_t mark();
+
+    /**
+     * Release everything allocated since `mark` and close the scope.
+     */
+    static void release(mark_t mark);
+
+    /**
+     * Allocate from the top of the arena (only inside an open scope).
+     * @returns Pointer (8-byte aligned) or NULL if the request does not fit
+     */
+    static void *alloc(size_t size);
+
+    /**
+     * Pop the top block. Any other pointer is rejected and left alone, its
+     * memory comes back when the scope is released.
+     * @returns true if `ptr` was the top block and has been popped
+     */
+    static bool dealloc(void *ptr);
+
+    static bool owns(const void *ptr);
+
+    /**
+     * Claim the whole arena for the NN. Only succeeds if no DSP scratch is alive.
+     * @returns The (zeroed) arena or NULL if it cannot be used
+     */
+    static void *claim(size_t size);
+
+    /**
+     * Give back an arena obtained through `claim()`.
+     * @returns true if the pointer was the claimed arena
+     */
+    static bool unclaim(void *ptr);
+
+    /**
+     * Size of the attached buffer, in bytes
+     */
+    static size_t get_size();
+
+    /**
+     * Bytes (incl. headers) currently handed out to DSP scratch
+     */
+    static size_t get_in_use();
+
+    /**
+     * Peak number of bytes (incl. headers) handed out to DSP scratch
+     */
+    static size_t get_dsp_peak_use();
+
+    /**
+     * Largest region claimed by the NN
+     */
+    static size_t get_nn_peak_use();
+
+    /**
+     * High-water mark of the arena, max(DSP scratch, NN tensor arena)
+     */
+    static size_t get_peak_use();
+
+    static void reset_peak_use();
+
+    /**
+     * DSP scratch allocation, served from the arena if possible, from the heap otherwise
+     */
+    static void *dsp_malloc(size_t size) {
+        void *ptr = alloc(size);
+        if (ptr) {
+            return ptr;
+        }
+        return ei_malloc(size);
+    }
+
+    static void *dsp_calloc(size_t num, size_t size) {
+        if (size != 0 && num > SIZE_MAX / size) {
+            return NULL;
+        }
+        void *ptr = alloc(num * size);
+        if (ptr) {
+            memset(ptr, 0, num * size);
+            return ptr;
+        }
+        return ei_calloc(num, size);
+    }
+
+    static void dsp_free(void *ptr) {
+        if (owns(ptr)) {
+            dealloc(ptr);
+            return;
+        }
+        ei_free(ptr);
+    }
+};
+
+/**
+ * RAII helper that opens an arena scope and releases it when going out of scope
+ */
+class scratch_arena_scope {
+public:
+    scratch_arena_scope() : _mark(scratch_arena::mark()) { }
+    ~scratch_arena_scope() { scratch_arena::release(_mark); }
+private:
+    scratch_arena_scope(const scratch_arena_scope&) = delete;
+    scratch_arena_scope& operator=(const scratch_arena_scope&) = delete;
+
+    scratch_arena::mark_t _mark;
+};
+
+#if EIDSP_TRACK_ALLOCATIONS
+/**
+ * Live allocation table used by EIDSP_TRACK_ALLOCATIONS.
+ *
+ * Every tracked block is kept in a fixed-capacity open-addressing table
+ * (pointer -> size, phase tag, allocation serial), so registering and freeing
+ * are O(1) and the tracker never allocates on the heap it is measuring.
+ * In-use bytes and peak watermarks are kept per phase (app, DSP, NN,
+ * postprocessing). Blocks that do not fit in the table are still counted
+ * but cannot be reported as leaks, see `get_dropped_count()`.
+ *
+ * Leak check, e.g. in a host test:
+ *
+ *     ei::alloc_tracker::mark_t mark = ei::alloc_tracker::mark();
+ *     process_impulse_continuous(...);
+ *     assert(ei::alloc_tracker::check_leaks(mark) == 0);
+ *
+ * The table holds (1 << EIDSP_TRACK_ALLOCATIONS_TABLE_BITS) entries.
+ */
+class alloc_tracker {
+public:
+    typedef uint32_t mark_t;
+
+    /**
+     * Register a block, tagged with the current phase.
+     * @param fn Name of the allocating function (must outlive the block), may be NULL
+     */
+    static void insert(void *ptr, size_t size, const char *fn = NULL);
+
+    /**
+     * Unregister a block. If the block is unknown (dropped, or never registered)
+     * `size` is taken off the current phase instead.
+     * @returns Size the block was registered with, or `size` if it was unknown
+     */
+    static size_t remove(void *ptr, size_t size);
+
+    /**
+     * Set the phase new allocations are tagged with
+     * @returns The previous phase
+     */
+    static ei_alloc_tag_t set_tag(ei_alloc_tag_t tag);
+
+    static ei_alloc_tag_t get_tag();
+
+    static const char *get_tag_name(ei_alloc_tag_t tag);
+
+    /**
+     * Bytes currently allocated in a phase
+     */
+    static size_t get_in_use(ei_alloc_tag_t tag);
+
+    /**
+     * Peak bytes allocated in a phase (only counting blocks of that phase)
+     */
+    static size_t get_peak_use(ei_alloc_tag_t tag);
+
+    /**
+     * Reset the per-phase watermarks (and ei_memory_peak_use) to the current use
+     */
+    static void reset_peak_use();
+
+    /**
+     * Number of blocks currently in the table
+     */
+    static size_t get_live_count();
+
+    /**
+     * Number of blocks that were not recorded because the table was full
+     */
+    static size_t get_dropped_count();
+
+    /**
+     * Start a leak check, blocks registered after this call are checked by `check_leaks()`
+     */
+    static mark_t mark();
+
+    /**
+     * Blocks registered after `mark` that are still alive
+     * @param print Print every leaked block
+     * @returns Number of leaked blocks
+     */
+    static size_t check_leaks(mark_t mark, bool print = true);
+
+    /**
+     * Print per-phase use and peaks and every block still alive that was
+     * allocated during DSP, NN or postprocessing (those should never outlive
+     * the impulse). Called from `run_classifier_deinit()`.
+     * @returns Number of leaked blocks
+     */
+    static size_t report_leaks();
+};
+
+/**
+ * RAII helper that tags allocations made in the enclosing block with a phase
+ */
+class alloc_tag_scope {
+public:
+    alloc_tag_scope(ei_alloc_tag_t tag) : _prev(alloc_tracker::set_tag(tag)) { }
+    ~alloc_tag_scope() { alloc_tracker::set_tag(_prev); }
+private:
+    alloc_tag_scope(const alloc_tag_scope&) = delete;
+    alloc_tag_scope& operator=(const alloc_tag_scope&) = delete;
+
+    ei_alloc_tag_t _prev;
+};
+
+#define EI_ALLOC_TAG_CONCAT_(a, b)          a##b
+#define EI_ALLOC_TAG_CONCAT(a, b)           EI_ALLOC_TAG_CONCAT_(a, b)
+// tag tracked allocations in the rest of the enclosing block with tag
+#define EI_ALLOC_TAG_SCOPE(tag) \
+    ei::alloc_tag_scope EI_ALLOC_TAG_CONCAT(_ei_alloc_tag_scope_, __LINE__)(tag)
+#else
+#define EI_ALLOC_TAG_SCOPE(tag)
+#endif // EIDSP_TRACK_ALLOCATIONS
+
 /**
  * These are macros used to track allocations when running DSP processes.
  * Enable memory tracking through the EIDSP_TRACK_ALLOCATIONS macro.
  */
 
+#if EIDSP_SCRATCH_ARENA
+    #define ei_dsp_arena_owns(ptr) ei::scratch_arena::owns(ptr)
+#else
+    #define ei_dsp_arena_owns(ptr) false
+#endif // EIDSP_SCRATCH_ARENA
+
 #if EIDSP_TRACK_ALLOCATIONS
     /**
      * Register a manual allocation (malloc or calloc).
@@ -76,10 +351,7 @@ namespace ei {
      * @param bytes Number of bytes allocated
      */
     #define ei_dsp_register_alloc_internal(fn, file, line, bytes, ptr) \
-        ei_memory_in_use += bytes; \
-        if (ei_memory_in_use > ei_memory_peak_use) { \
-            ei_memory_peak_use = ei_memory_in_use; \
-        } \
+        ei::alloc_tracker::insert(ptr, bytes, fn); \
         ei_dsp_printf("alloc %lu bytes (in_use=%lu, peak=%lu) (%s@ %s:%d) %p\n", \
             (unsigned long)bytes, (unsigned long)ei_memory_in_use, (unsigned long)ei_memory_peak_use, fn, file, line, ptr);
 
@@ -91,20 +363,19 @@ namespace ei {
      * @param type_size Size of the data type
      */
     #define ei_dsp_register_matrix_alloc_internal(fn, file, line, rows, cols, type_size, ptr) \
-        ei_memory_in_use += (rows * cols * type_size); \
-        if (ei_memory_in_use > ei_memory_peak_use) { \
-            ei_memory_peak_use = ei_memory_in_use; \
-        } \
+        if (!ei_dsp_arena_owns(ptr)) { \
+        ei::alloc_tracker::insert(ptr, (rows * cols * type_size), fn); \
         ei_dsp_printf("alloc matrix %lu x %lu = %lu bytes (in_use=%lu, peak=%lu) (%s@ %s:%d) %p\n", \
             (unsigned long)rows, (unsigned long)cols, (unsigned long)(rows * cols * type_size), (unsigned long)ei_memory_in_use, \
-                (unsigned long)ei_memory_peak_use, fn, file, line, ptr);
+                (unsigned long)ei_memory_peak_use, fn, file, line, ptr); \
+        }
 
     /**
      * Register free'ing manually allocated memory (allocated through malloc/calloc)
      * @param bytes Number of bytes free'd
      */
     #define ei_dsp_register_free_internal(fn, file, line, bytes, ptr) \
-        ei_memory_in_use -= bytes; \
+        ei::alloc_tracker::remove(ptr, bytes); \
         ei_dsp_printf("free %lu bytes (in_use=%lu, peak=%lu) (%s@ %s:%d) %p\n", \
             (unsigned long)bytes, (unsigned long)ei_memory_in_use, (unsigned long)ei_memory_peak_use, fn, file, line, ptr);
 
@@ -116,10 +387,12 @@ namespace ei {
      * @param type_size Size of the data type
      */
     #define ei_dsp_register_matrix_free_internal(fn, file, line, rows, cols, type_size, ptr) \
-        ei_memory_in_use -= (rows * cols * type_size); \
+        if (!ei_dsp_arena_owns(ptr)) { \
+        ei::alloc_tracker::remove(ptr, (rows * cols * type_size)); \
         ei_dsp_printf("free matrix %lu x %lu = %lu bytes (in_use=%lu, peak=%lu) (%s@ %s:%d) %p\n", \
             (unsigned long)rows, (unsigned long)cols, (unsigned long)(rows * cols * type_size), \
-                (unsigned long)ei_memory_in_use, (unsigned long)ei_memory_peak_use, fn, file, line, ptr);
+                (unsigned long)ei_memory_in_use, (unsigned long)ei_memory_peak_use, fn, file, line, ptr); \
+        }
 
     #define ei_dsp_register_alloc(...) ei_dsp_register_alloc_internal(__func__, __FILE__, __LINE__, __VA_ARGS__)
     #define ei_dsp_register_matrix_alloc(...) ei_dsp_register_matrix_alloc_internal(__func__, __FILE__, __LINE__, __VA_ARGS__)
@@ -138,9 +411,15 @@ namespace ei {
     #define ei_dsp_register_matrix_alloc(...) (void)0
     #define ei_dsp_register_free(...) (void)0
     #define ei_dsp_register_matrix_free(...) (void)0
+#if EIDSP_SCRATCH_ARENA
+    #define ei_dsp_malloc(size) ei::scratch_arena::dsp_malloc(size)
+    #define ei_dsp_calloc(num, size) ei::scratch_arena::dsp_calloc(num, size)
+    #define ei_dsp_free(ptr, size) ei::scratch_arena::dsp_free(ptr)
+#else
     #define ei_dsp_malloc ei_malloc
     #define ei_dsp_calloc ei_calloc
     #define ei_dsp_free(ptr, size) ei_free(ptr)
+#endif // EIDSP_SCRATCH_ARENA
     #define EI_DSP_MATRIX(name, ...) matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
     #define EI_DSP_MATRIX_B(name, ...) matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
     #define EI_DSP_QUANTIZED_MATRIX(name, ...) quantized_matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
@@ -157,6 +436,13 @@ public:
      * @param size The size of the memory block, in bytes.
      */
     static void *ei_wrapped_malloc(const char *fn, const char *file, int line, size_t size) {
+#if EIDSP_SCRATCH_ARENA
+        void *arena_ptr = scratch_arena::alloc(size);
+        if (arena_ptr) {
+            ei_dsp_printf("arena alloc %lu bytes (%s@ %s:%d) %p\n", (unsigned long)size, fn, file, line, arena_ptr);
+            return arena_ptr;
+        }
+#endif // EIDSP_SCRATCH_ARENA
         void *ptr = ei_malloc(size);
         if (ptr) {
             ei_dsp_register_alloc_internal(fn, file, line, size, ptr);
@@ -171,6 +457,17 @@ public:
      * @param size Size of each element
      */
     static void *ei_wrapped_calloc(const char *fn, const char *file, int line, size_t num, size_t size) {
+        if (size != 0 && num > SIZE_MAX / size) {
+            return NULL;
+        }
+#if EIDSP_SCRATCH_ARENA
+        void *arena_ptr = scratch_arena::alloc(num * size);
+        if (arena_ptr) {
+            memset(arena_ptr, 0, num * size);
+            ei_dsp_printf("arena alloc %lu bytes (%s@ %s:%d) %p\n", (unsigned long)(num * size), fn, file, line, arena_ptr);
+            return arena_ptr;
+        }
+#endif // EIDSP_SCRATCH_ARENA
         void *ptr = ei_calloc(num, size);
         if (ptr) {
             ei_dsp_register_alloc_internal(fn, file, line, num * size, ptr);
@@ -184,6 +481,16 @@ public:
      * @param size Size of the block of memory previously allocated.
      */
     static void ei_wrapped_free(const char *fn, const char *file, int line, void *ptr, size_t size) {
+#if EIDSP_SCRATCH_ARENA
+        if (scratch_arena::owns(ptr)) {
+            scratch_arena::dealloc(ptr);
+            ei_dsp_printf("arena free %lu bytes (%s@ %s:%d) %p\n", (unsigned long)size, fn, file, line, ptr);
+            return;
+        }
+#endif // EIDSP_SCRATCH_ARENA
+        if (!ptr) {
+            return;
+        }
         ei_free(ptr);
         ei_dsp_register_free_internal(fn, file, line, size, ptr);
     }
@@ -192,9 +499,10 @@ public:
 
 // This needs to be a real function so I can bind with a lambda
 __attribute__((unused)) static void ei_dsp_free_func(void *ptr, size_t size) {
-    ei_free(ptr);
 #if EIDSP_TRACK_ALLOCATIONS
-    ei_dsp_register_free_internal("unique_ptr free", "", 0, size, ptr);
+    memory::ei_wrapped_free("unique_ptr free", "", 0, ptr, size);
+#else
+    ei_dsp_free(ptr, size);
 #endif
 }
 
@@ -212,8 +520,7 @@ static ei_unique_ptr_t make_tracked_unique_ptr(void* ptr_in, size_t size) {
     auto ptr = reinterpret_cast<void**>(ptr_in);
     *ptr = ei_dsp_malloc(size);
     return ei_unique_ptr_t(*ptr, [size](void *ptr) {
-        ei_free(ptr);
-        ei_dsp_register_free_internal("unique_ptr", "", 0, size, ptr);
+        memory::ei_wrapped_free("unique_ptr", "", 0, ptr, size);
     });
 }
 #else
@@ -245,5 +552,31 @@ static ei_unique_ptr_t make_tracked_unique_ptr(void* ptr_in, size_t size)
 
 } // namespace ei
 
+/**
+ * Allocation functions that can be handed to the NN engines (e.g. EON `model_init`).
+ * These hand out the impulse scratch arena if it's attached, big enough and not in use
+ * by DSP; otherwise they fall back to ei_aligned_calloc / ei_aligned_free.
+ */
+__attribute__((unused)) static void *ei_scratch_arena_aligned_calloc(size_t align, size_t size) {
+#if EIDSP_SCRATCH_ARENA
+    if (align <= 16) {
+        void *ptr = ei::scratch_arena::claim(size);
+        if (ptr) {
+            return ptr;
+        }
+    }
+#endif // EIDSP_SCRATCH_ARENA
+    return ei_aligned_calloc(align, size);
+}
+
+__attribute__((unused)) static void ei_scratch_arena_aligned_free(void *ptr) {
+#if EIDSP_SCRATCH_ARENA
+    if (ei::scratch_arena::unclaim(ptr)) {
+        return;
+    }
+#endif // EIDSP_SCRATCH_ARENA
+    ei_aligned_free(ptr);
+}
+
 // clang-format on
 #endif // _EIDSP_MEMORY_H_
@@ -59,6 +59,7 @@
 #include "returntypes.hpp"
 #include "memory.hpp"
 #include "ei_utils.h"
+#include "ei_profiler.h"
 #include "kissfft/kiss_fftr.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 
@@ -621,6 +622,197 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Cosine basis for a DCT type 2 that only computes the first num_outputs
+     * coefficients, with the (2x and ortho) normalization folded in.
+     */
+    typedef struct {
+        size_t num_inputs;
+        size_t num_outputs;
+        DCT_NORMALIZATION_MODE normalization;
+        float *basis;           // [num_inputs][num_outputs], right-hand side of a matrix multiply
+        EIDSP_i16 *basis_q15;   // [num_outputs][num_inputs], built by get_dct2_plan_q15 only
+    } dct2_plan_t;
+
+    /**
+     * Get the cached basis for a truncated DCT type 2, building it on first use.
+     * The plans live on the heap until release_dct2_plans() (one per DSP config,
+     * see EIDSP_DCT_PLAN_CACHE_SIZE).
+     * @param num_inputs Number of input values per row (N)
+     * @param num_outputs Number of coefficients that are kept (K <= N)
+     * @param normalization Normalization mode
+     * @returns Plan, or nullptr if the basis is too large or does not fit in memory
+     */
+    static const dct2_plan_t *get_dct2_plan(size_t num_inputs, size_t num_outputs,
+        DCT_NORMALIZATION_MODE normalization)
+    {
+        return find_dct2_plan(num_inputs, num_outputs, normalization);
+    }
+
+    /**
+     * Same as get_dct2_plan() with DCT_NORMALIZATION_ORTHO, and the Q15 basis built
+     * on first use (the float basis of the plan is kept for dct2_truncated)
+     * @returns Plan with basis_q15 set, or nullptr if it does not fit in memory
+     */
+    static const dct2_plan_t *get_dct2_plan_q15(size_t num_inputs, size_t num_outputs)
+    {
+        dct2_plan_t *plan = find_dct2_plan(num_inputs, num_outputs, DCT_NORMALIZATION_ORTHO);
+        if (!plan) {
+            return nullptr;
+        }
+        if (!plan->basis_q15) {
+            plan->basis_q15 = (EIDSP_i16*)ei_malloc(num_inputs * num_outputs * sizeof(EIDSP_i16));
+            if (!plan->basis_q15) {
+                return nullptr;
+            }
+            for (size_t k = 0; k < num_outputs; k++) {
+                for (size_t n = 0; n < num_inputs; n++) {
+                    double q = ::round(dct2_basis_value(num_inputs, n, k, DCT_NORMALIZATION_ORTHO) * 32768.0);
+                    plan->basis_q15[k * num_inputs + n] =
+                        static_cast<EIDSP_i16>(q > 32767.0 ? 32767.0 : (q < -32768.0 ? -32768.0 : q));
+                }
+            }
+        }
+        return plan;
+    }
+
+    /**
+     * Free all cached DCT plans (run_classifier_deinit calls this), they are built
+     * again on the next use
+     */
+    static void release_dct2_plans(void)
+    {
+        dct2_plan_t *plans = dct2_plans();
+        for (size_t ix = 0; ix < EIDSP_DCT_PLAN_CACHE_SIZE; ix++) {
+            ei_free(plans[ix].basis);
+            ei_free(plans[ix].basis_q15);
+            memset(&plans[ix], 0, sizeof(dct2_plan_t));
+        }
+    }
+
+    /**
+     * Multiply every row of a matrix by a truncated DCT type 2 basis, as built by
+     * get_dct2_plan() (or emitted as const data for a static impulse)
+     * @param input Input matrix (rows x N), not modified
+     * @param output Output matrix (rows x K)
+     * @param basis Basis, [N][K]
+     * @returns EIDSP_OK if OK
+     */
+    static int dct2_truncated_basis(matrix_t *input, matrix_t *output, const float *basis)
+    {
+        if (input->rows != output->rows || output->cols > input->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+#if EIDSP_USE_HW_MATH
+        matrix_t basis_matrix(input->cols, output->cols, const_cast<float*>(basis));
+        return dot(input, &basis_matrix, output);
+#else
+        const size_t K = output->cols;
+        for (size_t ix = 0; ix < input->rows; ix++) {
+            const float *in = input->buffer + (ix * input->cols);
+            float *out = output->buffer + (ix * K);
+            memset(out, 0, K * sizeof(float));
+            for (size_t n = 0; n < input->cols; n++) {
+                const float value = in[n];
+                const float *basis_row = basis + (n * K);
+                for (size_t k = 0; k < K; k++) {
+                    out[k] += value * basis_row[k];
+                }
+            }
+        }
+        return EIDSP_OK;
+#endif
+    }
+
+    /**
+     * Discrete Cosine Transform of type 2 on every row of a matrix, only computing the
+     * first output->cols coefficients. Same result as dct2(matrix_t*) followed by
+     * dropping the trailing columns, but all rows go through a single matrix multiply.
+     * Falls back to dct2() per row when the basis does not fit (see EIDSP_DCT_MAX_BASIS_ELEMENTS).
+     * @param input Input matrix (rows x N), not modified
+     * @param output Output matrix (rows x K), K <= N
+     * @param normalization Normalization mode
+     * @returns EIDSP_OK if OK
+     */
+    static int dct2_truncated(matrix_t *input, matrix_t *output,
+        DCT_NORMALIZATION_MODE normalization = DCT_NORMALIZATION_NONE)
+    {
+        if (input->rows != output->rows || output->cols > input->cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+        if (input->rows == 0 || output->cols == 0) {
+            return EIDSP_OK;
+        }
+
+        const dct2_plan_t *plan = get_dct2_plan(input->cols, output->cols, normalization);
+        if (plan) {
+            return dct2_truncated_basis(input, output, plan->basis);
+        }
+
+        // full transform per row
+        EI_DSP_MATRIX(row, 1, input->cols);
+        if (!row.buffer) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        for (size_t ix = 0; ix < input->rows; ix++) {
+            memcpy(row.buffer, input->buffer + (ix * input->cols), input->cols * sizeof(float));
+            int ret = dct2(row.buffer, input->cols, normalization);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+            memcpy(output->buffer + (ix * output->cols), row.buffer, output->cols * sizeof(float));
+        }
+        return EIDSP_OK;
+    }
+
+    /**
+     * Orthonormal DCT type 2 in fixed point, only computing the first output_cols
+     * coefficients. Input and output use the same Q format, accumulation is done
+     * in 64 bits and the output saturates to 16 bits.
+     * @param input Input values (rows x input_cols)
+     * @param rows Number of rows
+     * @param input_cols Number of input values per row (N)
+     * @param output Output values (rows x output_cols)
+     * @param output_cols Number of coefficients that are kept (K <= N)
+     * @returns EIDSP_OK if OK
+     */
+    static int dct2_truncated_q15(const EIDSP_i16 *input, size_t rows, size_t input_cols,
+        EIDSP_i16 *output, size_t output_cols)
+    {
+        if (output_cols > input_cols) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+        if (rows == 0 || output_cols == 0) {
+            return EIDSP_OK;
+        }
+
+        const dct2_plan_t *plan = get_dct2_plan_q15(input_cols, output_cols);
+        if (!plan) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        for (size_t row = 0; row < rows; row++) {
+            const EIDSP_i16 *in = input + (row * input_cols);
+            for (size_t k = 0; k < output_cols; k++) {
+                const EIDSP_i16 *basis = plan->basis_q15 + (k * input_cols);
+                int64_t acc;
+#if EIDSP_USE_CMSIS_DSP
+                arm_dot_prod_q15((q15_t*)in, (q15_t*)basis, input_cols, &acc);
+#else
+                acc = 0;
+                for (size_t n = 0; n < input_cols; n++) {
+                    acc += (int32_t)in[n] * (int32_t)basis[n];
+                }
+#endif
+                acc >>= 15;
+                output[(row * output_cols) + k] =
+                    (EIDSP_i16)(acc > INT16_MAX ? INT16_MAX : (acc < INT16_MIN ? INT16_MIN : acc));
+            }
+        }
+        return EIDSP_OK;
+    }
+
     /**
      * Quantize a float value between zero and one
      * @param value Float value
@@ -1849,6 +2041,8 @@ public:
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
+        EI_PROFILE_SCOPE("fft");
+
         int r = numpy::rfft(frame, frame_size, out_buffer, out_buffer_size, fft_points);
         if (r != EIDSP_OK) {
             return r;
@@ -2306,6 +2500,68 @@ public:
     }
 
 private:
+    static dct2_plan_t *dct2_plans(void)
+    {
+        static dct2_plan_t plans[EIDSP_DCT_PLAN_CACHE_SIZE] = { };
+        return plans;
+    }
+
+    static double dct2_basis_value(size_t num_inputs, size_t n, size_t k, DCT_NORMALIZATION_MODE normalization)
+    {
+        double scale = 2.0;
+        if (normalization == DCT_NORMALIZATION_ORTHO) {
+            scale = k == 0 ?
+                sqrt(1.0 / static_cast<double>(num_inputs)) :
+                sqrt(2.0 / static_cast<double>(num_inputs));
+        }
+        return scale * cos(M_PI * static_cast<double>(k * (2 * n + 1)) / static_cast<double>(2 * num_inputs));
+    }
+
+    /**
+     * Cached plan with the float basis, see get_dct2_plan()
+     */
+    static dct2_plan_t *find_dct2_plan(size_t num_inputs, size_t num_outputs,
+        DCT_NORMALIZATION_MODE normalization)
+    {
+        static size_t next_plan = 0;
+        dct2_plan_t *plans = dct2_plans();
+
+        if (num_outputs == 0 || num_outputs > num_inputs ||
+                num_inputs * num_outputs > EIDSP_DCT_MAX_BASIS_ELEMENTS) {
+            return nullptr;
+        }
+
+        for (size_t ix = 0; ix < EIDSP_DCT_PLAN_CACHE_SIZE; ix++) {
+            if (plans[ix].basis && plans[ix].num_inputs == num_inputs &&
+                    plans[ix].num_outputs == num_outputs && plans[ix].normalization == normalization) {
+                return &plans[ix];
+            }
+        }
+
+        dct2_plan_t *plan = &plans[next_plan];
+        next_plan = (next_plan + 1) % EIDSP_DCT_PLAN_CACHE_SIZE;
+
+        ei_free(plan->basis);
+        ei_free(plan->basis_q15);
+        memset(plan, 0, sizeof(dct2_plan_t));
+
+        plan->basis = (float*)ei_malloc(num_inputs * num_outputs * sizeof(float));
+        if (!plan->basis) {
+            return nullptr;
+        }
+        for (size_t k = 0; k < num_outputs; k++) {
+            for (size_t n = 0; n < num_inputs; n++) {
+                plan->basis[n * num_outputs + k] =
+                    static_cast<float>(dct2_basis_value(num_inputs, n, k, normalization));
+            }
+        }
+
+        plan->num_inputs = num_inputs;
+        plan->num_outputs = num_outputs;
+        plan->normalization = normalization;
+        return plan;
+    }
+
     /**
      * Helper function to handle FFT hardware acceleration failures and logging
      * @param res Result code from hardware FFT attempt
@@ -45,10 +45,19 @@
 #include "config.hpp"
 #include "edge-impulse-sdk/dsp/returntypes.h"
 
-#if EIDSP_TRACK_ALLOCATIONS
+#if EIDSP_TRACK_ALLOCATIONS || (defined(__cplusplus) && EIDSP_SCRATCH_ARENA)
 #include "memory.hpp"
 #endif
 
+// matrix buffers allocated by DSP code can come from the impulse scratch arena
+#if defined(__cplusplus) && EIDSP_SCRATCH_ARENA
+#define ei_dsp_matrix_calloc(size) ei::scratch_arena::dsp_calloc(size, 1)
+#define ei_dsp_matrix_free(ptr) ei::scratch_arena::dsp_free(ptr)
+#else
+#define ei_dsp_matrix_calloc(size) ei_calloc(size, 1)
+#define ei_dsp_matrix_free(ptr) ei_free(ptr)
+#endif
+
 #ifdef __cplusplus
 namespace ei {
 #endif // __cplusplus
@@ -104,7 +113,7 @@ typedef struct ei_matrix {
             buffer_managed_by_me = false;
         }
         else {
-            buffer = (float*)ei_calloc(n_rows * n_cols * sizeof(float), 1);
+            buffer = (float*)ei_dsp_matrix_calloc(n_rows * n_cols * sizeof(float));
             buffer_managed_by_me = true;
         }
         rows = n_rows;
@@ -129,7 +138,7 @@ typedef struct ei_matrix {
 
     ~ei_matrix() {
         if (buffer && buffer_managed_by_me) {
-            ei_free(buffer);
+            ei_dsp_matrix_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
             if (_fn) {
@@ -219,7 +228,7 @@ typedef struct ei_matrix_i8 {
             buffer_managed_by_me = false;
         }
         else {
-            buffer = (int8_t*)ei_calloc(n_rows * n_cols * sizeof(int8_t), 1);
+            buffer = (int8_t*)ei_dsp_matrix_calloc(n_rows * n_cols * sizeof(int8_t));
             buffer_managed_by_me = true;
         }
         rows = n_rows;
@@ -244,7 +253,7 @@ typedef struct ei_matrix_i8 {
 
     ~ei_matrix_i8() {
         if (buffer && buffer_managed_by_me) {
-            ei_free(buffer);
+            ei_dsp_matrix_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
             if (_fn) {
@@ -330,7 +339,7 @@ typedef struct ei_matrix_i32 {
             buffer_managed_by_me = false;
         }
         else {
-            buffer = (int32_t*)ei_calloc(n_rows * n_cols * sizeof(int32_t), 1);
+            buffer = (int32_t*)ei_dsp_matrix_calloc(n_rows * n_cols * sizeof(int32_t));
             buffer_managed_by_me = true;
         }
         rows = n_rows;
@@ -355,7 +364,7 @@ typedef struct ei_matrix_i32 {
 
     ~ei_matrix_i32() {
         if (buffer && buffer_managed_by_me) {
-            ei_free(buffer);
+            ei_dsp_matrix_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
             if (_fn) {
@@ -452,7 +461,7 @@ typedef struct ei_quantized_matrix {
             buffer_managed_by_me = false;
         }
         else {
-            buffer = (uint8_t*)ei_calloc(n_rows * n_cols * sizeof(uint8_t), 1);
+            buffer = (uint8_t*)ei_dsp_matrix_calloc(n_rows * n_cols * sizeof(uint8_t));
             buffer_managed_by_me = true;
         }
         rows = n_rows;
@@ -477,7 +486,7 @@ typedef struct ei_quantized_matrix {
 
     ~ei_quantized_matrix() {
         if (buffer && buffer_managed_by_me) {
-            ei_free(buffer);
+            ei_dsp_matrix_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
             if (_fn) {
@@ -563,7 +572,7 @@ typedef struct ei_matrix_u8 {
             buffer_managed_by_me = false;
         }
         else {
-            buffer = (uint8_t*)ei_calloc(n_rows * n_cols * sizeof(uint8_t), 1);
+            buffer = (uint8_t*)ei_dsp_matrix_calloc(n_rows * n_cols * sizeof(uint8_t));
             buffer_managed_by_me = true;
         }
         rows = n_rows;
@@ -588,7 +597,7 @@ typedef struct ei_matrix_u8 {
 
     ~ei_matrix_u8() {
         if (buffer && buffer_managed_by_me) {
-            ei_free(buffer);
+            ei_dsp_matrix_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
             if (_fn) {
@@ -153,6 +153,188 @@ namespace filters {
         ei_dsp_free(w2, n_steps*sizeof(float));
     }
 
+    #define EI_BUTTERWORTH_MAX_STEPS    4
+
+    /**
+     * Butterworth filter that keeps its state between calls, so a stream can be
+     * filtered slice by slice. Same coefficients and arithmetic as
+     * butterworth_lowpass / butterworth_highpass.
+     */
+    typedef struct {
+        int n_steps;
+        bool highpass;
+        float A[EI_BUTTERWORTH_MAX_STEPS];
+        float d1[EI_BUTTERWORTH_MAX_STEPS];
+        float d2[EI_BUTTERWORTH_MAX_STEPS];
+        float w1[EI_BUTTERWORTH_MAX_STEPS];
+        float w2[EI_BUTTERWORTH_MAX_STEPS];
+    } butterworth_state_t;
+
+    /**
+     * Set up a stateful Butterworth filter (state starts at zero)
+     * @param state Filter state
+     * @param filter_order Even filter order (between 2..8)
+     * @param sampling_freq Sample frequency of the signal
+     * @param cutoff_freq Cut-off frequency of the signal
+     * @param highpass High pass (true) or low pass (false)
+     * @returns 0 when successful
+     */
+    static int butterworth_init(
+        butterworth_state_t *state,
+        int filter_order,
+        float sampling_freq,
+        float cutoff_freq,
+        bool highpass)
+    {
+        int n_steps = filter_order / 2;
+        if (n_steps < 0 || n_steps > EI_BUTTERWORTH_MAX_STEPS) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        memset(state, 0, sizeof(butterworth_state_t));
+        state->n_steps = n_steps;
+        state->highpass = highpass;
+
+        float a = tan(M_PI * cutoff_freq / sampling_freq);
+        float a2 = pow(a, 2);
+        for (int ix = 0; ix < n_steps; ix++) {
+            float r = sin(M_PI * ((2.0 * ix) + 1.0) / (2.0 * filter_order));
+            sampling_freq = a2 + (2.0 * a * r) + 1.0;
+            state->A[ix] = highpass ? 1.0f / sampling_freq : a2 / sampling_freq;
+            state->d1[ix] = 2.0 * (1 - a2) / sampling_freq;
+            state->d2[ix] = -(a2 - (2.0 * a * r) + 1.0) / sampling_freq;
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Run a stateful Butterworth filter over the next part of the stream
+     * @param state Filter state
+     * @param src Source array
+     * @param dest Destination array (can be the same as src)
+     * @param size Size of both source and destination arrays
+     */
+    __attribute__((unused)) static void butterworth_run(butterworth_state_t *state, const float *src, float *dest, size_t size)
+    {
+        const float sign = state->highpass ? -1.0f : 1.0f;
+
+        for (size_t sx = 0; sx < size; sx++) {
+            dest[sx] = src[sx];
+
+            for (int i = 0; i < state->n_steps; i++) {
+                float w0 = state->d1[i] * state->w1[i] + state->d2[i] * state->w2[i] + dest[sx];
+                dest[sx] = state->A[i] * (w0 + (sign * 2.0 * state->w1[i]) + state->w2[i]);
+                state->w2[i] = state->w1[i];
+                state->w1[i] = w0;
+            }
+        }
+    }
+
+    // number of signals (matrix rows) that butterworth_rows filters side by side
+    #define EI_BUTTERWORTH_LANES        4
+
+    /**
+     * Run one second order section over `lanes` signals at once, in place.
+     * The signals are `stride` apart; the recursions of the lanes are independent,
+     * so they interleave (or vectorize) instead of waiting on each other.
+     */
+    template <int lanes>
+    static void butterworth_section(
+        float *signal,
+        size_t stride,
+        size_t size,
+        float A,
+        float d1,
+        float d2,
+        float sign)
+    {
+        float s1[lanes] = { 0 };
+        float s2[lanes] = { 0 };
+
+        for (size_t sx = 0; sx < size; sx++) {
+            float *v = signal + sx;
+            for (int lane = 0; lane < lanes; lane++) {
+                float x = v[lane * stride];
+#if EIDSP_BUTTERWORTH_TDF2
+                float y = A * x + s1[lane];
+                s1[lane] = (sign * 2.0f * A) * x + d1 * y + s2[lane];
+                s2[lane] = A * x + d2 * y;
+                v[lane * stride] = y;
+#else
+                // s1 / s2 are the w1 / w2 delays of the direct form
+                float w0 = d1 * s1[lane] + d2 * s2[lane] + x;
+                v[lane * stride] = A * (w0 + (sign * 2.0 * s1[lane]) + s2[lane]);
+                s2[lane] = s1[lane];
+                s1[lane] = w0;
+#endif // EIDSP_BUTTERWORTH_TDF2
+            }
+        }
+    }
+
+    /**
+     * Butterworth filter over every row of a matrix (one axis per row), in place.
+     * Rows are filtered EI_BUTTERWORTH_LANES at a time, one section at a time, and
+     * no state is allocated.
+     * By default the sections use the same direct form II arithmetic as
+     * butterworth_lowpass / butterworth_highpass (identical output). With
+     * EIDSP_BUTTERWORTH_TDF2=1 they run in transposed direct form II in single
+     * precision, which is faster on FPUs without double support but rounds differently.
+     * @param buffer Matrix buffer (rows x cols)
+     * @param rows Number of signals
+     * @param cols Number of samples per signal
+     * @param filter_order Even filter order (between 2..8)
+     * @param sampling_freq Sample frequency of the signal
+     * @param cutoff_freq Cut-off frequency of the signal
+     * @param highpass High pass (true) or low pass (false)
+     */
+    static void butterworth_rows(
+        float *buffer,
+        size_t rows,
+        size_t cols,
+        int filter_order,
+        float sampling_freq,
+        float cutoff_freq,
+        bool highpass)
+    {
+        butterworth_state_t filter;
+        if (butterworth_init(&filter, filter_order, sampling_freq, cutoff_freq, highpass) != EIDSP_OK) {
+            // more sections than we keep on the stack
+            for (size_t row = 0; row < rows; row++) {
+                float *signal = buffer + (row * cols);
+                if (highpass) {
+                    butterworth_highpass(filter_order, sampling_freq, cutoff_freq, signal, signal, cols);
+                }
+                else {
+                    butterworth_lowpass(filter_order, sampling_freq, cutoff_freq, signal, signal, cols);
+                }
+            }
+            return;
+        }
+
+        const float sign = highpass ? -1.0f : 1.0f;
+
+        for (size_t row = 0; row < rows; row += EI_BUTTERWORTH_LANES) {
+            float *signal = buffer + (row * cols);
+            const size_t lanes = rows - row;
+
+            // cascading a whole signal section by section gives the same result
+            // as running every sample through all sections
+            for (int i = 0; i < filter.n_steps; i++) {
+                const float A = filter.A[i];
+                const float d1 = filter.d1[i];
+                const float d2 = filter.d2[i];
+
+                switch (lanes) {
+                    case 1: butterworth_section<1>(signal, cols, cols, A, d1, d2, sign); break;
+                    case 2: butterworth_section<2>(signal, cols, cols, A, d1, d2, sign); break;
+                    case 3: butterworth_section<3>(signal, cols, cols, A, d1, d2, sign); break;
+                    default: butterworth_section<EI_BUTTERWORTH_LANES>(signal, cols, cols, A, d1, d2, sign); break;
+                }
+            }
+        }
+    }
+
 } // namespace filters
 } // namespace spectral
 } // namespace ei
@@ -116,9 +116,10 @@ public:
         uint8_t filter_size,
         float lowpass_cutoff,
         float highpass_cutoff = 0,
-        int decimation_ratio = 1) :  taps(filter_size) , history(filter_size, 0)
+        int decimation_ratio = 1) :  taps(filter_size) , history(2 * filter_size, 0)
     {
         this->filter_size = filter_size;
+        this->decimation_ratio = decimation_ratio < 1 ? 1 : decimation_ratio;
         std::vector<float> f_taps(filter_size, 0);
         if( highpass_cutoff == 0 && lowpass_cutoff == 0 ) 
         {
@@ -167,41 +168,41 @@ public:
     {
         for (size_t i = 0; i < size; i++)
         {
-            history[write_index] = src[i];
-            int read_index = write_index;
-            //minus one b/c of the sign bit
-            int shift = (sizeof(input_t) * 8) - 1;
-            //stuff a 1 into one less than we're going to shift to effectively round
-            //this is essentially resetting the accumulator back to zero otherwise
-            acc_t accumulator = 1 << (shift - 1);
-            for (auto tap : taps)
-            {
-                accumulator += static_cast<acc_t>(tap) * history[read_index];
-                //wrap the read index
-                read_index = read_index == 0 ? filter_size - 1 : read_index - 1;
-            }
-            //wrap the write index
-            write_index++;
-            if (write_index == filter_size)
-            {
-                write_index = 0;
-            }
+            push(src[i]);
+            dest[i] = convolve();
+        }
+    }
 
-            accumulator >>= shift;
-            //saturate if overflow
-            if (accumulator > std::numeric_limits<input_t>::max())
-            {
-                dest[i] = std::numeric_limits<input_t>::max();
-            }
-            else if (accumulator < std::numeric_limits<input_t>::min())
+/**
+ * @brief Apply the filter and keep every decimation_ratio'th output (as passed to the constructor).
+ * The taps are only evaluated for the samples that are kept, the decimation phase carries over
+ * between calls so a stream can be processed blockwise.
+ *
+ * @param src Source array
+ * @param dest Output array, at least size / decimation_ratio + 1 long (can be the same as source)
+ * @param size Number of samples to process
+ * @return Number of samples written to dest
+ */
+    size_t apply_filter_decimate(
+        const input_t *src,
+        input_t *dest,
+        size_t size)
+    {
+        size_t out_ix = 0;
+        for (size_t i = 0; i < size; i++)
+        {
+            push(src[i]);
+            if (decimation_phase == 0)
             {
-                dest[i] = std::numeric_limits<input_t>::min();
+                dest[out_ix++] = convolve();
             }
-            else
+            decimation_phase++;
+            if (decimation_phase == decimation_ratio)
             {
-                dest[i] = accumulator;
+                decimation_phase = 0;
             }
         }
+        return out_ix;
     }
 
     /**
@@ -212,13 +213,73 @@ public:
     void reset()
     {
         std::fill(history.begin(), history.end(), 0);
+        decimation_phase = 0;
     }
 
 private:
+    /**
+     * @brief Add a sample to the delay line. Every sample is stored twice, filter_size apart,
+     * so the last filter_size samples are always contiguous and no index has to wrap
+     */
+    inline void push(input_t sample)
+    {
+        history[write_index] = sample;
+        history[write_index + filter_size] = sample;
+        write_index++;
+        if (write_index == filter_size)
+        {
+            write_index = 0;
+        }
+    }
+
+    /**
+     * @brief Filter output for the most recently pushed sample
+     */
+    inline input_t convolve()
+    {
+        // history[write_index .. write_index + filter_size - 1] holds the last filter_size samples
+        const input_t *newest = history.data() + write_index + filter_size - 1;
+        //minus one b/c of the sign bit
+        const int shift = (sizeof(input_t) * 8) - 1;
+        //stuff a 1 into one less than we're going to shift to effectively round
+        //this is essentially resetting the accumulator back to zero otherwise
+        acc_t accumulator = 1 << (shift - 1);
+        // integer sums are exact, so four independent partial sums give the same result
+        acc_t partial[4] = { 0, 0, 0, 0 };
+        const input_t *tap = taps.data();
+        int k = 0;
+        for (; k + 4 <= filter_size; k += 4)
+        {
+            partial[0] += static_cast<acc_t>(tap[k]) * newest[-k];
+            partial[1] += static_cast<acc_t>(tap[k + 1]) * newest[-k - 1];
+            partial[2] += static_cast<acc_t>(tap[k + 2]) * newest[-k - 2];
+            partial[3] += static_cast<acc_t>(tap[k + 3]) * newest[-k - 3];
+        }
+        for (; k < filter_size; k++)
+        {
+            accumulator += static_cast<acc_t>(tap[k]) * newest[-k];
+        }
+        accumulator += (partial[0] + partial[1]) + (partial[2] + partial[3]);
+
+        accumulator >>= shift;
+        //saturate if overflow
+        if (accumulator > std::numeric_limits<input_t>::max())
+        {
+            return std::numeric_limits<input_t>::max();
+        }
+        else if (accumulator < std::numeric_limits<input_t>::min())
+        {
+            return std::numeric_limits<input_t>::min();
+        }
+        return accumulator;
+    }
+
     std::vector<input_t> taps;
     std::vector<input_t> history;
     int write_index = 0;
     int filter_size;
+    int decimation_ratio = 1;
+    int decimation_phase = 0;
 
     friend class AccelerometerQuantizedTestCase;
 
@@ -120,15 +120,14 @@ namespace processing {
         float filter_cutoff,
         uint8_t filter_order)
     {
-        for (size_t row = 0; row < matrix->rows; row++) {
-            filters::butterworth_lowpass(
-                filter_order,
-                sampling_frequency,
-                filter_cutoff,
-                matrix->buffer + (row * matrix->cols),
-                matrix->buffer + (row * matrix->cols),
-                matrix->cols);
-        }
+        filters::butterworth_rows(
+            matrix->buffer,
+            matrix->rows,
+            matrix->cols,
+            filter_order,
+            sampling_frequency,
+            filter_cutoff,
+            false);
 
         return EIDSP_OK;
     }
@@ -149,15 +148,14 @@ namespace processing {
         float filter_cutoff,
         uint8_t filter_order)
     {
-        for (size_t row = 0; row < matrix->rows; row++) {
-            filters::butterworth_highpass(
-                filter_order,
-                sampling_frequency,
-                filter_cutoff,
-                matrix->buffer + (row * matrix->cols),
-                matrix->buffer + (row * matrix->cols),
-                matrix->cols);
-        }
+        filters::butterworth_rows(
+            matrix->buffer,
+            matrix->rows,
+            matrix->cols,
+            filter_order,
+            sampling_frequency,
+            filter_cutoff,
+            true);
 
         return EIDSP_OK;
     }
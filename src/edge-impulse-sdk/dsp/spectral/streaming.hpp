@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef _EIDSP_SPECTRAL_STREAMING_H_
+#define _EIDSP_SPECTRAL_STREAMING_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "../numpy.hpp"
+#include "filters.hpp"
+#include "feature.hpp"
+#include "model-parameters/model_metadata.h"
+
+// Keep the Butterworth filter state between slices instead of restarting the filter
+// on every window. Cheaper (the spectral features are then updated incrementally),
+// but the features no longer match the one-shot computation near the start of the
+// window, where the one-shot filter is still settling.
+#ifndef EI_DSP_SPECTRAL_STREAMING_PERSISTENT_FILTER
+#define EI_DSP_SPECTRAL_STREAMING_PERSISTENT_FILTER     0
+#endif // EI_DSP_SPECTRAL_STREAMING_PERSISTENT_FILTER
+
+// Maximum number of axes in a streamed spectral analysis block
+#ifndef EI_DSP_SPECTRAL_STREAMING_MAX_AXES
+#define EI_DSP_SPECTRAL_STREAMING_MAX_AXES              8
+#endif // EI_DSP_SPECTRAL_STREAMING_MAX_AXES
+
+// Maximum number of spectral analysis blocks streamed at the same time (one stream per block)
+#ifndef EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS
+#define EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS            4
+#endif // EI_DSP_SPECTRAL_STREAMING_MAX_BLOCKS
+
+// The running moments are recomputed from the window every this many slices
+#ifndef EI_DSP_SPECTRAL_STREAMING_RESYNC_SLICES
+#define EI_DSP_SPECTRAL_STREAMING_RESYNC_SLICES         64
+#endif // EI_DSP_SPECTRAL_STREAMING_RESYNC_SLICES
+
+namespace ei {
+namespace spectral {
+
+/**
+ * Spectral analysis over a sliding window, fed one slice at a time
+ * (the continuous counterpart of feature::extract_spec_features).
+ *
+ * Per axis the window is kept as (scaled sample - reference), with running power
+ * sums for mean / RMS / skew / kurtosis. The power spectra of full Welch segments
+ * don't depend on the window mean (apart from the DC bin, which is rebuilt from
+ * the segment sum) so they are cached by absolute sample position and reused as
+ * long as the window increase is a multiple of the segment hop. Only segments
+ * that are new, or that are zero padded at the end of the window, are transformed.
+ *
+ * Configs that can't be updated incrementally (wavelets, v1, decimation, or a
+ * filter that restarts every window) keep the raw window, so the caller can run
+ * the one-shot extraction over it (see incremental()).
+ */
+class feature_stream {
+public:
+    feature_stream() {
+        memset(&_s, 0, sizeof(_s));
+    }
+
+    ~feature_stream() {
+        clear();
+    }
+
+    /**
+     * Drop the window and free all buffers
+     */
+    void clear() {
+        if (_s.window) {
+            ei_free(_s.window);
+        }
+        if (_s.cache) {
+            ei_free(_s.cache);
+        }
+        if (_s.cache_start) {
+            ei_free(_s.cache_start);
+        }
+        memset(&_s, 0, sizeof(_s));
+    }
+
+    /**
+     * Set up the stream for a block, no-op if it's already set up for this block
+     * @param config Spectral analysis config
+     * @param window_frames Window size in samples per axis
+     * @param sampling_freq Sampling frequency
+     * @returns 0 if OK
+     */
+    int configure(ei_dsp_config_spectral_analysis_t *config, size_t window_frames, float sampling_freq) {
+        if (_s.config == config && _s.window_frames == window_frames && _s.sampling_freq == sampling_freq) {
+            return EIDSP_OK;
+        }
+
+        clear();
+
+        if (config->axes <= 0 || config->axes > EI_DSP_SPECTRAL_STREAMING_MAX_AXES || window_frames == 0) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        _s.config = config;
+        _s.axes = config->axes;
+        _s.window_frames = window_frames;
+        _s.sampling_freq = sampling_freq;
+        _s.incremental = supports_incremental(config);
+
+        _s.window = (float*)ei_calloc(window_frames * _s.axes, sizeof(float));
+        if (!_s.window) {
+            clear();
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        if (!_s.incremental) {
+            return EIDSP_OK;
+        }
+
+        _s.fft_points = config->fft_length;
+        _s.fft_out_size = _s.fft_points / 2 + 1;
+        _s.hop = config->do_fft_overlap ? _s.fft_points / 2 : _s.fft_points;
+        _s.cache_segments = window_frames >= _s.fft_points ?
+            ((window_frames - _s.fft_points) / _s.hop) + 1 : 0;
+
+        // per axis: segment power spectra and segment sums, then scratch for one segment
+        // and the max-hold spectrum
+        const size_t cache_floats = (_s.axes * _s.cache_segments * (_s.fft_out_size + 1)) +
+            _s.fft_points + (2 * _s.fft_out_size);
+        _s.cache = (float*)ei_calloc(cache_floats, sizeof(float));
+        _s.cache_start = (int64_t*)ei_calloc(_s.cache_segments + 1, sizeof(int64_t));
+        if (!_s.cache || !_s.cache_start) {
+            clear();
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        _s.cache_power = _s.cache;
+        _s.cache_sum = _s.cache_power + (_s.axes * _s.cache_segments * _s.fft_out_size);
+        _s.fft_in = _s.cache_sum + (_s.axes * _s.cache_segments);
+        _s.fft_out = _s.fft_in + _s.fft_points;
+        _s.held = _s.fft_out + _s.fft_out_size;
+        for (size_t ix = 0; ix < _s.cache_segments; ix++) {
+            _s.cache_start[ix] = -1;
+        }
+
+        if (strcmp(config->filter_type, "low") == 0 || strcmp(config->filter_type, "high") == 0) {
+            _s.is_high_pass = strcmp(config->filter_type, "high") == 0;
+            _s.do_filter = true;
+            for (int axis = 0; axis < _s.axes && config->filter_order; axis++) {
+                int ret = filters::butterworth_init(&_s.filter[axis], config->filter_order,
+                    sampling_freq, config->filter_cutoff, _s.is_high_pass);
+                if (ret != EIDSP_OK) {
+                    clear();
+                    EIDSP_ERR(ret);
+                }
+            }
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Config the stream is set up for, nullptr if it's not in use
+     */
+    const ei_dsp_config_spectral_analysis_t *config() const {
+        return _s.config;
+    }
+
+    /**
+     * Whether extract() can be used, otherwise run the one-shot extraction over window()
+     */
+    bool incremental() const {
+        return _s.incremental;
+    }
+
+    /**
+     * Whether a complete window has been pushed since configure() / clear()
+     */
+    bool window_full() const {
+        return _s.window && _s.frames == _s.window_frames;
+    }
+
+    /**
+     * Raw window, interleaved (frame-major, like the signal), only if !incremental()
+     */
+    const float *window() const {
+        return _s.incremental ? nullptr : _s.window;
+    }
+
+    /**
+     * Append a slice to the window, dropping the oldest frames once the window is full
+     * @param samples Raw samples, interleaved (frames x axes)
+     * @param frames Number of frames in the slice
+     * @returns 0 if OK
+     */
+    int push(const float *samples, size_t frames) {
+        if (!_s.window) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        // only the newest window_frames matter
+        if (frames > _s.window_frames) {
+            samples += (frames - _s.window_frames) * _s.axes;
+            _s.position += frames - _s.window_frames;
+            frames = _s.window_frames;
+        }
+
+        size_t drop = (_s.frames + frames > _s.window_frames) ?
+            _s.frames + frames - _s.window_frames : 0;
+
+        if (!_s.incremental) {
+            memmove(_s.window, _s.window + (drop * _s.axes),
+                (_s.frames - drop) * _s.axes * sizeof(float));
+            memcpy(_s.window + ((_s.frames - drop) * _s.axes), samples, frames * _s.axes * sizeof(float));
+            _s.frames += frames - drop;
+            _s.position += frames;
+            return EIDSP_OK;
+        }
+
+        const size_t W = _s.window_frames;
+        for (int axis = 0; axis < _s.axes; axis++) {
+            float *row = _s.window + (axis * W);
+            double *sums = _s.sums[axis];
+
+            // frames that leave the window
+            for (size_t ix = 0; ix < drop; ix++) {
+                double v = row[ix];
+                double v2 = v * v;
+                sums[0] -= v;
+                sums[1] -= v2;
+                sums[2] -= v2 * v;
+                sums[3] -= v2 * v2;
+            }
+            memmove(row, row + drop, (_s.frames - drop) * sizeof(float));
+
+            // scale (and filter) the new frames into the window
+            float *dst = row + (_s.frames - drop);
+            for (size_t ix = 0; ix < frames; ix++) {
+                dst[ix] = samples[(ix * _s.axes) + axis] * _s.config->scale_axes;
+            }
+#if EI_DSP_SPECTRAL_STREAMING_PERSISTENT_FILTER
+            if (_s.do_filter && _s.config->filter_order) {
+                filters::butterworth_run(&_s.filter[axis], dst, dst, frames);
+            }
+#endif
+            if (_s.position == 0 && frames > 0) {
+                _s.reference[axis] = dst[0];
+            }
+            for (size_t ix = 0; ix < frames; ix++) {
+                dst[ix] -= _s.reference[axis];
+                double v = dst[ix];
+                double v2 = v * v;
+                sums[0] += v;
+                sums[1] += v2;
+                sums[2] += v2 * v;
+                sums[3] += v2 * v2;
+            }
+        }
+
+        _s.frames += frames - drop;
+        _s.position += frames;
+
+        if (++_s.slices_since_resync >= EI_DSP_SPECTRAL_STREAMING_RESYNC_SLICES) {
+            resync_sums();
+        }
+
+        return EIDSP_OK;
+    }
+
+    /**
+     * Calculate the spectral features for the current window, in the same layout as
+     * feature::extract_spec_features
+     * @param output_matrix Output matrix, 1 x (axes * features per axis)
+     * @returns 0 if OK
+     */
+    int extract(matrix_t *output_matrix) {
+        if (!_s.incremental || !window_full()) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        ei_dsp_config_spectral_analysis_t *config = _s.config;
+        const size_t W = _s.window_frames;
+
+        size_t start_bin, stop_bin;
+        if (_s.do_filter) {
+            feature::get_start_stop_bin(_s.sampling_freq, config->fft_length, config->filter_cutoff,
+                &start_bin, &stop_bin, _s.is_high_pass);
+        }
+        else {
+            start_bin = 1;
+            stop_bin = config->fft_length / 2 + 1;
+        }
+        const size_t num_bins = stop_bin - start_bin;
+        const size_t features_per_axis = 3 + (config->implementation_version == 4 ? 2 : 0) + num_bins;
+
+        if (output_matrix->rows * output_matrix->cols != _s.axes * features_per_axis) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        float *feature_out = output_matrix->buffer;
+        for (int axis = 0; axis < _s.axes; axis++) {
+            const float *row = _s.window + (axis * W);
+            const double *sums = _s.sums[axis];
+
+            // central moments from the power sums
+            const double n = static_cast<double>(W);
+            const double mu = sums[0] / n;
+            const double e2 = sums[1] / n;
+            const double e3 = sums[2] / n;
+            const double e4 = sums[3] / n;
+            double m2 = e2 - (mu * mu);
+            if (m2 < 0.0) {
+                m2 = 0.0;
+            }
+            const double m3 = e3 - (3.0 * mu * e2) + (2.0 * mu * mu * mu);
+            const double m4 = e4 - (4.0 * mu * e3) + (6.0 * mu * mu * e2) - (3.0 * mu * mu * mu * mu);
+
+            float rms = static_cast<float>(sqrt(m2));
+            *feature_out++ = rms;
+
+            double stddev = rms == 0.0f ? 1e-10 : static_cast<double>(rms);
+            double temp = stddev * stddev * stddev;
+            *feature_out++ = static_cast<float>(m3 / temp);
+            *feature_out++ = static_cast<float>((m4 / (temp * stddev)) - 3.0);
+
+            // welch max hold, over every segment in the window
+            int ret = welch_max_hold(axis, row, static_cast<float>(mu));
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+
+            if (config->implementation_version == 4) {
+                matrix_t x(1, _s.fft_out_size, _s.held);
+                matrix_t out(1, 1);
+
+                *feature_out++ = (numpy::skew(&x, &out) == EIDSP_OK) ? (out.get_row_ptr(0)[0]) : 0.0f;
+                *feature_out++ = (numpy::kurtosis(&x, &out) == EIDSP_OK) ? (out.get_row_ptr(0)[0]) : 0.0f;
+            }
+
+            for (size_t i = start_bin; i < stop_bin; i++) {
+                feature_out[i - start_bin] = _s.held[i];
+            }
+            if (config->do_log) {
+                numpy::zero_handling(feature_out, num_bins);
+                ei_matrix temp_matrix(num_bins, 1, feature_out);
+                numpy::log10(&temp_matrix);
+            }
+            feature_out += num_bins;
+        }
+
+        return EIDSP_OK;
+    }
+
+private:
+    static bool supports_incremental(ei_dsp_config_spectral_analysis_t *config) {
+        if (config->implementation_version < 2 || config->implementation_version > 4) {
+            return false;
+        }
+        if (config->implementation_version >= 3 &&
+                (!config->analysis_type || strcmp(config->analysis_type, "FFT") != 0)) {
+            return false;
+        }
+        if (config->implementation_version == 4 &&
+                (config->extra_low_freq || config->input_decimation_ratio != 1)) {
+            return false;
+        }
+        if (config->fft_length < 2) {
+            return false;
+        }
+        bool filtered = config->filter_order &&
+            (strcmp(config->filter_type, "low") == 0 || strcmp(config->filter_type, "high") == 0);
+        if (filtered && !EI_DSP_SPECTRAL_STREAMING_PERSISTENT_FILTER) {
+            return false;
+        }
+        return true;
+    }
+
+    void resync_sums() {
+        const size_t W = _s.window_frames;
+        for (int axis = 0; axis < _s.axes; axis++) {
+            const float *row = _s.window + (axis * W);
+            double *sums = _s.sums[axis];
+            sums[0] = sums[1] = sums[2] = sums[3] = 0.0;
+            for (size_t ix = 0; ix < _s.frames; ix++) {
+                double v = row[ix];
+                double v2 = v * v;
+                sums[0] += v;
+                sums[1] += v2;
+                sums[2] += v2 * v;
+                sums[3] += v2 * v2;
+            }
+        }
+        _s.slices_since_resync = 0;
+    }
+
+    /**
+     * Same segments as numpy::welch_max_hold over the mean-removed window, all bins
+     * are held into _s.held
+     */
+    int welch_max_hold(int axis, const float *row, float mu) {
+        const size_t W = _s.window_frames;
+        const size_t fft_points = _s.fft_points;
+        const int64_t window_start = static_cast<int64_t>(_s.position) - static_cast<int64_t>(W);
+
+        memset(_s.held, 0, _s.fft_out_size * sizeof(float));
+
+        for (size_t offset = 0; offset < W; offset += _s.hop) {
+            const size_t n_input_points = offset + fft_points <= W ? fft_points : W - offset;
+            const float *spectrum;
+
+            if (n_input_points == fft_points && _s.cache_segments > 0) {
+                const int64_t start = window_start + static_cast<int64_t>(offset);
+                const size_t slot = static_cast<size_t>(start / static_cast<int64_t>(_s.hop)) % _s.cache_segments;
+                float *power = _s.cache_power + (((axis * _s.cache_segments) + slot) * _s.fft_out_size);
+                float *sum = _s.cache_sum + ((axis * _s.cache_segments) + slot);
+
+                // all axes share the segment positions, mark the slot once the last axis is done
+                if (_s.cache_start[slot] != start) {
+                    memcpy(_s.fft_in, row + offset, fft_points * sizeof(float));
+                    int ret = numpy::power_spectrum(_s.fft_in, fft_points, power, _s.fft_out_size, fft_points);
+                    if (ret != EIDSP_OK) {
+                        EIDSP_ERR(ret);
+                    }
+                    float s = 0.0f;
+                    for (size_t ix = 0; ix < fft_points; ix++) {
+                        s += row[offset + ix];
+                    }
+                    *sum = s;
+                    if (axis == _s.axes - 1) {
+                        _s.cache_start[slot] = start;
+                    }
+                }
+
+                // only the DC bin depends on the mean that the one-shot path removes
+                memcpy(_s.fft_out, power, _s.fft_out_size * sizeof(float));
+                float dc = *sum - (static_cast<float>(fft_points) * mu);
+                _s.fft_out[0] = (1.0 / static_cast<float>(fft_points)) * (dc * dc);
+                spectrum = _s.fft_out;
+            }
+            else {
+                // zero padded segment, the padding makes every bin depend on the mean
+                for (size_t ix = 0; ix < n_input_points; ix++) {
+                    _s.fft_in[ix] = row[offset + ix] - mu;
+                }
+                int ret = numpy::power_spectrum(_s.fft_in, n_input_points, _s.fft_out, _s.fft_out_size, fft_points);
+                if (ret != EIDSP_OK) {
+                    EIDSP_ERR(ret);
+                }
+                spectrum = _s.fft_out;
+            }
+
+            for (size_t ix = 0; ix < _s.fft_out_size; ix++) {
+                _s.held[ix] = std::max(_s.held[ix], spectrum[ix]);
+            }
+        }
+
+        return EIDSP_OK;
+    }
+
+    struct {
+        ei_dsp_config_spectral_analysis_t *config;
+        int axes;
+        size_t window_frames;
+        float sampling_freq;
+        bool incremental;
+
+        float *window;              // incremental: [axis][frame] (scaled, filtered, minus reference), else raw signal
+        size_t frames;              // frames in the window
+        uint64_t position;          // frames pushed since the start of the stream
+        size_t slices_since_resync;
+
+        double sums[EI_DSP_SPECTRAL_STREAMING_MAX_AXES][4];
+        float reference[EI_DSP_SPECTRAL_STREAMING_MAX_AXES];
+        filters::butterworth_state_t filter[EI_DSP_SPECTRAL_STREAMING_MAX_AXES];
+        bool do_filter;
+        bool is_high_pass;
+
+        size_t fft_points;
+        size_t fft_out_size;
+        size_t hop;
+        size_t cache_segments;
+        float *cache;               // single allocation for everything below
+        float *cache_power;         // [axis][segment][bin]
+        float *cache_sum;           // [axis][segment]
+        float *fft_in;
+        float *fft_out;
+        float *held;
+        int64_t *cache_start;       // [segment], absolute frame the cached segment starts at
+    } _s;
+};
+
+} // namespace spectral
+} // namespace ei
+
+#endif // _EIDSP_SPECTRAL_STREAMING_H_
@@ -32,6 +32,8 @@
 
 #include "edge-impulse-sdk/dsp/ei_vector.h"
 
+#include <algorithm>
+
 #include "processing.hpp"
 #include "wavelet_coeff.hpp"
 
@@ -79,151 +81,234 @@ inline bool histo(const fvec &x, size_t nbins, fvec &h, bool normalize = false)
 class wavelet {
 
     static constexpr size_t NUM_FEATHERS_PER_COMP = 14;
+    static constexpr size_t NUM_ENTROPY_BINS = 100;
+    static constexpr size_t MAX_FILTER_SIZE = 20;
+
+    // decomposition filters, stored reversed so dwt is a plain dot product
+    typedef struct {
+        float h[MAX_FILTER_SIZE];
+        float g[MAX_FILTER_SIZE];
+        size_t size;
+    } filter_t;
 
     template <size_t wave_size>
-    static void get_filter(const std::array<std::array<float, wave_size>, 2> wav, fvec &h, fvec &g)
+    static void get_filter(const std::array<std::array<float, wave_size>, 2> &wav, filter_t *filter)
     {
-        size_t n = wav[0].size();
-        h.resize(n);
-        g.resize(n);
-        for (size_t i = 0; i < n; i++) {
-            h[i] = wav[0][n - i - 1];
-            g[i] = wav[1][n - i - 1];
+        static_assert(wave_size <= MAX_FILTER_SIZE, "wavelet filter too long");
+        filter->size = wave_size;
+        for (size_t i = 0; i < wave_size; i++) {
+            filter->h[i] = wav[0][wave_size - i - 1];
+            filter->g[i] = wav[1][wave_size - i - 1];
         }
     }
 
-    static void find_filter(const char *wav, fvec &h, fvec &g)
+    static bool find_filter(const char *wav, filter_t *filter)
     {
-        if (strcmp(wav, "bior1.3") == 0) get_filter<6>(bior1p3, h, g);
-        else if (strcmp(wav, "bior1.5") == 0) get_filter<10>(bior1p5, h, g);
-        else if (strcmp(wav, "bior2.2") == 0) get_filter<6>(bior2p2, h, g);
-        else if (strcmp(wav, "bior2.4") == 0) get_filter<10>(bior2p4, h, g);
-        else if (strcmp(wav, "bior2.6") == 0) get_filter<14>(bior2p6, h, g);
-        else if (strcmp(wav, "bior2.8") == 0) get_filter<18>(bior2p8, h, g);
-        else if (strcmp(wav, "bior3.1") == 0) get_filter<4>(bior3p1, h, g);
-        else if (strcmp(wav, "bior3.3") == 0) get_filter<8>(bior3p3, h, g);
-        else if (strcmp(wav, "bior3.5") == 0) get_filter<12>(bior3p5, h, g);
-        else if (strcmp(wav, "bior3.7") == 0) get_filter<16>(bior3p7, h, g);
-        else if (strcmp(wav, "bior3.9") == 0) get_filter<20>(bior3p9, h, g);
-        else if (strcmp(wav, "bior4.4") == 0) get_filter<10>(bior4p4, h, g);
-        else if (strcmp(wav, "bior5.5") == 0) get_filter<12>(bior5p5, h, g);
-        else if (strcmp(wav, "bior6.8") == 0) get_filter<18>(bior6p8, h, g);
-        else if (strcmp(wav, "coif1") == 0) get_filter<6>(coif1, h, g);
-        else if (strcmp(wav, "coif2") == 0) get_filter<12>(coif2, h, g);
-        else if (strcmp(wav, "coif3") == 0) get_filter<18>(coif3, h, g);
-        else if (strcmp(wav, "db2") == 0) get_filter<4>(db2, h, g);
-        else if (strcmp(wav, "db3") == 0) get_filter<6>(db3, h, g);
-        else if (strcmp(wav, "db4") == 0) get_filter<8>(db4, h, g);
-        else if (strcmp(wav, "db5") == 0) get_filter<10>(db5, h, g);
-        else if (strcmp(wav, "db6") == 0) get_filter<12>(db6, h, g);
-        else if (strcmp(wav, "db7") == 0) get_filter<14>(db7, h, g);
-        else if (strcmp(wav, "db8") == 0) get_filter<16>(db8, h, g);
-        else if (strcmp(wav, "db9") == 0) get_filter<18>(db9, h, g);
-        else if (strcmp(wav, "db10") == 0) get_filter<20>(db10, h, g);
-        else if (strcmp(wav, "haar") == 0) get_filter<2>(haar, h, g);
-        else if (strcmp(wav, "rbio1.3") == 0) get_filter<6>(rbio1p3, h, g);
-        else if (strcmp(wav, "rbio1.5") == 0) get_filter<10>(rbio1p5, h, g);
-        else if (strcmp(wav, "rbio2.2") == 0) get_filter<6>(rbio2p2, h, g);
-        else if (strcmp(wav, "rbio2.4") == 0) get_filter<10>(rbio2p4, h, g);
-        else if (strcmp(wav, "rbio2.6") == 0) get_filter<14>(rbio2p6, h, g);
-        else if (strcmp(wav, "rbio2.8") == 0) get_filter<18>(rbio2p8, h, g);
-        else if (strcmp(wav, "rbio3.1") == 0) get_filter<4>(rbio3p1, h, g);
-        else if (strcmp(wav, "rbio3.3") == 0) get_filter<8>(rbio3p3, h, g);
-        else if (strcmp(wav, "rbio3.5") == 0) get_filter<12>(rbio3p5, h, g);
-        else if (strcmp(wav, "rbio3.7") == 0) get_filter<16>(rbio3p7, h, g);
-        else if (strcmp(wav, "rbio3.9") == 0) get_filter<20>(rbio3p9, h, g);
-        else if (strcmp(wav, "rbio4.4") == 0) get_filter<10>(rbio4p4, h, g);
-        else if (strcmp(wav, "rbio5.5") == 0) get_filter<12>(rbio5p5, h, g);
-        else if (strcmp(wav, "rbio6.8") == 0) get_filter<18>(rbio6p8, h, g);
-        else if (strcmp(wav, "sym2") == 0) get_filter<4>(sym2, h, g);
-        else if (strcmp(wav, "sym3") == 0) get_filter<6>(sym3, h, g);
-        else if (strcmp(wav, "sym4") == 0) get_filter<8>(sym4, h, g);
-        else if (strcmp(wav, "sym5") == 0) get_filter<10>(sym5, h, g);
-        else if (strcmp(wav, "sym6") == 0) get_filter<12>(sym6, h, g);
-        else if (strcmp(wav, "sym7") == 0) get_filter<14>(sym7, h, g);
-        else if (strcmp(wav, "sym8") == 0) get_filter<16>(sym8, h, g);
-        else if (strcmp(wav, "sym9") == 0) get_filter<18>(sym9, h, g);
-        else if (strcmp(wav, "sym10") == 0) get_filter<20>(sym10, h, g);
-        else assert(0); // wavelet not in the list
+        if (strcmp(wav, "bior1.3") == 0) get_filter<6>(bior1p3, filter);
+        else if (strcmp(wav, "bior1.5") == 0) get_filter<10>(bior1p5, filter);
+        else if (strcmp(wav, "bior2.2") == 0) get_filter<6>(bior2p2, filter);
+        else if (strcmp(wav, "bior2.4") == 0) get_filter<10>(bior2p4, filter);
+        else if (strcmp(wav, "bior2.6") == 0) get_filter<14>(bior2p6, filter);
+        else if (strcmp(wav, "bior2.8") == 0) get_filter<18>(bior2p8, filter);
+        else if (strcmp(wav, "bior3.1") == 0) get_filter<4>(bior3p1, filter);
+        else if (strcmp(wav, "bior3.3") == 0) get_filter<8>(bior3p3, filter);
+        else if (strcmp(wav, "bior3.5") == 0) get_filter<12>(bior3p5, filter);
+        else if (strcmp(wav, "bior3.7") == 0) get_filter<16>(bior3p7, filter);
+        else if (strcmp(wav, "bior3.9") == 0) get_filter<20>(bior3p9, filter);
+        else if (strcmp(wav, "bior4.4") == 0) get_filter<10>(bior4p4, filter);
+        else if (strcmp(wav, "bior5.5") == 0) get_filter<12>(bior5p5, filter);
+        else if (strcmp(wav, "bior6.8") == 0) get_filter<18>(bior6p8, filter);
+        else if (strcmp(wav, "coif1") == 0) get_filter<6>(coif1, filter);
+        else if (strcmp(wav, "coif2") == 0) get_filter<12>(coif2, filter);
+        else if (strcmp(wav, "coif3") == 0) get_filter<18>(coif3, filter);
+        else if (strcmp(wav, "db2") == 0) get_filter<4>(db2, filter);
+        else if (strcmp(wav, "db3") == 0) get_filter<6>(db3, filter);
+        else if (strcmp(wav, "db4") == 0) get_filter<8>(db4, filter);
+        else if (strcmp(wav, "db5") == 0) get_filter<10>(db5, filter);
+        else if (strcmp(wav, "db6") == 0) get_filter<12>(db6, filter);
+        else if (strcmp(wav, "db7") == 0) get_filter<14>(db7, filter);
+        else if (strcmp(wav, "db8") == 0) get_filter<16>(db8, filter);
+        else if (strcmp(wav, "db9") == 0) get_filter<18>(db9, filter);
+        else if (strcmp(wav, "db10") == 0) get_filter<20>(db10, filter);
+        else if (strcmp(wav, "haar") == 0) get_filter<2>(haar, filter);
+        else if (strcmp(wav, "rbio1.3") == 0) get_filter<6>(rbio1p3, filter);
+        else if (strcmp(wav, "rbio1.5") == 0) get_filter<10>(rbio1p5, filter);
+        else if (strcmp(wav, "rbio2.2") == 0) get_filter<6>(rbio2p2, filter);
+        else if (strcmp(wav, "rbio2.4") == 0) get_filter<10>(rbio2p4, filter);
+        else if (strcmp(wav, "rbio2.6") == 0) get_filter<14>(rbio2p6, filter);
+        else if (strcmp(wav, "rbio2.8") == 0) get_filter<18>(rbio2p8, filter);
+        else if (strcmp(wav, "rbio3.1") == 0) get_filter<4>(rbio3p1, filter);
+        else if (strcmp(wav, "rbio3.3") == 0) get_filter<8>(rbio3p3, filter);
+        else if (strcmp(wav, "rbio3.5") == 0) get_filter<12>(rbio3p5, filter);
+        else if (strcmp(wav, "rbio3.7") == 0) get_filter<16>(rbio3p7, filter);
+        else if (strcmp(wav, "rbio3.9") == 0) get_filter<20>(rbio3p9, filter);
+        else if (strcmp(wav, "rbio4.4") == 0) get_filter<10>(rbio4p4, filter);
+        else if (strcmp(wav, "rbio5.5") == 0) get_filter<12>(rbio5p5, filter);
+        else if (strcmp(wav, "rbio6.8") == 0) get_filter<18>(rbio6p8, filter);
+        else if (strcmp(wav, "sym2") == 0) get_filter<4>(sym2, filter);
+        else if (strcmp(wav, "sym3") == 0) get_filter<6>(sym3, filter);
+        else if (strcmp(wav, "sym4") == 0) get_filter<8>(sym4, filter);
+        else if (strcmp(wav, "sym5") == 0) get_filter<10>(sym5, filter);
+        else if (strcmp(wav, "sym6") == 0) get_filter<12>(sym6, filter);
+        else if (strcmp(wav, "sym7") == 0) get_filter<14>(sym7, filter);
+        else if (strcmp(wav, "sym8") == 0) get_filter<16>(sym8, filter);
+        else if (strcmp(wav, "sym9") == 0) get_filter<18>(sym9, filter);
+        else if (strcmp(wav, "sym10") == 0) get_filter<20>(sym10, filter);
+        else return false; // wavelet not in the list
+        return true;
     }
 
-    static void calculate_entropy(const fvec &y, fvec &features)
-    {
-        fvec h;
-        const bool ok = histo(y, 100, h, true);
-        if (!ok) {
-            features.push_back(0.0f);
-            return;
-        }
-        // entropy = -sum(prob * log(prob)
-        float entropy = 0.0f;
-        for (size_t i = 0; i < h.size(); i++) {
-            if (h[i] > 0.0f) {
-                entropy -= h[i] * log(h[i]);
-            }
-        }
-        features.push_back(entropy);
-    }
-
-    static float get_percentile_from_sorted(const fvec &sorted, float percentile)
+    static size_t get_percentile_index(size_t size, float percentile)
     {
         // adding 0.5 is a trick to get rounding out of C flooring behavior during cast
-        size_t index = (size_t) ((percentile * (sorted.size()-1)) + 0.5);
-        return sorted[index];
+        return (size_t) ((percentile * (size-1)) + 0.5);
     }
 
-    static void calculate_statistics(const fvec &y, fvec &features, float mean)
+    /**
+     * Percentiles (5, 25, 75, 95, 50) by selection instead of a full sort.
+     * The median partitions the buffer, every next percentile only selects
+     * within the part that is left of / right of the previous one.
+     * @param x Values, reordered in place
+     * @param size Number of values
+     * @param features Output, 5 values
+     */
+    static void calculate_percentiles(float *x, size_t size, float *features)
     {
-        fvec sorted = y;
-        std::sort(sorted.begin(), sorted.end());
-        features.push_back(get_percentile_from_sorted(sorted,0.05));
-        features.push_back(get_percentile_from_sorted(sorted,0.25));
-        features.push_back(get_percentile_from_sorted(sorted,0.75));
-        features.push_back(get_percentile_from_sorted(sorted,0.95));
-        features.push_back(get_percentile_from_sorted(sorted,0.5));
-
-        matrix_t x(1, y.size(), const_cast<float *>(y.data()));
-        matrix_t out(1, 1);
-
-        features.push_back(mean);
-        if (numpy::stdev(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-        features.push_back(numpy::variance(const_cast<float *>(y.data()), y.size()));
-        if (numpy::rms(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-        if (numpy::skew(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
-        if (numpy::kurtosis(&x, &out) == EIDSP_OK)
-            features.push_back(out.get_row_ptr(0)[0]);
+        const size_t k05 = get_percentile_index(size, 0.05);
+        const size_t k25 = get_percentile_index(size, 0.25);
+        const size_t k50 = get_percentile_index(size, 0.5);
+        const size_t k75 = get_percentile_index(size, 0.75);
+        const size_t k95 = get_percentile_index(size, 0.95);
+
+        std::nth_element(x, x + k50, x + size);
+        if (k25 < k50) {
+            std::nth_element(x, x + k25, x + k50);
+        }
+        if (k05 < k25) {
+            std::nth_element(x, x + k05, x + k25);
+        }
+        if (k75 > k50) {
+            std::nth_element(x + k50 + 1, x + k75, x + size);
+        }
+        if (k95 > k75) {
+            std::nth_element(x + k75 + 1, x + k95, x + size);
+        }
+
+        features[0] = x[k05];
+        features[1] = x[k25];
+        features[2] = x[k75];
+        features[3] = x[k95];
+        features[4] = x[k50];
     }
 
-    static void calculate_crossings(const fvec &y, fvec &features, float mean)
+    /**
+     * Entropy, zero / mean crossings, percentiles and moments of one set of
+     * coefficients, in two passes over the data. Accumulation order matches
+     * numpy::mean / stdev / variance / rms / skew / kurtosis.
+     * @param y Coefficients
+     * @param size Number of coefficients
+     * @param scratch Buffer of at least size elements, overwritten
+     * @param features Output, NUM_FEATHERS_PER_COMP values
+     */
+    static void extract_features(const float *y, size_t size, float *scratch, float *features)
     {
+        // first pass: mean and range
+        float sum = 0.0f;
+        float min = y[0];
+        float max = y[0];
+        for (size_t i = 0; i < size; i++) {
+            sum += y[i];
+            if (y[i] < min) min = y[i];
+            if (y[i] > max) max = y[i];
+        }
+        const float mean = sum / size;
+
+        // second pass: central moments, crossings and histogram
+        const bool has_range = (max - min) > 0.0f;
+        const float step = (max - min) / NUM_ENTROPY_BINS;
+        uint32_t histogram[NUM_ENTROPY_BINS] = { 0 };
+        float m_2 = 0.0f;
+        float m_3 = 0.0f;
+        float m_4 = 0.0f;
+        float sum_squares = 0.0f;
         size_t zc = 0;
-        for (size_t i = 1; i < y.size(); i++) {
-            if (y[i] * y[i - 1] < 0) {
-                zc++;
+        size_t mc = 0;
+
+        for (size_t i = 0; i < size; i++) {
+            const float v = y[i];
+            const float diff = v - mean;
+            const float square_diff = diff * diff;
+            m_2 += square_diff;
+            m_3 += square_diff * diff;
+            m_4 += square_diff * square_diff;
+            sum_squares += v * v;
+
+            if (i > 0) {
+                if (v * y[i - 1] < 0) {
+                    zc++;
+                }
+                if (diff * (y[i - 1] - mean) < 0) {
+                    mc++;
+                }
+            }
+
+            if (has_range) {
+                size_t bin = (v - min) / step;
+                if (bin >= NUM_ENTROPY_BINS)
+                    bin = NUM_ENTROPY_BINS - 1;
+                histogram[bin]++;
             }
+
+            scratch[i] = v;
         }
-        features.push_back(zc / (float)y.size());
 
-        size_t mc = 0;
-        for (size_t i = 1; i < y.size(); i++) {
-            if ((y[i] - mean) * (y[i - 1] - mean) < 0) {
-                mc++;
+        // entropy = -sum(prob * log(prob)
+        float entropy = 0.0f;
+        if (has_range) {
+            for (size_t i = 0; i < NUM_ENTROPY_BINS; i++) {
+                if (histogram[i] > 0) {
+                    float prob = histogram[i] / (float)size;
+                    entropy -= prob * log(prob);
+                }
             }
         }
-        features.push_back(mc / (float)y.size());
+        features[0] = entropy;
+        features[1] = zc / (float)size;
+        features[2] = mc / (float)size;
+
+        calculate_percentiles(scratch, size, features + 3);
+
+        features[8] = mean;
+        features[9] = sqrt(m_2 / size);
+        features[10] = m_2 / (size - 1);
+        features[11] = sqrt(sum_squares / static_cast<float>(size));
+
+        // skew = (m_3) / (m_2)^(3/2)
+        float m_2_n = m_2 / size;
+        float m_3_n = m_3 / size;
+        float m_2_pow = sqrt(m_2_n * m_2_n * m_2_n);
+        features[12] = m_2_pow == 0.0f ? 0.0f : m_3_n / m_2_pow;
+
+        // Fisher kurtosis = (m_4 / variance^2) - 3
+        float m_4_n = m_4 / size;
+        float variance_sq = m_2_n * m_2_n;
+        features[13] = variance_sq == 0.0f ? -3.0f : (m_4_n / variance_sq) - 3.0f;
     }
 
-    static void
-    dwt(const float *x, size_t nx, const float *h, const float *g, size_t nh, fvec &a, fvec &d)
+    /**
+     * One level of the decomposition (symmetric padding, the PyWavelet default)
+     * @param x Input, may be the same buffer as a
+     * @param nx Input length
+     * @param filter Decomposition filters
+     * @param x_padded Buffer of nx + 2 * filter->size - 2 elements
+     * @param a Approximation coefficients out
+     * @param d Detail coefficients out
+     * @returns Number of coefficients in a and d
+     */
+    static size_t dwt(const float *x, size_t nx, const filter_t *filter, float *x_padded, float *a, float *d)
     {
-        assert(nh <= 20 && nh > 0 && nx > 0);
-        size_t nx_padded = nx + nh * 2 - 2;
-        fvec x_padded(nx_padded);
+        const size_t nh = filter->size;
 
-        // symmetric padding (default in PyWavelet)
         for (size_t i = 0; i < nh - 2; i++)
             x_padded[i] = x[nh - 3 - i];
         for (size_t i = 0; i < nx; i++)
@@ -232,74 +317,81 @@ class wavelet {
             x_padded[i + nx + nh - 2] = x[nx - 1 - i];
 
         size_t ny = (nx + nh - 1) / 2;
-        a.resize(ny);
-        d.resize(ny);
 
         // decimate and filter
-        const float *xx = x_padded.data();
         for (size_t i = 0; i < ny; i++) {
-            a[i] = dot(xx + 2 * i, h, nh);
-            d[i] = dot(xx + 2 * i, g, nh);
+            a[i] = dot(x_padded + 2 * i, filter->h, nh);
+            d[i] = dot(x_padded + 2 * i, filter->g, nh);
         }
 
-        numpy::underflow_handling(d.data(), d.size());
-        numpy::underflow_handling(a.data(), a.size());
-    }
+        numpy::underflow_handling(d, ny);
+        numpy::underflow_handling(a, ny);
 
-    static void extract_features(fvec& y, fvec &features)
-    {
-        matrix_t x(1, y.size(), const_cast<float *>(y.data()));
-        matrix_t out(1, 1);
-        if (numpy::mean(&x, &out) != EIDSP_OK)
-            assert(0);
-        float mean = out.get_row_ptr(0)[0];
-
-        calculate_entropy(y, features);
-        calculate_crossings(y, features, mean);
-        calculate_statistics(y, features, mean);
+        return ny;
     }
 
-    static void
-    wavedec_features(const float *x, int len, const char *wav, int level, fvec &features)
+    /**
+     * Multi-level decomposition of one axis, features are written in python
+     * order (approximation first, then the details from the deepest level up)
+     * @param x Signal
+     * @param len Signal length
+     * @param filter Decomposition filters
+     * @param level Decomposition depth
+     * @param workspace Buffer of get_workspace_size() elements
+     * @param features Output, (level + 1) * NUM_FEATHERS_PER_COMP values
+     */
+    static void wavedec_features(
+        const float *x,
+        size_t len,
+        const filter_t *filter,
+        int level,
+        float *workspace,
+        float *features)
     {
-        assert(level > 0 && level < 8);
-
-        fvec h;
-        fvec g;
-        find_filter(wav, h, g);
+        // first level output is the largest, all later levels fit in the same buffers
+        // (x_padded doubles as the percentile scratch once a level is done)
+        const size_t ny = (len + filter->size - 1) / 2;
+        float *x_padded = workspace;
+        float *a = x_padded + len + 2 * filter->size - 2;
+        float *d = a + ny;
 
-        features.clear();
-        fvec a;
-        fvec d;
-        dwt(x, len, h.data(), g.data(), h.size(), a, d);
-        extract_features(d, features);
+        size_t n = dwt(x, len, filter, x_padded, a, d);
+        extract_features(d, n, x_padded, features + level * NUM_FEATHERS_PER_COMP);
 
         for (int l = 1; l < level; l++) {
-            dwt(a.data(), a.size(), h.data(), g.data(), h.size(), a, d);
-            extract_features(d, features);
+            n = dwt(a, n, filter, x_padded, a, d);
+            extract_features(d, n, x_padded, features + (level - l) * NUM_FEATHERS_PER_COMP);
         }
 
-        extract_features(a, features);
-
-        for (int l = 0; l <= level / 2; l++) { // reverse order to match python results.
-            for (int i = 0; i < (int)NUM_FEATHERS_PER_COMP; i++) {
-                std::swap(
-                    features[l * NUM_FEATHERS_PER_COMP + i],
-                    features[(level - l) * NUM_FEATHERS_PER_COMP + i]);
-            }
-        }
+        extract_features(a, n, x_padded, features);
     }
 
-    static int dwt_features(const float *x, int len, const char *wav, int level, fvec &features)
+    static size_t get_workspace_size(size_t len, size_t filter_size)
     {
-        assert(level <= 7);
+        return (len + 2 * filter_size - 2) + 2 * ((len + filter_size - 1) / 2);
+    }
 
-        assert(features.size() == 0); // make sure features is empty
-        features.reserve((level + 1) * NUM_FEATHERS_PER_COMP);
+    struct workspace_t {
+        float *buffer;
+        size_t size;
+    };
 
-        wavedec_features(x, len, wav, level, features);
+    static workspace_t *workspace(void)
+    {
+        static workspace_t ws = { nullptr, 0 };
+        return &ws;
+    }
 
-        return features.size();
+    static float *reserve_workspace(size_t size)
+    {
+        workspace_t *ws = workspace();
+        if (ws->size >= size) {
+            return ws->buffer;
+        }
+        release_workspace();
+        ws->buffer = (float *)ei_malloc(size * sizeof(float));
+        ws->size = ws->buffer ? size : 0;
+        return ws->buffer;
     }
 
     static bool check_min_size(int len, int level)
@@ -309,6 +401,48 @@ class wavelet {
     }
 
 public:
+    /**
+     * Allocate the DWT workspace for a config up front, extract_wavelet_features()
+     * reserves it on first use otherwise. The workspace is kept between calls (sized
+     * for the largest config seen) until release_workspace().
+     * @param config Spectral analysis config (wavelet)
+     * @param len Number of samples per axis
+     * @returns EIDSP_OK if OK
+     */
+    static int reserve_workspace(ei_dsp_config_spectral_analysis_t *config, size_t len)
+    {
+        filter_t filter;
+        if (!find_filter(config->wavelet, &filter)) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+        if (!reserve_workspace(get_workspace_size(len, filter.size))) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+        return EIDSP_OK;
+    }
+
+    /**
+     * The DWT workspace that is currently reserved
+     * @param size Set to the number of floats in it
+     * @returns The workspace, nullptr if there is none
+     */
+    static const float *get_workspace(size_t *size)
+    {
+        *size = workspace()->size;
+        return workspace()->buffer;
+    }
+
+    /**
+     * Free the DWT workspace (run_classifier_deinit calls this)
+     */
+    static void release_workspace(void)
+    {
+        workspace_t *ws = workspace();
+        ei_free(ws->buffer);
+        ws->buffer = nullptr;
+        ws->size = 0;
+    }
+
     static int extract_wavelet_features(
         matrix_t *input_matrix,
         matrix_t *output_matrix,
@@ -344,26 +478,38 @@ public:
 
         EI_TRY(processing::subtract_mean(input_matrix));
 
-        int out_idx = 0;
-        for (size_t row = 0; row < input_matrix->rows; row++) {
-            float *data_window = input_matrix->get_row_ptr(row);
-            size_t data_size = input_matrix->cols;
+        if (config->wavelet_level < 1 || config->wavelet_level > 7) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
 
-            if (!check_min_size(data_size, config->wavelet_level))
-                EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
+        if (!check_min_size(input_matrix->cols, config->wavelet_level)) {
+            EIDSP_ERR(EIDSP_BUFFER_SIZE_MISMATCH);
+        }
 
-            fvec features;
-            size_t num_features = dwt_features(
-                data_window,
-                data_size,
-                config->wavelet,
-                config->wavelet_level,
-                features);
+        const size_t features_per_axis = (config->wavelet_level + 1) * NUM_FEATHERS_PER_COMP;
+        if (output_matrix->rows * output_matrix->cols != input_matrix->rows * features_per_axis) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
 
-            assert(num_features == output_matrix->cols / input_matrix->rows);
-            for (size_t i = 0; i < num_features; i++) {
-                output_matrix->buffer[out_idx++] = features[i];
-            }
+        filter_t filter;
+        if (!find_filter(config->wavelet, &filter)) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
+        // one workspace for all levels and axes, kept for the next window
+        float *workspace = reserve_workspace(get_workspace_size(input_matrix->cols, filter.size));
+        if (!workspace) {
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
+
+        for (size_t row = 0; row < input_matrix->rows; row++) {
+            wavedec_features(
+                input_matrix->get_row_ptr(row),
+                input_matrix->cols,
+                &filter,
+                config->wavelet_level,
+                workspace,
+                output_matrix->buffer + row * features_per_axis);
         }
         return EIDSP_OK;
     }
@@ -193,6 +193,73 @@ public:
         return static_cast<int>(floor((fft_size + 1) * hertz / sampling_freq));
     }
 
+    /**
+     * Power spectrum bins of the mel filter edges (left, middle, right of every
+     * filter, num_filters + 2 in total), as mfe() uses them
+     * @param mels Scratch for num_filters + 2 floats, the bins are written over it
+     * @param sampling_frequency In Hz
+     * @param num_filters Number of filters
+     * @param fft_length Number of FFT points
+     * @param low_frequency Lowest band edge, in Hz (0 is 300 Hz before version 4)
+     * @param high_frequency Highest band edge, in Hz (0 is samplerate/2)
+     * @param version Implementation version of the DSP block
+     * @returns The bins, aliasing mels
+     */
+    static uint16_t *calculate_mel_bins(float *mels, uint32_t sampling_frequency,
+        uint16_t num_filters, uint16_t fft_length, uint32_t low_frequency, uint32_t high_frequency,
+        uint16_t version)
+    {
+        if (high_frequency == 0) {
+            high_frequency = sampling_frequency / 2;
+        }
+
+        if (version<4) {
+            if (low_frequency == 0) {
+                low_frequency = 300;
+            }
+        }
+
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+        // Computing the Mel filterbank
+        // converting the upper and lower frequencies to Mels.
+        // num_filter + 2 is because for num_filter filterbanks we need
+        // num_filter+2 point.
+        const int MELS_SIZE = num_filters + 2;
+        uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
+
+        numpy::linspace(
+            functions::frequency_to_mel(static_cast<float>(low_frequency)),
+            functions::frequency_to_mel(static_cast<float>(high_frequency)),
+            num_filters + 2,
+            mels);
+
+        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
+        // go to -1 size b/c special handling, see after
+        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
+            mels[ix] = functions::mel_to_frequency(mels[ix]);
+            if (mels[ix] < low_frequency) {
+                mels[ix] = low_frequency;
+            }
+            if (mels[ix] > high_frequency) {
+                mels[ix] = high_frequency;
+            }
+            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
+        }
+
+        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
+        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
+        // thus calculating the bucket to 64, not 65.
+        // we're adjusting this here a tiny bit to ensure we have the same result
+        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
+        if (mels[MELS_SIZE-1] > high_frequency) {
+            mels[MELS_SIZE-1] = high_frequency;
+        }
+        mels[MELS_SIZE-1] -= 0.001;
+        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
+
+        return bins;
+    }
+
     /**
      * Compute Mel-filterbank energy features from an audio signal.
      * @param out_features Use `calculate_mfe_buffer_size` to allocate the right matrix.
@@ -223,16 +290,6 @@ public:
     {
         int ret = 0;
 
-        if (high_frequency == 0) {
-            high_frequency = sampling_frequency / 2;
-        }
-
-        if (version<4) {
-            if (low_frequency == 0) {
-                low_frequency = 300;
-            }
-        }
-
         stack_frames_info_t stack_frame_info = { 0 };
         stack_frame_info.signal = signal;
 
@@ -248,7 +305,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frame_count != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -257,7 +314,7 @@ public:
         }
 
         if (out_energies) {
-            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
+            if (stack_frame_info.frame_count != out_energies->rows || out_energies->cols != 1) {
                 EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
             }
         }
@@ -267,47 +324,14 @@ public:
         }
 
         const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
-        // Computing the Mel filterbank
-        // converting the upper and lower frequencies to Mels.
-        // num_filter + 2 is because for num_filter filterbanks we need
-        // num_filter+2 point.
         float *mels;
         const int MELS_SIZE = num_filters + 2;
         const size_t mem_size = MELS_SIZE * sizeof(float);
         mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
         EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
         ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
-        uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
-
-        numpy::linspace(
-            functions::frequency_to_mel(static_cast<float>(low_frequency)),
-            functions::frequency_to_mel(static_cast<float>(high_frequency)),
-            num_filters + 2,
-            mels);
-
-        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
-        // go to -1 size b/c special handling, see after
-        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
-            mels[ix] = functions::mel_to_frequency(mels[ix]);
-            if (mels[ix] < low_frequency) {
-                mels[ix] = low_frequency;
-            }
-            if (mels[ix] > high_frequency) {
-                mels[ix] = high_frequency;
-            }
-            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
-        }
-
-        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
-        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
-        // thus calculating the bucket to 64, not 65.
-        // we're adjusting this here a tiny bit to ensure we have the same result
-        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
-        if (mels[MELS_SIZE-1] > high_frequency) {
-            mels[MELS_SIZE-1] = high_frequency;
-        }
-        mels[MELS_SIZE-1] -= 0.001;
-        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
+        uint16_t *bins = calculate_mel_bins(mels, sampling_frequency, num_filters, fft_length,
+            low_frequency, high_frequency, version);
 
         EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
         if (!power_spectrum_frame.buffer) {
@@ -317,20 +341,23 @@ public:
         // get signal data from the audio file
         EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
 
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
             // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
             size_t signal_length = stack_frame_info.frame_length;
             if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
                 signal_length = signal_length -
                     (stack_frame_info.signal->total_length - (signal_offset + signal_length));
             }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
+            {
+                EI_PROFILE_SCOPE("framing");
+                ret = stack_frame_info.signal->get_data(
+                    signal_offset,
+                    signal_length,
+                    signal_frame.buffer
+                );
+            }
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
@@ -356,6 +383,7 @@ public:
                 out_energies->buffer[ix] = energy;
             }
 
+            EI_PROFILE_SCOPE("filterbank");
             auto row_ptr = out_features->get_row_ptr(ix);
             for (size_t i = 0; i < num_filters; i++) {
                 size_t left = bins[i];
@@ -448,7 +476,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frame_count != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -457,7 +485,7 @@ public:
         }
 
         if (out_energies) {
-            if (stack_frame_info.frame_ixs.size() != out_energies->rows || out_energies->cols != 1) {
+            if (stack_frame_info.frame_count != out_energies->rows || out_energies->cols != 1) {
                 EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
             }
         }
@@ -484,7 +512,7 @@ public:
         if (ret != 0) {
             EIDSP_ERR(ret);
         }
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
             size_t power_spectrum_frame_size = (fft_length / 2 + 1);
 
             EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
@@ -496,18 +524,21 @@ public:
             EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
 
             // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
             size_t signal_length = stack_frame_info.frame_length;
             if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
                 signal_length = signal_length -
                     (stack_frame_info.signal->total_length - (signal_offset + signal_length));
             }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
+            {
+                EI_PROFILE_SCOPE("framing");
+                ret = stack_frame_info.signal->get_data(
+                    signal_offset,
+                    signal_length,
+                    signal_frame.buffer
+                );
+            }
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
@@ -534,6 +565,7 @@ public:
             }
 
             // calculate the out_features directly here
+            EI_PROFILE_SCOPE("filterbank");
             ret = numpy::dot_by_row(
                 ix,
                 power_spectrum_frame.buffer,
@@ -588,7 +620,7 @@ public:
             EIDSP_ERR(ret);
         }
 
-        if (stack_frame_info.frame_ixs.size() != out_features->rows) {
+        if (stack_frame_info.frame_count != out_features->rows) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
 
@@ -602,23 +634,26 @@ public:
             *(out_features->buffer + i) = 0;
         }
 
-        for (size_t ix = 0; ix < stack_frame_info.frame_ixs.size(); ix++) {
+        for (size_t ix = 0; ix < stack_frame_info.frame_count; ix++) {
             // get signal data from the audio file
             EI_DSP_MATRIX(signal_frame, 1, stack_frame_info.frame_length);
 
             // don't read outside of the audio buffer... we'll automatically zero pad then
-            size_t signal_offset = stack_frame_info.frame_ixs.at(ix);
+            size_t signal_offset = ix * stack_frame_info.frame_stride;
             size_t signal_length = stack_frame_info.frame_length;
             if (signal_offset + signal_length > stack_frame_info.signal->total_length) {
                 signal_length = signal_length -
                     (stack_frame_info.signal->total_length - (signal_offset + signal_length));
             }
 
-            ret = stack_frame_info.signal->get_data(
-                signal_offset,
-                signal_length,
-                signal_frame.buffer
-            );
+            {
+                EI_PROFILE_SCOPE("framing");
+                ret = stack_frame_info.signal->get_data(
+                    signal_offset,
+                    signal_length,
+                    signal_frame.buffer
+                );
+            }
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
@@ -757,28 +792,27 @@ public:
 
         // ok... now we need to calculate the MFCC from this...
         // first do log() over all features...
-        ret = numpy::log(&features_matrix);
+        {
+            EI_PROFILE_SCOPE("log");
+            ret = numpy::log(&features_matrix);
+        }
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
 
-        // now do DST type 2
-        ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
+        // now do DCT type 2, only for the coefficients that we keep
+        {
+            EI_PROFILE_SCOPE("dct");
+            ret = numpy::dct2_truncated(&features_matrix, out_features, DCT_NORMALIZATION_ORTHO);
+        }
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
 
         // replace first cepstral coefficient with log of frame energy for DC elimination
         if (dc_elimination) {
-            for (size_t row = 0; row < features_matrix.rows; row++) {
-                features_matrix.buffer[row * features_matrix.cols] = numpy::log(energy_matrix.buffer[row]);
-            }
-        }
-
-        // copy to the output...
-        for (size_t row = 0; row < features_matrix.rows; row++) {
-            for(int i = 0; i < num_cepstral; i++) {
-                *(out_features->buffer + (num_cepstral * row) + i) = *(features_matrix.buffer + (features_matrix.cols * row) + i);
+            for (size_t row = 0; row < out_features->rows; row++) {
+                out_features->buffer[row * out_features->cols] = numpy::log(energy_matrix.buffer[row]);
             }
         }
 
@@ -36,10 +36,11 @@
 namespace ei {
 namespace speechpy {
 
-// one stack frame returned by stack_frames
+// frames returned by stack_frames, frame ix starts at (ix * frame_stride) in the signal
 typedef struct ei_stack_frames_info {
     signal_t *signal;
-    ei_vector<uint32_t> frame_ixs;
+    size_t frame_count;
+    size_t frame_stride;
     int frame_length;
 } stack_frames_info_t;
 
@@ -63,10 +64,19 @@ public:
                 _shift = signal->total_length + shift;
             }
 
+            _buffer = nullptr;
+            _buffer_size = 0;
+
             if (!_prev_buffer || !_end_of_signal_buffer) return;
 
             // we need to get the shift bytes from the end of the buffer...
             signal->get_data(signal->total_length - shift, shift, _end_of_signal_buffer);
+
+            // short signals are read once, frames are then preemphasized out of this
+            // buffer (overlapping frames don't hit the signal again)
+            if (signal->total_length <= EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES) {
+                fill_buffer();
+            }
         }
 
         /**
@@ -83,7 +93,27 @@ public:
                 EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
             }
 
+            EI_PROFILE_SCOPE("preemphasis");
+
             int ret;
+            if (_buffer) {
+                const size_t shift = static_cast<size_t>(_shift);
+                for (size_t ix = 0; ix < length; ix++) {
+                    const size_t pos = offset + ix;
+                    const float prev = pos < shift ? _end_of_signal_buffer[pos] : static_cast<float>(_buffer[pos - shift]);
+                    out_buffer[ix] = static_cast<float>(_buffer[pos]) - (_cof * prev);
+                }
+
+                if (_rescale) {
+                    matrix_t scale_matrix(length, 1, out_buffer);
+                    ret = numpy::scale(&scale_matrix, 1.0f / 32768.0f);
+                    if (ret != 0) {
+                        EIDSP_ERR(ret);
+                    }
+                }
+                return EIDSP_OK;
+            }
+
             if (static_cast<int32_t>(offset) - _shift >= 0) {
                 ret = _signal->get_data(offset - _shift, _shift, _prev_buffer);
                 if (ret != 0) {
@@ -138,14 +168,61 @@ public:
             if (_end_of_signal_buffer) {
                 ei_dsp_free(_end_of_signal_buffer, _shift * sizeof(float));
             }
+            if (_buffer) {
+                ei_dsp_free(_buffer, _buffer_size * sizeof(int16_t));
+            }
         }
 
 private:
+        /**
+         * Read the complete signal into an int16 buffer. Audio signals hold int16
+         * values, so the samples are stored exactly and get_data() computes the same
+         * floats as the lazy path. Falls back to the lazy path if the signal holds
+         * anything else, or if this fails.
+         */
+        void fill_buffer() {
+            const size_t length = _signal->total_length;
+            if (length == 0 || _shift <= 0 || static_cast<size_t>(_shift) > length) {
+                return;
+            }
+
+            _buffer = (int16_t*)ei_dsp_malloc(length * sizeof(int16_t));
+            if (!_buffer) {
+                return;
+            }
+            _buffer_size = length;
+
+            float chunk[64];
+            for (size_t offset = 0; offset < length; offset += 64) {
+                const size_t n = std::min(length - offset, (size_t)64);
+                if (_signal->get_data(offset, n, chunk) != 0) {
+                    release_buffer();
+                    return;
+                }
+                for (size_t ix = 0; ix < n; ix++) {
+                    const int16_t sample = static_cast<int16_t>(chunk[ix]);
+                    if (!(chunk[ix] >= -32768.0f && chunk[ix] <= 32767.0f) || static_cast<float>(sample) != chunk[ix]) {
+                        release_buffer();
+                        return;
+                    }
+                    _buffer[offset + ix] = sample;
+                }
+            }
+        }
+
+        void release_buffer() {
+            ei_dsp_free(_buffer, _buffer_size * sizeof(int16_t));
+            _buffer = nullptr;
+            _buffer_size = 0;
+        }
+
         ei_signal_t *_signal;
         int _shift;
         float _cof;
         float *_prev_buffer;
         float *_end_of_signal_buffer;
+        int16_t *_buffer;           // the signal, nullptr when reading lazily
+        size_t _buffer_size;
         size_t _next_offset_should_be;
         bool _rescale;
     };
@@ -296,6 +373,10 @@ namespace processing {
             length = (frame_sample_length - (int)frame_stride);
         }
 
+        if (frame_stride < 1.0f) {
+            EIDSP_ERR(EIDSP_PARAMETER_INVALID);
+        }
+
         volatile int numframes;
         volatile int len_sig;
 
@@ -318,17 +399,12 @@ namespace processing {
             info->signal->total_length = static_cast<size_t>(len_sig);
         }
 
-        info->frame_ixs.clear();
-        info->frame_ixs.reserve(numframes); //limit the memory allocation
-
-        int frame_count = 0;
-
-        for (size_t ix = 0; ix < static_cast<uint32_t>(len_sig); ix += static_cast<size_t>(frame_stride)) {
-            if (++frame_count > numframes) break;
-
-            info->frame_ixs.push_back(ix);
-        }
+        // frame starts are ix * stride, for every start that lies within len_sig
+        const size_t stride = static_cast<size_t>(frame_stride);
+        size_t frames_in_signal = len_sig > 0 ? (static_cast<size_t>(len_sig) + stride - 1) / stride : 0;
 
+        info->frame_count = numframes > 0 ? std::min(static_cast<size_t>(numframes), frames_in_signal) : 0;
+        info->frame_stride = stride;
         info->frame_length = frame_sample_length;
 
         return EIDSP_OK;
@@ -404,6 +480,8 @@ namespace processing {
             return EIDSP_OK;
         }
 
+        EI_PROFILE_SCOPE("cmvn");
+
         uint16_t pad_size = (win_size - 1) / 2;
 
         int ret;
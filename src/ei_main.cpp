@@ -68,6 +68,8 @@ void fill_memory(void)
 /* Public functions -------------------------------------------------------- */
 void ei_main_init(void) 
 {
+    ei_serial_tx_setup();
+
     EiDevicePortenta *dev = static_cast<EiDevicePortenta*>(EiDeviceInfo::get_device());
     ei_sleep(500);
 
@@ -76,6 +78,7 @@ void ei_main_init(void)
               "Compiled on %s %s\r\n", __DATE__, __TIME__);
 
     at = ei_at_init(dev);   // init at handlers
+    run_nn_model_init();    // reserve the model slots and load a stored model (EI_CLASSIFIER_LOADABLE_MODEL)
     ei_printf("Type AT+HELP to see a list of commands.\r\n");
     at->print_prompt();
 
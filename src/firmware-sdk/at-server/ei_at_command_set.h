@@ -44,7 +44,7 @@
  * If you are adding or modifying OPTIONAL commands,
  * just upgrade the release version.
  */
-#define AT_COMMAND_VERSION "1.8.0"
+#define AT_COMMAND_VERSION "1.10.2"
 
 /*************************************************************************************************/
 /* Required commands by Edge Impulse CLI Tools        */
@@ -86,7 +86,10 @@
 #define AT_RUNIMPULSEDEBUG_ARGS      "USEMAXRATE"
 #define AT_RUNIMPULSEDEBUG_HELP_TEXT "Run the impulse with additional debug output or live preview"
 #define AT_RUNIMPULSECONT            "RUNIMPULSECONT"
-#define AT_RUNIMPULSECONT_HELP_TEXT  "Run the impulse continuously"
+#define AT_RUNIMPULSECONT_ARGS       "TEXT|BINARY"
+#define AT_RUNIMPULSECONT_HELP_TEXT  "Run the impulse continuously (BINARY: framed result records, see ei_result_stream.h)"
+#define AT_RUNIMPULSEMULTI           "RUNIMPULSEMULTI"
+#define AT_RUNIMPULSEMULTI_HELP_TEXT "Run all scheduled impulses continuously on the microphone stream"
 #define AT_RUNIMPULSESTATIC          "RUNIMPULSESTATIC"
 #define AT_RUNIMPULSESTATIC_ARGS     "DEBUG,LENGTH"
 #define AT_RUNIMPULSESTATIC_HELP_TEXT "Run the impulse on static data (base64 encoded)"
@@ -126,6 +129,26 @@
 #define AT_BOOTMODE_HELP_TEXT       "Jump to bootloader"
 #define AT_INFO                     "INFO"
 #define AT_INFO_HELP_TEXT           "Prints details about compiled firmware and ML model"
+#define AT_ARENA                    "ARENA"
+#define AT_ARENA_HELP_TEXT          "Prints the NN tensor arena layout (as JSON)"
+#define AT_FUSIONSTATS              "FUSIONSTATS"
+#define AT_FUSIONSTATS_HELP_TEXT    "Prints the counters of the last sensor fusion sampling run"
+#define AT_STATS                    "STATS"
+#define AT_STATS_ARGS               "RESET|JSON"
+#define AT_STATS_HELP_TEXT          "Prints inference latency histograms and counters (read: as JSON)"
+#define AT_PROFILE                  "PROFILE"
+#define AT_PROFILE_ARGS             "TREE|FLAT|RESET"
+#define AT_PROFILE_HELP_TEXT        "Prints the DSP and NN profiler zones (needs EI_PROFILER=1)"
+#define AT_BENCHKERNELS             "BENCHKERNELS"
+#define AT_BENCHKERNELS_ARGS        "MODELONLY"
+#define AT_BENCHKERNELS_HELP_TEXT   "Benchmarks the int8 NN kernels against the reference kernels"
+#define AT_MODEL                    "MODEL"
+#define AT_MODEL_HELP_TEXT          "Prints the running model and the model slots"
+#define AT_MODELUPLOAD              "MODELUPLOAD"
+#define AT_MODELUPLOAD_ARGS         "LENGTH"
+#define AT_MODELUPLOAD_HELP_TEXT    "Upload a model container (base64 encoded) and run it"
+#define AT_MODELROLLBACK            "MODELROLLBACK"
+#define AT_MODELROLLBACK_HELP_TEXT  "Erase the running model slot and go back to the previous model"
 
 /*************************************************************************************************/
 /* HELP is not necessary as it is built-in into ATServer and
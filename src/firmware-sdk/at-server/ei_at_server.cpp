@@ -138,7 +138,9 @@ bool ATServer::register_command(
     ATCommand_t temp_cmd;
 
     temp_cmd.command = cmd;
-    temp_cmd.help_text = help_text;
+    if (help_text != nullptr) {
+        temp_cmd.help_text = string(help_text);
+    }
     temp_cmd.run_handler = run_handler;
     temp_cmd.read_handler = read_handler;
     temp_cmd.write_handler = write_handler;
@@ -37,6 +37,7 @@
 #include "ei_device_info_lib.h"
 #include "ei_device_memory.h"
 #include "ei_device_interface.h"
+#include "ei_serial_tx.h"
 
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/classifier/ei_signal_with_axes.h"
@@ -149,6 +150,7 @@ bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
                 data_pt = NULL;
                 temp_buf = NULL;
                 ei_printf("END OUTPUT\r\n");
+                ei_serial_tx_flush();
                 return false;
             }
             uint8_t rec = ei_getchar();
@@ -179,6 +181,7 @@ bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
     temp_buf = NULL;
     ei_printf("RESULT %d\r\n", res);
     ei_printf("END OUTPUT\r\n");
+    ei_serial_tx_flush();
 
     return true;
 }
@@ -91,6 +91,12 @@ protected:
      *
      */
     uint32_t memory_size;
+    /**
+     * @brief number of blocks at the end of the memory taken out of the sample area,
+     * see reserve_blocks
+     *
+     */
+    uint32_t reserved_blocks;
 
 public:
     /**
@@ -121,6 +127,7 @@ public:
         uint32_t block_size)
         : memory_blocks(block_size == 0 ? 0 : memory_size / block_size)
         , memory_size(memory_size)
+        , reserved_blocks(0)
         , block_size(block_size)
         , block_erase_time(erase_time)
     {
@@ -143,12 +150,35 @@ public:
 
     virtual uint32_t get_available_sample_blocks(void)
     {
-        return memory_blocks - used_blocks;
+        return memory_blocks - used_blocks - reserved_blocks;
     }
 
     virtual uint32_t get_available_sample_bytes(void)
     {
-        return (memory_blocks - used_blocks) * block_size;
+        return (memory_blocks - used_blocks - reserved_blocks) * block_size;
+    }
+
+    /**
+     * @brief Take blocks at the end of the memory out of the sample area, so samples
+     * never overwrite them (e.g. the model slots of EiModelStore). Call at boot, before
+     * sampling, the reservation is not stored.
+     *
+     * @param num_blocks number of blocks to reserve
+     * @param address set to the address of the first reserved block, relative to the
+     * sample area like the addresses of read_sample_data / write_sample_data
+     * @return true if there were enough free blocks
+     */
+    virtual bool reserve_blocks(uint32_t num_blocks, uint32_t *address)
+    {
+        // keep at least one block for samples
+        if (num_blocks == 0 || num_blocks >= get_available_sample_blocks()) {
+            return false;
+        }
+
+        reserved_blocks += num_blocks;
+        *address = get_available_sample_blocks() * block_size;
+
+        return true;
     }
 
     virtual bool save_config(const uint8_t *config, uint32_t config_size)
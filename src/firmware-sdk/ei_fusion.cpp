@@ -45,6 +45,7 @@
 #include <vector>
 #include <cfloat>
 #include <algorithm>
+#include <atomic>
 
 // offset for unknown header size (can be 0-3)
 #define CBOR_HEADER_OFFSET 0x02
@@ -68,17 +69,57 @@ vector<fused_sensors_t> fused_sensors;
 static vector<ei_device_fusion_sensor_t *> fusion_sensors;
 int num_fusions, num_fusion_axis;
 #if MULTI_FREQ_ENABLED == 1
-#define MULTI_FREQ_MAX_FREQ_NOT_SET     (-1.0f)
-
 #ifndef MULTI_FREQ_MAX_INC_FACTOR
 #define MULTI_FREQ_MAX_INC_FACTOR       (10)
 #endif
 
-static float multi_sampling_freq[NUM_MAX_FUSIONS];
-static float multi_freq_combination[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES];
-static fusion_sample_format_t* old_data;    // store old samples for multi
+/*
+** @brief state of the multi frequency plan search, frequencies in mHz
+*/
+typedef struct {
+    uint8_t n;
+    uint8_t count[NUM_MAX_FUSIONS];
+    uint32_t freq_mhz[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES];
+    uint8_t choice[NUM_MAX_FUSIONS];
+    uint64_t allowed_mhz;       // highest tick of a combination where all frequencies divide each other, 0 if none
+    bool below_threshold;       // a plan under MULTI_FREQ_MAX_INC_FACTOR was found, bound on memory from here on
+    vector<ei_fusion_plan_t> *plans;
+} multi_freq_search_t;
+
+static ei_fusion_plan_t multi_plan;
+static uint32_t multi_tick; // position in the read schedule of multi_plan
+static fusion_sample_format_t fusion_last_values[EI_MAX_SENSOR_AXES]; // last samples for multi
+static uint64_t fusion_last_read_us[NUM_MAX_FUSIONS];
 #endif
 
+/*
+** @brief which sensor axes end up in a fused frame, built once in ei_connect_fusion_list
+*/
+typedef struct {
+    uint8_t count;
+    uint8_t axis[EI_MAX_SENSOR_AXES];
+} fusion_gather_t;
+
+/*
+** @brief one fused sample, as read in a sample tick
+*/
+typedef struct {
+    uint64_t timestamp_us;
+    uint64_t sensor_timestamp_us[NUM_MAX_FUSIONS]; // tick in which each sensor was (last) read
+    bool has_data; // false for a multi frequency tick where no sensor was due
+    fusion_sample_format_t data[EI_MAX_SENSOR_AXES];
+} fusion_frame_t;
+
+static fusion_gather_t fusion_gather[NUM_MAX_FUSIONS];
+static fusion_frame_t fusion_ring[EI_FUSION_RING_FRAMES];
+// single producer (sample tick) / single consumer (ei_fusion_drain), free running counters
+static std::atomic<uint32_t> fusion_ring_head;
+static std::atomic<uint32_t> fusion_ring_tail;
+static volatile bool fusion_sampling_done;
+static uint64_t fusion_last_tick_us;
+static uint32_t fusion_expected_interval_us;
+static ei_fusion_stats_t fusion_stats;
+
 /* Private function prototypes --------------------------------------------- */
 static void print_fusion_list(int r, uint32_t ingest_memory_size);
 static void print_all_combinations(
@@ -92,11 +133,20 @@ static int generate_bit_flags(int dec);
 static bool add_sensor(int sensor_ix, char *name_buffer);
 static bool add_axis(int sensor_ix, char *name_buffer);
 static float highest_frequency(float *frequencies, size_t size);
+static bool build_gather_maps(void);
+static void fusion_ring_reset(float sample_interval_ms);
+static fusion_frame_t *fusion_ring_claim(void);
+static void fusion_ring_commit(fusion_frame_t *frame);
 #if MULTI_FREQ_ENABLED == 1
-static float calc_gcd(float time1, float time2);
-static void get_multi_freq_combinations(int row, int col, float* mat_period, float* actual_comb, int ix, vector<float>* freq_comb, vector<int>* mem_fact, float allowed_period);
-static void clean_multi_freq_combinations(int n, int col, float* mat_period, float* actual_comb, int ix, float* actual_max);
+static uint64_t calc_gcd(uint64_t num1, uint64_t num2);
+static uint32_t freq_to_mhz(float freq);
+static void build_multi_plan(ei_fusion_plan_t *plan, uint8_t how_many, uint64_t tick_mhz);
+static void find_max_chain_freq(multi_freq_search_t *search, uint8_t ix, uint64_t max_mhz);
+static uint32_t multi_freq_mem_bound(multi_freq_search_t *search, uint8_t ix, uint64_t lcm_mhz);
+static void search_multi_freq_plans(multi_freq_search_t *search, uint8_t ix, uint64_t lcm_mhz);
+static void add_multi_freq_plan(multi_freq_search_t *search, uint64_t lcm_mhz);
 static bool ei_fusion_calc_optimal_frequencies(uint8_t row, uint8_t col, float freq_objective);
+static void fusion_multi_tick(void);
 #endif
 /**
  * @brief Add sensor to fusion list
@@ -171,55 +221,50 @@ bool ei_connect_fusion_list(const char *input_list, ei_fusion_list_format format
 
     ei_free(input_string);
 
+    if (is_fusion && !build_gather_maps()) {
+        return false;
+    }
+
     return is_fusion;
 }
 
 /**
  * @brief Get sensor data and extract needed sensors
- * Callback function writes data to mem
+ * Data is gathered into the fusion ring and handed to the sampler in batches
  */
 void ei_fusion_read_axis_data(void)
 {
-    EiDeviceInfo* dev = EiDeviceInfo::get_device();
-    fusion_sample_format_t *sensor_data;
-    fusion_sample_format_t *data;
-    uint32_t loc = 0;
+    fusion_frame_t *frame = fusion_ring_claim();
 
-    data = (fusion_sample_format_t *)ei_malloc(sizeof(fusion_sample_format_t) * num_fusion_axis);
-    if (data == NULL) {
-        return;
-    }
+    if (frame != nullptr) {
+        fusion_sample_format_t *data = frame->data;
 
-    for (int i = 0; i < num_fusions; i++) {
+        for (int i = 0; i < num_fusions; i++) {
+            const fusion_gather_t *gather = &fusion_gather[i];
+            fusion_sample_format_t *sensor_data = NULL;
 
-        sensor_data = NULL;
-        if (fusion_sensors[i]->read_data != NULL) {
-            sensor_data = fusion_sensors[i]->read_data(
-                fusion_sensors[i]->num_axis); // read sensor data from sensor file
-        }
+            if (fusion_sensors[i]->read_data != NULL) {
+                sensor_data = fusion_sensors[i]->read_data(
+                    fusion_sensors[i]->num_axis); // read sensor data from sensor file
+            }
+            frame->sensor_timestamp_us[i] = frame->timestamp_us;
 
-        if (sensor_data != NULL) {
-            for (int j = 0; j < fusion_sensors[i]->num_axis; j++) {
-                if (fusion_sensors[i]->axis_flag_used & (1 << j)) {
-                    data[loc++] = *(sensor_data + j); // add sensor data to fusion data
+            if (sensor_data != NULL) {
+                for (int j = 0; j < gather->count; j++) {
+                    data[j] = sensor_data[gather->axis[j]]; // add sensor data to fusion data
                 }
             }
-        }
-        else { // No data, zero fill
-            for (int j = 0; j < fusion_sensors[i]->num_axis; j++) {
-                if (fusion_sensors[i]->axis_flag_used & (1 << j)) {
-                    data[loc++] = 0;
+            else { // No data, zero fill
+                for (int j = 0; j < gather->count; j++) {
+                    data[j] = 0;
                 }
             }
+            data += gather->count;
         }
+        frame->has_data = true;
     }
 
-    if (fusion_cb_sampler(
-            (const void *)&data[0],
-            (sizeof(fusion_sample_format_t) * num_fusion_axis))) // send fusion data to sampler
-        dev->stop_sample_thread(); // if last sample detach
-
-    ei_free(data);
+    fusion_ring_commit(frame);
 }
 
 #if MULTI_FREQ_ENABLED == 1
@@ -229,66 +274,91 @@ void ei_fusion_read_axis_data(void)
  */
 void ei_fusion_multi_read_axis_data(uint8_t flag_read)
 {
-   EiDeviceInfo* dev = EiDeviceInfo::get_device();
-   fusion_sample_format_t *sensor_data;
-   fusion_sample_format_t *data;
-   uint32_t loc = 0;
-
-   if (flag_read != 0) {
-       data = (fusion_sample_format_t *)ei_malloc(sizeof(fusion_sample_format_t) * num_fusion_axis);
-       if (data == NULL) {
-           return;
-       }
-
-       for (int i = 0; i < num_fusions; i++) {
-
-           sensor_data = NULL;
-           if ((fusion_sensors[i]->read_data != NULL)
-                   && ((flag_read & (1 << i)) == (1 << i)) ) {
-               sensor_data = fusion_sensors[i]->read_data(
-                   fusion_sensors[i]->num_axis); // read sensor data from sensor file
-           }
-
-           if (sensor_data != NULL) {
-               for (int j = 0; j < fusion_sensors[i]->num_axis; j++, loc++) {
-                   if (fusion_sensors[i]->axis_flag_used & (1 << j)) {
-                       data[loc] = *(sensor_data + j); // add sensor data to fusion data
-                       if (old_data != nullptr) {
-
-                        old_data[loc] = data[loc];       // store in old structure
-                        }
-                   }
-               }
-           }
-           else { // No data, zero fill
-               for (int j = 0; j < fusion_sensors[i]->num_axis; j++, loc++) {
-                   if (fusion_sensors[i]->axis_flag_used & (1 << j)) {
-                       data[loc] = old_data[loc];       // not sampled, use last value
-                   }
-               }
-           }
-       }
-
-       if (fusion_cb_sampler(
-               (const void *)&data[0],
-               (sizeof(fusion_sample_format_t) * num_fusion_axis))) {
-           dev->stop_sample_thread(); // if last sample detach
-           ei_free(old_data);
-           // send fusion data to sampler
-       }
-
-       ei_free(data);
-   }
-   else {
-       if (fusion_cb_sampler(nullptr, 0)) {
-           dev->stop_sample_thread(); // if last sample detach
-           ei_free(old_data);
-       }
-   }
+    fusion_frame_t *frame = fusion_ring_claim();
+
+    if (frame != nullptr) {
+        frame->has_data = (flag_read != 0);
+
+        if (flag_read != 0) {
+            uint32_t loc = 0;
+
+            for (int i = 0; i < num_fusions; i++) {
+                const fusion_gather_t *gather = &fusion_gather[i];
+                fusion_sample_format_t *sensor_data = NULL;
+
+                if ((fusion_sensors[i]->read_data != NULL)
+                        && ((flag_read & (1 << i)) == (1 << i)) ) {
+                    sensor_data = fusion_sensors[i]->read_data(
+                        fusion_sensors[i]->num_axis); // read sensor data from sensor file
+                    fusion_last_read_us[i] = frame->timestamp_us;
+                }
+
+                if (sensor_data != NULL) {
+                    for (int j = 0; j < gather->count; j++) {
+                        fusion_last_values[loc + j] = sensor_data[gather->axis[j]];
+                    }
+                }
+                // not sampled, keep the last value
+                frame->sensor_timestamp_us[i] = fusion_last_read_us[i];
+                loc += gather->count;
+            }
+
+            memcpy(frame->data, fusion_last_values, sizeof(fusion_sample_format_t) * num_fusion_axis);
+        }
+    }
 
+    fusion_ring_commit(frame);
 }
 #endif
 
+/**
+ * @brief Hand all pending fused frames to the sampler, oldest first.
+ * Called from the sample tick every EI_FUSION_BATCH_FRAMES frames, or by the platform
+ * (from a single thread) when EI_FUSION_BATCH_FRAMES is 0
+ *
+ * @retval number of frames delivered
+ */
+uint32_t ei_fusion_drain(void)
+{
+    EiDeviceInfo* dev = EiDeviceInfo::get_device();
+    uint32_t delivered = 0;
+    uint32_t tail = fusion_ring_tail.load(std::memory_order_relaxed);
+
+    while (!fusion_sampling_done && tail != fusion_ring_head.load(std::memory_order_acquire)) {
+        const fusion_frame_t *frame = &fusion_ring[tail % EI_FUSION_RING_FRAMES];
+        bool last;
+
+        if (frame->has_data) {
+            last = fusion_cb_sampler(
+                (const void *)&frame->data[0],
+                (sizeof(fusion_sample_format_t) * num_fusion_axis)); // send fusion data to sampler
+        }
+        else {
+            last = fusion_cb_sampler(nullptr, 0);
+        }
+
+        // release the slot only once the sampler is done with it
+        fusion_ring_tail.store(++tail, std::memory_order_release);
+        delivered++;
+        fusion_stats.delivered++;
+
+        if (last) {
+            fusion_sampling_done = true;
+            dev->stop_sample_thread(); // if last sample detach
+        }
+    }
+
+    return delivered;
+}
+
+/**
+ * @brief Copy the statistics of the current (or last) sampling run
+ */
+void ei_fusion_get_stats(ei_fusion_stats_t *stats)
+{
+    *stats = fusion_stats;
+}
+
 /**
  * @brief      Wrapper for start_sample_thread
  *
@@ -303,6 +373,8 @@ bool ei_fusion_sample_start(sampler_callback callsampler, float sample_interval_
     fusion_cb_sampler = callsampler; // connect cb sampler (used in ei_fusion_read_data())
     bool started = false;
 
+    fusion_ring_reset(sample_interval_ms);
+
     if (fusion_cb_sampler != nullptr) {
 #if MULTI_FREQ_ENABLED == 1
         if (num_fusions == 1) {
@@ -327,18 +399,24 @@ bool ei_multi_fusion_sample_start(sampler_callback callsampler, float multi_samp
     EiDeviceInfo* dev = EiDeviceInfo::get_device();
     fusion_cb_sampler = callsampler; // connect cb sampler (used in ei_fusion_read_data())
 
-    if ((fusion_cb_sampler == NULL) || (num_fusions < 2)) {   /* */
+    if ((fusion_cb_sampler == NULL) || (num_fusions < 2)) {
         return false;
     }
-    else {
-        if (ei_fusion_calc_optimal_frequencies(num_fusions, EI_MAX_FREQUENCIES, (1000.0f/multi_sample_interval_ms)) == false) {
-            ei_printf("ERR: Unable to calculate the optimal frequency\n");
-            return false;
-        }
-        // TODO calc of optimal frequencies.
-        dev->start_multi_sample_thread(ei_fusion_multi_read_axis_data, multi_sampling_freq, num_fusions); // what about multi_sample_interval_ms ?
-        return true;
+
+    if (ei_fusion_calc_optimal_frequencies(num_fusions, EI_MAX_FREQUENCIES, (1000.0f/multi_sample_interval_ms)) == false) {
+        ei_printf("ERR: Unable to calculate the optimal frequency\n");
+        return false;
     }
+
+    // one sample tick at the plan frequency, the plan schedule says which sensors to read
+    const float tick_ms = 1000000.0f / multi_plan.tick_mhz;
+
+    fusion_ring_reset(tick_ms);
+    memset(fusion_last_values, 0, sizeof(fusion_last_values));
+    memset(fusion_last_read_us, 0, sizeof(fusion_last_read_us));
+    multi_tick = 0;
+
+    return dev->start_sample_thread(fusion_multi_tick, tick_ms);
 }
 #endif
 
@@ -408,9 +486,6 @@ bool ei_fusion_setup_data_sampling(void)
     bool ret = false;
 
 #if MULTI_FREQ_ENABLED == 1
-    old_data = (fusion_sample_format_t *)ei_malloc(sizeof(fusion_sample_format_t) * num_fusion_axis);
-    memset(old_data, 0, sizeof(fusion_sample_format_t) * num_fusion_axis);
-
     if (num_fusions == 1) {
         ret = ei_sampler_start_sampling(
                 &payload,
@@ -424,10 +499,6 @@ bool ei_fusion_setup_data_sampling(void)
                 (sizeof(fusion_sample_format_t) * num_fusion_axis));
     }
 
-    if (ret == false) {
-        ei_free(old_data);  //
-    }
-
 #else
     ret = ei_sampler_start_sampling(
             &payload,
@@ -567,42 +638,19 @@ static void print_all_combinations(
         }
         else {
 #if (MULTI_FREQ_ENABLED == 1)
-            float mat_period[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES] = {{0.0}};
             float mat_freq[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES] = {{0.0}};
-            float combination[NUM_MAX_FUSIONS] = {0.0};
-            float max_freq = MULTI_FREQ_MAX_FREQ_NOT_SET;
-            int starting_ix = 0;
-            const int mem_inc_threshold = MULTI_FREQ_MAX_INC_FACTOR;
-            int how_many_under_threshold = 0;
-
-            vector<float> found_freq_combinations;
-            vector<int> mem_increase_factor;
+            vector<ei_fusion_plan_t> plans;
 
             for (int j = 0; j < r; j++) {                         // per sensors
                 for (int z = 0; z < EI_MAX_FREQUENCIES; z++) {     // per freq
-                    if (fusable_sensor_list[data[j]].frequencies[z] != 0.0) {
-                        mat_period[j][z] = 1.f/fusable_sensor_list[data[j]].frequencies[z];
-                        mat_freq[j][z] = fusable_sensor_list[data[j]].frequencies[z];
-                    }
+                    mat_freq[j][z] = fusable_sensor_list[data[j]].frequencies[z];
                 }
             }
 
-            clean_multi_freq_combinations(r, EI_MAX_FREQUENCIES, (float*)mat_freq, combination, starting_ix, &max_freq);
-            get_multi_freq_combinations(r, EI_MAX_FREQUENCIES, (float*)mat_period, combination, starting_ix, &found_freq_combinations, &mem_increase_factor, max_freq);
-
-            for (size_t j = 0; j < mem_increase_factor.size(); j++) {
-                if (mem_increase_factor.at(j) < mem_inc_threshold) {
-                    how_many_under_threshold++;
-                }
-            }
+            ei_fusion_calc_multi_freq_plans((float*)mat_freq, (uint8_t)r, &plans);
 
-            for (size_t j = 0; j < found_freq_combinations.size(); j++) {
-                if ((how_many_under_threshold > 0) && (mem_increase_factor.at(j) < mem_inc_threshold)) {
-                    sens.frequencies.push_back(found_freq_combinations.at(j));
-                }
-                else if (how_many_under_threshold == 0) {
-                    sens.frequencies.push_back(found_freq_combinations.at(j));
-                }
+            for (size_t j = 0; j < plans.size(); j++) {
+                sens.frequencies.push_back(plans[j].tick_mhz / 1000.f);
             }
 
             if (sens.frequencies.size() > 0) {
@@ -771,231 +819,466 @@ static float highest_frequency(float *frequencies, size_t size)
     }
     return highest;
 }
-#if MULTI_FREQ_ENABLED == 1
 /**
- *
- * @param time1
- * @param time2
- * @return
+ * @brief Precompute which axes of every fused sensor are copied into a frame
+ * @return false if the fused frame does not fit EI_MAX_SENSOR_AXES
  */
-static float calc_gcd(float fnum1, float fnum2)
+static bool build_gather_maps(void)
 {
-    float temp;
-
-    while(1)
-    {
-        if (fnum1 < fnum2)
-        {
-            temp = fnum2;
-            fnum2 = fnum1;
-            fnum1 = temp;
+    int total = 0;
+
+    for (int i = 0; i < num_fusions; i++) {
+        fusion_gather_t *gather = &fusion_gather[i];
+        gather->count = 0;
+
+        for (int j = 0; j < fusion_sensors[i]->num_axis && j < EI_MAX_SENSOR_AXES; j++) {
+            if (fusion_sensors[i]->axis_flag_used & (1 << j)) {
+                gather->axis[gather->count++] = j;
+            }
         }
+        total += gather->count;
+    }
 
-        if (fabs(fnum2) < 0.001)
-        {
-            break;
+    if (total > EI_MAX_SENSOR_AXES || total != num_fusion_axis) {
+        ei_printf("ERR: Too many axes to fuse (%d, max %d)\n", num_fusion_axis, EI_MAX_SENSOR_AXES);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Empty the fusion ring and statistics before a new sampling run
+ * @param sample_interval_ms requested interval between ticks, 0 if not fixed
+ */
+static void fusion_ring_reset(float sample_interval_ms)
+{
+    fusion_ring_head.store(0);
+    fusion_ring_tail.store(0);
+    fusion_sampling_done = false;
+    fusion_last_tick_us = 0;
+    fusion_expected_interval_us = (uint32_t)(sample_interval_ms * 1000.0f);
+    memset(&fusion_stats, 0, sizeof(fusion_stats));
+    fusion_stats.interval_min_us = UINT32_MAX;
+}
+
+/**
+ * @brief Start a new frame: update tick statistics and return the slot to fill
+ * @return nullptr if sampling is done or the ring is full (frame dropped)
+ */
+static fusion_frame_t *fusion_ring_claim(void)
+{
+    if (fusion_sampling_done) {
+        return nullptr;
+    }
+
+    uint64_t now = ei_read_timer_us();
+
+    if (fusion_stats.frames > 0) {
+        uint32_t interval = (uint32_t)(now - fusion_last_tick_us);
+        fusion_stats.interval_min_us = std::min(fusion_stats.interval_min_us, interval);
+        fusion_stats.interval_max_us = std::max(fusion_stats.interval_max_us, interval);
+
+        if (fusion_expected_interval_us > 0) {
+            uint32_t jitter = interval > fusion_expected_interval_us ?
+                interval - fusion_expected_interval_us : fusion_expected_interval_us - interval;
+            fusion_stats.jitter_max_us = std::max(fusion_stats.jitter_max_us, jitter);
+            fusion_stats.jitter_sum_us += jitter;
         }
+    }
+    fusion_last_tick_us = now;
+    fusion_stats.frames++;
 
-        temp = fnum1;
-        fnum1 = fnum2;
-        fnum2 = temp - floor(temp / fnum2) * fnum2;
+    uint32_t head = fusion_ring_head.load(std::memory_order_relaxed);
+    if (head - fusion_ring_tail.load(std::memory_order_acquire) >= EI_FUSION_RING_FRAMES) {
+        fusion_stats.overruns++;
+        return nullptr;
     }
 
-    return fnum1;
+    fusion_frame_t *frame = &fusion_ring[head % EI_FUSION_RING_FRAMES];
+    frame->timestamp_us = now;
+
+    return frame;
 }
 
 /**
- * @brief Get the multi freq combinations object
+ * @brief Publish the frame returned by fusion_ring_claim (if any) and drain a full batch
+ */
+static void fusion_ring_commit(fusion_frame_t *frame)
+{
+    if (fusion_sampling_done) {
+        return;
+    }
+
+    uint32_t head = fusion_ring_head.load(std::memory_order_relaxed);
+    if (frame != nullptr) {
+        fusion_ring_head.store(++head, std::memory_order_release);
+    }
+
+    uint32_t pending = head - fusion_ring_tail.load(std::memory_order_acquire);
+    fusion_stats.max_pending = std::max(fusion_stats.max_pending, pending);
+
+#if EI_FUSION_BATCH_FRAMES > 0
+    if (pending >= EI_FUSION_BATCH_FRAMES) {
+        ei_fusion_drain();
+    }
+#endif
+}
+
+#if MULTI_FREQ_ENABLED == 1
+/**
+ * @brief Greatest common divisor (Euclid)
  *
- * @param n
- * @param mat_period
- * @param actual_comb
- * @param ix
- * @param psens
+ * @param num1
+ * @param num2
+ * @return uint64_t
  */
-static void get_multi_freq_combinations(int n, int col, float* mat_period, float* actual_comb, int ix, vector<float>* freq_comb, vector<int>* mem_fact, float allowed_period)
+static uint64_t calc_gcd(uint64_t num1, uint64_t num2)
 {
-    int i;
+    while (num2 != 0) {
+        uint64_t temp = num1 % num2;
+        num1 = num2;
+        num2 = temp;
+    }
+
+    return num1;
+}
 
-    if (ix == n) {
-        for (i = 0; i < n; i++) {
-            if (actual_comb[i] == 0.0) {
-                return; // make no sense to calc gcd for this combination
+/**
+ * @brief Convert a frequency in Hz to integer mHz
+ *
+ * @param freq
+ * @return uint32_t 0 for a missing (zero) frequency
+ */
+static uint32_t freq_to_mhz(float freq)
+{
+    if (freq <= 0.0f) {
+        return 0;
+    }
+
+    return (uint32_t)(freq * 1000.f + 0.5f);
+}
+
+/**
+ * @brief Fill tick, dividers, memory factor and read schedule of a plan
+ * from its sensor frequencies. Every frequency must divide tick_mhz.
+ *
+ * @param plan
+ * @param how_many number of sensors in the plan
+ * @param tick_mhz
+ */
+static void build_multi_plan(ei_fusion_plan_t *plan, uint8_t how_many, uint64_t tick_mhz)
+{
+    uint64_t freq_gcd = 0;
+    uint32_t mem_sum = 0;
+    bool every_tick = false;
+
+    plan->tick_mhz = (uint32_t)tick_mhz;
+    plan->tick_us = (uint32_t)((1000000000ULL + tick_mhz / 2) / tick_mhz);
+
+    for (uint8_t i = 0; i < how_many; i++) {
+        plan->divider[i] = (uint32_t)(tick_mhz / plan->freq_mhz[i]);
+        freq_gcd = calc_gcd(freq_gcd, plan->freq_mhz[i]);
+        mem_sum += plan->divider[i];
+        every_tick |= (plan->divider[i] == 1);
+    }
+    plan->mem_factor = every_tick ? 1 : mem_sum;
+
+    // the pattern repeats after lcm(dividers) = tick / gcd(frequencies) ticks
+    plan->hyperperiod = (uint32_t)(tick_mhz / freq_gcd);
+
+    memset(plan->schedule, 0, sizeof(plan->schedule));
+    if (plan->hyperperiod <= EI_FUSION_PLAN_MAX_TICKS) {
+        for (uint8_t i = 0; i < how_many; i++) {
+            for (uint32_t t = 0; t < plan->hyperperiod; t += plan->divider[i]) {
+                plan->schedule[t] |= (1 << i);
             }
         }
-        float freq = ei_fusion_calc_multi_gcd(actual_comb, (uint8_t)n);
-        int local_mem_fac = 0;
+    }
+}
+
+/**
+ * @brief Find the highest frequency of a combination where all frequencies
+ * divide each other. Such a combination needs no extra ticks, and is
+ * used as upper bound for the tick of the other combinations.
+ *
+ * @param search
+ * @param ix sensor to choose a frequency for
+ * @param max_mhz highest frequency chosen so far
+ */
+static void find_max_chain_freq(multi_freq_search_t *search, uint8_t ix, uint64_t max_mhz)
+{
+    if (ix == search->n) {
+        if (max_mhz > search->allowed_mhz) {
+            search->allowed_mhz = max_mhz;
+        }
+        return;
+    }
 
-        freq = roundf(10.f/(freq))/10.f;
+    for (uint8_t c = 0; c < search->count[ix]; c++) {
+        uint32_t freq = search->freq_mhz[ix][c];
+        bool natural_mult = true;
 
-        if ((freq > allowed_period) && (allowed_period != MULTI_FREQ_MAX_FREQ_NOT_SET)) {
-            return;
+        for (uint8_t i = 0; i < ix && natural_mult; i++) {
+            uint32_t chosen = search->freq_mhz[i][search->choice[i]];
+            natural_mult = (freq % chosen == 0) || (chosen % freq == 0);
         }
 
-        if (find(begin(*freq_comb), end(*freq_comb), freq) != end(*freq_comb)) {  /* already present, let's check if better mem increase */
-            size_t j;
-            for (j = 0; j < freq_comb->size(); j++) {
-                if (freq_comb->at(j) == freq) {
-                    break;
-                }
-            }
-            // let's check if we can found a better combination with the same result.
-            for (i = 0; i < n; i++) {
-                int temp = (int)(freq*actual_comb[i]);
+        if (natural_mult) {
+            search->choice[ix] = c;
+            find_max_chain_freq(search, ix + 1, std::max<uint64_t>(max_mhz, freq));
+        }
+    }
+}
 
-                if (temp == 1) {
-                    local_mem_fac = 1;  // if equal of one of the starting freq, we want to keep it!
-                    break;
-                }
-                else {
-                    local_mem_fac += (int)(freq*actual_comb[i]);
-                }
+/**
+ * @brief Lowest memory factor any completion of the first ix choices can reach.
+ * The tick only grows deeper in the tree, so dividers only grow.
+ *
+ * @param search
+ * @param ix number of sensors chosen so far
+ * @param lcm_mhz tick of the sensors chosen so far
+ * @return uint32_t
+ */
+static uint32_t multi_freq_mem_bound(multi_freq_search_t *search, uint8_t ix, uint64_t lcm_mhz)
+{
+    uint32_t mem_sum = 0;
 
+    // a factor of 1 stays reachable while a sensor could still run at the final tick
+    for (uint8_t i = ix; i < search->n; i++) {
+        for (uint8_t c = 0; c < search->count[i]; c++) {
+            if (search->freq_mhz[i][c] % lcm_mhz == 0) {
+                return 1;
             }
-            if (local_mem_fac < mem_fact->at(j)) {
-                mem_fact->at(j) = local_mem_fac;
-            }
+        }
+    }
 
-            return; // element already present, no need to add it.
+    for (uint8_t i = 0; i < ix; i++) {
+        uint32_t freq = search->freq_mhz[i][search->choice[i]];
+        if (freq == lcm_mhz) {
+            return 1;
         }
+        mem_sum += (uint32_t)(lcm_mhz / freq);
+    }
 
-        for (i = 0; i < n; i++) {
-            int temp = (int)(freq*actual_comb[i]);
+    // none of the remaining sensors can be read on every tick
+    return mem_sum + 2 * (search->n - ix);
+}
 
-            if (temp == 1) {
-                local_mem_fac = 1;  // if equal of one of the starting freq, we want to keep it!
-                break;
-            }
-            else {
-                local_mem_fac += (int)(freq*actual_comb[i]);
-            }
+/**
+ * @brief Branch and bound over the frequency combinations: the tick (lcm of the
+ * chosen frequencies) is bound by allowed_mhz, the memory factor by
+ * MULTI_FREQ_MAX_INC_FACTOR once a combination below it is known.
+ *
+ * @param search
+ * @param ix sensor to choose a frequency for
+ * @param lcm_mhz tick of the sensors chosen so far, 0 for none
+ */
+static void search_multi_freq_plans(multi_freq_search_t *search, uint8_t ix, uint64_t lcm_mhz)
+{
+    if (ix == search->n) {
+        add_multi_freq_plan(search, lcm_mhz);
+        return;
+    }
+
+    for (uint8_t c = 0; c < search->count[ix]; c++) {
+        uint64_t freq = search->freq_mhz[ix][c];
+        uint64_t next_lcm = (lcm_mhz == 0) ? freq : (lcm_mhz / calc_gcd(lcm_mhz, freq)) * freq;
+
+        if (next_lcm > UINT32_MAX) {
+            continue;
+        }
+
+        if ((search->allowed_mhz != 0) && (next_lcm > search->allowed_mhz)) {
+            continue;
         }
 
-        mem_fact->push_back(local_mem_fac);
-        freq_comb->push_back(freq);
+        search->choice[ix] = c;
 
-    } else {
-        for (i = 0; i < col; i++) {
-            actual_comb[ix] = mat_period[ix*col + i];
-            get_multi_freq_combinations(n, col, mat_period, actual_comb, ix + 1, freq_comb, mem_fact, allowed_period);
+        if (search->below_threshold
+            && (multi_freq_mem_bound(search, ix + 1, next_lcm) >= MULTI_FREQ_MAX_INC_FACTOR)) {
+            continue;
         }
+
+        search_multi_freq_plans(search, ix + 1, next_lcm);
     }
 }
 
 /**
- * @brief
+ * @brief Store the current combination, keeping the lowest memory factor per tick
  *
- * @param n
- * @param col
- * @param ix
- * @param actual_comb
- * @param actual_max
+ * @param search
+ * @param lcm_mhz tick of the combination
  */
-static void clean_multi_freq_combinations(int n, int col,float* mat_period, float* actual_comb, int ix, float* actual_max)
+static void add_multi_freq_plan(multi_freq_search_t *search, uint64_t lcm_mhz)
 {
-    if (ix == n) {
-
-        bool natural_mult = true;
-
-        for (int i = 0; i < (n-1); i++) {
-            for (int j = i + 1; j < n; j++) {
-                if (actual_comb[j] < actual_comb[i]) {
+    uint32_t mem_sum = 0;
+    bool every_tick = false;
+    ei_fusion_plan_t *plan = nullptr;
+
+    for (uint8_t i = 0; i < search->n; i++) {
+        uint32_t divider = (uint32_t)(lcm_mhz / search->freq_mhz[i][search->choice[i]]);
+        mem_sum += divider;
+        every_tick |= (divider == 1);
+    }
+    uint32_t mem_factor = every_tick ? 1 : mem_sum;
 
-                    if (fmodf(actual_comb[i], actual_comb[j]) != 0.0f) {
-                        return;
-                    }
-                }
-                else {
-                    if (fmodf(actual_comb[j], actual_comb[i]) != 0.0f) {
-                        return;
-                    }
-                }
+    for (size_t j = 0; j < search->plans->size(); j++) {
+        if (search->plans->at(j).tick_mhz == lcm_mhz) {
+            if (mem_factor >= search->plans->at(j).mem_factor) {
+                return;
             }
+            plan = &search->plans->at(j);
+            break;
         }
+    }
 
-        if (natural_mult == true) {
-            float temp_max = 0.0f;
+    if (plan == nullptr) {
+        search->plans->push_back(ei_fusion_plan_t());
+        plan = &search->plans->back();
+    }
 
-            for (int i = 0; i < (n-1); i++) {
-                temp_max = actual_comb[i];
+    memset(plan, 0, sizeof(ei_fusion_plan_t));
+    for (uint8_t i = 0; i < search->n; i++) {
+        plan->freq_mhz[i] = search->freq_mhz[i][search->choice[i]];
+    }
+    build_multi_plan(plan, search->n, lcm_mhz);
 
-                for (int j = i + 1; j < n; j++) {
-                    if (temp_max < actual_comb[j]) {
-                        temp_max = actual_comb[j];
-                    }
-                }
-            }
+    if (mem_factor < MULTI_FREQ_MAX_INC_FACTOR) {
+        search->below_threshold = true;
+    }
+}
+
+/**
+ * @brief Find the sample ticks a set of sensors can be fused at, with for each tick
+ * the frequency combination that needs the least memory. Ticks are bound by the
+ * highest combination where all frequencies divide each other, and when a plan
+ * below MULTI_FREQ_MAX_INC_FACTOR exists only those plans are returned.
+ *
+ * @param frequencies how_many x EI_MAX_FREQUENCIES matrix, 0 for unused entries
+ * @param how_many number of sensors
+ * @param plans found plans, in search order
+ * @return uint32_t number of plans
+ */
+uint32_t ei_fusion_calc_multi_freq_plans(const float *frequencies, uint8_t how_many, vector<ei_fusion_plan_t> *plans)
+{
+    multi_freq_search_t search;
+
+    plans->clear();
+
+    if ((how_many == 0) || (how_many > NUM_MAX_FUSIONS)) {
+        return 0;
+    }
+
+    memset(&search, 0, sizeof(search));
+    search.n = how_many;
+    search.plans = plans;
 
-            if (temp_max > *actual_max) {
-                *actual_max = temp_max;
+    for (uint8_t i = 0; i < how_many; i++) {
+        for (uint8_t j = 0; j < EI_MAX_FREQUENCIES; j++) {
+            uint32_t freq = freq_to_mhz(frequencies[i * EI_MAX_FREQUENCIES + j]);
+            bool duplicate = (freq == 0);
+
+            for (uint8_t c = 0; c < search.count[i] && !duplicate; c++) {
+                duplicate = (search.freq_mhz[i][c] == freq);
+            }
+            if (!duplicate) {
+                search.freq_mhz[i][search.count[i]++] = freq;
             }
         }
 
-        return;
-    } else {
-        for (int i = 0; i < col; i++) {
-            actual_comb[ix] = mat_period[ix*col + i];
-
-            clean_multi_freq_combinations(n, col, mat_period, actual_comb, ix + 1, actual_max);
+        if (search.count[i] == 0) {
+            return 0;
         }
     }
 
+    find_max_chain_freq(&search, 0, 0);
+    search_multi_freq_plans(&search, 0, 0);
+
+    if (search.below_threshold) {
+        plans->erase(
+            std::remove_if(plans->begin(), plans->end(), [](const ei_fusion_plan_t &plan) {
+                return plan.mem_factor >= MULTI_FREQ_MAX_INC_FACTOR;
+            }),
+            plans->end());
+    }
+
+    return (uint32_t)plans->size();
 }
 
 /**
- * @brief
+ * @brief Sensors to read in a sample tick
  *
- * @param mat_period
- * @param actual_comb
- * @return true
- * @return false
+ * @param plan
+ * @param tick tick counter since the start of sampling
+ * @return uint8_t read flags, bit i for sensor i
  */
-static bool ei_fusion_calc_optimal_frequencies(uint8_t row, uint8_t col, float freq_objective)
+uint8_t ei_fusion_plan_read_flags(const ei_fusion_plan_t *plan, uint32_t tick)
 {
-    uint8_t found = 0;
-    int32_t optimal_values = 0;
+    uint8_t flags = 0;
 
-    if (freq_objective == 0.0) {
-        return false;
+    if ((plan->hyperperiod != 0) && (plan->hyperperiod <= EI_FUSION_PLAN_MAX_TICKS)) {
+        return plan->schedule[tick % plan->hyperperiod];
     }
 
-    memset(multi_sampling_freq, 0, sizeof(multi_sampling_freq));
-    memset(multi_freq_combination, 0, sizeof(multi_freq_combination));
-
-    for (int i = 0; i < row; i++) {
-        for (int j = 0; j < col; j++) {
-            //
-            multi_freq_combination[i][j] = fusion_sensors[i]->frequencies[j];
+    for (uint8_t i = 0; i < NUM_MAX_FUSIONS; i++) {
+        if ((plan->divider[i] != 0) && (tick % plan->divider[i] == 0)) {
+            flags |= (1 << i);
         }
     }
 
+    return flags;
+}
+
+/**
+ * @brief Plan of the current (or last) multi frequency sampling
+ *
+ * @return const ei_fusion_plan_t*
+ */
+const ei_fusion_plan_t *ei_fusion_get_multi_plan(void)
+{
+    return &multi_plan;
+}
+
+/**
+ * @brief For each sensor, pick the highest frequency the objective is an integer
+ * multiple of, and build the plan with the objective as sample tick
+ *
+ * @param row number of sensors
+ * @param col frequencies per sensor
+ * @param freq_objective sample tick frequency in Hz
+ * @return true if every sensor has such a frequency
+ */
+static bool ei_fusion_calc_optimal_frequencies(uint8_t row, uint8_t col, float freq_objective)
+{
+    uint32_t objective_mhz = freq_to_mhz(freq_objective);
+
+    memset(&multi_plan, 0, sizeof(multi_plan));
+
+    if (objective_mhz == 0) {
+        return false;
+    }
+
     for (int i = 0; i < row; i++) {  // for each sensors
-        optimal_values = INT32_MAX;
+        uint32_t best_mhz = 0;
 
         for (int j = 0; j < col; j++) {  // for each freq
-            if ((freq_objective >= multi_freq_combination[i][j])
-                && (multi_freq_combination[i][j] != 0.0f)) {
-                if (fmodf(freq_objective, multi_freq_combination[i][j]) == 0.0f) {
-                    int32_t temp = freq_objective/multi_freq_combination[i][j];
-                    if (temp < optimal_values) {
-                        optimal_values = temp;
-                        multi_sampling_freq[i] = multi_freq_combination[i][j];
-                    }
-                }
+            uint32_t freq = freq_to_mhz(fusion_sensors[i]->frequencies[j]);
+
+            if ((freq != 0) && (freq <= objective_mhz) && (objective_mhz % freq == 0) && (freq > best_mhz)) {
+                best_mhz = freq;
             }
         }
 
-        if (optimal_values != INT32_MAX) {
-            found++;
+        if (best_mhz == 0) {
+            return false;
         }
+        multi_plan.freq_mhz[i] = best_mhz;
     }
 
-    if (found == row) {
-        return true;
-    }
-    else{
-        return false;
-    }
+    build_multi_plan(&multi_plan, row, objective_mhz);
+
+    return true;
 }
 
 /**
@@ -1003,25 +1286,23 @@ static bool ei_fusion_calc_optimal_frequencies(uint8_t row, uint8_t col, float f
  *
  * @param numbers
  * @param how_may
- * @return float the gcd of the array
+ * @return float the gcd of the array, computed on integer mHz
  */
 float ei_fusion_calc_multi_gcd(float* numbers, uint8_t how_many)
 {
-    uint8_t i;
-    float inttime1;
-
+    uint64_t gcd_mhz;
 
     if (how_many < 2) {
         return 0.f;
     }
 
-    inttime1 = numbers[0];
+    gcd_mhz = freq_to_mhz(numbers[0]);
 
-    for (i = 1; i < how_many; i++) {
-        inttime1 = calc_gcd(inttime1, (numbers[i]));
+    for (uint8_t i = 1; i < how_many; i++) {
+        gcd_mhz = calc_gcd(gcd_mhz, freq_to_mhz(numbers[i]));
     }
 
-    return (inttime1);
+    return (gcd_mhz / 1000.f);
 }
 
 bool ei_is_fusion(void)
@@ -1029,4 +1310,17 @@ bool ei_is_fusion(void)
     return (num_fusions > 1);
 }
 
+/**
+ * @brief Multi frequency sample tick, reads the sensors multi_plan schedules for it
+ * (all of them on the first tick)
+ */
+static void fusion_multi_tick(void)
+{
+    ei_fusion_multi_read_axis_data(ei_fusion_plan_read_flags(&multi_plan, multi_tick));
+
+    if (++multi_tick >= multi_plan.hyperperiod) {
+        multi_tick = 0;
+    }
+}
+
 #endif
@@ -61,6 +61,25 @@
 
 #define EI_MAX_FREQUENCIES 5
 
+/** Number of fused frames buffered between the sample tick and the sampler */
+#ifndef EI_FUSION_RING_FRAMES
+#define EI_FUSION_RING_FRAMES   16
+#endif
+
+/**
+ * Frames are handed to the sampler from the sample tick once this many are pending.
+ * 1 delivers every frame right away, 0 never drains from the tick
+ * (the platform calls ei_fusion_drain() from its own thread instead)
+ */
+#ifndef EI_FUSION_BATCH_FRAMES
+#define EI_FUSION_BATCH_FRAMES  4
+#endif
+
+/** Longest read pattern (in sample ticks) stored as a table in ei_fusion_plan_t */
+#ifndef EI_FUSION_PLAN_MAX_TICKS
+#define EI_FUSION_PLAN_MAX_TICKS    64
+#endif
+
 /** Format used in input list. Can either contain sensor names or axes names */
 typedef enum
 {
@@ -93,6 +112,47 @@ typedef struct {
     std::vector<float> frequencies;
 } fused_sensors_t;
 
+/**
+ * Statistics of the current (or last) fusion sampling run
+ */
+typedef struct {
+    // Frames read from the sensors
+    uint32_t frames;
+    // Frames handed to the sampler
+    uint32_t delivered;
+    // Frames dropped because the ring was full
+    uint32_t overruns;
+    // Highest number of frames waiting in the ring
+    uint32_t max_pending;
+    // Shortest and longest time between two sample ticks
+    uint32_t interval_min_us;
+    uint32_t interval_max_us;
+    // Largest and summed deviation from the requested interval (the plan tick for multi frequency)
+    uint32_t jitter_max_us;
+    uint64_t jitter_sum_us;
+} ei_fusion_stats_t;
+
+#if MULTI_FREQ_ENABLED == 1
+/**
+ * Multi frequency sampling plan: one sample tick, each sensor read every divider[i] ticks.
+ * Frequencies are kept in integer mHz so divisibility checks are exact.
+ */
+typedef struct {
+    // Sample tick frequency (mHz) and period (rounded to us)
+    uint32_t tick_mhz;
+    uint32_t tick_us;
+    // Chosen frequency per sensor (mHz) and how many ticks between two reads
+    uint32_t freq_mhz[NUM_MAX_FUSIONS];
+    uint32_t divider[NUM_MAX_FUSIONS];
+    // Memory increase factor, 1 when a sensor is read on every tick
+    uint32_t mem_factor;
+    // Ticks after which the read pattern repeats
+    uint32_t hyperperiod;
+    // Read flags per tick (bit i: read sensor i), valid when hyperperiod <= EI_FUSION_PLAN_MAX_TICKS
+    uint8_t schedule[EI_FUSION_PLAN_MAX_TICKS];
+} ei_fusion_plan_t;
+#endif
+
 /* Function prototypes ----------------------------------------------------- */
 bool ei_add_sensor_to_fusion_list(ei_device_fusion_sensor_t sensor);
 
@@ -113,10 +173,15 @@ bool ei_connect_fusion_list(const char *input_list, ei_fusion_list_format format
 void ei_fusion_read_axis_data(void);
 bool ei_fusion_sample_start(sampler_callback callsampler, float sample_interval_ms);
 bool ei_fusion_setup_data_sampling(void);
+uint32_t ei_fusion_drain(void);
+void ei_fusion_get_stats(ei_fusion_stats_t *stats);
 #if MULTI_FREQ_ENABLED == 1
 bool ei_multi_fusion_sample_start(sampler_callback callsampler, float multi_sample_interval_ms);
 void ei_fusion_multi_read_axis_data(uint8_t flag_read);
 float ei_fusion_calc_multi_gcd(float* numbers, uint8_t how_many);
+uint32_t ei_fusion_calc_multi_freq_plans(const float *frequencies, uint8_t how_many, std::vector<ei_fusion_plan_t> *plans);
+uint8_t ei_fusion_plan_read_flags(const ei_fusion_plan_t *plan, uint32_t tick);
+const ei_fusion_plan_t *ei_fusion_get_multi_plan(void);
 bool ei_is_fusion(void);
 #endif
 
@@ -0,0 +1,234 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_model_container.h"
+#include "edge-impulse-sdk/third_party/flatbuffers/include/flatbuffers/flatbuffers.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated_full.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_utils.h"
+#include <string.h>
+
+/* Private functions ------------------------------------------------------- */
+static bool has_op(const ei_model_container_header_t *header, uint16_t code)
+{
+    for (uint8_t ix = 0; ix < header->op_count; ix++) {
+        if (header->ops[ix] == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief      Compare a model tensor with the type, size and quantization in the header
+ */
+static bool tensor_matches(const tflite::Tensor *tensor, uint8_t type, uint32_t size, float scale, int32_t zero_point)
+{
+    if (tensor == nullptr || tensor->type() != type) {
+        return false;
+    }
+
+    uint32_t elements = 1;
+    if (tensor->shape()) {
+        for (int32_t dim : *tensor->shape()) {
+            if (dim < 0) {
+                return false;
+            }
+            elements *= (uint32_t)dim;
+        }
+    }
+    if (elements != size) {
+        return false;
+    }
+
+    if (type == EI_MODEL_CONTAINER_TYPE_FLOAT32) {
+        return true;
+    }
+
+    // quantized tensors, the postprocessing dequantizes with the header values
+    const tflite::QuantizationParameters *quant = tensor->quantization();
+    if (quant == nullptr || quant->scale() == nullptr || quant->zero_point() == nullptr ||
+        quant->scale()->size() < 1 || quant->zero_point()->size() < 1) {
+        return false;
+    }
+    return quant->scale()->Get(0) == scale && quant->zero_point()->Get(0) == zero_point;
+}
+
+/* Public functions -------------------------------------------------------- */
+/**
+ * @brief      CRC-32 (IEEE 802.3, reflected poly 0xEDB88320), a nibble at a time
+ * @param      crc  Previous value to continue a CRC over several buffers
+ */
+uint32_t ei_model_container_crc32(const uint8_t *data, size_t length, uint32_t crc)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+    for (size_t ix = 0; ix < length; ix++) {
+        crc = (crc >> 4) ^ table[(crc ^ data[ix]) & 0x0F];
+        crc = (crc >> 4) ^ table[(crc ^ (data[ix] >> 4)) & 0x0F];
+    }
+    return ~crc;
+}
+
+/**
+ * @brief      Update header_crc32 after changing header fields (e.g. the generation)
+ */
+void ei_model_container_seal(ei_model_container_header_t *header)
+{
+    header->header_crc32 = ei_model_container_crc32((const uint8_t *)header,
+                                                    offsetof(ei_model_container_header_t, header_crc32));
+}
+
+/**
+ * @brief      Check a header before reading the model it describes
+ * @param      max_model_size  Room for the model in the storage
+ */
+ei_model_container_status_t ei_model_container_check_header(const ei_model_container_header_t *header,
+                                                            uint32_t max_model_size)
+{
+    static const uint8_t erased[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+    if (memcmp(header->magic, erased, sizeof(erased)) == 0) {
+        return EI_MODEL_CONTAINER_EMPTY;
+    }
+    if (memcmp(header->magic, EI_MODEL_CONTAINER_MAGIC, sizeof(header->magic)) != 0) {
+        return EI_MODEL_CONTAINER_BAD_MAGIC;
+    }
+    if (header->version != EI_MODEL_CONTAINER_VERSION || header->header_size != EI_MODEL_CONTAINER_HEADER_SIZE) {
+        return EI_MODEL_CONTAINER_BAD_VERSION;
+    }
+    if (ei_model_container_crc32((const uint8_t *)header, offsetof(ei_model_container_header_t, header_crc32)) !=
+        header->header_crc32) {
+        return EI_MODEL_CONTAINER_BAD_HEADER_CRC;
+    }
+    if (header->model_size == 0 || header->model_size > max_model_size ||
+        header->arena_size == 0 || header->op_count > EI_MODEL_CONTAINER_MAX_OPS) {
+        return EI_MODEL_CONTAINER_BAD_SIZE;
+    }
+    return EI_MODEL_CONTAINER_OK;
+}
+
+/**
+ * @brief      Check the model bytes against the checksum in the header
+ */
+ei_model_container_status_t ei_model_container_check_crc(const ei_model_container_header_t *header,
+                                                         const uint8_t *model)
+{
+    if (ei_model_container_crc32(model, header->model_size) != header->model_crc32) {
+        return EI_MODEL_CONTAINER_BAD_MODEL_CRC;
+    }
+    return EI_MODEL_CONTAINER_OK;
+}
+
+/**
+ * @brief      Verify the flatbuffer and check it is the model the header describes,
+ *             so the interpreter never walks a malformed or unexpected model
+ * @param      model  Model bytes, aligned to at least 8 bytes
+ */
+ei_model_container_status_t ei_model_container_check_model(const ei_model_container_header_t *header,
+                                                           const uint8_t *model)
+{
+    flatbuffers::Verifier verifier(model, header->model_size);
+    if (!tflite::VerifyModelBuffer(verifier)) {
+        return EI_MODEL_CONTAINER_BAD_MODEL;
+    }
+
+    const tflite::Model *tfl_model = tflite::GetModel(model);
+    if (tfl_model->version() != 3 /* TFLITE_SCHEMA_VERSION */ ||
+        tfl_model->subgraphs() == nullptr || tfl_model->subgraphs()->size() != 1 ||
+        tfl_model->operator_codes() == nullptr) {
+        return EI_MODEL_CONTAINER_BAD_MODEL;
+    }
+
+    // the op list is exact: the model uses every listed op and nothing else
+    const auto *op_codes = tfl_model->operator_codes();
+    uint8_t seen = 0;
+    for (flatbuffers::uoffset_t ix = 0; ix < op_codes->size(); ix++) {
+        uint16_t code = (uint16_t)tflite::GetBuiltinCode(op_codes->Get(ix));
+        if (!has_op(header, code)) {
+            return EI_MODEL_CONTAINER_OPS_MISMATCH;
+        }
+        bool duplicate = false;
+        for (flatbuffers::uoffset_t prev = 0; prev < ix; prev++) {
+            duplicate |= (uint16_t)tflite::GetBuiltinCode(op_codes->Get(prev)) == code;
+        }
+        seen += duplicate ? 0 : 1;
+    }
+    if (seen != header->op_count) {
+        return EI_MODEL_CONTAINER_OPS_MISMATCH;
+    }
+
+    const tflite::SubGraph *subgraph = tfl_model->subgraphs()->Get(0);
+    const auto *tensors = subgraph->tensors();
+    if (tensors == nullptr || subgraph->inputs() == nullptr || subgraph->outputs() == nullptr ||
+        subgraph->inputs()->size() != 1 || subgraph->outputs()->size() != 1) {
+        return EI_MODEL_CONTAINER_IO_MISMATCH;
+    }
+
+    int32_t input = subgraph->inputs()->Get(0);
+    int32_t output = subgraph->outputs()->Get(0);
+    if (input < 0 || (uint32_t)input >= tensors->size() || output < 0 || (uint32_t)output >= tensors->size()) {
+        return EI_MODEL_CONTAINER_IO_MISMATCH;
+    }
+    if (!tensor_matches(tensors->Get(input), header->input_type, header->input_size,
+                        header->input_scale, header->input_zero_point) ||
+        !tensor_matches(tensors->Get(output), header->output_type, header->output_size,
+                        header->output_scale, header->output_zero_point)) {
+        return EI_MODEL_CONTAINER_IO_MISMATCH;
+    }
+
+    return EI_MODEL_CONTAINER_OK;
+}
+
+const char *ei_model_container_status_str(ei_model_container_status_t status)
+{
+    switch (status) {
+        case EI_MODEL_CONTAINER_OK: return "OK";
+        case EI_MODEL_CONTAINER_EMPTY: return "empty";
+        case EI_MODEL_CONTAINER_BAD_MAGIC: return "not a model container";
+        case EI_MODEL_CONTAINER_BAD_VERSION: return "unsupported container version";
+        case EI_MODEL_CONTAINER_BAD_HEADER_CRC: return "header checksum mismatch";
+        case EI_MODEL_CONTAINER_BAD_SIZE: return "invalid model or arena size";
+        case EI_MODEL_CONTAINER_BAD_MODEL_CRC: return "model checksum mismatch";
+        case EI_MODEL_CONTAINER_BAD_MODEL: return "invalid TFLite model";
+        case EI_MODEL_CONTAINER_OPS_MISMATCH: return "model ops differ from the header";
+        case EI_MODEL_CONTAINER_IO_MISMATCH: return "model input / output differs from the header";
+        default: return "unknown error";
+    }
+}
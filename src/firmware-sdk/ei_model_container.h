@@ -0,0 +1,123 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_MODEL_CONTAINER_H
+#define EI_MODEL_CONTAINER_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Model container, a TFLite flatbuffer with a header that tells the firmware
+ * if (and how) it can run it without parsing the model first.
+ *
+ * Layout (all fields little endian):
+ *
+ *   header   EI_MODEL_CONTAINER_HEADER_SIZE bytes, ei_model_container_header_t
+ *   model    model_size bytes, the .tflite flatbuffer
+ *
+ * The header is checked on its own (header_crc32 covers every field before it),
+ * the model against model_crc32 (check_crc) and then against the header
+ * (check_model): the flatbuffer is verified, its operators must be the ones in
+ * the op list and its single input / output tensor must have the type, size and
+ * quantization of the header.
+ *
+ * Built by tools/model_container.py, stored by EiModelStore (ei_model_store.h).
+ */
+
+/* Constants --------------------------------------------------------------- */
+#define EI_MODEL_CONTAINER_MAGIC        "EIMC"
+#define EI_MODEL_CONTAINER_VERSION      1
+#define EI_MODEL_CONTAINER_HEADER_SIZE  128
+#define EI_MODEL_CONTAINER_MAX_OPS      32
+
+// tflite::TensorType values of the supported input / output tensors
+#define EI_MODEL_CONTAINER_TYPE_FLOAT32 0
+#define EI_MODEL_CONTAINER_TYPE_UINT8   3
+#define EI_MODEL_CONTAINER_TYPE_INT8    9
+
+/* Types ------------------------------------------------------------------- */
+typedef struct __attribute__((packed)) {
+    char magic[4];                      // EI_MODEL_CONTAINER_MAGIC
+    uint16_t version;                   // EI_MODEL_CONTAINER_VERSION
+    uint16_t header_size;               // EI_MODEL_CONTAINER_HEADER_SIZE, the model starts here
+    uint32_t generation;                // set by the store, the higher one is the active slot
+    uint32_t model_size;
+    uint32_t model_crc32;
+    uint32_t arena_size;                // tensor arena the interpreter needs for this model
+    uint32_t project_id;                // Edge Impulse project, 0 to skip the check
+    uint32_t deploy_version;
+    uint32_t input_size;                // elements of the input tensor
+    uint32_t output_size;               // elements of the output tensor
+    uint8_t input_type;                 // EI_MODEL_CONTAINER_TYPE_*
+    uint8_t output_type;
+    uint8_t op_count;
+    uint8_t reserved;
+    float input_scale;                  // quantization, 0 / 0 for float tensors
+    int32_t input_zero_point;
+    float output_scale;
+    int32_t output_zero_point;
+    uint16_t ops[EI_MODEL_CONTAINER_MAX_OPS];   // tflite::BuiltinOperator codes the model uses
+    uint32_t header_crc32;
+} ei_model_container_header_t;
+
+static_assert(sizeof(ei_model_container_header_t) == EI_MODEL_CONTAINER_HEADER_SIZE,
+              "Model container header layout changed");
+
+typedef enum {
+    EI_MODEL_CONTAINER_OK = 0,
+    EI_MODEL_CONTAINER_EMPTY = -1,              // erased storage, no container
+    EI_MODEL_CONTAINER_BAD_MAGIC = -2,
+    EI_MODEL_CONTAINER_BAD_VERSION = -3,
+    EI_MODEL_CONTAINER_BAD_HEADER_CRC = -4,
+    EI_MODEL_CONTAINER_BAD_SIZE = -5,
+    EI_MODEL_CONTAINER_BAD_MODEL_CRC = -6,
+    EI_MODEL_CONTAINER_BAD_MODEL = -7,          // flatbuffer verification failed
+    EI_MODEL_CONTAINER_OPS_MISMATCH = -8,
+    EI_MODEL_CONTAINER_IO_MISMATCH = -9
+} ei_model_container_status_t;
+
+/* Function prototypes ----------------------------------------------------- */
+uint32_t ei_model_container_crc32(const uint8_t *data, size_t length, uint32_t crc = 0);
+void ei_model_container_seal(ei_model_container_header_t *header);
+ei_model_container_status_t ei_model_container_check_header(const ei_model_container_header_t *header,
+                                                            uint32_t max_model_size);
+ei_model_container_status_t ei_model_container_check_crc(const ei_model_container_header_t *header,
+                                                         const uint8_t *model);
+ei_model_container_status_t ei_model_container_check_model(const ei_model_container_header_t *header,
+                                                           const uint8_t *model);
+const char *ei_model_container_status_str(ei_model_container_status_t status);
+
+#endif /* EI_MODEL_CONTAINER_H */
@@ -0,0 +1,392 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_model_store.h"
+#include "at_base64_lib.h"
+#include "ei_serial_tx.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <string.h>
+
+/* Public functions -------------------------------------------------------- */
+EiModelStore::EiModelStore(EiDeviceMemory *memory)
+    : memory(memory)
+    , slot_size(0)
+    , base_address(0)
+    , ready(false)
+    , write_slot(-1)
+    , write_length(0)
+    , write_pos(0)
+    , chunk_len(0)
+    , model_pos(0)
+{
+    for (int slot = 0; slot < EI_MODEL_STORE_SLOTS; slot++) {
+        status[slot] = EI_MODEL_CONTAINER_EMPTY;
+    }
+}
+
+/**
+ * @brief      Reserve the slots at the end of the device memory and read their headers,
+ *             call once at boot before any sampling
+ */
+bool EiModelStore::init(void)
+{
+    if (!ready) {
+        if (memory->block_size == 0) {
+            return false;
+        }
+
+        uint32_t slot_blocks = (EI_MODEL_STORE_SLOT_SIZE + memory->block_size - 1) / memory->block_size;
+        if (!memory->reserve_blocks(slot_blocks * EI_MODEL_STORE_SLOTS, &base_address)) {
+            ei_printf("ERR: Not enough memory for %d model slots of %d bytes\r\n",
+                EI_MODEL_STORE_SLOTS, (int)(slot_blocks * memory->block_size));
+            return false;
+        }
+        slot_size = slot_blocks * memory->block_size;
+        ready = true;
+    }
+
+    for (int slot = 0; slot < EI_MODEL_STORE_SLOTS; slot++) {
+        scan_slot(slot);
+    }
+    return true;
+}
+
+uint32_t EiModelStore::max_model_size(void) const
+{
+    return slot_size - EI_MODEL_CONTAINER_HEADER_SIZE;
+}
+
+/**
+ * @brief      Slot with a valid header and the highest generation, -1 if there is none
+ */
+int EiModelStore::active_slot(void) const
+{
+    int active = -1;
+
+    for (int slot = 0; slot < EI_MODEL_STORE_SLOTS; slot++) {
+        if (status[slot] != EI_MODEL_CONTAINER_OK) {
+            continue;
+        }
+        if (active < 0 || headers[slot].generation > headers[active].generation) {
+            active = slot;
+        }
+    }
+    return active;
+}
+
+ei_model_container_status_t EiModelStore::slot_status(int slot) const
+{
+    return (slot >= 0 && slot < EI_MODEL_STORE_SLOTS) ? status[slot] : EI_MODEL_CONTAINER_EMPTY;
+}
+
+const ei_model_container_header_t *EiModelStore::slot_header(int slot) const
+{
+    return slot_status(slot) == EI_MODEL_CONTAINER_OK ? &headers[slot] : nullptr;
+}
+
+/**
+ * @brief      Erase the inactive slot to write a new container of length bytes
+ */
+bool EiModelStore::begin(uint32_t length)
+{
+    write_slot = -1;
+
+    if (!ready) {
+        ei_printf("ERR: Model store not initialized\r\n");
+        return false;
+    }
+    if (length <= EI_MODEL_CONTAINER_HEADER_SIZE || length > slot_size) {
+        ei_printf("ERR: Container size should be between %d and %d bytes\r\n",
+            EI_MODEL_CONTAINER_HEADER_SIZE + 1, (int)slot_size);
+        return false;
+    }
+
+    int slot = (active_slot() == 0) ? 1 : 0;
+    if (memory->erase_sample_data(slot_address(slot), slot_size) != slot_size) {
+        ei_printf("ERR: Failed to erase model slot %d\r\n", slot);
+        scan_slot(slot);
+        return false;
+    }
+    scan_slot(slot);
+
+    write_slot = slot;
+    write_length = length;
+    write_pos = 0;
+    chunk_len = 0;
+    model_pos = 0;
+
+    return true;
+}
+
+/**
+ * @brief      Append container bytes, the header first. Bytes past the length given
+ *             to begin() are ignored.
+ */
+bool EiModelStore::write(const uint8_t *data, uint32_t length)
+{
+    if (write_slot < 0) {
+        return false;
+    }
+
+    while (length > 0 && write_pos < write_length) {
+        if (write_pos < EI_MODEL_CONTAINER_HEADER_SIZE) {
+            // the header is kept in RAM and programmed by commit()
+            uint32_t n = EI_MODEL_CONTAINER_HEADER_SIZE - write_pos;
+            n = (n < length) ? n : length;
+            memcpy((uint8_t *)&write_header + write_pos, data, n);
+            write_pos += n;
+            data += n;
+            length -= n;
+
+            if (write_pos == EI_MODEL_CONTAINER_HEADER_SIZE) {
+                ei_model_container_status_t res = ei_model_container_check_header(&write_header, max_model_size());
+                if (res == EI_MODEL_CONTAINER_OK &&
+                    write_header.model_size != write_length - EI_MODEL_CONTAINER_HEADER_SIZE) {
+                    res = EI_MODEL_CONTAINER_BAD_SIZE;
+                }
+                if (res != EI_MODEL_CONTAINER_OK) {
+                    ei_printf("ERR: Invalid container header (%s)\r\n", ei_model_container_status_str(res));
+                    write_slot = -1;
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        uint32_t n = EI_MODEL_STORE_WRITE_CHUNK - chunk_len;
+        n = (n < length) ? n : length;
+        n = (n < write_length - write_pos) ? n : write_length - write_pos;
+        memcpy(chunk + chunk_len, data, n);
+        chunk_len += n;
+        write_pos += n;
+        data += n;
+        length -= n;
+
+        if (chunk_len == EI_MODEL_STORE_WRITE_CHUNK && !flush_chunk()) {
+            write_slot = -1;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief      Program the rest of the model, read it back and check it, then program
+ *             the header: only now the new container becomes the active one
+ */
+ei_model_container_status_t EiModelStore::commit(void)
+{
+    ei_model_container_status_t res = EI_MODEL_CONTAINER_OK;
+    int slot = write_slot;
+
+    if (slot < 0 || write_pos != write_length) {
+        write_slot = -1;
+        return EI_MODEL_CONTAINER_BAD_SIZE;
+    }
+
+    bool flushed = flush_chunk();
+    write_slot = -1;
+    if (!flushed) {
+        return EI_MODEL_CONTAINER_BAD_MODEL_CRC;
+    }
+
+    // check what the memory holds, not what was sent
+    uint32_t crc = 0;
+    uint32_t address = slot_address(slot) + EI_MODEL_CONTAINER_HEADER_SIZE;
+    for (uint32_t pos = 0; pos < write_header.model_size; pos += EI_MODEL_STORE_WRITE_CHUNK) {
+        uint32_t n = write_header.model_size - pos;
+        n = (n < EI_MODEL_STORE_WRITE_CHUNK) ? n : EI_MODEL_STORE_WRITE_CHUNK;
+        if (memory->read_sample_data(chunk, address + pos, n) != n) {
+            return EI_MODEL_CONTAINER_BAD_MODEL_CRC;
+        }
+        crc = ei_model_container_crc32(chunk, n, crc);
+    }
+    if (crc != write_header.model_crc32) {
+        return EI_MODEL_CONTAINER_BAD_MODEL_CRC;
+    }
+
+    int other = (slot == 0) ? 1 : 0;
+    write_header.generation = (status[other] == EI_MODEL_CONTAINER_OK) ? headers[other].generation + 1 : 1;
+    ei_model_container_seal(&write_header);
+
+    if (memory->write_sample_data((const uint8_t *)&write_header, slot_address(slot),
+                                  EI_MODEL_CONTAINER_HEADER_SIZE) != EI_MODEL_CONTAINER_HEADER_SIZE) {
+        res = EI_MODEL_CONTAINER_BAD_HEADER_CRC;
+    }
+    memory->flush_data();
+
+    scan_slot(slot);
+    return (res == EI_MODEL_CONTAINER_OK) ? status[slot] : res;
+}
+
+/**
+ * @brief      Read the model bytes of a slot
+ * @param      model  Buffer of at least slot_header(slot)->model_size bytes
+ */
+bool EiModelStore::read_model(int slot, uint8_t *model)
+{
+    const ei_model_container_header_t *header = slot_header(slot);
+    if (header == nullptr) {
+        return false;
+    }
+
+    return memory->read_sample_data(model, slot_address(slot) + EI_MODEL_CONTAINER_HEADER_SIZE,
+                                    header->model_size) == header->model_size;
+}
+
+bool EiModelStore::erase_slot(int slot)
+{
+    if (!ready || slot < 0 || slot >= EI_MODEL_STORE_SLOTS) {
+        return false;
+    }
+
+    bool ok = memory->erase_sample_data(slot_address(slot), slot_size) == slot_size;
+    scan_slot(slot);
+    return ok;
+}
+
+/**
+ * @brief      Erase the active slot, the other slot (if valid) becomes active
+ */
+bool EiModelStore::rollback(void)
+{
+    int active = active_slot();
+    if (active < 0) {
+        return false;
+    }
+
+    return erase_slot(active);
+}
+
+/* Private functions ------------------------------------------------------- */
+void EiModelStore::scan_slot(int slot)
+{
+    if (memory->read_sample_data((uint8_t *)&headers[slot], slot_address(slot),
+                                 EI_MODEL_CONTAINER_HEADER_SIZE) != EI_MODEL_CONTAINER_HEADER_SIZE) {
+        status[slot] = EI_MODEL_CONTAINER_EMPTY;
+        return;
+    }
+
+    status[slot] = ei_model_container_check_header(&headers[slot], max_model_size());
+}
+
+bool EiModelStore::flush_chunk(void)
+{
+    if (chunk_len == 0) {
+        return true;
+    }
+
+    uint32_t length = (chunk_len + EI_MODEL_STORE_WRITE_ALIGN - 1) & ~(uint32_t)(EI_MODEL_STORE_WRITE_ALIGN - 1);
+    memset(chunk + chunk_len, 0xFF, length - chunk_len);
+
+    uint32_t address = slot_address(write_slot) + EI_MODEL_CONTAINER_HEADER_SIZE + model_pos;
+    if (memory->write_sample_data(chunk, address, length) != length) {
+        ei_printf("ERR: Failed to write model slot %d\r\n", write_slot);
+        return false;
+    }
+
+    model_pos += chunk_len;
+    chunk_len = 0;
+    return true;
+}
+
+/**
+ * @brief      Receive a container over serial into the inactive slot, same transfer
+ *             as run_impulse_static_data: base64 in chunks of buf_len characters,
+ *             every chunk acknowledged with "OK <bytes received>". The caller commits.
+ *
+ * @param[in]  length   Container size in bytes
+ * @param[in]  buf_len  Characters per chunk, a multiple of 4
+ */
+bool ei_model_store_receive(EiModelStore *store, uint32_t length, size_t buf_len)
+{
+    uint32_t cur_pos = 0;
+    uint32_t buf_pos = 0;
+    uint64_t start_time = 0;
+
+    if (buf_len < 4 || (buf_len % 4) != 0) {
+        ei_printf("ERR: Buffer length should be a multiple of 4\r\n");
+        return false;
+    }
+
+    // erases the slot, this can take a while on flash
+    if (!store->begin(length)) {
+        return false;
+    }
+
+    uint8_t *temp_buf = (uint8_t*)ei_calloc(buf_len + 1, sizeof(uint8_t));
+    if (temp_buf == NULL) {
+        ei_printf("ERR: Memory allocation for serial read buffer failed\r\n");
+        return false;
+    }
+
+    ei_printf("OK CHUNK=%d\r\n", (int)buf_len);
+    ei_serial_tx_flush();
+
+    while (cur_pos < length) {
+
+        start_time = ei_read_timer_ms();
+        while (buf_pos < buf_len) {
+            if (ei_read_timer_ms() - start_time > 100) {
+                ei_printf("TIMEOUT\r\n");
+                ei_free(temp_buf);
+                return false;
+            }
+            uint8_t rec = ei_getchar();
+            if (rec != 0) {
+                temp_buf[buf_pos++] = rec;
+            }
+        }
+
+        std::vector<unsigned char> decoded = base64_decode((const char*)temp_buf);
+
+        uint32_t copylength = decoded.size() > (length - cur_pos) ? (length - cur_pos) : decoded.size();
+        if (!store->write(decoded.data(), copylength)) {
+            ei_free(temp_buf);
+            return false;
+        }
+
+        cur_pos += copylength;
+        buf_pos = 0;
+        ei_printf("OK %d\r\n", (int)cur_pos);
+        ei_serial_tx_flush();
+    }
+
+    ei_free(temp_buf);
+    ei_printf("TRANSFER COMPLETED %d\r\n", (int)cur_pos);
+
+    return true;
+}
@@ -0,0 +1,112 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_MODEL_STORE_H
+#define EI_MODEL_STORE_H
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_device_memory.h"
+#include "ei_model_container.h"
+
+/* Constants --------------------------------------------------------------- */
+#define EI_MODEL_STORE_SLOTS            2
+
+// Room for one container (header and model), rounded up to whole memory blocks
+#ifndef EI_MODEL_STORE_SLOT_SIZE
+#define EI_MODEL_STORE_SLOT_SIZE        (128 * 1024)
+#endif
+
+// Model bytes are programmed in chunks of this size, the last one padded with
+// 0xFF to EI_MODEL_STORE_WRITE_ALIGN (the flash word of the STM32H7)
+#define EI_MODEL_STORE_WRITE_CHUNK      256
+#define EI_MODEL_STORE_WRITE_ALIGN      32
+
+/**
+ * @brief Two model container slots (A/B) at the end of the device memory.
+ *
+ * A new container is always written to the slot that is not active and only
+ * becomes active when its header is programmed, after the model bytes were read
+ * back and checked. The header is written last with a generation one higher
+ * than the other slot, so a transfer that is interrupted or corrupted leaves
+ * the active model untouched. rollback() erases the active slot, which makes
+ * the previous container (or, if there is none, the built-in model) active.
+ */
+class EiModelStore {
+protected:
+    EiDeviceMemory *memory;
+    uint32_t slot_size;
+    uint32_t base_address;
+    bool ready;
+
+    ei_model_container_header_t headers[EI_MODEL_STORE_SLOTS];
+    ei_model_container_status_t status[EI_MODEL_STORE_SLOTS];
+
+    // container being written
+    int write_slot;
+    uint32_t write_length;
+    uint32_t write_pos;
+    ei_model_container_header_t write_header;
+    uint8_t chunk[EI_MODEL_STORE_WRITE_CHUNK];
+    uint32_t chunk_len;
+    uint32_t model_pos;
+
+    uint32_t slot_address(int slot) const
+    {
+        return base_address + (uint32_t)slot * slot_size;
+    }
+    void scan_slot(int slot);
+    bool flush_chunk(void);
+
+public:
+    EiModelStore(EiDeviceMemory *memory);
+
+    bool init(void);
+    uint32_t max_model_size(void) const;
+
+    int active_slot(void) const;
+    ei_model_container_status_t slot_status(int slot) const;
+    const ei_model_container_header_t *slot_header(int slot) const;
+
+    bool begin(uint32_t length);
+    bool write(const uint8_t *data, uint32_t length);
+    ei_model_container_status_t commit(void);
+
+    bool read_model(int slot, uint8_t *model);
+    bool erase_slot(int slot);
+    bool rollback(void);
+};
+
+bool ei_model_store_receive(EiModelStore *store, uint32_t length, size_t buf_len);
+
+#endif /* EI_MODEL_STORE_H */
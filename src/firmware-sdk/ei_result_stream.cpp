@@ -0,0 +1,306 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_result_stream.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <string.h>
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    uint8_t *buffer;
+    size_t size;
+    size_t length;
+    bool overflow;
+} record_writer_t;
+
+/* Private functions ------------------------------------------------------- */
+static void put_bytes(record_writer_t *w, const void *data, size_t length)
+{
+    if (w->overflow || w->length + length > w->size) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buffer + w->length, data, length);
+    w->length += length;
+}
+
+static void put_u8(record_writer_t *w, uint8_t value)
+{
+    put_bytes(w, &value, 1);
+}
+
+static void put_u16(record_writer_t *w, uint16_t value)
+{
+    uint8_t b[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+    put_bytes(w, b, sizeof(b));
+}
+
+static void put_u32(record_writer_t *w, uint32_t value)
+{
+    uint8_t b[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    put_bytes(w, b, sizeof(b));
+}
+
+static void put_u64(record_writer_t *w, uint64_t value)
+{
+    put_u32(w, (uint32_t)value);
+    put_u32(w, (uint32_t)(value >> 32));
+}
+
+static void put_f32(record_writer_t *w, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u32(w, bits);
+}
+
+static uint16_t quantize_score(float value)
+{
+    // also maps NaN to 0
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    if (value >= 1.0f) {
+        return 0xFFFF;
+    }
+    return (uint16_t)(value * 65535.0f + 0.5f);
+}
+
+static uint32_t clamp_us(int64_t us)
+{
+    if (us < 0) {
+        return 0;
+    }
+    return us > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static uint16_t clamp_u16(uint32_t value)
+{
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+}
+
+static uint8_t label_index(const ei_result_stream_schema_t *schema, const char *label)
+{
+    if (!label) {
+        return EI_RESULT_STREAM_NO_LABEL;
+    }
+    for (uint8_t ix = 0; ix < schema->label_count; ix++) {
+        if (schema->labels[ix] == label || strcmp(schema->labels[ix], label) == 0) {
+            return ix;
+        }
+    }
+    return EI_RESULT_STREAM_NO_LABEL;
+}
+
+/**
+ * @brief      Start a record, the payload length is filled in by finish_record
+ */
+static void start_record(record_writer_t *w, uint8_t *buffer, size_t size, ei_result_stream_type_t type)
+{
+    w->buffer = buffer;
+    w->size = size;
+    w->length = 0;
+    w->overflow = false;
+
+    put_u8(w, EI_RESULT_STREAM_SYNC_0);
+    put_u8(w, EI_RESULT_STREAM_SYNC_1);
+    put_u8(w, EI_RESULT_STREAM_VERSION);
+    put_u8(w, (uint8_t)type);
+    put_u16(w, 0);
+}
+
+/**
+ * @brief      Patch the payload length and append the CRC
+ * @return     Record size in bytes, 0 if it did not fit
+ */
+static size_t finish_record(record_writer_t *w)
+{
+    if (w->overflow || w->length + 2 > w->size) {
+        return 0;
+    }
+    size_t payload = w->length - (EI_RESULT_STREAM_FRAME_OVERHEAD - 2);
+    w->buffer[4] = (uint8_t)payload;
+    w->buffer[5] = (uint8_t)(payload >> 8);
+    put_u16(w, ei_result_stream_crc16(w->buffer + 2, w->length - 2));
+    return w->length;
+}
+
+/* Public functions -------------------------------------------------------- */
+/**
+ * @brief      CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), a nibble at a time
+ * @param      crc  Previous value to continue a CRC over several buffers
+ */
+uint16_t ei_result_stream_crc16(const uint8_t *data, size_t length, uint16_t crc)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+
+    for (size_t ix = 0; ix < length; ix++) {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[ix] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[ix] & 0x0F)]);
+    }
+    return crc;
+}
+
+/**
+ * @brief      Size of the LABELS record of this schema, it depends on the label names
+ */
+size_t ei_result_stream_labels_size(const ei_result_stream_schema_t *schema)
+{
+    size_t size = EI_RESULT_STREAM_FRAME_OVERHEAD + 2;
+    for (uint8_t ix = 0; ix < schema->label_count; ix++) {
+        size_t length = strlen(schema->labels[ix]);
+        size += 1 + (length > 255 ? 255 : length);
+    }
+    return size;
+}
+
+/**
+ * @brief      Encode the label names the scores of the following results refer to
+ * @return     Record size in bytes, 0 if the buffer is too small
+ */
+size_t ei_result_stream_encode_labels(const ei_result_stream_schema_t *schema, uint8_t *buffer, size_t size)
+{
+    record_writer_t w;
+    start_record(&w, buffer, size, EI_RESULT_STREAM_LABELS);
+
+    put_u8(&w, schema->has_anomaly ? EI_RESULT_STREAM_FLAG_ANOMALY : 0);
+    put_u8(&w, schema->label_count);
+    for (uint8_t ix = 0; ix < schema->label_count; ix++) {
+        size_t length = strlen(schema->labels[ix]);
+        if (length > 255) {
+            length = 255;
+        }
+        put_u8(&w, (uint8_t)length);
+        put_bytes(&w, schema->labels[ix], length);
+    }
+
+    return finish_record(&w);
+}
+
+/**
+ * @brief      Encode one inference result
+ * @param      window_end_us  When the input of this inference was complete (e.g. end of the slice)
+ * @param      error          Return value of run_classifier(_continuous)
+ * @return     Record size in bytes, 0 if the buffer is too small for the scores
+ */
+size_t ei_result_stream_encode_result(const ei_result_stream_schema_t *schema,
+                                      uint32_t sequence,
+                                      uint64_t window_end_us,
+                                      const ei_impulse_result_t *result,
+                                      int error,
+                                      uint8_t *buffer,
+                                      size_t size)
+{
+    record_writer_t w;
+    start_record(&w, buffer, size, EI_RESULT_STREAM_RESULT);
+
+    uint8_t flags = schema->has_anomaly ? EI_RESULT_STREAM_FLAG_ANOMALY : 0;
+
+    put_u32(&w, sequence);
+    put_u64(&w, window_end_us);
+    put_u64(&w, ei_read_timer_us());
+    put_u16(&w, (uint16_t)(int16_t)error);
+    size_t flags_offset = w.length;
+    uint8_t score_count = schema->has_scores ? schema->label_count : 0;
+    put_u8(&w, flags);
+    put_u8(&w, score_count);
+    put_u32(&w, clamp_us(result->timing.dsp_us));
+    put_u32(&w, clamp_us(result->timing.classification_us));
+    put_u32(&w, clamp_us(result->timing.anomaly_us));
+    put_u32(&w, clamp_us(result->timing.postprocessing_us));
+
+    for (uint8_t ix = 0; ix < score_count; ix++) {
+        put_u16(&w, quantize_score(result->classification[ix].value));
+    }
+    if (flags & EI_RESULT_STREAM_FLAG_ANOMALY) {
+        put_f32(&w, result->anomaly);
+    }
+
+    // boxes are optional, leave room for the crc and stop at the first one that does not fit
+    size_t count_offset = w.length;
+    uint8_t box_count = 0;
+    put_u8(&w, 0);
+    if (w.overflow) {
+        return 0;
+    }
+    const size_t box_size = 11;
+    for (uint32_t ix = 0; ix < result->bounding_boxes_count && box_count < 255; ix++) {
+        const ei_impulse_result_bounding_box_t *bb = &result->bounding_boxes[ix];
+        if (bb->value == 0) {
+            continue;
+        }
+        if (w.length + box_size + 2 > w.size) {
+            flags |= EI_RESULT_STREAM_FLAG_TRUNCATED;
+            break;
+        }
+        put_u8(&w, label_index(schema, bb->label));
+        put_u16(&w, quantize_score(bb->value));
+        put_u16(&w, clamp_u16(bb->x));
+        put_u16(&w, clamp_u16(bb->y));
+        put_u16(&w, clamp_u16(bb->width));
+        put_u16(&w, clamp_u16(bb->height));
+        box_count++;
+    }
+    w.buffer[count_offset] = box_count;
+    w.buffer[flags_offset] = flags;
+
+    return finish_record(&w);
+}
+
+/**
+ * @brief      Encode a result for a slice that was not classified, it has no scores
+ * @return     Record size in bytes, 0 if the buffer is too small
+ */
+size_t ei_result_stream_encode_skipped(uint32_t sequence, uint64_t window_end_us, uint8_t *buffer, size_t size)
+{
+    record_writer_t w;
+    start_record(&w, buffer, size, EI_RESULT_STREAM_RESULT);
+
+    put_u32(&w, sequence);
+    put_u64(&w, window_end_us);
+    put_u64(&w, ei_read_timer_us());
+    put_u16(&w, 0);
+    put_u8(&w, EI_RESULT_STREAM_FLAG_SKIPPED);
+    put_u8(&w, 0);
+    for (int ix = 0; ix < 4; ix++) {
+        put_u32(&w, 0);
+    }
+    put_u8(&w, 0);
+
+    return finish_record(&w);
+}
@@ -0,0 +1,119 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_RESULT_STREAM_H
+#define EI_RESULT_STREAM_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+
+/*
+ * Binary result records, an alternative to the ei_print_results text output.
+ *
+ * Every record is framed as (all fields little endian):
+ *
+ *   sync     2 bytes  0xEB 0x90
+ *   version  u8       EI_RESULT_STREAM_VERSION
+ *   type     u8       ei_result_stream_type_t
+ *   length   u16      payload length
+ *   payload  length bytes
+ *   crc      u16      CRC-16/CCITT-FALSE over version, type, length and payload
+ *
+ * LABELS payload (sent once when a stream starts):
+ *   flags u8 (EI_RESULT_STREAM_FLAG_ANOMALY), label count u8,
+ *   per label: length u8 + characters (no terminator)
+ *
+ * RESULT payload:
+ *   sequence u32, window end us u64 (input complete), result us u64 (record built),
+ *   error i16, flags u8, score count u8 (label count, or 0 for detection models),
+ *   dsp / classification / anomaly / postprocessing us u32 each,
+ *   per score: score u16 (value * 65535, rounded and clamped to [0, 1]),
+ *   anomaly f32 (only with EI_RESULT_STREAM_FLAG_ANOMALY),
+ *   box count u8, per box: label index u8 (0xFF if not a label), score u16,
+ *   x, y, width, height u16 each
+ *
+ * Newer versions only append fields, decoders skip what they do not know
+ * using the payload length. See tools/decode_results.py for the host side.
+ */
+
+/* Constants --------------------------------------------------------------- */
+#define EI_RESULT_STREAM_SYNC_0         0xEB
+#define EI_RESULT_STREAM_SYNC_1         0x90
+#define EI_RESULT_STREAM_VERSION        1
+
+// sync, version, type and length in front, crc at the end
+#define EI_RESULT_STREAM_FRAME_OVERHEAD 8
+
+// Largest result record the firmware builds, fits the scores of 255 labels,
+// boxes that do not fit anymore are dropped (EI_RESULT_STREAM_FLAG_TRUNCATED)
+#ifndef EI_RESULT_STREAM_MAX_RECORD
+#define EI_RESULT_STREAM_MAX_RECORD     640
+#endif
+
+#define EI_RESULT_STREAM_FLAG_ANOMALY   0x01    // anomaly score present
+#define EI_RESULT_STREAM_FLAG_SKIPPED   0x02    // slice not classified (e.g. VAD gate), no scores
+#define EI_RESULT_STREAM_FLAG_TRUNCATED 0x04    // boxes did not fit in the record
+
+#define EI_RESULT_STREAM_NO_LABEL       0xFF
+
+/* Types ------------------------------------------------------------------- */
+typedef enum {
+    EI_RESULT_STREAM_LABELS = 1,
+    EI_RESULT_STREAM_RESULT = 2
+} ei_result_stream_type_t;
+
+typedef struct {
+    const char * const *labels;         // impulse categories, index order of the scores
+    uint8_t label_count;
+    bool has_scores;                    // classification / regression, one score per label
+    bool has_anomaly;
+} ei_result_stream_schema_t;
+
+/* Function prototypes ----------------------------------------------------- */
+uint16_t ei_result_stream_crc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+size_t ei_result_stream_labels_size(const ei_result_stream_schema_t *schema);
+size_t ei_result_stream_encode_labels(const ei_result_stream_schema_t *schema, uint8_t *buffer, size_t size);
+size_t ei_result_stream_encode_result(const ei_result_stream_schema_t *schema,
+                                      uint32_t sequence,
+                                      uint64_t window_end_us,
+                                      const ei_impulse_result_t *result,
+                                      int error,
+                                      uint8_t *buffer,
+                                      size_t size);
+size_t ei_result_stream_encode_skipped(uint32_t sequence, uint64_t window_end_us, uint8_t *buffer, size_t size);
+
+#endif /* EI_RESULT_STREAM_H */
@@ -0,0 +1,341 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_serial_tx.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+
+static_assert((EI_SERIAL_TX_BUFFER_SIZE & (EI_SERIAL_TX_BUFFER_SIZE - 1)) == 0,
+    "EI_SERIAL_TX_BUFFER_SIZE must be a power of 2");
+
+/* Private variables ------------------------------------------------------- */
+static uint8_t tx_buffer[EI_SERIAL_TX_BUFFER_SIZE];
+// writers (under the port lock) move the head, the drain thread moves the tail, free running counters
+static std::atomic<uint32_t> tx_head;
+static std::atomic<uint32_t> tx_tail;
+static std::atomic<bool> tx_started;
+static const ei_serial_tx_port_t *tx_port = nullptr;
+static ei_serial_tx_policy_t tx_policy = EI_SERIAL_TX_POLICY;
+static ei_serial_tx_stats_t tx_stats;
+static std::atomic<uint64_t> tx_written;
+static bool tx_sink_stalled;    // a write timed out, drop until the tail moves past tx_stalled_tail
+static uint32_t tx_stalled_tail;
+static char tx_print_buf[EI_SERIAL_TX_PRINTF_SIZE];
+
+/* Private functions ------------------------------------------------------- */
+static void tx_lock(void)
+{
+    if (tx_port->lock) {
+        tx_port->lock();
+    }
+}
+
+static void tx_unlock(void)
+{
+    if (tx_port->unlock) {
+        tx_port->unlock();
+    }
+}
+
+static void tx_wake(void)
+{
+    if (tx_port->wake) {
+        tx_port->wake();
+    }
+}
+
+static void tx_wait(void)
+{
+    if (tx_port->wait) {
+        tx_port->wait();
+    }
+}
+
+/**
+ * @brief      Wait until the tail moves past target, giving up when the sink takes
+ *             nothing for EI_SERIAL_TX_STALL_TIMEOUT_MS
+ *
+ * @return     false on timeout
+ */
+static bool tx_wait_for_tail(uint32_t target)
+{
+    uint32_t tail = tx_tail.load(std::memory_order_acquire);
+    uint64_t progress_us = ei_read_timer_us();
+
+    while ((int32_t)(target - tail) > 0) {
+        tx_wake();
+        tx_wait();
+
+        uint32_t now_tail = tx_tail.load(std::memory_order_acquire);
+        if (now_tail != tail) {
+            tail = now_tail;
+            progress_us = ei_read_timer_us();
+        }
+        else if (ei_read_timer_us() - progress_us >= (uint64_t)EI_SERIAL_TX_STALL_TIMEOUT_MS * 1000) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief      Write straight to the sink, until the drain thread is started
+ */
+static size_t tx_write_direct(const uint8_t *data, size_t length)
+{
+    size_t sent = 0;
+
+    while (sent < length) {
+        size_t n = tx_port->write(data + sent, length - sent);
+        if (n == 0) {
+            break;
+        }
+        sent += n;
+    }
+    tx_written += sent;
+
+    return sent;
+}
+
+/**
+ * @brief      Queue data, caller holds the port lock
+ */
+static size_t tx_write_locked(const uint8_t *data, size_t length)
+{
+    uint32_t head = tx_head.load(std::memory_order_relaxed);
+    uint64_t stall_start = 0;
+    bool stalled = false;
+    size_t queued = 0;
+
+    if (!tx_started.load(std::memory_order_acquire)) {
+        return tx_write_direct(data, length);
+    }
+
+    if (tx_sink_stalled && (tx_tail.load(std::memory_order_acquire) != tx_stalled_tail)) {
+        tx_sink_stalled = false;
+    }
+
+    if ((tx_policy == EI_SERIAL_TX_DROP) || tx_sink_stalled) {
+        uint32_t space = EI_SERIAL_TX_BUFFER_SIZE - (head - tx_tail.load(std::memory_order_acquire));
+        if (length > space) {
+            tx_stats.dropped += length;
+            return 0;
+        }
+    }
+
+    while (queued < length) {
+        uint32_t space = EI_SERIAL_TX_BUFFER_SIZE - (head - tx_tail.load(std::memory_order_acquire));
+
+        if (space == 0) {
+            if (!stalled) {
+                stalled = true;
+                stall_start = ei_read_timer_us();
+                tx_stats.stalls++;
+            }
+            // room for the next byte, or the sink stopped taking data
+            if (!tx_wait_for_tail(head - EI_SERIAL_TX_BUFFER_SIZE + 1)) {
+                tx_sink_stalled = true;
+                tx_stalled_tail = tx_tail.load(std::memory_order_acquire);
+                tx_stats.timeouts++;
+                tx_stats.dropped += length - queued;
+                break;
+            }
+            continue;
+        }
+
+        uint32_t offset = head & (EI_SERIAL_TX_BUFFER_SIZE - 1);
+        size_t n = std::min<size_t>({ length - queued, space, EI_SERIAL_TX_BUFFER_SIZE - offset });
+
+        memcpy(&tx_buffer[offset], data + queued, n);
+        head += (uint32_t)n;
+        queued += n;
+        tx_head.store(head, std::memory_order_release);
+        tx_stats.high_water = std::max(tx_stats.high_water, head - tx_tail.load(std::memory_order_acquire));
+    }
+
+    if (stalled) {
+        tx_stats.stall_us += ei_read_timer_us() - stall_start;
+    }
+
+    tx_wake();
+
+    return queued;
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief      Connect the output channel to a sink. Writes go straight to the sink
+ *             until ei_serial_tx_start() is called.
+ */
+void ei_serial_tx_init(const ei_serial_tx_port_t *port)
+{
+    tx_port = port;
+    tx_started = false;
+    tx_head = 0;
+    tx_tail = 0;
+    tx_sink_stalled = false;
+    ei_serial_tx_reset_stats();
+}
+
+/**
+ * @brief      Start buffering, call once the thread running ei_serial_tx_drain() is up
+ */
+void ei_serial_tx_start(void)
+{
+    tx_started.store(tx_port != nullptr, std::memory_order_release);
+}
+
+void ei_serial_tx_set_policy(ei_serial_tx_policy_t policy)
+{
+    tx_policy = policy;
+}
+
+/**
+ * @brief      Queue data for the device
+ *
+ * @return     Bytes queued, 0 if the write was dropped
+ */
+size_t ei_serial_tx_write(const void *data, size_t length)
+{
+    size_t queued;
+
+    if (tx_port == nullptr) {
+        return 0;
+    }
+
+    tx_lock();
+    queued = tx_write_locked((const uint8_t *)data, length);
+    tx_unlock();
+
+    return queued;
+}
+
+/**
+ * @brief      Format and queue, output longer than EI_SERIAL_TX_PRINTF_SIZE - 1 is cut
+ *
+ * @return     Bytes queued
+ */
+int ei_serial_tx_vprintf(const char *format, va_list args)
+{
+    int queued = 0;
+
+    if (tx_port == nullptr) {
+        return 0;
+    }
+
+    tx_lock();
+    int r = vsnprintf(tx_print_buf, sizeof(tx_print_buf), format, args);
+    if (r > 0) {
+        queued = (int)tx_write_locked((const uint8_t *)tx_print_buf, std::min<size_t>(r, sizeof(tx_print_buf) - 1));
+    }
+    tx_unlock();
+
+    return queued;
+}
+
+/**
+ * @brief      Hand the next block of queued data to the sink. Run from the drain thread
+ *             until it returns 0, then wait for the wake hook.
+ *
+ * @return     Bytes written
+ */
+size_t ei_serial_tx_drain(void)
+{
+    uint32_t tail = tx_tail.load(std::memory_order_relaxed);
+    uint32_t pending = tx_head.load(std::memory_order_acquire) - tail;
+
+    if ((tx_port == nullptr) || (pending == 0)) {
+        return 0;
+    }
+
+    uint32_t offset = tail & (EI_SERIAL_TX_BUFFER_SIZE - 1);
+    size_t n = std::min<size_t>({ pending, EI_SERIAL_TX_BUFFER_SIZE - offset, EI_SERIAL_TX_CHUNK_SIZE });
+
+    n = tx_port->write(&tx_buffer[offset], n);
+    tx_tail.store(tail + (uint32_t)n, std::memory_order_release);
+    tx_written += n;
+
+    return n;
+}
+
+/**
+ * @brief      Barrier: return once everything queued before the call has been
+ *             handed to the sink (e.g. after END OUTPUT)
+ *
+ * @return     false if the sink took nothing for EI_SERIAL_TX_STALL_TIMEOUT_MS
+ */
+bool ei_serial_tx_flush(void)
+{
+    if ((tx_port == nullptr) || !tx_started.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    uint32_t target = tx_head.load(std::memory_order_acquire);
+    if ((int32_t)(target - tx_tail.load(std::memory_order_acquire)) <= 0) {
+        return true;
+    }
+
+    uint64_t stall_start = ei_read_timer_us();
+    bool flushed = tx_wait_for_tail(target);
+
+    tx_lock();
+    tx_stats.stalls++;
+    tx_stats.stall_us += ei_read_timer_us() - stall_start;
+    if (!flushed) {
+        tx_stats.timeouts++;
+    }
+    tx_unlock();
+
+    return flushed;
+}
+
+void ei_serial_tx_get_stats(ei_serial_tx_stats_t *stats)
+{
+    *stats = tx_stats;
+    stats->queued = tx_head.load(std::memory_order_acquire) - tx_tail.load(std::memory_order_acquire);
+    stats->written = tx_written.load();
+}
+
+void ei_serial_tx_reset_stats(void)
+{
+    memset(&tx_stats, 0, sizeof(tx_stats));
+    tx_written = 0;
+}
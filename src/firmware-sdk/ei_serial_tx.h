@@ -0,0 +1,113 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EI_SERIAL_TX_H
+#define EI_SERIAL_TX_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+/* Constants --------------------------------------------------------------- */
+// Bytes buffered between the writers and the drain thread, power of 2
+#ifndef EI_SERIAL_TX_BUFFER_SIZE
+#define EI_SERIAL_TX_BUFFER_SIZE        8192
+#endif
+
+// Largest block handed to the sink in one write call
+#ifndef EI_SERIAL_TX_CHUNK_SIZE
+#define EI_SERIAL_TX_CHUNK_SIZE         512
+#endif
+
+// Size of the ei_printf format buffer
+#ifndef EI_SERIAL_TX_PRINTF_SIZE
+#define EI_SERIAL_TX_PRINTF_SIZE        1024
+#endif
+
+// What a write does when the buffer is full, see ei_serial_tx_policy_t
+#ifndef EI_SERIAL_TX_POLICY
+#define EI_SERIAL_TX_POLICY             EI_SERIAL_TX_BLOCK
+#endif
+
+// A blocked write or flush gives up when the sink takes nothing for this long; writes
+// are then dropped (as with EI_SERIAL_TX_DROP) until the sink takes data again
+#ifndef EI_SERIAL_TX_STALL_TIMEOUT_MS
+#define EI_SERIAL_TX_STALL_TIMEOUT_MS   1000
+#endif
+
+/* Types ------------------------------------------------------------------- */
+typedef enum {
+    EI_SERIAL_TX_BLOCK = 0,     // wait for the drain thread to make room
+    EI_SERIAL_TX_DROP = 1       // drop writes that do not fit (never cut in half)
+} ei_serial_tx_policy_t;
+
+/**
+ * Platform hooks. Only write is required; without lock, all output must come from one thread.
+ */
+typedef struct {
+    // Send bytes to the device, may block, returns the number of bytes sent
+    size_t (*write)(const uint8_t *data, size_t length);
+    // Serialize writers
+    void (*lock)(void);
+    void (*unlock)(void);
+    // Data was queued, wake the drain thread
+    void (*wake)(void);
+    // A writer waits for room or a flush, sleep or yield for a short while
+    void (*wait)(void);
+} ei_serial_tx_port_t;
+
+typedef struct {
+    uint32_t queued;            // bytes waiting in the buffer
+    uint32_t high_water;        // most bytes ever waiting
+    uint64_t written;           // bytes handed to the sink
+    uint64_t dropped;           // bytes dropped on a full buffer (drop policy or stalled sink)
+    uint32_t stalls;            // writes and flushes that had to wait
+    uint64_t stall_us;          // time writers spent waiting for room or a flush
+    uint32_t timeouts;          // writes and flushes that gave up on a stalled sink
+} ei_serial_tx_stats_t;
+
+/* Function prototypes ----------------------------------------------------- */
+void ei_serial_tx_init(const ei_serial_tx_port_t *port);
+void ei_serial_tx_start(void);
+void ei_serial_tx_set_policy(ei_serial_tx_policy_t policy);
+size_t ei_serial_tx_write(const void *data, size_t length);
+int ei_serial_tx_vprintf(const char *format, va_list args);
+size_t ei_serial_tx_drain(void);
+bool ei_serial_tx_flush(void);
+void ei_serial_tx_get_stats(ei_serial_tx_stats_t *stats);
+void ei_serial_tx_reset_stats(void);
+
+#endif /* EI_SERIAL_TX_H */
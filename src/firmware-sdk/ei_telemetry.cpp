@@ -0,0 +1,395 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_telemetry.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+/* Private variables ------------------------------------------------------- */
+// histograms and the slowest list are only written by the inference thread, reset and
+// print them while no inference runs. Counters are also bumped from the audio callbacks.
+static ei_telemetry_histogram_t histograms[EI_TELEMETRY_STAGE_COUNT];
+static ei_telemetry_slow_entry_t slowest[EI_TELEMETRY_SLOWEST_SIZE];
+static size_t slowest_size = 0;
+static uint32_t inferences = 0;
+static uint32_t errors = 0;
+static std::atomic<uint32_t> counters[EI_TELEMETRY_COUNTER_COUNT];
+
+static const char *stage_names[EI_TELEMETRY_STAGE_COUNT] = {
+    "dsp", "classification", "anomaly", "postprocessing", "total"
+};
+
+/* Private functions ------------------------------------------------------- */
+/**
+ * @brief      Log-linear bucket: values under 2^SUB_BITS have their own bucket, above that
+ *             each power of 2 is split in 2^SUB_BITS equal buckets
+ */
+static inline uint32_t bucket_index(uint32_t us)
+{
+    if (us < (1u << EI_TELEMETRY_HIST_SUB_BITS)) {
+        return us;
+    }
+
+    uint32_t msb = 31 - __builtin_clz(us);
+    uint32_t sub = (us >> (msb - EI_TELEMETRY_HIST_SUB_BITS)) & ((1u << EI_TELEMETRY_HIST_SUB_BITS) - 1);
+    uint32_t ix = ((msb - EI_TELEMETRY_HIST_SUB_BITS + 1) << EI_TELEMETRY_HIST_SUB_BITS) + sub;
+
+    return ix < EI_TELEMETRY_HIST_BUCKETS ? ix : EI_TELEMETRY_HIST_BUCKETS - 1;
+}
+
+static uint32_t bucket_lower_us(uint32_t ix)
+{
+    if (ix < (1u << EI_TELEMETRY_HIST_SUB_BITS)) {
+        return ix;
+    }
+
+    uint32_t octave = ix >> EI_TELEMETRY_HIST_SUB_BITS;
+    uint32_t sub = ix & ((1u << EI_TELEMETRY_HIST_SUB_BITS) - 1);
+
+    return ((1u << EI_TELEMETRY_HIST_SUB_BITS) + sub) << (octave - 1);
+}
+
+static inline uint32_t clamp_us(int64_t us)
+{
+    if (us < 0) {
+        return 0;
+    }
+    return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static inline void histogram_add(ei_telemetry_histogram_t *hist, uint32_t us)
+{
+    if (hist->count == 0 || us < hist->min_us) {
+        hist->min_us = us;
+    }
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+    hist->count++;
+    hist->sum_us += us;
+    hist->buckets[bucket_index(us)]++;
+}
+
+/**
+ * @brief      Slot for a new slow entry: a free one, else one that has aged out, else the
+ *             fastest entry if the new inference was slower. -1 if it does not make the list.
+ */
+static int slowest_slot(uint32_t sequence, uint32_t total_us)
+{
+    if (slowest_size < EI_TELEMETRY_SLOWEST_SIZE) {
+        return (int)slowest_size++;
+    }
+
+    int fastest = 0;
+    for (size_t ix = 0; ix < slowest_size; ix++) {
+        if (sequence - slowest[ix].sequence > EI_TELEMETRY_SLOWEST_MAX_AGE) {
+            return (int)ix;
+        }
+        if (slowest[ix].stage_us[EI_TELEMETRY_STAGE_TOTAL] < slowest[fastest].stage_us[EI_TELEMETRY_STAGE_TOTAL]) {
+            fastest = (int)ix;
+        }
+    }
+
+    return total_us > slowest[fastest].stage_us[EI_TELEMETRY_STAGE_TOTAL] ? fastest : -1;
+}
+
+static void print_to(void (*write)(const char *text, void *ctx), void *ctx, const char *format, ...)
+{
+    char buf[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    if (write) {
+        write(buf, ctx);
+    }
+    else {
+        ei_printf("%s", buf);
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+/**
+ * @brief      Add one inference. Stages with a 0 us time did not run (or took under 1 us)
+ *             and are left out of their histogram, the total always counts.
+ *
+ * @param[in]  stage_us    Time spent per stage
+ * @param[in]  error       EI_IMPULSE_ERROR of the run
+ * @param[in]  continuous  Slice of a continuous run
+ */
+void ei_telemetry_record(const uint32_t stage_us[EI_TELEMETRY_STAGE_COUNT], int error, bool continuous)
+{
+    uint32_t sequence = ++inferences;
+    if (error != 0) {
+        errors++;
+    }
+
+    for (size_t ix = 0; ix < EI_TELEMETRY_STAGE_COUNT; ix++) {
+        if (stage_us[ix] > 0 || ix == EI_TELEMETRY_STAGE_TOTAL) {
+            histogram_add(&histograms[ix], stage_us[ix]);
+        }
+    }
+
+    int slot = slowest_slot(sequence, stage_us[EI_TELEMETRY_STAGE_TOTAL]);
+    if (slot >= 0) {
+        ei_telemetry_slow_entry_t *entry = &slowest[slot];
+        entry->sequence = sequence;
+        entry->timestamp_us = ei_read_timer_us();
+        memcpy(entry->stage_us, stage_us, sizeof(entry->stage_us));
+        entry->skipped_slices = counters[EI_TELEMETRY_SKIPPED_SLICES].load(std::memory_order_relaxed);
+        entry->audio_overruns = counters[EI_TELEMETRY_AUDIO_OVERRUNS].load(std::memory_order_relaxed);
+        entry->error = (int16_t)error;
+        entry->continuous = continuous;
+    }
+}
+
+/**
+ * @brief      Bump an event counter, safe from interrupts and other threads
+ */
+void ei_telemetry_count(ei_telemetry_counter_t counter, uint32_t n)
+{
+    counters[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+uint32_t ei_telemetry_get_counter(ei_telemetry_counter_t counter)
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+const ei_telemetry_histogram_t *ei_telemetry_get_histogram(ei_telemetry_stage_t stage)
+{
+    return &histograms[stage];
+}
+
+/**
+ * @brief      Percentile estimate from the histogram, the upper edge of the bucket it falls in
+ *             (clamped to the measured min and max)
+ *
+ * @param[in]  stage      The stage
+ * @param[in]  per_mille  Percentile in 1/1000 (990 = p99)
+ *
+ * @return     Time in us, 0 if the stage never ran
+ */
+uint32_t ei_telemetry_percentile(ei_telemetry_stage_t stage, uint32_t per_mille)
+{
+    const ei_telemetry_histogram_t *hist = &histograms[stage];
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = ((uint64_t)hist->count * per_mille + 999) / 1000;
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (uint32_t ix = 0; ix < EI_TELEMETRY_HIST_BUCKETS; ix++) {
+        seen += hist->buckets[ix];
+        if (seen >= rank) {
+            uint32_t upper_us = ix + 1 < EI_TELEMETRY_HIST_BUCKETS ? bucket_lower_us(ix + 1) - 1 : hist->max_us;
+            if (upper_us > hist->max_us) {
+                upper_us = hist->max_us;
+            }
+            return upper_us < hist->min_us ? hist->min_us : upper_us;
+        }
+    }
+
+    return hist->max_us;
+}
+
+/**
+ * @brief      Copy the slowest recent inferences, slowest first
+ *
+ * @return     Number of entries copied
+ */
+size_t ei_telemetry_get_slowest(ei_telemetry_slow_entry_t *entries, size_t max_entries)
+{
+    size_t n = slowest_size < max_entries ? slowest_size : max_entries;
+    bool taken[EI_TELEMETRY_SLOWEST_SIZE] = { false };
+
+    for (size_t out = 0; out < n; out++) {
+        int pick = -1;
+        for (size_t ix = 0; ix < slowest_size; ix++) {
+            if (!taken[ix] && (pick < 0 ||
+                slowest[ix].stage_us[EI_TELEMETRY_STAGE_TOTAL] > slowest[pick].stage_us[EI_TELEMETRY_STAGE_TOTAL])) {
+                pick = (int)ix;
+            }
+        }
+        taken[pick] = true;
+        entries[out] = slowest[pick];
+    }
+
+    return n;
+}
+
+void ei_telemetry_reset(void)
+{
+    memset(histograms, 0, sizeof(histograms));
+    memset(slowest, 0, sizeof(slowest));
+    slowest_size = 0;
+    inferences = 0;
+    errors = 0;
+    for (size_t ix = 0; ix < EI_TELEMETRY_COUNTER_COUNT; ix++) {
+        counters[ix].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief      Print counters, per stage percentiles and the slowest inferences (AT+STATS)
+ */
+void ei_telemetry_print(void)
+{
+    ei_telemetry_slow_entry_t entries[EI_TELEMETRY_SLOWEST_SIZE];
+    size_t n_entries = ei_telemetry_get_slowest(entries, EI_TELEMETRY_SLOWEST_SIZE);
+
+    ei_printf("Inferences: %u (%u errors), %u skipped slices, %u audio overruns, %u allocation failures\n",
+        (unsigned int)inferences, (unsigned int)errors,
+        (unsigned int)ei_telemetry_get_counter(EI_TELEMETRY_SKIPPED_SLICES),
+        (unsigned int)ei_telemetry_get_counter(EI_TELEMETRY_AUDIO_OVERRUNS),
+        (unsigned int)ei_telemetry_get_counter(EI_TELEMETRY_ALLOC_FAILURES));
+
+    for (size_t ix = 0; ix < EI_TELEMETRY_STAGE_COUNT; ix++) {
+        const ei_telemetry_histogram_t *hist = &histograms[ix];
+        if (hist->count == 0) {
+            continue;
+        }
+        ei_telemetry_stage_t stage = (ei_telemetry_stage_t)ix;
+        ei_printf("%s: %u runs, min %u us, avg %u us, p50 %u us, p90 %u us, p99 %u us, max %u us\n",
+            stage_names[ix], (unsigned int)hist->count, (unsigned int)hist->min_us,
+            (unsigned int)(hist->sum_us / hist->count),
+            (unsigned int)ei_telemetry_percentile(stage, 500), (unsigned int)ei_telemetry_percentile(stage, 900),
+            (unsigned int)ei_telemetry_percentile(stage, 990), (unsigned int)hist->max_us);
+    }
+
+    for (size_t ix = 0; ix < n_entries; ix++) {
+        const ei_telemetry_slow_entry_t *entry = &entries[ix];
+        ei_printf("Slow #%u at %u ms: %u us (dsp %u, classification %u, anomaly %u, postprocessing %u)%s, "
+            "error %d, %u skipped slices, %u audio overruns\n",
+            (unsigned int)entry->sequence, (unsigned int)(entry->timestamp_us / 1000),
+            (unsigned int)entry->stage_us[EI_TELEMETRY_STAGE_TOTAL],
+            (unsigned int)entry->stage_us[EI_TELEMETRY_STAGE_DSP],
+            (unsigned int)entry->stage_us[EI_TELEMETRY_STAGE_CLASSIFICATION],
+            (unsigned int)entry->stage_us[EI_TELEMETRY_STAGE_ANOMALY],
+            (unsigned int)entry->stage_us[EI_TELEMETRY_STAGE_POSTPROCESSING],
+            entry->continuous ? ", continuous" : "",
+            (int)entry->error, (unsigned int)entry->skipped_slices, (unsigned int)entry->audio_overruns);
+    }
+}
+
+/**
+ * @brief      Dump everything as one JSON object, including the non-empty histogram buckets
+ *             as [lower bound in us, count] pairs
+ *
+ * @param      write  Output for the text pieces, nullptr prints with ei_printf
+ * @param      ctx    Passed to write
+ */
+void ei_telemetry_print_json(void (*write)(const char *text, void *ctx), void *ctx)
+{
+    ei_telemetry_slow_entry_t entries[EI_TELEMETRY_SLOWEST_SIZE];
+    size_t n_entries = ei_telemetry_get_slowest(entries, EI_TELEMETRY_SLOWEST_SIZE);
+
+    print_to(write, ctx, "{\"inferences\":%u,\"errors\":%u,\"skipped_slices\":%u,\"audio_overruns\":%u,"
+        "\"alloc_failures\":%u,\"stages\":{",
+        (unsigned int)inferences, (unsigned int)errors,
+        (unsigned int)ei_telemetry_get_counter(EI_TELEMETRY_SKIPPED_SLICES),
+        (unsigned int)ei_telemetry_get_counter(EI_TELEMETRY_AUDIO_OVERRUNS),
+        (unsigned int)ei_telemetry_get_counter(EI_TELEMETRY_ALLOC_FAILURES));
+
+    for (size_t ix = 0; ix < EI_TELEMETRY_STAGE_COUNT; ix++) {
+        const ei_telemetry_histogram_t *hist = &histograms[ix];
+        ei_telemetry_stage_t stage = (ei_telemetry_stage_t)ix;
+
+        print_to(write, ctx, "%s\"%s\":{\"count\":%u,\"min_us\":%u,\"avg_us\":%u,\"max_us\":%u,",
+            ix > 0 ? "," : "", stage_names[ix], (unsigned int)hist->count,
+            (unsigned int)hist->min_us, (unsigned int)(hist->count > 0 ? hist->sum_us / hist->count : 0),
+            (unsigned int)hist->max_us);
+        print_to(write, ctx, "\"p50_us\":%u,\"p90_us\":%u,\"p99_us\":%u,\"buckets\":[",
+            (unsigned int)ei_telemetry_percentile(stage, 500), (unsigned int)ei_telemetry_percentile(stage, 900),
+            (unsigned int)ei_telemetry_percentile(stage, 990));
+
+        bool first = true;
+        for (uint32_t bx = 0; bx < EI_TELEMETRY_HIST_BUCKETS; bx++) {
+            if (hist->buckets[bx] == 0) {
+                continue;
+            }
+            print_to(write, ctx, "%s[%u,%u]", first ? "" : ",",
+                (unsigned int)bucket_lower_us(bx), (unsigned int)hist->buckets[bx]);
+            first = false;
+        }
+        print_to(write, ctx, "]}");
+    }
+
+    print_to(write, ctx, "},\"slowest\":[");
+    for (size_t ix = 0; ix < n_entries; ix++) {
+        const ei_telemetry_slow_entry_t *entry = &entries[ix];
+        print_to(write, ctx, "%s{\"sequence\":%u,\"timestamp_ms\":%u,\"continuous\":%s,\"error\":%d,",
+            ix > 0 ? "," : "", (unsigned int)entry->sequence, (unsigned int)(entry->timestamp_us / 1000),
+            entry->continuous ? "true" : "false", (int)entry->error);
+        print_to(write, ctx, "\"skipped_slices\":%u,\"audio_overruns\":%u",
+            (unsigned int)entry->skipped_slices, (unsigned int)entry->audio_overruns);
+        for (size_t sx = 0; sx < EI_TELEMETRY_STAGE_COUNT; sx++) {
+            print_to(write, ctx, ",\"%s_us\":%u", stage_names[sx], (unsigned int)entry->stage_us[sx]);
+        }
+        print_to(write, ctx, "}");
+    }
+    print_to(write, ctx, "]}\n");
+}
+
+/**
+ * @brief      Hook the SDK calls after every process_impulse / process_impulse_continuous
+ *             when it is built with EI_CLASSIFIER_TELEMETRY=1
+ */
+void ei_telemetry_record_inference(const ei_impulse_result_t *result, EI_IMPULSE_ERROR res, bool continuous, uint64_t total_us)
+{
+    uint32_t stage_us[EI_TELEMETRY_STAGE_COUNT];
+
+    stage_us[EI_TELEMETRY_STAGE_DSP] = clamp_us(result->timing.dsp_us);
+    stage_us[EI_TELEMETRY_STAGE_CLASSIFICATION] = clamp_us(result->timing.classification_us);
+    stage_us[EI_TELEMETRY_STAGE_ANOMALY] = clamp_us(result->timing.anomaly_us);
+    stage_us[EI_TELEMETRY_STAGE_POSTPROCESSING] = clamp_us(result->timing.postprocessing_us);
+    stage_us[EI_TELEMETRY_STAGE_TOTAL] = clamp_us((int64_t)total_us);
+
+    if (res == EI_IMPULSE_ALLOC_FAILED || res == EI_IMPULSE_OUT_OF_MEMORY ||
+        res == EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED) {
+        ei_telemetry_count(EI_TELEMETRY_ALLOC_FAILURES);
+    }
+
+    ei_telemetry_record(stage_us, res, continuous);
+}
@@ -0,0 +1,112 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_TELEMETRY_H
+#define EI_TELEMETRY_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Constants --------------------------------------------------------------- */
+// Histogram resolution: each power of 2 is split in 2^SUB_BITS buckets (2 bits: within 25%)
+#ifndef EI_TELEMETRY_HIST_SUB_BITS
+#define EI_TELEMETRY_HIST_SUB_BITS      2
+#endif
+
+// Powers of 2 covered by the histograms (27: up to 268 s), slower runs go in the last bucket
+#ifndef EI_TELEMETRY_HIST_OCTAVES
+#define EI_TELEMETRY_HIST_OCTAVES       27
+#endif
+
+// Slowest inferences kept with their context
+#ifndef EI_TELEMETRY_SLOWEST_SIZE
+#define EI_TELEMETRY_SLOWEST_SIZE       8
+#endif
+
+// After this many inferences a slow entry is replaced first, so the list follows recent runs
+#ifndef EI_TELEMETRY_SLOWEST_MAX_AGE
+#define EI_TELEMETRY_SLOWEST_MAX_AGE    1000
+#endif
+
+#define EI_TELEMETRY_HIST_BUCKETS       (EI_TELEMETRY_HIST_OCTAVES << EI_TELEMETRY_HIST_SUB_BITS)
+
+/* Types ------------------------------------------------------------------- */
+typedef enum {
+    EI_TELEMETRY_STAGE_DSP = 0,
+    EI_TELEMETRY_STAGE_CLASSIFICATION,
+    EI_TELEMETRY_STAGE_ANOMALY,
+    EI_TELEMETRY_STAGE_POSTPROCESSING,
+    EI_TELEMETRY_STAGE_TOTAL,           // process_impulse call, including allocations and copies
+    EI_TELEMETRY_STAGE_COUNT
+} ei_telemetry_stage_t;
+
+typedef enum {
+    EI_TELEMETRY_SKIPPED_SLICES = 0,    // slices not classified (VAD gate, scheduler catching up)
+    EI_TELEMETRY_AUDIO_OVERRUNS,        // audio blocks or slices lost because the reader was late
+    EI_TELEMETRY_ALLOC_FAILURES,        // inferences and capture buffers that ran out of memory
+    EI_TELEMETRY_COUNTER_COUNT
+} ei_telemetry_counter_t;
+
+typedef struct {
+    uint32_t count;                     // inferences that ran the stage
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[EI_TELEMETRY_HIST_BUCKETS];
+} ei_telemetry_histogram_t;
+
+typedef struct {
+    uint32_t sequence;                  // inference number since the last reset
+    uint64_t timestamp_us;              // end of the inference
+    uint32_t stage_us[EI_TELEMETRY_STAGE_COUNT];
+    uint32_t skipped_slices;            // counters when the inference ended
+    uint32_t audio_overruns;
+    int16_t error;                      // EI_IMPULSE_ERROR
+    bool continuous;                    // slice of run_classifier_continuous
+} ei_telemetry_slow_entry_t;
+
+/* Function prototypes ----------------------------------------------------- */
+void ei_telemetry_record(const uint32_t stage_us[EI_TELEMETRY_STAGE_COUNT], int error, bool continuous);
+void ei_telemetry_count(ei_telemetry_counter_t counter, uint32_t n = 1);
+uint32_t ei_telemetry_get_counter(ei_telemetry_counter_t counter);
+const ei_telemetry_histogram_t *ei_telemetry_get_histogram(ei_telemetry_stage_t stage);
+uint32_t ei_telemetry_percentile(ei_telemetry_stage_t stage, uint32_t per_mille);
+size_t ei_telemetry_get_slowest(ei_telemetry_slow_entry_t *entries, size_t max_entries);
+void ei_telemetry_reset(void);
+void ei_telemetry_print(void);
+void ei_telemetry_print_json(void (*write)(const char *text, void *ctx) = nullptr, void *ctx = nullptr);
+
+#endif /* EI_TELEMETRY_H */
@@ -0,0 +1,220 @@
+import json
+import os
+import stat
+import struct
+import sys
+
+# Decoder for the binary result records of AT+RUNIMPULSECONT=BINARY,
+# the record layout is described in firmware-sdk/ei_result_stream.h
+
+SYNC = b"\xeb\x90"
+VERSION = 1
+TYPE_LABELS = 1
+TYPE_RESULT = 2
+
+FLAG_ANOMALY = 0x01
+FLAG_SKIPPED = 0x02
+FLAG_TRUNCATED = 0x04
+
+NO_LABEL = 0xFF
+# a false sync in the text output should not make the decoder wait for 64K,
+# results are at most EI_RESULT_STREAM_MAX_RECORD, only label names can be long
+MAX_PAYLOAD = {TYPE_LABELS: 2 + 255 * 256, TYPE_RESULT: 4096}
+
+def crc16(data, crc=0xFFFF):
+    # CRC-16/CCITT-FALSE
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def decode_labels(payload):
+    flags, count = struct.unpack_from("<BB", payload, 0)
+    offset = 2
+    labels = []
+    for _ in range(count):
+        length = payload[offset]
+        labels.append(payload[offset + 1:offset + 1 + length].decode("utf-8", "replace"))
+        offset += 1 + length
+    return {"type": "labels", "labels": labels, "has_anomaly": bool(flags & FLAG_ANOMALY)}
+
+def decode_result(payload, labels):
+    (sequence, window_end_us, result_us, error, flags, score_count,
+     dsp_us, classification_us, anomaly_us, postprocessing_us) = struct.unpack_from("<IQQhBBIIII", payload, 0)
+    offset = struct.calcsize("<IQQhBBIIII")
+
+    scores = struct.unpack_from("<%dH" % score_count, payload, offset)
+    offset += 2 * score_count
+
+    record = {
+        "type": "result",
+        "sequence": sequence,
+        "window_end_us": window_end_us,
+        "result_us": result_us,
+        "error": error,
+        "skipped": bool(flags & FLAG_SKIPPED),
+        "timing_us": {
+            "dsp": dsp_us,
+            "classification": classification_us,
+            "anomaly": anomaly_us,
+            "postprocessing": postprocessing_us,
+        },
+        "classification": {},
+    }
+    for ix, score in enumerate(scores):
+        name = labels[ix] if ix < len(labels) else str(ix)
+        record["classification"][name] = score / 65535.0
+
+    if flags & FLAG_ANOMALY:
+        record["anomaly"] = struct.unpack_from("<f", payload, offset)[0]
+        offset += 4
+
+    boxes = []
+    box_count = payload[offset]
+    offset += 1
+    for _ in range(box_count):
+        label_ix, score, x, y, width, height = struct.unpack_from("<BHHHHH", payload, offset)
+        offset += struct.calcsize("<BHHHHH")
+        if label_ix != NO_LABEL and label_ix < len(labels):
+            label = labels[label_ix]
+        else:
+            label = None
+        boxes.append({"label": label, "value": score / 65535.0, "x": x, "y": y, "width": width, "height": height})
+    if boxes or flags & FLAG_TRUNCATED:
+        record["bounding_boxes"] = boxes
+        record["truncated"] = bool(flags & FLAG_TRUNCATED)
+    return record
+
+class ResultStreamDecoder:
+    """Splits a byte stream in records and the text printed in between"""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.labels = []
+        self.records = 0
+        self.crc_errors = 0
+        self.lost = 0
+        self.last_sequence = None
+
+    def feed(self, data):
+        """Returns a list of ("record", dict) and ("text", str) items"""
+        self.buffer += data
+        out = []
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                # keep a trailing first sync byte, the second one may be in the next read
+                keep = 1 if self.buffer[-1:] == SYNC[:1] else 0
+                self._text(out, self.buffer[:len(self.buffer) - keep])
+                del self.buffer[:len(self.buffer) - keep]
+                return out
+            self._text(out, self.buffer[:start])
+            del self.buffer[:start]
+
+            if len(self.buffer) < 6:
+                return out
+            version, rtype, length = struct.unpack_from("<BBH", self.buffer, 2)
+            if length > MAX_PAYLOAD.get(rtype, 0):
+                self._resync(out)
+                continue
+            if len(self.buffer) < 8 + length:
+                return out
+
+            frame = bytes(self.buffer[:8 + length])
+            (crc,) = struct.unpack_from("<H", frame, 6 + length)
+            if crc16(frame[2:6 + length]) != crc:
+                self.crc_errors += 1
+                self._resync(out)
+                continue
+            del self.buffer[:8 + length]
+
+            record = self._decode(version, rtype, frame[6:6 + length])
+            if record is not None:
+                self.records += 1
+                out.append(("record", record))
+
+    def _decode(self, version, rtype, payload):
+        if version < 1:
+            return None
+        # newer versions only append fields, decode what version 1 has
+        if rtype == TYPE_LABELS:
+            record = decode_labels(payload)
+            self.labels = record["labels"]
+            self.last_sequence = None
+            return record
+        if rtype == TYPE_RESULT:
+            record = decode_result(payload, self.labels)
+            if self.last_sequence is not None and record["sequence"] != self.last_sequence + 1:
+                self.lost += (record["sequence"] - self.last_sequence - 1) & 0xFFFFFFFF
+            self.last_sequence = record["sequence"]
+            return record
+        return None
+
+    def _resync(self, out):
+        # not a record after all, treat the sync bytes as text
+        self._text(out, self.buffer[:1])
+        del self.buffer[:1]
+
+    def _text(self, out, data):
+        if data:
+            out.append(("text", bytes(data).decode("utf-8", "replace")))
+
+def format_record(record):
+    if record["type"] == "labels":
+        return "Labels: {}{}".format(", ".join(record["labels"]), " (+anomaly)" if record["has_anomaly"] else "")
+    if record["skipped"]:
+        return "#{} skipped".format(record["sequence"])
+    timing = record["timing_us"]
+    line = "#{} err={} dsp={}us nn={}us".format(record["sequence"], record["error"], timing["dsp"], timing["classification"])
+    for name, value in record["classification"].items():
+        line += " {}={:.5f}".format(name, value)
+    if "anomaly" in record:
+        line += " anomaly={:.5f}".format(record["anomaly"])
+    for bb in record.get("bounding_boxes", []):
+        line += " [{} {:.5f} x={} y={} w={} h={}]".format(bb["label"], bb["value"], bb["x"], bb["y"], bb["width"], bb["height"])
+    return line
+
+def open_input(path, baudrate):
+    if path == "-":
+        return sys.stdin.buffer
+    if os.path.exists(path) and stat.S_ISCHR(os.stat(path).st_mode) or path.startswith("COM"):
+        import serial
+        ser = serial.Serial(path, baudrate, timeout=0.1)
+        ser.write(b"AT+RUNIMPULSECONT=BINARY\r")
+        return ser
+    return open(path, "rb")
+
+if __name__ == "__main__":
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    as_json = "--json" in sys.argv
+    show_text = "--text" in sys.argv
+    if len(args) < 1:
+        print("Usage: python3 decode_results.py [device port | file | -] [baudrate] [--json] [--text]")
+        sys.exit(1)
+
+    stream = open_input(args[0], int(args[1]) if len(args) > 1 else 115200)
+    is_serial = hasattr(stream, "in_waiting")
+    decoder = ResultStreamDecoder()
+    try:
+        while True:
+            if is_serial:
+                data = stream.read(max(1, stream.in_waiting))
+                if not data:
+                    continue
+            else:
+                # read1 returns what is there, so piped output is decoded as it arrives
+                data = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+                if not data:
+                    break
+            for kind, item in decoder.feed(data):
+                if kind == "record":
+                    print(json.dumps(item) if as_json else format_record(item), flush=True)
+                elif show_text:
+                    sys.stderr.write(item)
+    except KeyboardInterrupt:
+        if is_serial:
+            stream.write(b"b")
+
+    sys.stderr.write("{} records, {} CRC errors, {} results lost\n".format(decoder.records, decoder.crc_errors, decoder.lost))
@@ -0,0 +1,269 @@
+import argparse
+import base64
+import struct
+import sys
+import time
+import zlib
+
+# Builds, inspects and uploads model containers (AT+MODELUPLOAD),
+# the container layout is described in firmware-sdk/ei_model_container.h
+
+MAGIC = b"EIMC"
+VERSION = 1
+HEADER_SIZE = 128
+MAX_OPS = 32
+# magic, version, header size, generation, model size, model crc, arena size, project id,
+# deploy version, input size, output size, input type, output type, op count, reserved,
+# input scale, input zero point, output scale, output zero point
+HEADER_FORMAT = "<4sHHIIIIIIIIBBBBfifi"
+OPS_OFFSET = struct.calcsize(HEADER_FORMAT)
+
+TENSOR_TYPES = {0: "float32", 3: "uint8", 9: "int8"}
+SCHEMA_VERSION = 3
+
+class Table:
+    """Just enough of a flatbuffers reader to get the header fields out of a .tflite file"""
+
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        vtable = pos - struct.unpack_from("<i", buf, pos)[0]
+        self.vtable = vtable
+        self.vtable_size = struct.unpack_from("<H", buf, vtable)[0]
+
+    def _field(self, ix):
+        entry = 4 + 2 * ix
+        if entry >= self.vtable_size:
+            return 0
+        return struct.unpack_from("<H", self.buf, self.vtable + entry)[0]
+
+    def scalar(self, ix, fmt, default=0):
+        off = self._field(ix)
+        return struct.unpack_from("<" + fmt, self.buf, self.pos + off)[0] if off else default
+
+    def _indirect(self, ix):
+        off = self._field(ix)
+        if not off:
+            return None
+        pos = self.pos + off
+        return pos + struct.unpack_from("<I", self.buf, pos)[0]
+
+    def table(self, ix):
+        pos = self._indirect(ix)
+        return Table(self.buf, pos) if pos is not None else None
+
+    def vector(self, ix, fmt):
+        pos = self._indirect(ix)
+        if pos is None:
+            return []
+        count = struct.unpack_from("<I", self.buf, pos)[0]
+        return list(struct.unpack_from("<%d%s" % (count, fmt), self.buf, pos + 4))
+
+    def tables(self, ix):
+        pos = self._indirect(ix)
+        if pos is None:
+            return []
+        count = struct.unpack_from("<I", self.buf, pos)[0]
+        out = []
+        for i in range(count):
+            elem = pos + 4 + 4 * i
+            out.append(Table(self.buf, elem + struct.unpack_from("<I", self.buf, elem)[0]))
+        return out
+
+def tensor_info(tensor):
+    # Tensor: shape 0, type 1, quantization 4; QuantizationParameters: scale 2, zero_point 3
+    shape = tensor.vector(0, "i")
+    size = 1
+    for dim in shape:
+        size *= dim
+    info = {"type": tensor.scalar(1, "b"), "size": size, "scale": 0.0, "zero_point": 0}
+    quant = tensor.table(4)
+    if info["type"] != 0 and quant is not None:
+        scale = quant.vector(2, "f")
+        zero_point = quant.vector(3, "q")
+        if scale and zero_point:
+            info["scale"] = scale[0]
+            info["zero_point"] = zero_point[0]
+    return info
+
+def parse_tflite(data):
+    """Returns the op codes and the input / output tensor of a .tflite model"""
+    if data[4:8] != b"TFL3":
+        raise ValueError("not a TFLite model")
+    model = Table(data, struct.unpack_from("<I", data, 0)[0])
+    # Model: version 0, operator_codes 1, subgraphs 2
+    if model.scalar(0, "I") != SCHEMA_VERSION:
+        raise ValueError("unsupported schema version {}".format(model.scalar(0, "I")))
+
+    ops = []
+    for op_code in model.tables(1):
+        # OperatorCode: deprecated_builtin_code 0, builtin_code 3, the larger one is the op
+        code = max(op_code.scalar(0, "b"), op_code.scalar(3, "i"))
+        if code not in ops:
+            ops.append(code)
+
+    subgraphs = model.tables(2)
+    if len(subgraphs) != 1:
+        raise ValueError("models with {} subgraphs are not supported".format(len(subgraphs)))
+    # SubGraph: tensors 0, inputs 1, outputs 2
+    tensors = subgraphs[0].tables(0)
+    inputs = subgraphs[0].vector(1, "i")
+    outputs = subgraphs[0].vector(2, "i")
+    if len(inputs) != 1 or len(outputs) != 1:
+        raise ValueError("only models with one input and one output are supported")
+
+    return {"ops": ops, "input": tensor_info(tensors[inputs[0]]), "output": tensor_info(tensors[outputs[0]])}
+
+def pack(model_data, arena_size, project_id=0, deploy_version=0):
+    info = parse_tflite(model_data)
+    for name in ("input", "output"):
+        if info[name]["type"] not in TENSOR_TYPES:
+            raise ValueError("unsupported {} type {}".format(name, info[name]["type"]))
+    if len(info["ops"]) > MAX_OPS:
+        raise ValueError("model uses {} ops, the container holds {}".format(len(info["ops"]), MAX_OPS))
+
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, HEADER_SIZE, 0,
+                         len(model_data), zlib.crc32(model_data), arena_size, project_id, deploy_version,
+                         info["input"]["size"], info["output"]["size"],
+                         info["input"]["type"], info["output"]["type"], len(info["ops"]), 0,
+                         info["input"]["scale"], info["input"]["zero_point"],
+                         info["output"]["scale"], info["output"]["zero_point"])
+    header += struct.pack("<%dH" % MAX_OPS, *(info["ops"] + [0] * (MAX_OPS - len(info["ops"]))))
+    header += struct.pack("<I", zlib.crc32(header))
+    assert len(header) == HEADER_SIZE
+    return header + model_data
+
+def unpack_header(data):
+    if len(data) < HEADER_SIZE or data[:4] != MAGIC:
+        raise ValueError("not a model container")
+    fields = struct.unpack_from(HEADER_FORMAT, data, 0)
+    names = ("magic", "version", "header_size", "generation", "model_size", "model_crc32", "arena_size",
+             "project_id", "deploy_version", "input_size", "output_size", "input_type", "output_type",
+             "op_count", "reserved", "input_scale", "input_zero_point", "output_scale", "output_zero_point")
+    header = dict(zip(names, fields))
+    header["ops"] = list(struct.unpack_from("<%dH" % MAX_OPS, data, OPS_OFFSET))[:header["op_count"]]
+    (crc,) = struct.unpack_from("<I", data, HEADER_SIZE - 4)
+    header["header_ok"] = zlib.crc32(data[:HEADER_SIZE - 4]) == crc
+    model = data[HEADER_SIZE:HEADER_SIZE + header["model_size"]]
+    header["model_ok"] = len(model) == header["model_size"] and zlib.crc32(model) == header["model_crc32"]
+    return header
+
+def print_info(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] == MAGIC:
+        h = unpack_header(data)
+        print("Container v{}, header {}, model {}".format(h["version"], "OK" if h["header_ok"] else "CRC ERROR",
+                                                         "OK" if h["model_ok"] else "CRC ERROR"))
+        print("  model {} bytes, arena {} bytes, project {} v{}".format(h["model_size"], h["arena_size"],
+                                                                        h["project_id"], h["deploy_version"]))
+        tensors = {"input": (h["input_type"], h["input_size"], h["input_scale"], h["input_zero_point"]),
+                   "output": (h["output_type"], h["output_size"], h["output_scale"], h["output_zero_point"])}
+        ops = h["ops"]
+    else:
+        info = parse_tflite(data)
+        print("TFLite model, {} bytes".format(len(data)))
+        tensors = {name: (t["type"], t["size"], t["scale"], t["zero_point"])
+                   for name, t in (("input", info["input"]), ("output", info["output"]))}
+        ops = info["ops"]
+    for name, (ttype, size, scale, zero_point) in tensors.items():
+        print("  {} {} x {}, scale {} zero point {}".format(name, size, TENSOR_TYPES.get(ttype, ttype), scale, zero_point))
+    print("  ops {}".format(", ".join(str(op) for op in ops)))
+
+def await_line(ser, prefixes, timeout=30):
+    """Returns the first line starting with one of the prefixes, echoes everything else"""
+    deadline = time.time() + timeout
+    line = b""
+    while time.time() < deadline:
+        c = ser.read(1)
+        if not c:
+            continue
+        line += c
+        if c != b"\n":
+            continue
+        text = line.decode("utf-8", "replace").strip()
+        line = b""
+        if text.startswith(prefixes):
+            return text
+        if text:
+            print(text)
+    raise TimeoutError("no reply from the device")
+
+def send(ser, data):
+    """Sends a container over an open port (anything with pyserial's read / write)"""
+    ser.write("AT+MODELUPLOAD={}\r".format(len(data)).encode())
+    # the device erases the slot before it asks for data
+    reply = await_line(ser, ("OK CHUNK=", "ERR"))
+    if reply.startswith("ERR"):
+        print(reply)
+        await_line(ser, ("END OUTPUT",))
+        return False
+    chunk_size = int(reply.split("=")[1])
+
+    encoded = base64.b64encode(data).decode()
+    if len(encoded) % chunk_size:
+        encoded += "=" * (chunk_size - len(encoded) % chunk_size)
+
+    start = time.time()
+    for pos in range(0, len(encoded), chunk_size):
+        ser.write(encoded[pos:pos + chunk_size].encode())
+        reply = await_line(ser, ("OK ", "ERR", "TIMEOUT"))
+        if not reply.startswith("OK "):
+            print(reply)
+            # the device gives up on the transfer, wait for the end of its output
+            await_line(ser, ("END OUTPUT",))
+            return False
+        sys.stderr.write("\r{} / {} bytes".format(min(len(data), (pos + chunk_size) * 3 // 4), len(data)))
+    sys.stderr.write(" in {:.1f} s\n".format(time.time() - start))
+
+    ok = True
+    while True:
+        reply = await_line(ser, ("END OUTPUT", "ERR"))
+        if reply.startswith("END OUTPUT"):
+            break
+        print(reply)
+        ok = False
+    return ok
+
+def upload(path, port, baudrate):
+    import serial
+
+    with open(path, "rb") as f:
+        data = f.read()
+    unpack_header(data)
+
+    ser = serial.Serial(port, baudrate, timeout=0.1)
+    ok = send(ser, data)
+    ser.close()
+    return ok
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Model containers for AT+MODELUPLOAD")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("pack", help="build a container from a .tflite model")
+    p.add_argument("model")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--arena-size", type=int, required=True, help="tensor arena in bytes (see AT+ARENA)")
+    p.add_argument("--project-id", type=int, default=0, help="Edge Impulse project, 0 to skip the check")
+    p.add_argument("--deploy-version", type=int, default=0)
+
+    p = sub.add_parser("info", help="print a container or .tflite header")
+    p.add_argument("file")
+
+    p = sub.add_parser("upload", help="upload a container to a device and run it")
+    p.add_argument("container")
+    p.add_argument("port")
+    p.add_argument("baudrate", nargs="?", type=int, default=115200)
+
+    args = parser.parse_args()
+    if args.command == "pack":
+        with open(args.model, "rb") as f:
+            container = pack(f.read(), args.arena_size, args.project_id, args.deploy_version)
+        with open(args.output, "wb") as f:
+            f.write(container)
+        print_info(args.output)
+    elif args.command == "info":
+        print_info(args.file)
+    elif args.command == "upload":
+        sys.exit(0 if upload(args.container, args.port, args.baudrate) else 1)
@@ -0,0 +1,250 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Generates model-parameters/model_static_impulse.h, the tables and configs of the
+ * static impulse mode (EI_CLASSIFIER_STATIC_IMPULSE, ei_static_impulse.h), from the
+ * DSP blocks in model_variables.h. Run it again whenever the model is updated:
+ *
+ *   ./linux-build.sh --static-impulse-tables
+ *
+ * The tables are computed by the same SDK functions the generic blocks use, so the
+ * static blocks give the same outputs.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// the generic blocks are the reference, build against them
+#undef EI_CLASSIFIER_STATIC_IMPULSE
+#define EI_CLASSIFIER_STATIC_IMPULSE 0
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+/* Private functions ------------------------------------------------------- */
+static int zero_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    memset(out_ptr, 0, length * sizeof(float));
+    return 0;
+}
+
+/**
+ * Shortest "%g" that reads back as the same float, with the f suffix
+ */
+static const char *float_literal(float value)
+{
+    static char buf[32];
+    for (int precision = 6; precision <= 9; precision++) {
+        snprintf(buf, sizeof(buf) - 1, "%.*g", precision, value);
+        if (strtof(buf, nullptr) == value) {
+            break;
+        }
+    }
+    strcat(buf, "f");
+    return buf;
+}
+
+static void print_floats(FILE *out, const char *name, const float *values, size_t count, size_t per_line)
+{
+    fprintf(out, "const float %s[%d] = {\n", name, (int)count);
+    for (size_t ix = 0; ix < count; ix++) {
+        fprintf(out, "%s%s%s", ix % per_line == 0 ? "    " : " ", float_literal(values[ix]),
+            ix == count - 1 ? "\n" : (ix % per_line == per_line - 1 ? ",\n" : ","));
+    }
+    fprintf(out, "};\n");
+}
+
+/**
+ * Tables and config of one MFCC block (ei_static_impulse.h, mfcc<C>)
+ */
+static int print_mfcc(FILE *out, const ei_impulse_t *impulse, const ei_model_dsp_t *block)
+{
+    const ei_dsp_config_mfcc_t *config = (const ei_dsp_config_mfcc_t *)block->config;
+    const uint32_t frequency = static_cast<uint32_t>(impulse->frequency);
+    char name[64];
+    char table[96];
+    snprintf(name, sizeof(name), "ei_dsp_static_%d_%d", (int)impulse->project_id, (int)block->blockId);
+
+    // frames of a complete window
+    signal_t signal;
+    signal.total_length = impulse->raw_sample_count;
+    signal.get_data = &zero_get_data;
+    speechpy::stack_frames_info_t stack_frame_info = { 0 };
+    stack_frame_info.signal = &signal;
+    int ret = speechpy::processing::stack_frames(&stack_frame_info, frequency, config->frame_length,
+        config->frame_stride, false, config->implementation_version);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+
+    // mel filter edges, as in speechpy::feature::mfe()
+    const size_t bins_size = config->num_filters + 2;
+    float *mels = (float *)calloc(bins_size, sizeof(float));
+    uint16_t *bins = speechpy::feature::calculate_mel_bins(mels, frequency, config->num_filters,
+        config->fft_length, config->low_frequency, config->high_frequency, config->implementation_version);
+
+    fprintf(out, "const uint16_t %s_mel_bins[%d] = {\n", name, (int)bins_size);
+    for (size_t ix = 0; ix < bins_size; ix++) {
+        fprintf(out, "%s%d%s", ix % 16 == 0 ? "    " : " ", bins[ix],
+            ix == bins_size - 1 ? "\n" : (ix % 16 == 15 ? ",\n" : ","));
+    }
+    fprintf(out, "};\n");
+
+    // the triangle weights mfe() computes per frame, middle bins (1.0) left out
+    std::vector<float> weights;
+    for (size_t i = 0; i < config->num_filters; i++) {
+        size_t left = bins[i];
+        size_t middle = bins[i + 1];
+        size_t right = bins[i + 2];
+        for (size_t bin = left + 1; bin < middle; bin++) {
+            weights.push_back((static_cast<float>(bin) - left) / (middle - left));
+        }
+        for (size_t bin = middle + 1; bin < right; bin++) {
+            weights.push_back((right - static_cast<float>(bin)) / (right - middle));
+        }
+    }
+    free(mels);
+    snprintf(table, sizeof(table), "%s_mel_weights", name);
+    print_floats(out, table, weights.data(), weights.size(), 8);
+
+    const numpy::dct2_plan_t *plan = numpy::get_dct2_plan(config->num_filters, config->num_cepstral,
+        DCT_NORMALIZATION_ORTHO);
+    if (!plan) {
+        return EIDSP_OUT_OF_MEM;
+    }
+    snprintf(table, sizeof(table), "%s_dct_basis", name);
+    print_floats(out, table, plan->basis, config->num_filters * config->num_cepstral, config->num_cepstral);
+
+    fprintf(out, "\n");
+    fprintf(out, "struct ei_dsp_static_config_%d_%d {\n", (int)impulse->project_id, (int)block->blockId);
+    fprintf(out, "    static constexpr uint32_t frequency = %d;\n", (int)frequency);
+    fprintf(out, "    static constexpr float frame_length = %s;\n", float_literal(config->frame_length));
+    fprintf(out, "    static constexpr float frame_stride = %s;\n", float_literal(config->frame_stride));
+    fprintf(out, "    static constexpr uint16_t frame_length_samples = %d;\n", (int)stack_frame_info.frame_length);
+    fprintf(out, "    static constexpr uint16_t max_frames = %d;\n", (int)stack_frame_info.frame_count);
+    fprintf(out, "    static constexpr uint16_t num_cepstral = %d;\n", config->num_cepstral);
+    fprintf(out, "    static constexpr uint16_t num_filters = %d;\n", config->num_filters);
+    fprintf(out, "    static constexpr uint16_t fft_length = %d;\n", config->fft_length);
+    fprintf(out, "    static constexpr uint16_t win_size = %d;\n", config->win_size);
+    fprintf(out, "    static constexpr float pre_cof = %s;\n", float_literal(config->pre_cof));
+    fprintf(out, "    static constexpr int pre_shift = %d;\n", config->pre_shift);
+    fprintf(out, "    static constexpr int implementation_version = %d;\n", config->implementation_version);
+    fprintf(out, "    static constexpr const uint16_t *mel_bins = %s_mel_bins;\n", name);
+    fprintf(out, "    static constexpr const float *mel_weights = %s_mel_weights;\n", name);
+    fprintf(out, "    static constexpr const float *dct_basis = %s_dct_basis;\n", name);
+    fprintf(out, "};\n");
+    fprintf(out, "typedef ei::static_impulse::mfcc<ei_dsp_static_config_%d_%d> %s;\n\n",
+        (int)impulse->project_id, (int)block->blockId, name);
+
+    return EIDSP_OK;
+}
+
+/* Public functions -------------------------------------------------------- */
+// the SDK prints to stderr, the device port (ei_device_linux.cpp) stays out of the tool
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    fprintf(stderr, "%.6f", f);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s model_static_impulse.h\n", argv[0]);
+        return 1;
+    }
+
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        fprintf(stderr, "Cannot write %s\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(out,
+        "/*\n"
+        " * Generated by firmware-sdk/tools/static_impulse_tables.cpp from model_variables.h\n"
+        " * (./linux-build.sh --static-impulse-tables), do not edit.\n"
+        " */\n\n"
+        "#ifndef _EI_CLASSIFIER_MODEL_STATIC_IMPULSE_H_\n"
+        "#define _EI_CLASSIFIER_MODEL_STATIC_IMPULSE_H_\n\n"
+        "/**\n"
+        " * @file\n"
+        " *  Tables and configs of the specialized DSP blocks (EI_CLASSIFIER_STATIC_IMPULSE),\n"
+        " *  included by model_variables.h.\n"
+        " */\n\n"
+        "#include <stdint.h>\n"
+        "#include \"edge-impulse-sdk/classifier/ei_static_impulse.h\"\n\n");
+
+    std::vector<std::string> names;
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        const ei_model_dsp_t *block = &impulse->dsp_blocks[ix];
+        // only MFCC has a static version so far, the other blocks keep the generic functions
+        if (block->extract_fn != &extract_mfcc_features) {
+            continue;
+        }
+        int ret = print_mfcc(out, impulse, block);
+        if (ret != EIDSP_OK) {
+            fprintf(stderr, "DSP block %d failed (%d)\n", (int)block->blockId, ret);
+            fclose(out);
+            return 1;
+        }
+        names.push_back("ei_dsp_static_" + std::to_string(impulse->project_id) + "_" + std::to_string(block->blockId));
+    }
+
+    fprintf(out, "const ei_static_dsp_fns_t ei_static_dsp_fns_%d_%d[] = {\n",
+        (int)impulse->project_id, (int)impulse->impulse_id);
+    for (const std::string &name : names) {
+        fprintf(out, "    EI_STATIC_DSP_MFCC_FNS(%s),\n", name.c_str());
+    }
+    if (names.empty()) {
+        // no zero length arrays, ei_static_dsp_find() never sees this entry
+        fprintf(out, "    { nullptr, nullptr, nullptr },\n");
+    }
+    fprintf(out, "};\n");
+    fprintf(out, "const size_t ei_static_dsp_fns_%d_%d_size = %d;\n\n",
+        (int)impulse->project_id, (int)impulse->impulse_id, (int)names.size());
+    fprintf(out, "#endif // _EI_CLASSIFIER_MODEL_STATIC_IMPULSE_H_\n");
+
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,174 @@
+import argparse
+import glob
+import math
+import os
+import re
+import subprocess
+import sys
+import wave
+
+from decode_results import ResultStreamDecoder
+
+# Keyword recall against CPU saved for the VAD gate (EI_VAD_GATE=1) on a labelled WAV corpus.
+# Every WAV file is played once through the Linux build (firmware-linux --audio) while it runs
+# AT+RUNIMPULSECONT=BINARY. Keywords are labelled in a file next to the WAV with the same name
+# and a .txt extension, one "start end label" line per keyword (seconds, the Audacity label
+# track format). Lines for labels that are not keywords are ignored.
+
+SLICE_SAMPLES = 4000        # EI_CLASSIFIER_SLICE_SIZE
+SLICES_PER_WINDOW = 4       # EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW
+SAMPLE_RATE = 16000
+PROMPT = b"\n> "
+
+STATS_SLICES = re.compile(r"VAD gate: (\d+) slices, (\d+) active, (\d+) processed")
+STATS_SAVED = re.compile(r"VAD gate: (\d+) us per slice in the gate, (\d+) us per processed slice, (\d+) ms saved")
+
+def read_labels(path, non_keywords):
+    events = []
+    if not os.path.exists(path):
+        return events
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) < 3 or parts[2] in non_keywords:
+                continue
+            events.append((float(parts[0]), float(parts[1]), parts[2]))
+    return events
+
+def wav_seconds(path):
+    with wave.open(path, "rb") as w:
+        return w.getnframes() / float(w.getframerate())
+
+class Run:
+    """One pass of a WAV file through the firmware"""
+
+    def __init__(self, firmware, wav, pace, timeout):
+        self.proc = subprocess.Popen([firmware, "--audio", wav, "--audio-pace", str(pace)],
+                                     stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+        self.pace = pace
+        self.timeout = timeout
+        self.decoder = ResultStreamDecoder()
+        self.text = ""
+        self.records = []
+
+    def _read(self):
+        data = self.proc.stdout.read1(4096)
+        if not data:
+            raise RuntimeError("firmware exited, output: {!r}".format(self.text[-200:]))
+        for kind, item in self.decoder.feed(data):
+            if kind == "record":
+                self.records.append(item)
+            else:
+                self.text += item
+
+    def _until_text(self, token):
+        while token not in self.text:
+            self._read()
+
+    def play(self, seconds):
+        """Records of the slices covering seconds of audio, and the gate statistics"""
+        self._until_text(PROMPT.decode())
+        self.proc.stdin.write(b"AT+RUNIMPULSECONT=BINARY\r")
+        self.proc.stdin.flush()
+
+        slices = int(math.ceil(seconds * SAMPLE_RATE / SLICE_SAMPLES))
+        while True:
+            results = [r for r in self.records if r["type"] == "result"]
+            if results and self.slice_of(results[-1], results[0]) >= slices - 1:
+                break
+            self._read()
+
+        self.text = ""
+        self.proc.stdin.write(b"b")
+        self.proc.stdin.flush()
+        self._until_text("ms saved")
+        self.proc.stdin.close()
+        self.proc.wait(self.timeout)
+        self.proc.stdout.close()
+
+        results = [r for r in self.records if r["type"] == "result"]
+        by_slice = {}
+        for r in results:
+            by_slice[self.slice_of(r, results[0])] = r
+        return by_slice, self.text
+
+    def slice_of(self, record, first):
+        # the first full window is held back, the first record is slice SLICES_PER_WINDOW;
+        # the gate starts open, so no slice before it is skipped
+        period_us = SLICE_SAMPLES * 1e6 / (SAMPLE_RATE * self.pace)
+        return SLICES_PER_WINDOW + int(round((record["window_end_us"] - first["window_end_us"]) / period_us))
+
+def evaluate(firmware, wav, events, pace, threshold, timeout):
+    seconds = wav_seconds(wav)
+    by_slice, text = Run(firmware, wav, pace, timeout).play(seconds)
+
+    stats = STATS_SLICES.search(text)
+    saved = STATS_SAVED.search(text)
+    if not stats or not saved:
+        raise RuntimeError("no VAD gate statistics from the firmware, built with EI_VAD_GATE=1? Output: {!r}".format(text))
+
+    out = {
+        "file": os.path.basename(wav),
+        "slices": int(stats.group(1)),
+        "processed": int(stats.group(3)),
+        "saved_ms": int(saved.group(3)),
+        "events": len(events),
+        "gate_kept": 0,
+        "detected": 0,
+    }
+
+    for start, end, label in events:
+        first = int(start * SAMPLE_RATE) // SLICE_SAMPLES
+        last = int(math.ceil(end * SAMPLE_RATE / SLICE_SAMPLES)) - 1
+        # the keyword reaches the model only if none of its slices was skipped
+        if not any(by_slice.get(k, {}).get("skipped") for k in range(first, last + 1)):
+            out["gate_kept"] += 1
+        # and is detected if a window that holds its end scores the label
+        for k in range(last, last + SLICES_PER_WINDOW):
+            r = by_slice.get(k)
+            if r and not r["skipped"] and r["classification"].get(label, 0.0) >= threshold:
+                out["detected"] += 1
+                break
+
+    return out
+
+def ratio(a, b):
+    return a / float(b) if b else float("nan")
+
+def main():
+    parser = argparse.ArgumentParser(description="VAD gate CPU saved vs. keyword recall on a labelled WAV corpus")
+    parser.add_argument("corpus", help="directory with .wav files and .txt keyword labels")
+    parser.add_argument("--firmware", default=os.path.join(os.path.dirname(__file__), "..", "..", "..",
+                                                           "build-linux", "firmware-linux"))
+    parser.add_argument("--pace", type=float, default=8.0, help="audio speed, 1 is real time")
+    parser.add_argument("--threshold", type=float, default=0.6, help="score for a keyword to count as detected")
+    parser.add_argument("--non-keywords", default="noise,unknown", help="comma separated labels to ignore")
+    parser.add_argument("--timeout", type=float, default=30.0)
+    args = parser.parse_args()
+
+    wavs = sorted(glob.glob(os.path.join(args.corpus, "*.wav")))
+    if not wavs:
+        print("No .wav files in {}".format(args.corpus))
+        return 1
+
+    non_keywords = set(args.non_keywords.split(","))
+    totals = {"slices": 0, "processed": 0, "saved_ms": 0, "events": 0, "gate_kept": 0, "detected": 0}
+    print("{:<32} {:>7} {:>10} {:>10} {:>12} {:>12}".format("file", "slices", "cpu saved", "saved ms",
+                                                             "gate recall", "recall"))
+    for wav in wavs:
+        events = read_labels(os.path.splitext(wav)[0] + ".txt", non_keywords)
+        r = evaluate(args.firmware, wav, events, args.pace, args.threshold, args.timeout)
+        for key in totals:
+            totals[key] += r[key]
+        print("{:<32} {:>7} {:>9.1%} {:>10} {:>12.3f} {:>12.3f}".format(
+            r["file"][:32], r["slices"], 1.0 - ratio(r["processed"], r["slices"]), r["saved_ms"],
+            ratio(r["gate_kept"], r["events"]), ratio(r["detected"], r["events"])))
+
+    print("{:<32} {:>7} {:>9.1%} {:>10} {:>12.3f} {:>12.3f}".format(
+        "total ({} keywords)".format(totals["events"]), totals["slices"],
+        1.0 - ratio(totals["processed"], totals["slices"]), totals["saved_ms"],
+        ratio(totals["gate_kept"], totals["events"]), ratio(totals["detected"], totals["events"])))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,528 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_impulse_scheduler.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "firmware-sdk/ei_telemetry.h"
+#include <string.h>
+
+using namespace ei;
+
+/* Private variables ------------------------------------------------------- */
+// scheduler and impulse being run, for the signal callback (runs are not reentrant)
+static ei_impulse_scheduler_t *running_scheduler = nullptr;
+static ei_scheduler_impulse_t *running_impulse = nullptr;
+
+/* Private functions ------------------------------------------------------- */
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static uint32_t samples_to_ms(uint64_t samples, float frequency)
+{
+    return frequency > 0 ? (uint32_t)((samples * 1000) / (uint64_t)frequency) : 0;
+}
+
+static uint64_t run_deadline_us(const ei_scheduler_impulse_t *impulse)
+{
+    return impulse->config.deadline_us > 0 ? impulse->due_us + impulse->config.deadline_us : UINT64_MAX;
+}
+
+/**
+ * Read the slice of the impulse being run from the capture ring
+ */
+static int get_slice_data(size_t offset, size_t length, float *out_ptr)
+{
+    ei_impulse_scheduler_t *scheduler = running_scheduler;
+    uint64_t start = running_impulse->next_end - running_impulse->config.stride_samples + offset;
+    size_t ring_ix = (size_t)(start % scheduler->ring_size);
+
+    while (length > 0) {
+        size_t chunk = scheduler->ring_size - ring_ix;
+        if (chunk > length) {
+            chunk = length;
+        }
+        numpy::int16_to_float(&scheduler->ring[ring_ix], out_ptr, chunk);
+        out_ptr += chunk;
+        length -= chunk;
+        ring_ix = 0;
+    }
+
+    return EIDSP_OK;
+}
+
+static bool dsp_blocks_equal(const ei_impulse_scheduler_t *scheduler, const ei_model_dsp_t *a, const ei_model_dsp_t *b)
+{
+    if (a == b) {
+        return true;
+    }
+    return scheduler->callbacks.dsp_equal_fn ? scheduler->callbacks.dsp_equal_fn(a, b) : false;
+}
+
+/**
+ * Do two impulses compute the same feature window from the same stream, so one's
+ * continuous state can be copied to the other
+ */
+static bool impulses_dsp_equal(const ei_impulse_scheduler_t *scheduler, const ei_scheduler_impulse_t *a, const ei_scheduler_impulse_t *b)
+{
+    if (a->window_samples != b->window_samples ||
+        a->source->nn_input_frame_size != b->source->nn_input_frame_size ||
+        a->source->dsp_blocks_size != b->source->dsp_blocks_size) {
+        return false;
+    }
+
+    for (size_t ix = 0; ix < a->source->dsp_blocks_size; ix++) {
+        if (!dsp_blocks_equal(scheduler, &a->source->dsp_blocks[ix], &b->source->dsp_blocks[ix])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool copy_buffer(float **dst, size_t *dst_size, const float *src, size_t src_size)
+{
+    if (*dst_size != src_size) {
+        if (*dst) {
+            ei_free(*dst);
+        }
+        *dst = src_size > 0 ? (float *)ei_calloc(src_size, sizeof(float)) : nullptr;
+        *dst_size = *dst ? src_size : 0;
+        if (src_size > 0 && !*dst) {
+            return false;
+        }
+    }
+
+    if (src_size > 0) {
+        memcpy(*dst, src, src_size * sizeof(float));
+    }
+    return true;
+}
+
+static bool copy_state(ei_classifier_continuous_state_t *dst, const ei_classifier_continuous_state_t *src)
+{
+    if (!copy_buffer(&dst->features, &dst->features_size, src->features, src->features_size) ||
+        !copy_buffer(&dst->dsp_frame, &dst->dsp_frame_size, src->dsp_frame, src->dsp_frame_size)) {
+        return false;
+    }
+    dst->features_written = src->features_written;
+    dst->dsp_frame_ix = src->dsp_frame_ix;
+    return true;
+}
+
+/**
+ * Start the feature window over, as run_classifier_continuous_restart() (the buffers are kept)
+ */
+static void restart_state(ei_classifier_continuous_state_t *state)
+{
+    state->features_written = 0;
+    state->dsp_frame_ix = 0;
+}
+
+static void free_state(ei_classifier_continuous_state_t *state)
+{
+    if (state->features) {
+        ei_free(state->features);
+    }
+    if (state->dsp_frame) {
+        ei_free(state->dsp_frame);
+    }
+    memset(state, 0, sizeof(ei_classifier_continuous_state_t));
+}
+
+/**
+ * An impulse with the same DSP whose state already holds the features up to the
+ * end of this impulse's next slice
+ */
+static ei_scheduler_impulse_t *find_dsp_source(ei_impulse_scheduler_t *scheduler, const ei_scheduler_impulse_t *impulse)
+{
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        ei_scheduler_impulse_t *other = &scheduler->impulses[ix];
+        if ((impulse->dsp_equal & (1u << ix)) && other->state_end == impulse->next_end) {
+            return other;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * A full stride (or more) behind: drop the older slices, the next run starts the window over
+ */
+static void skip_stale_slices(ei_impulse_scheduler_t *scheduler, ei_scheduler_impulse_t *impulse)
+{
+    uint32_t stride = impulse->config.stride_samples;
+
+    if (impulse->next_end > scheduler->samples || scheduler->samples - impulse->next_end < stride) {
+        return;
+    }
+
+    uint64_t slices = (scheduler->samples - impulse->next_end) / stride;
+    impulse->next_end += slices * stride;
+    impulse->due_us = scheduler->last_push_us;
+    impulse->stats.skipped += (uint32_t)slices;
+    ei_telemetry_count(EI_TELEMETRY_SKIPPED_SLICES, (uint32_t)slices);
+}
+
+static void run_impulse(ei_impulse_scheduler_t *scheduler, ei_scheduler_impulse_t *impulse)
+{
+    ei_scheduler_impulse_stats_t *stats = &impulse->stats;
+    uint64_t slice_start = impulse->next_end - impulse->config.stride_samples;
+
+    // take over the features of an impulse with the same DSP, else run the DSP on the slice
+    ei_scheduler_impulse_t *dsp_source = find_dsp_source(scheduler, impulse);
+    if (dsp_source && !copy_state(&impulse->state, &dsp_source->state)) {
+        restart_state(&impulse->state);
+        impulse->state_end = UINT64_MAX;
+        dsp_source = nullptr;
+    }
+    if (!dsp_source && impulse->state_end != slice_start) {
+        restart_state(&impulse->state);
+    }
+
+    signal_t signal;
+    signal.total_length = impulse->config.stride_samples;
+    signal.get_data = &get_slice_data;
+
+    ei_impulse_result_t result = { 0 };
+    ei_impulse_handle_t *handle = impulse->config.handle;
+
+    running_scheduler = scheduler;
+    running_impulse = impulse;
+
+    EI_IMPULSE_ERROR r = scheduler->callbacks.run_fn(handle, &impulse->state, dsp_source ? nullptr : &signal,
+        &result, scheduler->debug);
+
+    running_impulse = nullptr;
+    running_scheduler = nullptr;
+
+    uint64_t done_us = ei_read_timer_us();
+    uint32_t latency_us = (uint32_t)(done_us - impulse->due_us);
+
+    stats->runs++;
+    if (dsp_source) {
+        stats->dsp_reused++;
+    }
+    else {
+        stats->dsp_runs++;
+    }
+    stats->latency_sum_us += latency_us;
+    if (latency_us < stats->latency_min_us) {
+        stats->latency_min_us = latency_us;
+    }
+    if (latency_us > stats->latency_max_us) {
+        stats->latency_max_us = latency_us;
+    }
+    if (done_us > run_deadline_us(impulse)) {
+        stats->deadline_misses++;
+    }
+
+    if (r != EI_IMPULSE_OK) {
+        ei_printf("ERR: Failed to run impulse %u (%d)\n", (unsigned int)(impulse - scheduler->impulses), r);
+        stats->errors++;
+        // the state may hold part of the slice, start over on the next one
+        impulse->state_end = UINT64_MAX;
+    }
+    else {
+        impulse->state_end = impulse->next_end;
+        if (impulse->state.features_written >= impulse->source->nn_input_frame_size) {
+            stats->windows++;
+            if (scheduler->callbacks.result_fn) {
+                scheduler->callbacks.result_fn((uint8_t)(impulse - scheduler->impulses), handle, &result);
+            }
+        }
+    }
+
+    impulse->next_end += impulse->config.stride_samples;
+    impulse->due_us = impulse->next_end <= scheduler->samples ? scheduler->last_push_us : 0;
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief      Reset the scheduler, impulses are added with ei_scheduler_register()
+ */
+void ei_scheduler_init(ei_impulse_scheduler_t *scheduler, const ei_scheduler_callbacks_t *callbacks)
+{
+    memset(scheduler, 0, sizeof(ei_impulse_scheduler_t));
+    scheduler->callbacks = *callbacks;
+}
+
+/**
+ * @brief      Add an impulse. All impulses share the capture stream, so they need
+ *             a single (audio) axis and the same sampling frequency. Every impulse
+ *             runs continuously (run_classifier_continuous()) on slices of its
+ *             stride, with its own feature window.
+ *
+ * @return     Id of the impulse (passed to the result callback), -1 on error
+ */
+int ei_scheduler_register(ei_impulse_scheduler_t *scheduler, const ei_scheduler_impulse_config_t *config)
+{
+    if (scheduler->impulses_size >= EI_SCHEDULER_MAX_IMPULSES) {
+        ei_printf("ERR: Too many impulses (max. %d)\n", EI_SCHEDULER_MAX_IMPULSES);
+        return -1;
+    }
+
+    if (!config->handle || !config->handle->impulse) {
+        return -1;
+    }
+
+    const ei_impulse_t *source = config->handle->impulse;
+    if (source->raw_samples_per_frame != 1 || source->raw_sample_count == 0) {
+        ei_printf("ERR: Only single axis impulses can share the capture stream\n");
+        return -1;
+    }
+
+    if (scheduler->impulses_size > 0 && scheduler->impulses[0].source->frequency != source->frequency) {
+        ei_printf("ERR: Impulses need the same sampling frequency\n");
+        return -1;
+    }
+
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        if (scheduler->impulses[ix].config.handle == config->handle) {
+            ei_printf("ERR: Impulse handle already registered\n");
+            return -1;
+        }
+    }
+
+    ei_scheduler_impulse_t *impulse = &scheduler->impulses[scheduler->impulses_size];
+    memset(impulse, 0, sizeof(ei_scheduler_impulse_t));
+
+    impulse->config = *config;
+    if (impulse->config.stride_samples == 0) {
+        impulse->config.stride_samples = source->slice_size > 0 ? source->slice_size : source->raw_sample_count;
+    }
+
+    impulse->source = source;
+    impulse->window_samples = source->raw_sample_count;
+
+    return scheduler->impulses_size++;
+}
+
+/**
+ * @brief      Allocate the capture ring and start the stream at position 0, every
+ *             impulse with an empty feature window
+ */
+bool ei_scheduler_start(ei_impulse_scheduler_t *scheduler, bool debug)
+{
+    uint32_t max_stride = 0;
+
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        ei_scheduler_impulse_t *impulse = &scheduler->impulses[ix];
+
+        if (impulse->config.stride_samples > max_stride) {
+            max_stride = impulse->config.stride_samples;
+        }
+
+        // the features of these can be copied instead of running the DSP again
+        impulse->dsp_equal = 0;
+        for (size_t other_ix = 0; other_ix < scheduler->impulses_size; other_ix++) {
+            if (other_ix != ix && impulses_dsp_equal(scheduler, impulse, &scheduler->impulses[other_ix])) {
+                impulse->dsp_equal |= 1u << other_ix;
+            }
+        }
+
+        free_state(&impulse->state);
+        impulse->stats = { };
+        impulse->stats.latency_min_us = UINT32_MAX;
+        impulse->next_end = impulse->config.stride_samples;
+        impulse->state_end = 0;
+        impulse->due_us = 0;
+    }
+
+    // the longest slice, plus a stride in which a deferred impulse can still catch up
+    scheduler->ring_size = 2 * max_stride;
+    scheduler->ring = (int16_t *)ei_malloc(scheduler->ring_size * sizeof(int16_t));
+    if (!scheduler->ring) {
+        ei_printf("ERR: Failed to allocate capture ring (%u samples)\n", (unsigned int)scheduler->ring_size);
+        return false;
+    }
+
+    scheduler->samples = 0;
+    scheduler->slices = 0;
+    scheduler->last_push_us = 0;
+    scheduler->debug = debug;
+
+    return true;
+}
+
+/**
+ * @brief      Samples per capture slice: every impulse's slice ends on a capture slice boundary
+ */
+uint32_t ei_scheduler_slice_samples(const ei_impulse_scheduler_t *scheduler)
+{
+    uint32_t slice = 0;
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        slice = gcd(scheduler->impulses[ix].config.stride_samples, slice);
+    }
+    return slice;
+}
+
+/**
+ * @brief      Append captured samples to the ring
+ */
+void ei_scheduler_push(ei_impulse_scheduler_t *scheduler, const int16_t *samples, size_t n_samples)
+{
+    size_t ring_ix = (size_t)(scheduler->samples % scheduler->ring_size);
+    size_t left = n_samples;
+
+    // only the newest ring_size samples are kept
+    if (left > scheduler->ring_size) {
+        samples += left - scheduler->ring_size;
+        ring_ix = (size_t)((scheduler->samples + left - scheduler->ring_size) % scheduler->ring_size);
+        left = scheduler->ring_size;
+    }
+
+    while (left > 0) {
+        size_t chunk = scheduler->ring_size - ring_ix;
+        if (chunk > left) {
+            chunk = left;
+        }
+        memcpy(&scheduler->ring[ring_ix], samples, chunk * sizeof(int16_t));
+        samples += chunk;
+        left -= chunk;
+        ring_ix = 0;
+    }
+
+    scheduler->samples += n_samples;
+    scheduler->slices++;
+    scheduler->last_push_us = ei_read_timer_us();
+
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        ei_scheduler_impulse_t *impulse = &scheduler->impulses[ix];
+        if (impulse->due_us == 0 && impulse->next_end <= scheduler->samples) {
+            impulse->due_us = scheduler->last_push_us;
+        }
+    }
+}
+
+/**
+ * @brief      Run the impulses that have a complete slice, by priority, then by
+ *             earliest deadline. Once a slice is waiting (input_pending_fn) the
+ *             remaining impulses are deferred to the next call, the highest priority
+ *             one always runs.
+ *
+ * @return     Number of impulses run
+ */
+uint32_t ei_scheduler_run_pending(ei_impulse_scheduler_t *scheduler)
+{
+    uint32_t runs = 0;
+
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        skip_stale_slices(scheduler, &scheduler->impulses[ix]);
+    }
+
+    while (true) {
+        ei_scheduler_impulse_t *next = nullptr;
+
+        for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+            ei_scheduler_impulse_t *impulse = &scheduler->impulses[ix];
+            if (impulse->next_end > scheduler->samples) {
+                continue;
+            }
+            if (!next || impulse->config.priority < next->config.priority ||
+                (impulse->config.priority == next->config.priority && run_deadline_us(impulse) < run_deadline_us(next))) {
+                next = impulse;
+            }
+        }
+
+        if (!next) {
+            break;
+        }
+
+        if (runs > 0 && scheduler->callbacks.input_pending_fn && scheduler->callbacks.input_pending_fn()) {
+            for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+                ei_scheduler_impulse_t *impulse = &scheduler->impulses[ix];
+                if (impulse->next_end <= scheduler->samples) {
+                    impulse->stats.deferred++;
+                }
+            }
+            break;
+        }
+
+        run_impulse(scheduler, next);
+        runs++;
+    }
+
+    return runs;
+}
+
+void ei_scheduler_print_stats(const ei_impulse_scheduler_t *scheduler)
+{
+    float frequency = scheduler->impulses_size > 0 ? scheduler->impulses[0].source->frequency : 0;
+
+    ei_printf("Scheduler: %u slices of %u ms\n", (unsigned int)scheduler->slices,
+        (unsigned int)samples_to_ms(ei_scheduler_slice_samples(scheduler), frequency));
+
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        const ei_scheduler_impulse_t *impulse = &scheduler->impulses[ix];
+        const ei_scheduler_impulse_stats_t *stats = &impulse->stats;
+        uint32_t latency_avg_us = stats->runs > 0 ? (uint32_t)(stats->latency_sum_us / stats->runs) : 0;
+
+        ei_printf("Impulse %u (window %u ms, stride %u ms, priority %u, deadline %u us): "
+            "%u runs, %u windows, %u deadline misses, %u deferred, %u skipped, %u errors\n",
+            (unsigned int)ix,
+            (unsigned int)samples_to_ms(impulse->window_samples, frequency),
+            (unsigned int)samples_to_ms(impulse->config.stride_samples, frequency),
+            (unsigned int)impulse->config.priority, (unsigned int)impulse->config.deadline_us,
+            (unsigned int)stats->runs, (unsigned int)stats->windows, (unsigned int)stats->deadline_misses,
+            (unsigned int)stats->deferred, (unsigned int)stats->skipped, (unsigned int)stats->errors);
+        ei_printf("Impulse %u: latency min %u us, avg %u us, max %u us, DSP %u slices run, %u reused\n",
+            (unsigned int)ix,
+            (unsigned int)(stats->runs > 0 ? stats->latency_min_us : 0), (unsigned int)latency_avg_us,
+            (unsigned int)stats->latency_max_us,
+            (unsigned int)stats->dsp_runs, (unsigned int)stats->dsp_reused);
+    }
+}
+
+/**
+ * @brief      Free the capture ring and the feature windows
+ */
+void ei_scheduler_end(ei_impulse_scheduler_t *scheduler)
+{
+    if (scheduler->ring) {
+        ei_free(scheduler->ring);
+        scheduler->ring = nullptr;
+    }
+
+    for (size_t ix = 0; ix < scheduler->impulses_size; ix++) {
+        free_state(&scheduler->impulses[ix].state);
+    }
+}
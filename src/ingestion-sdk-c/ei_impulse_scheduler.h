@@ -0,0 +1,119 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_IMPULSE_SCHEDULER_H
+#define EI_IMPULSE_SCHEDULER_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+
+/* Constants --------------------------------------------------------------- */
+// Impulses that can be registered with one scheduler
+#ifndef EI_SCHEDULER_MAX_IMPULSES
+#define EI_SCHEDULER_MAX_IMPULSES           4
+#endif
+
+/* Types ------------------------------------------------------------------- */
+typedef struct {
+    // Runs the impulse on one slice with its continuous state swapped in, i.e. run_classifier_continuous().
+    // signal is nullptr when the state already holds the slice's features (copied from an impulse with
+    // the same DSP), then only the window is classified, i.e. run_classifier_continuous_window()
+    EI_IMPULSE_ERROR (*run_fn)(ei_impulse_handle_t *handle, ei_classifier_continuous_state_t *state,
+        ei::signal_t *signal, ei_impulse_result_t *result, bool debug);
+    // Do two DSP blocks give the same features for the same signal (nullptr: only the same block)
+    bool (*dsp_equal_fn)(const ei_model_dsp_t *a, const ei_model_dsp_t *b);
+    // Called with the result of every classified window
+    void (*result_fn)(uint8_t id, ei_impulse_handle_t *handle, ei_impulse_result_t *result);
+    // Is the next slice already waiting, lower priority runs are then deferred (optional)
+    bool (*input_pending_fn)(void);
+} ei_scheduler_callbacks_t;
+
+typedef struct {
+    ei_impulse_handle_t *handle;
+    uint32_t stride_samples;    // samples in the slices the impulse runs on, 0 uses the impulse slice size
+    uint8_t priority;           // 0 runs first
+    uint32_t deadline_us;       // result due after the last sample of the slice arrived, 0 = none
+} ei_scheduler_impulse_config_t;
+
+typedef struct {
+    uint32_t runs;              // slices run
+    uint32_t windows;           // windows classified, none until the first window of features is complete
+    uint32_t errors;            // runs that did not return EI_IMPULSE_OK
+    uint32_t deferred;          // times a complete slice waited a slice for higher priority work
+    uint32_t skipped;           // slices dropped because the impulse fell a full stride behind
+    uint32_t deadline_misses;   // runs that finished after their deadline
+    uint32_t dsp_runs;          // slices the DSP blocks ran on
+    uint32_t dsp_reused;        // slices whose features were copied from another impulse
+    uint32_t latency_min_us;    // last sample of the slice in, to result out
+    uint32_t latency_max_us;
+    uint64_t latency_sum_us;
+} ei_scheduler_impulse_stats_t;
+
+typedef struct {
+    ei_scheduler_impulse_config_t config;
+    ei_scheduler_impulse_stats_t stats;
+    const ei_impulse_t *source;                 // the impulse as registered
+    ei_classifier_continuous_state_t state;     // feature window and DSP carry-over of this impulse
+    uint32_t dsp_equal;                         // bit per impulse with the same DSP blocks and window
+    uint32_t window_samples;
+    uint64_t next_end;                          // stream position the next slice ends at
+    uint64_t state_end;                         // stream position the state holds the features up to
+    uint64_t due_us;                            // when that slice became complete, 0 if it is not
+} ei_scheduler_impulse_t;
+
+typedef struct {
+    ei_scheduler_callbacks_t callbacks;
+    ei_scheduler_impulse_t impulses[EI_SCHEDULER_MAX_IMPULSES];
+    uint8_t impulses_size;
+    int16_t *ring;                  // shared capture ring
+    uint32_t ring_size;
+    uint64_t samples;               // samples pushed since ei_scheduler_start()
+    uint32_t slices;
+    uint64_t last_push_us;
+    bool debug;
+} ei_impulse_scheduler_t;
+
+/* Function prototypes ----------------------------------------------------- */
+void ei_scheduler_init(ei_impulse_scheduler_t *scheduler, const ei_scheduler_callbacks_t *callbacks);
+int ei_scheduler_register(ei_impulse_scheduler_t *scheduler, const ei_scheduler_impulse_config_t *config);
+bool ei_scheduler_start(ei_impulse_scheduler_t *scheduler, bool debug);
+uint32_t ei_scheduler_slice_samples(const ei_impulse_scheduler_t *scheduler);
+void ei_scheduler_push(ei_impulse_scheduler_t *scheduler, const int16_t *samples, size_t n_samples);
+uint32_t ei_scheduler_run_pending(ei_impulse_scheduler_t *scheduler);
+void ei_scheduler_print_stats(const ei_impulse_scheduler_t *scheduler);
+void ei_scheduler_end(ei_impulse_scheduler_t *scheduler);
+
+#endif /* EI_IMPULSE_SCHEDULER_H */
@@ -0,0 +1,681 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_kernel_benchmark.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#if EI_KERNEL_BENCHMARK == 1
+
+#include <stdio.h>
+#include <string.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/padding.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/quantization_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/pooling.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/softmax.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/micro_ops.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/test_helpers.h"
+
+#if defined(__MBED__)
+#include "mbed.h"
+#endif
+
+/* Constants --------------------------------------------------------------- */
+// Used to convert ns/op into MACs/cycle, 0 if the core clock is unknown
+#ifndef EI_KERNEL_BENCHMARK_CPU_HZ
+#if defined(__MBED__)
+#define EI_KERNEL_BENCHMARK_CPU_HZ      SystemCoreClock
+#else
+#define EI_KERNEL_BENCHMARK_CPU_HZ      0
+#endif
+#endif
+
+// Without CMSIS-NN the registered kernels are the TFLM reference kernels, so both
+// implementations run the same code and the speed-up is only the kernel call overhead
+#if EI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN == 1
+#define EI_KERNEL_BENCHMARK_KERNEL_NAME "cmsis-nn"
+#define EI_KERNEL_BENCHMARK_OPTIMIZED   1
+#else
+#define EI_KERNEL_BENCHMARK_KERNEL_NAME "tflm"
+#define EI_KERNEL_BENCHMARK_OPTIMIZED   0
+#endif
+
+#define EI_KERNEL_BENCHMARK_MAX_CHANNELS    64
+#define EI_KERNEL_BENCHMARK_BATCH           32
+
+using namespace tflite;
+using tflite::testing::CreateQuantizedTensor;
+using tflite::testing::FloatArrayFromFloats;
+using tflite::testing::IntArrayFromInts;
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    uint32_t ns_per_op;
+    uint32_t iterations;
+} bench_timing_t;
+
+/** Quantization parameters of an int8 tensor */
+typedef struct {
+    float scale;
+    int zero_point;
+} bench_quant_t;
+
+/* Private variables ------------------------------------------------------- */
+static uint32_t rng_state;
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * Deterministic LCG, so every run (and every board) benchmarks the same data
+ */
+static void rng_seed(uint32_t seed)
+{
+    rng_state = seed;
+}
+
+static int8_t rng_int8(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (int8_t)(rng_state >> 24);
+}
+
+static float rng_float(float min, float max)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return min + (max - min) * (float)(rng_state >> 8) / (float)(1u << 24);
+}
+
+static void rng_fill(int8_t *data, size_t size)
+{
+    for (size_t ix = 0; ix < size; ix++) {
+        data[ix] = rng_int8();
+    }
+}
+
+/**
+ * Run fn() in growing batches until at least EI_KERNEL_BENCHMARK_MIN_US has passed
+ */
+template <typename Fn>
+static bench_timing_t bench_time(Fn fn)
+{
+    bench_timing_t timing = { 0, 0 };
+    uint32_t batch = 1;
+    uint64_t start = ei_read_timer_us();
+    uint64_t elapsed = 0;
+
+    while (elapsed < EI_KERNEL_BENCHMARK_MIN_US) {
+        for (uint32_t ix = 0; ix < batch; ix++) {
+            fn();
+        }
+        timing.iterations += batch;
+        elapsed = ei_read_timer_us() - start;
+        if (batch < 1024) {
+            batch *= 2;
+        }
+    }
+
+    timing.ns_per_op = (uint32_t)((elapsed * 1000) / timing.iterations);
+    return timing;
+}
+
+/**
+ * Time the registered kernel. KernelRunner resolves the eval tensors from its own (small)
+ * arena on every Invoke() without releasing them, so the runner is rebuilt every
+ * EI_KERNEL_BENCHMARK_BATCH invocations. Only the Invoke() calls are timed.
+ */
+static TfLiteStatus bench_time_kernel(const TfLiteRegistration &registration,
+    TfLiteTensor *tensors, int tensors_size, int *inputs, int *outputs, void *builtin_data,
+    bench_timing_t *timing)
+{
+    uint64_t elapsed = 0;
+    timing->iterations = 0;
+
+    while (elapsed < EI_KERNEL_BENCHMARK_MIN_US) {
+        micro::KernelRunner runner(registration, tensors, tensors_size, IntArrayFromInts(inputs),
+            IntArrayFromInts(outputs), builtin_data);
+        if (runner.InitAndPrepare() != kTfLiteOk) {
+            return kTfLiteError;
+        }
+
+        uint64_t start = ei_read_timer_us();
+        for (uint32_t ix = 0; ix < EI_KERNEL_BENCHMARK_BATCH; ix++) {
+            if (runner.Invoke() != kTfLiteOk) {
+                return kTfLiteError;
+            }
+        }
+        elapsed += ei_read_timer_us() - start;
+        timing->iterations += EI_KERNEL_BENCHMARK_BATCH;
+
+        if (registration.free) {
+            runner.Free();
+        }
+    }
+
+    timing->ns_per_op = (uint32_t)((elapsed * 1000) / timing->iterations);
+    return kTfLiteOk;
+}
+
+static size_t count_mismatches(const int8_t *a, const int8_t *b, size_t size)
+{
+    size_t mismatches = 0;
+    for (size_t ix = 0; ix < size; ix++) {
+        if (a[ix] != b[ix]) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void print_throughput(const char *impl, bench_timing_t timing, uint32_t macs)
+{
+    ei_printf("%s %lu ns", impl, (unsigned long)timing.ns_per_op);
+
+    uint64_t cpu_hz = (uint64_t)EI_KERNEL_BENCHMARK_CPU_HZ;
+    if (macs == 0 || cpu_hz == 0 || timing.ns_per_op == 0) {
+        ei_printf(" (- MAC/cyc)");
+        return;
+    }
+
+    // MACs/cycle = macs / (ns * hz / 1e9), printed with 3 decimals
+    uint64_t cycles = ((uint64_t)timing.ns_per_op * cpu_hz) / 1000000000ULL;
+    if (cycles == 0) {
+        cycles = 1;
+    }
+    uint64_t milli = ((uint64_t)macs * 1000ULL) / cycles;
+    ei_printf(" (%lu.%03lu MAC/cyc)", (unsigned long)(milli / 1000), (unsigned long)(milli % 1000));
+}
+
+/**
+ * Print one result line, returns 1 if the case failed
+ */
+static int print_result(const char *label, uint32_t macs, bench_timing_t kernel,
+    bench_timing_t reference, size_t mismatches, size_t output_size)
+{
+    ei_printf("%-34s | ", label);
+    print_throughput(EI_KERNEL_BENCHMARK_KERNEL_NAME, kernel, macs);
+    ei_printf(" | ");
+    print_throughput("ref", reference, macs);
+
+#if EI_KERNEL_BENCHMARK_OPTIMIZED == 1
+    uint32_t speedup = kernel.ns_per_op > 0 ?
+        (uint32_t)(((uint64_t)reference.ns_per_op * 100) / kernel.ns_per_op) : 0;
+    ei_printf(" | x%lu.%02lu | ", (unsigned long)(speedup / 100), (unsigned long)(speedup % 100));
+#else
+    ei_printf(" | n/a   | ");
+#endif
+
+    if (mismatches == 0) {
+        ei_printf("exact\n");
+        return 0;
+    }
+
+    ei_printf("MISMATCH %u/%u\n", (unsigned int)mismatches, (unsigned int)output_size);
+    return 1;
+}
+
+static void activation_range(bool relu, bench_quant_t output, int32_t *act_min, int32_t *act_max)
+{
+    *act_min = -128;
+    *act_max = 127;
+    if (relu && output.zero_point > *act_min) {
+        *act_min = output.zero_point;
+    }
+}
+
+/**
+ * Conv2D with a 1xK kernel over a 1xW input (the layout the 1D conv layers of an impulse use)
+ */
+static int bench_conv(const char *name, int width, int in_ch, int out_ch, int kernel_size,
+    int stride, bench_quant_t input_q, bench_quant_t output_q, bool relu)
+{
+    char label[48];
+    snprintf(label, sizeof(label), "%s 1x%dx%d k%d s%d -> %d", name, width, in_ch,
+        kernel_size, stride, out_ch);
+
+    if (out_ch > EI_KERNEL_BENCHMARK_MAX_CHANNELS) {
+        ei_printf("%-34s | ERR: too many channels\n", label);
+        return 1;
+    }
+
+    int out_height, out_width;
+    TfLitePaddingValues padding = ComputePaddingHeightWidth(1, stride, 1, 1, 1, width,
+        1, kernel_size, kTfLitePaddingSame, &out_height, &out_width);
+
+    const size_t input_size = width * in_ch;
+    const size_t filter_size = out_ch * kernel_size * in_ch;
+    const size_t output_size = out_height * out_width * out_ch;
+
+    int8_t *input = (int8_t*)ei_malloc(input_size);
+    int8_t *filter = (int8_t*)ei_malloc(filter_size);
+    int32_t *bias = (int32_t*)ei_malloc(out_ch * sizeof(int32_t));
+    int8_t *output = (int8_t*)ei_malloc(output_size);
+    int8_t *output_ref = (int8_t*)ei_malloc(output_size);
+    int failed = 1;
+
+    if (!input || !filter || !bias || !output || !output_ref) {
+        ei_printf("%-34s | ERR: out of memory\n", label);
+        goto cleanup;
+    }
+
+    {
+        float filter_scales[1 + EI_KERNEL_BENCHMARK_MAX_CHANNELS];
+        float bias_scales[1 + EI_KERNEL_BENCHMARK_MAX_CHANNELS];
+        int zero_points[1 + EI_KERNEL_BENCHMARK_MAX_CHANNELS] = { 0 };
+        int32_t multipliers[EI_KERNEL_BENCHMARK_MAX_CHANNELS];
+        int32_t shifts[EI_KERNEL_BENCHMARK_MAX_CHANNELS];
+
+        rng_fill(input, input_size);
+        rng_fill(filter, filter_size);
+        filter_scales[0] = bias_scales[0] = (float)out_ch;
+        zero_points[0] = out_ch;
+        for (int c = 0; c < out_ch; c++) {
+            filter_scales[c + 1] = rng_float(0.002f, 0.01f);
+            bias_scales[c + 1] = input_q.scale * filter_scales[c + 1];
+            bias[c] = (int32_t)(rng_int8()) * 16;
+
+            int shift;
+            double effective_scale = static_cast<double>(input_q.scale) *
+                static_cast<double>(filter_scales[c + 1]) / static_cast<double>(output_q.scale);
+            QuantizeMultiplier(effective_scale, &multipliers[c], &shift);
+            shifts[c] = shift;
+        }
+
+        int input_dims[] = { 4, 1, 1, width, in_ch };
+        int filter_dims[] = { 4, out_ch, 1, kernel_size, in_ch };
+        int bias_dims[] = { 1, out_ch };
+        int output_dims[] = { 4, 1, out_height, out_width, out_ch };
+
+        TfLiteAffineQuantization filter_quant = {
+            FloatArrayFromFloats(filter_scales), IntArrayFromInts(zero_points), 0 };
+        TfLiteAffineQuantization bias_quant = {
+            FloatArrayFromFloats(bias_scales), IntArrayFromInts(zero_points), 0 };
+
+        TfLiteTensor tensors[4] = {
+            CreateQuantizedTensor(input, IntArrayFromInts(input_dims), input_q.scale, input_q.zero_point),
+            CreateQuantizedTensor(filter, IntArrayFromInts(filter_dims), 1.0f, 0),
+            CreateQuantizedTensor(bias, IntArrayFromInts(bias_dims), bias_scales[1], 0),
+            CreateQuantizedTensor(output, IntArrayFromInts(output_dims), output_q.scale, output_q.zero_point),
+        };
+        tensors[1].quantization = { kTfLiteAffineQuantization, &filter_quant };
+        tensors[2].quantization = { kTfLiteAffineQuantization, &bias_quant };
+
+        int inputs_array[] = { 3, 0, 1, 2 };
+        int outputs_array[] = { 1, 3 };
+        TfLiteConvParams conv_params = { kTfLitePaddingSame, stride, 1,
+            relu ? kTfLiteActRelu : kTfLiteActNone, 1, 1 };
+
+        bench_timing_t kernel;
+        if (bench_time_kernel(Register_CONV_2D(), tensors, 4, inputs_array, outputs_array,
+                &conv_params, &kernel) != kTfLiteOk) {
+            ei_printf("%-34s | ERR: " EI_KERNEL_BENCHMARK_KERNEL_NAME " kernel failed\n", label);
+            goto cleanup;
+        }
+
+        ConvParams params = { };
+        params.padding_type = PaddingType::kSame;
+        params.padding_values.width = padding.width;
+        params.padding_values.height = padding.height;
+        params.stride_width = stride;
+        params.stride_height = 1;
+        params.dilation_width_factor = 1;
+        params.dilation_height_factor = 1;
+        params.input_offset = -input_q.zero_point;
+        params.output_offset = output_q.zero_point;
+        activation_range(relu, output_q, &params.quantized_activation_min, &params.quantized_activation_max);
+
+        RuntimeShape input_shape(4, input_dims + 1);
+        RuntimeShape filter_shape(4, filter_dims + 1);
+        RuntimeShape bias_shape(1, bias_dims + 1);
+        RuntimeShape output_shape(4, output_dims + 1);
+        bench_timing_t reference = bench_time([&]() {
+            reference_integer_ops::ConvPerChannel(params, multipliers, shifts,
+                input_shape, input, filter_shape, filter, bias_shape, bias, output_shape, output_ref);
+        });
+
+        uint32_t macs = (uint32_t)(output_size * kernel_size * in_ch);
+        failed = print_result(label, macs, kernel, reference,
+            count_mismatches(output, output_ref, output_size), output_size);
+    }
+
+cleanup:
+    ei_free(input);
+    ei_free(filter);
+    ei_free(bias);
+    ei_free(output);
+    ei_free(output_ref);
+    return failed;
+}
+
+static int bench_fully_connected(const char *name, int in_size, int out_size,
+    bench_quant_t input_q, bench_quant_t output_q)
+{
+    char label[48];
+    snprintf(label, sizeof(label), "%s %d -> %d", name, in_size, out_size);
+
+    const float filter_scale = 0.005f;
+
+    int8_t *input = (int8_t*)ei_malloc(in_size);
+    int8_t *filter = (int8_t*)ei_malloc(in_size * out_size);
+    int32_t *bias = (int32_t*)ei_malloc(out_size * sizeof(int32_t));
+    int8_t *output = (int8_t*)ei_malloc(out_size);
+    int8_t *output_ref = (int8_t*)ei_malloc(out_size);
+    int failed = 1;
+
+    if (!input || !filter || !bias || !output || !output_ref) {
+        ei_printf("%-34s | ERR: out of memory\n", label);
+        goto cleanup;
+    }
+
+    {
+        rng_fill(input, in_size);
+        rng_fill(filter, in_size * out_size);
+        for (int ix = 0; ix < out_size; ix++) {
+            bias[ix] = (int32_t)(rng_int8()) * 16;
+        }
+
+        int input_dims[] = { 2, 1, in_size };
+        int filter_dims[] = { 2, out_size, in_size };
+        int bias_dims[] = { 1, out_size };
+        int output_dims[] = { 2, 1, out_size };
+
+        TfLiteTensor tensors[4] = {
+            CreateQuantizedTensor(input, IntArrayFromInts(input_dims), input_q.scale, input_q.zero_point),
+            CreateQuantizedTensor(filter, IntArrayFromInts(filter_dims), filter_scale, 0),
+            CreateQuantizedTensor(bias, IntArrayFromInts(bias_dims), input_q.scale * filter_scale, 0),
+            CreateQuantizedTensor(output, IntArrayFromInts(output_dims), output_q.scale, output_q.zero_point),
+        };
+
+        int inputs_array[] = { 3, 0, 1, 2 };
+        int outputs_array[] = { 1, 3 };
+        TfLiteFullyConnectedParams fc_params = { kTfLiteActNone,
+            kTfLiteFullyConnectedWeightsFormatDefault, false, false };
+
+        bench_timing_t kernel;
+        if (bench_time_kernel(Register_FULLY_CONNECTED(), tensors, 4, inputs_array, outputs_array,
+                &fc_params, &kernel) != kTfLiteOk) {
+            ei_printf("%-34s | ERR: " EI_KERNEL_BENCHMARK_KERNEL_NAME " kernel failed\n", label);
+            goto cleanup;
+        }
+
+        FullyConnectedParams params = { };
+        int shift;
+        double effective_scale = static_cast<double>(input_q.scale) *
+            static_cast<double>(filter_scale) / static_cast<double>(output_q.scale);
+        QuantizeMultiplier(effective_scale, &params.output_multiplier, &shift);
+        params.output_shift = shift;
+        params.input_offset = -input_q.zero_point;
+        params.weights_offset = 0;
+        params.output_offset = output_q.zero_point;
+        activation_range(false, output_q, &params.quantized_activation_min, &params.quantized_activation_max);
+
+        RuntimeShape input_shape(2, input_dims + 1);
+        RuntimeShape filter_shape(2, filter_dims + 1);
+        RuntimeShape bias_shape(1, bias_dims + 1);
+        RuntimeShape output_shape(2, output_dims + 1);
+        bench_timing_t reference = bench_time([&]() {
+            reference_integer_ops::FullyConnected(params, input_shape, input,
+                filter_shape, filter, bias_shape, bias, output_shape, output_ref);
+        });
+
+        failed = print_result(label, (uint32_t)(in_size * out_size), kernel, reference,
+            count_mismatches(output, output_ref, out_size), out_size);
+    }
+
+cleanup:
+    ei_free(input);
+    ei_free(filter);
+    ei_free(bias);
+    ei_free(output);
+    ei_free(output_ref);
+    return failed;
+}
+
+/**
+ * 2x1 max pooling with stride 2 over a Hx1 input (as the 1D pooling layers of an impulse use)
+ */
+static int bench_max_pool(const char *name, int height, int channels, bench_quant_t quant)
+{
+    char label[48];
+    snprintf(label, sizeof(label), "%s %dx1x%d f2 s2", name, height, channels);
+
+    int out_height, out_width;
+    TfLitePaddingValues padding = ComputePaddingHeightWidth(2, 1, 1, 1, height, 1,
+        2, 1, kTfLitePaddingSame, &out_height, &out_width);
+
+    const size_t input_size = height * channels;
+    const size_t output_size = out_height * out_width * channels;
+
+    int8_t *input = (int8_t*)ei_malloc(input_size);
+    int8_t *output = (int8_t*)ei_malloc(output_size);
+    int8_t *output_ref = (int8_t*)ei_malloc(output_size);
+    int failed = 1;
+
+    if (!input || !output || !output_ref) {
+        ei_printf("%-34s | ERR: out of memory\n", label);
+        goto cleanup;
+    }
+
+    {
+        rng_fill(input, input_size);
+
+        int input_dims[] = { 4, 1, height, 1, channels };
+        int output_dims[] = { 4, 1, out_height, out_width, channels };
+
+        TfLiteTensor tensors[2] = {
+            CreateQuantizedTensor(input, IntArrayFromInts(input_dims), quant.scale, quant.zero_point),
+            CreateQuantizedTensor(output, IntArrayFromInts(output_dims), quant.scale, quant.zero_point),
+        };
+
+        int inputs_array[] = { 1, 0 };
+        int outputs_array[] = { 1, 1 };
+        TfLitePoolParams pool_params = { kTfLitePaddingSame, 1, 2, 1, 2, kTfLiteActNone, { } };
+
+        bench_timing_t kernel;
+        if (bench_time_kernel(Register_MAX_POOL_2D(), tensors, 2, inputs_array, outputs_array,
+                &pool_params, &kernel) != kTfLiteOk) {
+            ei_printf("%-34s | ERR: " EI_KERNEL_BENCHMARK_KERNEL_NAME " kernel failed\n", label);
+            goto cleanup;
+        }
+
+        PoolParams params = { };
+        params.padding_type = PaddingType::kSame;
+        params.padding_values.height = padding.height;
+        params.padding_values.width = padding.width;
+        params.stride_height = 2;
+        params.stride_width = 1;
+        params.filter_height = 2;
+        params.filter_width = 1;
+        params.quantized_activation_min = -128;
+        params.quantized_activation_max = 127;
+
+        RuntimeShape input_shape(4, input_dims + 1);
+        RuntimeShape output_shape(4, output_dims + 1);
+        bench_timing_t reference = bench_time([&]() {
+            reference_integer_ops::MaxPool(params, input_shape, input, output_shape, output_ref);
+        });
+
+        failed = print_result(label, 0, kernel, reference,
+            count_mismatches(output, output_ref, output_size), output_size);
+    }
+
+cleanup:
+    ei_free(input);
+    ei_free(output);
+    ei_free(output_ref);
+    return failed;
+}
+
+static int bench_softmax(const char *name, int classes, bench_quant_t input_q)
+{
+    char label[48];
+    snprintf(label, sizeof(label), "%s %d", name, classes);
+
+    // int8 softmax always outputs with scale 1/256 and zero point -128
+    const bench_quant_t output_q = { 1.0f / 256.0f, -128 };
+
+    int8_t *input = (int8_t*)ei_malloc(classes);
+    int8_t *output = (int8_t*)ei_malloc(classes);
+    int8_t *output_ref = (int8_t*)ei_malloc(classes);
+    int failed = 1;
+
+    if (!input || !output || !output_ref) {
+        ei_printf("%-34s | ERR: out of memory\n", label);
+        goto cleanup;
+    }
+
+    {
+        rng_fill(input, classes);
+
+        int dims[] = { 2, 1, classes };
+
+        TfLiteTensor tensors[2] = {
+            CreateQuantizedTensor(input, IntArrayFromInts(dims), input_q.scale, input_q.zero_point),
+            CreateQuantizedTensor(output, IntArrayFromInts(dims), output_q.scale, output_q.zero_point),
+        };
+
+        int inputs_array[] = { 1, 0 };
+        int outputs_array[] = { 1, 1 };
+        TfLiteSoftmaxParams softmax_params = { 1.0f };
+
+        bench_timing_t kernel;
+        if (bench_time_kernel(Register_SOFTMAX(), tensors, 2, inputs_array, outputs_array,
+                &softmax_params, &kernel) != kTfLiteOk) {
+            ei_printf("%-34s | ERR: " EI_KERNEL_BENCHMARK_KERNEL_NAME " kernel failed\n", label);
+            goto cleanup;
+        }
+
+        // same scaling as SoftmaxPrepare() for int8 inputs
+        const int scaled_diff_integer_bits = 5;
+        SoftmaxParams params = { };
+        int left_shift;
+        PreprocessSoftmaxScaling(static_cast<double>(softmax_params.beta),
+            static_cast<double>(input_q.scale), scaled_diff_integer_bits,
+            &params.input_multiplier, &left_shift);
+        params.input_left_shift = left_shift;
+        params.diff_min = -1.0 * CalculateInputRadius(scaled_diff_integer_bits, left_shift);
+
+        RuntimeShape shape(2, dims + 1);
+        bench_timing_t reference = bench_time([&]() {
+            reference_ops::Softmax(params, shape, input, shape, output_ref);
+        });
+
+        failed = print_result(label, 0, kernel, reference,
+            count_mismatches(output, output_ref, classes), classes);
+    }
+
+cleanup:
+    ei_free(input);
+    ei_free(output);
+    ei_free(output_ref);
+    return failed;
+}
+
+/* Public functions -------------------------------------------------------- */
+
+int ei_kernel_benchmark_run(bool model_only)
+{
+    // quantization of the layers in the deployed keyword spotting model
+    const bench_quant_t conv1_in = { 0.044897459f, 9 };
+    const bench_quant_t conv1_out = { 0.034876559f, -128 };
+    const bench_quant_t conv2_out = { 0.02657395f, -128 };
+    const bench_quant_t fc_out = { 0.070122108f, 33 };
+    int failed = 0;
+
+    rng_seed(0x45494b42);
+
+    ei_printf("int8 kernel benchmark, %s vs reference, min. %u us per implementation",
+        EI_KERNEL_BENCHMARK_KERNEL_NAME, (unsigned int)EI_KERNEL_BENCHMARK_MIN_US);
+    if ((uint64_t)EI_KERNEL_BENCHMARK_CPU_HZ > 0) {
+        ei_printf(", core clock %lu Hz", (unsigned long)EI_KERNEL_BENCHMARK_CPU_HZ);
+    }
+    ei_printf("\n");
+#if EI_KERNEL_BENCHMARK_OPTIMIZED == 0
+    ei_printf("No optimized kernels in this build (CMSIS-NN disabled), " EI_KERNEL_BENCHMARK_KERNEL_NAME
+        " runs the reference kernels, only bit-exactness is checked\n");
+#endif
+
+    ei_printf("Model layers:\n");
+    failed += bench_conv("conv2d", 50, 13, 8, 3, 1, conv1_in, conv1_out, true);
+    failed += bench_max_pool("max_pool", 50, 8, conv1_out);
+    failed += bench_conv("conv2d", 25, 8, 16, 3, 1, conv1_out, conv2_out, true);
+    failed += bench_max_pool("max_pool", 25, 16, conv2_out);
+    failed += bench_fully_connected("fully_connected", 208, 3, conv2_out, fc_out);
+    failed += bench_softmax("softmax", 3, fc_out);
+
+    if (!model_only) {
+        const int channels[] = { 8, 16, 32 };
+        const int kernel_sizes[] = { 3, 5 };
+        const int strides[] = { 1, 2 };
+
+        ei_printf("Conv2D sweep:\n");
+        for (int c : channels) {
+            for (int k : kernel_sizes) {
+                for (int s : strides) {
+                    failed += bench_conv("conv2d", 50, c, c, k, s, conv1_in, conv1_out, true);
+                }
+            }
+        }
+
+        ei_printf("Fully connected sweep:\n");
+        const int fc_sizes[][2] = { { 64, 16 }, { 256, 32 }, { 512, 64 }, { 1024, 16 } };
+        for (auto &size : fc_sizes) {
+            failed += bench_fully_connected("fully_connected", size[0], size[1], conv2_out, fc_out);
+        }
+
+        ei_printf("Max pool / softmax sweep:\n");
+        for (int c : channels) {
+            failed += bench_max_pool("max_pool", 50, c * 2, conv1_out);
+        }
+        failed += bench_softmax("softmax", 16, fc_out);
+        failed += bench_softmax("softmax", 64, fc_out);
+    }
+
+    ei_printf("%d case(s) failed\n", failed);
+    return failed;
+}
+
+#else
+
+int ei_kernel_benchmark_run(bool model_only)
+{
+    (void)model_only;
+    ei_printf("Kernel benchmark not available, rebuild with EI_KERNEL_BENCHMARK=1\r\n");
+    return 0;
+}
+
+#endif // EI_KERNEL_BENCHMARK == 1
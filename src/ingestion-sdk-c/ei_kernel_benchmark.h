@@ -0,0 +1,60 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_KERNEL_BENCHMARK_H
+#define EI_KERNEL_BENCHMARK_H
+
+// Build the int8 kernel benchmark (AT+BENCHKERNELS)
+#ifndef EI_KERNEL_BENCHMARK
+#define EI_KERNEL_BENCHMARK             0
+#endif
+
+// Minimum time spent per implementation per case, in microseconds
+#ifndef EI_KERNEL_BENCHMARK_MIN_US
+#define EI_KERNEL_BENCHMARK_MIN_US      20000
+#endif
+
+/**
+ * @brief      Run the int8 kernel benchmark: the layer shapes of the deployed model
+ *             plus sweeps over channels, kernel sizes and strides. Every case runs
+ *             through the registered TFLM kernel (CMSIS-NN when enabled) and through
+ *             the TFLite reference kernel, outputs are checked for bit-exactness.
+ *
+ * @param[in]  model_only  Only run the layer shapes of the deployed model
+ *
+ * @return     Number of cases that were not bit-exact or failed to run
+ */
+int ei_kernel_benchmark_run(bool model_only);
+
+#endif /* EI_KERNEL_BENCHMARK_H */
@@ -40,9 +40,84 @@
 #include "ei_microphone.h"
 #include "ei_camera.h"
 #include "ei_main.h"
+#include "ei_vad_gate.h"
+#include "ei_impulse_scheduler.h"
 #include "firmware-sdk/jpeg/encode_as_jpg.h"
 #include "firmware-sdk/at_base64_lib.h"
 #include "firmware-sdk/ei_device_interface.h"
+#include "firmware-sdk/ei_telemetry.h"
+#include "firmware-sdk/ei_result_stream.h"
+#include "firmware-sdk/ei_model_store.h"
+#include "firmware-sdk/ei_serial_tx.h"
+#if (EI_CLASSIFIER_LOADABLE_MODEL == 1) && defined(EI_CAMERA_FRAME_BUFFER_SDRAM)
+#include "SDRAM.h"
+#endif
+
+/* Private variables ------------------------------------------------------- */
+// AT+RUNIMPULSECONT=BINARY, results are written as ei_result_stream records instead of text
+static bool result_stream_enabled = false;
+static uint32_t result_stream_sequence = 0;
+static uint8_t result_stream_buffer[EI_RESULT_STREAM_MAX_RECORD];
+
+/* Private functions ------------------------------------------------------- */
+static ei_result_stream_schema_t result_stream_schema(ei_impulse_handle_t *handle)
+{
+    const ei_impulse_t *impulse = handle->impulse;
+    ei_result_stream_schema_t schema;
+    schema.labels = impulse->categories;
+    schema.label_count = (uint8_t)(impulse->label_count > 255 ? 255 : impulse->label_count);
+    schema.has_scores = impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION;
+    schema.has_anomaly = impulse->has_anomaly != EI_ANOMALY_TYPE_UNKNOWN;
+    return schema;
+}
+
+/**
+ * @brief      Start a binary result stream, sends the labels record
+ */
+static void result_stream_start(ei_impulse_handle_t *handle)
+{
+    ei_result_stream_schema_t schema = result_stream_schema(handle);
+    result_stream_sequence = 0;
+
+    // long label names may not fit the result buffer, this record is only sent once
+    size_t size = ei_result_stream_labels_size(&schema);
+    uint8_t *buffer = size <= sizeof(result_stream_buffer) ? result_stream_buffer : (uint8_t *)ei_malloc(size);
+    if (buffer == nullptr) {
+        ei_printf("ERR: Failed to allocate the labels record (%u bytes)\n", (unsigned)size);
+        return;
+    }
+
+    size_t length = ei_result_stream_encode_labels(&schema, buffer, size);
+    if (length > 0) {
+        ei_write_string((char *)buffer, (int)length);
+    }
+    if (buffer != result_stream_buffer) {
+        ei_free(buffer);
+    }
+}
+
+/**
+ * @brief      Write one result as a binary record, in a single write
+ * @param      window_end_us  When the input of the inference was complete
+ */
+static void result_stream_write(ei_impulse_handle_t *handle, const ei_impulse_result_t *result, int error, uint64_t window_end_us)
+{
+    ei_result_stream_schema_t schema = result_stream_schema(handle);
+    size_t length = ei_result_stream_encode_result(&schema, result_stream_sequence++, window_end_us, result, error,
+        result_stream_buffer, sizeof(result_stream_buffer));
+    if (length > 0) {
+        ei_write_string((char *)result_stream_buffer, (int)length);
+    }
+}
+
+static void result_stream_write_skipped(uint64_t window_end_us)
+{
+    size_t length = ei_result_stream_encode_skipped(result_stream_sequence++, window_end_us,
+        result_stream_buffer, sizeof(result_stream_buffer));
+    if (length > 0) {
+        ei_write_string((char *)result_stream_buffer, (int)length);
+    }
+}
 
 #if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE
 void run_nn(bool debug, int delay_ms, bool use_max_baudrate) {
@@ -129,6 +204,25 @@ void run_nn(bool debug, int delay_ms, bool use_max_baudrate) {
     ei_microphone_inference_end();
 }
 
+#if EI_VAD_GATE == 1
+/**
+ * Did an audited (normally gated) slice contain a keyword, i.e. a label that is not
+ * in EI_VAD_GATE_NON_KEYWORD_LABELS
+ */
+static bool vad_keyword_detected(const ei_vad_gate_t *gate, const ei_impulse_result_t *result)
+{
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (!ei_vad_gate_is_keyword(gate, result->classification[ix].label)) {
+            continue;
+        }
+        if (result->classification[ix].value >= EI_VAD_GATE_AUDIT_THRESHOLD) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
 void run_nn_continuous(bool debug)
 {
     bool stop_inferencing = false;
@@ -143,10 +237,26 @@ void run_nn_continuous(bool debug)
     ei_printf("\tNo. of classes: %d\n", sizeof(ei_classifier_inferencing_categories) /
                                             sizeof(ei_classifier_inferencing_categories[0]));
 
+#if EI_VAD_GATE == 1
+    // the gate has to stay open for a full model window after speech, so the
+    // continuous feature buffer only holds silence when slices start being skipped
+    ei_vad_gate_t vad_gate;
+    ei_vad_gate_config_t vad_config;
+    ei_vad_gate_default_config(&vad_config);
+    if (vad_config.hangover_slices < EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW) {
+        vad_config.hangover_slices = EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+    }
+    ei_vad_gate_init(&vad_gate, &vad_config);
+    ei_printf("\tVAD gate: on (hangover %d slices)\n", (int)vad_config.hangover_slices);
+#endif
+
     ei_printf("Starting inferencing, press 'b' to break\n");
 
     run_classifier_init();
     ei_microphone_inference_start(EI_CLASSIFIER_SLICE_SIZE);
+    if (result_stream_enabled) {
+        result_stream_start(&ei_default_impulse);
+    }
 
     while (stop_inferencing == false) {
 
@@ -155,21 +265,63 @@ void run_nn_continuous(bool debug)
             ei_printf("ERR: Failed to record audio...\n");
             break;
         }
+        uint64_t window_end_us = ei_read_timer_us();
+
+        bool run_slice = true;
+#if EI_VAD_GATE == 1
+        size_t slice_samples;
+        const int16_t *slice = ei_microphone_inference_get_slice(&slice_samples);
+        run_slice = ei_vad_gate_process(&vad_gate, slice, slice_samples);
+        uint64_t slice_start_us = ei_read_timer_us();
+        if (vad_gate.resumed) {
+            // the buffered features end where the gate closed, start over with this slice
+            run_classifier_continuous_restart();
+            print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
+        }
+#endif
 
-        signal_t signal;
-        signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
-        signal.get_data = &ei_microphone_audio_signal_get_data;
-        ei_impulse_result_t result = {0};
+        if (run_slice) {
+            signal_t signal;
+            signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+            signal.get_data = &ei_microphone_audio_signal_get_data;
+            ei_impulse_result_t result = {0};
+
+            EI_IMPULSE_ERROR r = run_classifier_continuous(&signal, &result, debug);
+            if (r != EI_IMPULSE_OK) {
+                if (result_stream_enabled) {
+                    result_stream_write(&ei_default_impulse, &result, r, window_end_us);
+                }
+                ei_printf("ERR: Failed to run classifier (%d)\n", r);
+                break;
+            }
 
-        EI_IMPULSE_ERROR r = run_classifier_continuous(&signal, &result, debug);
-        if (r != EI_IMPULSE_OK) {
-            ei_printf("ERR: Failed to run classifier (%d)\n", r);
-            break;
-        }
+#if EI_VAD_GATE == 1
+            ei_vad_gate_report(&vad_gate, ei_read_timer_us() - slice_start_us, vad_keyword_detected(&vad_gate, &result));
+#endif
 
-        if (++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
-            ei_print_results(&ei_default_impulse, &result);
-            print_results = 0;
+            if (result_stream_enabled) {
+                // every slice once the first model window is filled, records are cheap to send
+                if (print_results < 0) {
+                    print_results++;
+                }
+                else {
+                    result_stream_write(&ei_default_impulse, &result, r, window_end_us);
+                }
+            }
+            else if (++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
+                ei_print_results(&ei_default_impulse, &result);
+                print_results = 0;
+            }
+        }
+        else {
+            ei_telemetry_count(EI_TELEMETRY_SKIPPED_SLICES);
+            if (result_stream_enabled) {
+                result_stream_write_skipped(window_end_us);
+            }
+            else if (++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
+                ei_printf("Silence, DSP and NN skipped\n");
+                print_results = 0;
+            }
         }
 
         while (ei_get_serial_available() > 0) {
@@ -180,10 +332,124 @@ void run_nn_continuous(bool debug)
         }
     }
 
+#if EI_VAD_GATE == 1
+    ei_vad_gate_print_stats(&vad_gate);
+#endif
+
     ei_microphone_inference_end();
     run_classifier_deinit();
 }
 
+/**
+ * AT+RUNIMPULSEMULTI runs these over the one microphone stream, each continuously with its
+ * own feature window: the active model (as AT+RUNIMPULSECONT) as the wake word at its slice
+ * cadence and, when a container is loaded (AT+MODELUPLOAD), the built-in model next to it at
+ * half that rate and a lower priority. Both have the built-in MFCC block, so the built-in model
+ * takes over the wake word's features instead of running the DSP again.
+ */
+static ei_impulse_handle_t multi_impulse_handle(ei_default_impulse.impulse);
+static ei_impulse_scheduler_t multi_scheduler;
+
+static EI_IMPULSE_ERROR multi_run_classifier(ei_impulse_handle_t *handle, ei_classifier_continuous_state_t *state,
+    signal_t *signal, ei_impulse_result_t *result, bool debug)
+{
+    run_classifier_continuous_swap_state(state);
+    EI_IMPULSE_ERROR r = signal ? run_classifier_continuous(handle, signal, result, debug)
+        : run_classifier_continuous_window(handle, result, debug);
+    run_classifier_continuous_swap_state(state);
+    return r;
+}
+
+static void multi_print_result(uint8_t id, ei_impulse_handle_t *handle, ei_impulse_result_t *result)
+{
+    ei_printf("Impulse %u: ", (unsigned int)id);
+    ei_print_results(handle, result);
+}
+
+void run_nn_multi(bool debug)
+{
+    bool stop_inferencing = false;
+    uint32_t slice_us = (uint32_t)(((uint64_t)EI_CLASSIFIER_SLICE_SIZE * 1000000) / EI_CLASSIFIER_FREQUENCY);
+
+    const ei_scheduler_callbacks_t callbacks = {
+        &multi_run_classifier,
+        &ei_dsp_blocks_equal,
+        &multi_print_result,
+        &ei_microphone_inference_slice_ready
+    };
+    // the deadline is the stride: a result has to be out before the next slice is complete
+    const ei_scheduler_impulse_config_t impulses[] = {
+        { &ei_default_impulse, EI_CLASSIFIER_SLICE_SIZE, 0, slice_us },
+        { &multi_impulse_handle, 2 * EI_CLASSIFIER_SLICE_SIZE, 1, 2 * slice_us },
+    };
+    // without a loaded container both would be the built-in model
+    size_t impulses_size = (multi_impulse_handle.impulse != ei_default_impulse.impulse) ? 2 : 1;
+
+    ei_scheduler_init(&multi_scheduler, &callbacks);
+    for (size_t ix = 0; ix < impulses_size; ix++) {
+        if (ei_scheduler_register(&multi_scheduler, &impulses[ix]) < 0) {
+            ei_printf("ERR: Failed to register impulse %u\n", (unsigned int)ix);
+            return;
+        }
+    }
+
+    if (!ei_scheduler_start(&multi_scheduler, debug)) {
+        return;
+    }
+    for (size_t ix = 0; ix < impulses_size; ix++) {
+        run_classifier_init(impulses[ix].handle);
+    }
+
+    uint32_t slice_samples = ei_scheduler_slice_samples(&multi_scheduler);
+
+    ei_printf("Inferencing settings:\n");
+    ei_printf("\tImpulses: %u\n", (unsigned int)multi_scheduler.impulses_size);
+    if (impulses_size == 1) {
+        ei_printf("\tSecond impulse: none, load a model with AT+MODELUPLOAD to run it next to the built-in one\n");
+    }
+    ei_printf("\tSlice: %u ms.\n", (unsigned int)(slice_samples * 1000 / EI_CLASSIFIER_FREQUENCY));
+    ei_printf("\tCapture ring: %u ms.\n", (unsigned int)(multi_scheduler.ring_size * 1000 / EI_CLASSIFIER_FREQUENCY));
+
+    if (ei_microphone_inference_start(slice_samples) == false) {
+        ei_printf("ERR: Could not allocate audio buffer (size %u)\r\n", (unsigned int)slice_samples);
+        ei_scheduler_end(&multi_scheduler);
+        for (size_t ix = 0; ix < impulses_size; ix++) {
+            run_classifier_deinit(impulses[ix].handle);
+        }
+        return;
+    }
+
+    ei_printf("Starting inferencing, press 'b' to break\n");
+
+    while (stop_inferencing == false) {
+
+        bool m = ei_microphone_inference_record();
+        if (!m) {
+            ei_printf("ERR: Failed to record audio...\n");
+            break;
+        }
+
+        size_t n_samples;
+        const int16_t *slice = ei_microphone_inference_get_slice(&n_samples);
+        ei_scheduler_push(&multi_scheduler, slice, n_samples);
+        ei_scheduler_run_pending(&multi_scheduler);
+
+        while (ei_get_serial_available() > 0) {
+            if (ei_get_serial_byte() == 'b') {
+                ei_printf("Inferencing stopped by user\r\n");
+                stop_inferencing = true;
+            }
+        }
+    }
+
+    ei_microphone_inference_end();
+    ei_scheduler_print_stats(&multi_scheduler);
+    ei_scheduler_end(&multi_scheduler);
+    for (size_t ix = 0; ix < impulses_size; ix++) {
+        run_classifier_deinit(impulses[ix].handle);
+    }
+}
+
 #elif defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_CAMERA
 
 #define DWORD_ALIGN_PTR(a)   ((a & 0x3) ?(((uintptr_t)a + 0x4) & ~(uintptr_t)0x3) : a)
@@ -215,6 +481,10 @@ void run_nn(bool debug, int delay_ms, bool use_max_baudrate) {
         return;
     }
 
+    if (result_stream_enabled) {
+        result_stream_start(&ei_default_impulse);
+    }
+
     while(stop_inferencing == false) {
         if (delay_ms != 0) {
             ei_printf("Starting inferencing in %d seconds...\n", delay_ms / 1000);
@@ -235,6 +505,7 @@ void run_nn(bool debug, int delay_ms, bool use_max_baudrate) {
             ei_printf("Failed to capture image\r\n");
             break;
         }
+        uint64_t capture_end_us = ei_read_timer_us();
 
         // run the impulse: DSP, neural network and the Anomaly algorithm
         ei_impulse_result_t result = { 0 };
@@ -259,7 +530,12 @@ void run_nn(bool debug, int delay_ms, bool use_max_baudrate) {
             ei_printf("\r\n");
         }
 
-        ei_print_results(&ei_default_impulse, &result);
+        if (result_stream_enabled) {
+            result_stream_write(&ei_default_impulse, &result, ei_error, capture_end_us);
+        }
+        else {
+            ei_print_results(&ei_default_impulse, &result);
+        }
 
         if (debug) {
             ei_printf("End output\n");
@@ -293,6 +569,22 @@ void run_nn_continuous_normal()
 #endif
 }
 
+void run_nn_continuous_binary(void)
+{
+    result_stream_enabled = true;
+    run_nn_continuous_normal();
+    result_stream_enabled = false;
+}
+
+void run_nn_multi_normal(void)
+{
+#if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE
+    run_nn_multi(false);
+#else
+    ei_printf("Error no multi impulse scheduling available for current model\r\n");
+#endif
+}
+
 void run_nn_normal(void) {
     run_nn(false, 2000, false);
 }
@@ -311,3 +603,420 @@ void run_nn_debug(const char *baudrate_s) {
 #endif
 
 }
+
+void run_nn_arena_print(void)
+{
+#if EI_CLASSIFIER_ARENA_REPORT && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+    ei_arena_report_t *report = (ei_arena_report_t*)ei_malloc(sizeof(ei_arena_report_t));
+    if (!report) {
+        ei_printf("ERR: Failed to allocate arena report (%u bytes)\n", (unsigned int)sizeof(ei_arena_report_t));
+        return;
+    }
+
+    for (size_t ix = 0; ix < ei_default_impulse.impulse->learning_blocks_size; ix++) {
+        EI_IMPULSE_ERROR res = run_classifier_arena_report(ix, report);
+        if (res == EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE) {
+            continue;
+        }
+        if (res != EI_IMPULSE_OK) {
+            ei_printf("ERR: Failed to collect arena report for learn block %u (%d)\n", (unsigned int)ix, res);
+            continue;
+        }
+        ei_arena_report_print_json(report);
+    }
+
+    ei_free(report);
+#else
+    ei_printf("Arena report not available, rebuild with EI_CLASSIFIER_ARENA_REPORT=1\r\n");
+#endif
+}
+
+#if (EI_CLASSIFIER_LOADABLE_MODEL == 1) && (EI_CLASSIFIER_COMPILED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+/*
+ * Models loaded at runtime (AT+MODELUPLOAD): containers are kept in two A/B slots at the
+ * end of the device memory, the active one is copied to SDRAM at boot and run by the
+ * TFLite Micro interpreter in place of the EON compiled model of the same impulse.
+ * The DSP, labels and postprocessing stay the built-in ones, so the container must
+ * have the input / output of the built-in model. AT+RUNIMPULSEMULTI runs it next to the
+ * built-in model (multi_impulse_handle).
+ */
+typedef struct {
+    int slot;
+    uint8_t *model_mem;                     // model_alloc'd, the model is 16 bytes aligned in it
+    ei_impulse_t impulse;
+    ei_learning_block_t *learning_blocks;
+    ei_postprocessing_block_t *postprocessing_blocks;
+    ei_learning_block_config_tflite_graph_t block_config;
+    ei_config_tflite_graph_t graph_config;
+    ei_fill_result_classification_i8_config_t output_quant;
+    uint32_t read_us;
+    uint32_t crc_us;
+    uint32_t verify_us;
+    uint32_t test_us;
+} loaded_model_t;
+
+static EiModelStore *model_store = nullptr;
+static loaded_model_t *loaded_model = nullptr;
+static const ei_impulse_t *builtin_impulse = nullptr;
+
+static uint8_t *model_alloc(size_t size)
+{
+#ifdef EI_CAMERA_FRAME_BUFFER_SDRAM
+    return (uint8_t *)SDRAM.malloc(size);
+#else
+    return (uint8_t *)ei_malloc(size);
+#endif
+}
+
+static void model_free(loaded_model_t *model)
+{
+    if (model == nullptr) {
+        return;
+    }
+#ifdef EI_CAMERA_FRAME_BUFFER_SDRAM
+    SDRAM.free(model->model_mem);
+#else
+    ei_free(model->model_mem);
+#endif
+    ei_free(model->learning_blocks);
+    ei_free(model->postprocessing_blocks);
+    ei_free(model);
+}
+
+static void model_activate(const ei_impulse_t *impulse)
+{
+    ei_default_impulse.impulse = impulse;
+    ei_default_impulse.state.impulse = impulse;
+}
+
+static int zero_signal_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    memset(out_ptr, 0, length * sizeof(float));
+    return 0;
+}
+
+/**
+ * @brief      Check a container can replace the NN of the built-in impulse
+ * @return     nullptr if it can, otherwise the reason
+ */
+static const char *model_incompatible(const ei_model_container_header_t *header,
+                                      const ei_postprocessing_block_t *postprocessing)
+{
+    if (header->project_id != 0 && header->project_id != builtin_impulse->project_id) {
+        return "built for another project";
+    }
+    if (header->input_size != builtin_impulse->nn_input_frame_size) {
+        return "input size differs from the impulse features";
+    }
+    if (header->output_size != builtin_impulse->label_count) {
+        return "output size differs from the impulse labels";
+    }
+    if (postprocessing == nullptr) {
+        return "impulse has no classification output";
+    }
+    if ((postprocessing->postprocess_fn == &process_classification_i8 && header->output_type != EI_MODEL_CONTAINER_TYPE_INT8) ||
+        (postprocessing->postprocess_fn == &process_classification_u8 && header->output_type != EI_MODEL_CONTAINER_TYPE_UINT8) ||
+        (postprocessing->postprocess_fn == &process_classification_f32 && header->output_type != EI_MODEL_CONTAINER_TYPE_FLOAT32)) {
+        return "output type differs from the impulse";
+    }
+    if (postprocessing->postprocess_fn != &process_classification_i8 &&
+        postprocessing->postprocess_fn != &process_classification_u8 &&
+        postprocessing->postprocess_fn != &process_classification_f32) {
+        return "only classification impulses are supported";
+    }
+    return nullptr;
+}
+
+/**
+ * @brief      Copy the model of a slot to SDRAM, check it and run the impulse with it.
+ *             The running model is only replaced if a test inference succeeds.
+ */
+static bool model_load(int slot)
+{
+    const ei_model_container_header_t *header = model_store->slot_header(slot);
+    if (header == nullptr) {
+        return false;
+    }
+
+    // the TFLite block of the built-in impulse and its postprocessing
+    int block_ix = -1;
+    for (size_t ix = 0; ix < builtin_impulse->learning_blocks_size; ix++) {
+        if (builtin_impulse->learning_blocks[ix].infer_fn == &run_nn_inference) {
+            block_ix = (int)ix;
+            break;
+        }
+    }
+    if (block_ix < 0) {
+        ei_printf("ERR: Impulse has no TFLite model to replace\r\n");
+        return false;
+    }
+    const ei_learning_block_t *block = &builtin_impulse->learning_blocks[block_ix];
+    int postprocessing_ix = -1;
+    for (size_t ix = 0; ix < builtin_impulse->postprocessing_blocks_size; ix++) {
+        if (builtin_impulse->postprocessing_blocks[ix].input_block_id == block->blockId) {
+            postprocessing_ix = (int)ix;
+            break;
+        }
+    }
+
+    const char *reason = model_incompatible(header,
+        postprocessing_ix < 0 ? nullptr : &builtin_impulse->postprocessing_blocks[postprocessing_ix]);
+    if (reason) {
+        ei_printf("ERR: Model in slot %c does not fit the impulse: %s\r\n", 'A' + slot, reason);
+        return false;
+    }
+
+    loaded_model_t *model = (loaded_model_t *)ei_calloc(1, sizeof(loaded_model_t));
+    if (model == nullptr) {
+        ei_printf("ERR: Failed to allocate the model state\r\n");
+        return false;
+    }
+    model->slot = slot;
+    model->model_mem = model_alloc(header->model_size + 16);
+    model->learning_blocks = (ei_learning_block_t *)ei_malloc(builtin_impulse->learning_blocks_size * sizeof(ei_learning_block_t));
+    model->postprocessing_blocks = (ei_postprocessing_block_t *)ei_malloc(
+        builtin_impulse->postprocessing_blocks_size * sizeof(ei_postprocessing_block_t));
+    if (model->model_mem == nullptr || model->learning_blocks == nullptr || model->postprocessing_blocks == nullptr) {
+        ei_printf("ERR: Failed to allocate %u bytes for the model\r\n", (unsigned int)header->model_size);
+        model_free(model);
+        return false;
+    }
+    uint8_t *model_data = (uint8_t *)(((uintptr_t)model->model_mem + 15) & ~(uintptr_t)15);
+
+    uint64_t start_us = ei_read_timer_us();
+    bool read_ok = model_store->read_model(slot, model_data);
+    uint64_t read_end_us = ei_read_timer_us();
+    ei_model_container_status_t status = read_ok ? ei_model_container_check_crc(header, model_data)
+                                                 : EI_MODEL_CONTAINER_BAD_SIZE;
+    uint64_t crc_end_us = ei_read_timer_us();
+    if (status == EI_MODEL_CONTAINER_OK) {
+        status = ei_model_container_check_model(header, model_data);
+    }
+    uint64_t verify_end_us = ei_read_timer_us();
+
+    model->read_us = (uint32_t)(read_end_us - start_us);
+    model->crc_us = (uint32_t)(crc_end_us - read_end_us);
+    model->verify_us = (uint32_t)(verify_end_us - crc_end_us);
+
+    if (status != EI_MODEL_CONTAINER_OK) {
+        ei_printf("ERR: Model in slot %c is invalid: %s\r\n", 'A' + slot,
+            read_ok ? ei_model_container_status_str(status) : "read failed");
+        model_free(model);
+        return false;
+    }
+
+    // the built-in impulse, with the TFLite block pointing at the loaded model
+    model->graph_config.implementation_version = 1;
+    model->graph_config.model = model_data;
+    model->graph_config.model_size = header->model_size;
+    model->graph_config.arena_size = header->arena_size;
+
+    model->block_config = *(ei_learning_block_config_tflite_graph_t *)block->config;
+    model->block_config.compiled = 0;
+    // keeps run_classifier off the quantized image shortcut, that one only knows the EON model
+    model->block_config.quantized = 0;
+    model->block_config.graph_config = &model->graph_config;
+
+    memcpy(model->learning_blocks, builtin_impulse->learning_blocks,
+        builtin_impulse->learning_blocks_size * sizeof(ei_learning_block_t));
+    model->learning_blocks[block_ix].infer_fn = &ei_interpreter::run_nn_inference;
+    model->learning_blocks[block_ix].config = &model->block_config;
+
+    memcpy(model->postprocessing_blocks, builtin_impulse->postprocessing_blocks,
+        builtin_impulse->postprocessing_blocks_size * sizeof(ei_postprocessing_block_t));
+    if (header->output_type != EI_MODEL_CONTAINER_TYPE_FLOAT32) {
+        model->output_quant.zero_point = header->output_zero_point;
+        model->output_quant.scale = header->output_scale;
+        model->postprocessing_blocks[postprocessing_ix].config = &model->output_quant;
+    }
+
+    model->impulse = *builtin_impulse;
+    model->impulse.learning_blocks = model->learning_blocks;
+    model->impulse.postprocessing_blocks = model->postprocessing_blocks;
+
+    // try it before it replaces the running model
+    const ei_impulse_t *previous = ei_default_impulse.impulse;
+    model_activate(&model->impulse);
+
+    signal_t signal;
+    signal.total_length = builtin_impulse->dsp_input_frame_size;
+    signal.get_data = &zero_signal_get_data;
+    ei_impulse_result_t result = { 0 };
+
+    start_us = ei_read_timer_us();
+    EI_IMPULSE_ERROR res = run_classifier(&signal, &result, false);
+    model->test_us = (uint32_t)(ei_read_timer_us() - start_us);
+
+    if (res != EI_IMPULSE_OK) {
+        ei_printf("ERR: Model in slot %c failed to run (%d)\r\n", 'A' + slot, res);
+        model_activate(previous);
+        model_free(model);
+        return false;
+    }
+
+    model_free(loaded_model);
+    loaded_model = model;
+
+    ei_printf("Loaded model from slot %c (generation %u, %u bytes, arena %u bytes): "
+        "read %u us, CRC %u us, verify %u us, test inference %u us\r\n",
+        'A' + slot, (unsigned int)header->generation, (unsigned int)header->model_size,
+        (unsigned int)header->arena_size, (unsigned int)model->read_us, (unsigned int)model->crc_us,
+        (unsigned int)model->verify_us, (unsigned int)model->test_us);
+
+    return true;
+}
+
+/**
+ * @brief      Run the newest valid container, then the older one, else the built-in model
+ */
+static void model_select(void)
+{
+    int active = model_store->active_slot();
+
+    if (active >= 0) {
+        if (loaded_model && loaded_model->slot == active) {
+            return;
+        }
+        if (model_load(active)) {
+            return;
+        }
+
+        int other = (active == 0) ? 1 : 0;
+        if (model_store->slot_header(other) && model_load(other)) {
+            return;
+        }
+    }
+
+    if (loaded_model) {
+        model_activate(builtin_impulse);
+        model_free(loaded_model);
+        loaded_model = nullptr;
+    }
+    if (active >= 0) {
+        ei_printf("Using the built-in model\r\n");
+    }
+}
+
+static void model_print_slot(int slot)
+{
+    const ei_model_container_header_t *header = model_store->slot_header(slot);
+
+    if (header == nullptr) {
+        ei_printf("Slot %c: %s\r\n", 'A' + slot, ei_model_container_status_str(model_store->slot_status(slot)));
+        return;
+    }
+    ei_printf("Slot %c: generation %u, project %u v%u, %u bytes, arena %u bytes, %u ops%s\r\n",
+        'A' + slot, (unsigned int)header->generation, (unsigned int)header->project_id,
+        (unsigned int)header->deploy_version, (unsigned int)header->model_size,
+        (unsigned int)header->arena_size, (unsigned int)header->op_count,
+        (loaded_model && loaded_model->slot == slot) ? " (running)" : "");
+}
+#endif // EI_CLASSIFIER_LOADABLE_MODEL
+
+/**
+ * @brief      Reserve the model slots and load the active model, call once at boot
+ */
+void run_nn_model_init(void)
+{
+#if (EI_CLASSIFIER_LOADABLE_MODEL == 1) && (EI_CLASSIFIER_COMPILED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+    if (model_store) {
+        return;
+    }
+
+    builtin_impulse = ei_default_impulse.impulse;
+    model_store = new EiModelStore(EiDeviceInfo::get_device()->get_memory());
+    if (!model_store->init()) {
+        delete model_store;
+        model_store = nullptr;
+        return;
+    }
+
+    model_select();
+#endif
+}
+
+void run_nn_model_info(void)
+{
+#if (EI_CLASSIFIER_LOADABLE_MODEL == 1) && (EI_CLASSIFIER_COMPILED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+    if (model_store == nullptr) {
+        ei_printf("ERR: No model slots\r\n");
+        return;
+    }
+
+    if (loaded_model) {
+        ei_printf("Model: slot %c (interpreter), read %u us, CRC %u us, verify %u us, test inference %u us\r\n",
+            'A' + loaded_model->slot, (unsigned int)loaded_model->read_us, (unsigned int)loaded_model->crc_us,
+            (unsigned int)loaded_model->verify_us, (unsigned int)loaded_model->test_us);
+    }
+    else {
+        ei_printf("Model: built-in (EON)\r\n");
+    }
+    for (int slot = 0; slot < EI_MODEL_STORE_SLOTS; slot++) {
+        model_print_slot(slot);
+    }
+    ei_printf("Max. model size: %u bytes\r\n", (unsigned int)model_store->max_model_size());
+#else
+    ei_printf("Model: built-in, rebuild with EI_CLASSIFIER_LOADABLE_MODEL=1 to load models at runtime\r\n");
+#endif
+}
+
+/**
+ * @brief      Receive a container (AT+MODELUPLOAD) into the inactive slot and run it,
+ *             if it does not run the slot is erased again and the current model stays
+ */
+bool run_nn_model_upload(size_t length, size_t buf_len)
+{
+#if (EI_CLASSIFIER_LOADABLE_MODEL == 1) && (EI_CLASSIFIER_COMPILED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+    bool res = false;
+    if (model_store == nullptr) {
+        ei_printf("ERR: No model slots\r\n");
+    }
+    else if (ei_model_store_receive(model_store, (uint32_t)length, buf_len)) {
+        res = true;
+        int previous = model_store->active_slot();
+        int slot = (previous == 0) ? 1 : 0;
+
+        ei_model_container_status_t status = model_store->commit();
+        if (status != EI_MODEL_CONTAINER_OK) {
+            ei_printf("ERR: Failed to store the model: %s\r\n", ei_model_container_status_str(status));
+            res = false;
+        }
+        else if (!model_load(slot)) {
+            model_store->erase_slot(slot);
+            ei_printf("ERR: Model not activated, slot %c erased\r\n", 'A' + slot);
+            res = false;
+        }
+    }
+
+    ei_printf("END OUTPUT\r\n");
+    ei_serial_tx_flush();
+
+    return res;
+#else
+    ei_printf("ERR: Rebuild with EI_CLASSIFIER_LOADABLE_MODEL=1 to load models at runtime\r\n");
+    return false;
+#endif
+}
+
+/**
+ * @brief      Erase the active slot and go back to the previous model
+ */
+bool run_nn_model_rollback(void)
+{
+#if (EI_CLASSIFIER_LOADABLE_MODEL == 1) && (EI_CLASSIFIER_COMPILED == 1) && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE)
+    if (model_store == nullptr || !model_store->rollback()) {
+        ei_printf("ERR: No model to roll back\r\n");
+        return false;
+    }
+
+    model_select();
+    if (loaded_model == nullptr) {
+        ei_printf("Using the built-in model\r\n");
+    }
+
+    return true;
+#else
+    ei_printf("ERR: Rebuild with EI_CLASSIFIER_LOADABLE_MODEL=1 to load models at runtime\r\n");
+    return false;
+#endif
+}
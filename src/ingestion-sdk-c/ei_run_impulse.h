@@ -35,9 +35,19 @@
 #ifndef EI_RUN_IMPULSE_H
 #define EI_RUN_IMPULSE_H
 
+/* Include ----------------------------------------------------------------- */
+#include <stddef.h>
+
 /* Prototypes -------------------------------------------------------------- */
 void run_nn_normal(void);
 void run_nn_continuous_normal(void);
+void run_nn_continuous_binary(void);
+void run_nn_multi_normal(void);
 void run_nn_debug(const char *baudrate_s);
+void run_nn_arena_print(void);
+void run_nn_model_init(void);
+void run_nn_model_info(void);
+bool run_nn_model_upload(size_t length, size_t buf_len);
+bool run_nn_model_rollback(void);
 
 #endif
@@ -65,7 +65,7 @@ static size_t ei_write(const void *buffer, size_t size, size_t count, EI_SENSOR_
 
     for(int i=0; i<count; i++) {
 
-        write_word_buf[write_addr&0x3] = *((char *)buffer++);
+        write_word_buf[write_addr&0x3] = ((const char *)buffer)[i];
 
         if((++write_addr & 0x03) == 0x00) {
             mem->write_sample_data((const uint8_t*)write_word_buf, (write_addr - 4) + headerOffset, 4);
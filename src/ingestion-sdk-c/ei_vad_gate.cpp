@@ -0,0 +1,265 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_vad_gate.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <string.h>
+
+/* Private functions ------------------------------------------------------- */
+static uint32_t per_mille(uint64_t part, uint64_t total)
+{
+    return total > 0 ? (uint32_t)((part * 1000) / total) : 0;
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief      Fill in the gate configuration from the EI_VAD_GATE_* defines
+ */
+void ei_vad_gate_default_config(ei_vad_gate_config_t *config)
+{
+    config->frame_samples = EI_VAD_GATE_FRAME_SAMPLES;
+    config->energy_ratio = EI_VAD_GATE_ENERGY_RATIO;
+    config->min_energy = EI_VAD_GATE_MIN_ENERGY;
+    config->zcr_min = EI_VAD_GATE_ZCR_MIN;
+    config->floor_rise = EI_VAD_GATE_FLOOR_RISE;
+    config->hangover_slices = EI_VAD_GATE_HANGOVER_SLICES;
+    config->audit_interval = EI_VAD_GATE_AUDIT_INTERVAL;
+    config->non_keyword_labels = EI_VAD_GATE_NON_KEYWORD_LABELS;
+}
+
+/**
+ * @brief      Reset the gate. It starts open for hangover_slices slices, so the
+ *             feature buffer is filled before anything gets skipped.
+ */
+void ei_vad_gate_init(ei_vad_gate_t *gate, const ei_vad_gate_config_t *config)
+{
+    gate->config = *config;
+    if (gate->config.frame_samples == 0) {
+        gate->config.frame_samples = EI_VAD_GATE_FRAME_SAMPLES;
+    }
+
+    gate->stats = { };
+    gate->noise_floor = 0.0f;
+    gate->last_energy = 0.0f;
+    gate->last_zcr = 0.0f;
+    gate->hangover_left = gate->config.hangover_slices;
+    gate->gated_since_audit = 0;
+    gate->audit_left = 0;
+    gate->gated_in_row = 0;
+    gate->audit = false;
+    gate->resumed = false;
+}
+
+/**
+ * @brief      Decide whether a slice of raw audio needs to go through DSP and NN.
+ *             Runs on the int16 samples: the peak short-term energy is compared
+ *             against an adaptive noise floor, with a lower threshold for slices
+ *             with a high zero-crossing rate.
+ *
+ * @param      gate       The gate
+ * @param[in]  samples    Raw audio slice
+ * @param[in]  n_samples  Number of samples in the slice
+ *
+ * @return     true if the slice should be classified
+ */
+bool ei_vad_gate_process(ei_vad_gate_t *gate, const int16_t *samples, size_t n_samples)
+{
+    const ei_vad_gate_config_t *config = &gate->config;
+    uint64_t start_us = ei_read_timer_us();
+
+    if (n_samples == 0) {
+        return true;
+    }
+
+    // remove the DC offset of the microphone before looking at energy and crossings
+    int64_t sum = 0;
+    for (size_t ix = 0; ix < n_samples; ix++) {
+        sum += samples[ix];
+    }
+    const int32_t dc = (int32_t)(sum / (int64_t)n_samples);
+
+    size_t frame_samples = config->frame_samples < n_samples ? config->frame_samples : n_samples;
+    float peak_energy = 0.0f;
+    float min_energy = -1.0f;
+    uint32_t crossings = 0;
+    bool positive = samples[0] >= dc;
+
+    for (size_t frame = 0; frame + frame_samples <= n_samples; frame += frame_samples) {
+        uint64_t sum_squares = 0;
+        for (size_t ix = frame; ix < frame + frame_samples; ix++) {
+            int32_t v = (int32_t)samples[ix] - dc;
+            sum_squares += (uint64_t)((int64_t)v * v);
+            if ((v >= 0) != positive) {
+                positive = !positive;
+                crossings++;
+            }
+        }
+
+        float energy = (float)sum_squares / (float)frame_samples;
+        if (energy > peak_energy) {
+            peak_energy = energy;
+        }
+        if (min_energy < 0.0f || energy < min_energy) {
+            min_energy = energy;
+        }
+    }
+
+    const float zcr = (float)crossings / (float)n_samples;
+
+    // the quietest sub-frame tracks the background: follow drops quickly, rises slowly
+    if (gate->noise_floor <= 0.0f) {
+        gate->noise_floor = min_energy;
+    }
+    else if (min_energy < gate->noise_floor) {
+        gate->noise_floor += (min_energy - gate->noise_floor) * 0.5f;
+    }
+    else {
+        gate->noise_floor += (min_energy - gate->noise_floor) * config->floor_rise;
+    }
+    if (gate->noise_floor < 1.0f) {
+        gate->noise_floor = 1.0f;
+    }
+
+    const float threshold = gate->noise_floor * config->energy_ratio;
+    const bool active = peak_energy >= config->min_energy &&
+        (peak_energy >= threshold || (zcr >= config->zcr_min && peak_energy >= threshold * 0.5f));
+
+    gate->last_energy = peak_energy;
+    gate->last_zcr = zcr;
+    gate->audit = false;
+    gate->stats.slices++;
+
+    bool run = true;
+    if (active) {
+        gate->stats.active_slices++;
+        gate->hangover_left = config->hangover_slices;
+        gate->gated_since_audit = 0;
+        gate->audit_left = 0;
+    }
+    else if (gate->hangover_left > 0) {
+        gate->hangover_left--;
+    }
+    else if (gate->audit_left > 0) {
+        gate->audit_left--;
+        gate->audit = true;
+        gate->stats.audited_slices++;
+    }
+    else if (config->audit_interval > 0 && ++gate->gated_since_audit >= config->audit_interval) {
+        gate->gated_since_audit = 0;
+        gate->audit_left = config->hangover_slices > 0 ? config->hangover_slices - 1 : 0;
+        gate->audit = true;
+        gate->stats.audited_slices++;
+    }
+    else {
+        run = false;
+    }
+
+    gate->resumed = run && gate->gated_in_row > 0;
+    if (run) {
+        gate->stats.processed_slices++;
+        gate->gated_in_row = 0;
+    }
+    else {
+        gate->gated_in_row++;
+    }
+
+    gate->stats.gate_us += ei_read_timer_us() - start_us;
+
+    return run;
+}
+
+/**
+ * @brief      Report the outcome of a slice that was let through. A keyword in an
+ *             audited slice counts as a missed trigger and re-opens the gate.
+ *
+ * @param      gate              The gate
+ * @param[in]  processed_us      Time spent in DSP and NN for the slice
+ * @param[in]  keyword_detected  Whether the classifier found a keyword
+ */
+void ei_vad_gate_report(ei_vad_gate_t *gate, uint64_t processed_us, bool keyword_detected)
+{
+    gate->stats.processed_us += processed_us;
+
+    if (gate->audit && keyword_detected) {
+        gate->stats.missed_triggers++;
+        gate->hangover_left = gate->config.hangover_slices;
+    }
+}
+
+/**
+ * @brief      Whether a label is a keyword, i.e. not in config.non_keyword_labels
+ */
+bool ei_vad_gate_is_keyword(const ei_vad_gate_t *gate, const char *label)
+{
+    if (!label) {
+        return false;
+    }
+
+    const char *entry = gate->config.non_keyword_labels;
+    while (entry && *entry) {
+        const char *end = strchr(entry, ',');
+        size_t len = end ? (size_t)(end - entry) : strlen(entry);
+        if (len > 0 && entry[len - 1] == '*') {
+            if (strncmp(label, entry, len - 1) == 0) {
+                return false;
+            }
+        }
+        else if (strlen(label) == len && strncmp(label, entry, len) == 0) {
+            return false;
+        }
+        entry = end ? end + 1 : nullptr;
+    }
+    return true;
+}
+
+void ei_vad_gate_print_stats(const ei_vad_gate_t *gate)
+{
+    const ei_vad_gate_stats_t *stats = &gate->stats;
+    uint32_t duty = per_mille(stats->processed_slices, stats->slices);
+    uint32_t gated = stats->slices - stats->processed_slices;
+    uint64_t gate_cost_us = stats->slices > 0 ? stats->gate_us / stats->slices : 0;
+    uint64_t slice_cost_us = stats->processed_slices > 0 ? stats->processed_us / stats->processed_slices : 0;
+    uint64_t saved_us = (uint64_t)gated * slice_cost_us;
+    saved_us = saved_us > stats->gate_us ? saved_us - stats->gate_us : 0;
+
+    ei_printf("VAD gate: %u slices, %u active, %u processed (duty cycle %u.%u%%), "
+        "%u audited, %u missed triggers\n",
+        (unsigned int)stats->slices, (unsigned int)stats->active_slices,
+        (unsigned int)stats->processed_slices, (unsigned int)(duty / 10), (unsigned int)(duty % 10),
+        (unsigned int)stats->audited_slices, (unsigned int)stats->missed_triggers);
+    ei_printf("VAD gate: %u us per slice in the gate, %u us per processed slice, %u ms saved\n",
+        (unsigned int)gate_cost_us, (unsigned int)slice_cost_us, (unsigned int)(saved_us / 1000));
+}
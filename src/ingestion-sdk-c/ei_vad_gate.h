@@ -0,0 +1,142 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_VAD_GATE_H
+#define EI_VAD_GATE_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Constants --------------------------------------------------------------- */
+// Skip DSP and NN for silent slices in continuous audio inferencing
+#ifndef EI_VAD_GATE
+#define EI_VAD_GATE                     0
+#endif
+
+// Length of the sub-frames the energy is measured over (10 ms at 16 kHz)
+#ifndef EI_VAD_GATE_FRAME_SAMPLES
+#define EI_VAD_GATE_FRAME_SAMPLES       160
+#endif
+
+// A sub-frame is active when its energy is this many times the noise floor (~9 dB)
+#ifndef EI_VAD_GATE_ENERGY_RATIO
+#define EI_VAD_GATE_ENERGY_RATIO        8.0f
+#endif
+
+// Absolute minimum energy (mean square, in int16 units) for a sub-frame to be active
+#ifndef EI_VAD_GATE_MIN_ENERGY
+#define EI_VAD_GATE_MIN_ENERGY          64.0f
+#endif
+
+// Zero-crossing rate above which half the energy ratio is enough (fricatives, e.g. 's')
+#ifndef EI_VAD_GATE_ZCR_MIN
+#define EI_VAD_GATE_ZCR_MIN             0.25f
+#endif
+
+// How fast the noise floor follows a louder background, per slice
+#ifndef EI_VAD_GATE_FLOOR_RISE
+#define EI_VAD_GATE_FLOOR_RISE          0.0625f
+#endif
+
+// Slices that are still processed after the last active slice. Keep this at least
+// EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW, so the continuous feature buffer and the
+// postprocessing state hold a full window of silence once the gate closes.
+#ifndef EI_VAD_GATE_HANGOVER_SLICES
+#define EI_VAD_GATE_HANGOVER_SLICES     4
+#endif
+
+// After this many gated slices, classify hangover_slices slices anyway to count missed
+// triggers (0 = off). An audit has to fill a model window, as the feature buffer starts
+// over whenever the gate opens.
+#ifndef EI_VAD_GATE_AUDIT_INTERVAL
+#define EI_VAD_GATE_AUDIT_INTERVAL      60
+#endif
+
+// Score over which an audited slice counts as a missed keyword
+#ifndef EI_VAD_GATE_AUDIT_THRESHOLD
+#define EI_VAD_GATE_AUDIT_THRESHOLD     0.6f
+#endif
+
+// Comma separated labels that are not keywords (not counted as missed triggers),
+// a trailing '*' matches any label starting with the text before it
+#ifndef EI_VAD_GATE_NON_KEYWORD_LABELS
+#define EI_VAD_GATE_NON_KEYWORD_LABELS  "noise,unknown,_*"
+#endif
+
+/* Types ------------------------------------------------------------------- */
+typedef struct {
+    uint16_t frame_samples;
+    float energy_ratio;
+    float min_energy;
+    float zcr_min;
+    float floor_rise;
+    uint16_t hangover_slices;
+    uint16_t audit_interval;
+    const char *non_keyword_labels;
+} ei_vad_gate_config_t;
+
+typedef struct {
+    uint32_t slices;            // slices seen by the gate
+    uint32_t active_slices;     // slices with voice activity
+    uint32_t processed_slices;  // slices passed on to DSP / NN (active, hangover and audits)
+    uint32_t audited_slices;    // silent slices that were classified anyway
+    uint32_t missed_triggers;   // audited slices that did contain a keyword
+    uint64_t gate_us;           // time spent in the gate
+    uint64_t processed_us;      // time spent in DSP / NN on processed slices
+} ei_vad_gate_stats_t;
+
+typedef struct {
+    ei_vad_gate_config_t config;
+    ei_vad_gate_stats_t stats;
+    float noise_floor;          // mean square energy, 0 until the first slice
+    float last_energy;          // peak sub-frame energy of the last slice
+    float last_zcr;             // zero-crossing rate of the last slice
+    uint16_t hangover_left;
+    uint16_t gated_since_audit;
+    uint16_t audit_left;        // slices left in the current audit
+    uint32_t gated_in_row;      // slices skipped since the last processed slice
+    bool audit;                 // the last slice is only processed as an audit
+    bool resumed;               // the last slice is the first one processed after skipped slices
+} ei_vad_gate_t;
+
+/* Function prototypes ----------------------------------------------------- */
+void ei_vad_gate_default_config(ei_vad_gate_config_t *config);
+void ei_vad_gate_init(ei_vad_gate_t *gate, const ei_vad_gate_config_t *config);
+bool ei_vad_gate_process(ei_vad_gate_t *gate, const int16_t *samples, size_t n_samples);
+void ei_vad_gate_report(ei_vad_gate_t *gate, uint64_t processed_us, bool keyword_detected);
+bool ei_vad_gate_is_keyword(const ei_vad_gate_t *gate, const char *label);
+void ei_vad_gate_print_stats(const ei_vad_gate_t *gate);
+
+#endif /* EI_VAD_GATE_H */
@@ -0,0 +1,595 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__linux__)
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_device_linux.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <deque>
+#include "mbed.h"
+#include "ei_flash_portenta.h"
+#include "firmware-sdk/ei_serial_tx.h"
+#include "sensors/ei_camera.h"
+#include "sensors/ei_microphone.h"
+
+#ifdef EI_CAMERA_FRAME_BUFFER_SDRAM
+#include "SDRAM.h"
+#endif
+/* Constants --------------------------------------------------------------- */
+
+/** Max size for device id array */
+#define DEVICE_ID_MAX_SIZE  32
+
+/** Sensors */
+typedef enum
+{
+    MICROPHONE = 0
+
+}used_sensors_t;
+
+/** Max Data Output Baudrate, the host has no baudrate but the CLI expects one */
+const ei_device_data_output_baudrate_t ei_dev_max_data_output_baudrate = {
+    "115200",
+    115200,
+};
+
+/** Default Data Output Baudrate */
+const ei_device_data_output_baudrate_t ei_dev_default_data_output_baudrate = {
+    "115200",
+    115200,
+};
+
+/**
+ * Once the input is closed and consumed, the firmware counts as idle when it keeps
+ * polling the serial port (AT server loop, every 10 ms) for this long
+ */
+#define SERIAL_IDLE_TIME_US     (200 * 1000)
+#define SERIAL_IDLE_POLL_GAP_US (50 * 1000)
+
+/** Serial output drain thread, same arrangement as on the board */
+#define SERIAL_TX_FLAG_DATA     (1 << 0)
+static unsigned char serial_tx_thread_stack[2 * 1024];
+static rtos::Thread serial_tx_thread(osPriorityAboveNormal1, sizeof(serial_tx_thread_stack), serial_tx_thread_stack, "serial-tx-thread");
+static rtos::Mutex serial_tx_mutex;
+
+/** Serial input, read from stdin or the pty by its own thread */
+static rtos::Thread serial_rx_thread(osPriorityAboveNormal, OS_STACK_SIZE, nullptr, "serial-rx-thread");
+static std::mutex serial_rx_mutex;
+static std::deque<char> serial_rx;
+static bool serial_rx_closed = false;
+static uint64_t serial_starved_since_us = 0;
+static uint64_t serial_starved_last_us = 0;
+
+static int serial_in_fd = -1;
+static int serial_out_fd = -1;
+static bool serial_is_tty = false;
+static struct termios serial_saved_termios;
+
+static mbed::Stream serial_stream;
+
+/* Private function declarations ------------------------------------------- */
+static size_t serial_tx_write(const uint8_t *data, size_t length);
+static void serial_tx_lock(void);
+static void serial_tx_unlock(void);
+static void serial_tx_wake(void);
+static void serial_tx_wait(void);
+static void serial_tx_drain_thread(void);
+static void serial_rx_reader_thread(void);
+
+static const ei_serial_tx_port_t serial_tx_port = {
+    serial_tx_write,
+    serial_tx_lock,
+    serial_tx_unlock,
+    serial_tx_wake,
+    serial_tx_wait,
+};
+
+/* Public functions -------------------------------------------------------- */
+
+EiDevicePortenta::EiDevicePortenta(EiDeviceMemory* mem)
+{
+    EiDeviceInfo::memory = mem;
+
+    load_config();
+    init_device_id();
+
+    device_type = std::string("PORTENTA_H7_LINUX");
+
+    ei_program_state = eiStateIdle;
+
+#ifdef EI_CAMERA_FRAME_BUFFER_SDRAM
+    // initialise the SDRAM
+    SDRAM.begin(SDRAM_START_ADDRESS);
+#endif
+    // (may) depends on the SDRAM
+    camera_present = ei_camera_init();
+}
+
+EiDeviceInfo* EiDeviceInfo::get_device(void)
+{
+    static EiFlashMemory memory(sizeof(EiConfig));
+    static EiDevicePortenta dev(&memory);
+
+    return &dev;
+}
+
+/**
+ * @brief      Device id from the machine id (or host name), formatted like the board's
+ */
+void EiDevicePortenta::init_device_id(void)
+{
+    char id[64] = { 0 };
+    char buf[DEVICE_ID_MAX_SIZE];
+
+    FILE *f = fopen("/etc/machine-id", "r");
+    if (!f || !fgets(id, sizeof(id), f) || strlen(id) < 12) {
+        // hash the host name into hex digits instead
+        char host[64] = "linux";
+        gethostname(host, sizeof(host) - 1);
+        uint64_t hash = 1469598103934665603ULL;
+        for (const char *c = host; *c; c++) {
+            hash = (hash ^ (uint8_t)*c) * 1099511628211ULL;
+        }
+        snprintf(id, sizeof(id), "%016llx", (unsigned long long)hash);
+    }
+    if (f) {
+        fclose(f);
+    }
+
+    /* Setup device ID ei_device_id */
+    snprintf(&buf[0], DEVICE_ID_MAX_SIZE, "%c%c:%c%c:%c%c:%c%c:%c%c:%c%c"
+        , id[0], id[1], id[2], id[3], id[4], id[5]
+        , id[6], id[7], id[8], id[9], id[10], id[11]
+        );
+
+    device_id = std::string(buf);
+}
+
+/**
+ * @brief      Set output baudrate to max
+ *
+ */
+void EiDevicePortenta::set_max_data_output_baudrate()
+{
+    ei_serial_set_baudrate(ei_dev_max_data_output_baudrate.val);
+}
+
+/**
+ * @brief      Set output baudrate to default
+ *
+ */
+void EiDevicePortenta::set_default_data_output_baudrate(void)
+{
+    ei_serial_set_baudrate(ei_dev_default_data_output_baudrate.val);
+}
+
+/**
+ * @brief      No Wifi available for device.
+ *
+ * @return     Always return false
+ */
+bool EiDevicePortenta::get_wifi_connection_status(void)
+{
+    return false;
+}
+
+/**
+ * @brief      No Wifi available for device.
+ *
+ * @return     Always return false
+ */
+bool EiDevicePortenta::get_wifi_present_status(void)
+{
+    return false;
+}
+
+/**
+ * @brief      Create sensor list with sensor specs
+ *             The studio and daemon require this list
+ * @param      sensor_list       Place pointer to sensor list
+ * @param      sensor_list_size  Write number of sensors here
+ *
+ * @return     False if all went ok
+ */
+bool EiDevicePortenta::get_sensor_list(const ei_device_sensor_t **sensor_list, size_t *sensor_list_size)
+{
+    /* Calculate number of bytes available on flash for sampling, reserve 1 block for header + overhead */
+    uint32_t available_bytes = (memory->get_available_sample_blocks()-1) * memory->block_size;
+
+    sensors[MICROPHONE].name = "Built-in microphone";
+    sensors[MICROPHONE].start_sampling_cb = &ei_microphone_sample_start;
+    sensors[MICROPHONE].max_sample_length_s = available_bytes / (16000 * 2);
+    sensors[MICROPHONE].frequencies[0] = 16000.0f;
+
+    *sensor_list      = sensors;
+    *sensor_list_size = EI_DEVICE_N_SENSORS;
+
+    return false;
+}
+
+/**
+ * @brief      Create resolution list for snapshot setting
+ *             The studio and daemon require this list
+ * @param      snapshot_list       Place pointer to resolution list
+ * @param      snapshot_list_size  Write number of resolutions here
+ *
+ * @return     False if all went ok
+ */
+bool EiDevicePortenta::get_snapshot_list(const ei_device_snapshot_resolutions_t **snapshot_list, size_t *snapshot_list_size,
+                                         const char **color_depth)
+{
+    snapshot_resolutions[0].width = 320;
+    snapshot_resolutions[0].height = 240;
+    snapshot_resolutions[1].width = 160;
+    snapshot_resolutions[1].height = 120;
+    snapshot_resolutions[2].width = 128;
+    snapshot_resolutions[2].height = 96;
+
+#if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_CAMERA
+    snapshot_resolutions[2].width = EI_CLASSIFIER_INPUT_WIDTH;
+    snapshot_resolutions[2].height = EI_CLASSIFIER_INPUT_HEIGHT;
+#endif
+
+    *snapshot_list      = snapshot_resolutions;
+    *snapshot_list_size = EI_DEVICE_N_RESOLUTIONS;
+    *color_depth = "Grayscale";
+
+    return false;
+}
+
+/**
+ * @brief      Create resolution list for resizing
+ * @param      resize_list       Place pointer to resolution list
+ * @param      resize_list_size  Write number of resolutions here
+ *
+ * @return     False if all went ok
+ */
+bool EiDevicePortenta::get_resize_list(const ei_device_snapshot_resolutions_t **resize_list, size_t *resize_list_size)
+{
+    resize_resolutions[0].width = 128;
+    resize_resolutions[0].height = 96;
+
+    resize_resolutions[1].width = 160;
+    resize_resolutions[1].height = 120;
+
+    resize_resolutions[2].width = 200;
+    resize_resolutions[2].height = 150;
+
+    resize_resolutions[3].width = 256;
+    resize_resolutions[3].height = 192;
+
+    resize_resolutions[4].width = 320;
+    resize_resolutions[4].height = 240;
+
+    *resize_list      = resize_resolutions;
+    *resize_list_size = EI_DEVICE_N_RESIZE_RESOLUTIONS;
+
+    return false;
+}
+
+void EiDevicePortenta::set_state(EiState state)
+{
+    static const char *state_names[] = { "idle", "erasing flash", "sampling", "uploading", "finished" };
+
+    if (ei_sim_get_config()->verbose && state != ei_program_state && (size_t)state < sizeof(state_names) / sizeof(state_names[0])) {
+        fprintf(stderr, "[sim] state: %s\n", state_names[state]);
+    }
+
+    ei_program_state = state;
+
+    if((state == eiStateFinished) || (state == eiStateIdle)){
+        ei_program_state = eiStateIdle;
+    }
+}
+
+/**
+ * @brief      Call this function periocally during inference to
+ *             detect a user stop command
+ *
+ * @return     true if user requested stop
+ */
+bool ei_user_invoke_stop(void) {
+    return false;
+}
+
+/**
+ * @brief      Write serial data with length to Serial output
+ *
+ * @param      data    The data
+ * @param[in]  length  The length
+ */
+void ei_write_string(char *data, int length) {
+    ei_serial_tx_write(data, length);
+}
+
+/**
+ * @brief      Route all serial output through the buffered output channel
+ *             and start its drain thread
+ */
+void ei_serial_tx_setup(void)
+{
+    ei_serial_tx_init(&serial_tx_port);
+    serial_tx_thread.start(mbed::callback(serial_tx_drain_thread));
+    ei_serial_tx_start();
+}
+
+void ei_putchar(char c)
+{
+    ei_serial_tx_write(&c, 1);
+}
+
+char ei_getchar(void)
+{
+    std::lock_guard<std::mutex> lock(serial_rx_mutex);
+    char ch = 0;
+
+    if (!serial_rx.empty()) {
+        ch = serial_rx.front();
+        serial_rx.pop_front();
+    }
+    return ch;
+}
+
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    ei_serial_tx_vprintf(format, args);
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "%.6f", f);
+    ei_serial_tx_write(buf, n);
+}
+
+/**
+ * @brief      Get serial object
+ *
+ * @return     pointer to Serial
+ */
+mbed::Stream* ei_get_serial() {
+    return &serial_stream;
+}
+
+/**
+ * @brief      Check if new serial data is available
+ *
+ * @return     Returns number of available bytes
+ */
+int ei_get_serial_available(void) {
+    std::lock_guard<std::mutex> lock(serial_rx_mutex);
+
+    if (serial_rx.empty() && serial_rx_closed) {
+        uint64_t now = ei_read_timer_us();
+        if (serial_starved_last_us == 0 || now - serial_starved_last_us > SERIAL_IDLE_POLL_GAP_US) {
+            serial_starved_since_us = now;
+        }
+        serial_starved_last_us = now;
+    }
+
+    return (int)serial_rx.size();
+}
+
+/**
+ * @brief      Get next available byte
+ *
+ * @return     byte
+ */
+char ei_get_serial_byte(void) {
+    return ei_getchar();
+}
+
+void ei_print_memory_info2(void)
+{
+    rtos::thread_for_each([](const rtos::Thread *thread, void *) {
+        ei_printf("Thread: 0x%lX, Name: %s, Stack size: %lu\r\n", (unsigned long)(uintptr_t)thread,
+            thread->get_name() ? thread->get_name() : "", (unsigned long)thread->stack_size());
+    }, nullptr);
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    ei_printf("Heap size: %lu / %lu bytes\r\n", (unsigned long)mi.uordblks, (unsigned long)mi.arena);
+#endif
+}
+
+/**
+ * @brief      Connect the serial port to stdin/stdout or a new pseudo terminal
+ *
+ * @return     false if the pty could not be created
+ */
+bool ei_sim_serial_open(void)
+{
+    if (ei_sim_get_config()->serial_mode == EI_SIM_SERIAL_PTY) {
+        int fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+            fprintf(stderr, "[sim] Failed to create a pseudo terminal (%s)\n", strerror(errno));
+            return false;
+        }
+
+        struct termios tio;
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+
+        serial_in_fd = fd;
+        serial_out_fd = fd;
+        fprintf(stderr, "[sim] Serial port: %s\n", ptsname(fd));
+    }
+    else {
+        serial_in_fd = STDIN_FILENO;
+        serial_out_fd = STDOUT_FILENO;
+
+        // a terminal sends characters as typed, Enter as '\r', and does not echo
+        if (isatty(serial_in_fd) && tcgetattr(serial_in_fd, &serial_saved_termios) == 0) {
+            struct termios tio = serial_saved_termios;
+            tio.c_lflag &= ~(ICANON | ECHO);
+            tio.c_iflag &= ~(ICRNL | INLCR);
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(serial_in_fd, TCSANOW, &tio);
+            serial_is_tty = true;
+        }
+    }
+
+    serial_rx_thread.start(mbed::callback(serial_rx_reader_thread));
+
+    return true;
+}
+
+/**
+ * @brief      Give the terminal its settings back
+ */
+void ei_sim_serial_close(void)
+{
+    if (serial_is_tty) {
+        tcsetattr(serial_in_fd, TCSANOW, &serial_saved_termios);
+    }
+}
+
+/**
+ * @brief      True when the input was closed, all of it was handled and
+ *             the firmware is back to waiting for commands
+ */
+bool ei_sim_serial_idle(void)
+{
+    std::lock_guard<std::mutex> lock(serial_rx_mutex);
+    uint64_t now = ei_read_timer_us();
+
+    return serial_rx_closed && serial_rx.empty() && serial_starved_last_us != 0
+        && (now - serial_starved_last_us) < SERIAL_IDLE_POLL_GAP_US
+        && (serial_starved_last_us - serial_starved_since_us) >= SERIAL_IDLE_TIME_US;
+}
+
+/* Private functions ------------------------------------------------------- */
+static size_t serial_tx_write(const uint8_t *data, size_t length)
+{
+    size_t written = 0;
+
+    while (written < length) {
+        ssize_t r = write(serial_out_fd, data + written, length - written);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // nobody on the other end (closed pipe or pty), drop like an unplugged USB port
+            return length;
+        }
+        written += r;
+    }
+
+    return written;
+}
+
+static void serial_tx_lock(void)
+{
+    serial_tx_mutex.lock();
+}
+
+static void serial_tx_unlock(void)
+{
+    serial_tx_mutex.unlock();
+}
+
+static void serial_tx_wake(void)
+{
+    serial_tx_thread.flags_set(SERIAL_TX_FLAG_DATA);
+}
+
+static void serial_tx_wait(void)
+{
+    rtos::ThisThread::sleep_for(1);
+}
+
+static void serial_tx_drain_thread(void)
+{
+    while (1) {
+        while (ei_serial_tx_drain() > 0) {
+        }
+        rtos::ThisThread::flags_wait_any(SERIAL_TX_FLAG_DATA);
+    }
+}
+
+static void serial_rx_reader_thread(void)
+{
+    const bool is_pty = (ei_sim_get_config()->serial_mode == EI_SIM_SERIAL_PTY);
+    // piped input has '\n' line endings, the AT server runs a command on '\r'
+    const bool map_newline = !is_pty && !serial_is_tty;
+    char prev = 0;
+    char buf[256];
+
+    while (1) {
+        ssize_t n = read(serial_in_fd, buf, sizeof(buf));
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            // a pty reports EIO until the other side is opened (again)
+            if (is_pty) {
+                rtos::ThisThread::sleep_for(100);
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(serial_rx_mutex);
+            serial_rx_closed = true;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(serial_rx_mutex);
+        for (ssize_t i = 0; i < n; i++) {
+            if (map_newline && buf[i] == '\n' && prev != '\r') {
+                serial_rx.push_back('\r');
+            }
+            else {
+                serial_rx.push_back(buf[i]);
+            }
+            prev = buf[i];
+        }
+    }
+}
+
+#endif // __linux__
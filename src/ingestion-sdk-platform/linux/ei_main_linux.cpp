@@ -0,0 +1,242 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__linux__)
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_device_linux.h"
+#include "ei_main.h"
+#include "firmware-sdk/ei_serial_tx.h"
+#include "firmware-sdk/ei_telemetry.h"
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Private variables ------------------------------------------------------- */
+static ei_sim_config_t sim_config = {
+    nullptr,                // flash_file
+    EI_SIM_FLASH_SIZE,      // flash_size
+    0,                      // flash_erase_ms
+    0,                      // flash_program_us
+    nullptr,                // camera_source
+    nullptr,                // audio_file
+    1.0f,                   // audio_pace
+    EI_SIM_SERIAL_STDIO,    // serial_mode
+    false,                  // verbose
+};
+
+static char **main_argv;
+static const char *stats_file = nullptr;
+
+static const struct option long_options[] = {
+    { "flash",              required_argument, nullptr, 'f' },
+    { "flash-size",         required_argument, nullptr, 's' },
+    { "flash-erase-ms",     required_argument, nullptr, 'e' },
+    { "flash-program-us",   required_argument, nullptr, 'p' },
+    { "camera",             required_argument, nullptr, 'c' },
+    { "audio",              required_argument, nullptr, 'a' },
+    { "audio-pace",         required_argument, nullptr, 'r' },
+    { "pty",                no_argument,       nullptr, 't' },
+    { "verbose",            no_argument,       nullptr, 'v' },
+    { "stats",              required_argument, nullptr, 'S' },
+    { "help",               no_argument,       nullptr, 'h' },
+    { nullptr,              0,                 nullptr, 0 }
+};
+
+/* Private functions ------------------------------------------------------- */
+static void print_usage(const char *name)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "Runs the firmware as a Linux process, AT commands on stdin (or a pty).\n"
+        "\n"
+        "  -f, --flash FILE           flash image to keep config and samples in (default: RAM only)\n"
+        "  -s, --flash-size BYTES     sample storage size, multiple of %u (default: %u)\n"
+        "  -e, --flash-erase-ms MS    time to erase one flash sector (default: 0)\n"
+        "  -p, --flash-program-us US  time to program one %u-byte flash word (default: 0)\n"
+        "  -c, --camera PATH          PGM/PPM image, or directory of images (default: synthetic)\n"
+        "  -a, --audio FILE           16-bit PCM WAV file for the microphone (default: synthetic tone)\n"
+        "  -r, --audio-pace FACTOR    audio speed, 1 is real time (default: 1)\n"
+        "  -t, --pty                  serial port on a new pseudo terminal instead of stdin/stdout\n"
+        "  -v, --verbose              log simulated peripheral activity on stderr\n"
+        "  -S, --stats FILE           write the inference telemetry (AT+STATS) as JSON on exit\n"
+        "  -h, --help                 show this help\n",
+        name, EI_SIM_FLASH_SECTOR_SIZE, EI_SIM_FLASH_SIZE, EI_SIM_FLASH_WORD_SIZE);
+}
+
+static bool parse_uint(const char *arg, uint32_t *value)
+{
+    char *end;
+    unsigned long v = strtoul(arg, &end, 0);
+
+    if (*arg == '\0' || *arg == '-' || *end != '\0' || v > UINT32_MAX) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    return true;
+}
+
+static bool parse_options(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "f:s:e:p:c:a:r:tvS:h", long_options, nullptr)) != -1) {
+        bool ok = true;
+
+        switch (opt) {
+            case 'f': sim_config.flash_file = optarg; break;
+            case 's':
+                ok = parse_uint(optarg, &sim_config.flash_size) && sim_config.flash_size > 0
+                    && (sim_config.flash_size % EI_SIM_FLASH_SECTOR_SIZE) == 0;
+                break;
+            case 'e': ok = parse_uint(optarg, &sim_config.flash_erase_ms); break;
+            case 'p': ok = parse_uint(optarg, &sim_config.flash_program_us); break;
+            case 'c': sim_config.camera_source = optarg; break;
+            case 'a': sim_config.audio_file = optarg; break;
+            case 'r':
+                sim_config.audio_pace = strtof(optarg, nullptr);
+                ok = sim_config.audio_pace > 0.0f;
+                break;
+            case 't': sim_config.serial_mode = EI_SIM_SERIAL_PTY; break;
+            case 'v': sim_config.verbose = true; break;
+            case 'S': stats_file = optarg; break;
+            default:
+                print_usage(argv[0]);
+                return false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Invalid value '%s' for option -%c\n", optarg, opt);
+            return false;
+        }
+    }
+
+    if (optind < argc) {
+        print_usage(argv[0]);
+        return false;
+    }
+
+    return true;
+}
+
+static void on_signal(int sig)
+{
+    ei_sim_serial_close();
+    _exit(128 + sig);
+}
+
+static void write_stats_text(const char *text, void *ctx)
+{
+    fputs(text, (FILE *)ctx);
+}
+
+static void write_stats(void)
+{
+    if (!stats_file) {
+        return;
+    }
+
+    FILE *f = fopen(stats_file, "w");
+    if (!f) {
+        fprintf(stderr, "[sim] Failed to open %s\n", stats_file);
+        return;
+    }
+    ei_telemetry_print_json(&write_stats_text, f);
+    fclose(f);
+}
+
+/**
+ * @brief      Leave without running static destructors, the firmware threads
+ *             are still running and use those objects
+ */
+static void sim_exit(int code)
+{
+    ei_serial_tx_flush();
+    ei_sim_serial_close();
+    write_stats();
+    fflush(stderr);
+    _exit(code);
+}
+
+/* Public functions -------------------------------------------------------- */
+ei_sim_config_t *ei_sim_get_config(void)
+{
+    return &sim_config;
+}
+
+/**
+ * @brief      AT+RESET, the process starts over with the same command line
+ *             (and the same flash image)
+ */
+void NVIC_SystemReset(void)
+{
+    ei_serial_tx_flush();
+    ei_sim_serial_close();
+    execv("/proc/self/exe", main_argv);
+    fprintf(stderr, "[sim] Failed to restart\n");
+    _exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    main_argv = argv;
+
+    if (!parse_options(argc, argv)) {
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!ei_sim_serial_open()) {
+        return 1;
+    }
+
+    ei_main_init();
+
+    // ei_main() only idles the Arduino loop, here the main thread waits for
+    // the end of the input (stdin mode) instead
+    while (!ei_sim_serial_idle()) {
+        rtos::ThisThread::sleep_for(20);
+    }
+
+    sim_exit(0);
+    return 0;
+}
+
+#endif // __linux__
@@ -0,0 +1,87 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_SIM_CONFIG_H
+#define EI_SIM_CONFIG_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+
+/* Constants --------------------------------------------------------------- */
+// Sample storage (flash behind FLASHIAP_APP_ROM_END_ADDR), multiple of the sector size
+#ifndef EI_SIM_FLASH_SIZE
+#define EI_SIM_FLASH_SIZE               (1024 * 1024)
+#endif
+
+// Erase granularity of the STM32H7 internal flash
+#ifndef EI_SIM_FLASH_SECTOR_SIZE
+#define EI_SIM_FLASH_SECTOR_SIZE        (128 * 1024)
+#endif
+
+// Program granularity of the STM32H7 internal flash (one 256-bit flash word)
+#ifndef EI_SIM_FLASH_WORD_SIZE
+#define EI_SIM_FLASH_WORD_SIZE          32
+#endif
+
+/* Types ------------------------------------------------------------------- */
+typedef enum {
+    EI_SIM_SERIAL_STDIO = 0,    // AT commands on stdin, output on stdout
+    EI_SIM_SERIAL_PTY = 1       // pseudo terminal, for the Edge Impulse CLI
+} ei_sim_serial_mode_t;
+
+/**
+ * Simulated peripherals of the Linux target, filled in from the command line
+ */
+typedef struct {
+    // Flash image backing the device memory, NULL keeps it in RAM only
+    const char *flash_file;
+    uint32_t flash_size;
+    // Latency per erased sector and per programmed flash word
+    uint32_t flash_erase_ms;
+    uint32_t flash_program_us;
+    // PGM/PPM file or directory of them, NULL for the synthetic generator
+    const char *camera_source;
+    // 16-bit PCM WAV file, NULL for the synthetic generator
+    const char *audio_file;
+    // Audio delivery speed, 1.0 is real time
+    float audio_pace;
+    ei_sim_serial_mode_t serial_mode;
+    // Print peripheral activity on stderr
+    bool verbose;
+} ei_sim_config_t;
+
+/* Function prototypes ----------------------------------------------------- */
+ei_sim_config_t *ei_sim_get_config(void);
+
+#endif /* EI_SIM_CONFIG_H */
@@ -0,0 +1,186 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__linux__)
+
+/* Include ----------------------------------------------------------------- */
+#include "FlashIAP.h"
+#include "ei_sim_config.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+
+/* Private functions ------------------------------------------------------- */
+static void flash_busy(uint64_t us)
+{
+    if (us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+namespace mbed {
+
+FlashIAP::~FlashIAP()
+{
+    deinit();
+}
+
+int FlashIAP::init(void)
+{
+    ei_sim_config_t *cfg = ei_sim_get_config();
+
+    if (_flash) {
+        return 0;
+    }
+
+    _size = FLASHIAP_APP_ROM_END_ADDR + cfg->flash_size;
+
+    if (cfg->flash_file == nullptr) {
+        _flash = (uint8_t *)mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (_flash == MAP_FAILED) {
+            _flash = nullptr;
+            return -1;
+        }
+        memset(_flash, 0xFF, _size);
+        return 0;
+    }
+
+    int fd = open(cfg->flash_file, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[sim] Failed to open flash file %s (%s)\n", cfg->flash_file, strerror(errno));
+        return -1;
+    }
+
+    // a new (or grown) image starts out erased
+    struct stat st;
+    fstat(fd, &st);
+    if ((uint32_t)st.st_size != _size) {
+        if (ftruncate(fd, _size) != 0) {
+            fprintf(stderr, "[sim] Failed to resize flash file %s (%s)\n", cfg->flash_file, strerror(errno));
+            close(fd);
+            return -1;
+        }
+    }
+
+    _flash = (uint8_t *)mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (_flash == MAP_FAILED) {
+        _flash = nullptr;
+        return -1;
+    }
+
+    if ((uint32_t)st.st_size < _size) {
+        memset(_flash + st.st_size, 0xFF, _size - st.st_size);
+    }
+
+    return 0;
+}
+
+int FlashIAP::deinit(void)
+{
+    if (_flash) {
+        msync(_flash, _size, MS_SYNC);
+        munmap(_flash, _size);
+        _flash = nullptr;
+    }
+    return 0;
+}
+
+int FlashIAP::read(void *buffer, uint32_t addr, uint32_t size)
+{
+    if (!_flash || addr > _size || size > _size - addr) {
+        return -1;
+    }
+
+    memcpy(buffer, _flash + addr, size);
+    return 0;
+}
+
+int FlashIAP::program(const void *buffer, uint32_t addr, uint32_t size)
+{
+    const uint8_t *src = (const uint8_t *)buffer;
+
+    if (!_flash || addr > _size || size > _size - addr) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < size; i++) {
+        _flash[addr + i] &= src[i];
+    }
+
+    uint32_t words = (size + EI_SIM_FLASH_WORD_SIZE - 1) / EI_SIM_FLASH_WORD_SIZE;
+    flash_busy((uint64_t)words * ei_sim_get_config()->flash_program_us);
+
+    return 0;
+}
+
+int FlashIAP::erase(uint32_t addr, uint32_t size)
+{
+    if (!_flash || addr > _size || size > _size - addr
+        || (addr % EI_SIM_FLASH_SECTOR_SIZE) != 0 || (size % EI_SIM_FLASH_SECTOR_SIZE) != 0) {
+        return -1;
+    }
+
+    memset(_flash + addr, 0xFF, size);
+
+    uint32_t sectors = size / EI_SIM_FLASH_SECTOR_SIZE;
+    flash_busy((uint64_t)sectors * ei_sim_get_config()->flash_erase_ms * 1000);
+
+    if (ei_sim_get_config()->verbose) {
+        fprintf(stderr, "[sim] flash: erased %u sector(s) at 0x%08x\n", sectors, addr);
+    }
+
+    return 0;
+}
+
+uint32_t FlashIAP::get_sector_size(uint32_t addr) const
+{
+    return (addr < _size) ? EI_SIM_FLASH_SECTOR_SIZE : 0;
+}
+
+uint32_t FlashIAP::get_page_size(void) const
+{
+    return EI_SIM_FLASH_WORD_SIZE;
+}
+
+} // namespace mbed
+
+#endif // __linux__
@@ -0,0 +1,78 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Host stand-in for mbed::FlashIAP: the internal flash is a file mapped into
+ * memory, with NOR semantics (program can only clear bits, erase sets whole
+ * sectors to 0xFF) and configurable erase/program latency, see ei_sim_config.h
+ */
+
+#ifndef EI_LINUX_FLASHIAP_H
+#define EI_LINUX_FLASHIAP_H
+
+/* Include ----------------------------------------------------------------- */
+#include "mbed.h"
+#include <stdint.h>
+
+/* Constants --------------------------------------------------------------- */
+// End of the (simulated) application image, sample storage starts here
+#define FLASHIAP_APP_ROM_END_ADDR       (1024 * 1024)
+
+namespace mbed {
+
+class FlashIAP {
+public:
+    FlashIAP() : _flash(nullptr), _size(0) { }
+    ~FlashIAP();
+
+    int init(void);
+    int deinit(void);
+    int read(void *buffer, uint32_t addr, uint32_t size);
+    int program(const void *buffer, uint32_t addr, uint32_t size);
+    int erase(uint32_t addr, uint32_t size);
+
+    uint32_t get_sector_size(uint32_t addr) const;
+    uint32_t get_flash_start(void) const { return 0; }
+    uint32_t get_flash_size(void) const { return _size; }
+    uint32_t get_page_size(void) const;
+    uint8_t get_erase_value(void) const { return 0xFF; }
+
+private:
+    uint8_t *_flash;
+    uint32_t _size;
+};
+
+} // namespace mbed
+
+#endif /* EI_LINUX_FLASHIAP_H */
@@ -0,0 +1,265 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__linux__)
+
+/* Include ----------------------------------------------------------------- */
+#include "PDM.h"
+#include "ei_sim_config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+/* Constants --------------------------------------------------------------- */
+#define SYNTHETIC_TONE_HZ           440
+#define SYNTHETIC_AMPLITUDE         3000
+
+/* Public variables -------------------------------------------------------- */
+PDMClass PDM;
+
+/* Private functions ------------------------------------------------------- */
+static uint32_t get_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+/**
+ * @brief      Load the first channel of a 16-bit PCM WAV file
+ *
+ * @return     false if the file can't be read or has an unsupported format
+ */
+static bool load_wav(const char *path, std::vector<int16_t> *samples, uint32_t *sample_rate)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[sim] Failed to open audio file %s\n", path);
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(&data[0], "RIFF", 4) != 0 || memcmp(&data[8], "WAVE", 4) != 0) {
+        fprintf(stderr, "[sim] %s is not a WAV file\n", path);
+        return false;
+    }
+
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    size_t pos = 12;
+
+    while (pos + 8 <= data.size()) {
+        uint32_t chunk_len = get_le32(&data[pos + 4]);
+        const uint8_t *chunk = &data[pos + 8];
+        size_t chunk_avail = std::min<size_t>(chunk_len, data.size() - pos - 8);
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && chunk_avail >= 16) {
+            uint16_t format = get_le16(chunk);
+            channels = get_le16(chunk + 2);
+            *sample_rate = get_le32(chunk + 4);
+            bits = get_le16(chunk + 14);
+            // 0xFFFE: WAVE_FORMAT_EXTENSIBLE, sub format is checked through the sample size
+            if ((format != 1 && format != 0xFFFE) || bits != 16 || channels == 0) {
+                fprintf(stderr, "[sim] %s: only 16-bit PCM is supported\n", path);
+                return false;
+            }
+        }
+        else if (memcmp(&data[pos], "data", 4) == 0 && channels > 0) {
+            size_t frames = chunk_avail / (2 * channels);
+            samples->resize(frames);
+            for (size_t i = 0; i < frames; i++) {
+                (*samples)[i] = (int16_t)get_le16(chunk + i * 2 * channels);
+            }
+            return frames > 0;
+        }
+
+        pos += 8 + chunk_len + (chunk_len & 1);
+    }
+
+    fprintf(stderr, "[sim] %s: no audio data found\n", path);
+    return false;
+}
+
+/**
+ * @brief      Linear interpolation to the rate the firmware asks for
+ */
+static void resample(std::vector<int16_t> *samples, uint32_t from_rate, uint32_t to_rate)
+{
+    if (from_rate == to_rate || samples->size() < 2) {
+        return;
+    }
+
+    const std::vector<int16_t> in(*samples);
+    size_t out_len = (size_t)((uint64_t)in.size() * to_rate / from_rate);
+
+    samples->resize(out_len);
+    for (size_t i = 0; i < out_len; i++) {
+        double pos = (double)i * from_rate / to_rate;
+        size_t ix = (size_t)pos;
+        double frac = pos - ix;
+        int16_t a = in[std::min(ix, in.size() - 1)];
+        int16_t b = in[std::min(ix + 1, in.size() - 1)];
+        (*samples)[i] = (int16_t)lrint(a + (b - a) * frac);
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+PDMClass::PDMClass()
+    : _on_receive(nullptr), _gain(-1), _buffer_size(512), _sample_rate(16000), _ready_len(0), _running(false)
+{
+}
+
+PDMClass::~PDMClass()
+{
+    end();
+}
+
+int PDMClass::begin(int channels, int sampleRate)
+{
+    ei_sim_config_t *cfg = ei_sim_get_config();
+
+    end();
+
+    if (channels != 1 || sampleRate <= 0 || _buffer_size < 2) {
+        return 0;
+    }
+    _sample_rate = sampleRate;
+
+    _source.clear();
+    if (cfg->audio_file) {
+        uint32_t file_rate = 0;
+        if (!load_wav(cfg->audio_file, &_source, &file_rate)) {
+            return 0;
+        }
+        resample(&_source, file_rate, _sample_rate);
+    }
+    else {
+        // one second, a whole number of periods so the loop is seamless
+        _source.resize(_sample_rate);
+        for (int i = 0; i < _sample_rate; i++) {
+            _source[i] = (int16_t)(SYNTHETIC_AMPLITUDE * sin(2.0 * M_PI * SYNTHETIC_TONE_HZ * i / _sample_rate));
+        }
+    }
+
+    _ready.assign(_buffer_size, 0);
+    _ready_len = 0;
+    _running = true;
+    _thread = std::thread(&PDMClass::feed, this);
+
+    if (cfg->verbose) {
+        fprintf(stderr, "[sim] pdm: started, %d Hz, %d byte buffers, pace %.2fx\n", _sample_rate, _buffer_size, cfg->audio_pace);
+    }
+
+    return 1;
+}
+
+void PDMClass::end(void)
+{
+    _running = false;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+int PDMClass::available(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_ready_len;
+}
+
+int PDMClass::read(void *buffer, size_t size)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t n = std::min(size, _ready_len);
+
+    memcpy(buffer, _ready.data(), n);
+    _ready_len = 0;
+
+    return (int)n;
+}
+
+void PDMClass::onReceive(void (*function)(void))
+{
+    _on_receive = function;
+}
+
+/**
+ * @brief      Feeder thread, stands in for the PDM DMA and its interrupt
+ */
+void PDMClass::feed(void)
+{
+    const size_t chunk_samples = _buffer_size / 2;
+    const double pace = ei_sim_get_config()->audio_pace;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t delivered = 0;
+    size_t pos = 0;
+
+    while (_running) {
+        // a buffer is handed over once it has been "recorded"
+        delivered += chunk_samples;
+        auto due = start + std::chrono::microseconds((uint64_t)(delivered * 1e6 / (_sample_rate * pace)));
+        std::this_thread::sleep_until(due);
+        if (!_running) {
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            int16_t *out = (int16_t *)_ready.data();
+            for (size_t i = 0; i < chunk_samples; i++) {
+                out[i] = _source[pos];
+                pos = (pos + 1 == _source.size()) ? 0 : pos + 1;
+            }
+            _ready_len = chunk_samples * 2;
+        }
+
+        if (_on_receive) {
+            _on_receive();
+        }
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,86 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Host stand-in for the Arduino PDM library. Samples come from the WAV file
+ * in ei_sim_config_t (or a synthetic tone when none is set) and are delivered
+ * in setBufferSize() chunks from a feeder thread, paced at audio_pace times
+ * real time, calling the onReceive() handler like the PDM DMA interrupt does.
+ */
+
+#ifndef EI_LINUX_PDM_H
+#define EI_LINUX_PDM_H
+
+/* Include ----------------------------------------------------------------- */
+#include "mbed.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PDMClass {
+public:
+    PDMClass();
+    ~PDMClass();
+
+    int begin(int channels, int sampleRate);
+    void end(void);
+
+    int available(void);
+    int read(void *buffer, size_t size);
+
+    void onReceive(void (*function)(void));
+    void setGain(int gain) { _gain = gain; }
+    void setBufferSize(int bufferSize) { _buffer_size = bufferSize; }
+
+private:
+    void feed(void);
+
+    void (*_on_receive)(void);
+    int _gain;
+    int _buffer_size;
+    int _sample_rate;
+    std::vector<int16_t> _source;
+    std::vector<uint8_t> _ready;
+    size_t _ready_len;
+    std::mutex _mutex;
+    std::atomic<bool> _running;
+    std::thread _thread;
+};
+
+extern PDMClass PDM;
+
+#endif /* EI_LINUX_PDM_H */
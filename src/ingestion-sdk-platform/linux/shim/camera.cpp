@@ -0,0 +1,289 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__linux__)
+
+/* Include ----------------------------------------------------------------- */
+#include "camera.h"
+#include "ei_sim_config.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Private functions ------------------------------------------------------- */
+static bool is_pnm_name(const char *name)
+{
+    const char *ext = strrchr(name, '.');
+
+    return ext && (strcasecmp(ext, ".pgm") == 0 || strcasecmp(ext, ".ppm") == 0
+                   || strcasecmp(ext, ".pnm") == 0);
+}
+
+/**
+ * @brief      Files to cycle through: the source itself, or the PGM/PPM files
+ *             of a directory in name order
+ */
+static std::vector<std::string> list_sources(const char *source)
+{
+    std::vector<std::string> files;
+    struct stat st;
+
+    if (stat(source, &st) != 0) {
+        return files;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+        files.push_back(source);
+        return files;
+    }
+
+    DIR *dir = opendir(source);
+    if (!dir) {
+        return files;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (is_pnm_name(entry->d_name)) {
+            files.push_back(std::string(source) + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static bool pnm_token(FILE *f, unsigned *value)
+{
+    int c = fgetc(f);
+
+    while (c != EOF && (isspace(c) || c == '#')) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') {
+                c = fgetc(f);
+            }
+        }
+        c = fgetc(f);
+    }
+
+    if (c == EOF || !isdigit(c)) {
+        return false;
+    }
+
+    *value = 0;
+    while (c != EOF && isdigit(c)) {
+        *value = *value * 10 + (c - '0');
+        c = fgetc(f);
+    }
+    // binary pixel data starts right after this single whitespace
+    return true;
+}
+
+/**
+ * @brief      Load a PGM (P2/P5) or PPM (P3/P6) image as 8-bit grayscale
+ */
+static bool load_pnm(const char *path, std::vector<uint8_t> *gray, uint32_t *width, uint32_t *height)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[sim] Failed to open image %s\n", path);
+        return false;
+    }
+
+    char magic[2];
+    unsigned w, h, maxval;
+    bool ok = fread(magic, 1, 2, f) == 2 && magic[0] == 'P'
+        && (magic[1] == '2' || magic[1] == '3' || magic[1] == '5' || magic[1] == '6')
+        && pnm_token(f, &w) && pnm_token(f, &h) && pnm_token(f, &maxval)
+        && w > 0 && h > 0 && maxval > 0 && maxval < 65536;
+
+    if (!ok) {
+        fprintf(stderr, "[sim] %s is not a PGM/PPM image\n", path);
+        fclose(f);
+        return false;
+    }
+
+    bool color = (magic[1] == '3' || magic[1] == '6');
+    bool ascii = (magic[1] == '2' || magic[1] == '3');
+    int channels = color ? 3 : 1;
+
+    gray->resize((size_t)w * h);
+    for (size_t i = 0; ok && i < gray->size(); i++) {
+        unsigned px[3];
+        for (int c = 0; c < channels; c++) {
+            if (ascii) {
+                ok = pnm_token(f, &px[c]);
+            }
+            else {
+                int hi = (maxval > 255) ? fgetc(f) : 0;
+                int lo = fgetc(f);
+                ok = (hi != EOF && lo != EOF);
+                px[c] = (hi << 8) | lo;
+            }
+        }
+        unsigned v = color ? (299 * px[0] + 587 * px[1] + 114 * px[2]) / 1000 : px[0];
+        (*gray)[i] = (uint8_t)(std::min(v, maxval) * 255 / maxval);
+    }
+    fclose(f);
+
+    if (!ok) {
+        fprintf(stderr, "[sim] %s: truncated image data\n", path);
+        return false;
+    }
+
+    *width = w;
+    *height = h;
+    return true;
+}
+
+/**
+ * @brief      Nearest neighbour scaling of the source image to the sensor size
+ */
+static void scale_into(const uint8_t *src, uint32_t src_w, uint32_t src_h, uint8_t *dst, uint32_t dst_w, uint32_t dst_h)
+{
+    for (uint32_t y = 0; y < dst_h; y++) {
+        const uint8_t *row = src + (size_t)((y * src_h + src_h / 2) / dst_h) * src_w;
+        for (uint32_t x = 0; x < dst_w; x++) {
+            dst[(size_t)y * dst_w + x] = row[(x * src_w + src_w / 2) / dst_w];
+        }
+    }
+}
+
+/**
+ * @brief      Moving gradient with a bright square sweeping across it
+ */
+static void synthesize(uint8_t *dst, uint32_t width, uint32_t height, uint32_t frame)
+{
+    uint32_t side = height / 4;
+    uint32_t sq_x = (frame * 4) % (width - side);
+    uint32_t sq_y = (height - side) / 2;
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            bool in_square = x >= sq_x && x < sq_x + side && y >= sq_y && y < sq_y + side;
+            dst[(size_t)y * width + x] = in_square ? 240 : (uint8_t)(((x + y + frame) * 160) / (width + height));
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+FrameBuffer::FrameBuffer(int32_t x, int32_t y, int32_t bpp)
+    : _fb_size(x * y * bpp), _fb((uint8_t *)malloc(x * y * bpp)), _is_allocated(true)
+{
+}
+
+FrameBuffer::~FrameBuffer()
+{
+    if (_is_allocated) {
+        free(_fb);
+    }
+}
+
+void FrameBuffer::setBuffer(uint8_t *buffer)
+{
+    if (_is_allocated) {
+        free(_fb);
+        _is_allocated = false;
+    }
+    _fb = buffer;
+}
+
+int Camera::begin(int32_t resolution, int32_t pixformat, int32_t framerate)
+{
+    ei_sim_config_t *cfg = ei_sim_get_config();
+    static const uint32_t resolutions[CAMERA_RMAX][2] = { { 160, 120 }, { 320, 240 }, { 320, 320 } };
+
+    if (resolution < 0 || resolution >= CAMERA_RMAX || pixformat != CAMERA_GRAYSCALE || framerate <= 0) {
+        return 0;
+    }
+
+    if (cfg->camera_source && list_sources(cfg->camera_source).empty()) {
+        fprintf(stderr, "[sim] No PGM/PPM images found at %s\n", cfg->camera_source);
+        return 0;
+    }
+
+    _width = resolutions[resolution][0];
+    _height = resolutions[resolution][1];
+    _frame_us = 1000000 / framerate;
+    _frame_count = 0;
+    _last_frame = std::chrono::steady_clock::now();
+
+    return 1;
+}
+
+int Camera::grabFrame(FrameBuffer &fb, uint32_t timeout)
+{
+    ei_sim_config_t *cfg = ei_sim_get_config();
+    size_t frame_size = (size_t)_width * _height;
+
+    if (_width == 0 || fb.getBuffer() == nullptr
+        || (fb.hasFixedSize() && fb.getBufferSize() < frame_size)) {
+        return -1;
+    }
+
+    // the sensor streams at a fixed rate, a grab waits for the next frame
+    _last_frame = std::max(_last_frame + std::chrono::microseconds(_frame_us), std::chrono::steady_clock::now());
+    std::this_thread::sleep_until(_last_frame);
+
+    if (cfg->camera_source) {
+        std::vector<std::string> files = list_sources(cfg->camera_source);
+        std::vector<uint8_t> image;
+        uint32_t w, h;
+
+        if (files.empty() || !load_pnm(files[_frame_count % files.size()].c_str(), &image, &w, &h)) {
+            return -1;
+        }
+        scale_into(image.data(), w, h, fb.getBuffer(), _width, _height);
+
+        if (cfg->verbose) {
+            fprintf(stderr, "[sim] camera: frame %u from %s\n", _frame_count, files[_frame_count % files.size()].c_str());
+        }
+    }
+    else {
+        synthesize(fb.getBuffer(), _width, _height, _frame_count);
+    }
+
+    _frame_count++;
+    return 0;
+}
+
+#endif // __linux__
@@ -0,0 +1,111 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Host stand-in for the Arduino camera library. Frames are read from a PGM/PPM
+ * file (or each file of a directory in turn) or drawn by a synthetic generator,
+ * see ei_sim_config_t, converted to grayscale and scaled to the sensor resolution.
+ */
+
+#ifndef EI_LINUX_CAMERA_H
+#define EI_LINUX_CAMERA_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+
+namespace mbed {
+class Stream;
+}
+
+/* Constants --------------------------------------------------------------- */
+enum {
+    CAMERA_R160x120 = 0,
+    CAMERA_R320x240,
+    CAMERA_R320x320,
+    CAMERA_RMAX
+};
+
+enum {
+    CAMERA_GRAYSCALE = 0,
+    CAMERA_BAYER,
+    CAMERA_RGB565,
+    CAMERA_PMAX
+};
+
+class ImageSensor {
+public:
+    virtual ~ImageSensor() { }
+    virtual const char *name(void) const = 0;
+};
+
+class FrameBuffer {
+public:
+    FrameBuffer() : _fb_size(0), _fb(nullptr), _is_allocated(false) { }
+    FrameBuffer(int32_t x, int32_t y, int32_t bpp);
+    ~FrameBuffer();
+    FrameBuffer(const FrameBuffer &) = delete;
+    FrameBuffer &operator=(const FrameBuffer &) = delete;
+
+    uint32_t getBufferSize(void) { return _fb_size; }
+    uint8_t *getBuffer(void) { return _fb; }
+    void setBuffer(uint8_t *buffer);
+    bool hasFixedSize(void) { return _fb_size != 0; }
+    bool isAllocated(void) { return _is_allocated; }
+
+private:
+    uint32_t _fb_size;
+    uint8_t *_fb;
+    bool _is_allocated;
+};
+
+class Camera {
+public:
+    Camera(ImageSensor &sensor) : _sensor(sensor), _width(0), _height(0), _frame_us(0), _frame_count(0) { }
+
+    int begin(int32_t resolution = CAMERA_R320x240, int32_t pixformat = CAMERA_GRAYSCALE, int32_t framerate = 30);
+    int grabFrame(FrameBuffer &fb, uint32_t timeout = 5000);
+    void debug(mbed::Stream &stream) { }
+
+private:
+    ImageSensor &_sensor;
+    uint32_t _width;
+    uint32_t _height;
+    uint32_t _frame_us;
+    uint32_t _frame_count;
+    std::chrono::steady_clock::time_point _last_frame;
+};
+
+#endif /* EI_LINUX_CAMERA_H */
@@ -0,0 +1,268 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Host stand-in for the parts of the Mbed OS API used by the firmware
+ * (threads, flags, event queue, timers, digital outputs), built on the
+ * C++ standard library so the shared sources compile unmodified on Linux.
+ * Thread priorities and stack sizes are recorded but not enforced.
+ */
+
+#ifndef EI_LINUX_MBED_H
+#define EI_LINUX_MBED_H
+
+/* Include ----------------------------------------------------------------- */
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+// Mbed OS pulls in Mbed TLS through its network stack, the signing code relies on it
+#include "mbedtls/md.h"
+
+/* Constants --------------------------------------------------------------- */
+#ifndef OS_STACK_SIZE
+#define OS_STACK_SIZE       4096
+#endif
+
+typedef enum {
+    osPriorityNone = 0,
+    osPriorityIdle = 1,
+    osPriorityLow = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityAboveNormal1 = 32 + 1,
+    osPriorityHigh = 40,
+    osPriorityRealtime = 48,
+    osPriorityISR = 56,
+    osPriorityError = -1
+} osPriority;
+
+typedef enum {
+    osOK = 0,
+    osError = -1,
+    osErrorTimeout = -2,
+    osErrorResource = -3,
+    osErrorParameter = -4,
+    osErrorNoMemory = -5
+} osStatus;
+
+typedef enum {
+    LED1 = 0,
+    LED2,
+    LED3,
+    LED_RED = LED1,
+    LED_GREEN = LED2,
+    LED_BLUE = LED3
+} PinName;
+
+/** Restarts the firmware process with the same command line */
+void NVIC_SystemReset(void);
+
+/* mbed -------------------------------------------------------------------- */
+namespace mbed {
+
+template <typename Signature>
+using Callback = std::function<Signature>;
+
+template <typename F>
+Callback<void()> callback(F func)
+{
+    return Callback<void()>(func);
+}
+
+template <typename T, typename R>
+Callback<void()> callback(T *obj, R (T::*method)())
+{
+    return Callback<void()>([obj, method]() { (obj->*method)(); });
+}
+
+/** Placeholder for the serial stream type exposed by ei_get_serial() */
+class Stream {
+public:
+    virtual ~Stream() { }
+};
+
+class DigitalOut {
+public:
+    DigitalOut(PinName pin, int value = 0) : _pin(pin), _value(value) { }
+    void write(int value) { _value = value; }
+    int read(void) { return _value; }
+    DigitalOut &operator=(int value) { write(value); return *this; }
+    operator int() { return read(); }
+
+private:
+    PinName _pin;
+    std::atomic<int> _value;
+};
+
+class Timer {
+public:
+    Timer() : _running(false), _elapsed(0) { }
+    void start(void);
+    void stop(void);
+    void reset(void);
+    float read(void) { return read_us() / 1000000.0f; }
+    int read_ms(void) { return (int)(read_us() / 1000); }
+    int read_us(void) { return (int)read_high_resolution_us(); }
+    uint64_t read_high_resolution_us(void);
+    std::chrono::microseconds elapsed_time(void) { return std::chrono::microseconds(read_high_resolution_us()); }
+
+private:
+    bool _running;
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::microseconds _elapsed;
+};
+
+/** Periodic callback, run from a host thread instead of the ticker interrupt */
+class Ticker {
+public:
+    Ticker() : _running(false) { }
+    ~Ticker() { detach(); }
+    void attach(Callback<void()> func, float t) { attach_us(func, (uint64_t)(t * 1000000.0f)); }
+    void attach_us(Callback<void()> func, uint64_t t_us);
+    void detach(void);
+
+private:
+    void run(void);
+
+    Callback<void()> _func;
+    std::chrono::microseconds _period;
+    bool _running;
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+};
+
+} // namespace mbed
+
+/* rtos -------------------------------------------------------------------- */
+namespace rtos {
+
+/** Per thread event flags, as set by Thread::flags_set() */
+struct ThreadFlags {
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t flags = 0;
+};
+
+class Thread {
+public:
+    Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE,
+           unsigned char *stack_mem = nullptr, const char *name = nullptr);
+    ~Thread();
+
+    osStatus start(mbed::Callback<void()> task);
+    osStatus join(void);
+    uint32_t flags_set(uint32_t flags);
+
+    osPriority get_priority(void) const { return _priority; }
+    uint32_t stack_size(void) const { return _stack_size; }
+    const char *get_name(void) const { return _name; }
+
+private:
+    osPriority _priority;
+    uint32_t _stack_size;
+    const char *_name;
+    bool _started;
+    std::thread _thread;
+    ThreadFlags _flags;
+};
+
+namespace ThisThread {
+    void sleep_for(uint32_t millisec);
+    void yield(void);
+    uint32_t flags_get(void);
+    uint32_t flags_clear(uint32_t flags);
+    uint32_t flags_wait_any(uint32_t flags, bool clear = true);
+    uint32_t flags_wait_all(uint32_t flags, bool clear = true);
+}
+
+class Mutex {
+public:
+    void lock(void) { _mutex.lock(); }
+    bool trylock(void) { return _mutex.try_lock(); }
+    osStatus unlock(void) { _mutex.unlock(); return osOK; }
+
+private:
+    std::recursive_mutex _mutex;
+};
+
+/** Called for every Thread that was started, for the memory report */
+typedef void (*thread_visitor_t)(const Thread *thread, void *arg);
+void thread_for_each(thread_visitor_t visitor, void *arg);
+
+} // namespace rtos
+
+/* events ------------------------------------------------------------------ */
+namespace events {
+
+class EventQueue {
+public:
+    EventQueue(unsigned size = 32 * 8, unsigned char *buffer = nullptr) : _break(false), _next_id(1) { }
+
+    template <typename F, typename... Args>
+    int call(F f, Args... args)
+    {
+        return post(std::bind(f, args...));
+    }
+
+    void dispatch_forever(void) { dispatch(-1); }
+    void dispatch(int ms = -1);
+    void break_dispatch(void);
+
+private:
+    int post(std::function<void()> event);
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::deque<std::function<void()>> _events;
+    bool _break;
+    int _next_id;
+};
+
+} // namespace events
+
+using namespace mbed;
+
+#endif /* EI_LINUX_MBED_H */
@@ -0,0 +1,332 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#if defined(__linux__)
+
+/* Include ----------------------------------------------------------------- */
+#include "mbed.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+/* Private variables ------------------------------------------------------- */
+static thread_local rtos::ThreadFlags *current_flags = nullptr;
+
+/* Private functions ------------------------------------------------------- */
+static std::mutex &registry_mutex(void)
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<const rtos::Thread *> &registry(void)
+{
+    static std::vector<const rtos::Thread *> threads;
+    return threads;
+}
+
+static rtos::ThreadFlags &this_thread_flags(void)
+{
+    static thread_local rtos::ThreadFlags own_flags;
+
+    return current_flags ? *current_flags : own_flags;
+}
+
+static uint32_t wait_flags(uint32_t flags, bool all, bool clear)
+{
+    rtos::ThreadFlags &tf = this_thread_flags();
+    std::unique_lock<std::mutex> lock(tf.mutex);
+
+    tf.cond.wait(lock, [&]() {
+        return all ? ((tf.flags & flags) == flags) : ((tf.flags & flags) != 0);
+    });
+
+    uint32_t ret = tf.flags;
+    if (clear) {
+        tf.flags &= ~flags;
+    }
+    return ret;
+}
+
+/* mbed -------------------------------------------------------------------- */
+namespace mbed {
+
+void Timer::start(void)
+{
+    if (!_running) {
+        _start = std::chrono::steady_clock::now();
+        _running = true;
+    }
+}
+
+void Timer::stop(void)
+{
+    if (_running) {
+        _elapsed += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+        _running = false;
+    }
+}
+
+void Timer::reset(void)
+{
+    _elapsed = std::chrono::microseconds(0);
+    _start = std::chrono::steady_clock::now();
+}
+
+uint64_t Timer::read_high_resolution_us(void)
+{
+    std::chrono::microseconds total = _elapsed;
+
+    if (_running) {
+        total += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+    }
+    return total.count();
+}
+
+void Ticker::attach_us(Callback<void()> func, uint64_t t_us)
+{
+    detach();
+
+    _func = func;
+    _period = std::chrono::microseconds(t_us);
+    _running = true;
+    _thread = std::thread(&Ticker::run, this);
+}
+
+void Ticker::detach(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _cond.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void Ticker::run(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto next = std::chrono::steady_clock::now() + _period;
+
+    while (_running) {
+        if (_cond.wait_until(lock, next, [this]() { return !_running; })) {
+            break;
+        }
+        lock.unlock();
+        _func();
+        lock.lock();
+        next += _period;
+    }
+}
+
+} // namespace mbed
+
+/* rtos -------------------------------------------------------------------- */
+namespace rtos {
+
+Thread::Thread(osPriority priority, uint32_t stack_size, unsigned char *stack_mem, const char *name)
+    : _priority(priority), _stack_size(stack_size), _name(name), _started(false)
+{
+}
+
+Thread::~Thread()
+{
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        std::vector<const Thread *> &threads = registry();
+        threads.erase(std::remove(threads.begin(), threads.end(), this), threads.end());
+    }
+
+    // an Mbed thread is terminated here, a host thread can only be let go
+    if (_thread.joinable()) {
+        _thread.detach();
+    }
+}
+
+osStatus Thread::start(mbed::Callback<void()> task)
+{
+    if (_started) {
+        return osErrorParameter;
+    }
+    _started = true;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry().push_back(this);
+    }
+
+    _thread = std::thread([this, task]() {
+        current_flags = &_flags;
+        task();
+    });
+
+    if (_name) {
+        char name[16];
+        snprintf(name, sizeof(name), "%s", _name);
+        pthread_setname_np(_thread.native_handle(), name);
+    }
+
+    return osOK;
+}
+
+osStatus Thread::join(void)
+{
+    if (!_thread.joinable()) {
+        return osErrorResource;
+    }
+    _thread.join();
+    return osOK;
+}
+
+uint32_t Thread::flags_set(uint32_t flags)
+{
+    uint32_t ret;
+
+    {
+        std::lock_guard<std::mutex> lock(_flags.mutex);
+        _flags.flags |= flags;
+        ret = _flags.flags;
+    }
+    _flags.cond.notify_all();
+
+    return ret;
+}
+
+void ThisThread::sleep_for(uint32_t millisec)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(millisec));
+}
+
+void ThisThread::yield(void)
+{
+    std::this_thread::yield();
+}
+
+uint32_t ThisThread::flags_get(void)
+{
+    ThreadFlags &tf = this_thread_flags();
+    std::lock_guard<std::mutex> lock(tf.mutex);
+
+    return tf.flags;
+}
+
+uint32_t ThisThread::flags_clear(uint32_t flags)
+{
+    ThreadFlags &tf = this_thread_flags();
+    std::lock_guard<std::mutex> lock(tf.mutex);
+
+    uint32_t ret = tf.flags;
+    tf.flags &= ~flags;
+    return ret;
+}
+
+uint32_t ThisThread::flags_wait_any(uint32_t flags, bool clear)
+{
+    return wait_flags(flags, false, clear);
+}
+
+uint32_t ThisThread::flags_wait_all(uint32_t flags, bool clear)
+{
+    return wait_flags(flags, true, clear);
+}
+
+void thread_for_each(thread_visitor_t visitor, void *arg)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    for (const Thread *thread : registry()) {
+        visitor(thread, arg);
+    }
+}
+
+} // namespace rtos
+
+/* events ------------------------------------------------------------------ */
+namespace events {
+
+int EventQueue::post(std::function<void()> event)
+{
+    int id;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _events.push_back(event);
+        id = _next_id++;
+    }
+    _cond.notify_one();
+
+    return id;
+}
+
+void EventQueue::dispatch(int ms)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms < 0 ? 0 : ms);
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    _break = false;
+    while (!_break) {
+        if (_events.empty()) {
+            if (ms < 0) {
+                _cond.wait(lock);
+            }
+            else if (_cond.wait_until(lock, deadline) == std::cv_status::timeout) {
+                break;
+            }
+            continue;
+        }
+
+        std::function<void()> event = std::move(_events.front());
+        _events.pop_front();
+        lock.unlock();
+        event();
+        lock.lock();
+    }
+}
+
+void EventQueue::break_dispatch(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _break = true;
+    }
+    _cond.notify_all();
+}
+
+} // namespace events
+
+#endif // __linux__
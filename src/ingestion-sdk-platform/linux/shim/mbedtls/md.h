@@ -0,0 +1,88 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * The subset of the Mbed TLS message digest API that ei_mbedtls_md.h builds
+ * on (it carries its own SHA256), so the Linux target needs no Mbed TLS install
+ */
+
+#ifndef EI_LINUX_MBEDTLS_MD_H
+#define EI_LINUX_MBEDTLS_MD_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stddef.h>
+#include <stdlib.h>
+#include "mbedtls/platform_util.h"
+
+/* Constants --------------------------------------------------------------- */
+#define MBEDTLS_MD_C
+
+#define MBEDTLS_ERR_MD_FEATURE_UNAVAILABLE      -0x5080
+#define MBEDTLS_ERR_MD_BAD_INPUT_DATA           -0x5100
+#define MBEDTLS_ERR_MD_ALLOC_FAILED             -0x5180
+
+#define MBEDTLS_MD_MAX_SIZE                     32
+#define MBEDTLS_MD_MAX_BLOCK_SIZE               64
+
+#define mbedtls_calloc                          calloc
+#define mbedtls_free                            free
+
+/* Types ------------------------------------------------------------------- */
+typedef enum {
+    MBEDTLS_MD_NONE = 0,
+    MBEDTLS_MD_MD2,
+    MBEDTLS_MD_MD4,
+    MBEDTLS_MD_MD5,
+    MBEDTLS_MD_SHA1,
+    MBEDTLS_MD_SHA224,
+    MBEDTLS_MD_SHA256,
+    MBEDTLS_MD_SHA384,
+    MBEDTLS_MD_SHA512,
+    MBEDTLS_MD_RIPEMD160,
+} mbedtls_md_type_t;
+
+typedef struct mbedtls_md_info_t mbedtls_md_info_t;
+
+typedef struct mbedtls_md_context_t {
+    const mbedtls_md_info_t *md_info;
+    void *md_ctx;
+    void *hmac_ctx;
+} mbedtls_md_context_t;
+
+/* Function prototypes ----------------------------------------------------- */
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t md_type);
+void mbedtls_md_init(mbedtls_md_context_t *ctx);
+void mbedtls_md_free(mbedtls_md_context_t *ctx);
+
+#endif /* EI_LINUX_MBEDTLS_MD_H */
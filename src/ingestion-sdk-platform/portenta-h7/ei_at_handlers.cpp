@@ -37,11 +37,14 @@
 #include "firmware-sdk/ei_device_interface.h"
 #include "firmware-sdk/at_base64_lib.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 #include "firmware-sdk/at-server/ei_at_command_set.h"
 #include "firmware-sdk/at-server/ei_at_server.h"
 #include "firmware-sdk/ei_fusion.h"
 #include "firmware-sdk/ei_image_lib.h"
+#include "firmware-sdk/ei_telemetry.h"
 #include "ei_run_impulse.h"
+#include "ei_kernel_benchmark.h"
 #include "sensors/ei_camera.h"
 #include "model-parameters/model_metadata.h"
 #include <string>
@@ -50,6 +53,8 @@ using namespace std;
 EiDevicePortenta* dev;
 
 #define TRANSFER_BUF_LEN 32
+// containers are up to EI_MODEL_STORE_SLOT_SIZE, bigger chunks keep the upload short
+#define MODEL_TRANSFER_BUF_LEN 256
 
 /* Private function declarations ------------------------------------------- */
 static inline bool check_args_num(const int &required, const int &received);
@@ -71,7 +76,21 @@ static bool at_sample_start(const char **argv, const int argc);
 static bool at_run_impulse(void);
 static bool at_run_impulse_debug(const char **argv, const int argc);
 static bool at_run_impulse_cont(void);
+static bool at_run_impulse_cont_format(const char **argv, const int argc);
+static bool at_run_impulse_multi(void);
 static bool at_run_impulse_static_data(const char **argv, const int argc);
+static bool at_get_arena(void);
+static bool at_fusion_stats(void);
+static bool at_stats(void);
+static bool at_get_stats(void);
+static bool at_set_stats(const char **argv, const int argc);
+static bool at_profile(void);
+static bool at_set_profile(const char **argv, const int argc);
+static bool at_bench_kernels(void);
+static bool at_bench_kernels_model(const char **argv, const int argc);
+static bool at_model(void);
+static bool at_model_upload(const char **argv, const int argc);
+static bool at_model_rollback(void);
 static bool at_get_snapshot(void);
 static bool at_take_snapshot(const char **argv, const int argc);
 static bool at_snapshot_stream(const char **argv, const int argc);
@@ -173,6 +192,13 @@ ATServer *ei_at_init(EiDevicePortenta* device)
         AT_RUNIMPULSECONT_HELP_TEXT,
         at_run_impulse_cont,
         nullptr,
+        at_run_impulse_cont_format,
+        AT_RUNIMPULSECONT_ARGS);
+    at->register_command(
+        AT_RUNIMPULSEMULTI,
+        AT_RUNIMPULSEMULTI_HELP_TEXT,
+        at_run_impulse_multi,
+        nullptr,
         nullptr,
         nullptr);
     at->register_command(
@@ -182,6 +208,62 @@ ATServer *ei_at_init(EiDevicePortenta* device)
         nullptr,
         at_run_impulse_static_data,
         AT_RUNIMPULSESTATIC_ARGS);
+    at->register_command(
+        AT_ARENA,
+        AT_ARENA_HELP_TEXT,
+        nullptr,
+        at_get_arena,
+        nullptr,
+        nullptr);
+    at->register_command(
+        AT_FUSIONSTATS,
+        AT_FUSIONSTATS_HELP_TEXT,
+        at_fusion_stats,
+        at_fusion_stats,
+        nullptr,
+        nullptr);
+    at->register_command(
+        AT_STATS,
+        AT_STATS_HELP_TEXT,
+        at_stats,
+        at_get_stats,
+        at_set_stats,
+        AT_STATS_ARGS);
+    at->register_command(
+        AT_PROFILE,
+        AT_PROFILE_HELP_TEXT,
+        at_profile,
+        nullptr,
+        at_set_profile,
+        AT_PROFILE_ARGS);
+    at->register_command(
+        AT_BENCHKERNELS,
+        AT_BENCHKERNELS_HELP_TEXT,
+        at_bench_kernels,
+        nullptr,
+        at_bench_kernels_model,
+        AT_BENCHKERNELS_ARGS);
+    at->register_command(
+        AT_MODEL,
+        AT_MODEL_HELP_TEXT,
+        at_model,
+        at_model,
+        nullptr,
+        nullptr);
+    at->register_command(
+        AT_MODELUPLOAD,
+        AT_MODELUPLOAD_HELP_TEXT,
+        nullptr,
+        nullptr,
+        at_model_upload,
+        AT_MODELUPLOAD_ARGS);
+    at->register_command(
+        AT_MODELROLLBACK,
+        AT_MODELROLLBACK_HELP_TEXT,
+        at_model_rollback,
+        nullptr,
+        nullptr,
+        nullptr);
     at->register_command(
         AT_SNAPSHOT,
         AT_SNAPSHOT_HELP_TEXT,
@@ -518,6 +600,149 @@ static bool at_run_impulse(void)
     return true;
 }
 
+static bool at_get_arena(void)
+{
+    run_nn_arena_print();
+
+    return true;
+}
+
+static bool at_fusion_stats(void)
+{
+    ei_fusion_stats_t stats;
+    ei_fusion_get_stats(&stats);
+
+    ei_printf("Fusion sampling (last run):\n");
+    ei_printf("    Frames: %lu, delivered: %lu, overruns: %lu, max pending: %lu\n",
+        (unsigned long)stats.frames, (unsigned long)stats.delivered,
+        (unsigned long)stats.overruns, (unsigned long)stats.max_pending);
+    if (stats.frames > 1) {
+        ei_printf("    Tick interval: %lu - %lu us, jitter: max %lu us, mean %lu us\n",
+            (unsigned long)stats.interval_min_us, (unsigned long)stats.interval_max_us,
+            (unsigned long)stats.jitter_max_us,
+            (unsigned long)(stats.jitter_sum_us / (stats.frames - 1)));
+    }
+
+    return true;
+}
+
+static bool at_stats(void)
+{
+    ei_telemetry_print();
+
+    return true;
+}
+
+static bool at_get_stats(void)
+{
+    ei_telemetry_print_json();
+
+    return true;
+}
+
+static bool at_set_stats(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    if (strcmp(argv[0], "RESET") == 0) {
+        ei_telemetry_reset();
+        ei_printf("OK\n");
+    }
+    else if (strcmp(argv[0], "JSON") == 0) {
+        ei_telemetry_print_json();
+    }
+    else {
+        ei_printf("Unknown argument '%s', use RESET or JSON\n", argv[0]);
+        return false;
+    }
+
+    return true;
+}
+
+static bool at_profile(void)
+{
+#if EI_PROFILER == 1
+    ei::profiler::report(true);
+#else
+    ei_printf("Profiler not compiled in, build with EI_PROFILER=1\n");
+#endif
+
+    return true;
+}
+
+static bool at_set_profile(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    if (strcmp(argv[0], "RESET") == 0) {
+        ei::profiler::reset();
+        ei_printf("OK\n");
+    }
+    else if (strcmp(argv[0], "FLAT") == 0 || strcmp(argv[0], "TREE") == 0) {
+#if EI_PROFILER == 1
+        ei::profiler::report(argv[0][0] == 'T');
+#else
+        ei_printf("Profiler not compiled in, build with EI_PROFILER=1\n");
+#endif
+    }
+    else {
+        ei_printf("Unknown argument '%s', use TREE, FLAT or RESET\n", argv[0]);
+        return false;
+    }
+
+    return true;
+}
+
+static bool at_bench_kernels(void)
+{
+    ei_kernel_benchmark_run(false);
+
+    return true;
+}
+
+static bool at_bench_kernels_model(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    if (strcmp(argv[0], "MODELONLY") != 0) {
+        ei_printf("Unknown argument '%s', use MODELONLY\n", argv[0]);
+        return false;
+    }
+
+    ei_kernel_benchmark_run(true);
+
+    return true;
+}
+
+static bool at_model(void)
+{
+    run_nn_model_info();
+
+    return true;
+}
+
+static bool at_model_upload(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    size_t length = (size_t)atoi(argv[0]);
+
+    return run_nn_model_upload(length, MODEL_TRANSFER_BUF_LEN);
+}
+
+static bool at_model_rollback(void)
+{
+    return run_nn_model_rollback();
+}
+
 static bool at_run_impulse_debug(const char **argv, const int argc)
 {
     bool use_max_uart_speed = false;
@@ -537,6 +762,33 @@ static bool at_run_impulse_cont(void)
     return true;
 }
 
+static bool at_run_impulse_cont_format(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    if (strcmp(argv[0], "TEXT") == 0) {
+        run_nn_continuous_normal();
+    }
+    else if (strcmp(argv[0], "BINARY") == 0) {
+        run_nn_continuous_binary();
+    }
+    else {
+        ei_printf("Unknown argument '%s', use TEXT or BINARY\n", argv[0]);
+        return false;
+    }
+
+    return true;
+}
+
+static bool at_run_impulse_multi(void)
+{
+    run_nn_multi_normal();
+
+    return true;
+}
+
 static bool at_run_impulse_static_data(const char **argv, const int argc)
 {
 
@@ -716,25 +968,26 @@ static bool at_get_config(void)
 
 static bool at_clear_fs(void)
 {
-
+    return true;
 }
 
 static bool at_reset(void)
 {
     NVIC_SystemReset();
+    return true;
 }
 
 static bool at_scan_wifi(void)
 {
-
+    return true;
 }
 
 static bool at_get_wifi(void)
 {
-
+    return true;
 }
 
 static bool at_set_wifi(const char **argv, const int argc)
 {
-
+    return true;
 }
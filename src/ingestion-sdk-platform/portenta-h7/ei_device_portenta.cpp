@@ -43,6 +43,7 @@
 #include <USB/PluggableUSBSerial.h> // for _SerialUSB
 #include "mbed.h"
 #include "ei_flash_portenta.h"
+#include "firmware-sdk/ei_serial_tx.h"
 #include "sensors/ei_camera.h"
 #include "sensors/ei_microphone.h"
 
@@ -79,7 +80,27 @@ const ei_device_data_output_baudrate_t ei_dev_default_data_output_baudrate = {
     115200,
 };
 
+/** Serial output drain thread, above the AT server so USB transfers start while it computes */
+#define SERIAL_TX_FLAG_DATA     (1 << 0)
+static unsigned char serial_tx_thread_stack[2 * 1024];
+static rtos::Thread serial_tx_thread(osPriorityAboveNormal1, sizeof(serial_tx_thread_stack), serial_tx_thread_stack, "serial-tx-thread");
+static rtos::Mutex serial_tx_mutex;
+
 /* Private function declarations ------------------------------------------- */
+static size_t serial_tx_write(const uint8_t *data, size_t length);
+static void serial_tx_lock(void);
+static void serial_tx_unlock(void);
+static void serial_tx_wake(void);
+static void serial_tx_wait(void);
+static void serial_tx_drain_thread(void);
+
+static const ei_serial_tx_port_t serial_tx_port = {
+    serial_tx_write,
+    serial_tx_lock,
+    serial_tx_unlock,
+    serial_tx_wake,
+    serial_tx_wait,
+};
 
 /* Public functions -------------------------------------------------------- */
 
@@ -313,9 +334,37 @@ bool ei_user_invoke_stop(void) {
  * @param[in]  length  The length
  */
 void ei_write_string(char *data, int length) {
-    while (length--) {
-        Serial.write(*(data++));
-    }
+    ei_serial_tx_write(data, length);
+}
+
+/**
+ * @brief      Route all serial output through the buffered output channel
+ *             and start its drain thread
+ */
+void ei_serial_tx_setup(void)
+{
+    ei_serial_tx_init(&serial_tx_port);
+    serial_tx_thread.start(mbed::callback(serial_tx_drain_thread));
+    ei_serial_tx_start();
+}
+
+void ei_putchar(char c)
+{
+    ei_serial_tx_write(&c, 1);
+}
+
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    ei_serial_tx_vprintf(format, args);
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    String s(f, 6);
+    ei_serial_tx_write(s.c_str(), s.length());
 }
 
 /**
@@ -371,3 +420,36 @@ void ei_print_memory_info2(void)
     ei_printf("Heap size: %lu / %lu bytes (max: %lu)\r\n", heap_stats.current_size, heap_stats.reserved_size, heap_stats.max_size);
 }
 /* Private functions ------------------------------------------------------- */
+static size_t serial_tx_write(const uint8_t *data, size_t length)
+{
+    return Serial.write(data, length);
+}
+
+static void serial_tx_lock(void)
+{
+    serial_tx_mutex.lock();
+}
+
+static void serial_tx_unlock(void)
+{
+    serial_tx_mutex.unlock();
+}
+
+static void serial_tx_wake(void)
+{
+    serial_tx_thread.flags_set(SERIAL_TX_FLAG_DATA);
+}
+
+static void serial_tx_wait(void)
+{
+    rtos::ThisThread::sleep_for(1);
+}
+
+static void serial_tx_drain_thread(void)
+{
+    while (1) {
+        while (ei_serial_tx_drain() > 0) {
+        }
+        rtos::ThisThread::flags_wait_any(SERIAL_TX_FLAG_DATA);
+    }
+}
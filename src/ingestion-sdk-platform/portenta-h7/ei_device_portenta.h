@@ -79,6 +79,7 @@ public:
 
 /* Function prototypes ----------------------------------------------------- */
 void ei_write_string(char *data, int length);
+void ei_serial_tx_setup(void);
 bool ei_user_invoke_stop(void);
 void ei_print_memory_info2(void);
 
@@ -0,0 +1,107 @@
+/*
+ * Generated by firmware-sdk/tools/static_impulse_tables.cpp from model_variables.h
+ * (./linux-build.sh --static-impulse-tables), do not edit.
+ */
+
+#ifndef _EI_CLASSIFIER_MODEL_STATIC_IMPULSE_H_
+#define _EI_CLASSIFIER_MODEL_STATIC_IMPULSE_H_
+
+/**
+ * @file
+ *  Tables and configs of the specialized DSP blocks (EI_CLASSIFIER_STATIC_IMPULSE),
+ *  included by model_variables.h.
+ */
+
+#include <stdint.h>
+#include "edge-impulse-sdk/classifier/ei_static_impulse.h"
+
+const uint16_t ei_dsp_static_44_12_mel_bins[34] = {
+    0, 0, 1, 2, 4, 5, 6, 7, 9, 11, 12, 14, 16, 19, 21, 24,
+    26, 29, 33, 36, 40, 44, 49, 53, 59, 64, 70, 77, 84, 91, 99, 108,
+    118, 128
+};
+const float ei_dsp_static_44_12_mel_weights[183] = {
+    0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f,
+    0.5f, 0.5f, 0.6666667f, 0.33333334f, 0.33333334f, 0.6666667f, 0.5f, 0.5f,
+    0.6666667f, 0.33333334f, 0.33333334f, 0.6666667f, 0.5f, 0.5f, 0.6666667f, 0.33333334f,
+    0.33333334f, 0.6666667f, 0.75f, 0.5f, 0.25f, 0.25f, 0.5f, 0.75f,
+    0.6666667f, 0.33333334f, 0.33333334f, 0.6666667f, 0.75f, 0.5f, 0.25f, 0.25f,
+    0.5f, 0.75f, 0.75f, 0.5f, 0.25f, 0.25f, 0.5f, 0.75f,
+    0.8f, 0.6f, 0.4f, 0.2f, 0.2f, 0.4f, 0.6f, 0.8f,
+    0.75f, 0.5f, 0.25f, 0.25f, 0.5f, 0.75f, 0.8333333f, 0.6666667f,
+    0.5f, 0.33333334f, 0.16666667f, 0.16666667f, 0.33333334f, 0.5f, 0.6666667f, 0.8333333f,
+    0.8f, 0.6f, 0.4f, 0.2f, 0.2f, 0.4f, 0.6f, 0.8f,
+    0.8333333f, 0.6666667f, 0.5f, 0.33333334f, 0.16666667f, 0.16666667f, 0.33333334f, 0.5f,
+    0.6666667f, 0.8333333f, 0.85714287f, 0.71428573f, 0.5714286f, 0.42857143f, 0.2857143f, 0.14285715f,
+    0.14285715f, 0.2857143f, 0.42857143f, 0.5714286f, 0.71428573f, 0.85714287f, 0.85714287f, 0.71428573f,
+    0.5714286f, 0.42857143f, 0.2857143f, 0.14285715f, 0.14285715f, 0.2857143f, 0.42857143f, 0.5714286f,
+    0.71428573f, 0.85714287f, 0.85714287f, 0.71428573f, 0.5714286f, 0.42857143f, 0.2857143f, 0.14285715f,
+    0.14285715f, 0.2857143f, 0.42857143f, 0.5714286f, 0.71428573f, 0.85714287f, 0.875f, 0.75f,
+    0.625f, 0.5f, 0.375f, 0.25f, 0.125f, 0.125f, 0.25f, 0.375f,
+    0.5f, 0.625f, 0.75f, 0.875f, 0.8888889f, 0.7777778f, 0.6666667f, 0.5555556f,
+    0.44444445f, 0.33333334f, 0.22222222f, 0.11111111f, 0.11111111f, 0.22222222f, 0.33333334f, 0.44444445f,
+    0.5555556f, 0.6666667f, 0.7777778f, 0.8888889f, 0.9f, 0.8f, 0.7f, 0.6f,
+    0.5f, 0.4f, 0.3f, 0.2f, 0.1f, 0.1f, 0.2f, 0.3f,
+    0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 0.9f, 0.8f,
+    0.7f, 0.6f, 0.5f, 0.4f, 0.3f, 0.2f, 0.1f
+};
+const float ei_dsp_static_44_12_dct_basis[416] = {
+    0.17677669f, 0.24969886f, 0.24879618f, 0.24729413f, 0.24519631f, 0.24250782f, 0.23923509f, 0.23538601f, 0.23096988f, 0.22599733f, 0.22048032f, 0.21443215f, 0.2078674f,
+    0.17677669f, 0.24729413f, 0.23923509f, 0.22599733f, 0.2078674f, 0.18523778f, 0.15859832f, 0.12852569f, 0.09567086f, 0.060745046f, 0.024504285f, -0.012266919f, -0.04877258f,
+    0.17677669f, 0.24250782f, 0.22048032f, 0.18523778f, 0.13889256f, 0.084222466f, 0.024504285f, -0.036682617f, -0.09567086f, -0.14892483f, -0.19325261f, -0.22599733f, -0.24519631f,
+    0.17677669f, 0.23538601f, 0.19325261f, 0.12852569f, 0.04877258f, -0.036682617f, -0.117849186f, -0.18523778f, -0.23096988f, -0.24969886f, -0.23923509f, -0.20080188f, -0.13889256f,
+    0.17677669f, 0.22599733f, 0.15859832f, 0.060745046f, -0.04877258f, -0.14892483f, -0.22048032f, -0.24969886f, -0.23096988f, -0.16788974f, -0.072571166f, 0.036682617f, 0.13889256f,
+    0.17677669f, 0.21443215f, 0.117849186f, -0.012266919f, -0.13889256f, -0.22599733f, -0.24879618f, -0.20080188f, -0.09567086f, 0.036682617f, 0.15859832f, 0.23538601f, 0.24519631f,
+    0.17677669f, 0.20080188f, 0.072571166f, -0.084222466f, -0.2078674f, -0.24969886f, -0.19325261f, -0.060745046f, 0.09567086f, 0.21443215f, 0.24879618f, 0.18523778f, 0.04877258f,
+    0.17677669f, 0.18523778f, 0.024504285f, -0.14892483f, -0.24519631f, -0.21443215f, -0.072571166f, 0.10688877f, 0.23096988f, 0.23538601f, 0.117849186f, -0.060745046f, -0.2078674f,
+    0.17677669f, 0.16788974f, -0.024504285f, -0.20080188f, -0.24519631f, -0.12852569f, 0.072571166f, 0.22599733f, 0.23096988f, 0.084222466f, -0.117849186f, -0.24250782f, -0.2078674f,
+    0.17677669f, 0.14892483f, -0.072571166f, -0.23538601f, -0.2078674f, -0.012266919f, 0.19325261f, 0.24250782f, 0.09567086f, -0.12852569f, -0.24879618f, -0.16788974f, 0.04877258f,
+    0.17677669f, 0.12852569f, -0.117849186f, -0.24969886f, -0.13889256f, 0.10688877f, 0.24879618f, 0.14892483f, -0.09567086f, -0.24729413f, -0.15859832f, 0.084222466f, 0.24519631f,
+    0.17677669f, 0.10688877f, -0.15859832f, -0.24250782f, -0.04877258f, 0.20080188f, 0.22048032f, -0.012266919f, -0.23096988f, -0.18523778f, 0.072571166f, 0.24729413f, 0.13889256f,
+    0.17677669f, 0.084222466f, -0.19325261f, -0.21443215f, 0.04877258f, 0.24729413f, 0.117849186f, -0.16788974f, -0.23096988f, 0.012266919f, 0.23923509f, 0.14892483f, -0.13889256f,
+    0.17677669f, 0.060745046f, -0.22048032f, -0.16788974f, 0.13889256f, 0.23538601f, -0.024504285f, -0.24729413f, -0.09567086f, 0.20080188f, 0.19325261f, -0.10688877f, -0.24519631f,
+    0.17677669f, 0.036682617f, -0.23923509f, -0.10688877f, 0.2078674f, 0.16788974f, -0.15859832f, -0.21443215f, 0.09567086f, 0.24250782f, -0.024504285f, -0.24969886f, -0.04877258f,
+    0.17677669f, 0.012266919f, -0.24879618f, -0.036682617f, 0.24519631f, 0.060745046f, -0.23923509f, -0.084222466f, 0.23096988f, 0.10688877f, -0.22048032f, -0.12852569f, 0.2078674f,
+    0.17677669f, -0.012266919f, -0.24879618f, 0.036682617f, 0.24519631f, -0.060745046f, -0.23923509f, 0.084222466f, 0.23096988f, -0.10688877f, -0.22048032f, 0.12852569f, 0.2078674f,
+    0.17677669f, -0.036682617f, -0.23923509f, 0.10688877f, 0.2078674f, -0.16788974f, -0.15859832f, 0.21443215f, 0.09567086f, -0.24250782f, -0.024504285f, 0.24969886f, -0.04877258f,
+    0.17677669f, -0.060745046f, -0.22048032f, 0.16788974f, 0.13889256f, -0.23538601f, -0.024504285f, 0.24729413f, -0.09567086f, -0.20080188f, 0.19325261f, 0.10688877f, -0.24519631f,
+    0.17677669f, -0.084222466f, -0.19325261f, 0.21443215f, 0.04877258f, -0.24729413f, 0.117849186f, 0.16788974f, -0.23096988f, -0.012266919f, 0.23923509f, -0.14892483f, -0.13889256f,
+    0.17677669f, -0.10688877f, -0.15859832f, 0.24250782f, -0.04877258f, -0.20080188f, 0.22048032f, 0.012266919f, -0.23096988f, 0.18523778f, 0.072571166f, -0.24729413f, 0.13889256f,
+    0.17677669f, -0.12852569f, -0.117849186f, 0.24969886f, -0.13889256f, -0.10688877f, 0.24879618f, -0.14892483f, -0.09567086f, 0.24729413f, -0.15859832f, -0.084222466f, 0.24519631f,
+    0.17677669f, -0.14892483f, -0.072571166f, 0.23538601f, -0.2078674f, 0.012266919f, 0.19325261f, -0.24250782f, 0.09567086f, 0.12852569f, -0.24879618f, 0.16788974f, 0.04877258f,
+    0.17677669f, -0.16788974f, -0.024504285f, 0.20080188f, -0.24519631f, 0.12852569f, 0.072571166f, -0.22599733f, 0.23096988f, -0.084222466f, -0.117849186f, 0.24250782f, -0.2078674f,
+    0.17677669f, -0.18523778f, 0.024504285f, 0.14892483f, -0.24519631f, 0.21443215f, -0.072571166f, -0.10688877f, 0.23096988f, -0.23538601f, 0.117849186f, 0.060745046f, -0.2078674f,
+    0.17677669f, -0.20080188f, 0.072571166f, 0.084222466f, -0.2078674f, 0.24969886f, -0.19325261f, 0.060745046f, 0.09567086f, -0.21443215f, 0.24879618f, -0.18523778f, 0.04877258f,
+    0.17677669f, -0.21443215f, 0.117849186f, 0.012266919f, -0.13889256f, 0.22599733f, -0.24879618f, 0.20080188f, -0.09567086f, -0.036682617f, 0.15859832f, -0.23538601f, 0.24519631f,
+    0.17677669f, -0.22599733f, 0.15859832f, -0.060745046f, -0.04877258f, 0.14892483f, -0.22048032f, 0.24969886f, -0.23096988f, 0.16788974f, -0.072571166f, -0.036682617f, 0.13889256f,
+    0.17677669f, -0.23538601f, 0.19325261f, -0.12852569f, 0.04877258f, 0.036682617f, -0.117849186f, 0.18523778f, -0.23096988f, 0.24969886f, -0.23923509f, 0.20080188f, -0.13889256f,
+    0.17677669f, -0.24250782f, 0.22048032f, -0.18523778f, 0.13889256f, -0.084222466f, 0.024504285f, 0.036682617f, -0.09567086f, 0.14892483f, -0.19325261f, 0.22599733f, -0.24519631f,
+    0.17677669f, -0.24729413f, 0.23923509f, -0.22599733f, 0.2078674f, -0.18523778f, 0.15859832f, -0.12852569f, 0.09567086f, -0.060745046f, 0.024504285f, 0.012266919f, -0.04877258f,
+    0.17677669f, -0.24969886f, 0.24879618f, -0.24729413f, 0.24519631f, -0.24250782f, 0.23923509f, -0.23538601f, 0.23096988f, -0.22599733f, 0.22048032f, -0.21443215f, 0.2078674f
+};
+
+struct ei_dsp_static_config_44_12 {
+    static constexpr uint32_t frequency = 16000;
+    static constexpr float frame_length = 0.02f;
+    static constexpr float frame_stride = 0.02f;
+    static constexpr uint16_t frame_length_samples = 320;
+    static constexpr uint16_t max_frames = 50;
+    static constexpr uint16_t num_cepstral = 13;
+    static constexpr uint16_t num_filters = 32;
+    static constexpr uint16_t fft_length = 256;
+    static constexpr uint16_t win_size = 101;
+    static constexpr float pre_cof = 0.98f;
+    static constexpr int pre_shift = 1;
+    static constexpr int implementation_version = 4;
+    static constexpr const uint16_t *mel_bins = ei_dsp_static_44_12_mel_bins;
+    static constexpr const float *mel_weights = ei_dsp_static_44_12_mel_weights;
+    static constexpr const float *dct_basis = ei_dsp_static_44_12_dct_basis;
+};
+typedef ei::static_impulse::mfcc<ei_dsp_static_config_44_12> ei_dsp_static_44_12;
+
+const ei_static_dsp_fns_t ei_static_dsp_fns_44_1[] = {
+    EI_STATIC_DSP_MFCC_FNS(ei_dsp_static_44_12),
+};
+const size_t ei_static_dsp_fns_44_1_size = 1;
+
+#endif // _EI_CLASSIFIER_MODEL_STATIC_IMPULSE_H_
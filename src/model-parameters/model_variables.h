@@ -45,6 +45,7 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/engines.h"
 #include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+#include "edge-impulse-sdk/classifier/ei_static_impulse.h"
 
 const char* ei_classifier_inferencing_categories_44_1[] = { "helloworld", "noise", "unknown" };
 
@@ -68,12 +69,20 @@ ei_dsp_config_mfcc_t ei_dsp_config_44_12 = {
     1 // int pre_shift
 };
 
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+#include "model_static_impulse.h"
+#endif // EI_CLASSIFIER_STATIC_IMPULSE == 1
+
 const uint8_t ei_dsp_blocks_44_1_size = 1;
 ei_model_dsp_t ei_dsp_blocks_44_1[ei_dsp_blocks_44_1_size] = {
     { // DSP block 12
         12,
         650, // output size
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+        &ei_dsp_static_44_12::extract, // DSP function pointer (specialized)
+#else
         &extract_mfcc_features, // DSP function pointer
+#endif
         (void*)&ei_dsp_config_44_12, // pointer to config struct
         ei_dsp_config_44_12_axes, // array of offsets into the input stream, one for each axis
         ei_dsp_config_44_12_axes_size, // number of axes
@@ -191,4 +200,8 @@ ei_impulse_handle_t& ei_default_impulse = impulse_handle_44_1;
 constexpr auto& ei_classifier_inferencing_categories = ei_classifier_inferencing_categories_44_1;
 const auto ei_dsp_blocks_size = ei_dsp_blocks_44_1_size;
 ei_model_dsp_t *ei_dsp_blocks = ei_dsp_blocks_44_1;
+#if EI_CLASSIFIER_STATIC_IMPULSE == 1
+constexpr auto& ei_static_dsp_fns = ei_static_dsp_fns_44_1;
+const auto ei_static_dsp_fns_size = ei_static_dsp_fns_44_1_size;
+#endif // EI_CLASSIFIER_STATIC_IMPULSE == 1
 #endif // _EI_CLASSIFIER_MODEL_VARIABLES_H_
@@ -42,6 +42,7 @@
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #include "ei_device_portenta.h"
 #include "ei_flash_portenta.h"
+#include "firmware-sdk/ei_telemetry.h"
 
 #define AUDIO_SAMPLING_FREQUENCY            16000
 
@@ -163,7 +164,10 @@ static void pdm_data_ready_inference_callback(void)
     // ei_printf("available: %d %d\r\n", bytesAvailable, bytesRead);
 
     if(record_ready == true) {
-        mic_queue.call(&audio_buffer_inference_callback, bytesRead);
+        // queue full, the block is lost
+        if (mic_queue.call(&audio_buffer_inference_callback, bytesRead) == 0) {
+            ei_telemetry_count(EI_TELEMETRY_AUDIO_OVERRUNS);
+        }
     }
 }
 
@@ -257,7 +261,7 @@ static bool create_header(void)
     int ref_size = insert_ref(((char*)ei_mic_ctx.cbor_buffer.ptr + end_of_header_ix), end_of_header_ix);
 
     // and update the signature
-    tr = ei_mic_ctx.signature_ctx->update(ei_mic_ctx.signature_ctx, (uint8_t*)(ei_mic_ctx.cbor_buffer.ptr + end_of_header_ix), ref_size);
+    tr = ei_mic_ctx.signature_ctx->update(ei_mic_ctx.signature_ctx, ((uint8_t*)ei_mic_ctx.cbor_buffer.ptr + end_of_header_ix), ref_size);
     if (tr != 0) {
         ei_printf("ERR: Failed to update signature from header (%d)\n", tr);
         return false;
@@ -327,12 +331,14 @@ bool ei_microphone_inference_start(uint32_t n_samples)
     inference.buffers[0] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
 
     if(inference.buffers[0] == NULL) {
+        ei_telemetry_count(EI_TELEMETRY_ALLOC_FAILURES);
         return false;
     }
 
     inference.buffers[1] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
 
     if(inference.buffers[1] == NULL) {
+        ei_telemetry_count(EI_TELEMETRY_ALLOC_FAILURES);
         ei_free(inference.buffers[0]);
         return false;
     }
@@ -386,6 +392,7 @@ bool ei_microphone_inference_record(void)
         ei_printf(
             "Error sample buffer overrun. Decrease the number of slices per model window "
             "(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)\n");
+        ei_telemetry_count(EI_TELEMETRY_AUDIO_OVERRUNS);
         ret = false;
     }
 
@@ -398,6 +405,14 @@ bool ei_microphone_inference_record(void)
     return ret;
 }
 
+/**
+ * @brief      Is the next slice already complete (i.e. ei_microphone_inference_record() won't wait)
+ */
+bool ei_microphone_inference_slice_ready(void)
+{
+    return inference.buf_ready == 1;
+}
+
 /**
  * @brief      Reset buffer counters for non-continuous inferecing
  */
@@ -415,12 +430,22 @@ int ei_microphone_audio_signal_get_data(size_t offset, size_t length, float *out
     return numpy::int16_to_float(&inference.buffers[inference.buf_select ^ 1][offset], out_ptr, length);
 }
 
+/**
+ * Get the last recorded slice as raw int16 samples
+ */
+const int16_t *ei_microphone_inference_get_slice(size_t *n_samples)
+{
+    *n_samples = inference.n_samples;
+    return inference.buffers[inference.buf_select ^ 1];
+}
+
 
 bool ei_microphone_inference_end(void)
 {
     PDM.end();
     ei_free(inference.buffers[0]);
     ei_free(inference.buffers[1]);
+    return true;
 }
 
 /**
@@ -46,8 +46,10 @@ bool ei_microphone_inference_start(uint32_t n_samples);
 
 bool ei_microphone_sample_start(void);
 bool ei_microphone_inference_record(void);
+bool ei_microphone_inference_slice_ready(void);
 void ei_microphone_inference_reset_buffers(void);
 int ei_microphone_audio_signal_get_data(size_t offset, size_t length, float *out_ptr);
+const int16_t *ei_microphone_inference_get_slice(size_t *n_samples);
 bool ei_microphone_inference_end(void);
 
 
@@ -0,0 +1,86 @@
+import os
+import subprocess
+import tempfile
+import threading
+import time
+
+# Runs build-linux/firmware-linux with its serial port on stdin / stdout,
+# read() / write() follow pyserial so the tools in firmware-sdk/tools can use it
+
+FIRMWARE = os.environ.get("FIRMWARE", os.path.join(os.path.dirname(__file__), "..", "..", "build-linux", "firmware-linux"))
+TOOLS = os.path.join(os.path.dirname(__file__), "..", "..", "src", "firmware-sdk", "tools")
+PROMPT = b"\n> "
+
+class Firmware:
+    def __init__(self, *args, flash=None):
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.flash = flash or os.path.join(self.tempdir.name, "flash.bin")
+        self.proc = subprocess.Popen([FIRMWARE, "--flash", self.flash] + list(args),
+                                     stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+        self.buffer = bytearray()
+        self.cond = threading.Condition()
+        self.reader = threading.Thread(target=self._read_stdout, daemon=True)
+        self.reader.start()
+        self.boot = self.until(b"Type AT+HELP")
+        self.until(PROMPT)
+
+    def _read_stdout(self):
+        while True:
+            data = self.proc.stdout.read1(4096)
+            with self.cond:
+                if not data:
+                    self.cond.notify_all()
+                    return
+                self.buffer += data
+                self.cond.notify_all()
+
+    def read(self, size=1, timeout=0.1):
+        with self.cond:
+            if not self.buffer:
+                self.cond.wait(timeout)
+            data = bytes(self.buffer[:size])
+            del self.buffer[:size]
+            return data
+
+    def write(self, data):
+        self.proc.stdin.write(data)
+        self.proc.stdin.flush()
+
+    def until(self, token, timeout=30):
+        """Returns everything up to and including token"""
+        deadline = time.time() + timeout
+        with self.cond:
+            while token not in self.buffer:
+                left = deadline - time.time()
+                if left <= 0 or self.proc.poll() is not None:
+                    raise TimeoutError("no {!r} from the firmware, got {!r}".format(token, bytes(self.buffer[-200:])))
+                self.cond.wait(left)
+            end = self.buffer.index(token) + len(token)
+            data = bytes(self.buffer[:end])
+            del self.buffer[:end]
+            return data
+
+    def command(self, cmd, timeout=30):
+        """Sends an AT command, returns its output up to the next prompt"""
+        self.write((cmd + "\r").encode())
+        return self.until(PROMPT, timeout).decode("utf-8", "replace")
+
+    def close(self):
+        try:
+            self.proc.stdin.close()
+        except BrokenPipeError:
+            pass
+        try:
+            self.proc.wait(10)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+            self.proc.wait()
+        self.reader.join()
+        self.proc.stdout.close()
+        self.tempdir.cleanup()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
@@ -0,0 +1,64 @@
+import contextlib
+import io
+import json
+import os
+import sys
+import unittest
+
+from firmware import Firmware, TOOLS
+
+sys.path.insert(0, TOOLS)
+import model_container
+
+MODEL = os.path.join(os.path.dirname(__file__), "data", "kws.tflite")
+ARENA_SIZE = 60000
+# the EON tensor arena (tflite_learn_44_13_compiled.cpp), the input tensor is the last one in it
+EON_ARENA_SIZE = 2176
+EON_INPUT_END = 656 + 650
+
+class ArenaTest(unittest.TestCase):
+    """AT+ARENA? prints one JSON object per NN learn block"""
+
+    def arena(self, fw):
+        out = fw.command("AT+ARENA?")
+        reports = [json.loads(line) for line in out.splitlines() if line.startswith("{")]
+        self.assertEqual(len(reports), 1, out)
+        report = reports[0]
+        self.assertEqual(report["persistentBytes"] + report["nonPersistentBytes"] + report["headroomBytes"],
+                         report["arenaSize"])
+        self.assertEqual(report["tensorCount"], len(report["tensors"]))
+        self.assertEqual(report["bufferCount"], len(report["buffers"]))
+        return report
+
+    def test_eon(self):
+        with Firmware() as fw:
+            report = self.arena(fw)
+            self.assertEqual(report["engine"], "eon")
+            self.assertEqual(report["arenaSize"], EON_ARENA_SIZE)
+            self.assertGreaterEqual(report["nonPersistentBytes"], EON_INPUT_END)
+            self.assertGreater(report["persistentBytes"], 0)
+            self.assertEqual(report["tensors"], [])
+            # the model is freed again after the report, a second one gives the same layout
+            self.assertEqual(self.arena(fw), report)
+
+    def test_interpreter(self):
+        with open(MODEL, "rb") as f:
+            container = model_container.pack(f.read(), ARENA_SIZE)
+
+        with Firmware() as fw:
+            with contextlib.redirect_stdout(io.StringIO()), contextlib.redirect_stderr(io.StringIO()):
+                self.assertTrue(model_container.send(fw, container))
+            fw.until(b"> ")
+
+            report = self.arena(fw)
+            self.assertEqual(report["engine"], "tflite")
+            self.assertEqual(report["arenaSize"], ARENA_SIZE)
+            self.assertGreater(report["nodes"], 0)
+            self.assertGreater(report["tensorCount"], 0)
+            for tensor in report["tensors"]:
+                self.assertLessEqual(tensor["offset"] + tensor["bytes"], report["nonPersistentBytes"])
+                self.assertLessEqual(tensor["firstNode"], tensor["lastNode"])
+            self.assertEqual(len(report["recorded"]), 6)
+
+if __name__ == "__main__":
+    unittest.main()
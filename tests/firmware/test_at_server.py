@@ -0,0 +1,27 @@
+import os
+import tempfile
+import unittest
+
+from firmware import Firmware
+
+class AtServerTest(unittest.TestCase):
+    def test_config(self):
+        with Firmware() as fw:
+            out = fw.command("AT+CONFIG?")
+            self.assertRegex(out, r"AT Version:\s+\d+\.\d+\.\d+")
+            self.assertIn("PORTENTA_H7_LINUX", out)
+
+    def test_config_persists_in_flash(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            flash = os.path.join(tmp, "flash.bin")
+            with Firmware(flash=flash) as fw:
+                self.assertIn("OK", fw.command("AT+SAMPLESETTINGS=host-test,16,1000"))
+            with Firmware(flash=flash) as fw:
+                self.assertRegex(fw.command("AT+CONFIG?"), r"Label:\s+host-test")
+
+    def test_unknown_command(self):
+        with Firmware() as fw:
+            self.assertNotIn("OK", fw.command("AT+NOSUCHCOMMAND"))
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,109 @@
+import contextlib
+import io
+import math
+import os
+import re
+import struct
+import sys
+import tempfile
+import unittest
+import wave
+
+from firmware import Firmware, TOOLS
+
+sys.path.insert(0, TOOLS)
+import model_container
+
+MODEL = os.path.join(os.path.dirname(__file__), "data", "kws.tflite")
+ARENA_SIZE = 60000
+SAMPLE_RATE = 16000
+
+RESULT = re.compile(r"^Impulse (\d+): Timing: .*\n#Classification predictions:\n((?:  \w+: \d+\.\d+\n)+)", re.M)
+STATS = re.compile(r"^Impulse (\d+) \(window (\d+) ms, stride (\d+) ms, priority (\d+), deadline \d+ us\): "
+                   r"(\d+) runs, (\d+) windows, \d+ deadline misses, \d+ deferred, \d+ skipped, (\d+) errors", re.M)
+DSP = re.compile(r"^Impulse (\d+): latency .*, DSP (\d+) slices run, (\d+) reused", re.M)
+
+class ImpulseMultiTest(unittest.TestCase):
+    """AT+RUNIMPULSEMULTI on a WAV file played as the microphone: the loaded container and
+    the built-in model over one stream"""
+
+    def setUp(self):
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.wav = os.path.join(self.tempdir.name, "tones.wav")
+        # half a second of tone, half a second of silence, so the windows differ
+        samples = [int(3000 * math.sin(ix * 0.2)) if (ix // 8000) % 2 else 0 for ix in range(4 * SAMPLE_RATE)]
+        with wave.open(self.wav, "wb") as w:
+            w.setnchannels(1)
+            w.setsampwidth(2)
+            w.setframerate(SAMPLE_RATE)
+            w.writeframes(struct.pack("<%dh" % len(samples), *samples))
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def run_multi(self, fw, results):
+        """Output of AT+RUNIMPULSEMULTI, stopped after results windows of the last impulse"""
+        fw.write(b"AT+RUNIMPULSEMULTI\r")
+        out = fw.until(b"press 'b' to break\n")
+        last = b"Impulse 0: Timing"
+        if b"Impulses: 2" in out:
+            last = b"Impulse 1: Timing"
+        for _ in range(results):
+            out += fw.until(last)
+        fw.write(b"b")
+        out += fw.until(b"\n> ")
+        return out.decode("utf-8", "replace")
+
+    def stats(self, out):
+        stats = {int(m.group(1)): [int(v) for v in m.groups()[1:]] for m in STATS.finditer(out)}
+        dsp = {int(m.group(1)): [int(v) for v in m.groups()[1:]] for m in DSP.finditer(out)}
+        return stats, dsp
+
+    def test_builtin_only(self):
+        with Firmware("--audio", self.wav, "--audio-pace", "8") as fw:
+            out = self.run_multi(fw, 4)
+        self.assertIn("Impulses: 1", out)
+        self.assertIn("Second impulse: none", out)
+        stats, dsp = self.stats(out)
+        self.assertEqual(list(stats), [0])
+        window, stride, priority, runs, windows, errors = stats[0]
+        self.assertEqual((window, stride, priority, errors), (1000, 250, 0, 0))
+        # the first window is classified once four slices are in
+        self.assertEqual(windows, runs - 3)
+        self.assertEqual(dsp[0], [runs, 0])
+
+    def test_two_impulses(self):
+        with open(MODEL, "rb") as f:
+            container = model_container.pack(f.read(), ARENA_SIZE)
+
+        with Firmware("--audio", self.wav, "--audio-pace", "8") as fw:
+            with contextlib.redirect_stdout(io.StringIO()), contextlib.redirect_stderr(io.StringIO()):
+                self.assertTrue(model_container.send(fw, container))
+            fw.until(b"> ")
+            out = self.run_multi(fw, 6)
+
+        self.assertIn("Impulses: 2", out)
+        stats, dsp = self.stats(out)
+        self.assertEqual(sorted(stats), [0, 1])
+        self.assertEqual(stats[0][:3], [1000, 250, 0])
+        self.assertEqual(stats[1][:3], [1000, 500, 1])
+        self.assertEqual(stats[0][5] + stats[1][5], 0)
+        self.assertGreaterEqual(stats[1][4], 6)
+        # twice the stride, every other slice
+        self.assertLessEqual(abs(stats[0][3] - 2 * stats[1][3]), 2)
+
+        # the built-in model has the container's MFCC block, it takes over the features
+        self.assertEqual(dsp[0], [stats[0][3], 0])
+        self.assertEqual(dsp[1], [0, stats[1][3]])
+
+        # the container holds the weights of the built-in model, so on the same window
+        # (impulse 1 runs right after impulse 0 on the slice that ends both) the scores match
+        results = [(int(m.group(1)), m.group(2)) for m in RESULT.finditer(out)]
+        pairs = [(a[1], b[1]) for a, b in zip(results, results[1:]) if a[0] == 0 and b[0] == 1]
+        self.assertGreaterEqual(len(pairs), 6)
+        for container_scores, builtin_scores in pairs:
+            self.assertEqual(container_scores, builtin_scores)
+        self.assertGreater(len(set(p[0] for p in pairs)), 1)
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,47 @@
+import unittest
+
+from firmware import Firmware
+
+class KernelBenchmarkTest(unittest.TestCase):
+    """The registered int8 kernels (portable TFLM, or CMSIS-NN C with
+    linux-build.sh --cmsis-nn) must be bit-exact with the reference kernels"""
+
+    def check_report(self, out):
+        self.assertIn("int8 kernel benchmark", out)
+        self.assertNotIn("MISMATCH", out)
+        self.assertNotIn("ERR:", out)
+        self.assertRegex(out, r"\b0 case\(s\) failed")
+        # without CMSIS-NN both sides run the reference kernels, no speed-up is claimed
+        if "cmsis-nn vs reference" in out:
+            self.assertNotIn("No optimized kernels", out)
+        else:
+            self.assertIn("No optimized kernels in this build", out)
+            self.assertNotRegex(out, r"\| x\d+\.\d+ \|")
+
+    def test_model_layers(self):
+        with Firmware() as fw:
+            out = fw.command("AT+BENCHKERNELS=MODELONLY", timeout=120)
+            self.check_report(out)
+            self.assertIn("Model layers:", out)
+            self.assertNotIn("Conv2D sweep:", out)
+
+    def test_full_suite(self):
+        with Firmware() as fw:
+            out = fw.command("AT+BENCHKERNELS", timeout=300)
+            self.check_report(out)
+            self.assertIn("Conv2D sweep:", out)
+            cases = [line for line in out.splitlines() if " | " in line]
+            self.assertGreater(len(cases), 20)
+            for line in cases:
+                self.assertTrue(line.endswith("| exact"), line)
+
+    def test_unknown_argument(self):
+        with Firmware() as fw:
+            # a failed command prints no prompt
+            fw.write(b"AT+BENCHKERNELS=y\r")
+            out = fw.until(b"use MODELONLY").decode()
+            self.assertIn("Unknown argument 'y'", out)
+            self.assertNotIn("int8 kernel benchmark", out)
+
+if __name__ == "__main__":
+    unittest.main()
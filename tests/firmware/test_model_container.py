@@ -0,0 +1,125 @@
+import base64
+import contextlib
+import io
+import os
+import random
+import re
+import struct
+import sys
+import tempfile
+import unittest
+
+from firmware import Firmware, TOOLS
+
+sys.path.insert(0, TOOLS)
+import model_container
+
+# the .tflite of the compiled model (tflite-model/), so the scores of a container match the built-in ones
+MODEL = os.path.join(os.path.dirname(__file__), "data", "kws.tflite")
+ARENA_SIZE = 60000
+NUM_FEATURES = 16000
+
+class ModelContainerTest(unittest.TestCase):
+    """Containers uploaded with firmware-sdk/tools/model_container.py and loaded from the flash file"""
+
+    @classmethod
+    def setUpClass(cls):
+        with open(MODEL, "rb") as f:
+            cls.container = model_container.pack(f.read(), ARENA_SIZE)
+        rnd = random.Random(7)
+        cls.windows = [[rnd.randint(-8000, 8000) for _ in range(NUM_FEATURES)],
+                       [int(3000 * ((ix // 40) % 2) - 1500 + rnd.randint(-500, 500)) for ix in range(NUM_FEATURES)]]
+
+    def setUp(self):
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.flash = os.path.join(self.tempdir.name, "flash.bin")
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def upload(self, fw, data):
+        # the tool echoes the device output and prints the progress, keep the test output clean
+        with contextlib.redirect_stdout(io.StringIO()) as out, contextlib.redirect_stderr(io.StringIO()):
+            ok = model_container.send(fw, data)
+        # send() reads up to the end of the END OUTPUT line, a failed command prints no prompt
+        if ok:
+            fw.until(b"> ")
+        return ok, out.getvalue()
+
+    def run_static(self, fw, features):
+        """Scores of AT+RUNIMPULSESTATIC for one window"""
+        data = base64.b64encode(struct.pack("<%df" % len(features), *features)).decode()
+        fw.write("AT+RUNIMPULSESTATIC=n,{}\r".format(len(features)).encode())
+        fw.until(b"OK CHUNK=")
+        chunk = int(fw.until(b"\n").strip())
+        if len(data) % chunk:
+            data += "=" * (chunk - len(data) % chunk)
+        for pos in range(0, len(data), chunk):
+            fw.write(data[pos:pos + chunk].encode())
+            fw.until(b"\n")
+        out = fw.until(b"END OUTPUT").decode("utf-8", "replace")
+        fw.until(b"\n> ")
+        return re.findall(r"^\s+(\w+): (\d+\.\d+)", out, re.M)
+
+    def scores(self, fw):
+        return [self.run_static(fw, window) for window in self.windows]
+
+    def test_load_from_flash(self):
+        with Firmware(flash=self.flash) as fw:
+            self.assertIn("Model: built-in (EON)", fw.command("AT+MODEL?"))
+            builtin = self.scores(fw)
+            self.assertTrue(all(builtin))
+
+            ok, out = self.upload(fw, self.container)
+            self.assertTrue(ok, out)
+            self.assertRegex(out, r"Loaded model from slot A \(generation 1, \d+ bytes, arena {} bytes\)".format(ARENA_SIZE))
+            self.assertEqual(self.scores(fw), builtin)
+
+        # a restart with the same flash file runs the container again
+        with Firmware(flash=self.flash) as fw:
+            self.assertIn(b"Loaded model from slot A", fw.boot)
+            info = fw.command("AT+MODEL?")
+            self.assertIn("Model: slot A (interpreter)", info)
+            self.assertRegex(info, r"Slot A: generation 1, .* \(running\)")
+            self.assertIn("Slot B: empty", info)
+            self.assertEqual(self.scores(fw), builtin)
+
+    def test_corrupt_container(self):
+        corrupt_model = bytearray(self.container)
+        corrupt_model[-1] ^= 0xff
+        corrupt_header = bytearray(self.container)
+        corrupt_header[20] ^= 0xff
+
+        with Firmware(flash=self.flash) as fw:
+            self.assertTrue(self.upload(fw, self.container)[0])
+            for data in (corrupt_model, corrupt_header):
+                ok, out = self.upload(fw, bytes(data))
+                self.assertFalse(ok)
+                self.assertIn("ERR", out)
+            self.assertRegex(fw.command("AT+MODEL?"), r"Slot A: generation 1, .* \(running\)")
+
+        with Firmware(flash=self.flash) as fw:
+            self.assertIn(b"Loaded model from slot A", fw.boot)
+
+    def test_rollback(self):
+        with Firmware(flash=self.flash) as fw:
+            builtin = self.scores(fw)
+            self.assertTrue(self.upload(fw, self.container)[0])
+            ok, out = self.upload(fw, self.container)
+            self.assertTrue(ok, out)
+            self.assertIn("Loaded model from slot B (generation 2", out)
+
+            fw.command("AT+MODELROLLBACK")
+            self.assertRegex(fw.command("AT+MODEL?"), r"Slot A: generation 1, .* \(running\)")
+
+        with Firmware(flash=self.flash) as fw:
+            self.assertIn(b"Loaded model from slot A", fw.boot)
+            fw.command("AT+MODELROLLBACK")
+            self.assertIn("Model: built-in (EON)", fw.command("AT+MODEL?"))
+            self.assertEqual(self.scores(fw), builtin)
+
+        with Firmware(flash=self.flash) as fw:
+            self.assertIn("Model: built-in (EON)", fw.command("AT+MODEL?"))
+
+if __name__ == "__main__":
+    unittest.main()
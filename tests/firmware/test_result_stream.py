@@ -0,0 +1,123 @@
+import json
+import math
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+import unittest
+import wave
+
+from firmware import Firmware, FIRMWARE, TOOLS
+
+sys.path.insert(0, TOOLS)
+from decode_results import ResultStreamDecoder
+
+# the audio sped up, so a few seconds give enough windows
+AUDIO_PACE = "4"
+
+def write_keyed_tone(path):
+    """One second of a 440 Hz tone with a 20 ms gap every slice: the VAD gate (EI_VAD_GATE)
+    closes on the steady synthetic tone, the gaps keep its noise floor down"""
+    samples = [0 if ix % 4000 < 320 else int(3000 * math.sin(2 * math.pi * 440 * ix / 16000))
+               for ix in range(16000)]
+    with wave.open(path, "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(16000)
+        w.writeframes(struct.pack("<%dh" % len(samples), *samples))
+
+class ResultStreamTest(unittest.TestCase):
+    """AT+RUNIMPULSECONT=BINARY records decoded with firmware-sdk/tools/decode_results.py"""
+
+    @classmethod
+    def setUpClass(cls):
+        cls.tempdir = tempfile.TemporaryDirectory()
+        cls.audio = os.path.join(cls.tempdir.name, "tone.wav")
+        write_keyed_tone(cls.audio)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.tempdir.cleanup()
+
+    def run_text(self, fw, count):
+        """Score vectors of the first count windows of AT+RUNIMPULSECONT"""
+        fw.write(b"AT+RUNIMPULSECONT\r")
+        results = []
+        while len(results) < count:
+            block = fw.until(b"Timing:", 60).decode("utf-8", "replace")
+            scores = re.findall(r"^\s+(\S+): (\d+\.\d+)$", block.split("predictions:")[-1], re.M)
+            if scores:
+                results.append({name: float(value) for name, value in scores})
+        fw.write(b"b")
+        fw.until(b"\n> ", 30)
+        return results
+
+    def run_binary(self, fw, count):
+        """Records of AT+RUNIMPULSECONT=BINARY until count results are decoded"""
+        decoder = ResultStreamDecoder()
+        fw.write(b"AT+RUNIMPULSECONT=BINARY\r")
+        records = []
+        deadline = time.time() + 60
+        while len([r for r in records if r["type"] == "result"]) < count:
+            self.assertLess(time.time(), deadline, "no results from the firmware")
+            records += [item for kind, item in decoder.feed(fw.read(4096)) if kind == "record"]
+        fw.write(b"b")
+        fw.until(b"\n> ", 30)
+        return decoder, records
+
+    def test_binary_round_trip(self):
+        with Firmware("--audio", self.audio, "--audio-pace", AUDIO_PACE) as fw:
+            text = self.run_text(fw, 8)
+            decoder, records = self.run_binary(fw, 8)
+
+        self.assertEqual(decoder.crc_errors, 0)
+        self.assertEqual(decoder.lost, 0)
+        self.assertEqual(records[0]["type"], "labels")
+        self.assertEqual(records[0]["labels"], list(text[0].keys()))
+
+        results = [r for r in records if r["type"] == "result"]
+        for previous, record in zip(results, results[1:]):
+            self.assertEqual(record["sequence"], previous["sequence"] + 1)
+        for record in results:
+            self.assertEqual(record["error"], 0)
+            if record["skipped"]:
+                continue
+            self.assertGreater(record["timing_us"]["dsp"], 0)
+            self.assertAlmostEqual(sum(record["classification"].values()), 1.0, delta=0.01)
+        # scores go out as 16 bit fractions, the text has 6 decimals. The gaps make even and odd
+        # slices differ (12.5 MFCC frames per slice), the text only shows every other slice.
+        scored = [r["classification"] for r in results if not r["skipped"]]
+        for scores in text:
+            self.assertTrue(
+                any(all(abs(record[name] - value) < 2e-5 for name, value in scores.items()) for record in scored),
+                "{} is none of the binary results {}".format(scores, scored))
+
+    def test_decode_results_tool(self):
+        # the firmware output piped into the tool, as with a capture file
+        firmware = subprocess.Popen([FIRMWARE, "--audio", self.audio, "--audio-pace", AUDIO_PACE],
+                                    stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+        decoder = subprocess.Popen([sys.executable, os.path.join(TOOLS, "decode_results.py"), "-", "--json"],
+                                   stdin=firmware.stdout, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        firmware.stdout.close()
+
+        firmware.stdin.write(b"AT+RUNIMPULSECONT=BINARY\r")
+        firmware.stdin.flush()
+        time.sleep(5)
+        firmware.stdin.write(b"b")
+        firmware.stdin.close()
+        firmware.wait(30)
+        out, err = decoder.communicate(timeout=30)
+
+        records = [json.loads(line) for line in out.decode().splitlines()]
+        results = [r for r in records if r["type"] == "result"]
+        self.assertEqual(records[0]["type"], "labels")
+        self.assertGreater(len(results), 2)
+        self.assertEqual([r["sequence"] for r in results], list(range(results[0]["sequence"],
+                                                                      results[0]["sequence"] + len(results))))
+        self.assertRegex(err.decode(), r"{} records, 0 CRC errors, 0 results lost".format(len(records)))
+
+if __name__ == "__main__":
+    unittest.main()
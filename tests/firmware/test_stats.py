@@ -0,0 +1,140 @@
+import json
+import math
+import os
+import random
+import re
+import struct
+import tempfile
+import unittest
+import wave
+
+from firmware import Firmware
+
+SAMPLE_RATE = 16000
+STAGES = ("dsp", "classification", "anomaly", "postprocessing", "total")
+
+SUMMARY = re.compile(r"^Inferences: (\d+) \((\d+) errors\), (\d+) skipped slices, (\d+) audio overruns, "
+                     r"(\d+) allocation failures", re.M)
+STAGE = re.compile(r"^(\w+): (\d+) runs, min (\d+) us, avg (\d+) us, p50 (\d+) us, p90 (\d+) us, "
+                   r"p99 (\d+) us, max (\d+) us", re.M)
+SLOW = re.compile(r"^Slow #(\d+) at \d+ ms: (\d+) us \(dsp (\d+), classification (\d+), anomaly (\d+), "
+                  r"postprocessing (\d+)\)(, continuous)?, error (-?\d+), (\d+) skipped slices, (\d+) audio overruns", re.M)
+
+class StatsTest(unittest.TestCase):
+    """AT+STATS after AT+RUNIMPULSECONT on a WAV file played as the microphone: the summary,
+    the JSON of AT+STATS? and the file the Linux build writes with --stats"""
+
+    def setUp(self):
+        self.tempdir = tempfile.TemporaryDirectory()
+        self.wav = os.path.join(self.tempdir.name, "bursts.wav")
+        self.stats_file = os.path.join(self.tempdir.name, "stats.json")
+        # tone bursts in low noise, the VAD gate skips part of the slices (it starts open,
+        # so the first window is classified)
+        rnd = random.Random(46)
+        noise = [rnd.randint(-8, 8) for _ in range(SAMPLE_RATE)]
+        burst = [int(4000 * math.sin(ix * 0.2)) for ix in range(SAMPLE_RATE * 3 // 4)]
+        samples = (noise + burst) * 2
+        with wave.open(self.wav, "wb") as w:
+            w.setnchannels(1)
+            w.setsampwidth(2)
+            w.setframerate(SAMPLE_RATE)
+            w.writeframes(struct.pack("<%dh" % len(samples), *samples))
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def run_continuous(self, fw, results):
+        """Stops after results printed results, every other slice (classified or skipped by the VAD gate)"""
+        fw.write(b"AT+RUNIMPULSECONT\r")
+        while results > 0:
+            line = fw.until(b"\n")
+            if line.startswith(b"#Classification predictions:") or line.startswith(b"Silence"):
+                results -= 1
+        fw.write(b"b")
+        fw.until(b"\n> ")
+
+    def read_json(self, fw, cmd):
+        lines = [line for line in fw.command(cmd).splitlines() if line.startswith("{")]
+        self.assertEqual(len(lines), 1)
+        return json.loads(lines[0])
+
+    def check_json(self, stats):
+        self.assertEqual(set(stats["stages"]), set(STAGES))
+        self.assertEqual(stats["stages"]["total"]["count"], stats["inferences"])
+        for name, stage in stats["stages"].items():
+            buckets = stage["buckets"]
+            self.assertEqual(sum(count for _, count in buckets), stage["count"], name)
+            self.assertEqual([lower for lower, _ in buckets], sorted(set(lower for lower, _ in buckets)), name)
+            if stage["count"] == 0:
+                continue
+            self.assertLessEqual(buckets[0][0], stage["min_us"], name)
+            self.assertLessEqual(buckets[-1][0], stage["max_us"], name)
+            self.assertTrue(stage["min_us"] <= stage["avg_us"] <= stage["max_us"], name)
+            self.assertTrue(stage["min_us"] <= stage["p50_us"] <= stage["p90_us"] <= stage["p99_us"] <= stage["max_us"], name)
+
+        slowest = stats["slowest"]
+        self.assertTrue(0 < len(slowest) <= 8)
+        self.assertEqual([s["total_us"] for s in slowest], sorted((s["total_us"] for s in slowest), reverse=True))
+        for entry in slowest:
+            self.assertTrue(entry["continuous"])
+            self.assertEqual(entry["error"], 0)
+            self.assertLessEqual(entry["total_us"], stats["stages"]["total"]["max_us"])
+            self.assertLessEqual(entry["sequence"], stats["inferences"])
+
+    def test_stats(self):
+        with Firmware("--audio", self.wav, "--audio-pace", "8", "--stats", self.stats_file) as fw:
+            self.assertIn("OK", fw.command("AT+STATS=RESET"))
+            self.run_continuous(fw, 6)
+
+            text = fw.command("AT+STATS")
+            stats = self.read_json(fw, "AT+STATS?")
+            self.assertEqual(self.read_json(fw, "AT+STATS=JSON"), stats)
+
+        # one inference per slice that passed the gate, every one runs the DSP, the NN once
+        # the first window is in
+        summary = SUMMARY.search(text)
+        self.assertIsNotNone(summary, text)
+        inferences, errors, skipped, overruns, alloc_failures = (int(v) for v in summary.groups())
+        self.assertGreaterEqual(inferences, 4)
+        self.assertEqual((errors, alloc_failures), (0, 0))
+        self.assertEqual((stats["inferences"], stats["errors"], stats["skipped_slices"],
+                          stats["audio_overruns"], stats["alloc_failures"]),
+                         (inferences, errors, skipped, overruns, alloc_failures))
+        self.check_json(stats)
+        self.assertEqual(stats["stages"]["dsp"]["count"], inferences)
+        self.assertGreater(stats["stages"]["classification"]["count"], 0)
+        self.assertEqual(stats["stages"]["anomaly"]["count"], 0)
+
+        # the summary lists the stages that ran, with the numbers of the JSON
+        lines = {m.group(1): [int(v) for v in m.groups()[1:]] for m in STAGE.finditer(text)}
+        self.assertEqual(set(lines), set(name for name in STAGES if stats["stages"][name]["count"] > 0))
+        for name, values in lines.items():
+            stage = stats["stages"][name]
+            self.assertEqual(values, [stage["count"], stage["min_us"], stage["avg_us"], stage["p50_us"],
+                                      stage["p90_us"], stage["p99_us"], stage["max_us"]], name)
+
+        slow = [[int(v) for v in (m.group(1), m.group(2))] for m in SLOW.finditer(text)]
+        self.assertEqual(slow, [[s["sequence"], s["total_us"]] for s in stats["slowest"]])
+
+        with open(self.stats_file) as f:
+            self.assertEqual(json.load(f), stats)
+
+    def test_reset(self):
+        with Firmware("--audio", self.wav, "--audio-pace", "8") as fw:
+            self.run_continuous(fw, 2)
+            self.assertGreater(self.read_json(fw, "AT+STATS?")["inferences"], 0)
+
+            self.assertIn("OK", fw.command("AT+STATS=RESET"))
+            stats = self.read_json(fw, "AT+STATS?")
+            self.assertEqual(stats["inferences"], 0)
+            self.assertEqual(stats["slowest"], [])
+            for stage in stats["stages"].values():
+                self.assertEqual((stage["count"], stage["buckets"]), (0, []))
+            self.assertIn("Inferences: 0 (0 errors)", fw.command("AT+STATS"))
+
+            # a failed command prints no prompt
+            fw.write(b"AT+STATS=FOO\r")
+            self.assertIn(b"Unknown argument", fw.until(b"use RESET or JSON\n"))
+
+if __name__ == "__main__":
+    unittest.main()
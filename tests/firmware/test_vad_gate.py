@@ -0,0 +1,70 @@
+import contextlib
+import io
+import math
+import os
+import random
+import struct
+import sys
+import tempfile
+import unittest
+import wave
+
+from firmware import FIRMWARE, TOOLS
+
+sys.path.insert(0, TOOLS)
+import vad_gate_eval
+
+SAMPLE_RATE = 16000
+
+def write_wav(path, samples):
+    with wave.open(path, "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(SAMPLE_RATE)
+        w.writeframes(struct.pack("<%dh" % len(samples), *samples))
+
+class VadGateEvalTest(unittest.TestCase):
+    """firmware-sdk/tools/vad_gate_eval.py on a small synthetic corpus: low noise with
+    tone bursts labelled as keywords"""
+
+    def setUp(self):
+        self.tempdir = tempfile.TemporaryDirectory()
+        rnd = random.Random(3)
+        noise = lambda seconds: [rnd.randint(-8, 8) for _ in range(int(seconds * SAMPLE_RATE))]
+        burst = lambda seconds: [int(4000 * math.sin(ix * 0.2)) for ix in range(int(seconds * SAMPLE_RATE))]
+        self.wav = os.path.join(self.tempdir.name, "bursts.wav")
+        write_wav(self.wav, noise(3.0) + burst(0.75) + noise(3.0) + burst(0.75) + noise(2.5))
+        with open(os.path.join(self.tempdir.name, "bursts.txt"), "w") as f:
+            f.write("3.0\t3.75\thelloworld\n6.75\t7.5\thelloworld\n8.0\t8.5\tnoise\n")
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def test_corpus(self):
+        events = vad_gate_eval.read_labels(os.path.join(self.tempdir.name, "bursts.txt"), {"noise", "unknown"})
+        self.assertEqual(len(events), 2)
+
+        r = vad_gate_eval.evaluate(FIRMWARE, self.wav, events, pace=8, threshold=0.6, timeout=30)
+        # 10 s of audio in 250 ms slices, the silence in between is skipped
+        self.assertGreaterEqual(r["slices"], 40)
+        self.assertLess(r["processed"], r["slices"])
+        # both bursts open the gate, whatever the model makes of a tone
+        self.assertEqual(r["gate_kept"], 2)
+        self.assertLessEqual(r["detected"], 2)
+
+    def test_report(self):
+        argv = sys.argv
+        sys.argv = ["vad_gate_eval.py", self.tempdir.name, "--firmware", FIRMWARE]
+        try:
+            with contextlib.redirect_stdout(io.StringIO()) as out:
+                self.assertEqual(vad_gate_eval.main(), 0)
+        finally:
+            sys.argv = argv
+        lines = out.getvalue().splitlines()
+        self.assertIn("cpu saved", lines[0])
+        self.assertTrue(lines[1].startswith("bursts.wav"))
+        self.assertTrue(lines[2].startswith("total (2 keywords)"))
+        self.assertRegex(lines[2], r" 1\.000 +\d\.\d{3}$")
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,266 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+// this model has no anomaly block, enable K-means for the test
+#undef EI_CLASSIFIER_LOAD_ANOMALY_H
+#define EI_CLASSIFIER_LOAD_ANOMALY_H 1
+#undef EI_CLASSIFIER_HAS_ANOMALY_KMEANS
+#define EI_CLASSIFIER_HAS_ANOMALY_KMEANS 1
+#include "edge-impulse-sdk/classifier/inferencing_engines/anomaly.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace ei;
+
+/* Private types ----------------------------------------------------------- */
+/**
+ * A K-means block with random clusters, its config points into the vectors
+ */
+class KmeansBlock {
+public:
+    KmeansBlock(uint32_t block_id, size_t features, size_t clusters, std::mt19937 &rng)
+        : centroids_(clusters, std::vector<float>(features)), clusters_(clusters),
+          axis_(features), scale_(features), mean_(features)
+    {
+        std::uniform_real_distribution<float> centroid(-2.f, 2.f), error(0.05f, 0.5f), scale(0.5f, 4.f), mean(-1.f, 1.f);
+        for (size_t cx = 0; cx < clusters; cx++) {
+            for (float &c : centroids_[cx]) {
+                c = centroid(rng);
+            }
+            clusters_[cx].centroid = centroids_[cx].data();
+            clusters_[cx].max_error = error(rng);
+        }
+        // every other feature of the DSP output goes to the anomaly block
+        for (size_t ix = 0; ix < features; ix++) {
+            axis_[ix] = (uint16_t)(ix * 2);
+            scale_[ix] = scale(rng);
+            mean_[ix] = mean(rng);
+        }
+        config = { 1, block_id, axis_.data(), (uint16_t)features, clusters_.data(), (uint16_t)clusters,
+            scale_.data(), mean_.data() };
+    }
+
+    /**
+     * The score as computed before the blocked, early-abandon distances: the
+     * distance to every cluster, in double
+     */
+    float reference_score(const float *dsp_output) const
+    {
+        double min = 1000.0;
+        for (const ei_classifier_anom_cluster_t &cluster : clusters_) {
+            double dist = 0.0;
+            for (size_t ix = 0; ix < axis_.size(); ix++) {
+                double value = ((double)dsp_output[axis_[ix]] - mean_[ix]) / scale_[ix];
+                double diff = value - cluster.centroid[ix];
+                dist += diff * diff;
+            }
+            min = std::min(min, sqrt(dist) - cluster.max_error);
+        }
+        return (float)min;
+    }
+
+    ei_learning_block_config_anomaly_kmeans_t config;
+
+private:
+    std::vector<std::vector<float>> centroids_;
+    std::vector<ei_classifier_anom_cluster_t> clusters_;
+    std::vector<uint16_t> axis_;
+    std::vector<float> scale_;
+    std::vector<float> mean_;
+};
+
+/* Private variables ------------------------------------------------------- */
+static const ei_impulse_t test_impulse = { };
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * DSP output around the centroids of a block (so a few clusters are close and most
+ * are abandoned early), or far from all of them
+ */
+static std::vector<float> dsp_output(const KmeansBlock &block, std::mt19937 &rng, bool near)
+{
+    const size_t features = block.config.anom_axes_size;
+    std::uniform_int_distribution<size_t> pick(0, block.config.anom_cluster_count - 1);
+    std::normal_distribution<float> noise(0.f, near ? 0.2f : 3.f);
+    const ei_classifier_anom_cluster_t &cluster = block.config.anom_clusters[pick(rng)];
+    std::vector<float> out(features * 2);
+    for (size_t ix = 0; ix < features; ix++) {
+        float scaled = cluster.centroid[ix] + noise(rng);
+        out[ix * 2] = scaled * block.config.anom_scale[ix] + block.config.anom_mean[ix];
+        out[ix * 2 + 1] = 1e6f; // not an anomaly axis
+    }
+    return out;
+}
+
+static float run_block(const ei_impulse_t *impulse, KmeansBlock &block, std::vector<float> &features)
+{
+    matrix_t matrix(1, features.size(), features.data());
+    ei_feature_t fmatrix = { &matrix, 0 };
+    uint32_t input_block_ids[] = { 0 };
+    ei_impulse_result_t result = { };
+    EI_IMPULSE_ERROR res = run_kmeans_anomaly(impulse, &fmatrix, 0, input_block_ids, 1, &result, &block.config, false);
+    TEST_CHECK(res == EI_IMPULSE_OK);
+    return result.anomaly;
+}
+
+/**
+ * Scores within 1e-5 of the reference for 8 to 256 clusters, through the
+ * interleaved centroids and through the clusters of the config
+ */
+static void test_scores(void)
+{
+    std::mt19937 rng(11);
+    for (size_t clusters : { 8, 13, 32, 64, 128, 256 }) {
+        for (size_t features : { 3, 33, 99 }) {
+            KmeansBlock block(clusters, features, clusters, rng);
+            int mismatches = 0;
+            for (int run = 0; run < 100; run++) {
+                std::vector<float> out = dsp_output(block, rng, run % 4 != 0);
+                float expected = block.reference_score(out.data());
+                float blocked = run_block(&test_impulse, block, out);
+                float plain = get_min_distance_to_cluster(ei_anomaly_kmeans_states[0].input, features,
+                    block.config.anom_clusters, clusters);
+                if (fabsf(blocked - expected) > 1e-5f * std::max(1.f, fabsf(expected)) ||
+                    fabsf(plain - expected) > 1e-5f * std::max(1.f, fabsf(expected))) {
+                    if (mismatches++ == 0) {
+                        printf("%zu clusters, %zu features: %.9g / %.9g, expected %.9g\n",
+                            clusters, features, (double)blocked, (double)plain, (double)expected);
+                    }
+                }
+            }
+            TEST_CHECK_MSG(mismatches == 0, "%zu clusters, %zu features: %d mismatches", clusters, features, mismatches);
+            ei_anomaly_release_state();
+        }
+    }
+}
+
+/**
+ * Two blocks (of one impulse, then of two impulses with the same block id) keep
+ * their own state, alternating between them does not rebuild it
+ */
+static void test_state_per_block(void)
+{
+    std::mt19937 rng(5);
+    static const ei_impulse_t other_impulse = { };
+    KmeansBlock first(3, 20, 16, rng), second(4, 12, 40, rng), same_id(3, 12, 40, rng);
+
+    struct {
+        const ei_impulse_t *impulse;
+        KmeansBlock *block;
+    } runs[] = { { &test_impulse, &first }, { &test_impulse, &second }, { &other_impulse, &same_id } };
+
+    float *inputs[3] = { };
+    for (int round = 0; round < 4; round++) {
+        for (size_t ix = 0; ix < 2; ix++) {
+            std::vector<float> out = dsp_output(*runs[ix].block, rng, true);
+            TEST_CHECK_NEAR(run_block(runs[ix].impulse, *runs[ix].block, out),
+                runs[ix].block->reference_score(out.data()), 1e-5);
+        }
+        for (size_t ix = 0; ix < 2; ix++) {
+            const ei_anomaly_kmeans_state_t &state = ei_anomaly_kmeans_states[ix];
+            TEST_CHECK(state.config == &runs[ix].block->config);
+            if (round > 0) {
+                TEST_CHECK(state.input == inputs[ix]);
+            }
+            inputs[ix] = state.input;
+        }
+    }
+
+    // a third block takes over a state, the scores stay right
+    for (int round = 0; round < 3; round++) {
+        for (auto &run : runs) {
+            std::vector<float> out = dsp_output(*run.block, rng, true);
+            TEST_CHECK_NEAR(run_block(run.impulse, *run.block, out), run.block->reference_score(out.data()), 1e-5);
+        }
+    }
+
+    ei_anomaly_release_state();
+    for (const ei_anomaly_kmeans_state_t &state : ei_anomaly_kmeans_states) {
+        TEST_CHECK(state.config == nullptr && state.input == nullptr && state.centroids == nullptr);
+    }
+}
+
+/**
+ * Score per inference against the reference, the timings are printed (not checked)
+ */
+static void benchmark(void)
+{
+    std::mt19937 rng(2);
+    const int reps = 200;
+    for (size_t clusters : { 8, 32, 256 }) {
+        KmeansBlock block(1, 64, clusters, rng);
+        std::vector<std::vector<float>> outputs;
+        for (int run = 0; run < reps; run++) {
+            outputs.push_back(dsp_output(block, rng, true));
+        }
+        // the scores are summed so the reference is not optimized away
+        volatile float sink = 0.f;
+        double start = now_us();
+        for (std::vector<float> &out : outputs) {
+            sink = sink + run_block(&test_impulse, block, out);
+        }
+        double kmeans_us = (now_us() - start) / reps;
+        start = now_us();
+        for (std::vector<float> &out : outputs) {
+            sink = sink + block.reference_score(out.data());
+        }
+        double reference_us = (now_us() - start) / reps;
+        printf("anomaly: %3zu clusters x 64 features: %6.2f us (reference %6.2f us)\n",
+            clusters, kmeans_us, reference_us);
+        ei_anomaly_release_state();
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_scores();
+    test_state_per_block();
+    benchmark();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,265 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_smooth.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_decision.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* Private variables ------------------------------------------------------- */
+static const char *labels[EI_CLASSIFIER_LABEL_COUNT];
+static char label_names[EI_CLASSIFIER_LABEL_COUNT][8];
+
+/* Private functions ------------------------------------------------------- */
+static float uniform(void)
+{
+    return (float)rand() / (float)RAND_MAX;
+}
+
+/**
+ * A stream of results that dwells on one label for a while, with noisy scores
+ * and the odd anomaly
+ */
+static void next_result(ei_impulse_result_t *result, int *dwell, int *label)
+{
+    if (--*dwell <= 0) {
+        *dwell = 1 + rand() % 12;
+        *label = rand() % EI_CLASSIFIER_LABEL_COUNT;
+    }
+    float sum = 0.f;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        result->classification[ix].label = labels[ix];
+        result->classification[ix].value = uniform() * ((int)ix == *label ? 4.f : 1.f);
+        sum += result->classification[ix].value;
+    }
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        result->classification[ix].value /= sum;
+    }
+    result->anomaly = uniform() < 0.05f ? 0.5f : 0.f;
+}
+
+/**
+ * Consensus as ei_classifier_smooth_update did before the ring buffer: shift the
+ * readings and count all of them on every update
+ */
+static const char *reference_smooth(std::vector<int> &readings, size_t min_readings_same,
+    const ei_impulse_result_t *result)
+{
+    int reading = -1;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (result->classification[ix].value >= 0.8f) {
+            reading = (int)ix;
+        }
+    }
+    if (result->anomaly >= 0.3f) {
+        reading = -2;
+    }
+    readings.erase(readings.begin());
+    readings.push_back(reading);
+
+    uint8_t count[EI_CLASSIFIER_LABEL_COUNT + 2] = { 0 };
+    for (int r : readings) {
+        count[r >= 0 ? r : (r == -1 ? EI_CLASSIFIER_LABEL_COUNT : EI_CLASSIFIER_LABEL_COUNT + 1)]++;
+    }
+    size_t top = 0;
+    uint8_t top_count = 0;
+    bool met = false;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT + 2; ix++) {
+        if (count[ix] > top_count) {
+            top = ix;
+            top_count = count[ix];
+        }
+        if (count[ix] >= min_readings_same) {
+            met = true;
+        }
+    }
+    if (!met || top == EI_CLASSIFIER_LABEL_COUNT) {
+        return "uncertain";
+    }
+    return top == EI_CLASSIFIER_LABEL_COUNT + 1 ? "anomaly" : result->classification[top].label;
+}
+
+static void test_smooth_replay(void)
+{
+    for (size_t n_readings : { 1, 5, 10, 32 }) {
+        const uint8_t min_same = (uint8_t)(n_readings * 7 / 10 > 0 ? n_readings * 7 / 10 : 1);
+        ei_classifier_smooth_t smooth;
+        TEST_CHECK(ei_classifier_smooth_init(&smooth, n_readings, min_same));
+        ei_classifier_decision_t decision;
+        ei_classifier_decision_config_t config;
+        ei_classifier_decision_default_config(&config, EI_CLASSIFIER_LABEL_COUNT);
+        config.n_readings = (uint16_t)n_readings;
+        config.min_readings_same = min_same;
+        TEST_CHECK(ei_classifier_decision_init(&decision, &config) == EI_IMPULSE_OK);
+
+        std::vector<int> readings(n_readings, -1);
+        int dwell = 0, label = 0, mismatches = 0;
+        for (int update = 0; update < 5000; update++) {
+            ei_impulse_result_t result = { };
+            next_result(&result, &dwell, &label);
+            const char *expected = reference_smooth(readings, min_same, &result);
+            const char *smoothed = ei_classifier_smooth_update(&smooth, &result);
+            const char *vote = ei_classifier_decision_update(&decision, &result)->vote;
+            if (strcmp(expected, smoothed) != 0 || strcmp(expected, vote) != 0) {
+                mismatches++;
+            }
+        }
+        TEST_CHECK_MSG(mismatches == 0, "%d readings: %d mismatches", (int)n_readings, mismatches);
+        ei_classifier_smooth_free(&smooth);
+    }
+
+    ei_classifier_smooth_t smooth;
+    TEST_CHECK(!ei_classifier_smooth_init(&smooth, EI_CLASSIFIER_SMOOTH_MAX_READINGS + 1, 1));
+    ei_impulse_result_t result = { };
+    int dwell = 0, label = 0;
+    next_result(&result, &dwell, &label);
+    TEST_CHECK(strcmp(ei_classifier_smooth_update(&smooth, &result), "uncertain") == 0);
+}
+
+/**
+ * Moving average as PerfCal computed it before the shared score window, windows
+ * longer than EI_CLASSIFIER_DECISION_MAX_WINDOW are rejected
+ */
+static void test_score_window_replay(void)
+{
+    for (size_t window : { 1, 4, 7, (int)EI_CLASSIFIER_DECISION_MAX_WINDOW }) {
+        ei_classifier_score_window_t w;
+        TEST_CHECK(ei_classifier_score_window_init(&w, EI_CLASSIFIER_LABEL_COUNT, window) == EI_IMPULSE_OK);
+
+        std::vector<float> score_array(window * EI_CLASSIFIER_LABEL_COUNT, 0.f);
+        std::vector<float> running_sum(EI_CLASSIFIER_LABEL_COUNT, 0.f);
+        size_t score_idx = 0, n_scores = 0;
+        int dwell = 0, label = 0, mismatches = 0;
+        for (int update = 0; update < 5000; update++) {
+            ei_impulse_result_t result = { };
+            next_result(&result, &dwell, &label);
+            ei_classifier_score_window_push(&w, result.classification);
+
+            for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+                running_sum[ix] -= score_array[(score_idx * EI_CLASSIFIER_LABEL_COUNT) + ix];
+                running_sum[ix] += result.classification[ix].value;
+                score_array[(score_idx * EI_CLASSIFIER_LABEL_COUNT) + ix] = result.classification[ix].value;
+            }
+            if (++score_idx >= window) {
+                score_idx = 0;
+            }
+            if (n_scores < window) {
+                n_scores++;
+            }
+            for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+                if (ei_classifier_score_window_mean(&w, ix) != running_sum[ix] / n_scores) {
+                    mismatches++;
+                }
+            }
+        }
+        TEST_CHECK_MSG(mismatches == 0, "window %d: %d mismatches", (int)window, mismatches);
+    }
+
+    ei_classifier_score_window_t w;
+    TEST_CHECK(ei_classifier_score_window_init(&w, EI_CLASSIFIER_LABEL_COUNT, 0) == EI_IMPULSE_INVALID_SIZE);
+    TEST_CHECK(ei_classifier_score_window_init(&w, EI_CLASSIFIER_LABEL_COUNT, EI_CLASSIFIER_DECISION_MAX_WINDOW + 1)
+        == EI_IMPULSE_INVALID_SIZE);
+    TEST_CHECK(ei_classifier_score_window_init(&w, EI_CLASSIFIER_DECISION_MAX_LABELS + 1, 4) == EI_IMPULSE_INVALID_SIZE);
+}
+
+/**
+ * Alternate the dominant label between 0 and 1 every two windows, for six windows
+ *
+ * @return number of events, each checked to be the dominant label
+ */
+static int replay_events(ei_classifier_decision_t *decision, int window)
+{
+    int events = 0;
+    for (int update = 0; update < window * 6; update++) {
+        int hot = (update / (window * 2)) % 2 == 0 ? 0 : 1;
+        ei_impulse_result_t result = { };
+        for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+            result.classification[ix].label = labels[ix];
+            result.classification[ix].value = (int)ix == hot ? 0.9f : 0.1f / (EI_CLASSIFIER_LABEL_COUNT - 1);
+        }
+        const ei_classifier_decision_output_t *out = ei_classifier_decision_update(decision, &result);
+        if (out->event) {
+            TEST_CHECK(out->event_ix == hot);
+            events++;
+        }
+    }
+    return events;
+}
+
+/**
+ * Events on a full averaged window: a label that dominates for long enough fires once,
+ * and again only after it has dropped below the release threshold
+ */
+static void test_decision_events(void)
+{
+    ei_classifier_decision_t decision;
+    ei_classifier_decision_config_t config;
+    ei_classifier_decision_default_config(&config, EI_CLASSIFIER_LABEL_COUNT);
+    config.average_window = EI_CLASSIFIER_DECISION_MAX_WINDOW;
+    config.detection_threshold = 0.7f;
+    config.release_threshold = 0.4f;
+    TEST_CHECK(ei_classifier_decision_init(&decision, &config) == EI_IMPULSE_OK);
+    int events = replay_events(&decision, config.average_window);
+    TEST_CHECK_MSG(events == 3, "%d events", events);
+
+    // only label 1 can raise an event
+    config.label_mask = 1u << 1;
+    TEST_CHECK(ei_classifier_decision_init(&decision, &config) == EI_IMPULSE_OK);
+    events = replay_events(&decision, config.average_window);
+    TEST_CHECK_MSG(events == 1, "%d masked events", events);
+
+    config.average_window = EI_CLASSIFIER_DECISION_MAX_WINDOW + 1;
+    TEST_CHECK(ei_classifier_decision_init(&decision, &config) == EI_IMPULSE_INVALID_SIZE);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        snprintf(label_names[ix], sizeof(label_names[ix]), "l%d", (int)ix);
+        labels[ix] = label_names[ix];
+    }
+    srand(30);
+
+    test_smooth_replay();
+    test_score_window_replay();
+    test_decision_events();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,195 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+#include <chrono>
+#include <random>
+#include <string.h>
+#include <vector>
+
+using namespace ei;
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * The truncated DCT as MFCC computed it before the cached basis: a full dct2 per
+ * row, then the first num_outputs coefficients
+ */
+static void reference_dct(const std::vector<float> &input, size_t rows, size_t N, size_t K,
+    DCT_NORMALIZATION_MODE normalization, std::vector<float> &output)
+{
+    std::vector<float> row(N);
+    output.resize(rows * K);
+    for (size_t ix = 0; ix < rows; ix++) {
+        memcpy(row.data(), &input[ix * N], N * sizeof(float));
+        TEST_CHECK(numpy::dct2(row.data(), N, normalization) == EIDSP_OK);
+        memcpy(&output[ix * K], row.data(), K * sizeof(float));
+    }
+}
+
+static std::vector<float> log_mel(std::mt19937 &rng, size_t rows, size_t N)
+{
+    std::uniform_real_distribution<float> value(-12.f, 4.f);
+    std::vector<float> input(rows * N);
+    for (float &v : input) {
+        v = value(rng);
+    }
+    return input;
+}
+
+/**
+ * dct2_truncated against the reference for 8 to 256 inputs, with the basis and
+ * with the full transform (bases over EIDSP_DCT_MAX_BASIS_ELEMENTS)
+ */
+static void test_float(void)
+{
+    std::mt19937 rng(17);
+    const size_t rows = 20;
+    // dct2 (the reference) needs an even number of inputs
+    for (size_t N : { 8, 20, 32, 40, 64, 128, 200, 256 }) {
+        for (size_t K : { (size_t)1, (size_t)8, (size_t)13, std::min(N, (size_t)20), N }) {
+            if (K > N) {
+                continue;
+            }
+            for (DCT_NORMALIZATION_MODE normalization : { DCT_NORMALIZATION_NONE, DCT_NORMALIZATION_ORTHO }) {
+                std::vector<float> input = log_mel(rng, rows, N), expected, actual(rows * K);
+                reference_dct(input, rows, N, K, normalization, expected);
+                matrix_t in(rows, N, input.data()), out(rows, K, actual.data());
+                TEST_CHECK(numpy::dct2_truncated(&in, &out, normalization) == EIDSP_OK);
+
+                float largest = 0.f, worst = 0.f;
+                for (size_t ix = 0; ix < expected.size(); ix++) {
+                    largest = std::max(largest, fabsf(expected[ix]));
+                    worst = std::max(worst, fabsf(actual[ix] - expected[ix]));
+                }
+                TEST_CHECK_MSG(worst <= 1e-5f * largest, "%zu -> %zu, normalization %d: %g off (of %g)",
+                    N, K, (int)normalization, (double)worst, (double)largest);
+            }
+        }
+    }
+}
+
+/**
+ * dct2_truncated_q15 on Q11 input against the float transform. The log-mel values
+ * are scaled down by 8 so the coefficients fit Q11. The Q15 basis is only built
+ * for the fixed-point path and released with the plans.
+ */
+static void test_q15(void)
+{
+    std::mt19937 rng(3);
+    const size_t rows = 20;
+    for (size_t N : { 8, 32, 40, 64 }) {
+        const size_t K = std::min(N, (size_t)13);
+        std::vector<float> input = log_mel(rng, rows, N), expected;
+        reference_dct(input, rows, N, K, DCT_NORMALIZATION_ORTHO, expected);
+
+        const numpy::dct2_plan_t *plan = numpy::get_dct2_plan(N, K, DCT_NORMALIZATION_ORTHO);
+        TEST_CHECK(plan && plan->basis && !plan->basis_q15);
+
+        std::vector<EIDSP_i16> input_q11(rows * N), output_q11(rows * K);
+        for (size_t ix = 0; ix < input.size(); ix++) {
+            input_q11[ix] = (EIDSP_i16)lrintf(input[ix] / 8.f * 2048.f);
+        }
+        TEST_CHECK(numpy::dct2_truncated_q15(input_q11.data(), rows, N, output_q11.data(), K) == EIDSP_OK);
+        TEST_CHECK(plan->basis_q15 != nullptr);
+        TEST_CHECK(numpy::get_dct2_plan(N, K, DCT_NORMALIZATION_ORTHO) == plan);
+
+        float worst = 0.f;
+        for (size_t ix = 0; ix < expected.size(); ix++) {
+            worst = std::max(worst, fabsf(output_q11[ix] / 2048.f - expected[ix] / 8.f));
+        }
+        TEST_CHECK_MSG(worst <= 0.005f, "%zu -> %zu: %g off", N, K, (double)worst);
+
+        numpy::release_dct2_plans();
+        TEST_CHECK(!plan->basis && !plan->basis_q15);
+    }
+}
+
+/**
+ * 49 frames (1 s MFCC window) for the common filter bank sizes, the timings are
+ * printed (not checked)
+ */
+static void benchmark(void)
+{
+    std::mt19937 rng(8);
+    const size_t rows = 49;
+    const int reps = 200;
+    for (size_t N : { 32, 40, 64 }) {
+        const size_t K = 13;
+        std::vector<float> input = log_mel(rng, rows, N), expected, actual(rows * K);
+        std::vector<EIDSP_i16> input_q11(rows * N), output_q11(rows * K);
+        for (size_t ix = 0; ix < input.size(); ix++) {
+            input_q11[ix] = (EIDSP_i16)lrintf(input[ix] / 8.f * 2048.f);
+        }
+        matrix_t in(rows, N, input.data()), out(rows, K, actual.data());
+
+        double start = now_us();
+        for (int rep = 0; rep < reps; rep++) {
+            reference_dct(input, rows, N, K, DCT_NORMALIZATION_ORTHO, expected);
+        }
+        double reference_us = (now_us() - start) / reps;
+        start = now_us();
+        for (int rep = 0; rep < reps; rep++) {
+            numpy::dct2_truncated(&in, &out, DCT_NORMALIZATION_ORTHO);
+        }
+        double truncated_us = (now_us() - start) / reps;
+        start = now_us();
+        for (int rep = 0; rep < reps; rep++) {
+            numpy::dct2_truncated_q15(input_q11.data(), rows, N, output_q11.data(), K);
+        }
+        double q15_us = (now_us() - start) / reps;
+        printf("dct: %zu frames %2zu -> %zu: %6.1f us, q15 %6.1f us (reference %6.1f us)\n",
+            rows, N, K, truncated_us, q15_us, reference_us);
+    }
+    numpy::release_dct2_plans();
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_float();
+    test_q15();
+    benchmark();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,275 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/spectral/filters.hpp"
+#include "edge-impulse-sdk/dsp/spectral/fir_filter.hpp"
+#include "fir_filter_reference.h"
+
+#include <chrono>
+#include <random>
+#include <string.h>
+#include <vector>
+
+using namespace ei;
+
+/* Private variables ------------------------------------------------------- */
+static const int tap_counts[] = { 5, 8, 31, 63, 64, 127, 255 };
+static const size_t signal_length = 16000;
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * A chirp plus noise, at 3/4 of full scale so the taps can't saturate the output
+ */
+template <class input_t>
+static std::vector<input_t> fir_signal(std::mt19937 &rng, size_t length)
+{
+    std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+    const float scale = 0.75f * (float)std::numeric_limits<input_t>::max();
+    std::vector<input_t> signal(length);
+    for (size_t ix = 0; ix < length; ix++) {
+        float t = (float)ix / (float)length;
+        signal[ix] = (input_t)(scale * (0.75f * sinf(2.0f * (float)M_PI * (10.0f + 2000.0f * t) * t) + noise(rng)));
+    }
+    return signal;
+}
+
+/**
+ * Filter the signal in random sized blocks with the new filter, in one go with the
+ * reference, and the output must be the same; the decimating path must give every
+ * ratio'th sample of it, again in random blocks
+ */
+template <class input_t, class acc_t>
+static void test_fir_variant(const char *name, std::mt19937 &rng)
+{
+    std::vector<input_t> signal = fir_signal<input_t>(rng, signal_length);
+    std::uniform_int_distribution<size_t> block_size(1, 700);
+
+    for (int taps : tap_counts) {
+        for (int highpass = 0; highpass <= 1; highpass++) {
+            float lowpass_cutoff = highpass ? 0.0f : 2000.0f;
+            float highpass_cutoff = highpass ? 500.0f : 0.0f;
+
+            fir_reference::fir_filter<input_t, acc_t> reference(16000.0f, taps, lowpass_cutoff, highpass_cutoff);
+            std::vector<input_t> expected(signal_length);
+            reference.apply_filter(signal.data(), expected.data(), signal_length);
+
+            fir_filter<input_t, acc_t> filter(16000.0f, taps, lowpass_cutoff, highpass_cutoff);
+            std::vector<input_t> actual(signal_length);
+            for (size_t pos = 0; pos < signal_length; ) {
+                size_t n = std::min(block_size(rng), signal_length - pos);
+                filter.apply_filter(signal.data() + pos, actual.data() + pos, n);
+                pos += n;
+            }
+            TEST_CHECK_MSG(actual == expected, "%s, %d taps, highpass %d", name, taps, highpass);
+
+            // after a reset the filter starts from zeros again, in place
+            filter.reset();
+            std::vector<input_t> in_place(signal);
+            filter.apply_filter(in_place.data(), in_place.data(), signal_length);
+            TEST_CHECK_MSG(in_place == expected, "%s, %d taps, highpass %d, reset", name, taps, highpass);
+
+            for (int ratio = 1; ratio <= 8; ratio++) {
+                fir_filter<input_t, acc_t> decimator(16000.0f, taps, lowpass_cutoff, highpass_cutoff, ratio);
+                std::vector<input_t> decimated(signal_length / ratio + 1);
+                size_t out = 0;
+                for (size_t pos = 0; pos < signal_length; ) {
+                    size_t n = std::min(block_size(rng), signal_length - pos);
+                    out += decimator.apply_filter_decimate(signal.data() + pos, decimated.data() + out, n);
+                    pos += n;
+                }
+
+                bool same = out == (signal_length + ratio - 1) / ratio;
+                for (size_t ix = 0; same && ix < out; ix++) {
+                    same = decimated[ix] == expected[ix * ratio];
+                }
+                TEST_CHECK_MSG(same, "%s, %d taps, highpass %d, ratio %d", name, taps, highpass, ratio);
+
+                // reset also restarts the decimation phase
+                decimator.reset();
+                size_t first = decimator.apply_filter_decimate(signal.data(), decimated.data(), 1);
+                TEST_CHECK(first == 1 && decimated[0] == expected[0]);
+            }
+        }
+    }
+}
+
+static void test_fir(void)
+{
+    std::mt19937 rng(11);
+    test_fir_variant<int16_t, int64_t>("int16/int64", rng);
+    test_fir_variant<int16_t, int32_t>("int16/int32", rng);
+    test_fir_variant<int32_t, int64_t>("int32/int64", rng);
+}
+
+/**
+ * rows x cols matrix of noisy sines, one frequency per row
+ */
+static std::vector<float> butterworth_signal(std::mt19937 &rng, size_t rows, size_t cols)
+{
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    std::vector<float> signal(rows * cols);
+    for (size_t row = 0; row < rows; row++) {
+        for (size_t col = 0; col < cols; col++) {
+            signal[row * cols + col] = sinf(0.01f * (row + 1) * col) * (row + 1) + noise(rng);
+        }
+    }
+    return signal;
+}
+
+/**
+ * butterworth_rows (what processing::butterworth_lowpass_filter / highpass_filter
+ * run) against the per-row filters, for every lane count and orders inside and above the sections kept
+ * on the stack
+ */
+static void test_butterworth(void)
+{
+    std::mt19937 rng(5);
+    const size_t cols = 333;
+
+    for (size_t rows = 1; rows <= 9; rows++) {
+        std::vector<float> signal = butterworth_signal(rng, rows, cols);
+
+        for (int order = 0; order <= 10; order += 2) {
+            for (int highpass = 0; highpass <= 1; highpass++) {
+                std::vector<float> expected(signal.size());
+                for (size_t row = 0; row < rows; row++) {
+                    if (highpass) {
+                        spectral::filters::butterworth_highpass(order, 100.0f, 3.0f,
+                            signal.data() + row * cols, expected.data() + row * cols, cols);
+                    }
+                    else {
+                        spectral::filters::butterworth_lowpass(order, 100.0f, 3.0f,
+                            signal.data() + row * cols, expected.data() + row * cols, cols);
+                    }
+                }
+
+                std::vector<float> actual(signal);
+                spectral::filters::butterworth_rows(actual.data(), rows, cols, order, 100.0f, 3.0f, highpass);
+
+                bool same = true;
+                for (size_t ix = 0; ix < actual.size(); ix++) {
+#if EIDSP_BUTTERWORTH_TDF2
+                    same &= fabsf(actual[ix] - expected[ix]) <= 1e-4f * fmaxf(1.0f, fabsf(expected[ix]));
+#else
+                    same &= actual[ix] == expected[ix];
+#endif
+                }
+                TEST_CHECK_MSG(same, "%zu rows, order %d, highpass %d", rows, order, highpass);
+            }
+        }
+    }
+}
+
+/**
+ * Time per filter over signal_length samples, printed (not checked)
+ */
+static void benchmark(void)
+{
+    std::mt19937 rng(1);
+    std::vector<int16_t> signal = fir_signal<int16_t>(rng, signal_length);
+    std::vector<int16_t> out(signal_length);
+    const int runs = 10;
+
+    printf("FIR, int16/int64, %zu samples          reference       block\n", signal_length);
+    for (int taps : { 31, 63, 255 }) {
+        for (int ratio : { 1, 4, 8 }) {
+            double reference_us = 0, block_us = 0;
+            for (int run = 0; run < runs; run++) {
+                // the reference filters every sample and drops the rest afterwards
+                fir_reference::fir_filter<int16_t, int64_t> reference(16000.0f, taps, 2000.0f / ratio);
+                fir_filter<int16_t, int64_t> filter(16000.0f, taps, 2000.0f / ratio, 0, ratio);
+
+                double start = now_us();
+                reference.apply_filter(signal.data(), out.data(), signal_length);
+                for (size_t ix = 0; ix < signal_length / ratio; ix++) {
+                    out[ix] = out[ix * ratio];
+                }
+                double middle = now_us();
+                filter.apply_filter_decimate(signal.data(), out.data(), signal_length);
+                double end = now_us();
+
+                reference_us += middle - start;
+                block_us += end - middle;
+            }
+            printf("    %3d taps, decimation %d       %9.1f us %9.1f us\n", taps, ratio,
+                reference_us / runs, block_us / runs);
+        }
+    }
+
+    printf("Butterworth lowpass, 2000 samples per axis  per row   %d lanes\n", EI_BUTTERWORTH_LANES);
+    for (int order : { 2, 8 }) {
+        for (size_t rows : { (size_t)3, (size_t)6 }) {
+            std::vector<float> input = butterworth_signal(rng, rows, 2000);
+            std::vector<float> buffer(input.size());
+            double per_row_us = 0, lanes_us = 0;
+            for (int run = 0; run < runs; run++) {
+                buffer = input;
+                double start = now_us();
+                for (size_t row = 0; row < rows; row++) {
+                    spectral::filters::butterworth_lowpass(order, 100.0f, 3.0f,
+                        buffer.data() + row * 2000, buffer.data() + row * 2000, 2000);
+                }
+                double middle = now_us();
+                buffer = input;
+                double restart = now_us();
+                spectral::filters::butterworth_rows(buffer.data(), rows, 2000, order, 100.0f, 3.0f, false);
+                double end = now_us();
+
+                per_row_us += middle - start;
+                lanes_us += end - restart;
+            }
+            printf("    order %d, %zu axes                  %9.1f us %9.1f us\n", order, rows,
+                per_row_us / runs, lanes_us / runs);
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_fir();
+    test_butterworth();
+    benchmark();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,364 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+
+// the fusion code (solver and sample tick) with room for up to 8 sensors
+#define EI_FUSION_SENSORS_CONFIG_H
+#define NUM_MAX_FUSIONS          8
+#define FUSION_FREQUENCY         12.5f
+#define NUM_MAX_FUSION_AXIS      20
+#define MULTI_FREQ_ENABLED       1
+typedef float fusion_sample_format_t;
+#include "firmware-sdk/ei_fusion.cpp"
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+/* Private types ----------------------------------------------------------- */
+/**
+ * Device with a sample thread the test ticks itself
+ */
+class TestDevice : public EiDeviceInfo {
+public:
+    void (*sample_read_cb)(void) = nullptr;
+    float sample_interval_ms = 0.0f;
+
+    void init_device_id(void) override
+    {
+    }
+
+    bool start_sample_thread(void (*cb)(void), float interval_ms) override
+    {
+        sample_read_cb = cb;
+        sample_interval_ms = interval_ms;
+        return true;
+    }
+
+    bool stop_sample_thread(void) override
+    {
+        sample_read_cb = nullptr;
+        return true;
+    }
+};
+
+/* Private variables ------------------------------------------------------- */
+static const float rates[] = {
+    1.0f, 5.0f, 10.0f, 12.5f, 20.0f, 25.0f, 26.0f, 50.0f, 52.0f, 62.5f, 100.0f, 104.0f,
+    125.0f, 200.0f, 208.0f, 250.0f, 400.0f, 416.0f, 500.0f, 833.0f, 1000.0f
+};
+
+// reads per sensor in the sample tick test
+static uint32_t sensor_reads[3];
+static fusion_sample_format_t sensor_values[3];
+static std::vector<std::vector<float>> sampled_frames;
+
+static TestDevice device;
+
+/* Private functions ------------------------------------------------------- */
+static uint64_t lcm(uint64_t a, uint64_t b)
+{
+    return (a / calc_gcd(a, b)) * b;
+}
+
+/**
+ * Exhaustive version of ei_fusion_calc_multi_freq_plans: every combination, ticks up to
+ * the highest combination where all frequencies divide each other, the lowest memory
+ * factor per tick, only factors under MULTI_FREQ_MAX_INC_FACTOR if there are any
+ */
+static std::set<std::pair<uint32_t, uint32_t>> reference_plans(
+    const std::vector<std::vector<uint32_t>> &freqs)
+{
+    const size_t n = freqs.size();
+    std::vector<size_t> choice(n, 0);
+    std::vector<std::pair<uint64_t, uint32_t>> combos;
+    uint64_t allowed = 0;
+
+    while (true) {
+        uint64_t tick = 1, highest = 0;
+        uint32_t mem_sum = 0;
+        bool every_tick = false, chain = true;
+
+        for (size_t i = 0; i < n; i++) {
+            uint32_t freq = freqs[i][choice[i]];
+            tick = lcm(tick, freq);
+            highest = std::max<uint64_t>(highest, freq);
+            for (size_t j = 0; j < i; j++) {
+                uint32_t other = freqs[j][choice[j]];
+                chain &= (freq % other == 0) || (other % freq == 0);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t divider = (uint32_t)(tick / freqs[i][choice[i]]);
+            mem_sum += divider;
+            every_tick |= (divider == 1);
+        }
+        if (chain) {
+            allowed = std::max(allowed, highest);
+        }
+        if (tick <= UINT32_MAX) {
+            combos.push_back(std::make_pair(tick, every_tick ? 1 : mem_sum));
+        }
+
+        size_t i = 0;
+        while (i < n && ++choice[i] == freqs[i].size()) {
+            choice[i++] = 0;
+        }
+        if (i == n) {
+            break;
+        }
+    }
+
+    std::map<uint64_t, uint32_t> best;
+    bool below_threshold = false;
+    for (const auto &combo : combos) {
+        if (allowed != 0 && combo.first > allowed) {
+            continue;
+        }
+        auto it = best.find(combo.first);
+        if (it == best.end() || combo.second < it->second) {
+            best[combo.first] = combo.second;
+        }
+        below_threshold |= (combo.second < MULTI_FREQ_MAX_INC_FACTOR);
+    }
+
+    std::set<std::pair<uint32_t, uint32_t>> plans;
+    for (const auto &plan : best) {
+        if (!below_threshold || plan.second < MULTI_FREQ_MAX_INC_FACTOR) {
+            plans.insert(std::make_pair((uint32_t)plan.first, plan.second));
+        }
+    }
+    return plans;
+}
+
+/**
+ * Random sensor with 1 to max_rates distinct frequencies, as the frequency matrix row
+ * and as deduplicated mHz list
+ */
+static void random_sensor(std::mt19937 &rng, int max_rates, float *row, std::vector<uint32_t> *mhz)
+{
+    std::uniform_int_distribution<int> rate(0, sizeof(rates) / sizeof(rates[0]) - 1);
+    std::uniform_int_distribution<int> count(1, max_rates);
+    int num_rates = count(rng);
+
+    for (int ix = 0; ix < EI_MAX_FREQUENCIES; ix++) {
+        row[ix] = 0.0f;
+    }
+    mhz->clear();
+    while ((int)mhz->size() < num_rates) {
+        float freq = rates[rate(rng)];
+        if (std::find(mhz->begin(), mhz->end(), freq_to_mhz(freq)) == mhz->end()) {
+            row[mhz->size()] = freq;
+            mhz->push_back(freq_to_mhz(freq));
+        }
+    }
+}
+
+/**
+ * Dividers, hyperperiod and read flags agree with the chosen frequencies
+ */
+static void check_plan(const ei_fusion_plan_t *plan, const std::vector<std::vector<uint32_t>> &freqs)
+{
+    uint64_t tick = 1;
+    for (size_t i = 0; i < freqs.size(); i++) {
+        TEST_CHECK(std::find(freqs[i].begin(), freqs[i].end(), plan->freq_mhz[i]) != freqs[i].end());
+        tick = lcm(tick, plan->freq_mhz[i]);
+    }
+    TEST_CHECK(plan->tick_mhz == tick);
+
+    for (uint32_t t = 0; t < 2 * plan->hyperperiod && t < 1000; t++) {
+        uint8_t expected = 0;
+        for (size_t i = 0; i < freqs.size(); i++) {
+            if ((t * (uint64_t)plan->freq_mhz[i]) % plan->tick_mhz == 0) {
+                expected |= (1 << i);
+            }
+        }
+        TEST_CHECK_MSG(ei_fusion_plan_read_flags(plan, t) == expected, "tick %u", (unsigned)t);
+    }
+}
+
+/**
+ * Plans of random 2-4 sensor sets against the exhaustive search
+ */
+static void test_plans_match_reference(void)
+{
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> sensors(2, 4);
+    float matrix[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES];
+    std::vector<ei_fusion_plan_t> plans;
+    int sets = 0, mismatches = 0;
+
+    for (int set = 0; set < 3000; set++) {
+        const int n = sensors(rng);
+        std::vector<std::vector<uint32_t>> freqs(n);
+        for (int i = 0; i < n; i++) {
+            random_sensor(rng, EI_MAX_FREQUENCIES, matrix[i], &freqs[i]);
+        }
+
+        ei_fusion_calc_multi_freq_plans(&matrix[0][0], n, &plans);
+
+        std::set<std::pair<uint32_t, uint32_t>> found;
+        for (const ei_fusion_plan_t &plan : plans) {
+            found.insert(std::make_pair(plan.tick_mhz, plan.mem_factor));
+            check_plan(&plan, freqs);
+        }
+        TEST_CHECK(found.size() == plans.size());
+
+        if (found != reference_plans(freqs)) {
+            if (mismatches < 5) {
+                printf("set %d: %zu plans, reference %zu\n", set, found.size(), reference_plans(freqs).size());
+            }
+            mismatches++;
+        }
+        sets++;
+    }
+
+    TEST_CHECK_MSG(mismatches == 0, "%d of %d sets differ from the exhaustive search", mismatches, sets);
+}
+
+/**
+ * 8 sensors with 5 frequencies each: the same plans, the timing is printed (not checked)
+ */
+static void test_plans_timing(void)
+{
+    std::mt19937 rng(9);
+    float matrix[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES];
+    std::vector<ei_fusion_plan_t> plans;
+    double solver_us = 0;
+    const int num_sets = 10;
+
+    for (int set = 0; set < num_sets; set++) {
+        std::vector<std::vector<uint32_t>> freqs(NUM_MAX_FUSIONS);
+        for (int i = 0; i < NUM_MAX_FUSIONS; i++) {
+            do {
+                random_sensor(rng, EI_MAX_FREQUENCIES, matrix[i], &freqs[i]);
+            } while (freqs[i].size() != EI_MAX_FREQUENCIES);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        ei_fusion_calc_multi_freq_plans(&matrix[0][0], NUM_MAX_FUSIONS, &plans);
+        solver_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        std::set<std::pair<uint32_t, uint32_t>> found;
+        for (const ei_fusion_plan_t &plan : plans) {
+            found.insert(std::make_pair(plan.tick_mhz, plan.mem_factor));
+        }
+        TEST_CHECK(found == reference_plans(freqs));
+    }
+
+    printf("fusion: 8 sensors x 5 frequencies, %.0f us per plan search\n", solver_us / num_sets);
+}
+
+static fusion_sample_format_t *read_sensor(int sensor)
+{
+    sensor_values[sensor] = (fusion_sample_format_t)sensor_reads[sensor]++;
+    return &sensor_values[sensor];
+}
+
+static fusion_sample_format_t *read_alpha(int n_samples) { return read_sensor(0); }
+static fusion_sample_format_t *read_beta(int n_samples) { return read_sensor(1); }
+static fusion_sample_format_t *read_gamma(int n_samples) { return read_sensor(2); }
+
+static bool sampler(const void *sample_buf, uint32_t byte_length)
+{
+    const float *values = (const float *)sample_buf;
+    sampled_frames.push_back(std::vector<float>(values, values + byte_length / sizeof(float)));
+    return false;
+}
+
+/**
+ * The multi frequency tick reads every sensor as the plan schedules it and holds the
+ * last value of the others
+ */
+static void test_sample_tick(void)
+{
+    ei_device_fusion_sensor_t alpha = { "Alpha", 1, { 100.0f }, { { "a", "u" } }, read_alpha, 0 };
+    ei_device_fusion_sensor_t beta = { "Beta", 1, { 25.0f, 50.0f }, { { "b", "u" } }, read_beta, 0 };
+    ei_device_fusion_sensor_t gamma = { "Gamma", 1, { 20.0f }, { { "c", "u" } }, read_gamma, 0 };
+
+    fusable_sensor_list.clear();
+    ei_add_sensor_to_fusion_list(alpha);
+    ei_add_sensor_to_fusion_list(beta);
+    ei_add_sensor_to_fusion_list(gamma);
+    TEST_CHECK(ei_connect_fusion_list("Alpha+Beta+Gamma", SENSOR_FORMAT));
+    TEST_CHECK(num_fusions == 3);
+
+    TEST_CHECK(ei_multi_fusion_sample_start(sampler, 10.0f));
+    TEST_CHECK(device.sample_read_cb != nullptr);
+    TEST_CHECK_NEAR(device.sample_interval_ms, 10.0f, 1e-6);
+    const ei_fusion_plan_t *plan = ei_fusion_get_multi_plan();
+    TEST_CHECK(plan->tick_mhz == 100000);
+    TEST_CHECK(plan->divider[0] == 1 && plan->divider[1] == 2 && plan->divider[2] == 5);
+    TEST_CHECK(plan->hyperperiod == 10);
+
+    const int ticks = 100;
+    for (int ix = 0; ix < ticks; ix++) {
+        device.sample_read_cb();
+    }
+    ei_fusion_drain();
+
+    TEST_CHECK(sampled_frames.size() == ticks);
+    TEST_CHECK(sensor_reads[0] == 100 && sensor_reads[1] == 50 && sensor_reads[2] == 20);
+    for (size_t ix = 0; ix < sampled_frames.size(); ix++) {
+        TEST_CHECK(sampled_frames[ix].size() == 3);
+        TEST_CHECK(sampled_frames[ix][0] == (float)ix);
+        TEST_CHECK(sampled_frames[ix][1] == (float)(ix / 2));
+        TEST_CHECK(sampled_frames[ix][2] == (float)(ix / 5));
+    }
+
+    ei_fusion_stats_t stats;
+    ei_fusion_get_stats(&stats);
+    TEST_CHECK(stats.frames == ticks);
+    TEST_CHECK(stats.delivered == ticks);
+    TEST_CHECK(stats.overruns == 0);
+}
+
+/* Public functions -------------------------------------------------------- */
+EiDeviceInfo *EiDeviceInfo::get_device(void)
+{
+    return &device;
+}
+
+int main(void)
+{
+    test_plans_match_reference();
+    test_plans_timing();
+    test_sample_tick();
+
+    return TEST_RESULT();
+}
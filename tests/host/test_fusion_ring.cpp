@@ -0,0 +1,326 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+
+// the fusion code as configured for the Portenta (one sampling frequency), frames
+// handed to the sampler by a consumer thread of the test instead of from the tick
+#define EI_FUSION_SENSORS_CONFIG_H
+#define NUM_MAX_FUSIONS          3
+#define FUSION_FREQUENCY         12.5f
+#define NUM_MAX_FUSION_AXIS      20
+#define MULTI_FREQ_ENABLED       0
+#define EI_FUSION_BATCH_FRAMES   0
+typedef float fusion_sample_format_t;
+#include "firmware-sdk/ei_fusion.cpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/* Private types ----------------------------------------------------------- */
+/**
+ * Device with a sample thread the test ticks itself
+ */
+class TestDevice : public EiDeviceInfo {
+public:
+    void (*sample_read_cb)(void) = nullptr;
+    float sample_interval_ms = 0.0f;
+    std::atomic<bool> stopped { false };
+
+    void init_device_id(void) override
+    {
+    }
+
+    bool start_sample_thread(void (*cb)(void), float interval_ms) override
+    {
+        sample_read_cb = cb;
+        sample_interval_ms = interval_ms;
+        stopped = false;
+        return true;
+    }
+
+    bool stop_sample_thread(void) override
+    {
+        stopped = true;
+        return true;
+    }
+};
+
+/* Private variables ------------------------------------------------------- */
+// Imu (6 axes) is read on every tick, Light (3 axes) has a new value every 3rd tick
+// and returns no data in between, Temp (1 axis) every tick
+static uint32_t imu_reads, light_reads, temp_reads;
+static fusion_sample_format_t imu_values[6], light_values[3], temp_value;
+
+static std::vector<std::vector<float>> sampled_frames;
+static uint32_t last_frame; // the sampler reports the last sample at this frame, 0 never
+
+static TestDevice device;
+
+/* Private functions ------------------------------------------------------- */
+static fusion_sample_format_t *read_imu(int n_samples)
+{
+    for (int ix = 0; ix < 6; ix++) {
+        imu_values[ix] = (fusion_sample_format_t)(imu_reads * 10 + ix);
+    }
+    imu_reads++;
+    return imu_values;
+}
+
+static fusion_sample_format_t *read_light(int n_samples)
+{
+    if (light_reads++ % 3 != 0) {
+        return nullptr;
+    }
+    for (int ix = 0; ix < 3; ix++) {
+        light_values[ix] = (fusion_sample_format_t)(1000 + light_reads * 10 + ix);
+    }
+    return light_values;
+}
+
+static fusion_sample_format_t *read_temp(int n_samples)
+{
+    temp_value = (fusion_sample_format_t)(-(int)temp_reads++);
+    return &temp_value;
+}
+
+static bool sampler(const void *sample_buf, uint32_t byte_length)
+{
+    const float *values = (const float *)sample_buf;
+    sampled_frames.push_back(std::vector<float>(values, values + byte_length / sizeof(float)));
+    return sampled_frames.size() == last_frame;
+}
+
+static bool count_sampler(const void *sample_buf, uint32_t byte_length)
+{
+    static volatile float sink;
+    sink = ((const float *)sample_buf)[0];
+    return false;
+}
+
+static void register_sensors(void)
+{
+    ei_device_fusion_sensor_t imu = { "Imu", 6, { 100.0f },
+        { { "accX", "m/s2" }, { "accY", "m/s2" }, { "accZ", "m/s2" },
+          { "gyrX", "dps" }, { "gyrY", "dps" }, { "gyrZ", "dps" } }, read_imu, 0 };
+    ei_device_fusion_sensor_t light = { "Light", 3, { 100.0f },
+        { { "r", "lux" }, { "g", "lux" }, { "b", "lux" } }, read_light, 0 };
+    ei_device_fusion_sensor_t temp = { "Temp", 1, { 100.0f }, { { "temp", "degC" } }, read_temp, 0 };
+
+    fusable_sensor_list.clear();
+    ei_add_sensor_to_fusion_list(imu);
+    ei_add_sensor_to_fusion_list(light);
+    ei_add_sensor_to_fusion_list(temp);
+}
+
+static void start(const char *list, ei_fusion_list_format format, sampler_callback cb)
+{
+    imu_reads = light_reads = temp_reads = 0;
+    sampled_frames.clear();
+    TEST_CHECK(ei_connect_fusion_list(list, format));
+    TEST_CHECK(ei_fusion_sample_start(cb, 10.0f));
+    TEST_CHECK(device.sample_read_cb == ei_fusion_read_axis_data);
+}
+
+/**
+ * Every frame carries the used axes only, in list order, frames arrive in tick order;
+ * a sensor without new data is zero filled
+ */
+static void test_gather_order(void)
+{
+    last_frame = 0;
+    start("gyrY+accX+r+b+temp", AXIS_FORMAT, sampler);
+    TEST_CHECK(num_fusions == 3);
+    TEST_CHECK(num_fusion_axis == 5);
+
+    const uint32_t ticks = 200;
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        device.sample_read_cb();
+        // nothing is handed over from the tick with EI_FUSION_BATCH_FRAMES 0
+        TEST_CHECK(sampled_frames.size() == tick / 10 * 10);
+        if (tick % 10 == 9) {
+            TEST_CHECK(ei_fusion_drain() == 10);
+            TEST_CHECK(sampled_frames.size() == tick + 1);
+        }
+    }
+    TEST_CHECK(ei_fusion_drain() == 0);
+
+    for (uint32_t tick = 0; tick < ticks && tick < sampled_frames.size(); tick++) {
+        const std::vector<float> &frame = sampled_frames[tick];
+        const bool light = (tick % 3) == 0;
+        TEST_CHECK_MSG(frame.size() == 5, "tick %u", (unsigned)tick);
+        // the gather map keeps the sensor axis order, not the order of the list
+        TEST_CHECK_MSG(frame[0] == (float)(tick * 10 + 0) && frame[1] == (float)(tick * 10 + 4),
+            "tick %u: imu %g %g", (unsigned)tick, frame[0], frame[1]);
+        TEST_CHECK_MSG(frame[2] == (light ? (float)(1000 + (tick + 1) * 10 + 0) : 0.0f) &&
+            frame[3] == (light ? (float)(1000 + (tick + 1) * 10 + 2) : 0.0f),
+            "tick %u: light %g %g", (unsigned)tick, frame[2], frame[3]);
+        TEST_CHECK_MSG(frame[4] == -(float)tick, "tick %u: temp %g", (unsigned)tick, frame[4]);
+    }
+
+    ei_fusion_stats_t stats;
+    ei_fusion_get_stats(&stats);
+    TEST_CHECK(stats.frames == ticks);
+    TEST_CHECK(stats.delivered == ticks);
+    TEST_CHECK(stats.overruns == 0);
+    TEST_CHECK(stats.max_pending == 10);
+    TEST_CHECK(stats.interval_min_us <= stats.interval_max_us);
+}
+
+/**
+ * A full ring drops the newest frames and counts them, the frames that were kept are
+ * delivered in order; once the sampler has its last sample nothing more is read
+ */
+static void test_overrun_and_last(void)
+{
+    last_frame = 0;
+    start("Imu+Temp", SENSOR_FORMAT, sampler);
+    TEST_CHECK(num_fusion_axis == 7);
+
+    for (int tick = 0; tick < EI_FUSION_RING_FRAMES + 5; tick++) {
+        device.sample_read_cb();
+    }
+    TEST_CHECK(ei_fusion_drain() == EI_FUSION_RING_FRAMES);
+    TEST_CHECK(sampled_frames.size() == EI_FUSION_RING_FRAMES);
+    for (size_t ix = 0; ix < sampled_frames.size(); ix++) {
+        TEST_CHECK(sampled_frames[ix][6] == -(float)ix);
+    }
+
+    ei_fusion_stats_t stats;
+    ei_fusion_get_stats(&stats);
+    TEST_CHECK(stats.frames == EI_FUSION_RING_FRAMES + 5);
+    TEST_CHECK(stats.overruns == 5);
+    TEST_CHECK(stats.max_pending == EI_FUSION_RING_FRAMES);
+
+    last_frame = 30;
+    start("Imu+Temp", SENSOR_FORMAT, sampler);
+    for (int tick = 0; tick < 40; tick++) {
+        device.sample_read_cb();
+        ei_fusion_drain();
+    }
+    TEST_CHECK(device.stopped);
+    TEST_CHECK(sampled_frames.size() == 30);
+    TEST_CHECK(imu_reads == 30);
+    ei_fusion_get_stats(&stats);
+    TEST_CHECK(stats.delivered == 30);
+}
+
+/**
+ * The tick in one thread at a fixed interval, the sampler in another: every frame
+ * arrives once and in order, the interval statistics cover the real tick times
+ */
+static void test_threads(void)
+{
+    last_frame = 0;
+    start("Imu+Light+Temp", SENSOR_FORMAT, sampler);
+
+    const uint32_t ticks = 500;
+    std::atomic<bool> ticking { true };
+    std::thread consumer([&]() {
+        while (ticking || fusion_ring_head.load() != fusion_ring_tail.load()) {
+            ei_fusion_drain();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        device.sample_read_cb();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    ticking = false;
+    consumer.join();
+
+    ei_fusion_stats_t stats;
+    ei_fusion_get_stats(&stats);
+    TEST_CHECK(stats.frames == ticks);
+    TEST_CHECK(stats.delivered + stats.overruns == ticks);
+    TEST_CHECK(sampled_frames.size() == stats.delivered);
+    TEST_CHECK(stats.interval_min_us >= 100);
+    TEST_CHECK(stats.interval_min_us <= stats.interval_max_us);
+    // jitter is against the requested 10 ms, the test ticks faster
+    TEST_CHECK(stats.jitter_max_us == (uint32_t)std::max<int64_t>(10000 - (int64_t)stats.interval_min_us,
+        (int64_t)stats.interval_max_us - 10000));
+
+    // dropped frames leave gaps, but the order never changes
+    bool ordered = true;
+    for (size_t ix = 1; ix < sampled_frames.size(); ix++) {
+        ordered &= sampled_frames[ix][0] > sampled_frames[ix - 1][0];
+    }
+    TEST_CHECK(ordered);
+}
+
+/**
+ * Cost of a tick and its share of the hand-off, with the ring drained whenever it
+ * is full, printed (not checked)
+ */
+static void benchmark(void)
+{
+    start("Imu+Light+Temp", SENSOR_FORMAT, count_sampler);
+
+    const uint32_t ticks = 1000000;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        device.sample_read_cb();
+        if (tick % EI_FUSION_RING_FRAMES == EI_FUSION_RING_FRAMES - 1) {
+            ei_fusion_drain();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    ei_fusion_stats_t stats;
+    ei_fusion_get_stats(&stats);
+    TEST_CHECK(stats.delivered == ticks);
+    TEST_CHECK(stats.overruns == 0);
+    printf("fusion: 3 sensors, 10 axes, %.3f us per tick and hand-off (%.0f kHz sustainable)\n",
+        seconds * 1e6 / ticks, ticks / seconds / 1000.0);
+}
+
+/* Public functions -------------------------------------------------------- */
+EiDeviceInfo *EiDeviceInfo::get_device(void)
+{
+    return &device;
+}
+
+int main(void)
+{
+    register_sensors();
+
+    test_gather_order();
+    test_overrun_and_last();
+    test_threads();
+    benchmark();
+
+    return TEST_RESULT();
+}
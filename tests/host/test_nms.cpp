@@ -0,0 +1,258 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+
+// this model has no object detection, enable the NMS code for the test
+#undef EI_HAS_YOLOV5
+#define EI_HAS_YOLOV5 1
+#include "edge-impulse-sdk/classifier/ei_nms.h"
+
+#include <chrono>
+#include <stdlib.h>
+#include <vector>
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    std::vector<float> boxes;
+    std::vector<float> scores;
+} scene_t;
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float uniform(void)
+{
+    return (float)rand() / (float)RAND_MAX;
+}
+
+/**
+ * Boxes around a number of objects, several overlapping detections per object
+ * and a few large boxes
+ */
+static scene_t random_scene(int num_boxes, int num_objects)
+{
+    scene_t scene;
+    std::vector<float> centers;
+    for (int ix = 0; ix < num_objects; ix++) {
+        centers.push_back(uniform() * 320.f);
+        centers.push_back(uniform() * 320.f);
+    }
+    for (int ix = 0; ix < num_boxes; ix++) {
+        int object = rand() % num_objects;
+        float size = (ix % 17 == 0) ? 80.f + uniform() * 160.f : 8.f + uniform() * 24.f;
+        float y = centers[object * 2] + (uniform() - 0.5f) * 12.f;
+        float x = centers[object * 2 + 1] + (uniform() - 0.5f) * 12.f;
+        // corners in either order, NMS has to sort them out
+        if (ix % 3 == 0) {
+            scene.boxes.insert(scene.boxes.end(), { y + size / 2, x + size / 2, y - size / 2, x - size / 2 });
+        }
+        else {
+            scene.boxes.insert(scene.boxes.end(), { y - size / 2, x - size / 2, y + size / 2, x + size / 2 });
+        }
+        scene.scores.push_back((float)(ix + 1) / (float)(num_boxes + 1));
+    }
+    // distinct scores: on ties NonMaxSuppression picks in heap order, ei_nms_run the lowest index
+    for (int ix = num_boxes - 1; ix > 0; ix--) {
+        std::swap(scene.scores[ix], scene.scores[rand() % (ix + 1)]);
+    }
+    return scene;
+}
+
+/**
+ * Small boxes on a regular grid that each straddle four cells of the NMS grid, and
+ * one large low score box over all of them. With soft-NMS and no hard suppression the
+ * large box has every selected box as a neighbour, most of them in four cells.
+ */
+static scene_t straddling_scene(int side)
+{
+    scene_t scene;
+    const float pitch = 10.f;
+    for (int row = 0; row < side; row++) {
+        for (int col = 0; col < side; col++) {
+            float y = row * pitch, x = col * pitch;
+            scene.boxes.insert(scene.boxes.end(), { y + 2.f, x + 2.f, y + 8.f, x + 8.f });
+            scene.scores.push_back(0.9f - 0.0001f * (row * side + col));
+        }
+    }
+    scene.boxes.insert(scene.boxes.end(), { 0.f, 0.f, side * pitch, side * pitch });
+    scene.scores.push_back(0.5f);
+    return scene;
+}
+
+static void check_equivalent(ei_nms_workspace_t *ws, const scene_t &scene, int max_output_size,
+    float iou_threshold, float score_threshold, float soft_nms_sigma)
+{
+    const int num_boxes = (int)scene.scores.size();
+    std::vector<int> expected_indices(max_output_size), indices(max_output_size);
+    std::vector<float> expected_scores(max_output_size), scores(max_output_size);
+    int expected_count = 0, count = 0;
+
+    NonMaxSuppression(scene.boxes.data(), num_boxes, scene.scores.data(), max_output_size,
+        iou_threshold, score_threshold, soft_nms_sigma,
+        expected_indices.data(), expected_scores.data(), &expected_count);
+    EI_IMPULSE_ERROR res = ei_nms_run(ws, scene.boxes.data(), num_boxes, scene.scores.data(), nullptr,
+        max_output_size, iou_threshold, score_threshold, soft_nms_sigma, EI_NMS_CLASS_AGNOSTIC,
+        indices.data(), scores.data(), &count);
+
+    TEST_CHECK(res == EI_IMPULSE_OK);
+    TEST_CHECK_MSG(count == expected_count, "%d boxes, iou %g, sigma %g: %d vs %d selected",
+        num_boxes, (double)iou_threshold, (double)soft_nms_sigma, count, expected_count);
+    for (int ix = 0; ix < count && ix < expected_count; ix++) {
+        if (indices[ix] != expected_indices[ix] || scores[ix] != expected_scores[ix]) {
+            TEST_CHECK_MSG(false, "%d boxes, iou %g, sigma %g: selection %d is %d (%g), expected %d (%g)",
+                num_boxes, (double)iou_threshold, (double)soft_nms_sigma, ix,
+                indices[ix], (double)scores[ix], expected_indices[ix], (double)expected_scores[ix]);
+            break;
+        }
+    }
+}
+
+/**
+ * The workspace of ei_run_nms is freed with the impulse (run_classifier_deinit)
+ */
+static void test_release_workspace(void)
+{
+    TEST_CHECK(ei_nms_workspace_reserve(&ei_nms_default_workspace, 100) == EI_IMPULSE_OK);
+    TEST_CHECK(ei_nms_workspace_reserve_staging(&ei_nms_default_workspace, 100) == EI_IMPULSE_OK);
+    TEST_CHECK(ei_nms_default_workspace.buffer != nullptr);
+    ei_nms_release_workspace();
+    TEST_CHECK(ei_nms_default_workspace.buffer == nullptr);
+    TEST_CHECK(ei_nms_default_workspace.staging_buffer == nullptr);
+    TEST_CHECK(ei_nms_default_workspace.capacity == 0);
+}
+
+/**
+ * Hard and soft NMS from 50 to 5000 candidates, the timings are printed (not checked)
+ */
+static void benchmark(ei_nms_workspace_t *ws)
+{
+    for (int num_boxes : { 50, 200, 1000, 5000 }) {
+        scene_t scene = random_scene(num_boxes, 1 + num_boxes / 6);
+        std::vector<int> indices(num_boxes);
+        std::vector<float> scores(num_boxes);
+        const int reps = num_boxes >= 1000 ? 5 : 50;
+
+        for (float sigma : { 0.0f, 0.5f }) {
+            double reference_us = 0, nms_us = 0;
+            for (int rep = 0; rep < reps; rep++) {
+                int count = 0;
+                double start = now_us();
+                NonMaxSuppression(scene.boxes.data(), num_boxes, scene.scores.data(), num_boxes,
+                    0.45f, 0.1f, sigma, indices.data(), scores.data(), &count);
+                reference_us += now_us() - start;
+
+                start = now_us();
+                ei_nms_run(ws, scene.boxes.data(), num_boxes, scene.scores.data(), nullptr, num_boxes,
+                    0.45f, 0.1f, sigma, EI_NMS_CLASS_AGNOSTIC, indices.data(), scores.data(), &count);
+                nms_us += now_us() - start;
+            }
+            printf("nms: %4d candidates, sigma %.1f: %8.1f us (reference %9.1f us)\n",
+                num_boxes, (double)sigma, nms_us / reps, reference_us / reps);
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    ei_nms_workspace_t ws = { };
+    srand(1234);
+
+    // ei_nms_run against the O(n^2) NonMaxSuppression, below and above the grid threshold
+    const int sizes[] = { 1, 8, 31, 64, 300, 1200 };
+    for (int num_boxes : sizes) {
+        for (int rep = 0; rep < 4; rep++) {
+            scene_t scene = random_scene(num_boxes, 1 + num_boxes / 6);
+            check_equivalent(&ws, scene, num_boxes, 0.45f, 0.1f, 0.0f);
+            check_equivalent(&ws, scene, 10, 0.45f, 0.1f, 0.0f);
+            check_equivalent(&ws, scene, num_boxes, 0.0f, 0.1f, 0.0f);
+            check_equivalent(&ws, scene, num_boxes, 0.45f, 0.1f, 0.5f);
+            check_equivalent(&ws, scene, num_boxes, 1.0f, 0.05f, 0.3f);
+        }
+    }
+
+    // a candidate that shares cells with every selected box, each of them in up to four cells
+    for (int side : { 8, 20 }) {
+        scene_t scene = straddling_scene(side);
+        ei_nms_workspace_free(&ws);
+        check_equivalent(&ws, scene, (int)scene.scores.size(), 1.0f, 0.01f, 0.5f);
+
+        // the neighbour list of the large box holds every selected box (itself included) once
+        const int num_boxes = (int)scene.scores.size();
+        std::vector<int> indices(num_boxes);
+        int num_selected = 0;
+        ei_nms_run(&ws, scene.boxes.data(), num_boxes, scene.scores.data(), nullptr, num_boxes,
+            1.0f, 0.01f, 0.5f, EI_NMS_CLASS_AGNOSTIC, indices.data(), nullptr, &num_selected);
+        TEST_CHECK(num_selected == num_boxes);
+        std::vector<int> entries(ws.entry_selected, ws.entry_selected + ws.entry_count);
+        size_t count = ei_nms_find_neighbours(&ws, num_boxes - 1, nullptr, EI_NMS_CLASS_AGNOSTIC, 0, num_selected);
+        TEST_CHECK(std::equal(entries.begin(), entries.end(), ws.entry_selected));
+        TEST_CHECK_MSG(count == (size_t)num_selected, "%d neighbours, expected %d", (int)count, num_selected);
+        for (size_t ix = 1; ix < count && ix < (size_t)num_selected; ix++) {
+            TEST_CHECK(ws.neighbours[ix] < ws.neighbours[ix - 1]);
+        }
+
+        check_equivalent(&ws, scene, (int)scene.scores.size(), 0.3f, 0.01f, 0.0f);
+    }
+
+    // equal scores: hard NMS selects the lowest index first
+    {
+        scene_t scene = random_scene(200, 40);
+        for (float &score : scene.scores) {
+            score = 0.5f;
+        }
+        std::vector<int> indices(200);
+        int count = 0;
+        ei_nms_run(&ws, scene.boxes.data(), 200, scene.scores.data(), nullptr, 200, 0.45f, 0.1f, 0.0f,
+            EI_NMS_CLASS_AGNOSTIC, indices.data(), nullptr, &count);
+        TEST_CHECK(count > 1);
+        TEST_CHECK(indices[0] == 0);
+        for (int ix = 1; ix < count; ix++) {
+            TEST_CHECK(indices[ix] > indices[ix - 1]);
+        }
+    }
+
+    test_release_workspace();
+    benchmark(&ws);
+
+    ei_nms_workspace_free(&ws);
+    return TEST_RESULT();
+}
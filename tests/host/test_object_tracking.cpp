@@ -0,0 +1,251 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include <stdint.h>
+
+// test_full_pool fills the tracker pool on purpose, keep its warnings out of the test output
+#define EI_LOG_LEVEL EI_LOG_LEVEL_ERROR
+
+// this model has no object tracking, give the result the traces a SORT model is
+// generated with and enable the tracker for the test
+#define ei_post_processing_output_t ei_post_processing_output_unused_t
+#include "model-parameters/model_metadata.h"
+#undef ei_post_processing_output_t
+
+typedef struct {
+    uint32_t id;
+    const char *label;
+    float value;
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+} ei_object_tracking_trace_t;
+
+typedef struct {
+    ei_object_tracking_trace_t *open_traces;
+    uint32_t open_traces_count;
+} ei_object_tracking_output_t;
+
+typedef struct {
+    ei_object_tracking_output_t object_tracking_output;
+} ei_post_processing_output_t;
+
+// the postprocessing glue refers to the impulse of the firmware, the tracker itself does not
+#define ei_default_impulse test_default_impulse
+#undef EI_CLASSIFIER_OBJECT_TRACKING_SORT_ENABLED
+#define EI_CLASSIFIER_OBJECT_TRACKING_SORT_ENABLED 1
+#include "edge-impulse-sdk/classifier/postprocessing/ei_object_tracking_sort.h"
+#include "sort_reference.h"
+
+#include <chrono>
+#include <random>
+#include <string.h>
+#include <vector>
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    float x, y, vx, vy, w, h;
+    const char *label;
+} object_t;
+
+/* Private variables ------------------------------------------------------- */
+static const ei_impulse_t test_impulse = { };
+static ei_impulse_handle_t test_handle(&test_impulse);
+ei_impulse_handle_t &test_default_impulse = test_handle;
+
+static const char *labels[] = { "car", "person" };
+static const int max_age = 1;
+static const int min_hits = 3;
+static const float iou_threshold = 0.3f;
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Detections of num_objects objects that move across a 640x640 frame and bounce off
+ * its edges, with jitter, missed detections and false positives
+ */
+class Scene {
+public:
+    Scene(int num_objects, uint32_t seed) : rng_(seed)
+    {
+        std::uniform_real_distribution<float> pos(40.f, 600.f), vel(-6.f, 6.f), size(16.f, 48.f);
+        for (int ix = 0; ix < num_objects; ix++) {
+            objects_.push_back({ pos(rng_), pos(rng_), vel(rng_), vel(rng_), size(rng_), size(rng_), labels[ix % 2] });
+        }
+    }
+
+    const std::vector<ei_impulse_result_bounding_box_t> &next_frame(void)
+    {
+        std::uniform_real_distribution<float> unit(0.f, 1.f), jitter(-1.5f, 1.5f);
+        frame_.clear();
+        for (object_t &o : objects_) {
+            o.x += o.vx;
+            o.y += o.vy;
+            if (o.x < 0.f || o.x + o.w > 640.f) {
+                o.vx = -o.vx;
+            }
+            if (o.y < 0.f || o.y + o.h > 640.f) {
+                o.vy = -o.vy;
+            }
+            if (unit(rng_) < 0.05f) {
+                continue;
+            }
+            frame_.push_back(box(o.label, o.x + jitter(rng_), o.y + jitter(rng_), o.w, o.h, 0.5f + 0.5f * unit(rng_)));
+        }
+        if (unit(rng_) < 0.2f) {
+            frame_.push_back(box(labels[0], 640.f * unit(rng_), 640.f * unit(rng_), 30.f, 30.f, 0.4f));
+        }
+        return frame_;
+    }
+
+private:
+    static ei_impulse_result_bounding_box_t box(const char *label, float x, float y, float w, float h, float value)
+    {
+        ei_impulse_result_bounding_box_t bb = { };
+        bb.label = label;
+        bb.x = (uint32_t)std::max(x, 0.f);
+        bb.y = (uint32_t)std::max(y, 0.f);
+        bb.width = (uint32_t)w;
+        bb.height = (uint32_t)h;
+        bb.value = value;
+        return bb;
+    }
+
+    std::mt19937 rng_;
+    std::vector<object_t> objects_;
+    std::vector<ei_impulse_result_bounding_box_t> frame_;
+};
+
+static bool same_traces(const std::vector<ei_object_tracking_trace_t> &a, const std::vector<ei_object_tracking_trace_t> &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t ix = 0; ix < a.size(); ix++) {
+        if (a[ix].id != b[ix].id || strcmp(a[ix].label, b[ix].label) != 0 || a[ix].value != b[ix].value ||
+            a[ix].x != b[ix].x || a[ix].y != b[ix].y || a[ix].width != b[ix].width || a[ix].height != b[ix].height) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Frame by frame the same traces as the reference tracker, as long as the live
+ * tracks fit the pool (EI_OBJECT_TRACKING_SORT_MAX_TRACKS)
+ */
+static void test_replay(void)
+{
+    for (int num_objects : { 1, 5, 20, 40, 55 }) {
+        Scene scene(num_objects, 100 + num_objects);
+        SORTTracker tracker(max_age, min_hits, iou_threshold);
+        sort_reference::SORTTracker reference(max_age, min_hits, iou_threshold);
+        tracker.reset_ids();
+        reference.reset_ids();
+
+        int mismatches = 0;
+        for (int frame = 0; frame < 300; frame++) {
+            const std::vector<ei_impulse_result_bounding_box_t> &detections = scene.next_frame();
+            tracker.process_new_detections(detections);
+            reference.process_new_detections(detections);
+            if (!same_traces(tracker.object_tracking_output, reference.object_tracking_output)) {
+                mismatches++;
+            }
+        }
+        TEST_CHECK_MSG(mismatches == 0, "%d objects: %d of 300 frames differ", num_objects, mismatches);
+    }
+}
+
+/**
+ * With more objects than trackers the pool keeps its size, detections that find
+ * no free tracker are not tracked
+ */
+static void test_full_pool(void)
+{
+    const int max_tracks = 16;
+    Scene scene(40, 7);
+    SORTTracker tracker(max_age, min_hits, iou_threshold, max_tracks);
+    tracker.reset_ids();
+
+    size_t most_traces = 0;
+    for (int frame = 0; frame < 100; frame++) {
+        tracker.process_new_detections(scene.next_frame());
+        most_traces = std::max(most_traces, tracker.object_tracking_output.size());
+    }
+    TEST_CHECK_MSG(most_traces > 0 && most_traces <= (size_t)max_tracks, "%d traces", (int)most_traces);
+    TEST_CHECK(tracker.object_tracking_output.capacity() == (size_t)max_tracks);
+}
+
+/**
+ * Tracker update per frame against the reference, the timings are printed (not checked)
+ */
+static void benchmark(void)
+{
+    for (int num_objects : { 10, 30, 60 }) {
+        Scene scene(num_objects, 3);
+        SORTTracker tracker(max_age, min_hits, iou_threshold);
+        sort_reference::SORTTracker reference(max_age, min_hits, iou_threshold);
+        double tracker_us = 0, reference_us = 0;
+        const int frames = 300;
+        for (int frame = 0; frame < frames; frame++) {
+            const std::vector<ei_impulse_result_bounding_box_t> &detections = scene.next_frame();
+            double start = now_us();
+            tracker.process_new_detections(detections);
+            tracker_us += now_us() - start;
+            start = now_us();
+            reference.process_new_detections(detections);
+            reference_us += now_us() - start;
+        }
+        printf("sort: %2d objects: %6.1f us per frame (reference %6.1f us)\n",
+            num_objects, tracker_us / frames, reference_us / frames);
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_replay();
+    test_full_pool();
+    benchmark();
+
+    return TEST_RESULT();
+}
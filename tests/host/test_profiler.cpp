@@ -0,0 +1,292 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+
+#include <chrono>
+#include <random>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ei;
+
+/* Private variables ------------------------------------------------------- */
+// the zones are used directly, the test does not depend on EI_PROFILER (off in linux-build.sh)
+static profiler::zone zone_a("a");
+static profiler::zone zone_b("b");
+static profiler::zone zone_c("c");
+static profiler::zone zone_x("x");
+static profiler::zone_array<EI_PROFILER_MAX_PARENTS + 1> zone_parents("parent");
+static profiler::zone zone_empty("empty");
+
+static std::string *printed = nullptr;
+static const size_t slice_size = EI_CLASSIFIER_SLICE_SIZE;
+static std::vector<float> slice_samples;
+
+/* Public functions -------------------------------------------------------- */
+
+// the SDK prints to stdout (or into printed), the device port stays out of the test
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    if (printed != nullptr) {
+        char buf[256];
+        vsnprintf(buf, sizeof(buf), format, args);
+        printed->append(buf);
+    }
+    else {
+        vprintf(format, args);
+    }
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    printf("%.6f", f);
+}
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void busy_us(double us)
+{
+    double end = now_us() + us;
+    while (now_us() < end) { }
+}
+
+static std::string report(bool tree)
+{
+    std::string out;
+    printed = &out;
+    profiler::report(tree);
+    printed = nullptr;
+    return out;
+}
+
+static const profiler::path_t *find_path(const profiler::zone &z, const profiler::path_t *parent)
+{
+    for (uint8_t ix = 0; ix < z.paths_size; ix++) {
+        if (z.paths[ix].parent == parent) {
+            return &z.paths[ix];
+        }
+    }
+    return nullptr;
+}
+
+static void run_b(void)
+{
+    profiler::scope s(zone_b);
+    busy_us(50);
+}
+
+/**
+ * b runs under a and at the top level, c under b under a: every entry is in the tree
+ * under the parent it ran in, the flat report sums them
+ */
+static void test_tree(void)
+{
+    profiler::reset();
+    for (int ix = 0; ix < 3; ix++) {
+        profiler::scope s(zone_a);
+        run_b();
+        {
+            profiler::scope sb(zone_b);
+            profiler::scope sc(zone_c);
+            busy_us(20);
+        }
+    }
+    run_b();
+    TEST_CHECK(profiler::current_path() == nullptr);
+
+    const profiler::path_t *a = find_path(zone_a, nullptr);
+    const profiler::path_t *b_in_a = find_path(zone_b, a);
+    const profiler::path_t *b_top = find_path(zone_b, nullptr);
+    const profiler::path_t *c = find_path(zone_c, b_in_a);
+    TEST_CHECK(a != nullptr && b_in_a != nullptr && b_top != nullptr && c != nullptr);
+    TEST_CHECK(zone_a.paths_size == 1 && zone_b.paths_size == 2 && zone_c.paths_size == 1);
+    if (a == nullptr || b_in_a == nullptr || b_top == nullptr || c == nullptr) {
+        return;
+    }
+    TEST_CHECK(a->stats.count == 3 && b_in_a->stats.count == 6 && b_top->stats.count == 1 && c->stats.count == 3);
+    TEST_CHECK(zone_b.stats.count == 7 && zone_b.stats.total == b_in_a->stats.total + b_top->stats.total);
+    TEST_CHECK(zone_b.unattributed == 0);
+    TEST_CHECK(a->stats.total >= b_in_a->stats.total && b_in_a->stats.total >= c->stats.total);
+    TEST_CHECK(zone_b.stats.min <= zone_b.stats.max && b_top->stats.min >= 49);
+
+    std::string tree = report(true);
+    TEST_CHECK(tree.find("\na ") != std::string::npos);
+    TEST_CHECK(tree.find("\n  b ") != std::string::npos);
+    TEST_CHECK(tree.find("\n    c ") != std::string::npos);
+    TEST_CHECK(tree.find("\nb ") != std::string::npos);
+    TEST_CHECK(tree.find("parents are only in the flat report") == std::string::npos);
+
+    std::string flat = report(false);
+    TEST_CHECK(flat.find("\nb        ") != std::string::npos && flat.find("\n  ") == std::string::npos);
+
+    profiler::reset();
+    TEST_CHECK(zone_b.stats.count == 0 && zone_b.paths_size == 0);
+    TEST_CHECK(report(true).find('\n') == report(true).size() - 1);
+}
+
+/**
+ * A zone entered on another thread while this one is inside a does not become a child of a
+ */
+static void test_threads(void)
+{
+    profiler::reset();
+    {
+        profiler::scope s(zone_a);
+        std::thread t([]() {
+            TEST_CHECK(profiler::current_path() == nullptr);
+            profiler::scope sb(zone_b);
+            profiler::scope sc(zone_c);
+        });
+        t.join();
+        profiler::scope sc(zone_c);
+    }
+
+    const profiler::path_t *a = find_path(zone_a, nullptr);
+    const profiler::path_t *b = find_path(zone_b, nullptr);
+    TEST_CHECK(zone_b.paths_size == 1 && b != nullptr);
+    TEST_CHECK(zone_c.paths_size == 2 && find_path(zone_c, a) != nullptr && find_path(zone_c, b) != nullptr);
+    profiler::reset();
+}
+
+/**
+ * Entries under more parents than the zone has paths for are only counted in the flat report,
+ * with the zones entered inside them
+ */
+static void test_unattributed(void)
+{
+    profiler::reset();
+    for (size_t ix = 0; ix < EI_PROFILER_MAX_PARENTS + 1; ix++) {
+        profiler::scope sp(zone_parents[ix]);
+        profiler::scope sx(zone_x);
+        profiler::scope sc(zone_c);
+    }
+
+    TEST_CHECK(zone_x.paths_size == EI_PROFILER_MAX_PARENTS && zone_x.stats.count == EI_PROFILER_MAX_PARENTS + 1);
+    TEST_CHECK(zone_x.unattributed == 1 && zone_c.unattributed == 1);
+    TEST_CHECK(zone_c.paths_size == EI_PROFILER_MAX_PARENTS && zone_c.stats.count == EI_PROFILER_MAX_PARENTS + 1);
+    TEST_CHECK(report(true).find("2 entries under more than") != std::string::npos);
+    profiler::reset();
+}
+
+static int get_slice_data(size_t offset, size_t length, float *out_ptr)
+{
+    memcpy(out_ptr, slice_samples.data() + offset, length * sizeof(float));
+    return 0;
+}
+
+/**
+ * Zone entries against a continuous KWS slice: the Linux build with --profiler enters four
+ * zones per MFCC frame (framing, preemphasis, fft, filterbank) and about ten per stage
+ * (dsp.slice, log, dct, cmvn, quantize, inference, nn.invoke, ...), that has to stay
+ * under 10% of the slice
+ */
+static void test_overhead(void)
+{
+    std::mt19937 rng(47);
+    std::normal_distribution<float> noise(0.f, 2000.f);
+    slice_samples.resize(slice_size);
+
+    signal_t signal;
+    signal.total_length = slice_size;
+    signal.get_data = &get_slice_data;
+    ei_impulse_result_t result = { 0 };
+
+    run_classifier_init();
+    const int slices = 40;
+    double slice_us = 0;
+    for (int ix = 0; ix < slices; ix++) {
+        for (float &sample : slice_samples) {
+            sample = roundf(noise(rng));
+        }
+        double start = now_us();
+        TEST_CHECK(run_classifier_continuous(&signal, &result, false) == EI_IMPULSE_OK);
+        // the first window only fills the feature buffer
+        if (ix >= EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW) {
+            slice_us += now_us() - start;
+        }
+    }
+    slice_us /= slices - EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+    run_classifier_deinit();
+
+    const ei_dsp_config_mfcc_t *mfcc = (const ei_dsp_config_mfcc_t *)ei_default_impulse.impulse->dsp_blocks[0].config;
+    const double frames = ceil((double)slice_size / (mfcc->frame_stride * ei_default_impulse.impulse->frequency));
+    const double entries = 4 * frames + 10;
+
+    // nested like the per-frame zones, the best of a few runs
+    const int reps = 100000;
+    double entry_us = 1e9;
+    profiler::reset();
+    for (int run = 0; run < 5; run++) {
+        profiler::scope s(zone_a);
+        double start = now_us();
+        for (int ix = 0; ix < reps; ix++) {
+            profiler::scope se(zone_empty);
+        }
+        entry_us = std::min(entry_us, (now_us() - start) / reps);
+    }
+    TEST_CHECK(zone_empty.stats.count == 5 * reps && zone_empty.paths_size == 1);
+    profiler::reset();
+
+    const double overhead = entries * entry_us / slice_us;
+    TEST_CHECK_MSG(overhead < 0.1, "%.0f entries of %.3f us per %.1f us slice", entries, entry_us, slice_us);
+    printf("profiler: %.0f ns per zone entry, %.0f entries per %.1f us KWS slice (%.2f%%)\n",
+        entry_us * 1000, entries, slice_us, 100 * overhead);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_tree();
+    test_threads();
+    test_unattributed();
+    test_overhead();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,338 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string.h>
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_quantize.h"
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    float scale;
+    int32_t zero_point;
+    bool is_signed;
+} quantize_case_t;
+
+/* Private variables ------------------------------------------------------- */
+static const size_t block_size = 4099;
+
+// input tensors of typical int8 / uint8 models
+static const quantize_case_t typical_cases[] = {
+    { 0.003921568859368563f, -128, true },
+    { 0.0235f, 3, true },
+    { 0.1f, 128, false },
+};
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float float_from_bits(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * pre_cast_quantize() where it is defined, otherwise what the kernels document:
+ * saturate large values, NaN maps to the (clamped) zero point
+ */
+static int32_t expected_quantize(const ei_quantize_params_t *params, float value)
+{
+    if (value != value) {
+        return std::min(std::max(params->zero_point, params->min_value), params->max_value);
+    }
+    float quotient = value / params->scale;
+    if (!std::isfinite(quotient) || fabsf(quotient) >= 2.0e9f) {
+        return value > 0 ? params->max_value : params->min_value;
+    }
+    return pre_cast_quantize(value, params->scale, params->zero_point, params->is_signed);
+}
+
+/**
+ * Run one block through every lane width and ei_quantize_one(), count the
+ * values where any of them differs from the expected result
+ */
+template <typename T>
+static size_t check_block(const ei_quantize_params_t *params, const float *in, size_t n, const char *label)
+{
+    static T out1[block_size], out4[block_size], out8[block_size], out_api[block_size];
+    static size_t reported = 0;
+
+    ei::quantize::block_impl<T, false, 1>(in, NULL, NULL, out1, n, params);
+    ei::quantize::block_impl<T, false, 4>(in, NULL, NULL, out4, n, params);
+    ei::quantize::block_impl<T, false, 8>(in, NULL, NULL, out8, n, params);
+    ei_quantize_block(in, out_api, n, params);
+
+    size_t mismatches = 0;
+    for (size_t ix = 0; ix < n; ix++) {
+        int32_t expected = expected_quantize(params, in[ix]);
+        if (out1[ix] != expected || out4[ix] != expected || out8[ix] != expected
+            || out_api[ix] != expected || ei_quantize_one(params, in[ix]) != expected) {
+            if (reported < 10) {
+                printf("%s: scale %.9g zero point %d, %.9g: %d / %d / %d / %d, expected %d\n",
+                    label, params->scale, (int)params->zero_point, in[ix],
+                    (int)out1[ix], (int)out4[ix], (int)out8[ix], (int)out_api[ix], (int)expected);
+                reported++;
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static size_t check_values(const ei_quantize_params_t *params, const float *in, size_t n, const char *label)
+{
+    return params->is_signed ? check_block<int8_t>(params, in, n, label)
+                             : check_block<uint8_t>(params, in, n, label);
+}
+
+/**
+ * Every stride-th float bit pattern (NaN, inf and denormals included)
+ */
+static size_t sweep_bit_patterns(const ei_quantize_params_t *params, uint32_t stride, size_t *compared)
+{
+    static float in[block_size];
+    size_t mismatches = 0;
+    uint64_t bits = 0;
+
+    while (bits <= 0xffffffffull) {
+        size_t n = 0;
+        for (; n < block_size && bits <= 0xffffffffull; n++, bits += stride) {
+            in[n] = float_from_bits((uint32_t)bits);
+        }
+        mismatches += check_values(params, in, n, "sweep");
+        *compared += n;
+    }
+    return mismatches;
+}
+
+/**
+ * 40 floats on each side of every decision boundary
+ */
+static size_t sweep_thresholds(const ei_quantize_params_t *params, size_t *compared)
+{
+    std::vector<float> in;
+
+    for (int k = 1; k < 256; k++) {
+        float below = params->thresholds[k], above = params->thresholds[k];
+        in.push_back(below);
+        for (int step = 0; step < 40; step++) {
+            below = std::nextafter(below, -INFINITY);
+            above = std::nextafter(above, INFINITY);
+            in.push_back(below);
+            in.push_back(above);
+        }
+    }
+
+    size_t mismatches = 0;
+    for (size_t pos = 0; pos < in.size(); pos += block_size) {
+        size_t n = std::min(block_size, in.size() - pos);
+        mismatches += check_values(params, in.data() + pos, n, "threshold");
+        *compared += n;
+    }
+    return mismatches;
+}
+
+/**
+ * The typical parameters at a fine stride, random ones (scale 2e-9 to 2e4) at a
+ * coarse stride plus the values around each of their boundaries
+ */
+static void test_bit_exact(void)
+{
+    size_t compared = 0, mismatches = 0;
+    ei_quantize_params_t params;
+
+    for (const quantize_case_t &c : typical_cases) {
+        ei_quantize_init_params(&params, c.scale, c.zero_point, c.is_signed);
+        TEST_CHECK(params.exact);
+        mismatches += sweep_bit_patterns(&params, 251, &compared);
+        mismatches += sweep_thresholds(&params, &compared);
+    }
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> log_scale(-20.0f, 10.0f);
+    for (int ix = 0; ix < 60; ix++) {
+        bool is_signed = rng() & 1;
+        float scale = std::exp(log_scale(rng));
+        int32_t zero_point = (int32_t)(rng() % 256) - (is_signed ? 128 : 0);
+        ei_quantize_init_params(&params, scale, zero_point, is_signed);
+        TEST_CHECK_MSG(params.exact, "scale %.9g zero point %d", scale, (int)zero_point);
+        mismatches += sweep_bit_patterns(&params, 65521, &compared);
+        mismatches += sweep_thresholds(&params, &compared);
+    }
+
+    TEST_CHECK_MSG(mismatches == 0, "%zu of %zu values differ", mismatches, compared);
+    printf("quantize: %zu values compared with pre_cast_quantize\n", compared);
+}
+
+/**
+ * Scales the fast path can't use fall back to pre_cast_quantize()
+ */
+static void test_inexact_params(void)
+{
+    const float values[] = { -3.0f, -0.4f, 0.0f, 0.26f, 1.0f, 1000.0f };
+    ei_quantize_params_t params;
+    int8_t out[6];
+
+    for (float scale : { 0.0f, -0.5f, (float)INFINITY }) {
+        ei_quantize_init_params(&params, scale, 4, true);
+        TEST_CHECK(!params.exact);
+        ei_quantize_block(values, out, 6, &params);
+        for (int ix = 0; ix < 6; ix++) {
+            TEST_CHECK(out[ix] == (int8_t)pre_cast_quantize(values[ix], scale, 4, true));
+        }
+    }
+
+    ei_quantize_init_params(&params, 0.1f, 2000, false);
+    TEST_CHECK(!params.exact);
+}
+
+/**
+ * Fused normalize + quantize against the standard scaler followed by pre_cast_quantize()
+ */
+static void test_normalized(void)
+{
+    const size_t n = 1003;
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> input(-50.0f, 50.0f), mean(-5.0f, 5.0f), mul(0.01f, 3.0f);
+    std::vector<float> x(n), m(n), k(n);
+    std::vector<int8_t> out_signed(n);
+    std::vector<uint8_t> out_unsigned(n);
+
+    for (size_t ix = 0; ix < n; ix++) {
+        x[ix] = input(rng);
+        m[ix] = mean(rng);
+        k[ix] = mul(rng);
+    }
+
+    ei_quantize_block_normalized(x.data(), m.data(), k.data(), out_signed.data(), n,
+        ei_quantize_get_params(0.07f, -5, true));
+    ei_quantize_block_normalized(x.data(), m.data(), k.data(), out_unsigned.data(), n,
+        ei_quantize_get_params(0.4f, 130, false));
+
+    size_t mismatches = 0;
+    for (size_t ix = 0; ix < n; ix++) {
+        float y = x[ix] - m[ix];
+        y = y * k[ix];
+        mismatches += out_signed[ix] != pre_cast_quantize(y, 0.07f, -5, true);
+        mismatches += out_unsigned[ix] != pre_cast_quantize(y, 0.4f, 130, false);
+    }
+    TEST_CHECK_MSG(mismatches == 0, "%zu of %zu values differ", mismatches, 2 * n);
+}
+
+static void test_dequantize(void)
+{
+    int8_t in_signed[256];
+    uint8_t in_unsigned[256];
+    float out_signed[256], out_unsigned[256];
+
+    for (int ix = 0; ix < 256; ix++) {
+        in_signed[ix] = (int8_t)(ix - 128);
+        in_unsigned[ix] = (uint8_t)ix;
+    }
+    ei_dequantize_block(in_signed, out_signed, 256, 0.00390625f, -128.0f);
+    ei_dequantize_block(in_unsigned, out_unsigned, 256, 0.0123f, 7.0f);
+
+    for (int ix = 0; ix < 256; ix++) {
+        TEST_CHECK(out_signed[ix] == static_cast<float>(in_signed[ix] - -128.0f) * 0.00390625f);
+        TEST_CHECK(out_unsigned[ix] == static_cast<float>(in_unsigned[ix] - 7.0f) * 0.0123f);
+    }
+}
+
+/**
+ * 4096 elements per call, the timings are printed (not checked)
+ */
+static void benchmark(void)
+{
+    const size_t n = 4096;
+    const float scale = 0.0078125f * 1.1f;
+    const int32_t zero_point = 3;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> input(-1.5f, 1.5f);
+    std::vector<float> x(n);
+    std::vector<int8_t> out(n);
+
+    for (size_t ix = 0; ix < n; ix++) {
+        x[ix] = input(rng);
+    }
+
+    double start = now_us();
+    ei_quantize_params_t params;
+    ei_quantize_init_params(&params, scale, zero_point, true);
+    double init_us = now_us() - start;
+
+    double reference_us = 1e9, kernel_us = 1e9;
+    volatile int sink = 0;
+    for (int rep = 0; rep < 200; rep++) {
+        double t0 = now_us();
+        for (size_t ix = 0; ix < n; ix++) {
+            out[ix] = (int8_t)pre_cast_quantize(x[ix], scale, zero_point, true);
+        }
+        double t1 = now_us();
+        sink += out[rep];
+        ei_quantize_block(x.data(), out.data(), n, &params);
+        double t2 = now_us();
+        sink += out[rep];
+        reference_us = std::min(reference_us, t1 - t0);
+        kernel_us = std::min(kernel_us, t2 - t1);
+    }
+
+    printf("quantize: %zu elements %.1f us (pre_cast_quantize %.1f us), params init %.1f us\n",
+        n, kernel_us, reference_us, init_us);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_bit_exact();
+    test_inexact_params();
+    test_normalized();
+    test_dequantize();
+    benchmark();
+
+    return TEST_RESULT();
+}
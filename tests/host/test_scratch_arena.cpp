@@ -0,0 +1,273 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+
+#include <random>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace ei;
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    size_t heap_peak;
+    size_t dsp_peak;
+    size_t nn_peak;
+    std::vector<float> scores;
+} classifier_run_t;
+
+/* Private variables ------------------------------------------------------- */
+static const size_t heap_header = 16;
+static size_t heap_in_use = 0;
+static size_t heap_peak = 0;
+
+static uint8_t arena[1024] __attribute__((aligned(16)));
+static uint8_t tiny_arena[8] __attribute__((aligned(16)));
+
+/* Function prototypes ----------------------------------------------------- */
+extern "C" EI_IMPULSE_ERROR run_classifier(signal_t *signal, ei_impulse_result_t *result, bool debug);
+extern "C" EI_IMPULSE_ERROR run_classifier_continuous(signal_t *signal, ei_impulse_result_t *result, bool debug,
+    bool enable_maf_unused);
+extern "C" void run_classifier_init(void);
+extern "C" void run_classifier_deinit(void);
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * The porting layer allocators are weak, these count the bytes in use
+ */
+void *ei_malloc(size_t size)
+{
+    uint8_t *ptr = (uint8_t *)malloc(size + heap_header);
+    if (!ptr) {
+        return NULL;
+    }
+    memcpy(ptr, &size, sizeof(size));
+    heap_in_use += size;
+    if (heap_in_use > heap_peak) {
+        heap_peak = heap_in_use;
+    }
+    return ptr + heap_header;
+}
+
+void *ei_calloc(size_t nitems, size_t size)
+{
+    if (size != 0 && nitems > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = ei_malloc(nitems * size);
+    if (ptr) {
+        memset(ptr, 0, nitems * size);
+    }
+    return ptr;
+}
+
+void ei_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    uint8_t *block = (uint8_t *)ptr - heap_header;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    heap_in_use -= size;
+    free(block);
+}
+
+/* Private functions ------------------------------------------------------- */
+static void test_stack_semantics(void)
+{
+    TEST_CHECK(ei::scratch_arena::attach(arena, sizeof(arena)) == ei::EIDSP_OK);
+    TEST_CHECK(ei::scratch_arena::attach(arena, sizeof(arena)) != ei::EIDSP_OK);
+
+    // nothing is handed out outside of a scope
+    TEST_CHECK(ei::scratch_arena::alloc(16) == NULL);
+
+    ei::scratch_arena::mark_t outer = ei::scratch_arena::mark();
+    void *a = ei::scratch_arena::alloc(100);
+    void *b = ei::scratch_arena::alloc(30);
+    TEST_CHECK(a && b && ei::scratch_arena::owns(a) && ei::scratch_arena::owns(b));
+    TEST_CHECK(((uintptr_t)a & 7) == 0 && ((uintptr_t)b & 7) == 0);
+    size_t in_use = ei::scratch_arena::get_in_use();
+
+    // only the top block can be freed
+    TEST_CHECK(!ei::scratch_arena::dealloc(a));
+    TEST_CHECK(!ei::scratch_arena::dealloc((uint8_t *)b + 8));
+    TEST_CHECK(ei::scratch_arena::get_in_use() == in_use);
+    TEST_CHECK(ei::scratch_arena::dealloc(b));
+    TEST_CHECK(!ei::scratch_arena::dealloc(b));
+    TEST_CHECK(ei::scratch_arena::dealloc(a));
+    TEST_CHECK(ei::scratch_arena::get_in_use() == 0);
+
+    // a nested scope gives back everything above its mark, out of order frees included
+    a = ei::scratch_arena::alloc(64);
+    ei::scratch_arena::mark_t inner = ei::scratch_arena::mark();
+    b = ei::scratch_arena::alloc(64);
+    void *c = ei::scratch_arena::alloc(64);
+    ei::scratch_arena::dsp_free(b);
+    TEST_CHECK(ei::scratch_arena::alloc(64) != b);
+    ei::scratch_arena::release(inner);
+    TEST_CHECK(ei::scratch_arena::alloc(64) == b);
+    (void)c;
+
+    // too large, overflowing and zero sized requests
+    TEST_CHECK(ei::scratch_arena::alloc(sizeof(arena)) == NULL);
+    TEST_CHECK(ei::scratch_arena::alloc(SIZE_MAX - 4) == NULL);
+    TEST_CHECK(ei::scratch_arena::alloc(0) == NULL);
+    TEST_CHECK(ei::scratch_arena::dsp_calloc(SIZE_MAX / 2, 4) == NULL);
+    TEST_CHECK(ei::scratch_arena::dsp_calloc((SIZE_MAX / 8) + 1, 8) == NULL);
+
+    // the heap takes what does not fit, and gets it back
+    size_t heap_before = heap_in_use;
+    void *large = ei::scratch_arena::dsp_calloc(512, 4);
+    TEST_CHECK(large && !ei::scratch_arena::owns(large) && heap_in_use == heap_before + 2048);
+    ei::scratch_arena::dsp_free(large);
+    TEST_CHECK(heap_in_use == heap_before);
+
+    // the NN can't claim the arena while DSP scratch is alive
+    TEST_CHECK(ei::scratch_arena::claim(256) == NULL);
+    ei::scratch_arena::release(outer);
+    TEST_CHECK(ei::scratch_arena::get_in_use() == 0);
+
+    void *nn = ei::scratch_arena::claim(sizeof(arena));
+    TEST_CHECK(nn == arena);
+    TEST_CHECK(ei::scratch_arena::claim(16) == NULL);
+    ei::scratch_arena::mark_t during_nn = ei::scratch_arena::mark();
+    TEST_CHECK(ei::scratch_arena::alloc(16) == NULL);
+    ei::scratch_arena::release(during_nn);
+    TEST_CHECK(ei::scratch_arena::unclaim(nn));
+    TEST_CHECK(!ei::scratch_arena::unclaim(nn));
+
+    TEST_CHECK(ei::scratch_arena::detach() == arena);
+    TEST_CHECK(!ei::scratch_arena::is_attached());
+}
+
+/**
+ * A tone over noise, loud enough to go through the whole KWS impulse
+ */
+static std::vector<float> test_audio(size_t length)
+{
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 300.0f);
+    std::vector<float> audio(length);
+    for (size_t ix = 0; ix < length; ix++) {
+        audio[ix] = roundf(4000.0f * sinf(ix * 0.11f) * sinf(ix * 0.0007f) + noise(rng));
+    }
+    return audio;
+}
+
+/**
+ * Three one-shot windows and a window of continuous slices, the heap peak and scores
+ */
+static classifier_run_t run_impulse(const std::vector<float> &audio)
+{
+    classifier_run_t run;
+    ei_impulse_result_t result;
+    signal_t signal;
+
+    heap_peak = heap_in_use;
+    ei::scratch_arena::reset_peak_use();
+    size_t heap_start = heap_in_use;
+
+    for (size_t offset : { 0, 4000, 9000 }) {
+        memset(&result, 0, sizeof(result));
+        ei::numpy::signal_from_buffer(audio.data() + offset, EI_CLASSIFIER_RAW_SAMPLE_COUNT, &signal);
+        TEST_CHECK(run_classifier(&signal, &result, false) == EI_IMPULSE_OK);
+        for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+            run.scores.push_back(result.classification[ix].value);
+        }
+    }
+
+    run_classifier_init();
+    for (size_t offset = 0; offset + EI_CLASSIFIER_SLICE_SIZE <= audio.size(); offset += EI_CLASSIFIER_SLICE_SIZE) {
+        memset(&result, 0, sizeof(result));
+        ei::numpy::signal_from_buffer(audio.data() + offset, EI_CLASSIFIER_SLICE_SIZE, &signal);
+        TEST_CHECK(run_classifier_continuous(&signal, &result, false, true) == EI_IMPULSE_OK);
+        for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+            run.scores.push_back(result.classification[ix].value);
+        }
+    }
+    run_classifier_deinit();
+
+    run.heap_peak = heap_peak - heap_start;
+    run.dsp_peak = ei::scratch_arena::get_dsp_peak_use();
+    run.nn_peak = ei::scratch_arena::get_nn_peak_use();
+    return run;
+}
+
+/**
+ * The same windows with everything on the heap (an arena too small for anything is
+ * attached) and with the shared arena: identical scores, lower heap peak + arena
+ */
+static void test_shared_arena_peak(void)
+{
+    std::vector<float> audio = test_audio(EI_CLASSIFIER_RAW_SAMPLE_COUNT * 2);
+
+    TEST_CHECK(ei::scratch_arena::attach(tiny_arena, sizeof(tiny_arena)) == ei::EIDSP_OK);
+    classifier_run_t heap_only = run_impulse(audio);
+    TEST_CHECK(heap_only.dsp_peak == 0 && heap_only.nn_peak == 0);
+
+    // run_classifier_deinit detached it, the next run attaches the impulse arena
+    TEST_CHECK(!ei::scratch_arena::is_attached());
+    classifier_run_t shared = run_impulse(audio);
+
+    TEST_CHECK(heap_only.scores.size() == shared.scores.size());
+    TEST_CHECK(memcmp(heap_only.scores.data(), shared.scores.data(), heap_only.scores.size() * sizeof(float)) == 0);
+    TEST_CHECK(shared.dsp_peak > 0 && shared.dsp_peak <= EI_CLASSIFIER_SCRATCH_ARENA_SIZE);
+    TEST_CHECK(shared.nn_peak > 0 && shared.nn_peak <= EI_CLASSIFIER_SCRATCH_ARENA_SIZE);
+
+    size_t heap_only_total = heap_only.heap_peak;
+    size_t shared_total = shared.heap_peak + EI_CLASSIFIER_SCRATCH_ARENA_SIZE;
+    TEST_CHECK_MSG(shared_total < heap_only_total, "%zu vs %zu bytes", shared_total, heap_only_total);
+
+    printf("scratch arena: heap only %zu bytes peak (NN arena included), shared arena %zu + %d bytes peak "
+        "(DSP scratch %zu bytes in the arena)\n",
+        heap_only_total, shared.heap_peak, (int)EI_CLASSIFIER_SCRATCH_ARENA_SIZE, shared.dsp_peak);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_stack_semantics();
+    test_shared_arena_peak();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,170 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+
+// a small buffer and a short stall timeout, so the test runs in a moment
+#define EI_SERIAL_TX_BUFFER_SIZE        64
+#define EI_SERIAL_TX_CHUNK_SIZE         16
+#define EI_SERIAL_TX_STALL_TIMEOUT_MS   20
+#include "firmware-sdk/ei_serial_tx.cpp"
+
+#include <unistd.h>
+#include <vector>
+
+/* Private variables ------------------------------------------------------- */
+// bytes the sink takes per write call, 0 while it is stalled
+static size_t sink_rate;
+static std::vector<uint8_t> sink_data;
+
+/* Private functions ------------------------------------------------------- */
+static size_t sink_write(const uint8_t *data, size_t length)
+{
+    size_t n = std::min(length, sink_rate);
+    sink_data.insert(sink_data.end(), data, data + n);
+    return n;
+}
+
+/**
+ * There is no drain thread, a waiting writer drains itself
+ */
+static void sink_wait(void)
+{
+    usleep(1000);
+    ei_serial_tx_drain();
+}
+
+static const ei_serial_tx_port_t port = { sink_write, nullptr, nullptr, nullptr, sink_wait };
+
+static uint64_t elapsed_ms(uint64_t start_us)
+{
+    return (ei_read_timer_us() - start_us) / 1000;
+}
+
+static void start(size_t rate)
+{
+    ei_serial_tx_init(&port);
+    ei_serial_tx_start();
+    ei_serial_tx_set_policy(EI_SERIAL_TX_BLOCK);
+    sink_rate = rate;
+    sink_data.clear();
+}
+
+/**
+ * A blocked write gives up on a stalled sink and counts what it dropped,
+ * later writes are dropped right away until the sink takes data again
+ */
+static void test_stalled_sink(void)
+{
+    uint8_t data[100];
+    ei_serial_tx_stats_t stats;
+
+    for (size_t ix = 0; ix < sizeof(data); ix++) {
+        data[ix] = (uint8_t)ix;
+    }
+
+    start(0);
+
+    // fills the buffer, the rest waits for the timeout
+    uint64_t start_us = ei_read_timer_us();
+    TEST_CHECK(ei_serial_tx_write(data, 80) == 64);
+    TEST_CHECK(elapsed_ms(start_us) >= EI_SERIAL_TX_STALL_TIMEOUT_MS);
+    ei_serial_tx_get_stats(&stats);
+    TEST_CHECK(stats.timeouts == 1);
+    TEST_CHECK(stats.dropped == 16);
+    TEST_CHECK(stats.queued == 64);
+
+    // no more waiting while the sink is stalled
+    start_us = ei_read_timer_us();
+    TEST_CHECK(ei_serial_tx_write(data, 10) == 0);
+    TEST_CHECK(elapsed_ms(start_us) < EI_SERIAL_TX_STALL_TIMEOUT_MS);
+    ei_serial_tx_get_stats(&stats);
+    TEST_CHECK(stats.timeouts == 1);
+    TEST_CHECK(stats.dropped == 26);
+
+    // the flush is bounded too
+    start_us = ei_read_timer_us();
+    TEST_CHECK(!ei_serial_tx_flush());
+    TEST_CHECK(elapsed_ms(start_us) >= EI_SERIAL_TX_STALL_TIMEOUT_MS);
+    ei_serial_tx_get_stats(&stats);
+    TEST_CHECK(stats.timeouts == 2);
+
+    // the sink is back: the queued bytes go out and writes block again
+    sink_rate = 16;
+    ei_serial_tx_drain();
+    TEST_CHECK(ei_serial_tx_write(data, 100) == 100);
+    TEST_CHECK(ei_serial_tx_flush());
+    ei_serial_tx_get_stats(&stats);
+    TEST_CHECK(stats.timeouts == 2);
+    TEST_CHECK(stats.dropped == 26);
+    TEST_CHECK(sink_data.size() == 164);
+    TEST_CHECK(memcmp(sink_data.data(), data, 64) == 0);
+    TEST_CHECK(memcmp(sink_data.data() + 64, data, 100) == 0);
+}
+
+/**
+ * A slow sink that keeps taking data never times out, however long the write takes
+ */
+static void test_slow_sink(void)
+{
+    uint8_t data[200];
+    ei_serial_tx_stats_t stats;
+
+    for (size_t ix = 0; ix < sizeof(data); ix++) {
+        data[ix] = (uint8_t)(ix * 7);
+    }
+
+    start(1);
+
+    uint64_t start_us = ei_read_timer_us();
+    TEST_CHECK(ei_serial_tx_write(data, sizeof(data)) == sizeof(data));
+    TEST_CHECK(ei_serial_tx_flush());
+    TEST_CHECK(elapsed_ms(start_us) > EI_SERIAL_TX_STALL_TIMEOUT_MS);
+
+    ei_serial_tx_get_stats(&stats);
+    TEST_CHECK(stats.timeouts == 0);
+    TEST_CHECK(stats.dropped == 0);
+    TEST_CHECK(sink_data.size() == sizeof(data));
+    TEST_CHECK(memcmp(sink_data.data(), data, sizeof(data)) == 0);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_stalled_sink();
+    test_slow_sink();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,245 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/spectral/streaming.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string.h>
+#include <vector>
+
+using namespace ei;
+
+/* Private variables ------------------------------------------------------- */
+static const int num_axes = 3;
+static const float frequency = 100.0f;
+
+static const size_t window_sizes[] = { 200, 256, 400 };
+// window increase as a fraction of the window
+static const float slice_ratios[] = { 0.25f, 1.0f / 3.0f, 0.5f };
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static ei_dsp_config_spectral_analysis_t spectral_config(uint16_t version, int fft_length, bool do_log,
+    bool do_fft_overlap, const char *filter_type, int filter_order)
+{
+    ei_dsp_config_spectral_analysis_t config = { 1, version, num_axes, 1.0f, 1, filter_type, 8.0f, filter_order,
+        "FFT", fft_length, 3, 0.1f, "", do_log, do_fft_overlap, 1, "", false };
+    return config;
+}
+
+/**
+ * A noisy sine, a square wave and gravity with a little noise, interleaved
+ */
+static std::vector<float> test_signal(std::mt19937 &rng, size_t frames)
+{
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> signal(frames * num_axes);
+    for (size_t ix = 0; ix < frames; ix++) {
+        signal[ix * num_axes + 0] = 2.0f * sinf(ix * 0.31f) + 0.3f * noise(rng);
+        signal[ix * num_axes + 1] = (ix % 23 < 11) ? 1.5f : -1.5f;
+        signal[ix * num_axes + 2] = 9.81f + 0.05f * noise(rng);
+    }
+    return signal;
+}
+
+/**
+ * The one-shot features of a window (the extraction works in place, so on a copy)
+ */
+static int one_shot(ei_dsp_config_spectral_analysis_t *config, const float *window, size_t frames,
+    std::vector<float> &features)
+{
+    std::vector<float> input(window, window + frames * num_axes);
+    matrix_t input_matrix(frames, num_axes, input.data());
+    matrix_t output_matrix(1, features.size(), features.data());
+    if (config->implementation_version == 4) {
+        return spectral::feature::extract_spectral_analysis_features_v4(&input_matrix, &output_matrix, config, frequency);
+    }
+    return spectral::feature::extract_spectral_analysis_features_v2(&input_matrix, &output_matrix, config, frequency);
+}
+
+static size_t feature_count(ei_dsp_config_spectral_analysis_t *config)
+{
+    size_t num_bins = config->fft_length / 2;
+    if (config->filter_order && strcmp(config->filter_type, "none") != 0) {
+        size_t start_bin, stop_bin;
+        spectral::feature::get_start_stop_bin(frequency, config->fft_length, config->filter_cutoff,
+            &start_bin, &stop_bin, strcmp(config->filter_type, "high") == 0);
+        num_bins = stop_bin - start_bin;
+    }
+    return num_axes * (3 + (config->implementation_version == 4 ? 2 : 0) + num_bins);
+}
+
+/**
+ * Streams the signal slice by slice and compares every window against the one-shot
+ * extraction over the same frames. Returns the worst relative difference.
+ */
+static float stream_vs_batch(ei_dsp_config_spectral_analysis_t *config, const std::vector<float> &signal,
+    size_t window_frames, size_t slice_frames, double *stream_us, double *batch_us, size_t *windows)
+{
+    const size_t total_frames = signal.size() / num_axes;
+    const size_t num_features = feature_count(config);
+    std::vector<float> streamed(num_features), expected(num_features);
+    matrix_t streamed_matrix(1, num_features, streamed.data());
+    float worst = 0.0f;
+
+    spectral::feature_stream stream;
+    TEST_CHECK(stream.configure(config, window_frames, frequency) == EIDSP_OK);
+
+    for (size_t end = slice_frames; end <= total_frames; end += slice_frames) {
+        const float *slice = signal.data() + (end - slice_frames) * num_axes;
+        const float *window = signal.data() + (end - std::min(end, window_frames)) * num_axes;
+
+        double start = now_us();
+        TEST_CHECK(stream.push(slice, slice_frames) == EIDSP_OK);
+        if (!stream.window_full()) {
+            TEST_CHECK(end < window_frames);
+            continue;
+        }
+        int ret = stream.incremental() ?
+            stream.extract(&streamed_matrix) : one_shot(config, stream.window(), window_frames, streamed);
+        double middle = now_us();
+        int expected_ret = one_shot(config, window, window_frames, expected);
+        double stop = now_us();
+
+        TEST_CHECK(ret == EIDSP_OK && expected_ret == EIDSP_OK);
+        *stream_us += middle - start;
+        *batch_us += stop - middle;
+        (*windows)++;
+
+        if (!stream.incremental()) {
+            // the raw window goes through the same one-shot extraction
+            TEST_CHECK(memcmp(streamed.data(), expected.data(), num_features * sizeof(float)) == 0);
+            continue;
+        }
+        for (size_t ix = 0; ix < num_features; ix++) {
+            worst = std::max(worst, fabsf(streamed[ix] - expected[ix]) / std::max(1.0f, fabsf(expected[ix])));
+        }
+    }
+    return worst;
+}
+
+/**
+ * Incremental configs (v2/v3/v4, FFT 16-128, overlap and log on and off) against the
+ * one-shot extraction, for 25, 33 and 50% window increases
+ */
+static void test_incremental(std::mt19937 &rng)
+{
+    std::vector<float> signal = test_signal(rng, 1600);
+
+    for (uint16_t version : { 2, 3, 4 }) {
+        for (int fft_length : { 16, 64, 128 }) {
+            for (int options = 0; options < 4; options++) {
+                ei_dsp_config_spectral_analysis_t config = spectral_config(version, fft_length,
+                    options & 1, options & 2, "none", 0);
+                for (size_t window_frames : window_sizes) {
+                    for (float ratio : slice_ratios) {
+                        const size_t slice_frames = (size_t)lroundf(window_frames * ratio);
+                        double stream_us = 0, batch_us = 0;
+                        size_t windows = 0;
+                        float worst = stream_vs_batch(&config, signal, window_frames, slice_frames,
+                            &stream_us, &batch_us, &windows);
+                        TEST_CHECK(windows > 0);
+                        TEST_CHECK_MSG(worst <= 5e-3f, "v%u fft %d log %d overlap %d, window %zu slice %zu: %g off",
+                            version, fft_length, options & 1, (options & 2) != 0, window_frames, slice_frames,
+                            (double)worst);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Filtered configs restart the filter every window, the stream keeps the raw window
+ * and the one-shot extraction over it is bit identical
+ */
+static void test_raw_window(std::mt19937 &rng)
+{
+    std::vector<float> signal = test_signal(rng, 1000);
+
+    for (const char *filter_type : { "low", "high" }) {
+        ei_dsp_config_spectral_analysis_t config = spectral_config(4, 64, true, true, filter_type, 6);
+        spectral::feature_stream stream;
+        TEST_CHECK(stream.configure(&config, 200, frequency) == EIDSP_OK);
+        TEST_CHECK(!stream.incremental());
+
+        double stream_us = 0, batch_us = 0;
+        size_t windows = 0;
+        stream_vs_batch(&config, signal, 200, 50, &stream_us, &batch_us, &windows);
+        TEST_CHECK(windows > 0);
+    }
+}
+
+/**
+ * Per-slice cost of the stream against recomputing the window, printed (not checked)
+ */
+static void benchmark(std::mt19937 &rng)
+{
+    std::vector<float> signal = test_signal(rng, 4000);
+
+    for (size_t window_frames : { (size_t)256, (size_t)400 }) {
+        for (float ratio : slice_ratios) {
+            const size_t slice_frames = (size_t)lroundf(window_frames * ratio);
+            ei_dsp_config_spectral_analysis_t config = spectral_config(4, 64, true, true, "none", 0);
+            double stream_us = 0, batch_us = 0;
+            size_t windows = 0;
+            stream_vs_batch(&config, signal, window_frames, slice_frames, &stream_us, &batch_us, &windows);
+            printf("spectral streaming: window %zu, slice %3zu (%2d%%): %6.1f us per slice (full window %6.1f us)\n",
+                window_frames, slice_frames, (int)lroundf(ratio * 100), stream_us / windows, batch_us / windows);
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    std::mt19937 rng(36);
+
+    test_incremental(rng);
+    test_raw_window(rng);
+
+    benchmark(rng);
+
+    return TEST_RESULT();
+}
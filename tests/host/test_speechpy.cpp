@@ -0,0 +1,347 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/speechpy/speechpy.hpp"
+#include "speechpy_reference.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string.h>
+#include <vector>
+
+using namespace ei;
+
+/* Private types ----------------------------------------------------------- */
+/**
+ * An int16 audio signal that counts the samples pulled from it
+ */
+struct AudioSource {
+    std::vector<float> samples;
+    size_t samples_read = 0;
+    signal_t signal;
+
+    explicit AudioSource(std::vector<float> data) : samples(std::move(data))
+    {
+        signal.total_length = samples.size();
+        signal.get_data = [this](size_t offset, size_t length, float *out_ptr) {
+            memcpy(out_ptr, samples.data() + offset, length * sizeof(float));
+            samples_read += length;
+            return 0;
+        };
+    }
+};
+
+/**
+ * A preemphasized view on an AudioSource, the way ei_run_dsp wraps the signal
+ */
+template <typename Preemphasis>
+struct Preemphasized {
+    Preemphasis pre;
+    signal_t signal;
+
+    Preemphasized(AudioSource &source, bool rescale) : pre(&source.signal, 1, 0.98f, rescale)
+    {
+        signal.total_length = source.signal.total_length;
+        signal.get_data = [this](size_t offset, size_t length, float *out_ptr) {
+            return pre.get_data(offset, length, out_ptr);
+        };
+    }
+};
+
+typedef Preemphasized<class speechpy::processing::preemphasis> Current;
+typedef Preemphasized<class speechpy_reference::processing::preemphasis> Reference;
+
+/* Private variables ------------------------------------------------------- */
+static const uint32_t frequency = 16000;
+static const uint16_t fft_length = 256;
+static const uint16_t num_filters = 32;
+static const uint16_t num_cepstral = 13;
+
+// a continuous inferencing slice (within the preemphasis working buffer), a one second
+// window, and one that ends in a partial frame
+static const size_t signal_lengths[] = { EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES, 16000, 19000 };
+// frame length and stride in seconds: overlapping, adjacent and with gaps between frames
+static const float frame_configs[][2] = {
+    { 0.02f, 0.01f }, { 0.025f, 0.01f }, { 0.032f, 0.016f }, { 0.02f, 0.02f }, { 0.016f, 0.02f }
+};
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Noise and a sweep, int16 values as the microphone delivers them
+ */
+static std::vector<float> test_audio(std::mt19937 &rng, size_t length)
+{
+    std::uniform_int_distribution<int> noise(-600, 600);
+    std::vector<float> audio(length);
+    for (size_t ix = 0; ix < length; ix++) {
+        float sweep = 12000.0f * sinf(0.0005f * ix * ix / (float)length * 400.0f);
+        audio[ix] = (float)(int)(sweep + noise(rng));
+    }
+    return audio;
+}
+
+static bool same_bits(const std::vector<float> &a, const std::vector<float> &b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+/**
+ * Frame offsets and the preemphasized samples of every frame, against the frame
+ * start indices and the lazy preemphasis of the reference
+ */
+static void test_frames(const std::vector<float> &audio, float frame_length, float frame_stride, uint16_t version)
+{
+    AudioSource source(audio), reference_source(audio);
+    Current current(source, false);
+    Reference reference(reference_source, false);
+
+    speechpy::stack_frames_info_t info = { 0 };
+    info.signal = &current.signal;
+    speechpy_reference::stack_frames_info_t reference_info;
+    reference_info.signal = &reference.signal;
+
+    int ret = speechpy::processing::stack_frames(&info, frequency, frame_length, frame_stride, false, version);
+    int reference_ret = speechpy_reference::processing::stack_frames(
+        &reference_info, frequency, frame_length, frame_stride, false, version);
+    TEST_CHECK(ret == reference_ret);
+    if (ret != EIDSP_OK) {
+        return;
+    }
+    TEST_CHECK_MSG(info.frame_count == reference_info.frame_ixs.size(), "v%u, %zu samples: %zu vs %zu frames",
+        version, audio.size(), info.frame_count, reference_info.frame_ixs.size());
+    TEST_CHECK(info.frame_length == reference_info.frame_length);
+    TEST_CHECK(info.frame_count == (size_t)speechpy::processing::calculate_no_of_stack_frames(
+        audio.size(), frequency, frame_length, frame_stride, false, version));
+
+    std::vector<float> frame(info.frame_length), reference_frame(info.frame_length);
+    size_t mismatches = 0;
+    for (size_t ix = 0; ix < info.frame_count && ix < reference_info.frame_ixs.size(); ix++) {
+        size_t offset = ix * info.frame_stride;
+        TEST_CHECK(offset == reference_info.frame_ixs[ix]);
+        size_t length = std::min((size_t)info.frame_length, audio.size() - std::min(audio.size(), offset));
+        if (length == 0) {
+            continue;
+        }
+        frame.assign(info.frame_length, 0.0f);
+        reference_frame.assign(info.frame_length, 0.0f);
+        TEST_CHECK(current.signal.get_data(offset, length, frame.data()) == EIDSP_OK);
+        TEST_CHECK(reference.signal.get_data(offset, length, reference_frame.data()) == EIDSP_OK);
+        mismatches += !same_bits(frame, reference_frame);
+    }
+    TEST_CHECK_MSG(mismatches == 0, "v%u, %zu samples, frame %g / %g: %zu frames differ",
+        version, audio.size(), (double)frame_length, (double)frame_stride, mismatches);
+}
+
+/**
+ * MFE (both implementations), spectrogram and MFCC features of one signal. Everything
+ * but MFCC is compared bit for bit; the MFCC DCT only computes the kept coefficients
+ * now, so those are compared within float rounding.
+ */
+static void test_features(const std::vector<float> &audio, float frame_length, float frame_stride, uint16_t version)
+{
+    const size_t rows = speechpy::processing::calculate_no_of_stack_frames(
+        audio.size(), frequency, frame_length, frame_stride, false, version);
+    const char *names[] = { "mfe", "mfe_v3", "spectrogram", "mfcc" };
+
+    for (int feature = 0; feature < 4; feature++) {
+        const size_t cols = feature == 2 ? fft_length / 2 + 1 : feature == 3 ? num_cepstral : num_filters;
+        std::vector<float> out(rows * cols, 0.0f), expected(rows * cols, 0.0f);
+        matrix_t out_matrix(rows, cols, out.data());
+        matrix_t expected_matrix(rows, cols, expected.data());
+
+        AudioSource source(audio), reference_source(audio);
+        // the MFCC block keeps the int16 range, MFE and spectrogram rescale
+        Current current(source, feature != 3);
+        Reference reference(reference_source, feature != 3);
+
+        int ret = -1, reference_ret = -1;
+        switch (feature) {
+            case 0:
+                ret = speechpy::feature::mfe(&out_matrix, nullptr, &current.signal, frequency,
+                    frame_length, frame_stride, num_filters, fft_length, 0, 0, version);
+                reference_ret = speechpy_reference::feature::mfe(&expected_matrix, nullptr, &reference.signal,
+                    frequency, frame_length, frame_stride, num_filters, fft_length, 0, 0, version);
+                break;
+            case 1:
+                ret = speechpy::feature::mfe_v3(&out_matrix, nullptr, &current.signal, frequency,
+                    frame_length, frame_stride, num_filters, fft_length, 0, 0, version);
+                reference_ret = speechpy_reference::feature::mfe_v3(&expected_matrix, nullptr, &reference.signal,
+                    frequency, frame_length, frame_stride, num_filters, fft_length, 0, 0, version);
+                break;
+            case 2:
+                ret = speechpy::feature::spectrogram(&out_matrix, &current.signal, frequency,
+                    frame_length, frame_stride, fft_length, version);
+                reference_ret = speechpy_reference::feature::spectrogram(&expected_matrix, &reference.signal,
+                    frequency, frame_length, frame_stride, fft_length, version);
+                break;
+            case 3:
+                ret = speechpy::feature::mfcc(&out_matrix, &current.signal, frequency, frame_length,
+                    frame_stride, num_cepstral, num_filters, fft_length, 0, 0, true, version);
+                reference_ret = speechpy_reference::feature::mfcc(&expected_matrix, &reference.signal,
+                    frequency, frame_length, frame_stride, num_cepstral, num_filters, fft_length, 0, 0, true, version);
+                break;
+        }
+
+        TEST_CHECK_MSG(ret == reference_ret, "%s v%u: %d vs %d", names[feature], version, ret, reference_ret);
+        if (feature < 3) {
+            TEST_CHECK_MSG(same_bits(out, expected), "%s v%u, %zu samples, frame %g / %g: not bit exact",
+                names[feature], version, audio.size(), (double)frame_length, (double)frame_stride);
+        }
+        else {
+            float worst = 0.0f;
+            for (size_t ix = 0; ix < out.size(); ix++) {
+                worst = std::max(worst, fabsf(out[ix] - expected[ix]) / std::max(1.0f, fabsf(expected[ix])));
+            }
+            TEST_CHECK_MSG(worst <= 1e-4f, "mfcc v%u, %zu samples: %g off", version, audio.size(), (double)worst);
+        }
+
+        // a signal within the working buffer is read from the source once, plus the
+        // sample before it
+        if (audio.size() <= EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES) {
+            TEST_CHECK_MSG(source.samples_read <= audio.size() + 1, "%s v%u: %zu samples read for %zu",
+                names[feature], version, source.samples_read, audio.size());
+        }
+    }
+}
+
+/**
+ * Frames requested out of order and of different lengths, from the working buffer
+ * and (for a signal that does not hold int16 values) from the lazy path
+ */
+static void test_out_of_order(std::mt19937 &rng)
+{
+    for (bool int16_values : { true, false }) {
+        std::vector<float> audio = test_audio(rng, EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES);
+        if (!int16_values) {
+            for (size_t ix = 0; ix < audio.size(); ix += 7) {
+                audio[ix] += 0.25f;
+            }
+        }
+        AudioSource source(audio), reference_source(audio);
+        Current current(source, true);
+        Reference reference(reference_source, true);
+
+        const size_t end = audio.size();
+        const size_t requests[][2] = { { 1000, 400 }, { 800, 400 }, { 0, 400 }, { end - 400, 400 },
+            { end / 2, 640 }, { 1, 17 }, { end - 1, 1 } };
+        for (auto &request : requests) {
+            std::vector<float> frame(request[1]), reference_frame(request[1]);
+            TEST_CHECK(current.signal.get_data(request[0], request[1], frame.data()) == EIDSP_OK);
+            TEST_CHECK(reference.signal.get_data(request[0], request[1], reference_frame.data()) == EIDSP_OK);
+            TEST_CHECK_MSG(same_bits(frame, reference_frame), "%zu samples at %zu differ", request[1], request[0]);
+        }
+        std::vector<float> frame(400);
+        TEST_CHECK(current.signal.get_data(end - 399, 400, frame.data()) == EIDSP_OUT_OF_BOUNDS);
+
+        // the working buffer reads the signal once, up front
+        if (int16_values) {
+            TEST_CHECK(source.samples_read == audio.size() + 1);
+        }
+    }
+}
+
+/**
+ * MFE v4 on a continuous inferencing slice (buffered) and on a one second window
+ * (lazy), printed (not checked)
+ */
+static void benchmark(std::mt19937 &rng)
+{
+    const int rounds = 20;
+
+    for (size_t length : { (size_t)EIDSP_PREEMPHASIS_MAX_BUFFERED_SAMPLES, (size_t)16000 }) {
+        std::vector<float> audio = test_audio(rng, length);
+        const size_t rows = speechpy::processing::calculate_no_of_stack_frames(
+            audio.size(), frequency, 0.02f, 0.01f, false, 4);
+        std::vector<float> out(rows * num_filters);
+        matrix_t out_matrix(rows, num_filters, out.data());
+
+        double current_us = 0, reference_us = 0;
+        size_t current_read = 0, reference_read = 0;
+        for (int round = 0; round < rounds; round++) {
+            AudioSource source(audio), reference_source(audio);
+            double start = now_us();
+            {
+                Current current(source, true);
+                speechpy::feature::mfe_v3(&out_matrix, nullptr, &current.signal, frequency,
+                    0.02f, 0.01f, num_filters, fft_length, 0, 0, 4);
+            }
+            double middle = now_us();
+            {
+                Reference reference(reference_source, true);
+                speechpy_reference::feature::mfe_v3(&out_matrix, nullptr, &reference.signal, frequency,
+                    0.02f, 0.01f, num_filters, fft_length, 0, 0, 4);
+            }
+            double end = now_us();
+            current_us += middle - start;
+            reference_us += end - middle;
+            current_read = source.samples_read;
+            reference_read = reference_source.samples_read;
+        }
+
+        printf("speechpy: mfe v4, %5zu samples, 20 / 10 ms frames: %7.1f us, %5zu samples read "
+            "(reference %7.1f us, %5zu samples read)\n", length, current_us / rounds, current_read,
+            reference_us / rounds, reference_read);
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    std::mt19937 rng(35);
+
+    for (size_t length : signal_lengths) {
+        std::vector<float> audio = test_audio(rng, length);
+        for (auto &frame : frame_configs) {
+            for (uint16_t version = 1; version <= 4; version++) {
+                test_frames(audio, frame[0], frame[1], version);
+                test_features(audio, frame[0], frame[1], version);
+            }
+        }
+    }
+    test_out_of_order(rng);
+
+    benchmark(rng);
+
+    return TEST_RESULT();
+}
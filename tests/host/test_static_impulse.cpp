@@ -0,0 +1,320 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+#include <chrono>
+#include <random>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if EI_CLASSIFIER_STATIC_IMPULSE != 1
+#error "test_static_impulse needs EI_CLASSIFIER_STATIC_IMPULSE=1 (linux-build.sh)"
+#endif
+
+using namespace ei;
+
+/* Private types ----------------------------------------------------------- */
+typedef ei_dsp_static_config_44_12 static_config_t;
+typedef ei_dsp_static_44_12 static_mfcc_t;
+
+/* Private variables ------------------------------------------------------- */
+static const size_t heap_header = 16;
+static size_t heap_in_use = 0;
+static size_t heap_peak = 0;
+
+static const size_t window_size = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+static const size_t slice_size = EI_CLASSIFIER_SLICE_SIZE;
+static const size_t features_size = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE;
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * The porting layer allocators are weak, these count the bytes the generic
+ * blocks have in use (no scratch arena is attached, all DSP scratch is heap)
+ */
+void *ei_malloc(size_t size)
+{
+    uint8_t *ptr = (uint8_t *)malloc(size + heap_header);
+    if (!ptr) {
+        return NULL;
+    }
+    memcpy(ptr, &size, sizeof(size));
+    heap_in_use += size;
+    if (heap_in_use > heap_peak) {
+        heap_peak = heap_in_use;
+    }
+    return ptr + heap_header;
+}
+
+void *ei_calloc(size_t nitems, size_t size)
+{
+    if (size != 0 && nitems > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = ei_malloc(nitems * size);
+    if (ptr) {
+        memset(ptr, 0, nitems * size);
+    }
+    return ptr;
+}
+
+void ei_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    uint8_t *block = (uint8_t *)ptr - heap_header;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    heap_in_use -= size;
+    free(block);
+}
+
+// the SDK prints to stdout, the device port (ei_device_linux.cpp) stays out of the test
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    printf("%.6f", f);
+}
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Noise, silence, a tone and a clipped square wave, in the int16 range of the microphone
+ */
+static std::vector<std::vector<float>> test_signals(size_t length)
+{
+    std::mt19937 rng(44);
+    std::normal_distribution<float> noise(0.f, 2000.f);
+    std::vector<std::vector<float>> signals(4, std::vector<float>(length));
+    for (size_t ix = 0; ix < length; ix++) {
+        signals[0][ix] = roundf(noise(rng));
+        signals[1][ix] = 0.f;
+        signals[2][ix] = roundf(8000.f * sinf((float)ix * 0.07f)) + roundf(noise(rng) * 0.01f);
+        signals[3][ix] = ((ix / 37) % 2) ? 32767.f : -32768.f;
+    }
+    return signals;
+}
+
+/**
+ * Start run_classifier_continuous() over, the per slice functions keep the
+ * frame that spans two slices in ei_run_dsp.h
+ */
+static void reset_continuous_state(void)
+{
+    ei_free(ei_dsp_cont_current_frame);
+    ei_dsp_cont_current_frame = nullptr;
+    ei_dsp_cont_current_frame_ix = 0;
+}
+
+static void test_tables(void)
+{
+    // the block in the impulse is the specialized one, the table finds its entry points
+    TEST_CHECK(ei_dsp_blocks[0].extract_fn == &static_mfcc_t::extract);
+    const ei_static_dsp_fns_t *fns = ei_static_dsp_find(ei_static_dsp_fns, ei_static_dsp_fns_size, &static_mfcc_t::extract);
+    TEST_CHECK(fns && fns->extract_per_slice_fn == &static_mfcc_t::extract_per_slice && fns->cmvn_fn == &static_mfcc_t::cmvn);
+    TEST_CHECK(ei_static_dsp_find(ei_static_dsp_fns, ei_static_dsp_fns_size, &extract_mfcc_features) == nullptr);
+
+    // the generated config is the one in model_variables.h
+    TEST_CHECK(static_config_t::num_cepstral == ei_dsp_config_44_12.num_cepstral);
+    TEST_CHECK(static_config_t::num_filters == ei_dsp_config_44_12.num_filters);
+    TEST_CHECK(static_config_t::fft_length == ei_dsp_config_44_12.fft_length);
+    TEST_CHECK(static_config_t::win_size == ei_dsp_config_44_12.win_size);
+    TEST_CHECK(static_config_t::frame_length == ei_dsp_config_44_12.frame_length);
+    TEST_CHECK(static_config_t::frame_stride == ei_dsp_config_44_12.frame_stride);
+    TEST_CHECK(static_config_t::pre_cof == ei_dsp_config_44_12.pre_cof);
+    TEST_CHECK(static_config_t::pre_shift == ei_dsp_config_44_12.pre_shift);
+    TEST_CHECK(static_config_t::max_frames * static_config_t::num_cepstral == features_size);
+}
+
+static void test_extract(void)
+{
+    for (std::vector<float> &samples : test_signals(window_size)) {
+        signal_t signal;
+        numpy::signal_from_buffer(samples.data(), samples.size(), &signal);
+
+        std::vector<float> generic(features_size), specialized(features_size);
+        matrix_t generic_matrix(1, features_size, generic.data());
+        matrix_t static_matrix(1, features_size, specialized.data());
+
+        TEST_CHECK(extract_mfcc_features(&signal, &generic_matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY) == EIDSP_OK);
+        TEST_CHECK(static_mfcc_t::extract(&signal, &static_matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY) == EIDSP_OK);
+        TEST_CHECK(static_matrix.rows == generic_matrix.rows && static_matrix.cols == generic_matrix.cols);
+        TEST_CHECK(memcmp(generic.data(), specialized.data(), features_size * sizeof(float)) == 0);
+    }
+}
+
+/**
+ * Slices in, feature window (before and after cmvn) out, as run_classifier_continuous()
+ * does it for one block
+ */
+static std::vector<std::vector<float>> run_slices(const std::vector<float> &samples,
+    int (*extract_per_slice)(signal_t *, matrix_t *, void *, const float, matrix_size_t *),
+    void (*cmvn)(matrix_t *, void *))
+{
+    std::vector<std::vector<float>> windows;
+    std::vector<float> features(features_size);
+
+    reset_continuous_state();
+    for (size_t offset = 0; offset + slice_size <= samples.size(); offset += slice_size) {
+        signal_t signal;
+        numpy::signal_from_buffer(samples.data() + offset, slice_size, &signal);
+        matrix_t matrix(1, features_size, features.data());
+        matrix_size_t written;
+        TEST_CHECK(extract_per_slice(&signal, &matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY, &written) == EIDSP_OK);
+        windows.push_back(features);
+
+        std::vector<float> normalized(features);
+        matrix_t normalized_matrix(1, features_size, normalized.data());
+        cmvn(&normalized_matrix, &ei_dsp_config_44_12);
+        TEST_CHECK(normalized_matrix.rows == 1 && normalized_matrix.cols == features_size);
+        windows.push_back(normalized);
+    }
+    reset_continuous_state();
+    return windows;
+}
+
+static void test_continuous(void)
+{
+    for (std::vector<float> &samples : test_signals(window_size * 2 + slice_size)) {
+        std::vector<std::vector<float>> generic = run_slices(samples,
+            &extract_mfcc_per_slice_features, &calc_cepstral_mean_and_var_normalization_mfcc);
+        std::vector<std::vector<float>> specialized = run_slices(samples,
+            &static_mfcc_t::extract_per_slice, &static_mfcc_t::cmvn);
+
+        TEST_CHECK(generic.size() == specialized.size() && !generic.empty());
+        for (size_t ix = 0; ix < generic.size() && ix < specialized.size(); ix++) {
+            TEST_CHECK_MSG(memcmp(generic[ix].data(), specialized[ix].data(), features_size * sizeof(float)) == 0,
+                "slice %zu (%s)", ix / 2, ix % 2 ? "cmvn" : "features");
+        }
+    }
+}
+
+/**
+ * RAM / flash of the two modes (printed, not checked): the generic block allocates its
+ * scratch on every run, the static one keeps it in .bss and its tables in .rodata,
+ * only the FFT work buffers still come from the heap
+ */
+static void test_memory(void)
+{
+    std::vector<float> samples = test_signals(window_size)[0];
+    signal_t signal;
+    numpy::signal_from_buffer(samples.data(), samples.size(), &signal);
+    std::vector<float> features(features_size);
+    matrix_t matrix(1, features_size, features.data());
+
+    numpy::release_dct2_plans();
+    heap_in_use = 0;
+    heap_peak = 0;
+    TEST_CHECK(extract_mfcc_features(&signal, &matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY) == EIDSP_OK);
+    size_t generic_peak = heap_peak;
+    size_t generic_kept = heap_in_use; // the cached DCT plan
+
+    matrix = matrix_t(1, features_size, features.data());
+    heap_in_use = 0;
+    heap_peak = 0;
+    TEST_CHECK(static_mfcc_t::extract(&signal, &matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY) == EIDSP_OK);
+    size_t static_peak = heap_peak;
+    numpy::release_dct2_plans();
+
+    // what is left on the heap is the FFT of every frame (numpy::rfft)
+    TEST_CHECK_MSG(static_peak < generic_peak, "%zu vs %zu bytes", static_peak, generic_peak);
+
+    const size_t C = static_config_t::num_cepstral;
+    size_t bss = sizeof(float) * (static_config_t::frame_length_samples + static_mfcc_t::power_spectrum_size +
+        static_config_t::max_frames * static_config_t::num_filters + static_config_t::max_frames +
+        (static_config_t::max_frames + static_mfcc_t::cmvn_pad * 2) * C + C * 2 + static_config_t::pre_shift * 2);
+    size_t rodata = sizeof(ei_dsp_static_44_12_mel_bins) + sizeof(ei_dsp_static_44_12_mel_weights) +
+        sizeof(ei_dsp_static_44_12_dct_basis);
+
+    printf("static impulse: generic MFCC %zu bytes heap peak (%zu kept for the DCT plan), "
+        "static MFCC %zu bytes .bss + %zu bytes .rodata tables, %zu bytes heap peak\n",
+        generic_peak, generic_kept, bss, rodata, static_peak);
+}
+
+static void benchmark(void)
+{
+    std::vector<float> samples = test_signals(window_size)[0];
+    signal_t signal;
+    numpy::signal_from_buffer(samples.data(), samples.size(), &signal);
+    std::vector<float> features(features_size);
+    const int reps = 50;
+
+    double start = now_us();
+    for (int run = 0; run < reps; run++) {
+        matrix_t matrix(1, features_size, features.data());
+        extract_mfcc_features(&signal, &matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY);
+    }
+    double generic_us = (now_us() - start) / reps;
+
+    start = now_us();
+    for (int run = 0; run < reps; run++) {
+        matrix_t matrix(1, features_size, features.data());
+        static_mfcc_t::extract(&signal, &matrix, &ei_dsp_config_44_12, EI_CLASSIFIER_FREQUENCY);
+    }
+    double static_us = (now_us() - start) / reps;
+    numpy::release_dct2_plans();
+
+    printf("static impulse: MFCC window %.1f us generic, %.1f us static\n", generic_us, static_us);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_tables();
+    test_extract();
+    test_continuous();
+    test_memory();
+    benchmark();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,260 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "firmware-sdk/ei_telemetry.h"
+
+#include <chrono>
+#include <random>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if EI_CLASSIFIER_TELEMETRY != 1
+#error "test_telemetry needs EI_CLASSIFIER_TELEMETRY=1 (linux-build.sh)"
+#endif
+
+using namespace ei;
+
+/* Private variables ------------------------------------------------------- */
+static const size_t slice_size = EI_CLASSIFIER_SLICE_SIZE;
+static std::vector<float> slice_samples;
+
+/* Public functions -------------------------------------------------------- */
+
+// the SDK prints to stdout, the device port (ei_device_linux.cpp) stays out of the test
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void ei_printf_float(float f)
+{
+    printf("%.6f", f);
+}
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int get_slice_data(size_t offset, size_t length, float *out_ptr)
+{
+    memcpy(out_ptr, slice_samples.data() + offset, length * sizeof(float));
+    return 0;
+}
+
+static void record(uint32_t dsp_us, uint32_t classification_us, uint32_t total_us, int error)
+{
+    uint32_t stage_us[EI_TELEMETRY_STAGE_COUNT] = { 0 };
+    stage_us[EI_TELEMETRY_STAGE_DSP] = dsp_us;
+    stage_us[EI_TELEMETRY_STAGE_CLASSIFICATION] = classification_us;
+    stage_us[EI_TELEMETRY_STAGE_TOTAL] = total_us;
+    ei_telemetry_record(stage_us, error, false);
+}
+
+static uint32_t bucket_total(const ei_telemetry_histogram_t *hist)
+{
+    uint32_t total = 0;
+    for (size_t ix = 0; ix < EI_TELEMETRY_HIST_BUCKETS; ix++) {
+        total += hist->buckets[ix];
+    }
+    return total;
+}
+
+static void test_histograms(void)
+{
+    ei_telemetry_reset();
+    for (uint32_t us = 1; us <= 1000; us++) {
+        record(us, 2 * us, 3 * us + 5, 0);
+    }
+
+    const ei_telemetry_histogram_t *dsp = ei_telemetry_get_histogram(EI_TELEMETRY_STAGE_DSP);
+    const ei_telemetry_histogram_t *total = ei_telemetry_get_histogram(EI_TELEMETRY_STAGE_TOTAL);
+    TEST_CHECK(dsp->count == 1000 && dsp->min_us == 1 && dsp->max_us == 1000 && dsp->sum_us == 500500);
+    TEST_CHECK(total->count == 1000 && total->min_us == 8 && total->max_us == 3005);
+    TEST_CHECK(bucket_total(dsp) == 1000 && bucket_total(total) == 1000);
+    // stages that never took time are left out
+    TEST_CHECK(ei_telemetry_get_histogram(EI_TELEMETRY_STAGE_ANOMALY)->count == 0);
+    TEST_CHECK(ei_telemetry_percentile(EI_TELEMETRY_STAGE_ANOMALY, 990) == 0);
+
+    // the estimate is the upper edge of the bucket, at most 25% above the exact value
+    const uint32_t per_mille[] = { 500, 900, 990 };
+    for (uint32_t pm : per_mille) {
+        uint32_t p = ei_telemetry_percentile(EI_TELEMETRY_STAGE_DSP, pm);
+        TEST_CHECK_MSG(p >= pm && p <= pm + pm / 4 && p <= 1000, "p%u: %u us", pm / 10, p);
+    }
+    TEST_CHECK(ei_telemetry_percentile(EI_TELEMETRY_STAGE_DSP, 1000) == 1000);
+    TEST_CHECK(ei_telemetry_percentile(EI_TELEMETRY_STAGE_DSP, 0) == 1);
+
+    // slowest first, the most recent runs were the slowest ones
+    ei_telemetry_slow_entry_t entries[EI_TELEMETRY_SLOWEST_SIZE];
+    size_t n = ei_telemetry_get_slowest(entries, EI_TELEMETRY_SLOWEST_SIZE);
+    TEST_CHECK(n == EI_TELEMETRY_SLOWEST_SIZE);
+    for (size_t ix = 0; ix < n; ix++) {
+        TEST_CHECK(entries[ix].sequence == 1000 - ix);
+        TEST_CHECK(entries[ix].stage_us[EI_TELEMETRY_STAGE_TOTAL] == 3 * (1000 - ix) + 5);
+    }
+
+    // a slow run older than EI_TELEMETRY_SLOWEST_MAX_AGE gives way to a faster recent one
+    for (uint32_t ix = 0; ix < EI_TELEMETRY_SLOWEST_MAX_AGE + 1; ix++) {
+        record(1, 1, 9, 0);
+    }
+    n = ei_telemetry_get_slowest(entries, EI_TELEMETRY_SLOWEST_SIZE);
+    TEST_CHECK(n == EI_TELEMETRY_SLOWEST_SIZE && entries[n - 1].stage_us[EI_TELEMETRY_STAGE_TOTAL] == 9);
+
+    ei_telemetry_reset();
+    TEST_CHECK(ei_telemetry_get_histogram(EI_TELEMETRY_STAGE_TOTAL)->count == 0);
+    TEST_CHECK(ei_telemetry_get_slowest(entries, EI_TELEMETRY_SLOWEST_SIZE) == 0);
+}
+
+static void test_counters(void)
+{
+    ei_telemetry_reset();
+    ei_telemetry_count(EI_TELEMETRY_SKIPPED_SLICES, 3);
+    ei_telemetry_count(EI_TELEMETRY_AUDIO_OVERRUNS);
+
+    ei_impulse_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.timing.dsp_us = 120;
+    ei_telemetry_record_inference(&result, EI_IMPULSE_ALLOC_FAILED, true, 150);
+
+    TEST_CHECK(ei_telemetry_get_counter(EI_TELEMETRY_SKIPPED_SLICES) == 3);
+    TEST_CHECK(ei_telemetry_get_counter(EI_TELEMETRY_AUDIO_OVERRUNS) == 1);
+    TEST_CHECK(ei_telemetry_get_counter(EI_TELEMETRY_ALLOC_FAILURES) == 1);
+
+    // the slow entry keeps the counters of that moment
+    ei_telemetry_slow_entry_t entry;
+    TEST_CHECK(ei_telemetry_get_slowest(&entry, 1) == 1);
+    TEST_CHECK(entry.skipped_slices == 3 && entry.audio_overruns == 1);
+    TEST_CHECK(entry.error == EI_IMPULSE_ALLOC_FAILED && entry.continuous);
+    TEST_CHECK(entry.stage_us[EI_TELEMETRY_STAGE_DSP] == 120 && entry.stage_us[EI_TELEMETRY_STAGE_TOTAL] == 150);
+
+    ei_telemetry_reset();
+    TEST_CHECK(ei_telemetry_get_counter(EI_TELEMETRY_SKIPPED_SLICES) == 0);
+}
+
+static void append_text(const char *text, void *ctx)
+{
+    ((std::string *)ctx)->append(text);
+}
+
+static void test_json(void)
+{
+    ei_telemetry_reset();
+    record(100, 200, 310, 0);
+    record(150, 250, 420, 0);
+
+    std::string json;
+    ei_telemetry_print_json(&append_text, &json);
+
+    TEST_CHECK(json.rfind("{\"inferences\":2,\"errors\":0,", 0) == 0);
+    TEST_CHECK(json.size() > 2 && json.compare(json.size() - 3, 3, "]}\n") == 0);
+    TEST_CHECK(json.find("\"dsp\":{\"count\":2,\"min_us\":100,\"avg_us\":125,\"max_us\":150,") != std::string::npos);
+    TEST_CHECK(json.find("\"anomaly\":{\"count\":0,") != std::string::npos);
+    TEST_CHECK(json.find("\"total_us\":420") != std::string::npos);
+
+    int depth = 0;
+    for (char c : json) {
+        depth += (c == '{' || c == '[') ? 1 : (c == '}' || c == ']') ? -1 : 0;
+        TEST_CHECK(depth >= 0);
+    }
+    TEST_CHECK(depth == 0);
+    ei_telemetry_reset();
+}
+
+/**
+ * Recording against a continuous KWS slice (DSP, NN and the recording itself): the
+ * telemetry has to stay under 1% of the inference time
+ */
+static void test_overhead(void)
+{
+    std::mt19937 rng(46);
+    std::normal_distribution<float> noise(0.f, 2000.f);
+    slice_samples.resize(slice_size);
+
+    signal_t signal;
+    signal.total_length = slice_size;
+    signal.get_data = &get_slice_data;
+    ei_impulse_result_t result = { 0 };
+
+    run_classifier_init();
+    const int slices = 40;
+    double slice_us = 0;
+    for (int ix = 0; ix < slices; ix++) {
+        for (float &sample : slice_samples) {
+            sample = roundf(noise(rng));
+        }
+        double start = now_us();
+        TEST_CHECK(run_classifier_continuous(&signal, &result, false) == EI_IMPULSE_OK);
+        // the first window only fills the feature buffer
+        if (ix >= EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW) {
+            slice_us += now_us() - start;
+        }
+    }
+    slice_us /= slices - EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+    run_classifier_deinit();
+
+    const int reps = 100000;
+    double start = now_us();
+    for (int ix = 0; ix < reps; ix++) {
+        ei_telemetry_record_inference(&result, EI_IMPULSE_OK, true, (uint64_t)slice_us + (ix & 63));
+    }
+    double record_us = (now_us() - start) / reps;
+    ei_telemetry_reset();
+
+    TEST_CHECK_MSG(record_us < slice_us / 100, "%.3f us per record, %.1f us per slice", record_us, slice_us);
+    printf("telemetry: %.0f ns per record, %.1f us per KWS slice (%.3f%%)\n",
+        record_us * 1000, slice_us, 100 * record_us / slice_us);
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_histograms();
+    test_counters();
+    test_json();
+    test_overhead();
+
+    return TEST_RESULT();
+}
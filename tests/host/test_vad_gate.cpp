@@ -0,0 +1,135 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "ingestion-sdk-c/ei_vad_gate.h"
+#include <string.h>
+
+/* Private variables ------------------------------------------------------- */
+static int16_t silence[4000];
+static int16_t speech[4000];
+
+/* Private functions ------------------------------------------------------- */
+static void test_keyword_labels(void)
+{
+    ei_vad_gate_t gate;
+    ei_vad_gate_config_t config;
+    ei_vad_gate_default_config(&config);
+    ei_vad_gate_init(&gate, &config);
+
+    TEST_CHECK(ei_vad_gate_is_keyword(&gate, "yes"));
+    TEST_CHECK(ei_vad_gate_is_keyword(&gate, "noisy"));
+    TEST_CHECK(!ei_vad_gate_is_keyword(&gate, "noise"));
+    TEST_CHECK(!ei_vad_gate_is_keyword(&gate, "unknown"));
+    TEST_CHECK(!ei_vad_gate_is_keyword(&gate, "_background"));
+    TEST_CHECK(!ei_vad_gate_is_keyword(&gate, nullptr));
+
+    config.non_keyword_labels = "background,silence*";
+    ei_vad_gate_init(&gate, &config);
+    TEST_CHECK(ei_vad_gate_is_keyword(&gate, "noise"));
+    TEST_CHECK(!ei_vad_gate_is_keyword(&gate, "background"));
+    TEST_CHECK(ei_vad_gate_is_keyword(&gate, "back"));
+    TEST_CHECK(!ei_vad_gate_is_keyword(&gate, "silence_2"));
+
+    config.non_keyword_labels = "";
+    ei_vad_gate_init(&gate, &config);
+    TEST_CHECK(ei_vad_gate_is_keyword(&gate, "noise"));
+}
+
+static void test_audit_window(void)
+{
+    ei_vad_gate_t gate;
+    ei_vad_gate_config_t config;
+    ei_vad_gate_default_config(&config);
+    config.hangover_slices = 4;
+    config.audit_interval = 10;
+    ei_vad_gate_init(&gate, &config);
+
+    // the gate starts open for the hangover, then skips audit_interval - 1 slices
+    int run = 0;
+    for (int ix = 0; ix < 4; ix++) {
+        run += ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0]));
+        TEST_CHECK(!gate.resumed);
+    }
+    TEST_CHECK(run == 4);
+    for (int ix = 0; ix < 9; ix++) {
+        TEST_CHECK(!ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0])));
+    }
+
+    // an audit classifies a full hangover window, the first slice resumes after the gap
+    for (int ix = 0; ix < 4; ix++) {
+        TEST_CHECK(ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0])));
+        TEST_CHECK(gate.audit);
+        TEST_CHECK(gate.resumed == (ix == 0));
+    }
+    TEST_CHECK(!ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0])));
+    TEST_CHECK(gate.stats.audited_slices == 4);
+
+    // speech opens the gate and resumes processing
+    TEST_CHECK(ei_vad_gate_process(&gate, speech, sizeof(speech) / sizeof(speech[0])));
+    TEST_CHECK(!gate.audit);
+    TEST_CHECK(gate.resumed);
+    TEST_CHECK(ei_vad_gate_process(&gate, speech, sizeof(speech) / sizeof(speech[0])));
+    TEST_CHECK(!gate.resumed);
+
+    // a keyword in an audit counts as a missed trigger and keeps the gate open
+    ei_vad_gate_init(&gate, &config);
+    for (int ix = 0; ix < 13; ix++) {
+        ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0]));
+    }
+    TEST_CHECK(ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0])));
+    TEST_CHECK(gate.audit);
+    ei_vad_gate_report(&gate, 0, true);
+    TEST_CHECK(gate.stats.missed_triggers == 1);
+    for (int ix = 0; ix < 4; ix++) {
+        TEST_CHECK(ei_vad_gate_process(&gate, silence, sizeof(silence) / sizeof(silence[0])));
+        TEST_CHECK(!gate.audit);
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    // low level noise, and a tone well above it
+    for (size_t ix = 0; ix < sizeof(silence) / sizeof(silence[0]); ix++) {
+        silence[ix] = (int16_t)(((ix * 7919) % 17) - 8);
+        speech[ix] = (int16_t)(4000.0 * sin((double)ix * 0.2));
+    }
+
+    test_keyword_labels();
+    test_audit_window();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,277 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/dsp/spectral/wavelet.hpp"
+#include "wavelet_reference.h"
+
+#include <chrono>
+#include <random>
+#include <string.h>
+#include <vector>
+
+using namespace ei;
+
+/* Private variables ------------------------------------------------------- */
+static const char *families[] = {
+    "bior1.3", "bior1.5", "bior2.2", "bior2.4", "bior2.6", "bior2.8", "bior3.1", "bior3.3", "bior3.5",
+    "bior3.7", "bior3.9", "bior4.4", "bior5.5", "bior6.8", "coif1", "coif2", "coif3", "db2", "db3",
+    "db4", "db5", "db6", "db7", "db8", "db9", "db10", "haar", "rbio1.3", "rbio1.5", "rbio2.2",
+    "rbio2.4", "rbio2.6", "rbio2.8", "rbio3.1", "rbio3.3", "rbio3.5", "rbio3.7", "rbio3.9", "rbio4.4",
+    "rbio5.5", "rbio6.8", "sym2", "sym3", "sym4", "sym5", "sym6", "sym7", "sym8", "sym9", "sym10"
+};
+
+static const int num_axes = 3;
+static const size_t features_per_level = 14;
+
+/* Private functions ------------------------------------------------------- */
+static double now_us(void)
+{
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static ei_dsp_config_spectral_analysis_t wavelet_config(const char *wavelet, int level, const char *filter_type)
+{
+    ei_dsp_config_spectral_analysis_t config = { 1, 4, num_axes, 1.0f, 1, filter_type, 3.0f, 4, "Wavelet",
+        64, 3, 0.1f, "", false, false, level, wavelet, false };
+    return config;
+}
+
+/**
+ * A noisy sine, a square wave and a small signal on an offset, interleaved
+ */
+static std::vector<float> test_signal(std::mt19937 &rng, int length)
+{
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> signal(length * num_axes);
+    for (int ix = 0; ix < length; ix++) {
+        signal[ix * num_axes + 0] = sinf(ix * 0.07f) + 0.2f * noise(rng);
+        signal[ix * num_axes + 1] = (ix % 17 < 8) ? 1.0f : -1.0f;
+        signal[ix * num_axes + 2] = 0.001f * noise(rng) + 3.0f;
+    }
+    return signal;
+}
+
+/**
+ * Features of both implementations, the input is consumed so each gets a copy
+ */
+static void extract_both(ei_dsp_config_spectral_analysis_t *config, const std::vector<float> &signal,
+    std::vector<float> &expected, std::vector<float> &actual, double *reference_us, double *wavelet_us)
+{
+    const size_t length = signal.size() / num_axes;
+    const size_t num_features = num_axes * (config->wavelet_level + 1) * features_per_level;
+    expected.assign(num_features, 0.0f);
+    actual.assign(num_features, 0.0f);
+
+    std::vector<float> input_reference = signal, input_wavelet = signal;
+    matrix_t in_reference(length, num_axes, input_reference.data());
+    matrix_t in_wavelet(length, num_axes, input_wavelet.data());
+    matrix_t out_reference(1, num_features, expected.data());
+    matrix_t out_wavelet(1, num_features, actual.data());
+
+    double start = now_us();
+    int ret_reference = spectral::reference::wavelet::extract_wavelet_features(
+        &in_reference, &out_reference, config, 100.0f);
+    double middle = now_us();
+    int ret_wavelet = spectral::wavelet::extract_wavelet_features(&in_wavelet, &out_wavelet, config, 100.0f);
+    double end = now_us();
+
+    TEST_CHECK(ret_reference == EIDSP_OK);
+    TEST_CHECK(ret_wavelet == EIDSP_OK);
+    *reference_us += middle - start;
+    *wavelet_us += end - middle;
+}
+
+static bool same_feature(float expected, float actual)
+{
+#if EIDSP_USE_CMSIS_DSP
+    // the reference computes the moments with the arm_* helpers
+    return fabsf(expected - actual) <= 1e-5f * fmaxf(1.0f, fabsf(expected));
+#else
+    return memcmp(&expected, &actual, sizeof(float)) == 0;
+#endif
+}
+
+/**
+ * Every family, levels 1-7, the minimum length for the level and an odd one above it
+ */
+static void test_all_families(void)
+{
+    std::mt19937 rng(7);
+    std::vector<float> expected, actual;
+    double reference_us = 0, wavelet_us = 0;
+    size_t compared = 0, mismatches = 0;
+
+    for (const char *family : families) {
+        for (int level = 1; level <= 7; level++) {
+            for (int length : { 32 << level, (32 << level) + 37 }) {
+                if (length > 8192) {
+                    continue;
+                }
+                ei_dsp_config_spectral_analysis_t config = wavelet_config(family, level,
+                    level % 3 == 0 ? "low" : "none");
+                extract_both(&config, test_signal(rng, length), expected, actual, &reference_us, &wavelet_us);
+
+                for (size_t ix = 0; ix < expected.size(); ix++) {
+                    compared++;
+                    if (!same_feature(expected[ix], actual[ix])) {
+                        if (mismatches < 10) {
+                            printf("%s level %d length %d feature %zu: %.9g vs %.9g\n",
+                                family, level, length, ix, expected[ix], actual[ix]);
+                        }
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CHECK_MSG(mismatches == 0, "%zu of %zu features differ", mismatches, compared);
+    printf("wavelet: %zu features, all families %.0f us (reference %.0f us)\n",
+        compared, wavelet_us, reference_us);
+}
+
+/**
+ * Errors that used to trip an assert
+ */
+static void test_invalid_config(void)
+{
+    std::mt19937 rng(11);
+    std::vector<float> signal = test_signal(rng, 256);
+    std::vector<float> features(num_axes * 3 * features_per_level);
+    matrix_t in(256, num_axes, signal.data());
+    matrix_t out(1, features.size(), features.data());
+
+    ei_dsp_config_spectral_analysis_t config = wavelet_config("db42", 2, "none");
+    TEST_CHECK(spectral::wavelet::extract_wavelet_features(&in, &out, &config, 100.0f) == EIDSP_PARAMETER_INVALID);
+
+    matrix_t in_short(100, num_axes, signal.data());
+    config = wavelet_config("db4", 2, "none");
+    TEST_CHECK(spectral::wavelet::extract_wavelet_features(&in_short, &out, &config, 100.0f) ==
+        EIDSP_BUFFER_SIZE_MISMATCH);
+
+    matrix_t out_small(1, features.size() - 1, features.data());
+    matrix_t in_again(256, num_axes, signal.data());
+    TEST_CHECK(spectral::wavelet::extract_wavelet_features(&in_again, &out_small, &config, 100.0f) ==
+        EIDSP_MATRIX_SIZE_MISMATCH);
+}
+
+/**
+ * The DWT workspace is allocated on the first window and reused for the next ones,
+ * until it is released
+ */
+static void test_workspace_reuse(void)
+{
+    std::mt19937 rng(13);
+    std::vector<float> features(num_axes * 5 * features_per_level);
+    ei_dsp_config_spectral_analysis_t config = wavelet_config("sym8", 4, "none");
+    size_t size, first_size;
+
+    auto extract = [&](size_t length) {
+        std::vector<float> input = test_signal(rng, length);
+        features.resize(num_axes * (config.wavelet_level + 1) * features_per_level);
+        matrix_t in(length, num_axes, input.data());
+        matrix_t out(1, features.size(), features.data());
+        TEST_CHECK(spectral::wavelet::extract_wavelet_features(&in, &out, &config, 100.0f) == EIDSP_OK);
+    };
+
+    spectral::wavelet::release_workspace();
+    TEST_CHECK(spectral::wavelet::get_workspace(&size) == NULL && size == 0);
+
+    extract(1024);
+    const float *first = spectral::wavelet::get_workspace(&first_size);
+    TEST_CHECK(first != NULL && first_size > 1024);
+    extract(1024);
+    TEST_CHECK(spectral::wavelet::get_workspace(&size) == first && size == first_size);
+
+    // a shorter window fits the same workspace, a longer one grows it
+    config.wavelet_level = 2;
+    extract(256);
+    TEST_CHECK(spectral::wavelet::get_workspace(&size) == first && size == first_size);
+    extract(2048);
+    TEST_CHECK(spectral::wavelet::get_workspace(&size) != NULL && size > first_size);
+
+    // reserved up front from the config, the first window uses it as is
+    spectral::wavelet::release_workspace();
+    config.wavelet_level = 4;
+    TEST_CHECK(spectral::wavelet::reserve_workspace(&config, 1024) == EIDSP_OK);
+    first = spectral::wavelet::get_workspace(&size);
+    TEST_CHECK(first != NULL && size == first_size);
+    extract(1024);
+    TEST_CHECK(spectral::wavelet::get_workspace(&size) == first && size == first_size);
+
+    config.wavelet = "db42";
+    TEST_CHECK(spectral::wavelet::reserve_workspace(&config, 1024) == EIDSP_PARAMETER_INVALID);
+    spectral::wavelet::release_workspace();
+}
+
+/**
+ * db4 over 3 axes, the timings are printed (not checked)
+ */
+static void benchmark(void)
+{
+    std::mt19937 rng(3);
+    std::vector<float> expected, actual;
+    const int reps = 50;
+
+    for (int length : { 256, 1024, 4096 }) {
+        for (int level : { 2, 4 }) {
+            if (length < (32 << level)) {
+                continue;
+            }
+            ei_dsp_config_spectral_analysis_t config = wavelet_config("db4", level, "none");
+            std::vector<float> signal = test_signal(rng, length);
+            double reference_us = 0, wavelet_us = 0;
+            for (int ix = 0; ix < reps; ix++) {
+                extract_both(&config, signal, expected, actual, &reference_us, &wavelet_us);
+            }
+            printf("wavelet: db4 length %4d level %d: %7.1f us (reference %7.1f us)\n",
+                length, level, wavelet_us / reps, reference_us / reps);
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+int main(void)
+{
+    test_all_families();
+    test_invalid_config();
+    test_workspace_reuse();
+    benchmark();
+
+    return TEST_RESULT();
+}